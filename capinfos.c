@@ -152,6 +152,7 @@ static gchar file_sha1[HASH_STR_SIZE];
 
 static char  *hash_buf = NULL;
 static gcry_md_hd_t hd = NULL;
+static GThread *hash_thread = NULL;
 
 static guint num_ipv4_addresses;
 static guint num_ipv6_addresses;
@@ -1155,27 +1156,50 @@ hash_to_str(const unsigned char *hash, size_t length, char *str)
     }
 }
 
-static void
-calculate_hashes(const char *filename)
+static gpointer
+calculate_hashes(gpointer data)
 {
+    const char *filename = (const char *)data;
     FILE  *fh;
     size_t hash_bytes;
 
+    fh = ws_fopen(filename, "rb");
+    if (fh && hd) {
+        while((hash_bytes = fread(hash_buf, 1, HASH_BUF_SIZE, fh)) > 0) {
+            gcry_md_write(hd, hash_buf, hash_bytes);
+        }
+        gcry_md_final(hd);
+        hash_to_str(gcry_md_read(hd, GCRY_MD_SHA256), HASH_SIZE_SHA256, file_sha256);
+        hash_to_str(gcry_md_read(hd, GCRY_MD_SHA1), HASH_SIZE_SHA1, file_sha1);
+    }
+    if (fh) fclose(fh);
+    if (hd) gcry_md_reset(hd);
+    return NULL;
+}
+
+/*
+ * Hash the raw file bytes in a separate thread, so that reading the file
+ * for the hashes overlaps with reading and parsing its records.  The
+ * thread only touches hd, hash_buf, file_sha256 and file_sha1, which
+ * nothing else looks at until finish_hashes() has been called.
+ */
+static void
+start_hashes(const char *filename)
+{
     (void) g_strlcpy(file_sha256, "<unknown>", HASH_STR_SIZE);
     (void) g_strlcpy(file_sha1, "<unknown>", HASH_STR_SIZE);
 
     if (cap_file_hashes) {
-        fh = ws_fopen(filename, "rb");
-        if (fh && hd) {
-            while((hash_bytes = fread(hash_buf, 1, HASH_BUF_SIZE, fh)) > 0) {
-                gcry_md_write(hd, hash_buf, hash_bytes);
-            }
-            gcry_md_final(hd);
-            hash_to_str(gcry_md_read(hd, GCRY_MD_SHA256), HASH_SIZE_SHA256, file_sha256);
-            hash_to_str(gcry_md_read(hd, GCRY_MD_SHA1), HASH_SIZE_SHA1, file_sha1);
-        }
-        if (fh) fclose(fh);
-        if (hd) gcry_md_reset(hd);
+        hash_thread = g_thread_new("capinfos hashes", calculate_hashes, (gpointer)filename);
+    }
+}
+
+static void
+finish_hashes(void)
+{
+    if (hash_thread) {
+        g_thread_join(hash_thread);
+        hash_thread = NULL;
     }
 }
 
@@ -1213,12 +1237,15 @@ process_cap_file(const char *filename, gboolean need_separator)
         return 2;
     }
 
+    /* We only look at the record headers, never at the packet data. */
+    wtap_set_skip_packet_data(cf_info.wth, TRUE);
+
     /*
      * Calculate the checksums. Do this after wtap_open_offline, so we don't
      * bother calculating them for files that are not known capture types
      * where we wouldn't print them anyway.
      */
-    calculate_hashes(filename);
+    start_hashes(filename);
 
     if (need_separator && long_report) {
         printf("\n");
@@ -1352,6 +1379,8 @@ process_cap_file(const char *filename, gboolean need_separator)
     wtap_rec_cleanup(&rec);
     ws_buffer_free(&buf);
 
+    finish_hashes();
+
     /*
      * Get IDB info strings.
      * We do this at the end, so we can get information for all IDBs in
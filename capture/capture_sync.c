@@ -1792,6 +1792,10 @@ sync_pipe_input_cb(GIOChannel *pipe_io, capture_session *cap_session)
         cap_session->drops(cap_session, num, name);
         break;
         }
+    case SP_QUEUE_HWM:
+        /* purely informational, "<packets>:<bytes>" */
+        ws_info("capture queue high-water mark (packets:bytes) %s", buffer);
+        break;
     default:
         ws_assert_not_reached();
     }
@@ -1021,13 +1021,23 @@ capture_opts_add_opt(capture_options *capture_opts, int opt, const char *optarg_
 #else
             cmdarg_err("'gzip' compression is not supported");
             return 1;
+#endif
+        } else if (strcmp(optarg_str_p, "zstd") == 0) {
+#ifdef HAVE_ZSTD
+            ;
+#else
+            cmdarg_err("'zstd' compression is not supported");
+            return 1;
 #endif
         } else {
+            cmdarg_err("parameter of --compress-type can be 'none'"
 #ifdef HAVE_ZLIB
-            cmdarg_err("parameter of --compress-type can be 'none' or 'gzip'");
-#else
-            cmdarg_err("parameter of --compress-type can only be 'none'");
+                       ", 'gzip'"
+#endif
+#ifdef HAVE_ZSTD
+                       ", 'zstd'"
 #endif
+                       );
             return 1;
         }
         capture_opts->compress_type = g_strdup(optarg_str_p);
@@ -120,9 +120,14 @@ FILE *debug_log;   /* for logging debug messages to  */
 static GAsyncQueue *pcap_queue;
 static gint64 pcap_queue_bytes;
 static gint64 pcap_queue_packets;
+static gint64 pcap_queue_bytes_max;    /* high-water marks, reported when */
+static gint64 pcap_queue_packets_max;  /* the capture stops */
 static gint64 pcap_queue_byte_limit = 0;
 static gint64 pcap_queue_packet_limit = 0;
 
+static const char *metrics_file = NULL; /* --metrics-file, NULL if not wanted */
+static gint64 metrics_write_us;         /* time spent writing packets, in microseconds */
+
 static gboolean capture_child = FALSE; /* FALSE: standalone call, TRUE: this is an Wireshark capture child */
 static const char *report_capture_filename = NULL; /* capture child file name */
 #ifdef _WIN32
@@ -359,7 +364,7 @@ typedef struct _pcap_queue_element {
         struct pcap_pkthdr  phdr;
         pcapng_block_header_t  bh;
     } u;
-    u_char             *pd;
+    u_char             *pd;     /* points just past the element itself */
 } pcap_queue_element;
 
 /*
@@ -402,6 +407,7 @@ static gboolean need_timeout_workaround;
 #endif
 
 #define WRITER_THREAD_TIMEOUT 100000 /* usecs */
+#define WRITER_DEQUEUE_BATCH  64     /* max. queue items written per lock */
 
 static void
 dumpcap_log_writer(const char *domain, enum ws_log_level level,
@@ -434,6 +440,7 @@ WS_NORETURN static void exit_main(int err);
 static void report_new_capture_file(const char *filename);
 static void report_packet_count(unsigned int packet_count);
 static void report_packet_drops(guint32 received, guint32 pcap_drops, guint32 drops, guint32 flushed, guint32 ps_ifdrop, gchar *name);
+static void report_queue_high_water_mark(gint64 packets, gint64 bytes);
 static void report_capture_error(const char *error_msg, const char *secondary_error_msg);
 static void report_cfilter_error(capture_options *capture_opts, guint i, const char *errmsg);
 
@@ -523,6 +530,8 @@ print_usage(FILE *output)
     fprintf(output, "                           (only for pcapng)\n");
     fprintf(output, "  --temp-dir <directory>   write temporary files to this directory\n");
     fprintf(output, "                           (default: %s)\n", g_get_tmp_dir());
+    fprintf(output, "  --metrics-file <file>    periodically write capture counters to <file>, in the\n");
+    fprintf(output, "                           Prometheus text format\n");
     fprintf(output, "\n");
 
     ws_log_print_usage(output);
@@ -3473,15 +3482,22 @@ capture_loop_close_output(capture_options *capture_opts, loop_data *ld, int *err
             for (i = 0; i < global_ld.pcaps->len; i++) {
                 pcap_src = g_array_index(global_ld.pcaps, capture_src *, i);
                 if (!pcap_src->from_cap_pipe) {
-                    guint64 isb_ifrecv, isb_ifdrop;
+                    guint64 isb_ifrecv, isb_ifdrop, isb_osdrop, isb_usrdeliv;
                     struct pcap_stat stats;
 
                     if (pcap_stats(pcap_src->pcap_h, &stats) >= 0) {
                         isb_ifrecv = pcap_src->received;
                         isb_ifdrop = stats.ps_drop + pcap_src->dropped + pcap_src->flushed;
+                        /* Also break out the drops by the OS capture
+                           mechanism (e.g. the packet ring, on Linux)
+                           from the ones dumpcap itself made. */
+                        isb_osdrop = stats.ps_drop;
+                        isb_usrdeliv = pcap_src->received;
                    } else {
                         isb_ifrecv = G_MAXUINT64;
                         isb_ifdrop = G_MAXUINT64;
+                        isb_osdrop = G_MAXUINT64;
+                        isb_usrdeliv = G_MAXUINT64;
                     }
                     pcapng_write_interface_statistics_block(ld->pdh,
                                                             i,
@@ -3491,6 +3507,8 @@ capture_loop_close_output(capture_options *capture_opts, loop_data *ld, int *err
                                                             end_time,
                                                             isb_ifrecv,
                                                             isb_ifdrop,
+                                                            isb_osdrop,
+                                                            isb_usrdeliv,
                                                             err_close);
                 }
             }
@@ -4005,44 +4023,61 @@ pcap_read_handler(void* arg)
     return (NULL);
 }
 
-/* Try to pop an item off the packet queue and if it exists, write it */
+/* Write one dequeued item to the output file and free it */
+static void
+capture_loop_write_queue_element(pcap_queue_element *queue_element)
+{
+    if (queue_element->pcap_src->from_pcapng) {
+        ws_info("Dequeued a block of type 0x%08x of length %d captured on interface %d.",
+              queue_element->u.bh.block_type, queue_element->u.bh.block_total_length,
+              queue_element->pcap_src->interface_id);
+
+        capture_loop_write_pcapng_cb(queue_element->pcap_src,
+                                    &queue_element->u.bh,
+                                    queue_element->pd);
+    } else {
+        ws_info("Dequeued a packet of length %d captured on interface %d.",
+            queue_element->u.phdr.caplen, queue_element->pcap_src->interface_id);
+
+        capture_loop_write_packet_cb((u_char *) queue_element->pcap_src,
+                                    &queue_element->u.phdr,
+                                    queue_element->pd);
+    }
+    g_free(queue_element);
+}
+
+/* Try to pop items off the packet queue and if there are any, write them.
+   Everything that is already queued, up to WRITER_DEQUEUE_BATCH items, is
+   taken in a single lock round trip, so that the capture threads contend
+   for the queue lock once per batch rather than once per packet. */
 static gboolean
 capture_loop_dequeue_packet(void) {
-    pcap_queue_element *queue_element;
+    pcap_queue_element *queue_elements[WRITER_DEQUEUE_BATCH];
+    guint               count = 0;
+    guint               i;
 
     g_async_queue_lock(pcap_queue);
-    queue_element = (pcap_queue_element *)g_async_queue_timeout_pop_unlocked(pcap_queue, WRITER_THREAD_TIMEOUT);
-    if (queue_element) {
-        if (queue_element->pcap_src->from_pcapng) {
-            pcap_queue_bytes -= queue_element->u.bh.block_total_length;
-        } else {
-            pcap_queue_bytes -= queue_element->u.phdr.caplen;
+    queue_elements[0] = (pcap_queue_element *)g_async_queue_timeout_pop_unlocked(pcap_queue, WRITER_THREAD_TIMEOUT);
+    if (queue_elements[0]) {
+        count = 1;
+        while (count < WRITER_DEQUEUE_BATCH &&
+               (queue_elements[count] = (pcap_queue_element *)g_async_queue_try_pop_unlocked(pcap_queue)) != NULL) {
+            count++;
         }
-        pcap_queue_packets -= 1;
+        for (i = 0; i < count; i++) {
+            if (queue_elements[i]->pcap_src->from_pcapng) {
+                pcap_queue_bytes -= queue_elements[i]->u.bh.block_total_length;
+            } else {
+                pcap_queue_bytes -= queue_elements[i]->u.phdr.caplen;
+            }
+        }
+        pcap_queue_packets -= count;
     }
     g_async_queue_unlock(pcap_queue);
-    if (queue_element) {
-        if (queue_element->pcap_src->from_pcapng) {
-            ws_info("Dequeued a block of type 0x%08x of length %d captured on interface %d.",
-                  queue_element->u.bh.block_type, queue_element->u.bh.block_total_length,
-                  queue_element->pcap_src->interface_id);
-
-            capture_loop_write_pcapng_cb(queue_element->pcap_src,
-                                        &queue_element->u.bh,
-                                        queue_element->pd);
-        } else {
-            ws_info("Dequeued a packet of length %d captured on interface %d.",
-                queue_element->u.phdr.caplen, queue_element->pcap_src->interface_id);
-
-            capture_loop_write_packet_cb((u_char *) queue_element->pcap_src,
-                                        &queue_element->u.phdr,
-                                        queue_element->pd);
-        }
-        g_free(queue_element->pd);
-        g_free(queue_element);
-        return TRUE;
+    for (i = 0; i < count; i++) {
+        capture_loop_write_queue_element(queue_elements[i]);
     }
-    return FALSE;
+    return count > 0;
 }
 
 /*
@@ -4076,6 +4111,107 @@ handle_npcap_bug(char *adapter_name _U_, char *cap_err_str _U_)
                           "be reported as a Wireshark or Npcap bug.");
 }
 
+/* Append a label value, escaped as the Prometheus text format requires. */
+static void
+metrics_append_label(GString *str, const char *value)
+{
+    for (const char *p = value; *p != '\0'; p++) {
+        switch (*p) {
+            case '\\':
+                g_string_append(str, "\\\\");
+                break;
+            case '"':
+                g_string_append(str, "\\\"");
+                break;
+            case '\n':
+                g_string_append(str, "\\n");
+                break;
+            default:
+                g_string_append_c(str, *p);
+                break;
+        }
+    }
+}
+
+static void
+metrics_append_header(GString *str, const char *name, const char *type, const char *help)
+{
+    g_string_append_printf(str, "# HELP %s %s\n# TYPE %s %s\n", name, help, name, type);
+}
+
+/*
+ * Write the capture counters to the --metrics-file, in the Prometheus
+ * text exposition format, so that they can be picked up by e.g. the
+ * textfile collector of the node exporter. The file is replaced
+ * atomically, so readers never see a partial update.
+ *
+ * pcap_t handles aren't thread-safe, so the libpcap drop counts are only
+ * included when no capture threads are reading from them.
+ */
+static void
+write_metrics_file(capture_options *capture_opts, loop_data *ld, gboolean threads_running)
+{
+    static gboolean reported_error = FALSE;
+    GString *str = g_string_new(NULL);
+    GError *error = NULL;
+    guint i;
+
+    metrics_append_header(str, "dumpcap_packets_captured_total", "counter",
+                          "Packets written to the capture file(s).");
+    g_string_append_printf(str, "dumpcap_packets_captured_total %d\n", ld->packets_captured);
+    metrics_append_header(str, "dumpcap_file_bytes", "gauge",
+                          "Bytes written to the current capture file.");
+    g_string_append_printf(str, "dumpcap_file_bytes %" PRIu64 "\n", ld->bytes_written);
+    metrics_append_header(str, "dumpcap_write_seconds_total", "counter",
+                          "Time spent writing and flushing packets.");
+    g_string_append_printf(str, "dumpcap_write_seconds_total %.6f\n", metrics_write_us / 1e6);
+    metrics_append_header(str, "dumpcap_queue_packets", "gauge",
+                          "Packets queued between the capture threads and the writer.");
+    g_string_append_printf(str, "dumpcap_queue_packets %" PRId64 "\n", pcap_queue_packets);
+    metrics_append_header(str, "dumpcap_queue_bytes", "gauge",
+                          "Bytes queued between the capture threads and the writer.");
+    g_string_append_printf(str, "dumpcap_queue_bytes %" PRId64 "\n", pcap_queue_bytes);
+
+    metrics_append_header(str, "dumpcap_interface_packets_received_total", "counter",
+                          "Packets received on an interface.");
+    metrics_append_header(str, "dumpcap_interface_packets_dropped_total", "counter",
+                          "Packets dropped, by where they were dropped.");
+    for (i = 0; i < ld->pcaps->len; i++) {
+        capture_src *pcap_src = g_array_index(ld->pcaps, capture_src *, i);
+        interface_options *interface_opts = &g_array_index(capture_opts->ifaces, interface_options, pcap_src->interface_id);
+        GString *label = g_string_new("interface=\"");
+        struct pcap_stat stats;
+
+        metrics_append_label(label, interface_opts->display_name);
+        g_string_append_c(label, '"');
+
+        g_string_append_printf(str, "dumpcap_interface_packets_received_total{%s} %u\n",
+                               label->str, pcap_src->received);
+        g_string_append_printf(str, "dumpcap_interface_packets_dropped_total{%s,reason=\"dumpcap\"} %u\n",
+                               label->str, pcap_src->dropped);
+        g_string_append_printf(str, "dumpcap_interface_packets_dropped_total{%s,reason=\"flushed\"} %u\n",
+                               label->str, pcap_src->flushed);
+        if (!threads_running && pcap_src->pcap_h != NULL &&
+            pcap_stats(pcap_src->pcap_h, &stats) >= 0) {
+            g_string_append_printf(str, "dumpcap_interface_packets_dropped_total{%s,reason=\"os\"} %u\n",
+                                   label->str, stats.ps_drop);
+            g_string_append_printf(str, "dumpcap_interface_packets_dropped_total{%s,reason=\"interface\"} %u\n",
+                                   label->str, stats.ps_ifdrop);
+        }
+        g_string_free(label, TRUE);
+    }
+
+    if (!g_file_set_contents(metrics_file, str->str, str->len, &error)) {
+        /* Don't flood the log if the file can't be written. */
+        if (!reported_error) {
+            ws_warning("Can't write metrics file: %s", error->message);
+            reported_error = TRUE;
+        }
+        g_error_free(error);
+    }
+    g_string_free(str, TRUE);
+}
+
 /* Do the low-level work of a capture.
    Returns TRUE if it succeeds, FALSE otherwise. */
 static gboolean
@@ -4225,6 +4361,8 @@ capture_loop_start(capture_options *capture_opts, gboolean *stats_known, struct
         pcap_queue = g_async_queue_new();
         pcap_queue_bytes = 0;
         pcap_queue_packets = 0;
+        pcap_queue_bytes_max = 0;
+        pcap_queue_packets_max = 0;
         for (i = 0; i < global_ld.pcaps->len; i++) {
             pcap_src = g_array_index(global_ld.pcaps, capture_src *, i);
             /* XXX - Add an interface name here? */
@@ -4308,7 +4446,13 @@ capture_loop_start(capture_options *capture_opts, gboolean *stats_known, struct
             /* Let the parent process know. */
             if (global_ld.inpkts_to_sync_pipe) {
                 /* do sync here */
-                fflush(global_ld.pdh);
+                if (metrics_file) {
+                    gint64 write_start = g_get_monotonic_time();
+                    fflush(global_ld.pdh);
+                    metrics_write_us += g_get_monotonic_time() - write_start;
+                } else {
+                    fflush(global_ld.pdh);
+                }
 
                 /* Send our parent a message saying we've written out
                    "global_ld.inpkts_to_sync_pipe" packets to the capture file. */
@@ -4318,6 +4462,9 @@ capture_loop_start(capture_options *capture_opts, gboolean *stats_known, struct
                 global_ld.inpkts_to_sync_pipe = 0;
             }
 
+            if (metrics_file)
+                write_metrics_file(capture_opts, &global_ld, use_threads);
+
             /* check capture duration condition */
             if (autostop_duration_timer != NULL && g_timer_elapsed(autostop_duration_timer, NULL) >= capture_opts->autostop_duration) {
                 /* The maximum capture time has elapsed; stop the capture. */
@@ -4551,6 +4698,13 @@ capture_loop_start(capture_options *capture_opts, gboolean *stats_known, struct
         report_packet_drops(received, pcap_dropped, pcap_src->dropped, pcap_src->flushed, stats->ps_ifdrop, interface_opts->display_name);
     }
 
+    if (use_threads) {
+        report_queue_high_water_mark(pcap_queue_packets_max, pcap_queue_bytes_max);
+    }
+
+    if (metrics_file)
+        write_metrics_file(capture_opts, &global_ld, FALSE);
+
     /* close the input file (pcap or capture pipe) */
     capture_loop_close_input(&global_ld);
 
@@ -4741,12 +4895,18 @@ capture_loop_write_pcapng_cb(capture_src *pcap_src, const pcapng_block_header_t
         /* We're supposed to write the packet to a file; do so.
            If this fails, set "ld->go" to FALSE, to stop the capture, and set
            "ld->err" to the error. */
+        gint64 write_start = metrics_file ? g_get_monotonic_time() : 0;
+
         successful = pcapng_write_block(global_ld.pdh,
                                        pd,
                                        bh->block_total_length,
                                        &global_ld.bytes_written, &err);
+        if (metrics_file)
+            metrics_write_us += g_get_monotonic_time() - write_start;
 
-        fflush(global_ld.pdh);
+        /* Don't flush here; as for pcap sources, the capture loop flushes
+           after each dispatch when writing to a pipe, and otherwise once
+           per update interval, before telling the parent about new packets. */
         if (!successful) {
             global_ld.go = FALSE;
             global_ld.err = err;
@@ -4790,6 +4950,7 @@ capture_loop_write_packet_cb(u_char *pcap_src_p, const struct pcap_pkthdr *phdr,
 
     if (global_ld.pdh) {
         gboolean successful;
+        gint64 write_start = metrics_file ? g_get_monotonic_time() : 0;
 
         /* We're supposed to write the packet to a file; do so.
            If this fails, set "ld->go" to FALSE, to stop the capture, and set
@@ -4810,6 +4971,8 @@ capture_loop_write_packet_cb(u_char *pcap_src_p, const struct pcap_pkthdr *phdr,
                                               pd,
                                               &global_ld.bytes_written, &err);
         }
+        if (metrics_file)
+            metrics_write_us += g_get_monotonic_time() - write_start;
         if (!successful) {
             global_ld.go = FALSE;
             global_ld.err = err;
@@ -4841,19 +5004,16 @@ capture_loop_queue_packet_cb(u_char *pcap_src_p, const struct pcap_pkthdr *phdr,
         return;
     }
 
-    queue_element = g_new(pcap_queue_element, 1);
+    /* Allocate the element and the packet data in one go, to halve the
+       number of allocations done on the capture thread. */
+    queue_element = (pcap_queue_element *)g_try_malloc(sizeof(pcap_queue_element) + phdr->caplen);
     if (queue_element == NULL) {
        pcap_src->dropped++;
        return;
     }
     queue_element->pcap_src = pcap_src;
     queue_element->u.phdr = *phdr;
-    queue_element->pd = (u_char *)g_malloc(phdr->caplen);
-    if (queue_element->pd == NULL) {
-        pcap_src->dropped++;
-        g_free(queue_element);
-        return;
-    }
+    queue_element->pd = (u_char *)(queue_element + 1);
     memcpy(queue_element->pd, pd, phdr->caplen);
     g_async_queue_lock(pcap_queue);
     if (((pcap_queue_byte_limit == 0) || (pcap_queue_bytes < pcap_queue_byte_limit)) &&
@@ -4862,13 +5022,16 @@ capture_loop_queue_packet_cb(u_char *pcap_src_p, const struct pcap_pkthdr *phdr,
         g_async_queue_push_unlocked(pcap_queue, queue_element);
         pcap_queue_bytes += phdr->caplen;
         pcap_queue_packets += 1;
+        if (pcap_queue_bytes > pcap_queue_bytes_max)
+            pcap_queue_bytes_max = pcap_queue_bytes;
+        if (pcap_queue_packets > pcap_queue_packets_max)
+            pcap_queue_packets_max = pcap_queue_packets;
     } else {
         limit_reached = TRUE;
     }
     g_async_queue_unlock(pcap_queue);
     if (limit_reached) {
         pcap_src->dropped++;
-        g_free(queue_element->pd);
         g_free(queue_element);
         ws_info("Dropped a packet of length %d captured on interface %u.",
               phdr->caplen, pcap_src->interface_id);
@@ -4898,19 +5061,14 @@ capture_loop_queue_pcapng_cb(capture_src *pcap_src, const pcapng_block_header_t
         return;
     }
 
-    queue_element = g_new(pcap_queue_element, 1);
+    queue_element = (pcap_queue_element *)g_try_malloc(sizeof(pcap_queue_element) + bh->block_total_length);
     if (queue_element == NULL) {
        pcap_src->dropped++;
        return;
     }
     queue_element->pcap_src = pcap_src;
     queue_element->u.bh = *bh;
-    queue_element->pd = (u_char *)g_malloc(bh->block_total_length);
-    if (queue_element->pd == NULL) {
-        pcap_src->dropped++;
-        g_free(queue_element);
-        return;
-    }
+    queue_element->pd = (u_char *)(queue_element + 1);
     memcpy(queue_element->pd, pd, bh->block_total_length);
     g_async_queue_lock(pcap_queue);
     if (((pcap_queue_byte_limit == 0) || (pcap_queue_bytes < pcap_queue_byte_limit)) &&
@@ -4919,13 +5077,16 @@ capture_loop_queue_pcapng_cb(capture_src *pcap_src, const pcapng_block_header_t
         g_async_queue_push_unlocked(pcap_queue, queue_element);
         pcap_queue_bytes += bh->block_total_length;
         pcap_queue_packets += 1;
+        if (pcap_queue_bytes > pcap_queue_bytes_max)
+            pcap_queue_bytes_max = pcap_queue_bytes;
+        if (pcap_queue_packets > pcap_queue_packets_max)
+            pcap_queue_packets_max = pcap_queue_packets;
     } else {
         limit_reached = TRUE;
     }
     g_async_queue_unlock(pcap_queue);
     if (limit_reached) {
         pcap_src->dropped++;
-        g_free(queue_element->pd);
         g_free(queue_element);
         ws_info("Dropped a packet of length %d captured on interface %u.",
               bh->block_total_length, pcap_src->interface_id);
@@ -5016,6 +5177,7 @@ gather_dumpcap_runtime_info(feature_list l)
 #define LONGOPT_IFNAME             LONGOPT_BASE_APPLICATION+1
 #define LONGOPT_IFDESCR            LONGOPT_BASE_APPLICATION+2
 #define LONGOPT_CAPTURE_COMMENT    LONGOPT_BASE_APPLICATION+3
+#define LONGOPT_METRICS_FILE       LONGOPT_BASE_APPLICATION+4
 
 /* And now our feature presentation... [ fade to music ] */
 int
@@ -5030,6 +5192,7 @@ main(int argc, char *argv[])
         {"ifname", ws_required_argument, NULL, LONGOPT_IFNAME},
         {"ifdescr", ws_required_argument, NULL, LONGOPT_IFDESCR},
         {"capture-comment", ws_required_argument, NULL, LONGOPT_CAPTURE_COMMENT},
+        {"metrics-file", ws_required_argument, NULL, LONGOPT_METRICS_FILE},
         {0, 0, 0, 0 }
     };
 
@@ -5404,6 +5567,9 @@ main(int argc, char *argv[])
             }
             g_ptr_array_add(capture_comments, g_strdup(ws_optarg));
             break;
+        case LONGOPT_METRICS_FILE:
+            metrics_file = ws_optarg;
+            break;
         case 'Z':
             capture_child = TRUE;
 #ifdef _WIN32
@@ -5966,6 +6132,30 @@ report_packet_drops(guint32 received, guint32 pcap_drops, guint32 drops, guint32
 }
 
 
+/*
+ * How far the writer fell behind the capture threads, so that the queue
+ * limits (-C and -N) can be sized to ride out slow storage.
+ */
+static void
+report_queue_high_water_mark(gint64 packets, gint64 bytes)
+{
+    if (capture_child) {
+        char* tmp = ws_strdup_printf("%" PRId64 ":%" PRId64, packets, bytes);
+
+        ws_debug("Capture queue high-water mark: %" PRId64 " packets, %" PRId64 " bytes",
+            packets, bytes);
+        pipe_write_block(2, SP_QUEUE_HWM, tmp);
+        g_free(tmp);
+    } else {
+        fprintf(stderr,
+            "Capture queue high-water mark: %" PRId64 " packets, %" PRId64 " bytes (limits: %" PRId64 " packets, %" PRId64 " bytes)\n",
+            packets, bytes, pcap_queue_packet_limit, pcap_queue_byte_limit);
+        /* stderr could be line buffered */
+        fflush(stderr);
+    }
+}
+
+
 /************************************************************************************************/
 /* signal_pipe handling */
 
@@ -91,6 +91,7 @@ typedef struct _fd_hash_t {
     guint8     digest[16];
     guint32    len;
     nstime_t   frame_time;
+    gboolean   in_use;      /* TRUE if this entry is counted in fd_hash_index */
 } fd_hash_t;
 
 #define DEFAULT_DUP_DEPTH       5   /* Used with -d */
@@ -100,6 +101,19 @@ static fd_hash_t fd_hash[MAX_DUP_DEPTH];
 static int       dup_window    = DEFAULT_DUP_DEPTH;
 static int       cur_dup_entry = 0;
 
+/*
+ * Index of the (len, digest) pairs currently in the fd_hash[] window,
+ * with the number of window entries that have each of them, so that we
+ * don't have to scan the whole window for every packet.
+ */
+typedef struct _fd_hash_key_t {
+    guint8     digest[16];
+    guint32    len;
+    guint      count;
+} fd_hash_key_t;
+
+static GHashTable *fd_hash_index = NULL;
+
 static guint32   ignored_bytes  = 0;  /* Used with -I */
 
 #define ONE_BILLION 1000000000
@@ -637,9 +651,81 @@ set_unused_info(const wtap_packet_header *phdr, guint8* fd) {
     }
 }
 
+static guint
+fd_hash_key_hash(gconstpointer key)
+{
+    const fd_hash_key_t *hkey = (const fd_hash_key_t *)key;
+    guint hash;
+
+    /* The digest is already well distributed; just fold in the length. */
+    memcpy(&hash, hkey->digest, sizeof hash);
+    return hash ^ hkey->len;
+}
+
+static gboolean
+fd_hash_key_equal(gconstpointer a, gconstpointer b)
+{
+    const fd_hash_key_t *hkey_a = (const fd_hash_key_t *)a;
+    const fd_hash_key_t *hkey_b = (const fd_hash_key_t *)b;
+
+    return hkey_a->len == hkey_b->len &&
+           memcmp(hkey_a->digest, hkey_b->digest, 16) == 0;
+}
+
+/*
+ * Drop the fd_hash[] entry that's about to be overwritten from the index.
+ */
+static void
+fd_hash_index_remove(fd_hash_t *entry)
+{
+    fd_hash_key_t lookup_key, *hkey;
+
+    if (!entry->in_use)
+        return;
+    entry->in_use = FALSE;
+
+    memcpy(lookup_key.digest, entry->digest, 16);
+    lookup_key.len = entry->len;
+    hkey = (fd_hash_key_t *)g_hash_table_lookup(fd_hash_index, &lookup_key);
+    if (hkey == NULL)
+        return;
+
+    if (--hkey->count == 0)
+        g_hash_table_remove(fd_hash_index, hkey);
+}
+
+/*
+ * Add a newly filled-in fd_hash[] entry to the index; returns TRUE if
+ * some other entry in the window has the same length and digest.
+ */
+static gboolean
+fd_hash_index_add(fd_hash_t *entry)
+{
+    fd_hash_key_t lookup_key, *hkey;
+
+    entry->in_use = TRUE;
+
+    memcpy(lookup_key.digest, entry->digest, 16);
+    lookup_key.len = entry->len;
+    hkey = (fd_hash_key_t *)g_hash_table_lookup(fd_hash_index, &lookup_key);
+    if (hkey != NULL) {
+        hkey->count++;
+        return TRUE;
+    }
+
+    /*
+     * The key has to be a copy, as the entry will be overwritten when
+     * it falls out of the window while other entries may still share it.
+     */
+    hkey = g_new(fd_hash_key_t, 1);
+    *hkey = lookup_key;
+    hkey->count = 1;
+    g_hash_table_add(fd_hash_index, hkey);
+    return FALSE;
+}
+
 static gboolean
 is_duplicate(guint8* fd, guint32 len) {
-    int i;
     const struct ieee80211_radiotap_header* tap_header;
 
     /*Hint to ignore some bytes at the start of the frame for the digest calculation(-I option) */
@@ -666,23 +752,16 @@ is_duplicate(guint8* fd, guint32 len) {
     if (cur_dup_entry >= dup_window)
         cur_dup_entry = 0;
 
+    /* The oldest entry in the window is being replaced. */
+    fd_hash_index_remove(&fd_hash[cur_dup_entry]);
+
     /* Calculate our digest */
     gcry_md_hash_buffer(GCRY_MD_MD5, fd_hash[cur_dup_entry].digest, new_fd, new_len);
 
     fd_hash[cur_dup_entry].len = len;
 
     /* Look for duplicates */
-    for (i = 0; i < dup_window; i++) {
-        if (i == cur_dup_entry)
-            continue;
-
-        if (fd_hash[i].len == fd_hash[cur_dup_entry].len
-            && memcmp(fd_hash[i].digest, fd_hash[cur_dup_entry].digest, 16) == 0) {
-            return TRUE;
-        }
-    }
-
-    return FALSE;
+    return fd_hash_index_add(&fd_hash[cur_dup_entry]);
 }
 
 static gboolean
@@ -705,6 +784,9 @@ is_duplicate_rel_time(guint8* fd, guint32 len, const nstime_t *current) {
     if (cur_dup_entry >= dup_window)
         cur_dup_entry = 0;
 
+    /* The oldest entry in the window is being replaced. */
+    fd_hash_index_remove(&fd_hash[cur_dup_entry]);
+
     /* Calculate our digest */
     gcry_md_hash_buffer(GCRY_MD_MD5, fd_hash[cur_dup_entry].digest, new_fd, new_len);
 
@@ -712,6 +794,15 @@ is_duplicate_rel_time(guint8* fd, guint32 len, const nstime_t *current) {
     fd_hash[cur_dup_entry].frame_time.secs = current->secs;
     fd_hash[cur_dup_entry].frame_time.nsecs = current->nsecs;
 
+    /*
+     * If no other packet in the whole window has the same length and
+     * digest, it can't be a duplicate within the time window either,
+     * so we needn't look at the timestamps at all; that's by far the
+     * most common case.
+     */
+    if (!fd_hash_index_add(&fd_hash[cur_dup_entry]))
+        return FALSE;
+
     /*
      * Look for relative time related duplicates.
      * This is hopefully a reasonably efficient mechanism for
@@ -1228,6 +1319,8 @@ main(int argc, char *argv[])
     int           written_count      = 0;
     char         *filename           = NULL;
     gboolean      ts_okay;
+    gboolean      skip_outside_window = FALSE;
+    gboolean      data_skipped = FALSE;
     nstime_t      secs_per_block     = NSTIME_INIT_UNSET;
     int           block_cnt          = 0;
     nstime_t      block_next         = NSTIME_INIT_UNSET;
@@ -1694,7 +1787,16 @@ main(int argc, char *argv[])
         goto clean_exit;
     }
 
-    wth = wtap_open_offline(argv[ws_optind], WTAP_TYPE_AUTO, &read_err, &read_err_info, FALSE);
+    /*
+     * When selecting a time window from a file we can seek in, read the
+     * packets outside the window without their data, and go back for
+     * the data of the ones that turn out to be wanted.  That makes
+     * getting to the start of a window in a large file cost little more
+     * than reading the record headers.
+     */
+    skip_outside_window = check_startstop && strcmp(argv[ws_optind], "-") != 0;
+
+    wth = wtap_open_offline(argv[ws_optind], WTAP_TYPE_AUTO, &read_err, &read_err_info, skip_outside_window);
 
     if (!wth) {
         cfile_open_failure_message(argv[ws_optind], read_err, read_err_info);
@@ -1843,7 +1945,11 @@ main(int argc, char *argv[])
             memset(&fd_hash[i].digest, 0, 16);
             fd_hash[i].len = 0;
             nstime_set_unset(&fd_hash[i].frame_time);
+            fd_hash[i].in_use = FALSE;
         }
+        fd_hash_index = g_hash_table_new_full(fd_hash_key_hash,
+                                              fd_hash_key_equal,
+                                              g_free, NULL);
     }
 
     /* Set up an array of all IDBs seen */
@@ -1852,6 +1958,11 @@ main(int argc, char *argv[])
     /* Read all of the packets in turn */
     wtap_rec_init(&read_rec);
     ws_buffer_init(&read_buf, 1514);
+    if (skip_outside_window) {
+        /* Assume we start outside the window */
+        data_skipped = TRUE;
+        wtap_set_skip_packet_data(wth, data_skipped);
+    }
     while (wtap_read(wth, &read_rec, &read_buf, &read_err, &read_err_info, &data_offset)) {
         /*
          * XXX - what about non-packet records in the file after this?
@@ -2015,6 +2126,30 @@ main(int argc, char *argv[])
             ts_okay = TRUE;
         }
 
+        if (skip_outside_window) {
+            /* Not all readers can skip the data, so check that it was. */
+            if (data_skipped && ts_okay &&
+                rec->rec_type == REC_TYPE_PACKET &&
+                ws_buffer_length(&read_buf) < rec->rec_header.packet_header.caplen &&
+                ((!selected(count) && !keep_em) || (selected(count) && keep_em))) {
+                /* This one is wanted; go back and read it again, with its data. */
+                wtap_rec_reset(&read_rec);
+                if (!wtap_seek_read(wth, data_offset, &read_rec, &read_buf,
+                                    &read_err, &read_err_info)) {
+                    if (read_err == 0)
+                        read_err = WTAP_ERR_SHORT_READ;
+                    break;
+                }
+                buf = ws_buffer_start_ptr(&read_buf);
+            }
+
+            /* The next packet is probably on the same side of the window. */
+            if (data_skipped != !ts_okay) {
+                data_skipped = !ts_okay;
+                wtap_set_skip_packet_data(wth, data_skipped);
+            }
+        }
+
         if (ts_okay && ((!selected(count) && !keep_em)
                         || (selected(count) && keep_em))) {
 
@@ -2454,6 +2589,9 @@ clean_exit:
     if (filename) {
         g_free(filename);
     }
+    if (fd_hash_index) {
+        g_hash_table_destroy(fd_hash_index);
+    }
     if (frames_user_comments) {
         g_tree_destroy(frames_user_comments);
     }
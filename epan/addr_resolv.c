@@ -20,6 +20,7 @@
 #include <string.h>
 #include <errno.h>
 
+#include <wsutil/bits_ctz.h>
 #include <wsutil/strtoi.h>
 #include <wsutil/ws_assert.h>
 
@@ -221,17 +222,22 @@ struct cb_serv_data {
 static wmem_map_t *manuf_hashtable = NULL;
 static wmem_map_t *wka_hashtable = NULL;
 static wmem_map_t *eth_hashtable = NULL;
+static gboolean manuf_loaded = FALSE;  /* manuf and wka files have been read */
+// Maps address -> ether_t* from the personal and global ethers files
+static wmem_map_t *ethers_file_hashtable = NULL;
+static gboolean ethers_loaded = FALSE; /* ethers files have been read */
 // Maps guint -> serv_port_t*
 static wmem_map_t *serv_port_hashtable = NULL;
 static GHashTable *enterprises_hashtable = NULL;
 
 static subnet_length_entry_t subnet_length_entries[SUBNETLENGTHSIZE]; /* Ordered array of entries */
-static gboolean have_subnet_entry = FALSE;
+static guint32 subnet_lengths_present = 0; /* Bit n-1 set if any /n subnet is defined */
 
 static gboolean new_resolved_objects = FALSE;
 
 static GPtrArray* extra_hosts_files = NULL;
 
+static void load_manuf(void);
 static hashether_t *add_eth_name(const guint8 *addr, const gchar *name);
 static void add_serv_port_cb(const guint32 port, gpointer ptr);
 
@@ -1544,29 +1550,41 @@ get_ethent(unsigned int *mask, const gboolean accept_mask)
 
 } /* get_ethent */
 
-static ether_t *
-get_ethbyaddr(const guint8 *addr)
+/*
+ * Index one ethers file by address. An address that is already present
+ * keeps its earlier name, matching the first hit of a sequential scan.
+ */
+static void
+load_ethers_file(char *path)
 {
-
     ether_t *eth;
+    ether_t *entry;
 
-    set_ethent(g_pethers_path);
-
-    while (((eth = get_ethent(NULL, FALSE)) != NULL) && memcmp(addr, eth->addr, 6) != 0)
-        ;
-
-    if (eth == NULL) {
-        end_ethent();
-
-        set_ethent(g_ethers_path);
-
-        while (((eth = get_ethent(NULL, FALSE)) != NULL) && memcmp(addr, eth->addr, 6) != 0)
-            ;
+    set_ethent(path);
+    while ((eth = get_ethent(NULL, FALSE)) != NULL) {
+        if (wmem_map_contains(ethers_file_hashtable, eth->addr))
+            continue;
+        entry = (ether_t *)wmem_memdup(wmem_epan_scope(), eth, sizeof(ether_t));
+        wmem_map_insert(ethers_file_hashtable, entry->addr, entry);
+    }
+    end_ethent();
+}
 
-        end_ethent();
+static ether_t *
+get_ethbyaddr(const guint8 *addr)
+{
+    /*
+     * Rescanning the ethers files for every new address is quadratic
+     * with large files, so read them once on first use, personal file
+     * first, and answer lookups from the table afterwards.
+     */
+    if (!ethers_loaded) {
+        ethers_loaded = TRUE;
+        load_ethers_file(g_pethers_path);
+        load_ethers_file(g_ethers_path);
     }
 
-    return eth;
+    return (ether_t *)wmem_map_lookup(ethers_file_hashtable, addr);
 
 } /* get_ethbyaddr */
 
@@ -1654,6 +1672,7 @@ manuf_name_lookup(const guint8 *addr)
     oct = addr[2];
     manuf_key = manuf_key | oct;
 
+    load_manuf();
 
     /* first try to find a "perfect match" */
     manuf_value = (hashmanuf_t*)wmem_map_lookup(manuf_hashtable, GUINT_TO_POINTER(manuf_key));
@@ -1690,6 +1709,7 @@ wka_name_lookup(const guint8 *addr, const unsigned int mask)
     if (wka_hashtable == NULL) {
         return NULL;
     }
+    load_manuf();
     /* Get the part of the address covered by the mask. */
     for (i = 0, num = mask; num >= 8; i++, num -= 8)
         masked_addr[i] = addr[i];   /* copy octets entirely covered by the mask */
@@ -1737,13 +1757,11 @@ eth_addr_cmp(gconstpointer a, gconstpointer b)
 static void
 initialize_ethers(void)
 {
-    ether_t *eth;
-    guint    mask = 0;
-
     /* hash table initialization */
     wka_hashtable   = wmem_map_new(wmem_epan_scope(), eth_addr_hash, eth_addr_cmp);
     manuf_hashtable = wmem_map_new(wmem_epan_scope(), g_direct_hash, g_direct_equal);
     eth_hashtable   = wmem_map_new(wmem_epan_scope(), eth_addr_hash, eth_addr_cmp);
+    ethers_file_hashtable = wmem_map_new(wmem_epan_scope(), eth_addr_hash, eth_addr_cmp);
 
     /* Compute the pathname of the ethers file. */
     if (g_ethers_path == NULL) {
@@ -1762,6 +1780,31 @@ initialize_ethers(void)
         }
     }
 
+    /* The manuf, wka and ethers files are only read on first use, see
+     * load_manuf() and get_ethbyaddr() */
+    manuf_loaded = FALSE;
+    ethers_loaded = FALSE;
+
+} /* initialize_ethers */
+
+/*
+ * Read the manuf and wka files. They hold tens of thousands of entries
+ * and parsing them dominates startup, yet many sessions (name resolution
+ * turned off, captures without MAC addresses, tshark -T fields on IP
+ * fields, ...) never look anything up in them. So defer the work until
+ * the first lookup that needs it.
+ */
+static void
+load_manuf(void)
+{
+    ether_t *eth;
+    guint    mask = 0;
+
+    if (manuf_loaded)
+        return;
+    /* Set this first; add_manuf_name() ends up in add_eth_name(). */
+    manuf_loaded = TRUE;
+
     /* Compute the pathname of the manuf file */
     if (g_manuf_path == NULL)
         g_manuf_path = get_datafile_path(ENAME_MANUF);
@@ -1784,7 +1827,7 @@ initialize_ethers(void)
     }
     end_ethent();
 
-} /* initialize_ethers */
+} /* load_manuf */
 
 static void
 ethers_cleanup(void)
@@ -1797,6 +1840,8 @@ ethers_cleanup(void)
     g_manuf_path = NULL;
     g_free(g_wka_path);
     g_wka_path = NULL;
+    manuf_loaded = FALSE;
+    ethers_loaded = FALSE;
 }
 
 /* Resolve ethernet address */
@@ -1933,6 +1978,9 @@ add_eth_name(const guint8 *addr, const gchar *name)
 {
     hashether_t *tp;
 
+    /* Entries added later must win over the well-known ones. */
+    load_manuf();
+
     tp = (hashether_t *)wmem_map_lookup(eth_hashtable, addr);
 
     if (tp == NULL) {
@@ -1953,6 +2001,8 @@ eth_name_lookup(const guint8 *addr, const gboolean resolve)
 {
     hashether_t  *tp;
 
+    load_manuf();
+
     tp = (hashether_t *)wmem_map_lookup(eth_hashtable, addr);
 
     if (tp == NULL) {
@@ -2556,40 +2606,36 @@ static subnet_entry_t
 subnet_lookup(const guint32 addr)
 {
     subnet_entry_t subnet_entry;
+    guint32 lengths;
     guint32 i;
 
-    /* Search mask lengths linearly, longest first */
+    /* Search the mask lengths that have entries, longest first */
 
-    i = SUBNETLENGTHSIZE;
-    while(have_subnet_entry && i > 0) {
+    lengths = subnet_lengths_present;
+    while (lengths != 0) {
         guint32 masked_addr;
         subnet_length_entry_t* length_entry;
+        sub_net_hashipv4_t * tp;
 
         /* Note that we run from 31 (length 32)  to 0 (length 1)  */
-        --i;
+        i = ws_ilog2(lengths);
+        lengths &= ~(1U << i);
         ws_assert(i < SUBNETLENGTHSIZE);
 
-
         length_entry = &subnet_length_entries[i];
 
-        if (NULL != length_entry->subnet_addresses) {
-            sub_net_hashipv4_t * tp;
-            guint32 hash_idx;
-
-            masked_addr = addr & length_entry->mask;
-            hash_idx = HASH_IPV4_ADDRESS(masked_addr);
+        masked_addr = addr & length_entry->mask;
 
-            tp = length_entry->subnet_addresses[hash_idx];
-            while(tp != NULL && tp->addr != masked_addr) {
-                tp = tp->next;
-            }
+        tp = length_entry->subnet_addresses[HASH_IPV4_ADDRESS(masked_addr)];
+        while(tp != NULL && tp->addr != masked_addr) {
+            tp = tp->next;
+        }
 
-            if (NULL != tp) {
-                subnet_entry.mask = length_entry->mask;
-                subnet_entry.mask_length = i + 1; /* Length is offset + 1 */
-                subnet_entry.name = tp->name;
-                return subnet_entry;
-            }
+        if (NULL != tp) {
+            subnet_entry.mask = length_entry->mask;
+            subnet_entry.mask_length = i + 1; /* Length is offset + 1 */
+            subnet_entry.name = tp->name;
+            return subnet_entry;
         }
     }
 
@@ -2644,7 +2690,7 @@ subnet_entry_set(guint32 subnet_addr, const guint8 mask_length, const gchar* nam
     tp->next = NULL;
     tp->addr = subnet_addr;
     (void) g_strlcpy(tp->name, name, MAXNAMELEN); /* This is longer than subnet names can actually be */
-    have_subnet_entry = TRUE;
+    subnet_lengths_present |= 1U << (mask_length - 1);
 }
 
 static void
@@ -2952,22 +2998,19 @@ disable_name_resolution(void) {
     gbl_resolv_flags.maxmind_geoip                      = FALSE;
 }
 
-gboolean
-host_name_lookup_process(void) {
+/*
+ * How long host_name_lookup_process() keeps reading replies and sending
+ * queued requests, in microseconds, before returning to its caller
+ * (usually the GUI's main loop, once a second).
+ */
+#define HOST_NAME_LOOKUP_PROCESS_BUDGET 50000
+
+static void
+process_async_dns_queue(void)
+{
     async_dns_queue_msg_t *caqm;
-    struct timeval tv = { 0, 0 };
-    int nfds;
-    fd_set rfds, wfds;
-    gboolean nro = new_resolved_objects;
     wmem_list_frame_t* head;
 
-    new_resolved_objects = FALSE;
-    nro |= maxmind_db_lookup_process();
-
-    if (!async_dns_initialized)
-        /* c-ares not initialized. Bail out and cancel timers. */
-        return nro;
-
     head = wmem_list_head(async_dns_queue_head);
 
     while (head != NULL && async_dns_in_flight <= name_resolve_concurrency) {
@@ -2985,21 +3028,54 @@ host_name_lookup_process(void) {
 
         head = wmem_list_head(async_dns_queue_head);
     }
+}
 
-    FD_ZERO(&rfds);
-    FD_ZERO(&wfds);
-    nfds = ares_fds(ghba_chan, &rfds, &wfds);
-    if (nfds > 0) {
+gboolean
+host_name_lookup_process(void) {
+    struct timeval tv = { 0, 0 };
+    int nfds;
+    fd_set rfds, wfds;
+    gboolean nro = new_resolved_objects;
+    gint64 deadline;
+    guint in_flight;
+
+    new_resolved_objects = FALSE;
+    nro |= maxmind_db_lookup_process();
+
+    if (!async_dns_initialized)
+        /* c-ares not initialized. Bail out and cancel timers. */
+        return nro;
+
+    /*
+     * We're only called periodically, so rather than sending at most
+     * one batch of requests per call, keep handling the replies that
+     * have already arrived and replacing them with queued requests,
+     * for as long as that's making progress and we're within budget.
+     */
+    deadline = g_get_monotonic_time() + HOST_NAME_LOOKUP_PROCESS_BUDGET;
+    do {
+        process_async_dns_queue();
+        in_flight = async_dns_in_flight;
+
+        FD_ZERO(&rfds);
+        FD_ZERO(&wfds);
+        nfds = ares_fds(ghba_chan, &rfds, &wfds);
+        if (nfds <= 0)
+            break;
         if (select(nfds, &rfds, &wfds, NULL, &tv) == -1) { /* call to select() failed */
             /* If it's interrupted by a signal, no need to put out a message */
             if (errno != EINTR)
                 fprintf(stderr, "Warning: call to select() failed, error is %s\n", g_strerror(errno));
-            return nro;
+            break;
         }
         ares_process(ghba_chan, &rfds, &wfds);
-    }
+    } while (async_dns_in_flight < in_flight &&
+             wmem_list_count(async_dns_queue_head) > 0 &&
+             g_get_monotonic_time() < deadline);
 
-    /* Any new entries? */
+    /* Any new entries, including from the replies we just handled? */
+    nro |= new_resolved_objects;
+    new_resolved_objects = FALSE;
     return nro;
 }
 
@@ -3230,7 +3306,7 @@ host_name_lookup_cleanup(void)
         }
     }
 
-    have_subnet_entry = FALSE;
+    subnet_lengths_present = 0;
     new_resolved_objects = FALSE;
 }
 
@@ -3455,6 +3531,8 @@ get_manuf_name_if_known(const guint8 *addr)
     oct = addr[2];
     manuf_key = manuf_key | oct;
 
+    load_manuf();
+
     manuf_value = (hashmanuf_t *)wmem_map_lookup(manuf_hashtable, GUINT_TO_POINTER(manuf_key));
     if ((manuf_value == NULL) || (manuf_value->status == HASHETHER_STATUS_UNRESOLVED)) {
         return NULL;
@@ -3469,6 +3547,8 @@ uint_get_manuf_name_if_known(const guint manuf_key)
 {
     hashmanuf_t *manuf_value;
 
+    load_manuf();
+
     manuf_value = (hashmanuf_t *)wmem_map_lookup(manuf_hashtable, GUINT_TO_POINTER(manuf_key));
     if ((manuf_value == NULL) || (manuf_value->status == HASHETHER_STATUS_UNRESOLVED)) {
         return NULL;
@@ -3647,18 +3727,21 @@ get_host_ipaddr6(const char *host, ws_in6_addr *addrp)
 wmem_map_t *
 get_manuf_hashtable(void)
 {
+    load_manuf();
     return manuf_hashtable;
 }
 
 wmem_map_t *
 get_wka_hashtable(void)
 {
+    load_manuf();
     return wka_hashtable;
 }
 
 wmem_map_t *
 get_eth_hashtable(void)
 {
+    load_manuf();
     return eth_hashtable;
 }
 
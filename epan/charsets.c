@@ -89,19 +89,23 @@ get_ascii_string(wmem_allocator_t *scope, const guint8 *ptr, gint length)
     str = wmem_strbuf_new_sized(scope, length+1);
 
     while (length > 0) {
-        guint8 ch = *ptr++;
+        guint8 ch = *ptr;
 
         if (ch < 0x80) {
-            valid_bytes++;
+            size_t ascii_len = ws_ascii_prefix_len(ptr, length);
+
+            valid_bytes += ascii_len;
+            ptr += ascii_len;
+            length -= (gint)ascii_len;
         } else {
             if (valid_bytes) {
                 wmem_strbuf_append_len(str, prev, valid_bytes);
                 valid_bytes = 0;
             }
-            prev = ptr;
+            prev = ++ptr;
             wmem_strbuf_append_unichar_repl(str);
+            length--;
         }
-        length--;
     }
     if (valid_bytes) {
         wmem_strbuf_append_len(str, prev, valid_bytes);
@@ -695,6 +699,47 @@ get_unichar2_string(wmem_allocator_t *scope, const guint8 *ptr, gint length, con
     return (guint8 *) wmem_strbuf_finalize(str);
 }
 
+/*
+ * Append the run of UTF-16 code units at the beginning of the buffer
+ * that are in the ASCII range, in the specified byte order, as
+ * single-byte UTF-8 characters; return the number of bytes consumed.
+ *
+ * This lets the UCS-2 and UTF-16 getters copy mostly-ASCII strings
+ * in bulk rather than one code unit at a time.
+ */
+static gint
+append_utf_16_ascii_run(wmem_strbuf_t *strbuf, const guint8 *ptr, gint length, guint encoding)
+{
+    gchar buf[64];
+    gint i = 0;
+    size_t n = 0;
+
+    while (i + 1 < length) {
+        guint8 hi, lo;
+
+        if (encoding == ENC_BIG_ENDIAN) {
+            hi = ptr[i];
+            lo = ptr[i + 1];
+        } else {
+            lo = ptr[i];
+            hi = ptr[i + 1];
+        }
+        if (hi != 0 || lo >= 0x80)
+            break;
+        buf[n++] = lo;
+        i += 2;
+        if (n == sizeof buf) {
+            wmem_strbuf_append_len(strbuf, buf, n);
+            n = 0;
+        }
+    }
+    if (n) {
+        wmem_strbuf_append_len(strbuf, buf, n);
+    }
+
+    return i;
+}
+
 /*
  * Given a wmem scope, a pointer, and a length, treat the string of bytes
  * referred to by the pointer and length as a UCS-2 encoded string
@@ -729,6 +774,10 @@ get_ucs_2_string(wmem_allocator_t *scope, const guint8 *ptr, gint length, guint
     encoding = encoding & ENC_LITTLE_ENDIAN;
 
     for(; i + 1 < length; i += 2) {
+        i += append_utf_16_ascii_run(strbuf, ptr + i, length - i, encoding);
+        if (i + 1 >= length)
+            break;
+
         if (encoding == ENC_BIG_ENDIAN) {
             uchar = pntoh16(ptr + i);
         } else {
@@ -782,6 +831,10 @@ get_utf_16_string(wmem_allocator_t *scope, const guint8 *ptr, gint length, guint
     encoding = encoding & ENC_LITTLE_ENDIAN;
 
     for(; i + 1 < length; i += 2) {
+        i += append_utf_16_ascii_run(strbuf, ptr + i, length - i, encoding);
+        if (i + 1 >= length)
+            break;
+
         if (encoding == ENC_BIG_ENDIAN)
             uchar2 = pntoh16(ptr + i);
         else
@@ -449,6 +449,54 @@ color_filter_validate_cb(gpointer filter_arg, gpointer err)
      */
 }
 
+/* Do two color filters match in everything but their colors? */
+static gboolean
+color_filter_same_rule(const color_filter_t *a, const color_filter_t *b)
+{
+    return a->disabled == b->disabled &&
+           g_strcmp0(a->filter_name, b->filter_name) == 0 &&
+           g_strcmp0(a->filter_text, b->filter_text) == 0;
+}
+
+/* If the tmp/edit lists only differ from the current list in their colors,
+ * update the colors of the current entries in place and return TRUE.
+ * Frames keep pointers to the entry that colorized them, so they pick up
+ * the new colors without having to be dissected and filtered again. */
+static gboolean
+color_filters_update_colors(GSList *tmp_cfl, GSList *edit_cfl)
+{
+    GSList *lists[2] = { tmp_cfl, edit_cfl };
+    GSList *curr, *new_item;
+    int pass, i;
+
+    /* First check that all rules match, then update the colors. */
+    for (pass = 0; pass < 2; pass++) {
+        curr = color_filter_list;
+        for (i = 0; i < 2; i++) {
+            for (new_item = lists[i]; new_item != NULL; new_item = g_slist_next(new_item)) {
+                color_filter_t *colorf;
+                color_filter_t *new_colorf = (color_filter_t *)new_item->data;
+
+                if (curr == NULL)
+                    return FALSE;
+                colorf = (color_filter_t *)curr->data;
+                if (pass == 0) {
+                    if (!color_filter_same_rule(colorf, new_colorf))
+                        return FALSE;
+                } else {
+                    colorf->bg_color = new_colorf->bg_color;
+                    colorf->fg_color = new_colorf->fg_color;
+                }
+                curr = g_slist_next(curr);
+            }
+        }
+        if (curr != NULL)
+            return FALSE;
+    }
+
+    return TRUE;
+}
+
 /* apply changes from the edit list */
 gboolean
 color_filters_apply(GSList *tmp_cfl, GSList *edit_cfl, gchar** err_msg)
@@ -457,6 +505,10 @@ color_filters_apply(GSList *tmp_cfl, GSList *edit_cfl, gchar** err_msg)
 
     *err_msg = NULL;
 
+    /* Recoloring a rule doesn't change which frames it matches. */
+    if (color_filter_list != NULL && color_filters_update_colors(tmp_cfl, edit_cfl))
+        return TRUE;
+
     /* "move" old entries to the deleted list
      * we must keep them until the dissection no longer needs them */
     color_filter_deleted_list = g_slist_concat(color_filter_deleted_list, color_filter_list);
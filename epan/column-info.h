@@ -43,6 +43,7 @@ typedef struct {
   gchar              *col_buf;              /**< Buffer into which to copy data for column */
   int                 col_fence;            /**< Stuff in column buffer before this index is immutable */
   gboolean            writable;             /**< writable or not */
+  gboolean            needed;               /**< anything will look at this column's data */
 } col_item_t;
 
 /** Column info */
@@ -71,6 +72,12 @@ WS_DLL_PUBLIC void col_cleanup(column_info *cinfo);
  */
 extern void col_init(column_info *cinfo, const struct epan_session *epan);
 
+/** Set whether anything will look at the data for the column with the
+ * given index. Columns that aren't needed aren't filled in, and
+ * dissectors can skip formatting text that would only go into them.
+ */
+WS_DLL_PUBLIC void col_set_needed(column_info *cinfo, const gint col, const gboolean needed);
+
 /** Fill in all columns of the given packet which are based on values from frame_data.
  */
 WS_DLL_PUBLIC void col_fill_in_frame_data(const frame_data *fd, column_info *cinfo, const gint col, gboolean const fill_col_exprs);
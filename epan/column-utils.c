@@ -32,6 +32,7 @@
 #include <epan/epan.h>
 #include <epan/dfilter/dfilter.h>
 
+#include <wsutil/time_util.h>
 #include <wsutil/utf8_entities.h>
 #include <wsutil/ws_assert.h>
 #include <wsutil/unicode-utils.h>
@@ -63,6 +64,7 @@ col_setup(column_info *cinfo, const gint num_cols)
   cinfo->col_last              = g_new(int, NUM_COL_FMTS);
   for (i = 0; i < num_cols; i++) {
     cinfo->columns[i].col_custom_fields_ids = NULL;
+    cinfo->columns[i].needed = TRUE;
   }
   cinfo->col_expr.col_expr     = g_new(const gchar*, num_cols + 1);
   cinfo->col_expr.col_expr_val = g_new(gchar*, num_cols + 1);
@@ -164,7 +166,7 @@ col_get_writable(column_info *cinfo, const gint col)
   if (cinfo->col_first[col] >= 0) {
     for (i = cinfo->col_first[col]; i <= cinfo->col_last[col]; i++) {
       col_item = &cinfo->columns[i];
-      if (col_item->fmt_matx[col]) {
+      if (col_item->fmt_matx[col] && col_item->needed) {
         return col_item->writable;
       }
     }
@@ -172,6 +174,15 @@ col_get_writable(column_info *cinfo, const gint col)
   return FALSE;
 }
 
+void
+col_set_needed(column_info *cinfo, const gint col, const gboolean needed)
+{
+  ws_assert(cinfo);
+  ws_assert(col < cinfo->num_cols);
+
+  cinfo->columns[col].needed = needed;
+}
+
 void
 col_set_writable(column_info *cinfo, const gint col, const gboolean writable)
 {
@@ -351,6 +362,7 @@ void col_custom_set_edt(epan_dissect_t *edt, column_info *cinfo)
        i <= cinfo->col_last[COL_CUSTOM]; i++) {
     col_item = &cinfo->columns[i];
     if (col_item->fmt_matx[COL_CUSTOM] &&
+        col_item->needed &&
         col_item->col_custom_fields &&
         col_item->col_custom_fields_ids) {
         col_item->col_data = col_item->col_buf;
@@ -377,6 +389,7 @@ col_custom_prime_edt(epan_dissect_t *edt, column_info *cinfo)
     col_item = &cinfo->columns[i];
 
     if (col_item->fmt_matx[COL_CUSTOM] &&
+        col_item->needed &&
         col_item->col_custom_dfilter) {
       epan_dissect_prime_with_dfilter(edt, col_item->col_custom_dfilter);
     }
@@ -929,118 +942,114 @@ col_has_time_fmt(column_info *cinfo, const gint col)
           (col_item->fmt_matx[COL_DELTA_TIME_DIS]));
 }
 
+/* Returns the precision with which to show the frame's timestamp. */
+static int
+get_frame_tsprecision(const frame_data *fd)
+{
+  switch (timestamp_get_precision()) {
+  case TS_PREC_FIXED_SEC:
+    return WTAP_TSPREC_SEC;
+  case TS_PREC_FIXED_DSEC:
+    return WTAP_TSPREC_DSEC;
+  case TS_PREC_FIXED_CSEC:
+    return WTAP_TSPREC_CSEC;
+  case TS_PREC_FIXED_MSEC:
+    return WTAP_TSPREC_MSEC;
+  case TS_PREC_FIXED_USEC:
+    return WTAP_TSPREC_USEC;
+  case TS_PREC_FIXED_NSEC:
+    return WTAP_TSPREC_NSEC;
+  case TS_PREC_AUTO:
+    return fd->tsprec;
+  default:
+    ws_assert_not_reached();
+  }
+}
+
+static const struct tm *
+get_frame_abs_tm(const frame_data *fd, gboolean local)
+{
+  if (!fd->has_ts)
+    return NULL;
+  if (local)
+    return ws_localtime_cached(fd->abs_ts.secs);
+  return ws_gmtime_cached(fd->abs_ts.secs);
+}
+
+/*
+ * The absolute time columns are formatted for every row that's drawn,
+ * so they're built up by hand rather than with snprintf().
+ *
+ * put_dec() writes val as exactly width decimal digits, padded with
+ * zeroes; put_frac_secs() writes the decimal point and the fraction of
+ * a second, with tsprecision digits (the WTAP_TSPREC_ values are the
+ * number of digits).
+ */
+static inline gchar *
+put_dec(gchar *p, guint val, int width)
+{
+  for (int i = width - 1; i >= 0; i--) {
+    p[i] = '0' + (val % 10);
+    val /= 10;
+  }
+  return p + width;
+}
+
+static gchar *
+put_year(gchar *p, int year)
+{
+  if (year >= 0 && year <= 9999)
+    return put_dec(p, year, 4);
+  return p + snprintf(p, 16, "%04d", year);
+}
+
+static gchar *
+put_hms(gchar *p, const struct tm *tmp)
+{
+  p = put_dec(p, tmp->tm_hour, 2);
+  *p++ = ':';
+  p = put_dec(p, tmp->tm_min, 2);
+  *p++ = ':';
+  return put_dec(p, tmp->tm_sec, 2);
+}
+
+static gchar *
+put_frac_secs(gchar *p, const char *decimal_point, gint32 nsecs, int tsprecision)
+{
+  guint frac = (guint)nsecs;
+
+  ws_assert(tsprecision >= WTAP_TSPREC_SEC && tsprecision <= WTAP_TSPREC_NSEC);
+  if (tsprecision == WTAP_TSPREC_SEC)
+    return p;
+
+  while (*decimal_point != '\0')
+    *p++ = *decimal_point++;
+  for (int i = tsprecision; i < WTAP_TSPREC_NSEC; i++)
+    frac /= 10;
+  return put_dec(p, frac, tsprecision);
+}
+
 static void
 set_abs_ymd_time(const frame_data *fd, gchar *buf, char *decimal_point, gboolean local)
 {
-  struct tm *tmp;
-  time_t then;
-  int tsprecision;
+  const struct tm *tmp;
+  gchar *p;
 
-  if (fd->has_ts) {
-    then = fd->abs_ts.secs;
-    if (local)
-      tmp = localtime(&then);
-    else
-      tmp = gmtime(&then);
-  } else
-    tmp = NULL;
-  if (tmp != NULL) {
-    switch (timestamp_get_precision()) {
-    case TS_PREC_FIXED_SEC:
-      tsprecision = WTAP_TSPREC_SEC;
-      break;
-    case TS_PREC_FIXED_DSEC:
-      tsprecision = WTAP_TSPREC_DSEC;
-      break;
-    case TS_PREC_FIXED_CSEC:
-      tsprecision = WTAP_TSPREC_CSEC;
-      break;
-    case TS_PREC_FIXED_MSEC:
-      tsprecision = WTAP_TSPREC_MSEC;
-      break;
-    case TS_PREC_FIXED_USEC:
-      tsprecision = WTAP_TSPREC_USEC;
-      break;
-    case TS_PREC_FIXED_NSEC:
-      tsprecision = WTAP_TSPREC_NSEC;
-      break;
-    case TS_PREC_AUTO:
-      tsprecision = fd->tsprec;
-      break;
-    default:
-      ws_assert_not_reached();
-    }
-    switch (tsprecision) {
-    case WTAP_TSPREC_SEC:
-      snprintf(buf, COL_MAX_LEN,"%04d-%02d-%02d %02d:%02d:%02d",
-        tmp->tm_year + 1900,
-        tmp->tm_mon + 1,
-        tmp->tm_mday,
-        tmp->tm_hour,
-        tmp->tm_min,
-        tmp->tm_sec);
-      break;
-    case WTAP_TSPREC_DSEC:
-      snprintf(buf, COL_MAX_LEN,"%04d-%02d-%02d %02d:%02d:%02d%s%01d",
-        tmp->tm_year + 1900,
-        tmp->tm_mon + 1,
-        tmp->tm_mday,
-        tmp->tm_hour,
-        tmp->tm_min,
-        tmp->tm_sec,
-        decimal_point,
-        fd->abs_ts.nsecs / 100000000);
-      break;
-    case WTAP_TSPREC_CSEC:
-      snprintf(buf, COL_MAX_LEN,"%04d-%02d-%02d %02d:%02d:%02d%s%02d",
-        tmp->tm_year + 1900,
-        tmp->tm_mon + 1,
-        tmp->tm_mday,
-        tmp->tm_hour,
-        tmp->tm_min,
-        tmp->tm_sec,
-        decimal_point,
-        fd->abs_ts.nsecs / 10000000);
-      break;
-    case WTAP_TSPREC_MSEC:
-      snprintf(buf, COL_MAX_LEN, "%04d-%02d-%02d %02d:%02d:%02d%s%03d",
-        tmp->tm_year + 1900,
-        tmp->tm_mon + 1,
-        tmp->tm_mday,
-        tmp->tm_hour,
-        tmp->tm_min,
-        tmp->tm_sec,
-        decimal_point,
-        fd->abs_ts.nsecs / 1000000);
-      break;
-    case WTAP_TSPREC_USEC:
-      snprintf(buf, COL_MAX_LEN, "%04d-%02d-%02d %02d:%02d:%02d%s%06d",
-        tmp->tm_year + 1900,
-        tmp->tm_mon + 1,
-        tmp->tm_mday,
-        tmp->tm_hour,
-        tmp->tm_min,
-        tmp->tm_sec,
-        decimal_point,
-        fd->abs_ts.nsecs / 1000);
-      break;
-    case WTAP_TSPREC_NSEC:
-      snprintf(buf, COL_MAX_LEN, "%04d-%02d-%02d %02d:%02d:%02d%s%09d",
-        tmp->tm_year + 1900,
-        tmp->tm_mon + 1,
-        tmp->tm_mday,
-        tmp->tm_hour,
-        tmp->tm_min,
-        tmp->tm_sec,
-        decimal_point,
-        fd->abs_ts.nsecs);
-      break;
-    default:
-      ws_assert_not_reached();
-    }
-  } else {
+  tmp = get_frame_abs_tm(fd, local);
+  if (tmp == NULL) {
     buf[0] = '\0';
+    return;
   }
+
+  p = put_year(buf, tmp->tm_year + 1900);
+  *p++ = '-';
+  p = put_dec(p, tmp->tm_mon + 1, 2);
+  *p++ = '-';
+  p = put_dec(p, tmp->tm_mday, 2);
+  *p++ = ' ';
+  p = put_hms(p, tmp);
+  p = put_frac_secs(p, decimal_point, fd->abs_ts.nsecs, get_frame_tsprecision(fd));
+  *p = '\0';
 }
 
 static void
@@ -1066,109 +1075,22 @@ col_set_utc_ymd_time(const frame_data *fd, column_info *cinfo, const int col)
 static void
 set_abs_ydoy_time(const frame_data *fd, gchar *buf, char *decimal_point, gboolean local)
 {
-  struct tm *tmp;
-  time_t then;
-  int tsprecision;
+  const struct tm *tmp;
+  gchar *p;
 
-  if (fd->has_ts) {
-    then = fd->abs_ts.secs;
-    if (local)
-      tmp = localtime(&then);
-    else
-      tmp = gmtime(&then);
-  } else
-    tmp = NULL;
-  if (tmp != NULL) {
-    switch (timestamp_get_precision()) {
-    case TS_PREC_FIXED_SEC:
-      tsprecision = WTAP_TSPREC_SEC;
-      break;
-    case TS_PREC_FIXED_DSEC:
-      tsprecision = WTAP_TSPREC_DSEC;
-      break;
-    case TS_PREC_FIXED_CSEC:
-      tsprecision = WTAP_TSPREC_CSEC;
-      break;
-    case TS_PREC_FIXED_MSEC:
-      tsprecision = WTAP_TSPREC_MSEC;
-      break;
-    case TS_PREC_FIXED_USEC:
-      tsprecision = WTAP_TSPREC_USEC;
-      break;
-    case TS_PREC_FIXED_NSEC:
-      tsprecision = WTAP_TSPREC_NSEC;
-      break;
-    case TS_PREC_AUTO:
-      tsprecision = fd->tsprec;
-      break;
-    default:
-      ws_assert_not_reached();
-    }
-    switch (tsprecision) {
-    case WTAP_TSPREC_SEC:
-      snprintf(buf, COL_MAX_LEN,"%04d/%03d %02d:%02d:%02d",
-        tmp->tm_year + 1900,
-        tmp->tm_yday + 1,
-        tmp->tm_hour,
-        tmp->tm_min,
-        tmp->tm_sec);
-      break;
-    case WTAP_TSPREC_DSEC:
-      snprintf(buf, COL_MAX_LEN,"%04d/%03d %02d:%02d:%02d%s%01d",
-        tmp->tm_year + 1900,
-        tmp->tm_yday + 1,
-        tmp->tm_hour,
-        tmp->tm_min,
-        tmp->tm_sec,
-        decimal_point,
-        fd->abs_ts.nsecs / 100000000);
-      break;
-    case WTAP_TSPREC_CSEC:
-      snprintf(buf, COL_MAX_LEN,"%04d/%03d %02d:%02d:%02d%s%02d",
-        tmp->tm_year + 1900,
-        tmp->tm_yday + 1,
-        tmp->tm_hour,
-        tmp->tm_min,
-        tmp->tm_sec,
-        decimal_point,
-        fd->abs_ts.nsecs / 10000000);
-      break;
-    case WTAP_TSPREC_MSEC:
-      snprintf(buf, COL_MAX_LEN, "%04d/%03d %02d:%02d:%02d%s%03d",
-        tmp->tm_year + 1900,
-        tmp->tm_yday + 1,
-        tmp->tm_hour,
-        tmp->tm_min,
-        tmp->tm_sec,
-        decimal_point,
-        fd->abs_ts.nsecs / 1000000);
-      break;
-    case WTAP_TSPREC_USEC:
-      snprintf(buf, COL_MAX_LEN, "%04d/%03d %02d:%02d:%02d%s%06d",
-        tmp->tm_year + 1900,
-        tmp->tm_yday + 1,
-        tmp->tm_hour,
-        tmp->tm_min,
-        tmp->tm_sec,
-        decimal_point,
-        fd->abs_ts.nsecs / 1000);
-      break;
-    case WTAP_TSPREC_NSEC:
-      snprintf(buf, COL_MAX_LEN, "%04d/%03d %02d:%02d:%02d%s%09d",
-        tmp->tm_year + 1900,
-        tmp->tm_yday + 1,
-        tmp->tm_hour,
-        tmp->tm_min,
-        tmp->tm_sec,
-        decimal_point,
-        fd->abs_ts.nsecs);
-      break;
-    default:
-      ws_assert_not_reached();
-    }
-  } else {
+  tmp = get_frame_abs_tm(fd, local);
+  if (tmp == NULL) {
     buf[0] = '\0';
+    return;
   }
+
+  p = put_year(buf, tmp->tm_year + 1900);
+  *p++ = '/';
+  p = put_dec(p, tmp->tm_yday + 1, 3);
+  *p++ = ' ';
+  p = put_hms(p, tmp);
+  p = put_frac_secs(p, decimal_point, fd->abs_ts.nsecs, get_frame_tsprecision(fd));
+  *p = '\0';
 }
 
 static void
@@ -1533,98 +1455,18 @@ col_set_delta_time_dis(const frame_data *fd, column_info *cinfo, const int col)
 static void
 set_abs_time(const frame_data *fd, gchar *buf, char *decimal_point, gboolean local)
 {
-  struct tm *tmp;
-  time_t then;
-  int tsprecision;
-
-  if (fd->has_ts) {
-    then = fd->abs_ts.secs;
-    if (local)
-      tmp = localtime(&then);
-    else
-      tmp = gmtime(&then);
-  } else
-    tmp = NULL;
-  if (tmp != NULL) {
-    switch (timestamp_get_precision()) {
-    case TS_PREC_FIXED_SEC:
-      tsprecision = WTAP_TSPREC_SEC;
-      break;
-    case TS_PREC_FIXED_DSEC:
-      tsprecision = WTAP_TSPREC_DSEC;
-      break;
-    case TS_PREC_FIXED_CSEC:
-      tsprecision = WTAP_TSPREC_CSEC;
-      break;
-    case TS_PREC_FIXED_MSEC:
-      tsprecision = WTAP_TSPREC_MSEC;
-      break;
-    case TS_PREC_FIXED_USEC:
-      tsprecision = WTAP_TSPREC_USEC;
-      break;
-    case TS_PREC_FIXED_NSEC:
-      tsprecision = WTAP_TSPREC_NSEC;
-      break;
-    case TS_PREC_AUTO:
-      tsprecision = fd->tsprec;
-      break;
-    default:
-      ws_assert_not_reached();
-    }
-    switch (tsprecision) {
-    case WTAP_TSPREC_SEC:
-      snprintf(buf, COL_MAX_LEN,"%02d:%02d:%02d",
-        tmp->tm_hour,
-        tmp->tm_min,
-        tmp->tm_sec);
-      break;
-    case WTAP_TSPREC_DSEC:
-      snprintf(buf, COL_MAX_LEN,"%02d:%02d:%02d%s%01d",
-        tmp->tm_hour,
-        tmp->tm_min,
-        tmp->tm_sec,
-        decimal_point,
-        fd->abs_ts.nsecs / 100000000);
-      break;
-    case WTAP_TSPREC_CSEC:
-      snprintf(buf, COL_MAX_LEN,"%02d:%02d:%02d%s%02d",
-        tmp->tm_hour,
-        tmp->tm_min,
-        tmp->tm_sec,
-        decimal_point,
-        fd->abs_ts.nsecs / 10000000);
-      break;
-    case WTAP_TSPREC_MSEC:
-      snprintf(buf, COL_MAX_LEN,"%02d:%02d:%02d%s%03d",
-        tmp->tm_hour,
-        tmp->tm_min,
-        tmp->tm_sec,
-        decimal_point,
-        fd->abs_ts.nsecs / 1000000);
-      break;
-    case WTAP_TSPREC_USEC:
-      snprintf(buf, COL_MAX_LEN,"%02d:%02d:%02d%s%06d",
-        tmp->tm_hour,
-        tmp->tm_min,
-        tmp->tm_sec,
-        decimal_point,
-        fd->abs_ts.nsecs / 1000);
-      break;
-    case WTAP_TSPREC_NSEC:
-      snprintf(buf, COL_MAX_LEN, "%02d:%02d:%02d%s%09d",
-        tmp->tm_hour,
-        tmp->tm_min,
-        tmp->tm_sec,
-        decimal_point,
-        fd->abs_ts.nsecs);
-      break;
-    default:
-      ws_assert_not_reached();
-    }
+  const struct tm *tmp;
+  gchar *p;
 
-  } else {
+  tmp = get_frame_abs_tm(fd, local);
+  if (tmp == NULL) {
     *buf = '\0';
+    return;
   }
+
+  p = put_hms(buf, tmp);
+  p = put_frac_secs(p, decimal_point, fd->abs_ts.nsecs, get_frame_tsprecision(fd));
+  *p = '\0';
 }
 
 static void
@@ -2223,6 +2065,8 @@ col_fill_in(packet_info *pinfo, const gboolean fill_col_exprs, const gboolean fi
 
   for (i = 0; i < pinfo->cinfo->num_cols; i++) {
     col_item = &pinfo->cinfo->columns[i];
+    if (!col_item->needed)
+      continue;
     if (col_based_on_frame_data(pinfo->cinfo, i)) {
       if (fill_fd_colums)
         col_fill_in_frame_data(pinfo->fd, pinfo->cinfo, i, fill_col_exprs);
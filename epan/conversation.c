@@ -480,9 +480,9 @@ conversation_init(void)
         { CE_CONVERSATION_TYPE, .conversation_type_val = CONVERSATION_NONE }
     };
     char *exact_map_key = conversation_element_list_name(wmem_epan_scope(), exact_elements);
-    conversation_hashtable_exact_addr_port = wmem_map_new_autoreset(wmem_epan_scope(), wmem_file_scope(),
-                                                                    conversation_hash_element_list,
-                                                                    conversation_match_element_list);
+    conversation_hashtable_exact_addr_port = wmem_map_new_flat_autoreset(wmem_epan_scope(), wmem_file_scope(),
+                                                                         conversation_hash_element_list,
+                                                                         conversation_match_element_list);
     wmem_map_insert(conversation_hashtable_element_list, wmem_strdup(wmem_epan_scope(), exact_map_key),
                     conversation_hashtable_exact_addr_port);
 
@@ -493,9 +493,9 @@ conversation_init(void)
         { CE_CONVERSATION_TYPE, .conversation_type_val = CONVERSATION_NONE }
     };
     char *no_addr2_map_key = conversation_element_list_name(wmem_epan_scope(), no_addr2_elements);
-    conversation_hashtable_no_addr2 = wmem_map_new_autoreset(wmem_epan_scope(), wmem_file_scope(),
-                                                       conversation_hash_element_list,
-                                                       conversation_match_element_list);
+    conversation_hashtable_no_addr2 = wmem_map_new_flat_autoreset(wmem_epan_scope(), wmem_file_scope(),
+                                                            conversation_hash_element_list,
+                                                            conversation_match_element_list);
     wmem_map_insert(conversation_hashtable_element_list, wmem_strdup(wmem_epan_scope(), no_addr2_map_key),
                     conversation_hashtable_no_addr2);
 
@@ -506,9 +506,9 @@ conversation_init(void)
         { CE_CONVERSATION_TYPE, .conversation_type_val = CONVERSATION_NONE }
     };
     char *no_port2_map_key = conversation_element_list_name(wmem_epan_scope(), no_port2_elements);
-    conversation_hashtable_no_port2 = wmem_map_new_autoreset(wmem_epan_scope(), wmem_file_scope(),
-                                                       conversation_hash_element_list,
-                                                       conversation_match_element_list);
+    conversation_hashtable_no_port2 = wmem_map_new_flat_autoreset(wmem_epan_scope(), wmem_file_scope(),
+                                                            conversation_hash_element_list,
+                                                            conversation_match_element_list);
     wmem_map_insert(conversation_hashtable_element_list, wmem_strdup(wmem_epan_scope(), no_port2_map_key),
                     conversation_hashtable_no_port2);
 
@@ -518,9 +518,9 @@ conversation_init(void)
         { CE_CONVERSATION_TYPE, .conversation_type_val = CONVERSATION_NONE }
     };
     char *no_addr2_or_port2_map_key = conversation_element_list_name(wmem_epan_scope(), no_addr2_or_port2_elements);
-    conversation_hashtable_no_addr2_or_port2 = wmem_map_new_autoreset(wmem_epan_scope(), wmem_file_scope(),
-                                                                    conversation_hash_element_list,
-                                                                    conversation_match_element_list);
+    conversation_hashtable_no_addr2_or_port2 = wmem_map_new_flat_autoreset(wmem_epan_scope(), wmem_file_scope(),
+                                                                         conversation_hash_element_list,
+                                                                         conversation_match_element_list);
     wmem_map_insert(conversation_hashtable_element_list, wmem_strdup(wmem_epan_scope(), no_addr2_or_port2_map_key),
                     conversation_hashtable_no_addr2_or_port2);
 
@@ -529,9 +529,9 @@ conversation_init(void)
         { CE_CONVERSATION_TYPE, .conversation_type_val = CONVERSATION_NONE }
     };
     char *id_map_key = conversation_element_list_name(wmem_epan_scope(), id_elements);
-    conversation_hashtable_id = wmem_map_new_autoreset(wmem_epan_scope(), wmem_file_scope(),
-                                                       conversation_hash_element_list,
-                                                       conversation_match_element_list);
+    conversation_hashtable_id = wmem_map_new_flat_autoreset(wmem_epan_scope(), wmem_file_scope(),
+                                                            conversation_hash_element_list,
+                                                            conversation_match_element_list);
     wmem_map_insert(conversation_hashtable_element_list, wmem_strdup(wmem_epan_scope(), id_map_key),
                     conversation_hashtable_id);
 }
@@ -674,7 +674,7 @@ conversation_t *conversation_new_full(const guint32 setup_frame, conversation_el
     char *el_list_map_key = conversation_element_list_name(wmem_epan_scope(), elements);
     wmem_map_t *el_list_map = (wmem_map_t *) wmem_map_lookup(conversation_hashtable_element_list, el_list_map_key);
     if (!el_list_map) {
-        el_list_map = wmem_map_new_autoreset(wmem_epan_scope(), wmem_file_scope(), conversation_hash_element_list,
+        el_list_map = wmem_map_new_flat_autoreset(wmem_epan_scope(), wmem_file_scope(), conversation_hash_element_list,
                 conversation_match_element_list);
         wmem_map_insert(conversation_hashtable_element_list, wmem_strdup(wmem_file_scope(), el_list_map_key), el_list_map);
     }
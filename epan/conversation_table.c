@@ -206,9 +206,35 @@ guint conversation_table_get_num(void)
     return wmem_tree_count(registered_ct_tables);
 }
 
+/** Compute the hash value for one side of a conversation.
+ *
+ * @param addr The address.
+ * @param port The port.
+ * @return Computed hash.
+ */
+static guint
+conversation_side_hash(const address *addr, guint32 port)
+{
+    guint hash_val;
+
+    hash_val = add_address_to_hash(0, addr);
+    hash_val += port;
+    hash_val += (hash_val << 10);
+    hash_val ^= (hash_val >> 6);
+    hash_val += (hash_val << 3);
+    hash_val ^= (hash_val >> 11);
+    hash_val += (hash_val << 15);
+
+    return hash_val;
+}
+
 /** Compute the hash value for two given address/port pairs.
  * (Parameter type is gconstpointer for GHashTable compatibility.)
  *
+ * The hash is the same whichever way round the pairs are, to match
+ * conversation_equal(), so that a single lookup finds the conversation
+ * for packets in either direction.
+ *
  * @param v Conversation Key. MUST point to a conv_key_t struct.
  * @return Computed key hash.
  */
@@ -218,11 +244,8 @@ conversation_hash(gconstpointer v)
     const conv_key_t *key = (const conv_key_t *)v;
     guint hash_val;
 
-    hash_val = 0;
-    hash_val = add_address_to_hash(hash_val, &key->addr1);
-    hash_val += key->port1;
-    hash_val = add_address_to_hash(hash_val, &key->addr2);
-    hash_val += key->port2;
+    hash_val = conversation_side_hash(&key->addr1, key->port1) +
+               conversation_side_hash(&key->addr2, key->port2);
     hash_val ^= key->conv_id;
 
     return hash_val;
@@ -657,7 +680,7 @@ add_conversation_table_data_with_conv_id(
                                               NULL);              /* value_destroy_func */
 
     } else { /* try to find it among the existing known conversations */
-        /* first, check in the fwd conversations */
+        /* The key matches conversations in either direction */
         conv_key_t existing_key;
         gpointer conversation_idx_hash_val;
 
@@ -668,19 +691,11 @@ add_conversation_table_data_with_conv_id(
         existing_key.conv_id = conv_id;
         if (g_hash_table_lookup_extended(ch->hashtable, &existing_key, NULL, &conversation_idx_hash_val)) {
             conv_item = &g_array_index(ch->conv_array, conv_item_t, GPOINTER_TO_UINT(conversation_idx_hash_val));
-        }
-        if (conv_item == NULL) {
-            /* then, check in the rev conversations if not found in 'fwd' */
-            existing_key.addr1 = *dst;
-            existing_key.addr2 = *src;
-            existing_key.port1 = dst_port;
-            existing_key.port2 = src_port;
-            if (g_hash_table_lookup_extended(ch->hashtable, &existing_key, NULL, &conversation_idx_hash_val)) {
-                conv_item = &g_array_index(ch->conv_array, conv_item_t, GPOINTER_TO_UINT(conversation_idx_hash_val));
-            }
-        } else {
-            /* a conversation was found in this same fwd direction */
-            is_fwd_direction = TRUE;
+            /* was it found in this same fwd direction? */
+            is_fwd_direction = conv_item->src_port == src_port &&
+                               conv_item->dst_port == dst_port &&
+                               addresses_equal(&conv_item->src_address, src) &&
+                               addresses_equal(&conv_item->dst_address, dst);
         }
     }
 
@@ -112,28 +112,6 @@ extern const UINT32 crc32_table[256];
 extern "C" {
 #endif
 
-/**
- * It is a step of the PBKDF2 (specifically the PKCS #5 v2.0) defined in
- * the RFC 2898 to derive a key (used as PMK in WPA)
- * @param ppbytes [IN] pointer to a password (sequence of between 8 and
- * 63 ASCII encoded characters)
- * @param ssid [IN] pointer to the SSID string encoded in max 32 ASCII
- * encoded characters
- * @param iterations [IN] times to hash the password (4096 for WPA)
- * @param count [IN] ???
- * @param output [OUT] pointer to a preallocated buffer of
- * SHA1_DIGEST_LEN characters that will contain a part of the key
- */
-static INT Dot11DecryptRsnaPwd2PskStep(
-    const guint8 *ppbytes,
-    const guint passLength,
-    const CHAR *ssid,
-    const size_t ssidLength,
-    const INT iterations,
-    const INT count,
-    UCHAR *output)
-    ;
-
 /**
  * It calculates the passphrase-to-PSK mapping reccomanded for use with
  * RSNAs. This implementation uses the PBKDF2 method defined in the RFC
@@ -153,6 +131,11 @@ static INT Dot11DecryptRsnaPwd2Psk(
     UCHAR *output)
     ;
 
+static void Dot11DecryptWildcardPwd2Psk(
+    PDOT11DECRYPT_CONTEXT ctx,
+    PDOT11DECRYPT_KEY_ITEM pkt_key)
+    ;
+
 static INT Dot11DecryptRsnaMng(
     UCHAR *decrypt_data,
     guint mac_header_len,
@@ -1128,6 +1111,16 @@ Dot11DecryptCleanSecAssoc(
     }
 }
 
+static void
+Dot11DecryptCleanPskCache(
+    PDOT11DECRYPT_CONTEXT ctx)
+{
+    if (ctx->psk_cache != NULL) {
+        g_hash_table_destroy(ctx->psk_cache);
+        ctx->psk_cache = NULL;
+    }
+}
+
 /*
  * XXX - This won't be reliable if a packet containing SSID "B" shows
  * up in the middle of a 4-way handshake for SSID "A".
@@ -1173,6 +1166,7 @@ INT Dot11DecryptInitContext(
 
     Dot11DecryptCleanKeys(ctx);
     Dot11DecryptCleanSecAssoc(ctx);
+    Dot11DecryptCleanPskCache(ctx);
 
     ctx->pkt_ssid_len = 0;
     ctx->sa_hash = g_hash_table_new_full(Dot11DecryptSaHash, Dot11DecryptIsSaIdEqual,
@@ -1180,6 +1174,8 @@ INT Dot11DecryptInitContext(
     if (ctx->sa_hash == NULL) {
         return DOT11DECRYPT_RET_UNSUCCESS;
     }
+    ctx->psk_cache = g_hash_table_new_full(g_bytes_hash, g_bytes_equal,
+                                           (GDestroyNotify)g_bytes_unref, g_free);
 
     ws_debug("Context initialized!");
     return DOT11DECRYPT_RET_SUCCESS;
@@ -1195,6 +1191,7 @@ INT Dot11DecryptDestroyContext(
 
     Dot11DecryptCleanKeys(ctx);
     Dot11DecryptCleanSecAssoc(ctx);
+    Dot11DecryptCleanPskCache(ctx);
 
     ws_debug("Context destroyed!");
     return DOT11DECRYPT_RET_SUCCESS;
@@ -1686,8 +1683,7 @@ Dot11DecryptRsna4WHandshake(
                 memcpy(&pkt_key, tmp_key, sizeof(pkt_key));
                 memcpy(&pkt_key.UserPwd.Ssid, ctx->pkt_ssid, ctx->pkt_ssid_len);
                 pkt_key.UserPwd.SsidLen = ctx->pkt_ssid_len;
-                Dot11DecryptRsnaPwd2Psk(pkt_key.UserPwd.Passphrase, pkt_key.UserPwd.Ssid,
-                    pkt_key.UserPwd.SsidLen, pkt_key.KeyData.Wpa.Psk);
+                Dot11DecryptWildcardPwd2Psk(ctx, &pkt_key);
                 tmp_pkt_key = &pkt_key;
             } else {
                 tmp_pkt_key = tmp_key;
@@ -1896,8 +1892,7 @@ Dot11DecryptScanFtAssocForKeys(
             memcpy(&pkt_key, tmp_key, sizeof(pkt_key));
             memcpy(&pkt_key.UserPwd.Ssid, ctx->pkt_ssid, ctx->pkt_ssid_len);
             pkt_key.UserPwd.SsidLen = ctx->pkt_ssid_len;
-            Dot11DecryptRsnaPwd2Psk(pkt_key.UserPwd.Passphrase, pkt_key.UserPwd.Ssid,
-                pkt_key.UserPwd.SsidLen, pkt_key.KeyData.Wpa.Psk);
+            Dot11DecryptWildcardPwd2Psk(ctx, &pkt_key);
             tmp_pkt_key = &pkt_key;
         } else {
             tmp_pkt_key = tmp_key;
@@ -2650,74 +2645,73 @@ Dot11DecryptFtDerivePtk(
 #define MAX_SSID_LENGTH 32 /* maximum SSID length */
 
 static INT
-Dot11DecryptRsnaPwd2PskStep(
-    const guint8 *ppBytes,
-    const guint ppLength,
+Dot11DecryptRsnaPwd2Psk(
+    const CHAR *passphrase,
     const CHAR *ssid,
     const size_t ssidLength,
-    const INT iterations,
-    const INT count,
     UCHAR *output)
 {
-    UCHAR digest[MAX_SSID_LENGTH+4] = { 0 };  /* SSID plus 4 bytes of count */
-    INT i, j;
+    GByteArray *pp_ba;
 
     if (ssidLength > MAX_SSID_LENGTH) {
         /* This "should not happen" */
         return DOT11DECRYPT_RET_UNSUCCESS;
     }
 
-    /* U1 = PRF(P, S || INT(i)) */
-    memcpy(digest, ssid, ssidLength);
-    digest[ssidLength] = (UCHAR)((count>>24) & 0xff);
-    digest[ssidLength+1] = (UCHAR)((count>>16) & 0xff);
-    digest[ssidLength+2] = (UCHAR)((count>>8) & 0xff);
-    digest[ssidLength+3] = (UCHAR)(count & 0xff);
-    if (ws_hmac_buffer(GCRY_MD_SHA1, digest, digest, (guint32) ssidLength + 4, ppBytes, ppLength)) {
-      return DOT11DECRYPT_RET_UNSUCCESS;
-    }
-
-    /* output = U1 */
-    memcpy(output, digest, 20);
-    for (i = 1; i < iterations; i++) {
-        /* Un = PRF(P, Un-1) */
-        if (ws_hmac_buffer(GCRY_MD_SHA1, digest, digest, HASH_SHA1_LENGTH, ppBytes, ppLength)) {
-          return DOT11DECRYPT_RET_UNSUCCESS;
-        }
-
-        /* output = output xor Un */
-        for (j = 0; j < 20; j++) {
-            output[j] ^= digest[j];
-        }
-    }
-
-    return DOT11DECRYPT_RET_SUCCESS;
-}
-
-static INT
-Dot11DecryptRsnaPwd2Psk(
-    const CHAR *passphrase,
-    const CHAR *ssid,
-    const size_t ssidLength,
-    UCHAR *output)
-{
-    UCHAR m_output[40] = { 0 };
-    GByteArray *pp_ba = g_byte_array_new();
-
+    pp_ba = g_byte_array_new();
     if (!uri_str_to_bytes(passphrase, pp_ba)) {
         g_byte_array_free(pp_ba, TRUE);
         return 0;
     }
 
-    Dot11DecryptRsnaPwd2PskStep(pp_ba->data, pp_ba->len, ssid, ssidLength, 4096, 1, m_output);
-    Dot11DecryptRsnaPwd2PskStep(pp_ba->data, pp_ba->len, ssid, ssidLength, 4096, 2, &m_output[20]);
+    /* PSK = PBKDF2(HMAC-SHA1, passphrase, ssid, 4096, 256 bits).
+     * Libgcrypt keeps one HMAC context across all iterations, which is
+     * much cheaper than opening a new one for each of the 8192 steps. */
+    if (gcry_kdf_derive(pp_ba->data, pp_ba->len, GCRY_KDF_PBKDF2, GCRY_MD_SHA1,
+                        ssid, ssidLength, 4096,
+                        DOT11DECRYPT_WPA_PWD_PSK_LEN, output)) {
+        g_byte_array_free(pp_ba, TRUE);
+        return DOT11DECRYPT_RET_UNSUCCESS;
+    }
 
-    memcpy(output, m_output, DOT11DECRYPT_WPA_PWD_PSK_LEN);
     g_byte_array_free(pp_ba, TRUE);
 
     return 0;
 }
 
+/*
+ * Derive the PSK for a passphrase with a "wildcard" SSID, using the SSID
+ * already copied into pkt_key. The result is cached per passphrase and
+ * SSID since otherwise every handshake would repeat the derivation.
+ */
+static void
+Dot11DecryptWildcardPwd2Psk(
+    PDOT11DECRYPT_CONTEXT ctx,
+    PDOT11DECRYPT_KEY_ITEM pkt_key)
+{
+    GByteArray *key_ba = g_byte_array_new();
+    GBytes *key;
+    guint8 *psk;
+
+    g_byte_array_append(key_ba, (const guint8 *)pkt_key->UserPwd.Passphrase,
+                        (guint)strlen(pkt_key->UserPwd.Passphrase) + 1);
+    g_byte_array_append(key_ba, (const guint8 *)pkt_key->UserPwd.Ssid,
+                        (guint)pkt_key->UserPwd.SsidLen);
+    key = g_byte_array_free_to_bytes(key_ba);
+
+    psk = (guint8 *)g_hash_table_lookup(ctx->psk_cache, key);
+    if (psk != NULL) {
+        memcpy(pkt_key->KeyData.Wpa.Psk, psk, DOT11DECRYPT_WPA_PWD_PSK_LEN);
+        g_bytes_unref(key);
+        return;
+    }
+
+    Dot11DecryptRsnaPwd2Psk(pkt_key->UserPwd.Passphrase, pkt_key->UserPwd.Ssid,
+        pkt_key->UserPwd.SsidLen, pkt_key->KeyData.Wpa.Psk);
+    g_hash_table_insert(ctx->psk_cache, key,
+                        g_memdup2(pkt_key->KeyData.Wpa.Psk, DOT11DECRYPT_WPA_PWD_PSK_LEN));
+}
+
 /*
  * Returns the decryption_key_t struct given a string describing the key.
  * Returns NULL if the input_string cannot be parsed.
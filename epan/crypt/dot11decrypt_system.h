@@ -128,6 +128,7 @@ typedef struct _DOT11DECRYPT_SEC_ASSOCIATION {
 
 typedef struct _DOT11DECRYPT_CONTEXT {
 	GHashTable *sa_hash;
+	GHashTable *psk_cache;	/* (passphrase, SSID) -> derived PSK */
 	DOT11DECRYPT_KEY_ITEM keys[DOT11DECRYPT_MAX_KEYS_NR];
 	size_t keys_nr;
 	CHAR pkt_ssid[DOT11DECRYPT_WPA_SSID_MAX_LEN];
@@ -25,8 +25,9 @@ typedef struct {
 /* Passed back to user */
 struct epan_dfilter {
 	GPtrArray	*insns;
+	int		ref_count;
 	guint		num_registers;
-	GSList		**registers;
+	GPtrArray	**registers;
 	gboolean	*attempted_load;
 	GDestroyNotify	*free_registers;
 	int		*interesting_fields;
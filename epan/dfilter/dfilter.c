@@ -98,6 +98,78 @@ dfilter_resolve_unparsed(dfsyntax_t *dfs, const char *name)
 	return NULL;
 }
 
+/* Compiled filters, keyed by the compile flags and the expanded filter
+ * text, so that a filter used by several coloring rules, taps and dialogs
+ * is only compiled once. The cache holds a reference to each filter and
+ * is flushed when the set of registered fields changes. */
+#define FILTER_CACHE_MAX	256
+#define FILTER_CACHE_SKIP_FLAGS	(DF_DEBUG_FLEX|DF_DEBUG_LEMON)
+
+static GHashTable *filter_cache = NULL;
+static guint filter_cache_generation = 0;
+
+static char *
+filter_cache_key(const char *expanded_text, unsigned flags)
+{
+	return g_strdup_printf("%x:%s", flags, expanded_text);
+}
+
+/* Returns FALSE if the cache can't be used for these flags. */
+static gboolean
+filter_cache_validate(unsigned flags)
+{
+	if (filter_cache == NULL || (flags & FILTER_CACHE_SKIP_FLAGS))
+		return FALSE;
+
+	if (filter_cache_generation != proto_registrar_generation()) {
+		/* Fields were added or removed; the filters may refer to
+		 * fields that no longer exist or miss new ones. */
+		g_hash_table_remove_all(filter_cache);
+		filter_cache_generation = proto_registrar_generation();
+	}
+	return TRUE;
+}
+
+static dfilter_t *
+filter_cache_lookup(const char *expanded_text, unsigned flags)
+{
+	char *key;
+	dfilter_t *df;
+
+	if (!filter_cache_validate(flags))
+		return NULL;
+
+	key = filter_cache_key(expanded_text, flags);
+	df = g_hash_table_lookup(filter_cache, key);
+	g_free(key);
+	if (df)
+		df->ref_count++;
+	return df;
+}
+
+static gboolean
+filter_cache_unused(gpointer key _U_, gpointer value, gpointer user_data _U_)
+{
+	return ((dfilter_t *)value)->ref_count == 1;
+}
+
+static void
+filter_cache_insert(const char *expanded_text, unsigned flags, dfilter_t *df)
+{
+	if (!filter_cache_validate(flags))
+		return;
+
+	if (g_hash_table_size(filter_cache) >= FILTER_CACHE_MAX) {
+		/* Drop the filters nobody else is using. */
+		g_hash_table_foreach_remove(filter_cache, filter_cache_unused, NULL);
+		if (g_hash_table_size(filter_cache) >= FILTER_CACHE_MAX)
+			return;
+	}
+
+	df->ref_count++;
+	g_hash_table_insert(filter_cache, filter_cache_key(expanded_text, flags), df);
+}
+
 /* Initialize the dfilter module */
 void
 dfilter_init(void)
@@ -114,12 +186,21 @@ dfilter_init(void)
 	sttype_init();
 
 	dfilter_macro_init();
+
+	filter_cache = g_hash_table_new_full(g_str_hash, g_str_equal,
+					g_free, (GDestroyNotify)dfilter_free);
+	filter_cache_generation = proto_registrar_generation();
 }
 
 /* Clean-up the dfilter module */
 void
 dfilter_cleanup(void)
 {
+	if (filter_cache) {
+		g_hash_table_destroy(filter_cache);
+		filter_cache = NULL;
+	}
+
 	dfilter_macro_cleanup();
 
 	/* Free the Lemon Parser object */
@@ -137,6 +218,7 @@ dfilter_new(GPtrArray *deprecated)
 	dfilter_t	*df;
 
 	df = g_new0(dfilter_t, 1);
+	df->ref_count = 1;
 	df->insns = NULL;
 	df->function_stack = NULL;
 	df->warnings = NULL;
@@ -166,6 +248,10 @@ dfilter_free(dfilter_t *df)
 	if (!df)
 		return;
 
+	/* The filter may still be shared through the compile cache. */
+	if (--df->ref_count > 0)
+		return;
+
 	if (df->insns) {
 		free_insns(df->insns);
 	}
@@ -186,6 +272,8 @@ dfilter_free(dfilter_t *df)
 	if (df->warnings)
 		g_slist_free_full(df->warnings, g_free);
 
+	for (guint i = 0; i < df->num_registers; i++)
+		g_ptr_array_free(df->registers[i], TRUE);
 	g_free(df->registers);
 	g_free(df->attempted_load);
 	g_free(df->free_registers);
@@ -506,7 +594,9 @@ dfwork_build(dfwork_t *dfw)
 
 	/* Initialize run-time space */
 	dfilter->num_registers = dfw->next_register;
-	dfilter->registers = g_new0(GSList *, dfilter->num_registers);
+	dfilter->registers = g_new0(GPtrArray *, dfilter->num_registers);
+	for (guint i = 0; i < dfilter->num_registers; i++)
+		dfilter->registers[i] = g_ptr_array_new();
 	dfilter->attempted_load = g_new0(gboolean, dfilter->num_registers);
 	dfilter->free_registers = g_new0(GDestroyNotify, dfilter->num_registers);
 
@@ -627,14 +717,26 @@ dfilter_compile_full(const gchar *text, dfilter_t **dfp,
 		ws_noisy("Verbatim text: %s", expanded_text);
 	}
 
+	dfcode = filter_cache_lookup(expanded_text, flags);
+	if (dfcode != NULL) {
+		g_free(expanded_text);
+		*dfp = dfcode;
+		ws_debug("Reusing compiled display filter: %s", text);
+		return TRUE;
+	}
+
 	dfcode = compile_filter(expanded_text, flags, &error);
-	g_free(expanded_text);
-	expanded_text = NULL;
 
 	if(error != NULL) {
+		g_free(expanded_text);
 		return compile_failure(error, err_ptr);
 	}
 
+	if (dfcode != NULL)
+		filter_cache_insert(expanded_text, flags, dfcode);
+	g_free(expanded_text);
+	expanded_text = NULL;
+
 	*dfp = dfcode;
 	ws_log(WS_LOG_DOMAIN, LOG_LEVEL_INFO, "Compiled display filter: %s", text);
 	return TRUE;
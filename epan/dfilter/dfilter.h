@@ -78,8 +78,11 @@ dfilter_expand(const char *expr, df_error_t **err_ret);
  * On success, sets the dfilter* pointed to by dfp
  * to either a NULL pointer (if the filter is a null
  * filter, as generated by an all-blank string) or to
- * a pointer to the newly-allocated dfilter_t
- * structure.
+ * a pointer to the dfilter_t structure. Compiled
+ * filters are cached, so compiling the same text with
+ * the same flags again returns another reference to the
+ * same dfilter_t; either way it must be released with
+ * dfilter_free().
  *
  * On failure, *err_msg is set to point to the error
  * message.  This error message is allocated with
@@ -99,8 +102,8 @@ dfilter_compile_full(const gchar *text, dfilter_t **dfp,
 				DF_EXPAND_MACROS|DF_OPTIMIZE, \
 				__func__)
 
-/* Frees all memory used by dfilter, and frees
- * the dfilter itself. */
+/* Releases a reference to the dfilter, and frees all
+ * memory used by it once the last reference is gone. */
 WS_DLL_PUBLIC
 void
 dfilter_free(dfilter_t *df);
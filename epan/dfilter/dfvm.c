@@ -11,11 +11,14 @@
 
 #include "dfvm.h"
 
+#include <string.h>
+
 #include <ftypes/ftypes.h>
+#include <epan/exceptions.h>
 #include <wsutil/ws_assert.h>
 
 static void
-debug_register(GSList *reg, guint32 num);
+debug_register(GPtrArray *reg, guint32 num);
 
 const char *
 dfvm_opcode_tostr(dfvm_opcode_t code)
@@ -63,6 +66,9 @@ dfvm_opcode_tostr(dfvm_opcode_t code)
 		case DFVM_STACK_PUSH:		return "STACK_PUSH";
 		case DFVM_STACK_POP:		return "STACK_POP";
 		case DFVM_NOT_ALL_ZERO:		return "NOT_ALL_ZERO";
+		case DFVM_CMP_TREE:		return "CMP_TREE";
+		case DFVM_ANY_CONTAINS_ANY:	return "ANY_CONTAINS_ANY";
+		case DFVM_ANY_IN_SET:		return "ANY_IN_SET";
 	}
 	return "(fix-opcode-string)";
 }
@@ -80,6 +86,300 @@ dfvm_insn_new(dfvm_opcode_t op)
 	return insn;
 }
 
+/*
+ * A set of constant byte strings, compiled into an Aho-Corasick
+ * automaton, so that "field contains "a" or field contains "b" or ..."
+ * can be tested with a single pass over each field value, however many
+ * strings there are. See gen_contains_any() in gencode.c.
+ *
+ * The automaton is a complete DFA, with a transition for every byte
+ * value out of every state, so the scan is one table lookup per byte.
+ * That's 1 KiB per state, hence the limit on the total length of
+ * the patterns.
+ */
+#define PATTERNS_MAX_STATES	8192
+#define PATTERNS_NO_STATE	G_MAXUINT32
+
+struct _dfvm_patterns {
+	ftenum_t	ftype;		/* type of the patterns and of the field */
+	GPtrArray	*fvalues;	/* the patterns, for dumping and for the slow path */
+	guint32		*next;		/* [state * 256 + byte] -> state */
+	guint8		*accept;	/* [state] -> a pattern ends here */
+	guint32		num_states;
+};
+
+static void
+get_pattern_bytes(fvalue_t *fv, const guint8 **data, size_t *len)
+{
+	tvbuff_t *tvb;
+
+	if (fvalue_type_ftenum(fv) == FT_PROTOCOL) {
+		/* A constant, so a private tvbuff with real data. */
+		tvb = fvalue_get_protocol(fv);
+		*len = tvb != NULL ? tvb_captured_length(tvb) : 0;
+		*data = *len > 0 ? tvb_get_ptr(tvb, 0, (gint)*len) : NULL;
+	}
+	else {
+		*data = fvalue_get_bytes_data(fv);
+		*len = fvalue_get_bytes_size(fv);
+	}
+}
+
+/* Returns NULL if the patterns can't be matched this way, in which
+ * case they should be tested one at a time. The fvalues are copied. */
+dfvm_patterns_t *
+dfvm_patterns_new(GPtrArray *fvalues)
+{
+	dfvm_patterns_t	*p;
+	ftenum_t	ftype;
+	const guint8	*data;
+	size_t		len, total = 1;
+	guint32		*fail, *queue, head, tail;
+	guint32		state, t, f;
+	guint		i, c;
+
+	if (fvalues->len == 0)
+		return NULL;
+
+	ftype = fvalue_type_ftenum(g_ptr_array_index(fvalues, 0));
+	if (ftype != FT_PROTOCOL && ftype != FT_BYTES && ftype != FT_UINT_BYTES)
+		return NULL;
+
+	for (i = 0; i < fvalues->len; i++) {
+		if (fvalue_type_ftenum(g_ptr_array_index(fvalues, i)) != ftype)
+			return NULL;
+		get_pattern_bytes(g_ptr_array_index(fvalues, i), &data, &len);
+		/* "contains" with an empty string isn't consistent
+		 * between types; leave that to fvalue_contains(). */
+		if (len == 0)
+			return NULL;
+		total += len;
+		if (total > PATTERNS_MAX_STATES)
+			return NULL;
+	}
+
+	p = g_new(dfvm_patterns_t, 1);
+	p->ftype = ftype;
+	p->fvalues = g_ptr_array_new_full(fvalues->len, (GDestroyNotify)fvalue_free);
+	p->next = g_new(guint32, total * 256);
+	memset(p->next, 0xff, total * 256 * sizeof(guint32));
+	p->accept = g_new0(guint8, total);
+	p->num_states = 1;
+
+	/* Build the trie of the patterns; state 0 is the root. */
+	for (i = 0; i < fvalues->len; i++) {
+		g_ptr_array_add(p->fvalues, fvalue_dup(g_ptr_array_index(fvalues, i)));
+		get_pattern_bytes(g_ptr_array_index(fvalues, i), &data, &len);
+		state = 0;
+		for (size_t j = 0; j < len; j++) {
+			t = p->next[state * 256 + data[j]];
+			if (t == PATTERNS_NO_STATE) {
+				t = p->num_states++;
+				p->next[state * 256 + data[j]] = t;
+			}
+			state = t;
+		}
+		p->accept[state] = TRUE;
+	}
+
+	/* Fill in the missing transitions, breadth first, so that the
+	 * failure state of a state (the longest proper suffix of its path
+	 * that's also in the trie) is complete before the state itself. */
+	fail = g_new(guint32, p->num_states);
+	queue = g_new(guint32, p->num_states);
+	head = tail = 0;
+	for (c = 0; c < 256; c++) {
+		t = p->next[c];
+		if (t == PATTERNS_NO_STATE) {
+			p->next[c] = 0;
+		}
+		else {
+			fail[t] = 0;
+			queue[tail++] = t;
+		}
+	}
+	while (head < tail) {
+		state = queue[head++];
+		if (p->accept[fail[state]])
+			p->accept[state] = TRUE;
+		for (c = 0; c < 256; c++) {
+			t = p->next[state * 256 + c];
+			f = p->next[fail[state] * 256 + c];
+			if (t == PATTERNS_NO_STATE) {
+				p->next[state * 256 + c] = f;
+			}
+			else {
+				fail[t] = f;
+				queue[tail++] = t;
+			}
+		}
+	}
+	g_free(fail);
+	g_free(queue);
+
+	return p;
+}
+
+static void
+dfvm_patterns_free(dfvm_patterns_t *p)
+{
+	g_ptr_array_free(p->fvalues, TRUE);
+	g_free(p->next);
+	g_free(p->accept);
+	g_free(p);
+}
+
+static char *
+dfvm_patterns_tostr(const dfvm_patterns_t *p)
+{
+	GString	*gs;
+	char	*repr;
+
+	gs = g_string_new("{");
+	for (guint i = 0; i < p->fvalues->len; i++) {
+		repr = fvalue_to_debug_repr(NULL, g_ptr_array_index(p->fvalues, i));
+		g_string_append_printf(gs, " %s", repr);
+		g_free(repr);
+	}
+	g_string_append(gs, " }");
+	return g_string_free(gs, FALSE);
+}
+
+/*
+ * A set of constants, for "field in {...}" with a large set. Single
+ * elements for which equality is exact are kept in a hash table; ranges
+ * are kept sorted by their lower bound, with the largest upper bound seen
+ * so far, so that a value can be tested with a binary search. Anything
+ * else, such as a subnet, is tested one at a time. See gen_in_set() in
+ * gencode.c.
+ */
+typedef struct {
+	fvalue_t	*low;
+	fvalue_t	*high;
+	fvalue_t	*max_high;	/* largest high of this and the previous ranges */
+} dfvm_set_range_t;
+
+struct _dfvm_set {
+	ftenum_t	ftype;		/* type of the elements and of the field */
+	GPtrArray	*fvalues;	/* the single elements, for dumping and for the slow path */
+	GHashTable	*exact;		/* the single elements that can be hashed */
+	GPtrArray	*inexact;	/* the other single elements */
+	dfvm_set_range_t *ranges;	/* sorted by low */
+	guint		num_ranges;
+};
+
+static int
+compare_set_ranges(const void *a, const void *b)
+{
+	const dfvm_set_range_t *ra = a, *rb = b;
+
+	if (fvalue_lt(ra->low, rb->low) == FT_TRUE)
+		return -1;
+	if (fvalue_gt(ra->low, rb->low) == FT_TRUE)
+		return 1;
+	return 0;
+}
+
+/* The elements come in pairs, the element and NULL or the lower and upper
+ * bounds of a range, as in the set stnode.  Returns NULL if the set can't
+ * be tested this way, in which case the elements should be tested one at
+ * a time. The fvalues are copied. */
+dfvm_set_t *
+dfvm_set_new(GPtrArray *elements)
+{
+	dfvm_set_t	*set;
+	ftenum_t	ftype;
+	fvalue_t	*low, *high;
+	guint		i, r;
+
+	if (elements->len == 0)
+		return NULL;
+
+	ftype = fvalue_type_ftenum(g_ptr_array_index(elements, 0));
+	for (i = 0; i < elements->len; i += 2) {
+		low = g_ptr_array_index(elements, i);
+		high = g_ptr_array_index(elements, i + 1);
+		if (fvalue_type_ftenum(low) != ftype)
+			return NULL;
+		/* Ranges are only sorted for types where the order is
+		 * consistent with equality. */
+		if (high != NULL && (fvalue_type_ftenum(high) != ftype ||
+				!fvalue_eq_is_exact(low) || !fvalue_eq_is_exact(high)))
+			return NULL;
+	}
+
+	set = g_new(dfvm_set_t, 1);
+	set->ftype = ftype;
+	set->fvalues = g_ptr_array_new_with_free_func((GDestroyNotify)fvalue_free);
+	set->exact = g_hash_table_new((GHashFunc)fvalue_hash, (GEqualFunc)fvalue_equal);
+	set->inexact = g_ptr_array_new();
+	set->ranges = g_new(dfvm_set_range_t, elements->len / 2);
+	set->num_ranges = 0;
+
+	for (i = 0; i < elements->len; i += 2) {
+		low = g_ptr_array_index(elements, i);
+		high = g_ptr_array_index(elements, i + 1);
+		if (high != NULL) {
+			r = set->num_ranges++;
+			set->ranges[r].low = fvalue_dup(low);
+			set->ranges[r].high = fvalue_dup(high);
+			continue;
+		}
+		low = fvalue_dup(low);
+		g_ptr_array_add(set->fvalues, low);
+		if (fvalue_eq_is_exact(low))
+			g_hash_table_add(set->exact, low);
+		else
+			g_ptr_array_add(set->inexact, low);
+	}
+
+	qsort(set->ranges, set->num_ranges, sizeof(dfvm_set_range_t), compare_set_ranges);
+	for (r = 0; r < set->num_ranges; r++) {
+		set->ranges[r].max_high = set->ranges[r].high;
+		if (r > 0 && fvalue_lt(set->ranges[r].high, set->ranges[r - 1].max_high) == FT_TRUE)
+			set->ranges[r].max_high = set->ranges[r - 1].max_high;
+	}
+
+	return set;
+}
+
+static void
+dfvm_set_free(dfvm_set_t *set)
+{
+	for (guint r = 0; r < set->num_ranges; r++) {
+		fvalue_free(set->ranges[r].low);
+		fvalue_free(set->ranges[r].high);
+	}
+	g_free(set->ranges);
+	g_ptr_array_free(set->inexact, TRUE);
+	g_hash_table_destroy(set->exact);
+	g_ptr_array_free(set->fvalues, TRUE);
+	g_free(set);
+}
+
+static char *
+dfvm_set_tostr(const dfvm_set_t *set)
+{
+	GString	*gs;
+	char	*repr, *repr2;
+
+	gs = g_string_new("{");
+	for (guint i = 0; i < set->fvalues->len; i++) {
+		repr = fvalue_to_debug_repr(NULL, g_ptr_array_index(set->fvalues, i));
+		g_string_append_printf(gs, " %s", repr);
+		g_free(repr);
+	}
+	for (guint r = 0; r < set->num_ranges; r++) {
+		repr = fvalue_to_debug_repr(NULL, set->ranges[r].low);
+		repr2 = fvalue_to_debug_repr(NULL, set->ranges[r].high);
+		g_string_append_printf(gs, " %s..%s", repr, repr2);
+		g_free(repr);
+		g_free(repr2);
+	}
+	g_string_append(gs, " }");
+	return g_string_free(gs, FALSE);
+}
+
 static void
 dfvm_value_free(dfvm_value_t *v)
 {
@@ -93,6 +393,12 @@ dfvm_value_free(dfvm_value_t *v)
 		case PCRE:
 			ws_regex_free(v->value.pcre);
 			break;
+		case PATTERNS:
+			dfvm_patterns_free(v->value.patterns);
+			break;
+		case SET:
+			dfvm_set_free(v->value.set);
+			break;
 		case EMPTY:
 		case HFINFO:
 		case RAW_HFINFO:
@@ -212,6 +518,22 @@ dfvm_value_new_guint(guint num)
 	return v;
 }
 
+dfvm_value_t*
+dfvm_value_new_patterns(dfvm_patterns_t *patterns)
+{
+	dfvm_value_t *v = dfvm_value_new(PATTERNS);
+	v->value.patterns = patterns;
+	return v;
+}
+
+dfvm_value_t*
+dfvm_value_new_set(dfvm_set_t *set)
+{
+	dfvm_value_t *v = dfvm_value_new(SET);
+	v->value.set = set;
+	return v;
+}
+
 static char *
 dfvm_value_tostr(dfvm_value_t *v)
 {
@@ -236,6 +558,12 @@ dfvm_value_tostr(dfvm_value_t *v)
 		case PCRE:
 			s = ws_strdup(ws_regex_pattern(v->value.pcre));
 			break;
+		case PATTERNS:
+			s = dfvm_patterns_tostr(v->value.patterns);
+			break;
+		case SET:
+			s = dfvm_set_tostr(v->value.set);
+			break;
 		case REGISTER:
 			s = ws_strdup_printf("R%"G_GUINT32_FORMAT, v->value.numeric);
 			break;
@@ -267,6 +595,12 @@ value_type_tostr(dfvm_value_t *v, gboolean show_ftype)
 		case FVALUE:
 			s = fvalue_type_name(v->value.fvalue);
 			break;
+		case PATTERNS:
+			s = ftype_name(v->value.patterns->ftype);
+			break;
+		case SET:
+			s = ftype_name(v->value.set->ftype);
+			break;
 		default:
 			return ws_strdup("");
 			break;
@@ -482,6 +816,11 @@ append_op_args(wmem_strbuf_t *buf, dfvm_insn_t *insn, GSList **stack_print,
 						arg1_str, arg1_str_type, arg2_str, arg2_str_type);
 			break;
 
+		case DFVM_ANY_CONTAINS_ANY:
+			wmem_strbuf_append_printf(buf, "%s%s contains any %s%s",
+						arg1_str, arg1_str_type, arg2_str, arg2_str_type);
+			break;
+
 		case DFVM_ALL_MATCHES:
 		case DFVM_ANY_MATCHES:
 			wmem_strbuf_append_printf(buf, "%s%s matches %s%s",
@@ -494,6 +833,11 @@ append_op_args(wmem_strbuf_t *buf, dfvm_insn_t *insn, GSList **stack_print,
 						arg1_str, arg1_str_type, arg2_str, arg2_str_type, arg3_str, arg3_str_type);
 			break;
 
+		case DFVM_ANY_IN_SET:
+			wmem_strbuf_append_printf(buf, "%s%s in %s%s",
+						arg1_str, arg1_str_type, arg2_str, arg2_str_type);
+			break;
+
 		case DFVM_BITWISE_AND:
 			wmem_strbuf_append_printf(buf, "%s%s & %s%s",
 						arg1_str, arg1_str_type, arg2_str, arg2_str_type);
@@ -543,6 +887,13 @@ append_op_args(wmem_strbuf_t *buf, dfvm_insn_t *insn, GSList **stack_print,
 			append_to_register(buf, arg3_str);
 			break;
 
+		case DFVM_CMP_TREE:
+			wmem_strbuf_append_printf(buf, "%s%s %s %s%s",
+						arg1_str, arg1_str_type,
+						dfvm_opcode_tostr(arg3->value.numeric),
+						arg2_str, arg2_str_type);
+			break;
+
 		case DFVM_IF_TRUE_GOTO:
 		case DFVM_IF_FALSE_GOTO:
 			wmem_strbuf_append_printf(buf, "%u", arg1->value.numeric);
@@ -731,14 +1082,16 @@ dfvm_get_raw_fvalue(const field_info *fi)
 	return fv;
 }
 
-static GSList *
-filter_finfo_fvalues(GSList *fvalues, GPtrArray *finfos, drange_t *range, gboolean raw)
+/* Appends the values of the fields in the given layer range to fvalues,
+ * or, if fvalues is NULL, only checks whether there are any. */
+static gboolean
+filter_finfo_fvalues(GPtrArray *fvalues, GPtrArray *finfos, drange_t *range, gboolean raw)
 {
 	int length; /* maximum proto layer number. The numbers are sequential. */
 	field_info *last_finfo, *finfo;
-	fvalue_t *fv;
 	int cookie = -1;
 	gboolean cookie_matches = false;
+	gboolean found = FALSE;
 	int layer;
 
 	g_ptr_array_sort(finfos, compare_finfo_layer);
@@ -748,28 +1101,21 @@ filter_finfo_fvalues(GSList *fvalues, GPtrArray *finfos, drange_t *range, gboole
 	for (guint i = 0; i < finfos->len; i++) {
 		finfo = finfos->pdata[i];
 		layer = finfo->proto_layer_num;
-		if (cookie == layer) {
-			if (cookie_matches) {
-				if (raw)
-					fv = dfvm_get_raw_fvalue(finfo);
-				else
-					fv = finfo->value;
-				fvalues = g_slist_prepend(fvalues, fv);
-			}
-		}
-		else {
+		if (cookie != layer) {
 			cookie = layer;
 			cookie_matches = drange_contains_layer(range, layer, length);
-			if (cookie_matches) {
-				if (raw)
-					fv = dfvm_get_raw_fvalue(finfo);
-				else
-					fv = finfo->value;
-				fvalues = g_slist_prepend(fvalues, fv);
-			}
 		}
+		if (!cookie_matches)
+			continue;
+		if (fvalues == NULL)
+			return TRUE;
+		found = TRUE;
+		if (raw)
+			g_ptr_array_add(fvalues, dfvm_get_raw_fvalue(finfo));
+		else
+			g_ptr_array_add(fvalues, finfo->value);
 	}
-	return fvalues;
+	return found;
 }
 
 /* Reads a field from the proto_tree and loads the fvalues into a register,
@@ -782,8 +1128,7 @@ read_tree(dfilter_t *df, proto_tree *tree,
 	GPtrArray	*finfos;
 	field_info	*finfo;
 	int		i, len;
-	GSList		*fvalues = NULL;
-	fvalue_t	*fv;
+	GPtrArray	*fvalues;
 	drange_t	*range = NULL;
 	gboolean	raw;
 
@@ -791,6 +1136,7 @@ read_tree(dfilter_t *df, proto_tree *tree,
 	raw = arg1->type == RAW_HFINFO;
 
 	int reg = arg2->value.numeric;
+	fvalues = df->registers[reg];
 
 	if (arg3) {
 		range = arg3->value.drange;
@@ -798,7 +1144,7 @@ read_tree(dfilter_t *df, proto_tree *tree,
 
 	/* Already loaded in this run of the dfilter? */
 	if (df->attempted_load[reg]) {
-		if (df->registers[reg]) {
+		if (fvalues->len > 0) {
 			return TRUE;
 		}
 		else {
@@ -817,28 +1163,26 @@ read_tree(dfilter_t *df, proto_tree *tree,
 		}
 
 		if (range) {
-			fvalues = filter_finfo_fvalues(fvalues, finfos, range, raw);
+			filter_finfo_fvalues(fvalues, finfos, range, raw);
 		}
 		else {
 			len = finfos->len;
 			for (i = 0; i < len; i++) {
 				finfo = g_ptr_array_index(finfos, i);
 				if (raw)
-					fv = dfvm_get_raw_fvalue(finfo);
+					g_ptr_array_add(fvalues, dfvm_get_raw_fvalue(finfo));
 				else
-					fv = finfo->value;
-				fvalues = g_slist_prepend(fvalues, fv);
+					g_ptr_array_add(fvalues, finfo->value);
 			}
 		}
 
 		hfinfo = hfinfo->same_name_next;
 	}
 
-	if (fvalues == NULL) {
+	if (fvalues->len == 0) {
 		return FALSE;
 	}
 
-	df->registers[reg] = fvalues;
 	if (raw) {
 		df->free_registers[reg] = (GDestroyNotify)fvalue_free;
 	}
@@ -849,17 +1193,16 @@ read_tree(dfilter_t *df, proto_tree *tree,
 	return TRUE;
 }
 
-static GSList *
-filter_refs_fvalues(GPtrArray *refs_array, drange_t *range)
+static void
+filter_refs_fvalues(GPtrArray *fvalues, GPtrArray *refs_array, drange_t *range)
 {
 	int length; /* maximum proto layer number. The numbers are sequential. */
 	df_reference_t *last_ref = NULL;
 	int cookie = -1;
 	gboolean cookie_matches = false;
-	GSList *fvalues = NULL;
 
 	if (!refs_array || refs_array->len == 0) {
-		return fvalues;
+		return;
 	}
 
 	/* refs array is sorted. */
@@ -871,24 +1214,18 @@ filter_refs_fvalues(GPtrArray *refs_array, drange_t *range)
 		int layer = ref->proto_layer_num;
 
 		if (range == NULL) {
-			fvalues = g_slist_prepend(fvalues, ref->value);
+			g_ptr_array_add(fvalues, ref->value);
 			continue;
 		}
 
-		if (cookie == layer) {
-			if (cookie_matches) {
-				fvalues = g_slist_prepend(fvalues, ref->value);
-			}
-		}
-		else {
+		if (cookie != layer) {
 			cookie = layer;
 			cookie_matches = drange_contains_layer(range, layer, length);
-			if (cookie_matches) {
-				fvalues = g_slist_prepend(fvalues, ref->value);
-			}
+		}
+		if (cookie_matches) {
+			g_ptr_array_add(fvalues, ref->value);
 		}
 	}
-	return fvalues;
 }
 
 static gboolean
@@ -910,7 +1247,7 @@ read_reference(dfilter_t *df, dfvm_value_t *arg1, dfvm_value_t *arg2,
 
 	/* Already loaded in this run of the dfilter? */
 	if (df->attempted_load[reg]) {
-		if (df->registers[reg]) {
+		if (df->registers[reg]->len > 0) {
 			return TRUE;
 		}
 		else {
@@ -925,11 +1262,10 @@ read_reference(dfilter_t *df, dfvm_value_t *arg1, dfvm_value_t *arg2,
 	else
 		refs = g_hash_table_lookup(df->references, hfinfo);
 	if (refs == NULL || refs->len == 0) {
-		df->registers[reg] = NULL;
 		return FALSE;
 	}
 
-	df->registers[reg] = filter_refs_fvalues(refs, range);
+	filter_refs_fvalues(df->registers[reg], refs, range);
 	// These values are referenced only, do not try to free it later.
 	df->free_registers[reg] = NULL;
 	return TRUE;
@@ -943,54 +1279,65 @@ enum match_how {
 typedef ft_bool_t (*DFVMCompareFunc)(const fvalue_t*, const fvalue_t*);
 typedef ft_bool_t (*DFVMTestFunc)(const fvalue_t*);
 
+/* Returns the values of an operand, which is either a register or a
+ * single constant; the constant is passed back through "single" so
+ * that no list has to be built for it. */
+static inline fvalue_t **
+operand_values(dfilter_t *df, dfvm_value_t *arg, fvalue_t **single, guint *len)
+{
+	GPtrArray *reg;
+
+	if (arg->type == REGISTER) {
+		reg = df->registers[arg->value.numeric];
+		*len = reg->len;
+		return (fvalue_t **)reg->pdata;
+	}
+	else if (arg->type == FVALUE) {
+		*single = arg->value.fvalue;
+		*len = 1;
+		return single;
+	}
+	ws_assert_not_reached();
+}
+
 static gboolean
 cmp_test_internal(enum match_how how, DFVMCompareFunc match_func,
-					GSList *arg1, GSList *arg2)
+			fvalue_t **vals1, guint len1, fvalue_t **vals2, guint len2)
 {
-	GSList *list1, *list2;
 	gboolean want_all = (how == MATCH_ALL);
 	gboolean want_any = (how == MATCH_ANY);
 	ft_bool_t have_match;
 
-	list1 = arg1;
-
-	while (list1) {
-		list2 = arg2;
-		while (list2) {
-			have_match = match_func(list1->data, list2->data);
+	for (guint i = 0; i < len1; i++) {
+		for (guint j = 0; j < len2; j++) {
+			have_match = match_func(vals1[i], vals2[j]);
 			if (want_all && have_match == FT_FALSE) {
 				return FALSE;
 			}
 			else if (want_any && have_match == FT_TRUE) {
 				return TRUE;
 			}
-			list2 = g_slist_next(list2);
 		}
-		list1 = g_slist_next(list1);
 	}
 	/* want_all || !want_any */
 	return want_all;
 }
 
 static gboolean
-cmp_test_unary(enum match_how how, DFVMTestFunc test_func, GSList *arg1)
+cmp_test_unary(enum match_how how, DFVMTestFunc test_func, GPtrArray *arg1)
 {
-	GSList *list1;
 	gboolean want_all = (how == MATCH_ALL);
 	gboolean want_any = (how == MATCH_ANY);
 	ft_bool_t have_match;
 
-	list1 = arg1;
-
-	while (list1) {
-		have_match = test_func(list1->data);
+	for (guint i = 0; i < arg1->len; i++) {
+		have_match = test_func(arg1->pdata[i]);
 		if (want_all && have_match == FT_FALSE) {
 			return FALSE;
 		}
 		else if (want_any && have_match == FT_TRUE) {
 			return TRUE;
 		}
-		list1 = g_slist_next(list1);
 	}
 	/* want_all || !want_any */
 	return want_all;
@@ -1000,8 +1347,8 @@ static gboolean
 all_test_unary(dfilter_t *df, DFVMTestFunc func, dfvm_value_t *arg1)
 {
 	ws_assert(arg1->type == REGISTER);
-	GSList *list1 = df->registers[arg1->value.numeric];
-	return cmp_test_unary(MATCH_ALL, func, list1);
+	GPtrArray *reg1 = df->registers[arg1->value.numeric];
+	return cmp_test_unary(MATCH_ALL, func, reg1);
 }
 
 static gboolean
@@ -1009,33 +1356,14 @@ cmp_test(dfilter_t *df, DFVMCompareFunc cmp,
 			dfvm_value_t *arg1, dfvm_value_t *arg2,
 			enum match_how how)
 {
-	GSList list1, list2, *l1, *l2;
-
-	if (arg1->type == REGISTER) {
-		l1 = df->registers[arg1->value.numeric];
-	}
-	else if (arg1->type == FVALUE) {
-		list1.data = arg1->value.fvalue;
-		list1.next = NULL;
-		l1 = &list1;
-	}
-	else {
-		ws_assert_not_reached();
-	}
+	fvalue_t *single1, *single2;
+	fvalue_t **vals1, **vals2;
+	guint len1, len2;
 
-	if (arg2->type == REGISTER) {
-		l2 = df->registers[arg2->value.numeric];
-	}
-	else if (arg2->type == FVALUE) {
-		list2.data = arg2->value.fvalue;
-		list2.next = NULL;
-		l2 = &list2;
-	}
-	else {
-		ws_assert_not_reached();
-	}
+	vals1 = operand_values(df, arg1, &single1, &len1);
+	vals2 = operand_values(df, arg2, &single2, &len2);
 
-	return cmp_test_internal(how, cmp, l1, l2);
+	return cmp_test_internal(how, cmp, vals1, len1, vals2, len2);
 }
 
 /* cmp(A) <=> cmp(a1) OR cmp(a2) OR cmp(a3) OR ... */
@@ -1054,17 +1382,200 @@ all_test(dfilter_t *df, DFVMCompareFunc cmp,
 	return cmp_test(df, cmp, arg1, arg2, MATCH_ALL);
 }
 
+/* Compares the values of a field in the proto_tree directly against
+ * a constant, without loading them into a register first; arg3 is the
+ * comparison instruction that this replaces. See fuse_read_tree_cmp()
+ * in gencode.c. */
+static gboolean
+cmp_tree(proto_tree *tree, dfvm_value_t *arg1, dfvm_value_t *arg2,
+				dfvm_value_t *arg3)
+{
+	header_field_info *hfinfo = arg1->value.hfinfo;
+	const fvalue_t	*fv = arg2->value.fvalue;
+	DFVMCompareFunc	cmp;
+	enum match_how	how;
+	GPtrArray	*finfos;
+	field_info	*finfo;
+	gboolean	found = FALSE;
+	ft_bool_t	have_match;
+
+	switch ((dfvm_opcode_t)arg3->value.numeric) {
+		case DFVM_ALL_EQ:	cmp = fvalue_eq;	how = MATCH_ALL; break;
+		case DFVM_ANY_EQ:	cmp = fvalue_eq;	how = MATCH_ANY; break;
+		case DFVM_ALL_NE:	cmp = fvalue_ne;	how = MATCH_ALL; break;
+		case DFVM_ANY_NE:	cmp = fvalue_ne;	how = MATCH_ANY; break;
+		case DFVM_ALL_GT:	cmp = fvalue_gt;	how = MATCH_ALL; break;
+		case DFVM_ANY_GT:	cmp = fvalue_gt;	how = MATCH_ANY; break;
+		case DFVM_ALL_GE:	cmp = fvalue_ge;	how = MATCH_ALL; break;
+		case DFVM_ANY_GE:	cmp = fvalue_ge;	how = MATCH_ANY; break;
+		case DFVM_ALL_LT:	cmp = fvalue_lt;	how = MATCH_ALL; break;
+		case DFVM_ANY_LT:	cmp = fvalue_lt;	how = MATCH_ANY; break;
+		case DFVM_ALL_LE:	cmp = fvalue_le;	how = MATCH_ALL; break;
+		case DFVM_ANY_LE:	cmp = fvalue_le;	how = MATCH_ANY; break;
+		case DFVM_ALL_CONTAINS:	cmp = fvalue_contains;	how = MATCH_ALL; break;
+		case DFVM_ANY_CONTAINS:	cmp = fvalue_contains;	how = MATCH_ANY; break;
+		default:
+			ws_assert_not_reached();
+	}
+
+	while (hfinfo) {
+		/* The caller should NOT free the GPtrArray. */
+		finfos = proto_get_finfo_ptr_array(tree, hfinfo->id);
+		if (finfos != NULL) {
+			for (guint i = 0; i < finfos->len; i++) {
+				finfo = g_ptr_array_index(finfos, i);
+				found = TRUE;
+				have_match = cmp(finfo->value, fv);
+				if (how == MATCH_ALL && have_match == FT_FALSE) {
+					return FALSE;
+				}
+				else if (how == MATCH_ANY && have_match == FT_TRUE) {
+					return TRUE;
+				}
+			}
+		}
+		hfinfo = hfinfo->same_name_next;
+	}
+
+	/* A missing field fails the test, as it does with READ_TREE. */
+	if (!found) {
+		return FALSE;
+	}
+	return how == MATCH_ALL;
+}
+
+static gboolean
+patterns_scan(const dfvm_patterns_t *p, const guint8 *data, size_t len)
+{
+	guint32 state = 0;
+
+	for (size_t i = 0; i < len; i++) {
+		state = p->next[state * 256 + data[i]];
+		if (p->accept[state])
+			return TRUE;
+	}
+	return FALSE;
+}
+
+static gboolean
+fvalue_contains_patterns(fvalue_t *fv, const dfvm_patterns_t *p)
+{
+	volatile gboolean found = FALSE;
+	tvbuff_t	*tvb;
+	guint		len;
+
+	if (fvalue_type_ftenum(fv) != p->ftype) {
+		/* Not a type we can scan, so test the patterns one by one. */
+		for (guint i = 0; i < p->fvalues->len; i++) {
+			if (fvalue_contains(fv, g_ptr_array_index(p->fvalues, i)) == FT_TRUE)
+				return TRUE;
+		}
+		return FALSE;
+	}
+
+	if (p->ftype != FT_PROTOCOL) {
+		return patterns_scan(p, fvalue_get_bytes_data(fv),
+					fvalue_get_bytes_size(fv));
+	}
+
+	/* As with cmp_contains() for FT_PROTOCOL, a protocol without
+	 * a tvbuff doesn't contain any non-empty constant. */
+	tvb = fvalue_get_protocol(fv);
+	if (tvb == NULL)
+		return FALSE;
+
+	TRY {
+		len = tvb_captured_length(tvb);
+		if (len > 0)
+			found = patterns_scan(p, tvb_get_ptr(tvb, 0, len), len);
+	}
+	CATCH_ALL {
+		/* nothing */
+	}
+	ENDTRY;
+
+	return found;
+}
+
+static gboolean
+any_contains_any(dfilter_t *df, dfvm_value_t *arg1, dfvm_value_t *arg2)
+{
+	GPtrArray *reg1 = df->registers[arg1->value.numeric];
+	const dfvm_patterns_t *patterns = arg2->value.patterns;
+
+	for (guint i = 0; i < reg1->len; i++) {
+		if (fvalue_contains_patterns(reg1->pdata[i], patterns)) {
+			return TRUE;
+		}
+	}
+	return FALSE;
+}
+
+static gboolean
+fvalue_in_set(fvalue_t *fv, const dfvm_set_t *set)
+{
+	guint lo, hi, mid;
+
+	if (fvalue_type_ftenum(fv) != set->ftype || !fvalue_eq_is_exact(fv)) {
+		/* Not a value we can look up, so test the elements one by one. */
+		for (guint i = 0; i < set->fvalues->len; i++) {
+			if (fvalue_eq(fv, g_ptr_array_index(set->fvalues, i)) == FT_TRUE)
+				return TRUE;
+		}
+		for (guint r = 0; r < set->num_ranges; r++) {
+			if (fvalue_ge(fv, set->ranges[r].low) == FT_TRUE &&
+					fvalue_le(fv, set->ranges[r].high) == FT_TRUE)
+				return TRUE;
+		}
+		return FALSE;
+	}
+
+	if (g_hash_table_contains(set->exact, fv))
+		return TRUE;
+
+	for (guint i = 0; i < set->inexact->len; i++) {
+		if (fvalue_eq(fv, g_ptr_array_index(set->inexact, i)) == FT_TRUE)
+			return TRUE;
+	}
+
+	/* Find the first range with a lower bound above the value; the value
+	 * is in a range if it's below the largest upper bound before that. */
+	lo = 0;
+	hi = set->num_ranges;
+	while (lo < hi) {
+		mid = lo + (hi - lo) / 2;
+		if (fvalue_le(set->ranges[mid].low, fv) == FT_TRUE)
+			lo = mid + 1;
+		else
+			hi = mid;
+	}
+	return lo > 0 && fvalue_le(fv, set->ranges[lo - 1].max_high) == FT_TRUE;
+}
+
+static gboolean
+any_in_set(dfilter_t *df, dfvm_value_t *arg1, dfvm_value_t *arg2)
+{
+	GPtrArray *reg1 = df->registers[arg1->value.numeric];
+	const dfvm_set_t *set = arg2->value.set;
+
+	for (guint i = 0; i < reg1->len; i++) {
+		if (fvalue_in_set(reg1->pdata[i], set)) {
+			return TRUE;
+		}
+	}
+	return FALSE;
+}
+
 static gboolean
 any_matches(dfilter_t *df, dfvm_value_t *arg1, dfvm_value_t *arg2)
 {
-	GSList *list1 = df->registers[arg1->value.numeric];
+	GPtrArray *reg1 = df->registers[arg1->value.numeric];
 	ws_regex_t *re = arg2->value.pcre;
 
-	while (list1) {
-		if (fvalue_matches(list1->data, re) == FT_TRUE) {
+	for (guint i = 0; i < reg1->len; i++) {
+		if (fvalue_matches(reg1->pdata[i], re) == FT_TRUE) {
 			return TRUE;
 		}
-		list1 = g_slist_next(list1);
 	}
 	return FALSE;
 }
@@ -1072,40 +1583,37 @@ any_matches(dfilter_t *df, dfvm_value_t *arg1, dfvm_value_t *arg2)
 static gboolean
 all_matches(dfilter_t *df, dfvm_value_t *arg1, dfvm_value_t *arg2)
 {
-	GSList *list1 = df->registers[arg1->value.numeric];
+	GPtrArray *reg1 = df->registers[arg1->value.numeric];
 	ws_regex_t *re = arg2->value.pcre;
 
-	while (list1) {
-		if (fvalue_matches(list1->data, re) == FT_FALSE) {
+	for (guint i = 0; i < reg1->len; i++) {
+		if (fvalue_matches(reg1->pdata[i], re) == FT_FALSE) {
 			return FALSE;
 		}
-		list1 = g_slist_next(list1);
 	}
 	return TRUE;
 }
 
 static gboolean
-any_in_range_internal(GSList *list1, fvalue_t *low, fvalue_t *high)
+any_in_range_internal(GPtrArray *reg1, fvalue_t *low, fvalue_t *high)
 {
-	while (list1) {
-		if (fvalue_ge(list1->data, low) == FT_TRUE &&
-				fvalue_le(list1->data, high) == FT_TRUE) {
+	for (guint i = 0; i < reg1->len; i++) {
+		if (fvalue_ge(reg1->pdata[i], low) == FT_TRUE &&
+				fvalue_le(reg1->pdata[i], high) == FT_TRUE) {
 			return TRUE;
 		}
-		list1 = g_slist_next(list1);
 	}
 	return FALSE;
 }
 
 static gboolean
-all_in_range_internal(GSList *list1, fvalue_t *low, fvalue_t *high)
+all_in_range_internal(GPtrArray *reg1, fvalue_t *low, fvalue_t *high)
 {
-	while (list1) {
-		if (fvalue_ge(list1->data, low) == FT_FALSE ||
-				fvalue_le(list1->data, high) == FT_FALSE) {
+	for (guint i = 0; i < reg1->len; i++) {
+		if (fvalue_ge(reg1->pdata[i], low) == FT_FALSE ||
+				fvalue_le(reg1->pdata[i], high) == FT_FALSE) {
 			return FALSE;
 		}
-		list1 = g_slist_next(list1);
 	}
 	return TRUE;
 }
@@ -1114,14 +1622,14 @@ static gboolean
 match_in_range(dfilter_t *df, enum match_how how, dfvm_value_t *arg1,
 				dfvm_value_t *arg_low, dfvm_value_t *arg_high)
 {
-	GSList *list1 = df->registers[arg1->value.numeric];
-	GSList *_low, *_high;
+	GPtrArray *reg1 = df->registers[arg1->value.numeric];
+	GPtrArray *_low, *_high;
 	fvalue_t *low, *high;
 
 	if (arg_low->type == REGISTER) {
 		_low = df->registers[arg_low->value.numeric];
-		ws_assert(g_slist_length(_low) == 1);
-		low = _low->data;
+		ws_assert(_low->len == 1);
+		low = _low->pdata[0];
 	}
 	else if (arg_low->type == FVALUE) {
 		low = arg_low->value.fvalue;
@@ -1131,8 +1639,8 @@ match_in_range(dfilter_t *df, enum match_how how, dfvm_value_t *arg1,
 	}
 	if (arg_high->type == REGISTER) {
 		_high = df->registers[arg_high->value.numeric];
-		ws_assert(g_slist_length(_high) == 1);
-		high = _high->data;
+		ws_assert(_high->len == 1);
+		high = _high->pdata[0];
 	}
 	else if (arg_high->type == FVALUE) {
 		high = arg_high->value.fvalue;
@@ -1142,9 +1650,9 @@ match_in_range(dfilter_t *df, enum match_how how, dfvm_value_t *arg1,
 	}
 
 	if (how == MATCH_ALL)
-		return all_in_range_internal(list1, low, high);
+		return all_in_range_internal(reg1, low, high);
 	else if (how == MATCH_ANY)
-		return any_in_range_internal(list1, low, high);
+		return any_in_range_internal(reg1, low, high);
 	else
 		ws_assert_not_reached();
 }
@@ -1164,76 +1672,73 @@ all_in_range(dfilter_t *df, dfvm_value_t *arg1,
 }
 
 /* Clear registers that were populated during evaluation.
- * If we created the values, then these will be freed as well. */
+ * If we created the values, then these will be freed as well.
+ * The arrays themselves are kept, so that the next packet can
+ * reuse their storage. */
 static void
 free_register_overhead(dfilter_t* df)
 {
 	guint i;
+	GPtrArray *reg;
 
 	for (i = 0; i < df->num_registers; i++) {
 		df->attempted_load[i] = FALSE;
-		if (df->registers[i]) {
+		reg = df->registers[i];
+		if (reg->len > 0) {
 			if (df->free_registers[i]) {
-				for (GSList *l = df->registers[i]; l != NULL; l = l->next) {
-					df->free_registers[i](l->data);
+				for (guint j = 0; j < reg->len; j++) {
+					df->free_registers[i](reg->pdata[j]);
 				}
 				df->free_registers[i] = NULL;
 			}
-			g_slist_free(df->registers[i]);
-			df->registers[i] = NULL;
+			g_ptr_array_set_size(reg, 0);
 		}
 	}
 }
 
-/* Takes the list of fvalue_t's in a register, uses fvalue_slice()
- * to make a new list of fvalue_t's (which are byte-slices),
- * and puts the new list into a new register. */
+/* Takes the fvalue_t's in a register, uses fvalue_slice()
+ * to make new fvalue_t's (which are byte-slices),
+ * and puts them into a new register. */
 static void
 mk_slice(dfilter_t *df, dfvm_value_t *from_arg, dfvm_value_t *to_arg,
 						dfvm_value_t *drange_arg)
 {
-	GSList		*from_list, *to_list;
+	GPtrArray	*from_reg, *to_reg;
 	fvalue_t	*old_fv, *new_fv;
 
-	to_list = NULL;
-	from_list = df->registers[from_arg->value.numeric];
+	from_reg = df->registers[from_arg->value.numeric];
+	to_reg = df->registers[to_arg->value.numeric];
 	drange_t *drange = drange_arg->value.drange;
 
-	while (from_list) {
-		old_fv = from_list->data;
+	for (guint i = 0; i < from_reg->len; i++) {
+		old_fv = from_reg->pdata[i];
 		new_fv = fvalue_slice(old_fv, drange);
 		/* Assert here because semcheck.c should have
 		 * already caught the cases in which a slice
 		 * cannot be made. */
 		ws_assert(new_fv);
-		to_list = g_slist_prepend(to_list, new_fv);
-
-		from_list = g_slist_next(from_list);
+		g_ptr_array_add(to_reg, new_fv);
 	}
 
-	df->registers[to_arg->value.numeric] = to_list;
 	df->free_registers[to_arg->value.numeric] = (GDestroyNotify)fvalue_free;
 }
 
 static void
 mk_length(dfilter_t *df, dfvm_value_t *from_arg, dfvm_value_t *to_arg)
 {
-	GSList		*from_list, *to_list;
+	GPtrArray	*from_reg, *to_reg;
 	fvalue_t	*old_fv, *new_fv;
 
-	to_list = NULL;
-	from_list = df->registers[from_arg->value.numeric];
+	from_reg = df->registers[from_arg->value.numeric];
+	to_reg = df->registers[to_arg->value.numeric];
 
-	while (from_list) {
-		old_fv = from_list->data;
+	for (guint i = 0; i < from_reg->len; i++) {
+		old_fv = from_reg->pdata[i];
 		new_fv = fvalue_new(FT_UINT32);
 		fvalue_set_uinteger(new_fv, fvalue_length(old_fv));
-		to_list = g_slist_prepend(to_list, new_fv);
-
-		from_list = g_slist_next(from_list);
+		g_ptr_array_add(to_reg, new_fv);
 	}
 
-	df->registers[to_arg->value.numeric] = to_list;
 	df->free_registers[to_arg->value.numeric] = (GDestroyNotify)fvalue_free;
 }
 
@@ -1253,7 +1758,10 @@ call_function(dfilter_t *df, dfvm_value_t *arg1, dfvm_value_t *arg2,
 	accum = funcdef->function(df->function_stack, arg_count, &retval);
 
 	/* Write return registers. */
-	df->registers[reg_return] = retval;
+	for (GSList *l = retval; l != NULL; l = l->next) {
+		g_ptr_array_add(df->registers[reg_return], l->data);
+	}
+	g_slist_free(retval);
 	// functions create a new value, so own it.
 	df->free_registers[reg_return] = (GDestroyNotify)fvalue_free;
 	return accum;
@@ -1271,20 +1779,19 @@ static void debug_op_error(fvalue_t *v1, fvalue_t *v2, const char *op, const cha
 /* Used for temporary debugging only, don't leave in production code (at
  * a minimum WS_DEBUG_HERE must be replaced by another log level). */
 static void _U_
-debug_register(GSList *reg, guint32 num)
+debug_register(GPtrArray *reg, guint32 num)
 {
 	wmem_strbuf_t *buf;
-	GSList *l;
 	char *s;
 
 	buf = wmem_strbuf_new(NULL, NULL);
 
 	wmem_strbuf_append_printf(buf, "Reg#%"G_GUINT32_FORMAT" = { ", num);
-	for (l = reg; l != NULL; l = l->next) {
-		s = fvalue_to_debug_repr(NULL, l->data);
-		wmem_strbuf_append_printf(buf, "%s <%s>", s, fvalue_type_name(l->data));
+	for (guint i = 0; i < reg->len; i++) {
+		s = fvalue_to_debug_repr(NULL, reg->pdata[i]);
+		wmem_strbuf_append_printf(buf, "%s <%s>", s, fvalue_type_name(reg->pdata[i]));
 		g_free(s);
-		if (l->next != NULL) {
+		if (i + 1 < reg->len) {
 			wmem_strbuf_append(buf, ", ");
 		}
 	}
@@ -1298,20 +1805,17 @@ typedef fvalue_t* (*DFVMBinaryFunc)(const fvalue_t*, const fvalue_t*, char **);
 
 static void
 mk_binary_internal(DFVMBinaryFunc func,
-			GSList *arg1, GSList *arg2, GSList **retval)
+			fvalue_t **vals1, guint len1, fvalue_t **vals2, guint len2,
+			GPtrArray *retval)
 {
-	GSList *list1, *list2;
-	GSList *to_list = NULL;
 	fvalue_t *val1, *val2;
 	fvalue_t *result;
 	char *err_msg = NULL;
 
-	list1 = arg1;
-	while (list1) {
-		list2 = arg2;
-		while (list2) {
-			val1 = list1->data;
-			val2 = list2->data;
+	for (guint i = 0; i < len1; i++) {
+		for (guint j = 0; j < len2; j++) {
+			val1 = vals1[i];
+			val2 = vals2[j];
 			result = func(val1, val2, &err_msg);
 			if (result == NULL) {
 				debug_op_error(val1, val2, "&", err_msg);
@@ -1319,66 +1823,39 @@ mk_binary_internal(DFVMBinaryFunc func,
 				err_msg = NULL;
 			}
 			else {
-				to_list = g_slist_prepend(to_list, result);
+				g_ptr_array_add(retval, result);
 			}
-			list2 = g_slist_next(list2);
 		}
-		list1 = g_slist_next(list1);
 	}
-	*retval = to_list;
 }
 
 static void
 mk_binary(dfilter_t *df, DFVMBinaryFunc func,
 		dfvm_value_t *arg1, dfvm_value_t *arg2, dfvm_value_t *to_arg)
 {
-	GSList ls1, ls2;
-	GSList *list1, *list2;
-	GSList *result = NULL;
+	fvalue_t *single1, *single2;
+	fvalue_t **vals1, **vals2;
+	guint len1, len2;
+	GPtrArray *result = df->registers[to_arg->value.numeric];
 
-	if (arg1->type == REGISTER) {
-		list1 = df->registers[arg1->value.numeric];
-	}
-	else if (arg1->type == FVALUE) {
-		ls1.data = arg1->value.fvalue;
-		ls1.next = NULL;
-		list1 = &ls1;
-	}
-	else {
-		ws_assert_not_reached();
-	}
+	vals1 = operand_values(df, arg1, &single1, &len1);
+	vals2 = operand_values(df, arg2, &single2, &len2);
 
-	if (arg2->type == REGISTER) {
-		list2 = df->registers[arg2->value.numeric];
-	}
-	else if (arg2->type == FVALUE) {
-		ls2.data = arg2->value.fvalue;
-		ls2.next = NULL;
-		list2 = &ls2;
-	}
-	else {
-		ws_assert_not_reached();
-	}
-
-	mk_binary_internal(func, list1, list2, &result);
+	mk_binary_internal(func, vals1, len1, vals2, len2, result);
 	//debug_register(result, to_arg->value.numeric);
 
-	df->registers[to_arg->value.numeric] = result;
 	df->free_registers[to_arg->value.numeric] = (GDestroyNotify)fvalue_free;
 }
 
 static void
-mk_minus_internal(GSList *arg1, GSList **retval)
+mk_minus_internal(fvalue_t **vals1, guint len1, GPtrArray *retval)
 {
-	GSList *list1;
-	GSList *to_list = NULL;
 	fvalue_t *val1;
 	fvalue_t *result;
 	char *err_msg = NULL;
 
-	list1 = arg1;
-	while (list1) {
-		val1 = list1->data;
+	for (guint i = 0; i < len1; i++) {
+		val1 = vals1[i];
 		result = fvalue_unary_minus(val1, &err_msg);
 		if (result == NULL) {
 			ws_noisy("unary_minus: %s", err_msg);
@@ -1386,35 +1863,23 @@ mk_minus_internal(GSList *arg1, GSList **retval)
 			err_msg = NULL;
 		}
 		else {
-			to_list = g_slist_prepend(to_list, result);
+			g_ptr_array_add(retval, result);
 		}
-		list1 = g_slist_next(list1);
 	}
-	*retval = to_list;
 }
 
 static void
 mk_minus(dfilter_t *df, dfvm_value_t *arg1, dfvm_value_t *to_arg)
 {
-	GSList ls1;
-	GSList *list1;
-	GSList *result = NULL;
+	fvalue_t *single1;
+	fvalue_t **vals1;
+	guint len1;
+	GPtrArray *result = df->registers[to_arg->value.numeric];
 
-	if (arg1->type == REGISTER) {
-		list1 = df->registers[arg1->value.numeric];
-	}
-	else if (arg1->type == FVALUE) {
-		ls1.data = arg1->value.fvalue;
-		ls1.next = NULL;
-		list1 = &ls1;
-	}
-	else {
-		ws_assert_not_reached();
-	}
+	vals1 = operand_values(df, arg1, &single1, &len1);
 
-	mk_minus_internal(list1, &result);
+	mk_minus_internal(vals1, len1, result);
 
-	df->registers[to_arg->value.numeric] = result;
 	df->free_registers[to_arg->value.numeric] = (GDestroyNotify)fvalue_free;
 }
 
@@ -1422,22 +1887,28 @@ static void
 put_fvalue(dfilter_t *df, dfvm_value_t *arg1, dfvm_value_t *to_arg)
 {
 	fvalue_t *fv = arg1->value.fvalue;
-	df->registers[to_arg->value.numeric] = g_slist_append(NULL, fv);
+	g_ptr_array_add(df->registers[to_arg->value.numeric], fv);
 
 	/* Memory is owned by the dfvm_value_t. */
 	df->free_registers[to_arg->value.numeric] = NULL;
 }
 
+/* Function arguments are still passed as lists, which is what the
+ * display filter functions expect. */
 static void
 stack_push(dfilter_t *df, dfvm_value_t *arg1)
 {
-	GSList *arg;
+	GSList *arg = NULL;
+	GPtrArray *reg;
 
 	if (arg1->type == FVALUE) {
 		arg = g_slist_prepend(NULL, arg1->value.fvalue);
 	}
 	else if (arg1->type == REGISTER) {
-		arg = g_slist_copy(df->registers[arg1->value.numeric]);
+		reg = df->registers[arg1->value.numeric];
+		for (guint i = reg->len; i > 0; i--) {
+			arg = g_slist_prepend(arg, reg->pdata[i - 1]);
+		}
 	}
 	else {
 		ws_assert_not_reached();
@@ -1470,8 +1941,6 @@ check_exists(proto_tree *tree, dfvm_value_t *arg1, dfvm_value_t *arg2)
 	GPtrArray		*finfos;
 	header_field_info	*hfinfo;
 	drange_t		*range = NULL;
-	gboolean		exists;
-	GSList			*fvalues;
 
 	hfinfo = arg1->value.hfinfo;
 	if (arg2)
@@ -1487,10 +1956,7 @@ check_exists(proto_tree *tree, dfvm_value_t *arg1, dfvm_value_t *arg2)
 			return TRUE;
 		}
 
-		fvalues = filter_finfo_fvalues(NULL, finfos, range, FALSE);
-		exists = (fvalues != NULL);
-		g_slist_free(fvalues);
-		if (exists) {
+		if (filter_finfo_fvalues(NULL, finfos, range, FALSE)) {
 			return TRUE;
 		}
 
@@ -1539,6 +2005,10 @@ dfvm_apply(dfilter_t *df, proto_tree *tree)
 				accum = read_tree(df, tree, arg1, arg2, arg3);
 				break;
 
+			case DFVM_CMP_TREE:
+				accum = cmp_tree(tree, arg1, arg2, arg3);
+				break;
+
 			case DFVM_READ_REFERENCE:
 				accum = read_reference(df, arg1, arg2, NULL);
 				break;
@@ -1655,6 +2125,10 @@ dfvm_apply(dfilter_t *df, proto_tree *tree)
 				accum = any_test(df, fvalue_contains, arg1, arg2);
 				break;
 
+			case DFVM_ANY_CONTAINS_ANY:
+				accum = any_contains_any(df, arg1, arg2);
+				break;
+
 			case DFVM_ALL_MATCHES:
 				accum = all_matches(df, arg1, arg2);
 				break;
@@ -1671,6 +2145,10 @@ dfvm_apply(dfilter_t *df, proto_tree *tree)
 				accum = any_in_range(df, arg1, arg2, arg3);
 				break;
 
+			case DFVM_ANY_IN_SET:
+				accum = any_in_set(df, arg1, arg2);
+				break;
+
 			case DFVM_UNARY_MINUS:
 				mk_minus(df, arg1, arg2);
 				break;
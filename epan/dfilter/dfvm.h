@@ -27,9 +27,14 @@ typedef enum {
 	INTEGER,
 	DRANGE,
 	FUNCTION_DEF,
-	PCRE
+	PCRE,
+	PATTERNS,
+	SET
 } dfvm_value_type_t;
 
+typedef struct _dfvm_patterns dfvm_patterns_t;
+typedef struct _dfvm_set dfvm_set_t;
+
 typedef struct {
 	dfvm_value_type_t	type;
 
@@ -40,6 +45,8 @@ typedef struct {
 		header_field_info	*hfinfo;
 		df_func_def_t		*funcdef;
 		ws_regex_t		*pcre;
+		dfvm_patterns_t		*patterns;
+		dfvm_set_t		*set;
 	} value;
 
 	int ref_count;
@@ -90,6 +97,9 @@ typedef enum {
 	DFVM_STACK_PUSH,
 	DFVM_STACK_POP,
 	DFVM_NOT_ALL_ZERO,
+	DFVM_CMP_TREE,
+	DFVM_ANY_CONTAINS_ANY,
+	DFVM_ANY_IN_SET,
 } dfvm_opcode_t;
 
 const char *
@@ -139,6 +149,18 @@ dfvm_value_new_pcre(ws_regex_t *re);
 dfvm_value_t*
 dfvm_value_new_guint(guint num);
 
+dfvm_patterns_t *
+dfvm_patterns_new(GPtrArray *fvalues);
+
+dfvm_value_t*
+dfvm_value_new_patterns(dfvm_patterns_t *patterns);
+
+dfvm_set_t *
+dfvm_set_new(GPtrArray *elements);
+
+dfvm_value_t*
+dfvm_value_new_set(dfvm_set_t *set);
+
 void
 dfvm_dump(FILE *f, dfilter_t *df, uint16_t flags);
 
@@ -79,6 +79,9 @@ select_opcode(dfvm_opcode_t op, stmatch_t how)
 		case DFVM_CALL_FUNCTION:
 		case DFVM_STACK_PUSH:
 		case DFVM_STACK_POP:
+		case DFVM_CMP_TREE:
+		case DFVM_ANY_CONTAINS_ANY:
+		case DFVM_ANY_IN_SET:
 			break;
 	}
 	ws_assert_not_reached();
@@ -416,6 +419,58 @@ fixup_jumps(gpointer data, gpointer user_data)
 	}
 }
 
+/* With fewer elements than this, it's faster to test each one in turn. */
+#define IN_SET_MIN_ELEMENTS	8
+
+/*
+ * Generate the code for the in operator with a large set of constants,
+ * as a single test against a hash table and a sorted array of ranges,
+ * so that the cost doesn't grow with the size of the set.  Returns FALSE,
+ * without generating anything, if the set doesn't have that shape.
+ */
+static gboolean
+gen_in_set(dfwork_t *dfw, stmatch_t how, stnode_t *st_arg1, stnode_t *st_arg2)
+{
+	GPtrArray	*elements;
+	GSList		*nodelist;
+	GSList		*jumps = NULL;
+	stnode_t	*node1, *node2;
+	dfvm_set_t	*set = NULL;
+	dfvm_value_t	*val1;
+
+	if (how == STNODE_MATCH_ALL)
+		return FALSE;
+
+	if (g_slist_length(stnode_data(st_arg2)) < 2 * IN_SET_MIN_ELEMENTS)
+		return FALSE;
+
+	elements = g_ptr_array_new();
+	for (nodelist = stnode_data(st_arg2); nodelist; nodelist = g_slist_next(nodelist)) {
+		node1 = nodelist->data;
+		nodelist = g_slist_next(nodelist);
+		node2 = nodelist->data;
+
+		if (stnode_type_id(node1) != STTYPE_FVALUE ||
+				(node2 != NULL && stnode_type_id(node2) != STTYPE_FVALUE))
+			goto done;
+		g_ptr_array_add(elements, stnode_data(node1));
+		g_ptr_array_add(elements, node2 != NULL ? stnode_data(node2) : NULL);
+	}
+
+	set = dfvm_set_new(elements);
+	if (set != NULL) {
+		val1 = gen_entity(dfw, st_arg1, &jumps);
+		gen_relation_insn(dfw, DFVM_ANY_IN_SET, val1,
+				dfvm_value_new_set(set), NULL);
+		g_slist_foreach(jumps, fixup_jumps, dfw);
+		g_slist_free(jumps);
+	}
+
+done:
+	g_ptr_array_free(elements, TRUE);
+	return set != NULL;
+}
+
 /* Generate the code for the in operator.  It behaves much like an OR-ed
  * series of == tests, but without the redundant existence checks. */
 static void
@@ -431,6 +486,9 @@ gen_relation_in(dfwork_t *dfw, stmatch_t how,
 	dfvm_opcode_t	op;
 	GSList		*nodelist_head, *nodelist;
 
+	if (gen_in_set(dfw, how, st_arg1, st_arg2))
+		return;
+
 	/* Create code for the LHS of the relation */
 	val1 = gen_entity(dfw, st_arg1, &jumps);
 
@@ -663,6 +721,162 @@ gen_exists_slice(dfwork_t *dfw, stnode_t *st_node)
 	g_slist_free(jumps);
 }
 
+/* With fewer strings than this, it's faster to scan for each one
+ * separately, with memmem(). */
+#define CONTAINS_ANY_MIN_PATTERNS	4
+
+static void
+get_or_operands(stnode_t *st_node, GPtrArray *operands)
+{
+	stnode_op_t	st_op;
+	stnode_t	*st_arg1, *st_arg2;
+
+	if (stnode_type_id(st_node) == STTYPE_TEST) {
+		sttype_oper_get(st_node, &st_op, &st_arg1, &st_arg2);
+		if (st_op == STNODE_OP_OR) {
+			get_or_operands(st_arg1, operands);
+			get_or_operands(st_arg2, operands);
+			return;
+		}
+	}
+	g_ptr_array_add(operands, st_node);
+}
+
+/*
+ * Generate the code for "F contains "a" or F contains "b" or ...", for
+ * the same field F and constant strings, as a single test against all
+ * the strings at once, so that each value of F is only scanned once.
+ * Returns FALSE, without generating anything, if the expression doesn't
+ * have that shape.
+ */
+static gboolean
+gen_contains_any(dfwork_t *dfw, stnode_t *st_node)
+{
+	GPtrArray	*operands, *fvalues;
+	stnode_t	*st_operand, *st_field = NULL;
+	stnode_t	*st_arg1, *st_arg2;
+	stnode_op_t	st_op;
+	dfvm_patterns_t	*patterns = NULL;
+	dfvm_value_t	*val1;
+	GSList		*jumps = NULL;
+
+	operands = g_ptr_array_new();
+	get_or_operands(st_node, operands);
+	if (operands->len < CONTAINS_ANY_MIN_PATTERNS) {
+		g_ptr_array_free(operands, TRUE);
+		return FALSE;
+	}
+
+	fvalues = g_ptr_array_sized_new(operands->len);
+	for (guint i = 0; i < operands->len; i++) {
+		st_operand = g_ptr_array_index(operands, i);
+		if (stnode_type_id(st_operand) != STTYPE_TEST)
+			goto done;
+		sttype_oper_get(st_operand, &st_op, &st_arg1, &st_arg2);
+		if (st_op != STNODE_OP_CONTAINS ||
+				sttype_test_get_match(st_operand) == STNODE_MATCH_ALL)
+			goto done;
+		if (stnode_type_id(st_arg1) != STTYPE_FIELD ||
+				sttype_field_drange(st_arg1) != NULL ||
+				stnode_type_id(st_arg2) != STTYPE_FVALUE)
+			goto done;
+		if (st_field == NULL) {
+			st_field = st_arg1;
+		}
+		else if (sttype_field_hfinfo(st_arg1) != sttype_field_hfinfo(st_field) ||
+				sttype_field_raw(st_arg1) != sttype_field_raw(st_field)) {
+			goto done;
+		}
+		g_ptr_array_add(fvalues, stnode_data(st_arg2));
+	}
+
+	patterns = dfvm_patterns_new(fvalues);
+	if (patterns != NULL) {
+		val1 = gen_entity(dfw, st_field, &jumps);
+		gen_relation_insn(dfw, DFVM_ANY_CONTAINS_ANY, val1,
+				dfvm_value_new_patterns(patterns), NULL);
+		g_slist_foreach(jumps, fixup_jumps, dfw);
+		g_slist_free(jumps);
+	}
+
+done:
+	g_ptr_array_free(fvalues, TRUE);
+	g_ptr_array_free(operands, TRUE);
+	return patterns != NULL;
+}
+
+/* How deep to look into a syntax tree when estimating its cost. */
+#define COST_MAX_DEPTH	8
+
+/*
+ * A rough estimate of the cost of evaluating a syntax tree node, used to
+ * test the cheaper operand of "and" and "or" first. Reading a field or
+ * comparing values is cheap; regular expressions, string searches,
+ * slices and function calls are not.
+ */
+static int
+estimate_cost(stnode_t *st_node, int depth)
+{
+	stnode_op_t	st_op;
+	stnode_t	*st_arg1, *st_arg2;
+	GSList		*params;
+	int		cost;
+
+	if (st_node == NULL)
+		return 0;
+
+	if (depth >= COST_MAX_DEPTH)
+		return 100;
+
+	switch (stnode_type_id(st_node)) {
+		case STTYPE_TEST:
+		case STTYPE_ARITHMETIC:
+			sttype_oper_get(st_node, &st_op, &st_arg1, &st_arg2);
+			cost = estimate_cost(st_arg1, depth + 1) +
+					estimate_cost(st_arg2, depth + 1);
+			switch (st_op) {
+				case STNODE_OP_MATCHES:
+					return cost + 20;
+				case STNODE_OP_CONTAINS:
+					return cost + 5;
+				default:
+					return cost + 1;
+			}
+		case STTYPE_FIELD:
+		case STTYPE_REFERENCE:
+			return 2;
+		case STTYPE_SLICE:
+			return estimate_cost(sttype_slice_entity(st_node), depth + 1) + 4;
+		case STTYPE_FUNCTION:
+			cost = 20;
+			for (params = sttype_function_params(st_node); params; params = params->next)
+				cost += estimate_cost(params->data, depth + 1);
+			return cost;
+		case STTYPE_SET:
+			/* Pairs of elements; large sets are a single hash lookup. */
+			return MIN(g_slist_length(stnode_data(st_node)) / 2, IN_SET_MIN_ELEMENTS);
+		default:
+			return 0;
+	}
+}
+
+/* When optimizing, swap the operands of a commutative "and" or "or" so
+ * that the cheaper one is tested first. */
+static void
+order_operands(dfwork_t *dfw, stnode_t **st_arg1, stnode_t **st_arg2)
+{
+	stnode_t *tmp;
+
+	if (!(dfw->flags & DF_OPTIMIZE))
+		return;
+
+	if (estimate_cost(*st_arg2, 0) < estimate_cost(*st_arg1, 0)) {
+		tmp = *st_arg1;
+		*st_arg1 = *st_arg2;
+		*st_arg2 = tmp;
+	}
+}
+
 static void
 gen_test(dfwork_t *dfw, stnode_t *st_node)
 {
@@ -688,6 +902,7 @@ gen_test(dfwork_t *dfw, stnode_t *st_node)
 			break;
 
 		case STNODE_OP_AND:
+			order_operands(dfw, &st_arg1, &st_arg2);
 			gencode(dfw, st_arg1);
 
 			insn = dfvm_insn_new(DFVM_IF_FALSE_GOTO);
@@ -700,6 +915,10 @@ gen_test(dfwork_t *dfw, stnode_t *st_node)
 			break;
 
 		case STNODE_OP_OR:
+			if (gen_contains_any(dfw, st_node))
+				break;
+
+			order_operands(dfw, &st_arg1, &st_arg2);
 			gencode(dfw, st_arg1);
 
 			insn = dfvm_insn_new(DFVM_IF_TRUE_GOTO);
@@ -789,6 +1008,137 @@ gencode(dfwork_t *dfw, stnode_t *st_node)
 }
 
 
+static gboolean
+is_fusable_cmp(dfvm_opcode_t op)
+{
+	switch (op) {
+		case DFVM_ALL_EQ:
+		case DFVM_ANY_EQ:
+		case DFVM_ALL_NE:
+		case DFVM_ANY_NE:
+		case DFVM_ALL_GT:
+		case DFVM_ANY_GT:
+		case DFVM_ALL_GE:
+		case DFVM_ANY_GE:
+		case DFVM_ALL_LT:
+		case DFVM_ANY_LT:
+		case DFVM_ALL_LE:
+		case DFVM_ANY_LE:
+		case DFVM_ALL_CONTAINS:
+		case DFVM_ANY_CONTAINS:
+			return TRUE;
+		default:
+			return FALSE;
+	}
+}
+
+/*
+ * Replace the sequence
+ *
+ *	READ_TREE	field -> R
+ *	IF_FALSE_GOTO	next
+ *	<cmp>		R, constant
+ *   next:
+ *
+ * with a single CMP_TREE instruction, which compares the field values
+ * in the tree directly, when R isn't used anywhere else. That is by far
+ * the most common shape of a relation, and this saves two dispatches
+ * and building (and freeing) a list of the field values per packet.
+ */
+static void
+fuse_read_tree_cmp(dfwork_t *dfw)
+{
+	guint		length = dfw->insns->len;
+	guint		id, new_id;
+	int		*reg_uses;
+	gboolean	*is_target;
+	gboolean	*removed;
+	guint		*new_ids;
+	dfvm_insn_t	*insn, *jump, *cmp, *fused;
+	dfvm_value_t	*args[3];
+	GPtrArray	*insns;
+	int		reg;
+
+	reg_uses = g_new0(int, dfw->next_register);
+	is_target = g_new0(gboolean, length);
+	removed = g_new0(gboolean, length);
+	new_ids = g_new(guint, length);
+
+	for (id = 0; id < length; id++) {
+		insn = g_ptr_array_index(dfw->insns, id);
+		args[0] = insn->arg1;
+		args[1] = insn->arg2;
+		args[2] = insn->arg3;
+		for (int i = 0; i < 3; i++) {
+			if (args[i] && args[i]->type == REGISTER)
+				reg_uses[args[i]->value.numeric]++;
+		}
+		if (insn->op == DFVM_IF_TRUE_GOTO || insn->op == DFVM_IF_FALSE_GOTO)
+			is_target[insn->arg1->value.numeric] = TRUE;
+	}
+
+	for (id = 0; id + 3 < length; id++) {
+		insn = g_ptr_array_index(dfw->insns, id);
+		if (insn->op != DFVM_READ_TREE || insn->arg1->type != HFINFO)
+			continue;
+		reg = insn->arg2->value.numeric;
+
+		jump = g_ptr_array_index(dfw->insns, id + 1);
+		if (jump->op != DFVM_IF_FALSE_GOTO ||
+				jump->arg1->value.numeric != (guint32)(id + 3) ||
+				is_target[id + 1])
+			continue;
+
+		cmp = g_ptr_array_index(dfw->insns, id + 2);
+		if (!is_fusable_cmp(cmp->op) || is_target[id + 2] ||
+				cmp->arg1->type != REGISTER ||
+				cmp->arg1->value.numeric != (guint32)reg ||
+				cmp->arg2->type != FVALUE ||
+				reg_uses[reg] != 2)
+			continue;
+
+		fused = dfvm_insn_new(DFVM_CMP_TREE);
+		fused->arg1 = dfvm_value_ref(insn->arg1);
+		fused->arg2 = dfvm_value_ref(cmp->arg2);
+		fused->arg3 = dfvm_value_ref(dfvm_value_new_guint(cmp->op));
+		dfvm_insn_free(insn);
+		g_ptr_array_index(dfw->insns, id) = fused;
+		removed[id + 1] = TRUE;
+		removed[id + 2] = TRUE;
+		id += 2;
+	}
+
+	/* Renumber the instructions, and retarget the jumps. A jump to
+	 * a removed instruction goes to the next one that's left. */
+	new_id = 0;
+	for (id = 0; id < length; id++) {
+		new_ids[id] = new_id;
+		if (!removed[id])
+			new_id++;
+	}
+
+	insns = g_ptr_array_sized_new(new_id);
+	for (id = 0; id < length; id++) {
+		insn = g_ptr_array_index(dfw->insns, id);
+		if (removed[id]) {
+			dfvm_insn_free(insn);
+			continue;
+		}
+		insn->id = new_ids[id];
+		if (insn->op == DFVM_IF_TRUE_GOTO || insn->op == DFVM_IF_FALSE_GOTO)
+			insn->arg1->value.numeric = new_ids[insn->arg1->value.numeric];
+		g_ptr_array_add(insns, insn);
+	}
+	g_ptr_array_free(dfw->insns, TRUE);
+	dfw->insns = insns;
+	dfw->next_insn_id = new_id;
+
+	g_free(reg_uses);
+	g_free(is_target);
+	g_free(removed);
+	g_free(new_ids);
+}
+
 static void
 optimize(dfwork_t *dfw)
 {
@@ -845,6 +1195,7 @@ dfw_gencode(dfwork_t *dfw)
 	gencode(dfw, dfw->st_root);
 	dfw_append_insn(dfw, dfvm_insn_new(DFVM_RETURN));
 	if (dfw->flags & DF_OPTIMIZE) {
+		fuse_read_tree_cmp(dfw);
 		optimize(dfw);
 	}
 }
@@ -1380,6 +1380,38 @@ op_to_error_msg(stnode_op_t st_op)
 	}
 }
 
+static fvalue_t *
+constant_arithmetic(stnode_op_t st_op, const fvalue_t *fv1, const fvalue_t *fv2)
+{
+	fvalue_t	*result;
+	char		*err_msg = NULL;
+
+	switch (st_op) {
+		case STNODE_OP_ADD:
+			result = fvalue_add(fv1, fv2, &err_msg);
+			break;
+		case STNODE_OP_SUBTRACT:
+			result = fvalue_subtract(fv1, fv2, &err_msg);
+			break;
+		case STNODE_OP_MULTIPLY:
+			result = fvalue_multiply(fv1, fv2, &err_msg);
+			break;
+		case STNODE_OP_DIVIDE:
+			result = fvalue_divide(fv1, fv2, &err_msg);
+			break;
+		case STNODE_OP_MODULO:
+			result = fvalue_modulo(fv1, fv2, &err_msg);
+			break;
+		case STNODE_OP_BITWISE_AND:
+			result = fvalue_bitwise_and(fv1, fv2, &err_msg);
+			break;
+		default:
+			ws_assert_not_reached();
+	}
+	g_free(err_msg);
+	return result;
+}
+
 static ftenum_t
 check_arithmetic_LHS(dfwork_t *dfw, stnode_op_t st_op,
 			stnode_t *st_node, stnode_t *st_arg1, stnode_t *st_arg2,
@@ -1457,6 +1489,18 @@ check_arithmetic_LHS(dfwork_t *dfw, stnode_op_t st_op,
 			ftype_name(ftype1), ftype_name(ftype2));
 	}
 
+	if (stnode_type_id(st_arg1) == STTYPE_FVALUE &&
+			stnode_type_id(st_arg2) == STTYPE_FVALUE) {
+		/* Pre-compute constant arithmetic result. If it fails,
+		 * leave it to be evaluated (and fail) at run time. */
+		fvalue_t *new_fv = constant_arithmetic(st_op,
+				stnode_data(st_arg1), stnode_data(st_arg2));
+		if (new_fv != NULL) {
+			/* Replaces arithmetic operator with result */
+			stnode_replace(st_node, STTYPE_FVALUE, new_fv);
+		}
+	}
+
 	return ftype1;
 }
 
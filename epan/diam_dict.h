@@ -70,4 +70,8 @@ extern void ddict_print(FILE* fh, ddict_t* d);
 extern ddict_t* ddict_scan(const char* directory, const char* filename, int dbg);
 extern void ddict_free(ddict_t* d);
 
+/* Save a parsed dictionary to, or load it from, a binary cache file. */
+extern void ddict_cache_save(const char* filename, GChecksum* key, ddict_t* d);
+extern ddict_t* ddict_cache_load(const char* filename, GChecksum* key);
+
 #endif
@@ -0,0 +1,222 @@
+/* dict_cache.c
+ * Binary caches of dictionaries parsed at startup
+ *
+ * Wireshark - Network traffic analyzer
+ * By Gerald Combs <gerald@wireshark.org>
+ * Copyright 1998 Gerald Combs
+ *
+ * SPDX-License-Identifier: GPL-2.0-or-later
+ */
+
+#include "config.h"
+
+#define WS_LOG_DOMAIN LOG_DOMAIN_EPAN
+
+#include <string.h>
+
+#include <wsutil/file_util.h>
+#include <wsutil/filesystem.h>
+#include <wsutil/wslog.h>
+
+#include "dict_cache.h"
+
+#define DICT_CACHE_NO_STRING G_MAXUINT32
+
+void
+dict_cache_key_add_string(GChecksum *key, const char *str)
+{
+    /* Include the terminator so that "ab","c" and "a","bc" differ. */
+    g_checksum_update(key, (const guchar *)str, strlen(str) + 1);
+}
+
+static gint
+name_cmp(gconstpointer a, gconstpointer b)
+{
+    return strcmp(*(const char * const *)a, *(const char * const *)b);
+}
+
+void
+dict_cache_key_add_dir(GChecksum *key, const char *dirname)
+{
+    GDir *dir;
+    GPtrArray *names;
+    const char *name;
+    guint i;
+
+    if (!dirname || !*dirname || !(dir = g_dir_open(dirname, 0, NULL)))
+        return;
+
+    /* The order in which g_dir_read_name() returns files isn't defined. */
+    names = g_ptr_array_new_with_free_func(g_free);
+    while ((name = g_dir_read_name(dir)) != NULL)
+        g_ptr_array_add(names, g_strdup(name));
+    g_dir_close(dir);
+    g_ptr_array_sort(names, name_cmp);
+
+    for (i = 0; i < names->len; i++) {
+        char *path = g_build_filename(dirname, (const char *)g_ptr_array_index(names, i), NULL);
+        ws_statb64 st;
+
+        if (ws_stat64(path, &st) == 0) {
+            gint64 stamp[2] = { (gint64)st.st_size, (gint64)st.st_mtime };
+
+            dict_cache_key_add_string(key, path);
+            g_checksum_update(key, (const guchar *)stamp, sizeof stamp);
+        }
+        g_free(path);
+    }
+    g_ptr_array_free(names, TRUE);
+}
+
+GByteArray *
+dict_cache_new(const char *magic, guint32 version, GChecksum *key)
+{
+    GByteArray *cache = g_byte_array_new();
+
+    dict_cache_put_str(cache, magic);
+    dict_cache_put_u32(cache, version);
+    dict_cache_put_str(cache, g_checksum_get_string(key));
+    return cache;
+}
+
+void
+dict_cache_put_u32(GByteArray *cache, guint32 value)
+{
+    g_byte_array_append(cache, (const guint8 *)&value, sizeof value);
+}
+
+void
+dict_cache_put_u64(GByteArray *cache, guint64 value)
+{
+    g_byte_array_append(cache, (const guint8 *)&value, sizeof value);
+}
+
+void
+dict_cache_put_str(GByteArray *cache, const char *str)
+{
+    guint32 len;
+
+    if (!str) {
+        dict_cache_put_u32(cache, DICT_CACHE_NO_STRING);
+        return;
+    }
+    len = (guint32)strlen(str);
+    dict_cache_put_u32(cache, len);
+    g_byte_array_append(cache, (const guint8 *)str, len);
+}
+
+void
+dict_cache_save(const char *filename, GByteArray *cache)
+{
+    char *pf_dir_path;
+    char *path;
+    GError *err = NULL;
+
+    if (create_persconffile_dir(&pf_dir_path) == -1) {
+        ws_info("Can't create directory %s for %s", pf_dir_path, filename);
+        g_free(pf_dir_path);
+        g_byte_array_free(cache, TRUE);
+        return;
+    }
+
+    path = get_persconffile_path(filename, FALSE);
+    if (!g_file_set_contents(path, (const gchar *)cache->data, cache->len, &err)) {
+        ws_info("Can't write %s: %s", path, err->message);
+        g_error_free(err);
+    }
+    g_free(path);
+    g_byte_array_free(cache, TRUE);
+}
+
+gboolean
+dict_cache_open(dict_cache_reader_t *reader, const char *filename,
+        const char *magic, guint32 version, GChecksum *key)
+{
+    char *path = get_persconffile_path(filename, FALSE);
+    GByteArray *header;
+    gboolean match;
+
+    reader->mapped = g_mapped_file_new(path, FALSE, NULL);
+    g_free(path);
+    if (!reader->mapped)
+        return FALSE;
+
+    reader->ptr = (const guint8 *)g_mapped_file_get_contents(reader->mapped);
+    reader->end = reader->ptr + g_mapped_file_get_length(reader->mapped);
+    reader->ok = TRUE;
+
+    header = dict_cache_new(magic, version, key);
+    match = (gsize)(reader->end - reader->ptr) >= header->len &&
+            memcmp(reader->ptr, header->data, header->len) == 0;
+    if (match) {
+        reader->ptr += header->len;
+    } else {
+        ws_debug("%s is out of date", filename);
+        dict_cache_close(reader);
+    }
+    g_byte_array_free(header, TRUE);
+
+    return match;
+}
+
+guint32
+dict_cache_get_u32(dict_cache_reader_t *reader)
+{
+    guint32 value;
+
+    if (!reader->ok || (gsize)(reader->end - reader->ptr) < sizeof value) {
+        reader->ok = FALSE;
+        return 0;
+    }
+    memcpy(&value, reader->ptr, sizeof value);
+    reader->ptr += sizeof value;
+    return value;
+}
+
+guint64
+dict_cache_get_u64(dict_cache_reader_t *reader)
+{
+    guint64 value;
+
+    if (!reader->ok || (gsize)(reader->end - reader->ptr) < sizeof value) {
+        reader->ok = FALSE;
+        return 0;
+    }
+    memcpy(&value, reader->ptr, sizeof value);
+    reader->ptr += sizeof value;
+    return value;
+}
+
+char *
+dict_cache_get_str(dict_cache_reader_t *reader)
+{
+    guint32 len = dict_cache_get_u32(reader);
+    char *str;
+
+    if (!reader->ok || len == DICT_CACHE_NO_STRING)
+        return NULL;
+    if ((gsize)(reader->end - reader->ptr) < len) {
+        reader->ok = FALSE;
+        return NULL;
+    }
+    str = g_strndup((const char *)reader->ptr, len);
+    reader->ptr += len;
+    return str;
+}
+
+gboolean
+dict_cache_at_end(dict_cache_reader_t *reader)
+{
+    return reader->ok && reader->ptr == reader->end;
+}
+
+void
+dict_cache_close(dict_cache_reader_t *reader)
+{
+    if (reader->mapped) {
+        g_mapped_file_unref(reader->mapped);
+        reader->mapped = NULL;
+    }
+    reader->ptr = reader->end = NULL;
+    reader->ok = FALSE;
+}
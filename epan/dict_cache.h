@@ -0,0 +1,87 @@
+/* dict_cache.h
+ * Binary caches of dictionaries parsed at startup
+ *
+ * Wireshark - Network traffic analyzer
+ * By Gerald Combs <gerald@wireshark.org>
+ * Copyright 1998 Gerald Combs
+ *
+ * SPDX-License-Identifier: GPL-2.0-or-later
+ */
+#ifndef __DICT_CACHE_H__
+#define __DICT_CACHE_H__
+
+#include <glib.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif /* __cplusplus */
+
+/*
+ * Some dictionaries (MIB modules, the Diameter and RADIUS dictionaries)
+ * take a noticeable time to parse at every startup. These routines let
+ * their loaders save what they parsed to a file in the personal
+ * configuration directory and read it back on the next start, as long
+ * as the inputs, summarized by a key, haven't changed.
+ *
+ * The cache is a header (magic, format version and key) followed by
+ * native-endian 32-bit integers and length-prefixed strings, so it can
+ * only be read back on the machine that wrote it.
+ */
+
+/* Adds a string to a cache key. */
+void dict_cache_key_add_string(GChecksum *key, const char *str);
+
+/*
+ * Adds the name, size and modification time of every file in a
+ * directory to a cache key. A missing directory adds nothing.
+ */
+void dict_cache_key_add_dir(GChecksum *key, const char *dirname);
+
+/* Starts a new cache, returning a buffer that holds its header. */
+GByteArray *dict_cache_new(const char *magic, guint32 version, GChecksum *key);
+
+void dict_cache_put_u32(GByteArray *cache, guint32 value);
+
+void dict_cache_put_u64(GByteArray *cache, guint64 value);
+
+/* Strings can be NULL. */
+void dict_cache_put_str(GByteArray *cache, const char *str);
+
+/*
+ * Writes a cache to the given file in the personal configuration
+ * directory and frees it. Failures are silently ignored; the
+ * dictionary will just be parsed again next time.
+ */
+void dict_cache_save(const char *filename, GByteArray *cache);
+
+typedef struct {
+    GMappedFile *mapped;
+    const guint8 *ptr;
+    const guint8 *end;
+    gboolean ok;        /* FALSE once a read went past the end */
+} dict_cache_reader_t;
+
+/*
+ * Opens a cache file and checks its header. Returns FALSE if there's
+ * no cache or if it was written for other inputs or another version.
+ */
+gboolean dict_cache_open(dict_cache_reader_t *reader, const char *filename,
+        const char *magic, guint32 version, GChecksum *key);
+
+guint32 dict_cache_get_u32(dict_cache_reader_t *reader);
+
+guint64 dict_cache_get_u64(dict_cache_reader_t *reader);
+
+/* Returns a newly allocated string, or NULL. */
+char *dict_cache_get_str(dict_cache_reader_t *reader);
+
+/* TRUE if all the data was read without error. */
+gboolean dict_cache_at_end(dict_cache_reader_t *reader);
+
+void dict_cache_close(dict_cache_reader_t *reader);
+
+#ifdef __cplusplus
+}
+#endif /* __cplusplus */
+
+#endif /* __DICT_CACHE_H__ */
@@ -149,6 +149,7 @@ static snmp_usm_decoder_t priv_protos[] = {
 
 static snmp_ue_assoc_t* ueas = NULL;
 static guint num_ueas = 0;
+static uat_t* assocs_uat = NULL;
 static snmp_ue_assoc_t* localized_ues = NULL;
 static snmp_ue_assoc_t* unlocalized_ues = NULL;
 /****/
@@ -1642,6 +1643,8 @@ get_user_assoc(tvbuff_t* engine_tvb, tvbuff_t* user_tvb, packet_info *pinfo)
 	guint given_engine_len = 0;
 	guint8* given_engine = NULL;
 
+	uat_ensure_loaded(assocs_uat);
+
 	if ( ! (localized_ues || unlocalized_ues ) ) return NULL;
 
 	if (! ( user_tvb && engine_tvb ) ) return NULL;
@@ -2517,13 +2520,13 @@ void proto_register_snmp(void) {
 		UAT_END_FIELDS
 	};
 
-	uat_t *assocs_uat = uat_new("SNMP Users",
+	assocs_uat = uat_new("SNMP Users",
 				    sizeof(snmp_ue_assoc_t),
 				    "snmp_users",
 				    TRUE,
 				    &ueas,
 				    &num_ueas,
-				    UAT_AFFECTS_DISSECTION,	/* affects dissection of packets, but not set of named fields */
+				    UAT_AFFECTS_DISSECTION|UAT_LOAD_ON_DEMAND,	/* affects dissection of packets, but not set of named fields */
 				    "ChSNMPUsersSection",
 				    snmp_users_copy_cb,
 				    snmp_users_update_cb,
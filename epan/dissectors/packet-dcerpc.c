@@ -1884,7 +1884,7 @@ dcerpc_cn_call_hash(gconstpointer k)
     hash += key->call_id;
     /* sizeof(guint) might be smaller than sizeof(guint64) */
     hash += (guint)key->transport_salt;
-    hash += (guint)(key->transport_salt << sizeof(guint));
+    hash += (guint)(key->transport_salt >> 32);
 
     return hash;
 }
@@ -1928,7 +1928,8 @@ static guint
 dcerpc_matched_hash(gconstpointer k)
 {
     const dcerpc_matched_key *key = (const dcerpc_matched_key *)k;
-    return key->frame;
+    /* There can be more than one call in a frame */
+    return key->frame ^ (key->call_id << 16);
 }
 
 static gboolean
@@ -7184,11 +7185,11 @@ proto_register_dcerpc(void)
                                           dcerpc_auth_context_equal);
 
     /* structures and data for CALL */
-    dcerpc_cn_calls = wmem_map_new_autoreset(wmem_epan_scope(), wmem_file_scope(), dcerpc_cn_call_hash, dcerpc_cn_call_equal);
-    dcerpc_dg_calls = wmem_map_new_autoreset(wmem_epan_scope(), wmem_file_scope(), dcerpc_dg_call_hash, dcerpc_dg_call_equal);
+    dcerpc_cn_calls = wmem_map_new_flat_autoreset(wmem_epan_scope(), wmem_file_scope(), dcerpc_cn_call_hash, dcerpc_cn_call_equal);
+    dcerpc_dg_calls = wmem_map_new_flat_autoreset(wmem_epan_scope(), wmem_file_scope(), dcerpc_dg_call_hash, dcerpc_dg_call_equal);
 
     /* structure and data for MATCHED */
-    dcerpc_matched = wmem_map_new_autoreset(wmem_epan_scope(), wmem_file_scope(), dcerpc_matched_hash, dcerpc_matched_equal);
+    dcerpc_matched = wmem_map_new_flat_autoreset(wmem_epan_scope(), wmem_file_scope(), dcerpc_matched_hash, dcerpc_matched_equal);
 
     register_init_routine(decode_dcerpc_inject_bindings);
 
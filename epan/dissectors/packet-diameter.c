@@ -46,6 +46,7 @@
 #include <epan/srt_table.h>
 #include <epan/exported_pdu.h>
 #include <epan/diam_dict.h>
+#include <epan/dict_cache.h>
 #include <epan/sctpppids.h>
 #include <epan/show_exception.h>
 #include <epan/to_str.h>
@@ -63,6 +64,9 @@
 void proto_register_diameter(void);
 void proto_reg_handoff_diameter(void);
 
+/* Binary cache of the parsed dictionary, in the personal configuration directory */
+#define DIAMETER_DICT_CACHE "diameter_dict_cache"
+
 /* Diameter Header Flags */
 /* RPETrrrrCCCCCCCCCCCCCCCCCCCCCCCC  */
 #define DIAM_FLAGS_R 0x80
@@ -2058,6 +2062,7 @@ dictionary_load(void)
 	gboolean do_debug_parser = getenv("WIRESHARK_DEBUG_DIAM_DICT_PARSER") ? TRUE : FALSE;
 	gboolean do_dump_dict = getenv("WIRESHARK_DUMP_DIAM_DICT") ? TRUE : FALSE;
 	char *dir;
+	GChecksum *cache_key;
 	const avp_type_t *type;
 	const avp_type_t *octetstring = &basic_types[0];
 	diam_avp_t *avp;
@@ -2090,9 +2095,20 @@ dictionary_load(void)
 		g_hash_table_insert(build_dict.types,(gchar *)type->name,(void *)type);
 	}
 
-	/* load the dictionary */
+	/*
+	 * load the dictionary, from the cache if none of the files in the
+	 * dictionary directory changed since it was written
+	 */
 	dir = wmem_strdup_printf(NULL, "%s" G_DIR_SEPARATOR_S "diameter" G_DIR_SEPARATOR_S, get_datafile_dir());
-	d = ddict_scan(dir,"dictionary.xml",do_debug_parser);
+	cache_key = g_checksum_new(G_CHECKSUM_SHA256);
+	dict_cache_key_add_dir(cache_key, dir);
+	d = do_debug_parser ? NULL : ddict_cache_load(DIAMETER_DICT_CACHE, cache_key);
+	if (d == NULL) {
+		d = ddict_scan(dir,"dictionary.xml",do_debug_parser);
+		if (d != NULL)
+			ddict_cache_save(DIAMETER_DICT_CACHE, cache_key, d);
+	}
+	g_checksum_free(cache_key);
 	wmem_free(NULL, dir);
 	if (d == NULL) {
 		g_hash_table_destroy(vendors);
@@ -1366,6 +1366,56 @@ qname_labels_count(const gchar* name, gint name_len)
     return labels;
 }
 
+/*
+ * Names already expanded in this packet, keyed by where they start in the
+ * message; responses tend to point back at the same few names over and
+ * over. Only names made of plain labels (and pointers) are kept, so they
+ * can be appended verbatim when a later name points at them.
+ */
+typedef struct {
+  tvbuff_t *tvb;
+  int       dns_data_offset;
+  int       offset;
+} dns_name_key_t;
+
+typedef struct {
+  const gchar *name;
+  gint         name_len;
+  int          len;             /* bytes consumed at offset */
+  int          pointers_count;
+} dns_name_entry_t;
+
+static wmem_map_t *dns_name_cache = NULL;
+
+static guint
+dns_name_key_hash(gconstpointer k)
+{
+  const dns_name_key_t *key = (const dns_name_key_t *)k;
+
+  return g_direct_hash(key->tvb) ^ ((guint)key->dns_data_offset << 16) ^ (guint)key->offset;
+}
+
+static gboolean
+dns_name_key_equal(gconstpointer k1, gconstpointer k2)
+{
+  const dns_name_key_t *key1 = (const dns_name_key_t *)k1;
+  const dns_name_key_t *key2 = (const dns_name_key_t *)k2;
+
+  return key1->tvb == key2->tvb && key1->dns_data_offset == key2->dns_data_offset &&
+         key1->offset == key2->offset;
+}
+
+static dns_name_entry_t *
+dns_name_cache_lookup(tvbuff_t *tvb, int dns_data_offset, int offset)
+{
+  dns_name_key_t key;
+
+  key.tvb = tvb;
+  key.dns_data_offset = dns_data_offset;
+  key.offset = offset;
+  return (dns_name_entry_t *)wmem_map_lookup(dns_name_cache, &key);
+}
+
 /* This function returns the number of bytes consumed and the expanded string
  * in *name.
  * The string is allocated with wmem_packet_scope scope and does not need to be freed.
@@ -1382,12 +1432,23 @@ expand_dns_name(tvbuff_t *tvb, int offset, int max_len, int dns_data_offset,
   int     component_len;
   int     indir_offset;
   int     maxname;
+  gboolean cacheable      = (max_len == 0);
+  dns_name_entry_t *entry;
 
   const int min_len = 1;        /* Minimum length of encoded name (for root) */
         /* If we're about to return a value (probably negative) which is less
          * than the minimum length, we're looking at bad data and we're liable
          * to put the dissector into a loop.  Instead we throw an exception */
 
+  if (cacheable) {
+    entry = dns_name_cache_lookup(tvb, dns_data_offset, offset);
+    if (entry) {
+      *name = entry->name;
+      *name_len = entry->name_len;
+      return entry->len;
+    }
+  }
+
   maxname = MAX_DNAME_LEN;
   np=(gchar *)wmem_alloc(wmem_packet_scope(), maxname);
   *name=np;
@@ -1442,6 +1503,8 @@ expand_dns_name(tvbuff_t *tvb, int offset, int max_len, int dns_data_offset,
             int label_len;
             int print_len;
 
+            cacheable = FALSE;
+
             bit_count = tvb_get_guint8(tvb, offset);
             offset++;
             label_len = (bit_count - 1) / 8 + 1;
@@ -1529,11 +1592,41 @@ expand_dns_name(tvbuff_t *tvb, int offset, int max_len, int dns_data_offset,
           return len;
         }
 
+        /*
+         * If we've already expanded the name we're pointing at, append
+         * it instead of walking it again; this is what the label case
+         * above would have done with the same bytes.
+         */
+        entry = cacheable ? dns_name_cache_lookup(tvb, dns_data_offset, indir_offset) : NULL;
+        if (entry && pointers_count + entry->pointers_count <= MAX_DNAME_LEN) {
+          int copy_len = entry->name_len;
+
+          if (copy_len > 0) {
+            if (np != *name) {
+              if (maxname > 0) {
+                *np++ = '.';
+                (*name_len)++;
+              }
+            }
+            maxname--;
+            if (copy_len > maxname)
+              copy_len = maxname > 0 ? maxname : 0;
+            memcpy(np, entry->name, copy_len);
+            np += copy_len;
+            (*name_len) += copy_len;
+            maxname -= copy_len;
+          }
+          pointers_count += entry->pointers_count;
+          goto done;
+        }
+
         offset = indir_offset;
         break;   /* now continue processing from there */
     }
   }
 
+done:
+
   // Do we have space for the terminating 0?
   if (maxname > 0) {
     *np = '\0';
@@ -1549,6 +1642,20 @@ expand_dns_name(tvbuff_t *tvb, int offset, int max_len, int dns_data_offset,
     len = offset - start_offset;
   }
 
+  if (cacheable && maxname > 0) {
+    dns_name_key_t *key = wmem_new(wmem_packet_scope(), dns_name_key_t);
+
+    key->tvb = tvb;
+    key->dns_data_offset = dns_data_offset;
+    key->offset = start_offset;
+    entry = wmem_new(wmem_packet_scope(), dns_name_entry_t);
+    entry->name = *name;
+    entry->name_len = *name_len;
+    entry->len = len;
+    entry->pointers_count = pointers_count;
+    wmem_map_insert(dns_name_cache, key, entry);
+  }
+
   return len;
 }
 
@@ -6534,6 +6641,8 @@ proto_register_dns(void)
   expert_dns = expert_register_protocol(proto_dns);
   expert_register_field_array(expert_dns, ei, array_length(ei));
 
+  dns_name_cache = wmem_map_new_autoreset(wmem_epan_scope(), wmem_packet_scope(), dns_name_key_hash, dns_name_key_equal);
+
   dns_module = prefs_register_protocol(proto_dns, NULL);
 
   prefs_register_bool_preference(dns_module, "desegment_dns_messages",
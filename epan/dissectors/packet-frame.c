@@ -1434,10 +1434,16 @@ dissect_frame(tvbuff_t *tvb, packet_info *pinfo, proto_tree *parent_tree, void*
 	ENDTRY;
 
 	if (proto_field_is_referenced(tree, hf_frame_protocols)) {
-		wmem_strbuf_t *val = wmem_strbuf_new_sized(pinfo->pool, 128);
+		wmem_strbuf_t *val;
 		wmem_list_frame_t *frame;
+		gsize val_len = 1;
 		/* skip the first entry, it's always the "frame" protocol */
 		frame = wmem_list_frame_next(wmem_list_head(pinfo->layers));
+		/* size the buffer for the whole stack so that it is never regrown */
+		for (wmem_list_frame_t *layer = frame; layer; layer = wmem_list_frame_next(layer)) {
+			val_len += strlen(proto_get_protocol_filter_name(GPOINTER_TO_UINT(wmem_list_frame_data(layer)))) + 1;
+		}
+		val = wmem_strbuf_new_sized(pinfo->pool, val_len);
 		if (frame) {
 			wmem_strbuf_append(val, proto_get_protocol_filter_name(GPOINTER_TO_UINT(wmem_list_frame_data(frame))));
 			frame = wmem_list_frame_next(frame);
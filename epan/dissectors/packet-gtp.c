@@ -2485,6 +2485,10 @@ guint32 gtp_session_count;
 GHashTable* session_table;
 /* Relation between <teid,ip> -> frame */
 wmem_map_t* frame_map;
+/* Relation between frame -> <teid,ip> keys inserted by it */
+static wmem_map_t* frame_keys_map;
+/* Relation between session -> frames */
+static wmem_map_t* session_frames_map;
 
 typedef struct {
     guint32 teid;
@@ -2525,28 +2529,57 @@ get_frame(address ip, guint32 teid, guint32 *frame) {
     return 0;
 }
 
-static gboolean
-frame_equal(void *key _U_, void *value, void *data){
-    guint32 frame = GPOINTER_TO_UINT(data);
+void
+remove_frame_info(guint32 f) {
+    wmem_list_t *keys;
+    wmem_list_frame_t *elem;
+    gtp_info_t *key;
 
-    return (GPOINTER_TO_UINT(value) == frame);
+    keys = (wmem_list_t *)wmem_map_remove(frame_keys_map, GUINT_TO_POINTER(f));
+    if (keys == NULL) {
+        return;
+    }
+    for (elem = wmem_list_head(keys); elem; elem = wmem_list_frame_next(elem)) {
+        key = (gtp_info_t *)wmem_list_frame_data(elem);
+        /* A later frame may have taken over the <teid,ip> in the meantime */
+        if (GPOINTER_TO_UINT(wmem_map_lookup(frame_map, key)) == f) {
+            wmem_map_remove(frame_map, key);
+        }
+    }
+    wmem_destroy_list(keys);
 }
 
-void
-remove_frame_info(guint32 f) {
-    /* XXX: This iterates through the entire map and it is slow if done
-     * often. For large files with lots of removals, there are better
-     * alternatives, e.g. marking sessions as expired and then periodically
-     * removing all expired sessions from the map, or using a bijective
-     * map to coordinate removals.
-     */
-    wmem_map_foreach_remove(frame_map, frame_equal, GUINT_TO_POINTER(f));
+static void
+remove_session_info(guint32 session) {
+    wmem_list_t *frames;
+    wmem_list_frame_t *elem;
+    guint32 f;
+
+    frames = (wmem_list_t *)wmem_map_lookup(session_frames_map, GUINT_TO_POINTER(session));
+    if (frames == NULL) {
+        return;
+    }
+    for (elem = wmem_list_head(frames); elem; elem = wmem_list_frame_next(elem)) {
+        f = GPOINTER_TO_UINT(wmem_list_frame_data(elem));
+        /* Skip frames that have been assigned to another session since */
+        if (GPOINTER_TO_UINT(g_hash_table_lookup(session_table, GUINT_TO_POINTER(f))) == session) {
+            remove_frame_info(f);
+        }
+    }
 }
 
 void
 add_gtp_session(guint32 frame, guint32 session) {
+    wmem_list_t *frames;
 
     g_hash_table_insert(session_table, GUINT_TO_POINTER(frame), GUINT_TO_POINTER(session));
+
+    frames = (wmem_list_t *)wmem_map_lookup(session_frames_map, GUINT_TO_POINTER(session));
+    if (frames == NULL) {
+        frames = wmem_list_new(wmem_file_scope());
+        wmem_map_insert(session_frames_map, GUINT_TO_POINTER(session), frames);
+    }
+    wmem_list_prepend(frames, GUINT_TO_POINTER(frame));
 }
 
 gboolean
@@ -2583,8 +2616,7 @@ void
 fill_map(wmem_list_t *teid_list, wmem_list_t *ip_list, guint32 frame) {
     wmem_list_frame_t *elem_ip, *elem_teid;
     gtp_info_t *gtp_info;
-    gpointer session_p, fr_p;
-    GHashTableIter iter;
+    wmem_list_t *keys;
     guint32 teid, session;
     address *ip;
 
@@ -2612,17 +2644,17 @@ fill_map(wmem_list_t *teid_list, wmem_list_t *ip_list, guint32 frame) {
                 /* We look for its session ID */
                 session = GPOINTER_TO_UINT(g_hash_table_lookup(session_table, GUINT_TO_POINTER(frame)));
                 if (session) {
-                    g_hash_table_iter_init(&iter, session_table);
-                    while (g_hash_table_iter_next(&iter, &fr_p, &session_p)) {
-                        /* If the msg has the same session ID and it's not the upd req we have to remove its info */
-                        if (GPOINTER_TO_UINT(session_p) == session) {
-                            /* If it's the session we are looking for, we remove all the frame information */
-                            remove_frame_info(GPOINTER_TO_UINT(fr_p));
-                        }
-                    }
+                    /* We remove the information of every frame in that session */
+                    remove_session_info(session);
                 }
             }
             wmem_map_insert(frame_map, gtp_info, GUINT_TO_POINTER(frame));
+            keys = (wmem_list_t *)wmem_map_lookup(frame_keys_map, GUINT_TO_POINTER(frame));
+            if (keys == NULL) {
+                keys = wmem_list_new(wmem_file_scope());
+                wmem_map_insert(frame_keys_map, GUINT_TO_POINTER(frame), keys);
+            }
+            wmem_list_prepend(keys, gtp_info);
             elem_teid = wmem_list_frame_next(elem_teid);
         }
         elem_ip = wmem_list_frame_next(elem_ip);
@@ -4279,7 +4311,12 @@ gtp_match_response(tvbuff_t * tvb, packet_info * pinfo, proto_tree * tree, gint
         break;
     }
 
-    gcrp = (gtp_msg_hash_t *)g_hash_table_lookup(gtp_info->matched, &gcr);
+    /* A request or response seen for the first time can't have been
+     * matched yet, so don't walk the entries sharing its sequence number.
+     */
+    if (PINFO_FD_VISITED(pinfo) || (!gcr.req_frame && !gcr.rep_frame)) {
+        gcrp = (gtp_msg_hash_t *)g_hash_table_lookup(gtp_info->matched, &gcr);
+    }
 
     if (gcrp) {
 
@@ -9789,9 +9826,6 @@ track_gtp_session(tvbuff_t * tvb, packet_info * pinfo, proto_tree * tree, gtp_hd
              * XXX: Wouldn't it be better not to insert this information
              * in the first place for other message types, instead of
              * inserting it and then immediately removing it?
-             * At the very least, it would be faster to iterate through the
-             * teid_list and ip_list and remove via keys rather than doing
-             * removal through a reverse lookup.
              */
             if ((gtp_hdr->message != GTP_MSG_CREATE_PDP_RESP && gtp_hdr->message != GTP_MSG_CREATE_PDP_REQ && gtp_hdr->message != GTP_MSG_UPDATE_PDP_RESP
                 && gtp_hdr->message != GTP_MSG_UPDATE_PDP_REQ)) {
@@ -10868,7 +10902,9 @@ gtp_init(void)
 {
     gtp_session_count = 1;
     session_table = g_hash_table_new(g_direct_hash, g_direct_equal);
-    frame_map = wmem_map_new(wmem_file_scope(), gtp_info_hash, gtp_info_equal);
+    frame_map = wmem_map_new_flat(wmem_file_scope(), gtp_info_hash, gtp_info_equal);
+    frame_keys_map = wmem_map_new_flat(wmem_file_scope(), g_direct_hash, g_direct_equal);
+    session_frames_map = wmem_map_new_flat(wmem_file_scope(), g_direct_hash, g_direct_equal);
 }
 
 static void
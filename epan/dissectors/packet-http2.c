@@ -2231,9 +2231,9 @@ inflate_http2_header_block(tvbuff_t *tvb, packet_info *pinfo, guint offset, prot
         return;
     }
 
+    guint header_fields = 0;
     for(i = 0; i < wmem_array_get_count(headers); ++i) {
         http2_header_t *in;
-        tvbuff_t *next_tvb;
 
         in = (http2_header_t*)wmem_array_index(headers, i);
 
@@ -2242,21 +2242,31 @@ inflate_http2_header_block(tvbuff_t *tvb, packet_info *pinfo, guint offset, prot
         }
 
         header_len += in->table.data.datalen;
+        header_fields++;
+    }
 
-        /* Now setup the tvb buffer to have the new data */
-        next_tvb = tvb_new_child_real_data(tvb, in->table.data.data, in->table.data.datalen, in->table.data.datalen);
-        if (!header_tvb) {
-            header_tvb = tvb_new_composite();
-        }
-        tvb_composite_append(header_tvb, next_tvb);
+    if (header_fields == 0) {
+        return;
     }
 
+    /* Put the decompressed headers into one contiguous buffer rather than
+     * a composite tvb, which is needlessly slow to access field by field. */
+    guint8 *header_buf_data = (guint8 *)wmem_alloc(pinfo->pool, header_len);
+    guint header_buf_offset = 0;
+    for(i = 0; i < wmem_array_get_count(headers); ++i) {
+        http2_header_t *in;
 
-    if (!header_tvb) {
-        return;
+        in = (http2_header_t*)wmem_array_index(headers, i);
+
+        if(in->type == HTTP2_HD_HEADER_TABLE_SIZE_UPDATE) {
+            continue;
+        }
+
+        memcpy(header_buf_data + header_buf_offset, in->table.data.data, in->table.data.datalen);
+        header_buf_offset += in->table.data.datalen;
     }
 
-    tvb_composite_finalize(header_tvb);
+    header_tvb = tvb_new_child_real_data(tvb, header_buf_data, header_len, header_len);
     add_new_data_source(pinfo, header_tvb, "Decompressed Header");
 
     ti = proto_tree_add_uint(tree, hf_http2_header_length, header_tvb, hoffset, 1, header_len);
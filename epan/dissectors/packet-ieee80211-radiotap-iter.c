@@ -13,6 +13,7 @@
 
 #include <epan/packet.h>
 #include <wsutil/pint.h>
+#include <wsutil/bits_ctz.h>
 
 #define le16_to_cpu		GINT16_FROM_LE
 #define le32_to_cpu		GINT32_FROM_LE
@@ -304,7 +305,7 @@ return_tlv:
 
 	while (1) {
 		int hit = 0;
-		int pad, align, size, subns;
+		int pad, align, size, subns, skip;
 		guint32 oui;
 
 		/* if no more EXT bits, that's it */
@@ -312,8 +313,18 @@ return_tlv:
 		    !(iterator->_bitmap_shifter & 1))
 			return -ENOENT;
 
-		if (!(iterator->_bitmap_shifter & 1))
-			goto next_entry; /* arg not present */
+		if (!(iterator->_bitmap_shifter & 1)) {
+			/*
+			 * arg not present; jump straight to the next
+			 * present bit of this word.  If there is none,
+			 * the EXT bit is clear as well and we're done.
+			 */
+			if (!iterator->_bitmap_shifter)
+				return -ENOENT;
+			skip = ws_ctz(iterator->_bitmap_shifter);
+			iterator->_bitmap_shifter >>= skip;
+			iterator->_arg_index += skip;
+		}
 
 		/* get alignment/size of data */
 		switch (iterator->_arg_index % 32) {
@@ -278,6 +278,42 @@ static extra_esp_sa_records_t extra_esp_sa_records;
 static uat_t * esp_uat = NULL;
 static guint num_sa_uat = 0;
 
+/* Cache of SA lookups, so that the records only need to be searched once
+   per <protocol, src, dst, spi>.  Maps esp_sa_cache_key_t -> record
+   (NULL when no usable SA matches).  Emptied whenever the records change. */
+typedef struct {
+  gint    protocol_typ;
+  guint32 spi;
+  guint8  src[16];
+  guint8  dst[16];
+} esp_sa_cache_key_t;
+
+static GHashTable *esp_sa_cache = NULL;
+
+static guint
+esp_sa_cache_hash(gconstpointer k)
+{
+  const esp_sa_cache_key_t *key = (const esp_sa_cache_key_t *)k;
+
+  /* The SPI is likely unique, so just use it. */
+  return key->spi;
+}
+
+static gboolean
+esp_sa_cache_equal(gconstpointer k1, gconstpointer k2)
+{
+  return memcmp(k1, k2, sizeof(esp_sa_cache_key_t)) == 0;
+}
+
+static void
+esp_sa_cache_clear(void)
+{
+  if (esp_sa_cache) {
+    g_hash_table_destroy(esp_sa_cache);
+    esp_sa_cache = NULL;
+  }
+}
+
 /*
    Name : static gint compute_ascii_key(gchar **ascii_key, gchar *key)
    Description : Allocate memory for the key and transform the key if it is hexadecimal
@@ -491,6 +527,7 @@ void esp_sa_record_add_from_dissector(guint8 protocol, const gchar *srcIP, const
       extra_esp_sa_records.records = g_new(uat_esp_sa_record_t, MAX_EXTRA_SA_RECORDS);
    }
    /* Add new entry */
+   esp_sa_cache_clear();
    if (extra_esp_sa_records.num_records < MAX_EXTRA_SA_RECORDS) {
       record = &extra_esp_sa_records.records[extra_esp_sa_records.num_records++];
    }
@@ -1078,7 +1115,53 @@ filter_spi_match(guint spi, gchar *filter)
 
 
 /*
-   Name : static goolean get_esp_sa(g_esp_sa_database *sad, gint protocol_typ, gchar *src,  gchar *dst,  guint spi,
+   Name : static uat_esp_sa_record_t *find_esp_sa(gint protocol_typ, gchar *src,  gchar *dst,  guint spi)
+
+   Description : Search the Security Association database for the first SA matching a packet
+   Return: The record of the SA, or NULL if there is no SA with valid keys for the packet.
+   Params:
+      - gint protocol_typ : the protocol type
+      - gchar *src : the source address
+      - gchar *dst : the destination address
+      - guint spi : the spi of the SA
+*/
+static uat_esp_sa_record_t *
+find_esp_sa(gint protocol_typ, gchar *src,  gchar *dst,  guint spi)
+{
+  guint i, j;
+
+  /* Check each known SA in turn */
+  for (i = 0, j=0; (i < num_sa_uat) || (j < extra_esp_sa_records.num_records); )
+  {
+    /* Get the next record to try */
+    uat_esp_sa_record_t *record;
+    if (j < extra_esp_sa_records.num_records) {
+      /* Extra ones checked first */
+      record = &extra_esp_sa_records.records[j++];
+    }
+    else {
+      /* Then UAT ones */
+      record = &uat_esp_sa_records[i++];
+    }
+
+    if((protocol_typ == record->protocol)
+       && filter_address_match(src, record->srcIP, protocol_typ)
+       && filter_address_match(dst, record->dstIP, protocol_typ)
+       && filter_spi_match(spi, record->spi))
+    {
+      /* Bad keys; XXX - report this */
+      if ((record->authentication_key_length == -1) || (record->encryption_key_length == -1))
+        continue;
+
+      return record;
+    }
+  }
+
+  return NULL;
+}
+
+/*
+   Name : static goolean get_esp_sa(gint protocol_typ, const address *src, const address *dst, guint spi,
            gint *encryption_algo,
            gint *authentication_algo,
            gchar **encryption_key,
@@ -1091,11 +1174,10 @@ filter_spi_match(guint spi, gchar *filter)
    Description : Give Encryption Algo, Key and Authentication Algo for a Packet if a corresponding SA is available in a Security Association database
    Return: If the SA is not present, FALSE is then returned.
    Params:
-      - g_esp_sa_database *sad : the Security Association Database
-      - gint *pt_protocol_typ : the protocol type
-      - gchar *src : the source address
-      - gchar *dst : the destination address
-      - gchar *spi : the spi of the SA
+      - gint protocol_typ : the protocol type
+      - const address *src : the source address
+      - const address *dst : the destination address
+      - guint spi : the spi of the SA
       - gint *encryption_algo : the Encryption Algorithm to apply the packet
       - gint *authentication_algo : the Authentication Algorithm to apply to the packet
       - gchar **encryption_key : the Encryption Key to apply to the packet
@@ -1109,7 +1191,7 @@ filter_spi_match(guint spi, gchar *filter)
 
 */
 static gboolean
-get_esp_sa(gint protocol_typ, gchar *src,  gchar *dst,  guint spi,
+get_esp_sa(gint protocol_typ, const address *src, const address *dst, guint spi,
            gint *encryption_algo,
            gint *authentication_algo,
            gchar **encryption_key,
@@ -1120,66 +1202,59 @@ get_esp_sa(gint protocol_typ, gchar *src,  gchar *dst,  guint spi,
            gboolean **cipher_hd_created
   )
 {
-  gboolean found = FALSE;
-  guint i, j;
+  esp_sa_cache_key_t key;
+  esp_sa_cache_key_t *new_key;
+  gpointer value;
+  uat_esp_sa_record_t *record;
 
   *cipher_hd = NULL;
   *cipher_hd_created = NULL;
 
-  /* Check each known SA in turn */
-  for (i = 0, j=0; (found == FALSE) && ((i < num_sa_uat) || (j < extra_esp_sa_records.num_records)); )
-  {
-    /* Get the next record to try */
-    uat_esp_sa_record_t *record;
-    if (j < extra_esp_sa_records.num_records) {
-      /* Extra ones checked first */
-      record = &extra_esp_sa_records.records[j++];
-    }
-    else {
-      /* Then UAT ones */
-      record = &uat_esp_sa_records[i++];
-    }
+  uat_ensure_loaded(esp_uat);
 
-    if((protocol_typ == record->protocol)
-       && filter_address_match(src, record->srcIP, protocol_typ)
-       && filter_address_match(dst, record->dstIP, protocol_typ)
-       && filter_spi_match(spi, record->spi))
-    {
-      found = TRUE;
+  if ((src->len > (int)sizeof(key.src)) || (dst->len > (int)sizeof(key.dst))) {
+    return FALSE;
+  }
 
-      *encryption_algo = record->encryption_algo;
-      *authentication_algo = record->authentication_algo;
-      *authentication_key = record->authentication_key;
-      if (record->authentication_key_length == -1)
-      {
-        /* Bad key; XXX - report this */
-        *authentication_key_len = 0;
-        found = FALSE;
-      }
-      else {
-        *authentication_key_len = record->authentication_key_length;
-      }
+  memset(&key, 0, sizeof(key));
+  key.protocol_typ = protocol_typ;
+  key.spi = spi;
+  memcpy(key.src, src->data, src->len);
+  memcpy(key.dst, dst->data, dst->len);
 
-      *encryption_key = record->encryption_key;
-      if (record->encryption_key_length == -1)
-      {
-        /* Bad key; XXX - report this */
-        *encryption_key_len = 0;
-        found = FALSE;
-      }
-      else {
-        *encryption_key_len = record->encryption_key_length;
-      }
+  if (esp_sa_cache == NULL) {
+    esp_sa_cache = g_hash_table_new_full(esp_sa_cache_hash, esp_sa_cache_equal, g_free, NULL);
+  }
 
-      /* Tell the caller whether cipher_hd has been created yet and a pointer.
-         Pass pointer to created flag so that caller can set if/when
-         it opens the cipher_hd. */
-      *cipher_hd = &record->cipher_hd;
-      *cipher_hd_created = &record->cipher_hd_created;
-    }
+  if (g_hash_table_lookup_extended(esp_sa_cache, &key, NULL, &value)) {
+    record = (uat_esp_sa_record_t *)value;
+  } else {
+    record = find_esp_sa(protocol_typ,
+                         address_to_str(wmem_packet_scope(), src),
+                         address_to_str(wmem_packet_scope(), dst), spi);
+    new_key = g_new(esp_sa_cache_key_t, 1);
+    *new_key = key;
+    g_hash_table_insert(esp_sa_cache, new_key, record);
+  }
+
+  if (record == NULL) {
+    return FALSE;
   }
 
-  return found;
+  *encryption_algo = record->encryption_algo;
+  *authentication_algo = record->authentication_algo;
+  *authentication_key = record->authentication_key;
+  *authentication_key_len = record->authentication_key_length;
+  *encryption_key = record->encryption_key;
+  *encryption_key_len = record->encryption_key_length;
+
+  /* Tell the caller whether cipher_hd has been created yet and a pointer.
+     Pass pointer to created flag so that caller can set if/when
+     it opens the cipher_hd. */
+  *cipher_hd = &record->cipher_hd;
+  *cipher_hd_created = &record->cipher_hd_created;
+
+  return TRUE;
 }
 
 static void ah_prompt(packet_info *pinfo, gchar *result)
@@ -1395,8 +1470,6 @@ dissect_esp(tvbuff_t *tvb, packet_info *pinfo, proto_tree *tree, void* data _U_)
   proto_item *iv_item = NULL, *encr_data_item = NULL, *icv_item = NULL;
 
   /* Packet Variables related */
-  gchar *ip_src = NULL;
-  gchar *ip_dst = NULL;
 
   guint32 spi = 0;
   guint encapsulated_protocol = 0;
@@ -1507,10 +1580,6 @@ dissect_esp(tvbuff_t *tvb, packet_info *pinfo, proto_tree *tree, void* data _U_)
       protocol_typ = IPSEC_SA_IPV6;
     }
 
-    /* Create strings for src, dst addresses */
-    ip_src = address_to_str(wmem_packet_scope(), &pinfo->src);
-    ip_dst = address_to_str(wmem_packet_scope(), &pinfo->dst);
-
     /* Get the SPI */
     if (tvb_captured_length(tvb) >= 4)
     {
@@ -1519,11 +1588,11 @@ dissect_esp(tvbuff_t *tvb, packet_info *pinfo, proto_tree *tree, void* data _U_)
 
 
     /*
-      PARSE the SAD and fill it. It may take some time since it will
-      be called every times an ESP Payload is found.
+      PARSE the SAD and fill it. The result is cached, so the SAD is only
+      searched once for each combination of addresses and SPI.
     */
 
-    if((sad_is_present = get_esp_sa(protocol_typ, ip_src, ip_dst, spi,
+    if((sad_is_present = get_esp_sa(protocol_typ, &pinfo->src, &pinfo->dst, spi,
                                     &esp_encr_algo, &esp_auth_algo,
                                     &esp_encr_key, &esp_encr_key_len, &esp_auth_key, &esp_auth_key_len,
                                     &cipher_hd, &cipher_hd_created)))
@@ -2394,6 +2463,8 @@ dissect_ipcomp(tvbuff_t *tvb, packet_info *pinfo, proto_tree *tree, void* dissec
 
 static void ipsec_cleanup_protocol(void)
 {
+  esp_sa_cache_clear();
+
   /* Free any SA records added by other dissectors */
   guint n;
   for (n=0; n < extra_esp_sa_records.num_records; n++) {
@@ -2578,13 +2649,13 @@ proto_register_ipsec(void)
             TRUE,                           /* from_profile */
             &uat_esp_sa_records,            /* data_ptr */
             &num_sa_uat,                    /* numitems_ptr */
-            UAT_AFFECTS_DISSECTION,         /* affects dissection of packets, but not set of named fields */
+            UAT_AFFECTS_DISSECTION|UAT_LOAD_ON_DEMAND, /* affects dissection of packets, but not set of named fields */
             NULL,                           /* help */
             uat_esp_sa_record_copy_cb,      /* copy callback */
             uat_esp_sa_record_update_cb,    /* update callback */
             uat_esp_sa_record_free_cb,      /* free callback */
-            NULL,                           /* post update callback */
-            NULL,                           /* reset callback */
+            esp_sa_cache_clear,             /* post update callback */
+            esp_sa_cache_clear,             /* reset callback */
             esp_uat_flds);                  /* UAT field definitions */
 
   prefs_register_uat_preference(esp_module,
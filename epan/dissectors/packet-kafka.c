@@ -1888,6 +1888,116 @@ decompress(tvbuff_t *tvb, packet_info *pinfo, int offset, guint32 length, int co
     }
 }
 
+/*
+ * Decompressed record batches, keyed by frame, batch base offset and
+ * batch CRC, so that revisiting a frame (e.g. clicking around in the GUI)
+ * does not decompress the same batch over and over again. The store is
+ * bounded; when it grows past the limit it is simply emptied.
+ */
+#define KAFKA_BATCH_CACHE_MAX_BYTES (64 << 20)
+
+typedef struct _kafka_batch_cache_key_t {
+    guint32 frame;
+    guint32 crc;
+    guint64 base_offset;
+} kafka_batch_cache_key_t;
+
+typedef struct _kafka_batch_cache_value_t {
+    guint8  *data;
+    guint32  length;
+} kafka_batch_cache_value_t;
+
+static GHashTable *kafka_batch_cache = NULL;
+static gsize kafka_batch_cache_bytes = 0;
+
+static guint
+kafka_batch_cache_hash(gconstpointer k)
+{
+    const kafka_batch_cache_key_t *key = (const kafka_batch_cache_key_t *)k;
+
+    return key->frame ^ key->crc ^ (guint)key->base_offset;
+}
+
+static gboolean
+kafka_batch_cache_equal(gconstpointer k1, gconstpointer k2)
+{
+    const kafka_batch_cache_key_t *key1 = (const kafka_batch_cache_key_t *)k1;
+    const kafka_batch_cache_key_t *key2 = (const kafka_batch_cache_key_t *)k2;
+
+    return key1->frame == key2->frame && key1->crc == key2->crc && key1->base_offset == key2->base_offset;
+}
+
+static void
+kafka_batch_cache_free_value(gpointer v)
+{
+    kafka_batch_cache_value_t *value = (kafka_batch_cache_value_t *)v;
+
+    g_free(value->data);
+    g_free(value);
+}
+
+static void
+kafka_batch_cache_clear(void)
+{
+    if (kafka_batch_cache) {
+        g_hash_table_remove_all(kafka_batch_cache);
+    }
+    kafka_batch_cache_bytes = 0;
+}
+
+/*
+ * Same contract as decompress(), but looks up and stores the result in
+ * the batch cache. The returned buffer always belongs to the packet scope,
+ * so it stays valid even if the cache is emptied while the packet is
+ * still being dissected.
+ */
+static gboolean
+decompress_batch(tvbuff_t *tvb, packet_info *pinfo, int offset, guint32 length, int codec,
+                 guint64 base_offset, guint32 crc,
+                 tvbuff_t **decompressed_tvb, int *decompressed_offset)
+{
+    kafka_batch_cache_key_t key;
+    kafka_batch_cache_value_t *value;
+    guint8 *data;
+    guint32 decompressed_length;
+
+    if (codec == KAFKA_MESSAGE_CODEC_NONE) {
+        return decompress(tvb, pinfo, offset, length, codec, decompressed_tvb, decompressed_offset);
+    }
+
+    key.frame = pinfo->num;
+    key.crc = crc;
+    key.base_offset = base_offset;
+
+    value = (kafka_batch_cache_value_t *)g_hash_table_lookup(kafka_batch_cache, &key);
+    if (value) {
+        data = (guint8 *)wmem_memdup(pinfo->pool, value->data, value->length);
+        *decompressed_tvb = tvb_new_child_real_data(tvb, data, value->length, value->length);
+        *decompressed_offset = 0;
+        return TRUE;
+    }
+
+    if (!decompress(tvb, pinfo, offset, length, codec, decompressed_tvb, decompressed_offset)) {
+        return FALSE;
+    }
+
+    decompressed_length = tvb_captured_length_remaining(*decompressed_tvb, *decompressed_offset);
+    if (decompressed_length > KAFKA_BATCH_CACHE_MAX_BYTES) {
+        return TRUE;
+    }
+    if (kafka_batch_cache_bytes + decompressed_length > KAFKA_BATCH_CACHE_MAX_BYTES) {
+        kafka_batch_cache_clear();
+    }
+
+    value = g_new(kafka_batch_cache_value_t, 1);
+    value->data = (guint8 *)tvb_memdup(NULL, *decompressed_tvb, *decompressed_offset, decompressed_length);
+    value->length = decompressed_length;
+    g_hash_table_insert(kafka_batch_cache, g_memdup2(&key, sizeof(key)), value);
+    kafka_batch_cache_bytes += decompressed_length;
+
+    return TRUE;
+}
+
 /*
  * Function: dissect_kafka_message_old
  * ---------------------------------------------------
@@ -2008,7 +2118,7 @@ dissect_kafka_message_new(tvbuff_t *tvb, packet_info *pinfo, proto_tree *tree, i
     gint8       magic_byte;
     guint16     codec;
     guint32     message_size;
-    guint32     count, i, length;
+    guint32     count, i, length, crc;
     guint64     base_offset, first_timestamp;
 
     tvbuff_t    *decompressed_tvb;
@@ -2033,7 +2143,7 @@ dissect_kafka_message_new(tvbuff_t *tvb, packet_info *pinfo, proto_tree *tree, i
         return start_offset + 8 /*base offset*/ + 4 /*message size*/ + message_size;
     }
 
-    offset = dissect_kafka_int32(subtree, hf_kafka_batch_crc, tvb, pinfo, offset, NULL);
+    offset = dissect_kafka_int32(subtree, hf_kafka_batch_crc, tvb, pinfo, offset, &crc);
 
     dissect_kafka_int16(subtree, hf_kafka_batch_codec, tvb, pinfo, offset, &codec);
     codec &= KAFKA_MESSAGE_CODEC_MASK;
@@ -2057,7 +2167,7 @@ dissect_kafka_message_new(tvbuff_t *tvb, packet_info *pinfo, proto_tree *tree, i
 
     length = start_offset + 8 /*base offset*/ + 4 /*message size*/ + message_size - offset;
 
-    if (decompress(tvb, pinfo, offset, length, codec, &decompressed_tvb, &decompressed_offset)==1) {
+    if (decompress_batch(tvb, pinfo, offset, length, codec, base_offset, crc, &decompressed_tvb, &decompressed_offset)==1) {
         if (codec != 0) {
             add_new_data_source(pinfo, decompressed_tvb, "Decompressed Records");
             show_compression_reduction(tvb, subtree, length, tvb_captured_length(decompressed_tvb));
@@ -10287,6 +10397,9 @@ proto_register_kafka(void)
 
     proto_kafka = protocol_handle;
 
+    kafka_batch_cache = g_hash_table_new_full(kafka_batch_cache_hash, kafka_batch_cache_equal, g_free, kafka_batch_cache_free_value);
+    register_cleanup_routine(kafka_batch_cache_clear);
+
 }
 
 void
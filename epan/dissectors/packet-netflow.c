@@ -325,6 +325,7 @@ typedef struct _v9_v10_tmplt {
     guint    length;
     guint16  field_count[TF_NUM];                /* 0:scopes; 1:entries  */
     v9_v10_tmplt_entry_t *fields_p[TF_NUM_EXT];  /* 0:scopes; 1:entries; n:vendor_entries  */
+    gboolean need_records;                       /* Records must be dissected even without a tree */
 } v9_v10_tmplt_t;
 
 
@@ -4904,6 +4905,18 @@ dissect_v9_v10_data(tvbuff_t *tvb, packet_info *pinfo, proto_tree *pdutree, int
         }
         proto_item_set_generated(ti);
 
+        /* Without a tree, records with only fixed length, standard fields */
+        /* have nothing to show, so just count them.                       */
+        if ((pdutree == NULL) && !tmplt_p->need_records) {
+            guint records = length / tmplt_p->length;
+
+            tvb_ensure_bytes_exist(tvb, offset, records * tmplt_p->length);
+            count       += records;
+            *flows_seen += records;
+            offset      += records * tmplt_p->length;
+            length      -= records * tmplt_p->length;
+        }
+
         /* Note: If the flow contains variable length fields then          */
         /*       tmplt_p->length will be less then actual length of the flow. */
         while (length >= tmplt_p->length) {
@@ -12517,6 +12530,12 @@ dissect_v9_v10_template_fields(tvbuff_t *tvb, packet_info *pinfo _U_, proto_tree
             if (length != VARIABLE_LENGTH) { /* Don't include "variable length" in the total */
                 tmplt_p->length    += length;
             }
+            /* Variable length and enterprise fields, subtemplate lists and  */
+            /* data link frame sections can't be skipped in records.         */
+            if ((length == VARIABLE_LENGTH) || (type & 0x8000) ||
+                (type == 292) || (type == 315)) {
+                tmplt_p->need_records = TRUE;
+            }
         }
 
         field_tree = proto_tree_add_subtree_format(tmplt_tree, tvb, offset, 4+((pen_str!=NULL)?4:0),
@@ -21282,7 +21301,7 @@ proto_register_netflow(void)
 
     prefs_register_bool_preference(netflow_module, "desegment", "Reassemble Netflow v10 messages spanning multiple TCP segments.", "Whether the Netflow/Ipfix dissector should reassemble messages spanning multiple TCP segments.  To use this option, you must also enable \"Allow subdissectors to reassemble TCP streams\" in the TCP protocol settings.", &netflow_preference_desegment);
 
-    v9_v10_tmplt_table = wmem_map_new_autoreset(wmem_epan_scope(), wmem_file_scope(), v9_v10_tmplt_table_hash, v9_v10_tmplt_table_equal);
+    v9_v10_tmplt_table = wmem_map_new_flat_autoreset(wmem_epan_scope(), wmem_file_scope(), v9_v10_tmplt_table_hash, v9_v10_tmplt_table_equal);
 }
 
 static guint
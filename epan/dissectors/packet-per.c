@@ -1912,6 +1912,41 @@ index_get_field_name(const per_sequence_t *sequence, int idx)
 	return "<unknown field>";
 }
 
+/* 18.2 Read the bit-map of which OPTIONAL/DEFAULT components are present.
+ * Without a tree there is nothing to label, so take the bits from the tvb
+ * up to 32 at a time instead of going through dissect_per_boolean() for
+ * every component.
+ */
+static guint32
+dissect_per_optional_field_bits(tvbuff_t *tvb, guint32 offset, asn1_ctx_t *actx, proto_tree *tree, const per_sequence_t *sequence, guint32 num_opts, guint32 *optional_mask)
+{
+	gboolean optional_field_flag;
+	guint32 i;
+
+	memset(optional_mask, 0, (SEQ_MAX_COMPONENTS>>5)*sizeof(guint32));
+	if(!tree){
+		for(i=0;i<num_opts;i+=32){
+			guint32 num_bits=MIN(num_opts-i, 32);
+
+			optional_mask[i>>5]=tvb_get_bits32(tvb, offset, num_bits, ENC_BIG_ENDIAN)<<(32-num_bits);
+			offset+=num_bits;
+		}
+		actx->created_item=NULL;
+		return offset;
+	}
+
+	for(i=0;i<num_opts;i++){
+		offset=dissect_per_boolean(tvb, offset, actx, tree, hf_per_optional_field_bit, &optional_field_flag);
+		proto_item_append_text(actx->created_item, " (%s %s present)",
+			index_get_optional_name(sequence, i), optional_field_flag?"is":"is NOT");
+		if (!display_internal_per_fields) proto_item_set_hidden(actx->created_item);
+		if(optional_field_flag){
+			optional_mask[i>>5]|=0x80000000>>(i&0x1f);
+		}
+	}
+	return offset;
+}
+
 /* this functions decodes a SEQUENCE
    it can only handle SEQUENCES with at most 32 DEFAULT or OPTIONAL fields
 18.1 extension bit
@@ -1927,7 +1962,7 @@ index_get_field_name(const per_sequence_t *sequence, int idx)
 guint32
 dissect_per_sequence(tvbuff_t *tvb, guint32 offset, asn1_ctx_t *actx, proto_tree *parent_tree, int hf_index, gint ett_index, const per_sequence_t *sequence)
 {
-	gboolean /*extension_present,*/ extension_flag, optional_field_flag;
+	gboolean /*extension_present,*/ extension_flag;
 	proto_item *item;
 	proto_tree *tree;
 	guint32 old_offset=offset;
@@ -1964,18 +1999,7 @@ DEBUG_ENTRY("dissect_per_sequence");
 		dissect_per_not_decoded_yet(tree, actx->pinfo, tvb, "too many optional/default components");
 	}
 
-	memset(optional_mask, 0, sizeof(optional_mask));
-	for(i=0;i<num_opts;i++){
-		offset=dissect_per_boolean(tvb, offset, actx, tree, hf_per_optional_field_bit, &optional_field_flag);
-		if (tree) {
-			proto_item_append_text(actx->created_item, " (%s %s present)",
-				index_get_optional_name(sequence, i), optional_field_flag?"is":"is NOT");
-		}
-		if (!display_internal_per_fields) proto_item_set_hidden(actx->created_item);
-		if(optional_field_flag){
-			optional_mask[i>>5]|=0x80000000>>(i&0x1f);
-		}
-	}
+	offset=dissect_per_optional_field_bits(tvb, offset, actx, tree, sequence, num_opts, optional_mask);
 
 
 	/* 18.4 */
@@ -2113,7 +2137,6 @@ DEBUG_ENTRY("dissect_per_sequence");
 guint32
 dissect_per_sequence_eag(tvbuff_t *tvb, guint32 offset, asn1_ctx_t *actx, proto_tree *tree, const per_sequence_t *sequence)
 {
-	gboolean optional_field_flag;
 	guint32 i, j, num_opts;
 	guint32 optional_mask[SEQ_MAX_COMPONENTS>>5];
 
@@ -2129,18 +2152,7 @@ DEBUG_ENTRY("dissect_per_sequence_eag");
 		dissect_per_not_decoded_yet(tree, actx->pinfo, tvb, "too many optional/default components");
 	}
 
-	memset(optional_mask, 0, sizeof(optional_mask));
-	for(i=0;i<num_opts;i++){
-		offset=dissect_per_boolean(tvb, offset, actx, tree, hf_per_optional_field_bit, &optional_field_flag);
-		if (tree) {
-			proto_item_append_text(actx->created_item, " (%s %s present)",
-				index_get_optional_name(sequence, i), optional_field_flag?"is":"is NOT");
-		}
-		if (!display_internal_per_fields) proto_item_set_hidden(actx->created_item);
-		if(optional_field_flag){
-			optional_mask[i>>5]|=0x80000000>>(i&0x1f);
-		}
-	}
+	offset=dissect_per_optional_field_bits(tvb, offset, actx, tree, sequence, num_opts, optional_mask);
 
 	for(i=0,j=0;sequence[i].p_id;i++){
 		if(sequence[i].optional==ASN1_OPTIONAL){
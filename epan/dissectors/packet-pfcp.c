@@ -1209,6 +1209,10 @@ typedef struct _pfcp_hdr {
 GHashTable* pfcp_session_table;
 /* Relation between <seid,ip> -> frame */
 wmem_map_t* pfcp_frame_map;
+/* Relation between frame -> <seid,ip> keys inserted by it */
+static wmem_map_t* pfcp_frame_keys_map;
+/* Relation between session -> frames */
+static wmem_map_t* pfcp_session_frames_map;
 
 
 typedef struct pfcp_info {
@@ -1738,7 +1742,7 @@ pfcp_info_hash(gconstpointer key)
     const pfcp_info_t *k = (const pfcp_info_t *)key;
 
     /* The SEID is likely unique, so just use it. */
-    return g_int_hash(&k->seid);
+    return g_int64_hash(&k->seid);
 }
 
 static gboolean
@@ -1765,29 +1769,57 @@ pfcp_get_frame(address ip, guint64 seid, guint32 *frame) {
     return 0;
 }
 
-static gboolean
-pfcp_frame_equal(void *key _U_, void *value, void *data){
-    guint32 frame = GPOINTER_TO_UINT(data);
+static void
+pfcp_remove_frame_info(guint32 f) {
+    wmem_list_t *keys;
+    wmem_list_frame_t *elem;
+    pfcp_info_t *key;
 
-    return (GPOINTER_TO_UINT(value) == frame);
+    keys = (wmem_list_t *)wmem_map_remove(pfcp_frame_keys_map, GUINT_TO_POINTER(f));
+    if (keys == NULL) {
+        return;
+    }
+    for (elem = wmem_list_head(keys); elem; elem = wmem_list_frame_next(elem)) {
+        key = (pfcp_info_t *)wmem_list_frame_data(elem);
+        /* A later frame may have taken over the <seid,ip> in the meantime */
+        if (GPOINTER_TO_UINT(wmem_map_lookup(pfcp_frame_map, key)) == f) {
+            wmem_map_remove(pfcp_frame_map, key);
+        }
+    }
+    wmem_destroy_list(keys);
 }
 
 static void
-pfcp_remove_frame_info(guint32 f) {
-    /* XXX: This iterates through the entire map and it is slow if done
-     * often. For large files with lots of removals, there are better
-     * alternatives, e.g. marking sessions as expired and then periodically
-     * removing all expired sessions from the map, or using a bijective
-     * map to coordinate removals.
-     */
-    wmem_map_foreach_remove(pfcp_frame_map, pfcp_frame_equal, GUINT_TO_POINTER(f));
-}
+pfcp_remove_session_info(guint32 session) {
+    wmem_list_t *frames;
+    wmem_list_frame_t *elem;
+    guint32 f;
 
+    frames = (wmem_list_t *)wmem_map_lookup(pfcp_session_frames_map, GUINT_TO_POINTER(session));
+    if (frames == NULL) {
+        return;
+    }
+    for (elem = wmem_list_head(frames); elem; elem = wmem_list_frame_next(elem)) {
+        f = GPOINTER_TO_UINT(wmem_list_frame_data(elem));
+        /* Skip frames that have been assigned to another session since */
+        if (GPOINTER_TO_UINT(g_hash_table_lookup(pfcp_session_table, GUINT_TO_POINTER(f))) == session) {
+            pfcp_remove_frame_info(f);
+        }
+    }
+}
 
 static void
 pfcp_add_session(guint32 frame, guint32 session) {
+    wmem_list_t *frames;
+
     g_hash_table_insert(pfcp_session_table, GUINT_TO_POINTER(frame), GUINT_TO_POINTER(session));
 
+    frames = (wmem_list_t *)wmem_map_lookup(pfcp_session_frames_map, GUINT_TO_POINTER(session));
+    if (frames == NULL) {
+        frames = wmem_list_new(wmem_file_scope());
+        wmem_map_insert(pfcp_session_frames_map, GUINT_TO_POINTER(session), frames);
+    }
+    wmem_list_prepend(frames, GUINT_TO_POINTER(frame));
 }
 
 static gboolean
@@ -1824,8 +1856,7 @@ static void
 pfcp_fill_map(wmem_list_t *seid_list, wmem_list_t *ip_list, guint32 frame) {
     wmem_list_frame_t *elem_ip, *elem_seid;
     pfcp_info_t *pfcp_info;
-    gpointer session_p, fr_p;
-    GHashTableIter iter;
+    wmem_list_t *keys;
     guint64 seid;
     guint32 session;
     address *ip;
@@ -1846,17 +1877,17 @@ pfcp_fill_map(wmem_list_t *seid_list, wmem_list_t *ip_list, guint32 frame) {
                 /* We look for its session ID */
                 session = GPOINTER_TO_UINT(g_hash_table_lookup(pfcp_session_table, GUINT_TO_POINTER(frame)));
                 if (session) {
-                    g_hash_table_iter_init(&iter, pfcp_session_table);
-                    while (g_hash_table_iter_next(&iter, &fr_p, &session_p)) {
-                        /* If the msg has the same session ID and it's not the upd req we have to remove its info */
-                        if (GPOINTER_TO_UINT(session_p) == session) {
-                            /* If it's the session we are looking for, we remove all the frame information */
-                            pfcp_remove_frame_info(GPOINTER_TO_UINT(fr_p));
-                        }
-                    }
+                    /* We remove the information of every frame in that session */
+                    pfcp_remove_session_info(session);
                 }
             }
             wmem_map_insert(pfcp_frame_map, pfcp_info, GUINT_TO_POINTER(frame));
+            keys = (wmem_list_t *)wmem_map_lookup(pfcp_frame_keys_map, GUINT_TO_POINTER(frame));
+            if (keys == NULL) {
+                keys = wmem_list_new(wmem_file_scope());
+                wmem_map_insert(pfcp_frame_keys_map, GUINT_TO_POINTER(frame), keys);
+            }
+            wmem_list_prepend(keys, pfcp_info);
             elem_seid = wmem_list_frame_next(elem_seid);
         }
         elem_ip = wmem_list_frame_next(elem_ip);
@@ -9090,7 +9121,12 @@ pfcp_match_response(tvbuff_t * tvb, packet_info * pinfo, proto_tree * tree, gint
         break;
     }
 
-    pcrp = (pfcp_msg_hash_t *)wmem_map_lookup(pfcp_info->matched, &pcr);
+    /* A request or response seen for the first time can't have been
+     * matched yet, so don't walk the entries sharing its sequence number.
+     */
+    if (PINFO_FD_VISITED(pinfo) || (!pcr.req_frame && !pcr.rep_frame)) {
+        pcrp = (pfcp_msg_hash_t *)wmem_map_lookup(pfcp_info->matched, &pcr);
+    }
 
     if (pcrp) {
         pcrp->is_request = pcr.is_request;
@@ -11528,7 +11564,9 @@ pfcp_init(void)
 {
     pfcp_session_count = 1;
     pfcp_session_table = g_hash_table_new(g_direct_hash, g_direct_equal);
-    pfcp_frame_map = wmem_map_new(wmem_file_scope(), pfcp_info_hash, pfcp_info_equal);
+    pfcp_frame_map = wmem_map_new_flat(wmem_file_scope(), pfcp_info_hash, pfcp_info_equal);
+    pfcp_frame_keys_map = wmem_map_new_flat(wmem_file_scope(), g_direct_hash, g_direct_equal);
+    pfcp_session_frames_map = wmem_map_new_flat(wmem_file_scope(), g_direct_hash, g_direct_equal);
 
 }
 
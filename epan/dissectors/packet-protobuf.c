@@ -36,6 +36,7 @@
 #include <epan/uat.h>
 #include <epan/strutil.h>
 #include <epan/proto_data.h>
+#include <epan/dict_cache.h>
 #include <wsutil/filesystem.h>
 #include <wsutil/file_util.h>
 #include <wsutil/json_dumper.h>
@@ -99,6 +100,7 @@ void proto_reg_handoff_protobuf(void);
 #define PREFS_UPDATE_ALL   (PREFS_UPDATE_PROTOBUF_SEARCH_PATHS | PREFS_UPDATE_PROTOBUF_UDP_MESSAGE_TYPES)
 
 static void protobuf_reinit(int target);
+static void flush_and_report_error(void);
 
 static int proto_protobuf = -1;
 static int proto_protobuf_json_mapping = -1;
@@ -155,6 +157,7 @@ static gboolean old_dissect_bytes_as_string = FALSE;
 static gboolean show_details = FALSE;
 static gboolean pbf_as_hf = FALSE; /* dissect protobuf fields as header fields of wireshark */
 static gboolean preload_protos = FALSE;
+static gboolean lazy_load_protos = FALSE;
 /* Show protobuf as JSON similar to https://developers.google.com/protocol-buffers/docs/proto3#json */
 static gboolean display_json_mapping = FALSE;
 static gboolean use_utc_fmt = FALSE;
@@ -1613,6 +1616,11 @@ dissect_protobuf(tvbuff_t *tvb, packet_info *pinfo, proto_tree *tree, void *data
         message_desc = find_message_type_by_udp_port(pinfo);
     }
 
+    if (lazy_load_protos) {
+        /* report errors of the .proto files that were just loaded */
+        flush_and_report_error();
+    }
+
     if (display_json_mapping && message_desc) {
         json_dumper dumper = {
             .output_string = g_string_new(NULL),
@@ -1654,8 +1662,136 @@ dissect_protobuf(tvbuff_t *tvb, packet_info *pinfo, proto_tree *tree, void *data
     return tvb_captured_length(tvb);
 }
 
+/* An index of the top level names defined by each .proto file, so that with the
+   lazy_load_protos preference only the files that are needed are parsed. The entries
+   of unchanged files are reused from the index saved the last time. */
+#define PROTO_INDEX_FILE "protobuf_index"
+#define PROTO_INDEX_MAGIC "WSPBI"
+#define PROTO_INDEX_VERSION 1
+
+typedef struct {
+    guint64 size;
+    guint64 mtime;
+    gchar** names;
+} proto_index_entry_t;
+
+typedef struct {
+    GChecksum* key;
+    GHashTable* saved; /* file path -> proto_index_entry_t, from PROTO_INDEX_FILE */
+    GByteArray* cache; /* entries of the files found this time */
+    guint num_reused;
+    gboolean changed;
+} proto_index_t;
+
+static void
+free_proto_index_entry(gpointer data)
+{
+    proto_index_entry_t* entry = (proto_index_entry_t*) data;
+    g_strfreev(entry->names);
+    g_free(entry);
+}
+
+static void
+proto_index_open(proto_index_t* index)
+{
+    dict_cache_reader_t reader;
+
+    /* entries are checked one by one, the key only covers the format */
+    index->key = g_checksum_new(G_CHECKSUM_SHA256);
+    index->saved = g_hash_table_new_full(g_str_hash, g_str_equal, g_free, free_proto_index_entry);
+    index->cache = dict_cache_new(PROTO_INDEX_MAGIC, PROTO_INDEX_VERSION, index->key);
+    index->num_reused = 0;
+    index->changed = FALSE;
+
+    if (!dict_cache_open(&reader, PROTO_INDEX_FILE, PROTO_INDEX_MAGIC, PROTO_INDEX_VERSION, index->key)) {
+        return;
+    }
+
+    while (!dict_cache_at_end(&reader)) {
+        gchar* path = dict_cache_get_str(&reader);
+        proto_index_entry_t* entry = g_new0(proto_index_entry_t, 1);
+        guint32 i, num_names;
+
+        entry->size = dict_cache_get_u64(&reader);
+        entry->mtime = dict_cache_get_u64(&reader);
+        num_names = dict_cache_get_u32(&reader);
+        if (!reader.ok || !path || num_names > (gsize)(reader.end - reader.ptr)) {
+            g_free(path);
+            free_proto_index_entry(entry);
+            /* ignore the corrupt index */
+            g_hash_table_remove_all(index->saved);
+            break;
+        }
+        entry->names = g_new0(gchar*, num_names + 1);
+        for (i = 0; i < num_names; i++) {
+            entry->names[i] = dict_cache_get_str(&reader);
+            if (!entry->names[i]) {
+                reader.ok = FALSE;
+                break;
+            }
+        }
+        g_hash_table_replace(index->saved, path, entry);
+    }
+    dict_cache_close(&reader);
+}
+
+static void
+proto_index_close(proto_index_t* index)
+{
+    if (index->changed || index->num_reused != g_hash_table_size(index->saved)) {
+        dict_cache_save(PROTO_INDEX_FILE, index->cache);
+    } else {
+        g_byte_array_free(index->cache, TRUE);
+    }
+    g_hash_table_destroy(index->saved);
+    g_checksum_free(index->key);
+}
+
+/* add a .proto file to the pool, to be loaded when one of its names is looked up */
+static gboolean
+defer_proto_file(PbwDescriptorPool* pool, proto_index_t* index, const gchar* path)
+{
+    ws_statb64 st;
+    proto_index_entry_t* entry;
+    gchar** scanned = NULL;
+    const gchar* const* names;
+    guint i;
+    int status;
+
+    if (ws_stat64(path, &st) != 0) {
+        /* let the parser report the error */
+        return pbw_load_proto_file(pool, path) == 0;
+    }
+
+    entry = (proto_index_entry_t*) g_hash_table_lookup(index->saved, path);
+    if (entry && entry->size == (guint64) st.st_size && entry->mtime == (guint64) st.st_mtime) {
+        names = (const gchar* const*) entry->names;
+        index->num_reused++;
+    } else {
+        scanned = pbw_scan_proto_file_names(path);
+        if (!scanned) {
+            return pbw_load_proto_file(pool, path) == 0;
+        }
+        names = (const gchar* const*) scanned;
+        index->changed = TRUE;
+    }
+
+    dict_cache_put_str(index->cache, path);
+    dict_cache_put_u64(index->cache, (guint64) st.st_size);
+    dict_cache_put_u64(index->cache, (guint64) st.st_mtime);
+    dict_cache_put_u32(index->cache, g_strv_length((gchar**) names));
+    for (i = 0; names[i]; i++) {
+        dict_cache_put_str(index->cache, names[i]);
+    }
+
+    status = pbw_defer_proto_file(pool, path, names);
+    g_strfreev(scanned);
+    return status == 0;
+}
+
+/* load all .proto files in dir_path, or add them to the index if index is not NULL */
 static gboolean
-load_all_files_in_dir(PbwDescriptorPool* pool, const gchar* dir_path)
+load_all_files_in_dir(PbwDescriptorPool* pool, const gchar* dir_path, proto_index_t* index)
 {
     WS_DIR        *dir;             /* scanned directory */
     WS_DIRENT     *file;            /* current file */
@@ -1672,13 +1808,13 @@ load_all_files_in_dir(PbwDescriptorPool* pool, const gchar* dir_path)
                 dot = strrchr(name, '.');
                 if (dot && g_ascii_strcasecmp(dot + 1, "proto") == 0) {
                     /* Note: pbw_load_proto_file support absolute or relative (to one of search paths) path */
-                    if (pbw_load_proto_file(pool, path) != 0) {
+                    if (index ? !defer_proto_file(pool, index, path) : pbw_load_proto_file(pool, path) != 0) {
                         g_free(path);
                         ws_dir_close(dir);
                         return FALSE;
                     }
                 } else {
-                    if (!load_all_files_in_dir(pool, path)) {
+                    if (!load_all_files_in_dir(pool, path, index)) {
                         g_free(path);
                         ws_dir_close(dir);
                         return FALSE;
@@ -1944,6 +2080,9 @@ protobuf_reinit(int target)
     const gchar* message_type;
     gboolean loading_completed = TRUE;
     size_t num_proto_paths;
+    proto_index_t index;
+    /* all messages must be loaded to register them as header fields */
+    gboolean lazy = lazy_load_protos && !pbf_as_hf;
 
     if (target & PREFS_UPDATE_PROTOBUF_UDP_MESSAGE_TYPES) {
         /* delete protobuf dissector from old udp ports */
@@ -1992,15 +2131,21 @@ protobuf_reinit(int target)
         pbw_reinit_DescriptorPool(&pbw_pool, (const char **)source_paths, buffer_error);
 
         /* load all .proto files in the marked search paths, we can invoke FindMethodByName etc later. */
+        if (lazy) {
+            proto_index_open(&index);
+        }
         for (i = 0; i < num_proto_paths; ++i) {
             if ((i < 2) || protobuf_search_paths[i - 2].load_all) {
-                if (!load_all_files_in_dir(pbw_pool, source_paths[i])) {
+                if (!load_all_files_in_dir(pbw_pool, source_paths[i], lazy ? &index : NULL)) {
                     buffer_error("Protobuf: Loading .proto files action stopped!\n");
                     loading_completed = FALSE;
                     break; /* stop loading when error occurs */
                 }
             }
         }
+        if (lazy) {
+            proto_index_close(&index);
+        }
 
         g_free(source_paths[0]);
         g_free(source_paths[1]);
@@ -2203,6 +2348,15 @@ proto_register_protobuf(void)
         " when the Protobuf dissector is called for the first time.",
         &preload_protos);
 
+    prefs_register_bool_preference(protobuf_module, "lazy_load_protos",
+        "Load .proto files only when needed.",
+        "Only index the names of the messages, enums and services defined by the .proto files"
+        " of the search paths, and parse a file when one of them is needed for the first time."
+        " The index is saved in the personal configuration directory so that unchanged files"
+        " are not read again. This has no effect if the Protobuf fields are dissected as"
+        " Wireshark fields, which needs all the messages to be loaded.",
+        &lazy_load_protos);
+
     protobuf_search_paths_uat = uat_new("Protobuf Search Paths",
         sizeof(protobuf_search_path_t),
         "protobuf_search_paths",
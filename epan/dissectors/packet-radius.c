@@ -2583,7 +2583,7 @@ radius_shutdown(void)
 }
 
 static void
-_radius_load_dictionary(gchar* dir)
+_radius_load_dictionary(gchar* dir, const gchar* cache_name)
 {
 	gchar *dict_err_str = NULL;
 
@@ -2591,7 +2591,7 @@ _radius_load_dictionary(gchar* dir)
 		return;
 	}
 
-	radius_load_dictionary(dict, dir, "dictionary", &dict_err_str);
+	radius_load_dictionary(dict, dir, "dictionary", cache_name, &dict_err_str);
 
 	if (dict_err_str) {
 		report_failure("radius: %s", dict_err_str);
@@ -2808,10 +2808,10 @@ register_radius_fields(const char *unused _U_)
 
 
 	dir = get_datafile_path("radius");
-	_radius_load_dictionary(dir);
+	_radius_load_dictionary(dir, "radius_dict_cache");
 	g_free(dir);
 	dir = get_persconffile_path("radius", FALSE);
-	_radius_load_dictionary(dir);
+	_radius_load_dictionary(dir, "radius_dict_cache_personal");
 	g_free(dir);
 
 	g_hash_table_foreach(dict->attrs_by_id, register_attrs, &ri);
@@ -160,4 +160,6 @@ void dissect_attribute_value_pairs(proto_tree *tree, packet_info *pinfo, tvbuff_
 extern void free_radius_attr_info(gpointer data);
 
 /* from radius_dict.l */
-gboolean radius_load_dictionary (radius_dictionary_t* dict, gchar* directory, const gchar* filename, gchar** err_str);
+/* cache_name, if not NULL, is the file in the personal configuration directory
+ * used to cache the dictionary */
+gboolean radius_load_dictionary (radius_dictionary_t* dict, gchar* directory, const gchar* filename, const gchar* cache_name, gchar** err_str);
@@ -1297,6 +1297,7 @@ static sip_info_value_t *stat_info;
 
 static GHashTable *sip_hash = NULL;           /* Hash table */
 static GHashTable *sip_headers_hash = NULL;     /* Hash table */
+static guint sip_compact_headers[128];          /* Compact name letter to POS_x */
 
 /* Types for hash table keys and values */
 #define MAX_CALL_ID_SIZE 128
@@ -1380,6 +1381,19 @@ sip_init_protocol(void)
         ascii_strdown_inplace(value_copy);
         g_hash_table_insert(sip_headers_hash, (gpointer)value_copy, GINT_TO_POINTER(i));
     }
+
+    /* Compact names are single letters, index them directly */
+    memset(sip_compact_headers, 0, sizeof(sip_compact_headers));
+    for (i = 1; i < array_length(sip_headers); i++){
+        const char *compact_name = sip_headers[i].compact_name;
+        guchar c;
+
+        if (compact_name == NULL || compact_name[0] == '\0' || compact_name[1] != '\0')
+            continue;
+        c = g_ascii_tolower(compact_name[0]);
+        if (c < array_length(sip_compact_headers) && sip_compact_headers[c] == 0)
+            sip_compact_headers[c] = i;
+    }
 }
 
 static void
@@ -5252,10 +5266,9 @@ static gint sip_is_known_sip_header(gchar *header_name, guint header_len)
     }
 
     /* Look for compact name match */
-    for (pos = 1; pos < array_length(sip_headers); pos++) {
-        if (sip_headers[pos].compact_name != NULL &&
-                header_len == strlen(sip_headers[pos].compact_name) &&
-                g_ascii_strncasecmp(header_name, sip_headers[pos].compact_name, header_len) == 0)
+    if (header_len == 1 && (guchar)header_name[0] < array_length(sip_compact_headers)) {
+        pos = sip_compact_headers[(guchar)header_name[0]];
+        if (pos != 0)
             return pos;
     }
 
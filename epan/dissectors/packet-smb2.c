@@ -1505,22 +1505,6 @@ smb2_fid_info_hash(gconstpointer k)
 	return hash;
 }
 
-/* Callback for destroying the glib hash tables associated with a conversation
- * struct. */
-static gboolean
-smb2_conv_destroy(wmem_allocator_t *allocator _U_, wmem_cb_event_t event _U_,
-	          void *user_data)
-{
-	smb2_conv_info_t *conv = (smb2_conv_info_t *)user_data;
-
-	g_hash_table_destroy(conv->matched);
-	g_hash_table_destroy(conv->unmatched);
-
-	/* This conversation is gone, return FALSE to indicate we don't
-	 * want to be called again for this conversation. */
-	return FALSE;
-}
-
 static smb2_sesid_info_t *
 smb2_get_session(smb2_conv_info_t *conv _U_, guint64 id, packet_info *pinfo, smb2_info_t *si)
 {
@@ -1533,6 +1517,7 @@ smb2_get_session(smb2_conv_info_t *conv _U_, guint64 id, packet_info *pinfo, smb
 		ses->auth_frame = (guint32)-1;
 		ses->tids = wmem_map_new(wmem_file_scope(), smb2_tid_info_hash, smb2_tid_info_equal);
 		ses->fids = wmem_map_new(wmem_file_scope(), smb2_fid_info_hash, smb2_fid_info_equal);
+		ses->closed_fids = wmem_map_new(wmem_file_scope(), smb2_fid_info_hash, smb2_fid_info_equal);
 		ses->files = wmem_map_new(wmem_file_scope(), smb2_eo_files_hash, smb2_eo_files_equal);
 
 		seskey_find_sid_key(id, ses->session_key,
@@ -2447,10 +2432,11 @@ dissect_smb2_fid(tvbuff_t *tvb, packet_info *pinfo, proto_tree *tree, int offset
 		break;
 	case FID_MODE_CLOSE:
 		if (!pinfo->fd->visited) {
-			smb2_fid_info_t *fid = (smb2_fid_info_t *)wmem_map_lookup(si->session->fids, &sfi_key);
+			smb2_fid_info_t *fid = (smb2_fid_info_t *)wmem_map_remove(si->session->fids, &sfi_key);
 			if (fid) {
 				/* set last frame */
 				fid->frame_end = pinfo->num;
+				wmem_map_insert(si->session->closed_fids, fid, fid);
 			}
 		}
 		offset = dissect_nt_guid_hnd(tvb, offset, pinfo, tree, &di, drep, hf_smb2_fid, &policy_hnd, &hnd_item, FALSE, TRUE);
@@ -2463,6 +2449,9 @@ dissect_smb2_fid(tvbuff_t *tvb, packet_info *pinfo, proto_tree *tree, int offset
 	}
 
 	si->file = (smb2_fid_info_t *)wmem_map_lookup(si->session->fids, &sfi_key);
+	if (!si->file) {
+		si->file = (smb2_fid_info_t *)wmem_map_lookup(si->session->closed_fids, &sfi_key);
+	}
 	if (si->file) {
 		if (si->saved) {
 			si->saved->file = si->file;
@@ -10941,20 +10930,12 @@ dissect_smb2(tvbuff_t *tvb, packet_info *pinfo, proto_tree *parent_tree, gboolea
 		 * create it.
 		 */
 		si->conv = wmem_new0(wmem_file_scope(), smb2_conv_info_t);
-		/* qqq this leaks memory for now since we never free
-		   the hashtables */
-		si->conv->matched = g_hash_table_new(smb2_saved_info_hash_matched,
-			smb2_saved_info_equal_matched);
-		si->conv->unmatched = g_hash_table_new(smb2_saved_info_hash_unmatched,
-			smb2_saved_info_equal_unmatched);
+		si->conv->matched = wmem_map_new_flat(wmem_file_scope(),
+			smb2_saved_info_hash_matched, smb2_saved_info_equal_matched);
+		si->conv->unmatched = wmem_map_new_flat(wmem_file_scope(),
+			smb2_saved_info_hash_unmatched, smb2_saved_info_equal_unmatched);
 		si->conv->preauth_hash_current = si->conv->preauth_hash_con;
 
-		/* Bit of a hack to avoid leaking the hash tables - register a
-		 * callback to free them. Ideally wmem would implement a simple
-		 * hash table so we wouldn't have to do this. */
-		wmem_register_callback(wmem_file_scope(), smb2_conv_destroy,
-				si->conv);
-
 		conversation_add_proto_data(conversation, proto_smb2, si->conv);
 	}
 
@@ -11076,7 +11057,7 @@ dissect_smb2(tvbuff_t *tvb, packet_info *pinfo, proto_tree *parent_tree, gboolea
 
 		if (!pinfo->fd->visited) {
 			/* see if we can find this msg_id in the unmatched table */
-			ssi = (smb2_saved_info_t *)g_hash_table_lookup(si->conv->unmatched, &ssi_key);
+			ssi = (smb2_saved_info_t *)wmem_map_lookup(si->conv->unmatched, &ssi_key);
 
 			if (!(si->flags & SMB2_FLAGS_RESPONSE)) {
 				/* This is a request */
@@ -11085,7 +11066,7 @@ dissect_smb2(tvbuff_t *tvb, packet_info *pinfo, proto_tree *parent_tree, gboolea
 					* an older ssi so just delete the previous
 					* one
 					*/
-					g_hash_table_remove(si->conv->unmatched, ssi);
+					wmem_map_remove(si->conv->unmatched, ssi);
 					ssi = NULL;
 				}
 
@@ -11098,7 +11079,7 @@ dissect_smb2(tvbuff_t *tvb, packet_info *pinfo, proto_tree *parent_tree, gboolea
 					ssi->frame_req       = pinfo->num;
 					ssi->req_time        = pinfo->abs_ts;
 					ssi->extra_info_type = SMB2_EI_NONE;
-					g_hash_table_insert(si->conv->unmatched, ssi, ssi);
+					wmem_map_insert(si->conv->unmatched, ssi, ssi);
 				}
 			} else {
 				/* This is a response */
@@ -11107,18 +11088,18 @@ dissect_smb2(tvbuff_t *tvb, packet_info *pinfo, proto_tree *parent_tree, gboolea
 					&& ssi) {
 					/* just  set the response frame and move it to the matched table */
 					ssi->frame_res = pinfo->num;
-					g_hash_table_remove(si->conv->unmatched, ssi);
-					g_hash_table_insert(si->conv->matched, ssi, ssi);
+					wmem_map_remove(si->conv->unmatched, ssi);
+					wmem_map_insert(si->conv->matched, ssi, ssi);
 				}
 			}
 		} else {
 			/* see if we can find this msg_id in the matched table */
-			ssi = (smb2_saved_info_t *)g_hash_table_lookup(si->conv->matched, &ssi_key);
+			ssi = (smb2_saved_info_t *)wmem_map_lookup(si->conv->matched, &ssi_key);
 			/* if we couldn't find it in the matched table, it might still
 			* be in the unmatched table
 			*/
 			if (!ssi) {
-				ssi = (smb2_saved_info_t *)g_hash_table_lookup(si->conv->unmatched, &ssi_key);
+				ssi = (smb2_saved_info_t *)wmem_map_lookup(si->conv->unmatched, &ssi_key);
 			}
 		}
 
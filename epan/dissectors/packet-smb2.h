@@ -58,20 +58,22 @@ typedef enum {
 	SMB2_EI_FILENAME,	/* fid tracking  char * */
 	SMB2_EI_FINDPATTERN	/* find tracking  char * */
 } smb2_extra_info_t;
+/* One of these is kept for every request, so members are ordered by
+ * alignment to avoid padding. */
 typedef struct _smb2_saved_info_t {
-	guint8 smb2_class;
-	guint8 infolevel;
 	guint64 msg_id;
-	guint32 frame_req, frame_res;
 	nstime_t req_time;
 	guint8 *preauth_hash_req, *preauth_hash_res;
 	smb2_fid_info_t *file;
-	e_ctx_hnd policy_hnd; 		/* for eo_smb tracking */
 	smb_eo_t	*eo_info_t;	/* for storing eo_smb infos */
 	guint64		file_offset;	/* needed file_offset for eo_smb */
-	guint32		bytes_moved;	/* needed for eo_smb */
 	void *extra_info;
+	guint32 frame_req, frame_res;
+	e_ctx_hnd policy_hnd; 		/* for eo_smb tracking */
+	guint32		bytes_moved;	/* needed for eo_smb */
 	smb2_extra_info_t extra_info_type;
+	guint8 smb2_class;
+	guint8 infolevel;
 } smb2_saved_info_t;
 
 typedef struct _smb2_tid_info_t {
@@ -100,6 +102,8 @@ typedef struct _smb2_sesid_info_t {
 
 	wmem_map_t *tids;
 	wmem_map_t *fids;
+	/* FIDs that have been closed, kept out of the way of lookups for open ones */
+	wmem_map_t *closed_fids;
 	/* table to store some infos for smb export object */
 	wmem_map_t *files;
 
@@ -111,8 +115,8 @@ typedef struct _smb2_sesid_info_t {
  */
 typedef struct _smb2_conv_info_t {
 	/* these two tables are used to match requests with responses */
-	GHashTable *unmatched;
-	GHashTable *matched;
+	wmem_map_t *unmatched;
+	wmem_map_t *matched;
 	guint16 dialect;
 	guint16 sign_alg;
 	guint16 enc_alg;
@@ -150,6 +150,7 @@ typedef struct {
 
     GString *buf;       /* Incomplete alert output that has been read */
     wtap_dumper *pdh;   /* wiretap dumper used to deliver packets to 'in' */
+    guint unflushed;    /* Frames written to 'in' since it was last flushed */
 
     GIOChannel *channel; /* IO channel used for readimg stdout (alerts) */
 
@@ -159,6 +160,11 @@ typedef struct {
 /* Global instance of the snort session */
 static snort_session_t current_session;
 
+/* Frames are handed to snort in batches of this many, rather than flushing
+   the pipe after each one.  The last batch is flushed when the dumper is
+   closed at the end of the first pass. */
+#define SNORT_FLUSH_FRAMES 64
+
 static int snort_config_ok = TRUE;   /* N.B. Not running test at the moment... */
 
 
@@ -1195,14 +1201,19 @@ snort_dissector(tvbuff_t *tvb, packet_info *pinfo, proto_tree *tree, void *data
                 current_session.working = FALSE;
                 return 0;
             }
-            if (!wtap_dump_flush(current_session.pdh, &write_err)) {
-                /* XXX - report the error somehow? */
-                current_session.working = FALSE;
-                return 0;
-            }
+            if (++current_session.unflushed == SNORT_FLUSH_FRAMES) {
+                current_session.unflushed = 0;
+                if (!wtap_dump_flush(current_session.pdh, &write_err)) {
+                    /* XXX - report the error somehow? */
+                    current_session.working = FALSE;
+                    return 0;
+                }
 
-            /* Give the io channel a chance to deliver alerts.
-               TODO: g_main_context_iteration(NULL, FALSE); causes crashes sometimes when Qt events get to execute.. */
+                /* Collect any alerts snort has written by now, without waiting for more.
+                   This doesn't depend on a main loop running, so it also works in tshark.
+                   TODO: g_main_context_iteration(NULL, FALSE); causes crashes sometimes when Qt events get to execute.. */
+                snort_fast_output(current_session.channel, G_IO_IN, &current_session);
+            }
         }
     }
 
@@ -1398,6 +1409,7 @@ static void snort_cleanup(void)
             g_free(write_err_info);
         }
         current_session.pdh = NULL;
+        current_session.unflushed = 0;
     }
 }
 
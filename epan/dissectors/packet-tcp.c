@@ -728,6 +728,18 @@ static dissector_handle_t tcp_opt_unknown_handle;
 static guint32 tcp_stream_count;
 static guint32 mptcp_stream_count;
 
+/*
+ * First and last frame of each TCP stream, indexed by stream number and
+ * filled in on the first pass, so that retaps for a single stream can
+ * skip the frames outside it.
+ */
+typedef struct {
+    guint32 first_frame;
+    guint32 last_frame;
+} tcp_stream_frames_t;
+
+static wmem_array_t *tcp_stream_frames;
+
 
 
 /*
@@ -1728,6 +1740,9 @@ init_tcp_conversation_data(packet_info *pinfo, int direction)
     tcpd->stream = tcp_stream_count++;
     tcpd->server_port = 0;
 
+    tcp_stream_frames_t frames = { pinfo->num, pinfo->num };
+    wmem_array_append_one(tcp_stream_frames, frames);
+
     return tcpd;
 }
 
@@ -1860,6 +1875,20 @@ guint32 get_mptcp_stream_count(void)
     return mptcp_stream_count;
 }
 
+gboolean get_tcp_stream_frame_range(guint32 stream, guint32 *first_frame, guint32 *last_frame)
+{
+    tcp_stream_frames_t *frames;
+
+    if (tcp_stream_frames == NULL || stream >= wmem_array_get_count(tcp_stream_frames)) {
+        return FALSE;
+    }
+
+    frames = (tcp_stream_frames_t *)wmem_array_index(tcp_stream_frames, stream);
+    *first_frame = frames->first_frame;
+    *last_frame = frames->last_frame;
+    return TRUE;
+}
+
 /* Calculate the timestamps relative to this conversation */
 static void
 tcp_calculate_timestamps(packet_info *pinfo, struct tcp_analysis *tcpd,
@@ -2103,11 +2132,22 @@ tcp_analyze_get_acked_struct(guint32 frame, guint32 seq, guint32 ack, gboolean c
         return;
     }
 
+    /* The analysis asks for the same entry several times per packet,
+     * don't walk the tree again for it. */
+    if (tcpd->ta && tcpd->ta_frame == frame && tcpd->ta_seq == seq && tcpd->ta_ack == ack) {
+        return;
+    }
+
     tcpd->ta = (struct tcp_acked *)wmem_tree_lookup32_array(tcpd->acked_table, key);
     if((!tcpd->ta) && createflag) {
         tcpd->ta = wmem_new0(wmem_file_scope(), struct tcp_acked);
         wmem_tree_insert32_array(tcpd->acked_table, key, (void *)tcpd->ta);
     }
+    if (tcpd->ta) {
+        tcpd->ta_frame = frame;
+        tcpd->ta_seq = seq;
+        tcpd->ta_ack = ack;
+    }
 }
 
 
@@ -7762,6 +7802,13 @@ dissect_tcp(tvbuff_t *tvb, packet_info *pinfo, proto_tree *tree, void* data _U_)
          */
         tcph->th_stream = tcpd->stream;
 
+        if (!pinfo->fd->visited) {
+            tcp_stream_frames_t *frames = (tcp_stream_frames_t *)wmem_array_index(tcp_stream_frames, tcpd->stream);
+            if (pinfo->num > frames->last_frame) {
+                frames->last_frame = pinfo->num;
+            }
+        }
+
         /* initialize the SACK blocks seen to 0 */
         if(tcp_analyze_seq && tcpd->fwd->tcp_analyze_seq_info) {
             tcpd->fwd->tcp_analyze_seq_info->num_sack_ranges = 0;
@@ -8574,6 +8621,7 @@ static void
 tcp_init(void)
 {
     tcp_stream_count = 0;
+    tcp_stream_frames = wmem_array_new(wmem_file_scope(), sizeof(tcp_stream_frames_t));
 
     /* MPTCP init */
     mptcp_stream_count = 0;
@@ -439,6 +439,10 @@ struct tcp_analysis {
 	 * similar
 	 */
 	struct tcp_acked *ta;
+	/* The acked_table key ta was looked up with, valid if ta is set */
+	guint32		ta_frame;
+	guint32		ta_seq;
+	guint32		ta_ack;
 	/* This structure contains a tree containing all the various ta's
 	 * keyed by frame number.
 	 */
@@ -551,6 +555,15 @@ extern void add_tcp_process_info(guint32 frame_num, address *local_addr, address
  */
 WS_DLL_PUBLIC guint32 get_tcp_stream_count(void);
 
+/** Get the first and last frame of a TCP stream, as seen in the first pass
+ *
+ * @param stream The TCP stream index
+ * @param first_frame Set to the first frame of the stream
+ * @param last_frame Set to the last frame of the stream
+ * @return TRUE if the stream exists, FALSE otherwise
+ */
+WS_DLL_PUBLIC gboolean get_tcp_stream_frame_range(guint32 stream, guint32 *first_frame, guint32 *last_frame);
+
 /** Get the current number of MPTCP streams
  *
  * @return The number of MPTCP streams
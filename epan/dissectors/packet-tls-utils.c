@@ -6298,9 +6298,74 @@ typedef struct ssl_master_key_match_group {
     GHashTable *master_key_ht;
 } ssl_master_key_match_group_t;
 
+typedef struct tls_keylog_label {
+    const char *label;          /* Label, including the trailing space */
+    size_t      label_len;
+    GHashTable *master_key_ht;
+    guint       secret_len;     /* Required secret length, or 0 for any */
+} tls_keylog_label_t;
+
+#define TLS_KEYLOG_LABEL(label, ht, secret_len) \
+    { label " ", sizeof(label), ht, secret_len }
+
+/*
+ * Fast path for the "<label> <client_random> <secret>" lines that make
+ * up nearly all of a typical key log, which avoids running the regex and
+ * fetching its named groups for every line.  Only lines that are exactly
+ * in the canonical form are handled; returns FALSE for anything else so
+ * that the caller can fall back to the regex, keeping its semantics for
+ * unusual lines.
+ */
+static gboolean
+tls_keylog_process_line_fast(const tls_keylog_label_t *labels, unsigned num_labels,
+                             const char *line, size_t linelen)
+{
+    const size_t crandom_hex_len = 2 * 32;
+
+    for (unsigned i = 0; i < num_labels; i++) {
+        const tls_keylog_label_t *l = &labels[i];
+        size_t secret_hex_len;
+
+        if (linelen <= l->label_len + crandom_hex_len + 1 ||
+                memcmp(line, l->label, l->label_len) != 0) {
+            continue;
+        }
+        if (line[l->label_len + crandom_hex_len] != ' ') {
+            return FALSE;
+        }
+        secret_hex_len = linelen - (l->label_len + crandom_hex_len + 1);
+        if (l->secret_len && secret_hex_len != 2 * l->secret_len) {
+            return FALSE;
+        }
+
+        StringInfo *key = wmem_new(wmem_file_scope(), StringInfo);
+        StringInfo *secret = wmem_new(wmem_file_scope(), StringInfo);
+        if (!from_hex(key, line + l->label_len, crandom_hex_len) ||
+                !from_hex(secret, line + l->label_len + crandom_hex_len + 1, secret_hex_len)) {
+            return FALSE;
+        }
+        ssl_debug_printf("    matched %.*s\n", (int)(l->label_len - 1), l->label);
+        g_hash_table_insert(l->master_key_ht, key, secret);
+        return TRUE;
+    }
+
+    return FALSE;
+}
+
 void
 tls_keylog_process_lines(const ssl_master_key_map_t *mk_map, const guint8 *data, guint datalen)
 {
+    const tls_keylog_label_t fast_labels[] = {
+        TLS_KEYLOG_LABEL("CLIENT_RANDOM",                   mk_map->crandom, SSL_MASTER_SECRET_LENGTH),
+        TLS_KEYLOG_LABEL("CLIENT_EARLY_TRAFFIC_SECRET",     mk_map->tls13_client_early, 0),
+        TLS_KEYLOG_LABEL("CLIENT_HANDSHAKE_TRAFFIC_SECRET", mk_map->tls13_client_handshake, 0),
+        TLS_KEYLOG_LABEL("SERVER_HANDSHAKE_TRAFFIC_SECRET", mk_map->tls13_server_handshake, 0),
+        TLS_KEYLOG_LABEL("CLIENT_TRAFFIC_SECRET_0",         mk_map->tls13_client_appdata, 0),
+        TLS_KEYLOG_LABEL("SERVER_TRAFFIC_SECRET_0",         mk_map->tls13_server_appdata, 0),
+        TLS_KEYLOG_LABEL("EARLY_EXPORTER_SECRET",           mk_map->tls13_early_exporter, 0),
+        TLS_KEYLOG_LABEL("EXPORTER_SECRET",                 mk_map->tls13_exporter, 0),
+    };
+
     ssl_master_key_match_group_t mk_groups[] = {
         { "encrypted_pmk",  mk_map->pre_master },
         { "session_id",     mk_map->session },
@@ -6376,6 +6441,10 @@ tls_keylog_process_lines(const ssl_master_key_map_t *mk_map, const guint8 *data,
         }
 
         ssl_debug_printf("  checking keylog line: %.*s\n", (int)linelen, line);
+        if (tls_keylog_process_line_fast(fast_labels, G_N_ELEMENTS(fast_labels), line, linelen)) {
+            continue;
+        }
+
         GMatchInfo *mi;
         if (g_regex_match_full(regex, line, linelen, 0, G_REGEX_MATCH_ANCHORED, &mi, NULL)) {
             gchar *hex_key, *hex_pre_ms_or_ms;
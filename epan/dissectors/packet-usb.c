@@ -1754,7 +1754,8 @@ get_usb_conv_info(conversation_t *conversation)
         usb_conv_info->deviceProduct     = DEV_PRODUCT_UNKNOWN;
         usb_conv_info->deviceVersion     = DEV_VERSION_UNKNOWN;
         usb_conv_info->alt_settings      = wmem_array_new(wmem_file_scope(), sizeof(usb_alt_setting_t));
-        usb_conv_info->transactions      = wmem_tree_new(wmem_file_scope());
+        usb_conv_info->transactions      = wmem_map_new_flat(wmem_file_scope(), g_direct_hash, g_direct_equal);
+        usb_conv_info->urb_transactions  = wmem_map_new_flat(wmem_file_scope(), g_int64_hash, g_int64_equal);
         usb_conv_info->descriptor_transfer_type = URB_UNKNOWN;
         usb_conv_info->max_packet_size   = 0;
 
@@ -4363,21 +4364,16 @@ static usb_trans_info_t
     usb_trans_info_t *usb_trans_info;
     proto_item       *ti;
     nstime_t          t, deltat;
-    wmem_tree_key_t   key[3];
 
     /* request/response matching so we can keep track of transaction specific
-     * data.
+     * data.  Each frame carries a single URB, so once a frame has been seen
+     * its transaction is found by frame number; on the first pass, a
+     * response belongs to the latest transaction with the same URB id.
      */
-    key[0].length = 2;
-    key[0].key = (guint32 *)&usb_id;
-    key[1].length = 1;
-    key[1].key = &pinfo->num;
-    key[2].length = 0;
-    key[2].key = NULL;
+    usb_trans_info = (usb_trans_info_t *)wmem_map_lookup(usb_conv_info->transactions, GUINT_TO_POINTER(pinfo->num));
 
     if (usb_conv_info->is_request) {
         /* this is a request */
-        usb_trans_info = (usb_trans_info_t *)wmem_tree_lookup32_array(usb_conv_info->transactions, key);
         if (!usb_trans_info) {
             usb_trans_info              = wmem_new0(wmem_file_scope(), usb_trans_info_t);
             usb_trans_info->request_in  = pinfo->num;
@@ -4385,7 +4381,8 @@ static usb_trans_info_t
             usb_trans_info->header_type = header_type;
             usb_trans_info->usb_id      = usb_id;
 
-            wmem_tree_insert32_array(usb_conv_info->transactions, key, usb_trans_info);
+            wmem_map_insert(usb_conv_info->transactions, GUINT_TO_POINTER(pinfo->num), usb_trans_info);
+            wmem_map_insert(usb_conv_info->urb_transactions, &usb_trans_info->usb_id, usb_trans_info);
         }
 
         if (usb_trans_info->response_in) {
@@ -4395,21 +4392,14 @@ static usb_trans_info_t
 
     } else {
         /* this is a response */
-        if (pinfo->fd->visited) {
-            usb_trans_info = (usb_trans_info_t *)wmem_tree_lookup32_array(usb_conv_info->transactions, key);
-
-        } else {
-            usb_trans_info = (usb_trans_info_t *)wmem_tree_lookup32_array_le(usb_conv_info->transactions, key);
+        if (!pinfo->fd->visited) {
+            usb_trans_info = (usb_trans_info_t *)wmem_map_lookup(usb_conv_info->urb_transactions, &usb_id);
             if (usb_trans_info) {
-                if (usb_trans_info->usb_id == usb_id) {
-                    if (usb_trans_info->response_in == 0) {
-                        /* USBPcap generates 2 frames for response; store the first one */
-                        usb_trans_info->response_in = pinfo->num;
-                    }
-                    wmem_tree_insert32_array(usb_conv_info->transactions, key, usb_trans_info);
-                } else {
-                    usb_trans_info = NULL;
+                if (usb_trans_info->response_in == 0) {
+                    /* USBPcap generates 2 frames for response; store the first one */
+                    usb_trans_info->response_in = pinfo->num;
                 }
+                wmem_map_insert(usb_conv_info->transactions, GUINT_TO_POINTER(pinfo->num), usb_trans_info);
             }
         }
 
@@ -133,7 +133,8 @@ struct _usb_conv_info_t {
     guint32 deviceProduct;      /* Device    Descriptor - USB Product ID - MSBs only for encoding unknown */
     guint16 deviceVersion;      /* Device    Descriptor - USB device version number BCD */
     guint8  iSerialNumber;      /* Device    Descriptor - iSerialNumber (0 if no serial number available) */
-    wmem_tree_t *transactions;
+    wmem_map_t *transactions;       /* frame number -> usb_trans_info_t */
+    wmem_map_t *urb_transactions;   /* URB id -> most recent usb_trans_info_t */
     usb_trans_info_t *usb_trans_info; /* pointer to the current transaction */
 
     void *class_data;           /* private class/id decode data */
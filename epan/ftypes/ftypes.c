@@ -984,14 +984,70 @@ fvalue_get_ipv6(fvalue_t *fv)
 	return fv->ftype->get_value.get_value_ipv6(fv);
 }
 
+/*
+ * Compare two values. Integers and host addresses of the same type are
+ * by far the most common case in filters, so compare those inline
+ * instead of through cmp_order(), which for integers also converts each
+ * operand with another indirect call.
+ */
+#define CMP_VALUES(x, y)	((x) < (y) ? -1 : ((x) > (y) ? 1 : 0))
+
+static inline enum ft_result
+cmp_order(const fvalue_t *a, const fvalue_t *b, int *cmp)
+{
+	if (a->ftype == b->ftype) {
+		switch (a->ftype->ftype) {
+			case FT_CHAR:
+			case FT_UINT8:
+			case FT_UINT16:
+			case FT_UINT24:
+			case FT_UINT32:
+			case FT_FRAMENUM:
+			case FT_IPXNET:
+				*cmp = CMP_VALUES(a->value.uinteger, b->value.uinteger);
+				return FT_OK;
+			case FT_UINT40:
+			case FT_UINT48:
+			case FT_UINT56:
+			case FT_UINT64:
+			case FT_EUI64:
+				*cmp = CMP_VALUES(a->value.uinteger64, b->value.uinteger64);
+				return FT_OK;
+			case FT_INT8:
+			case FT_INT16:
+			case FT_INT24:
+			case FT_INT32:
+				*cmp = CMP_VALUES(a->value.sinteger, b->value.sinteger);
+				return FT_OK;
+			case FT_INT40:
+			case FT_INT48:
+			case FT_INT56:
+			case FT_INT64:
+				*cmp = CMP_VALUES(a->value.sinteger64, b->value.sinteger64);
+				return FT_OK;
+			case FT_IPv4:
+				if (a->value.ipv4.nmask == G_MAXUINT32 &&
+						b->value.ipv4.nmask == G_MAXUINT32) {
+					*cmp = CMP_VALUES(a->value.ipv4.addr, b->value.ipv4.addr);
+					return FT_OK;
+				}
+				break;
+			default:
+				break;
+		}
+	}
+
+	ws_assert(a->ftype->cmp_order);
+	return a->ftype->cmp_order(a, b, cmp);
+}
+
 ft_bool_t
 fvalue_eq(const fvalue_t *a, const fvalue_t *b)
 {
 	int cmp;
 	enum ft_result res;
 
-	ws_assert(a->ftype->cmp_order);
-	res = a->ftype->cmp_order(a, b, &cmp);
+	res = cmp_order(a, b, &cmp);
 	if (res != FT_OK)
 		return -res;
 	return cmp == 0 ? FT_TRUE : FT_FALSE;
@@ -1003,8 +1059,7 @@ fvalue_ne(const fvalue_t *a, const fvalue_t *b)
 	int cmp;
 	enum ft_result res;
 
-	ws_assert(a->ftype->cmp_order);
-	res = a->ftype->cmp_order(a, b, &cmp);
+	res = cmp_order(a, b, &cmp);
 	if (res != FT_OK)
 		return -res;
 	return cmp != 0 ? FT_TRUE : FT_FALSE;
@@ -1016,8 +1071,7 @@ fvalue_gt(const fvalue_t *a, const fvalue_t *b)
 	int cmp;
 	enum ft_result res;
 
-	ws_assert(a->ftype->cmp_order);
-	res = a->ftype->cmp_order(a, b, &cmp);
+	res = cmp_order(a, b, &cmp);
 	if (res != FT_OK)
 		return -res;
 	return cmp > 0 ? FT_TRUE : FT_FALSE;
@@ -1029,8 +1083,7 @@ fvalue_ge(const fvalue_t *a, const fvalue_t *b)
 	int cmp;
 	enum ft_result res;
 
-	ws_assert(a->ftype->cmp_order);
-	res = a->ftype->cmp_order(a, b, &cmp);
+	res = cmp_order(a, b, &cmp);
 	if (res != FT_OK)
 		return -res;
 	return cmp >= 0 ? FT_TRUE : FT_FALSE;
@@ -1042,8 +1095,7 @@ fvalue_lt(const fvalue_t *a, const fvalue_t *b)
 	int cmp;
 	enum ft_result res;
 
-	ws_assert(a->ftype->cmp_order);
-	res = a->ftype->cmp_order(a, b, &cmp);
+	res = cmp_order(a, b, &cmp);
 	if (res != FT_OK)
 		return -res;
 	return cmp < 0 ? FT_TRUE : FT_FALSE;
@@ -1055,8 +1107,7 @@ fvalue_le(const fvalue_t *a, const fvalue_t *b)
 	int cmp;
 	enum ft_result res;
 
-	ws_assert(a->ftype->cmp_order);
-	res = a->ftype->cmp_order(a, b, &cmp);
+	res = cmp_order(a, b, &cmp);
 	if (res != FT_OK)
 		return -res;
 	return cmp <= 0 ? FT_TRUE : FT_FALSE;
@@ -1189,6 +1240,54 @@ fvalue_equal(const fvalue_t *a, const fvalue_t *b)
 	return fvalue_eq(a, b) == FT_TRUE;
 }
 
+gboolean
+fvalue_eq_is_exact(const fvalue_t *fv)
+{
+	switch (fv->ftype->ftype) {
+		case FT_IPv4:
+			return fv->value.ipv4.nmask == G_MAXUINT32;
+		case FT_IPv6:
+			return fv->value.ipv6.prefix == 128;
+		case FT_CHAR:
+		case FT_UINT8:
+		case FT_UINT16:
+		case FT_UINT24:
+		case FT_UINT32:
+		case FT_UINT40:
+		case FT_UINT48:
+		case FT_UINT56:
+		case FT_UINT64:
+		case FT_INT8:
+		case FT_INT16:
+		case FT_INT24:
+		case FT_INT32:
+		case FT_INT40:
+		case FT_INT48:
+		case FT_INT56:
+		case FT_INT64:
+		case FT_FRAMENUM:
+		case FT_EUI64:
+		case FT_STRING:
+		case FT_STRINGZ:
+		case FT_UINT_STRING:
+		case FT_STRINGZPAD:
+		case FT_STRINGZTRUNC:
+		case FT_ETHER:
+		case FT_BYTES:
+		case FT_UINT_BYTES:
+		case FT_AX25:
+		case FT_VINES:
+		case FT_FCWWN:
+		case FT_SYSTEM_ID:
+		case FT_OID:
+		case FT_REL_OID:
+		case FT_GUID:
+			return fv->ftype->hash != NULL;
+		default:
+			return FALSE;
+	}
+}
+
 /*
  * Editor modelines  -  https://www.wireshark.org/tools/modelines.html
  *
@@ -511,6 +511,13 @@ fvalue_hash(const fvalue_t *fv);
 gboolean
 fvalue_equal(const fvalue_t *a, const fvalue_t *b);
 
+/* Returns TRUE if a value of the same type is equal to fv only when it
+ * hashes the same, so that fv can be looked up in a hash table built
+ * with fvalue_hash() and fvalue_equal(). Subnets and floating-point
+ * values are not exact. */
+gboolean
+fvalue_eq_is_exact(const fvalue_t *fv);
+
 #ifdef __cplusplus
 }
 #endif /* __cplusplus */
@@ -159,12 +159,30 @@ static gboolean mmdbr_pipe_valid(void) {
     return pipe_valid;
 }
 
-// Writing to mmdbr_pipe.stdin_fd can block. Do so in a separate thread.
-static gpointer
-write_mmdbr_stdin_worker(gpointer data _U_) {
+// Write a request to mmdbresolve. On failure, queue a fatal error response
+// so that the main thread shuts the child down.
+static gboolean
+write_mmdbr_request(const char *request) {
     GIOStatus status;
     GError *err = NULL;
     gsize bytes_written;
+
+    status = g_io_channel_write_chars(mmdbr_pipe.stdin_io, request, strlen(request), &bytes_written, &err);
+    if (status != G_IO_STATUS_NORMAL) {
+        ws_debug("write error %s", err ? err->message : "(unknown)");
+        g_clear_error(&err);
+        mmdb_response_t *response = g_new0(mmdb_response_t, 1);
+        response->fatal_err = TRUE;
+        g_async_queue_push(mmdbr_response_q, response); // Will be freed by maxmind_db_pop_response.
+        return FALSE;
+    }
+    g_clear_error(&err);
+    return TRUE;
+}
+
+// Writing to mmdbr_pipe.stdin_fd can block. Do so in a separate thread.
+static gpointer
+write_mmdbr_stdin_worker(gpointer data _U_) {
     ws_debug("starting write worker");
 
     while (1) {
@@ -184,17 +202,11 @@ write_mmdbr_stdin_worker(gpointer data _U_) {
         }
 
         ws_noisy("write %s ql %d", request, g_async_queue_length(mmdbr_request_q));
-        status = g_io_channel_write_chars(mmdbr_pipe.stdin_io, request, strlen(request), &bytes_written, &err);
-        if (status != G_IO_STATUS_NORMAL) {
-            ws_debug("write error %s. exiting thread.", err->message);
-            g_clear_error(&err);
+        if (!write_mmdbr_request(request)) {
+            ws_debug("exiting write worker");
             g_free(request);
-            mmdb_response_t *response = g_new0(mmdb_response_t, 1);
-            response->fatal_err = TRUE;
-            g_async_queue_push(mmdbr_response_q, response); // Will be freed by maxmind_db_pop_response.
             return NULL;
         }
-        g_clear_error(&err);
         g_free(request);
     }
     return NULL;
@@ -710,6 +722,29 @@ static void maxmind_db_await_response(void)
     }
 }
 
+/**
+ * Ask mmdbresolve about an address. Main thread only.
+ */
+static void maxmind_db_request(const char *addr_str)
+{
+    char *request = ws_strdup_printf("%s\n", addr_str);
+
+    ws_debug("looking up %s", addr_str);
+    if (resolve_synchronously) {
+        // We're going to block until the answer arrives anyway, and only
+        // one request is ever outstanding so the write can't fill the
+        // pipe. Write it ourselves instead of waking the writer thread,
+        // which saves a thread handoff on every lookup.
+        if (write_mmdbr_request(request)) {
+            ws_noisy("wrote %s", addr_str);
+        }
+        g_free(request);
+        maxmind_db_await_response();
+    } else {
+        g_async_queue_push(mmdbr_request_q, request);
+    }
+}
+
 /**
  * Public API
  */
@@ -742,10 +777,8 @@ maxmind_db_lookup_ipv4(const ws_in4_addr *addr) {
         if (mmdbr_pipe_valid()) {
             char addr_str[WS_INET_ADDRSTRLEN];
             ws_inet_ntop4(addr, addr_str, WS_INET_ADDRSTRLEN);
-            ws_debug("looking up %s", addr_str);
-            g_async_queue_push(mmdbr_request_q, ws_strdup_printf("%s\n", addr_str));
+            maxmind_db_request(addr_str);
             if (resolve_synchronously) {
-                maxmind_db_await_response();
                 result = (mmdb_lookup_t *) wmem_map_lookup(mmdb_ipv4_map, GUINT_TO_POINTER(*addr));
             }
         }
@@ -769,10 +802,8 @@ maxmind_db_lookup_ipv6(const ws_in6_addr *addr) {
         if (mmdbr_pipe_valid()) {
             char addr_str[WS_INET6_ADDRSTRLEN];
             ws_inet_ntop6(addr, addr_str, WS_INET6_ADDRSTRLEN);
-            ws_debug("looking up %s", addr_str);
-            g_async_queue_push(mmdbr_request_q, ws_strdup_printf("%s\n", addr_str));
+            maxmind_db_request(addr_str);
             if (resolve_synchronously) {
-                maxmind_db_await_response();
                 result = (mmdb_lookup_t *) wmem_map_lookup(mmdb_ipv6_map, addr->bytes);
             }
         }
@@ -20,6 +20,7 @@
 
 #include <epan/strutil.h>
 #include <epan/wmem_scopes.h>
+#include "dict_cache.h"
 #include "uat.h"
 #include "prefs.h"
 #include "proto.h"
@@ -533,29 +534,290 @@ static void restart_needed_warning(void) {
 		report_failure("Wireshark needs to be restarted for these changes to take effect");
 }
 
-static void register_mibs(void) {
-	SmiModule *smiModule;
-	SmiNode *smiNode;
+/*
+ * Walking the MIB modules with libsmi takes seconds for large sets of
+ * modules, so the result of the walk is saved to a cache file and
+ * reused as long as neither the MIB path, the list of modules nor any
+ * file in the MIB directories has changed.
+ *
+ * The cache holds one record per node, in the order libsmi returned
+ * them, so that building the OID tree from it gives the same result as
+ * the walk.
+ */
+#define MIB_CACHE_FILE		"mibs_cache"
+#define MIB_CACHE_MAGIC		"WSMIBC"
+#define MIB_CACHE_VERSION	1
+
+/* One node, as read from libsmi or from the cache. */
+typedef struct _mib_node_t {
+	char* name;
+	oid_kind_t kind;
+	const oid_value_type_t* type;
+	oid_key_t* key;
+	guint oid_len;
+	guint32* subids;
+	char* blurb;
+	GArray* enums;		/* value_strings, NULL if there are none */
+} mib_node_t;
+
+/* The value types that can appear in the cache, by index. */
+static const oid_value_type_t* const mib_cache_types[] = {
+	&integer_type, &bytes_type, &oid_type, &ipv4_type, &counter32_type,
+	&unsigned32_type, &timeticks_type, &nsap_type, &counter64_type,
+	&ipv6_type, &float_type, &double_type, &ether_type, &string_type,
+	&date_and_time_type, &unknown_type
+};
+
+static void free_oid_keys(oid_key_t* key) {
+	while (key) {
+		oid_key_t* next = key->next;
+		g_free(key->name);
+		g_free(key);
+		key = next;
+	}
+}
+
+static void free_enums(GArray* enums) {
 	guint i;
-	int proto_mibs = -1;
-	wmem_array_t* hfa;
-	GArray* etta;
-	gchar* path_str;
 
-	if (!load_smi_modules) {
-		D(1,("OID resolution not enabled"));
-		return;
+	if (!enums) return;
+
+	for (i = 0; i < enums->len; i++)
+		g_free((char*)g_array_index(enums, value_string, i).strptr);
+	g_array_free(enums, TRUE);
+}
+
+static void mib_cache_put_node(GByteArray* b, const mib_node_t* node) {
+	guint i;
+	guint32 type_idx = G_MAXUINT32;
+	guint32 num_keys = 0;
+	oid_key_t* k;
+
+	dict_cache_put_u32(b, node->oid_len);
+	for (i = 0; i < node->oid_len; i++)
+		dict_cache_put_u32(b, node->subids[i]);
+	dict_cache_put_str(b, node->name);
+	dict_cache_put_u32(b, node->kind);
+	for (i = 0; i < G_N_ELEMENTS(mib_cache_types); i++) {
+		if (node->type == mib_cache_types[i])
+			type_idx = i;
+	}
+	dict_cache_put_u32(b, type_idx);
+	dict_cache_put_str(b, node->blurb);
+
+	dict_cache_put_u32(b, node->enums ? node->enums->len : 0);
+	for (i = 0; node->enums && i < node->enums->len; i++) {
+		value_string* val = &g_array_index(node->enums, value_string, i);
+		dict_cache_put_u32(b, val->value);
+		dict_cache_put_str(b, val->strptr);
 	}
 
-	/* TODO: Remove this workaround when unregistration of "MIBs" proto is solved.
-	 * Wireshark does not support that yet. :-( */
-	if (oids_init_done) {
-		D(1,("Exiting register_mibs() to avoid double registration of MIBs proto."));
-		return;
+	for (k = node->key; k; k = k->next)
+		num_keys++;
+	dict_cache_put_u32(b, num_keys);
+	for (k = node->key; k; k = k->next) {
+		dict_cache_put_str(b, k->name);
+		dict_cache_put_u32(b, k->num_subids);
+		dict_cache_put_u32(b, k->key_type);
+		dict_cache_put_u32(b, k->ft_type);
+		dict_cache_put_u32(b, k->display);
 	}
+}
 
-	hfa = wmem_array_new(wmem_epan_scope(), sizeof(hf_register_info));
-	etta = g_array_new(FALSE,TRUE,sizeof(gint*));
+/* Returns FALSE if the cache is truncated or corrupt. */
+static gboolean mib_cache_get_node(dict_cache_reader_t* r, mib_node_t* node) {
+	guint32 i, n, type_idx;
+	oid_key_t* kl = NULL;
+
+	memset(node, 0, sizeof *node);
+
+	node->oid_len = dict_cache_get_u32(r);
+	if (!r->ok || node->oid_len == 0 || node->oid_len > (gsize)(r->end - r->ptr) / sizeof(guint32))
+		return FALSE;
+	node->subids = g_new(guint32, node->oid_len);
+	for (i = 0; i < node->oid_len; i++)
+		node->subids[i] = dict_cache_get_u32(r);
+	node->name = dict_cache_get_str(r);
+	node->kind = (oid_kind_t)dict_cache_get_u32(r);
+	type_idx = dict_cache_get_u32(r);
+	if (type_idx < G_N_ELEMENTS(mib_cache_types))
+		node->type = mib_cache_types[type_idx];
+	else if (type_idx != G_MAXUINT32)
+		r->ok = FALSE;
+	node->blurb = dict_cache_get_str(r);
+
+	n = dict_cache_get_u32(r);
+	for (i = 0; r->ok && i < n; i++) {
+		value_string val;
+
+		if (!node->enums)
+			node->enums = g_array_new(TRUE, TRUE, sizeof(value_string));
+		val.value = dict_cache_get_u32(r);
+		val.strptr = dict_cache_get_str(r);
+		g_array_append_val(node->enums, val);
+	}
+
+	n = dict_cache_get_u32(r);
+	for (i = 0; r->ok && i < n; i++) {
+		oid_key_t* k = g_new0(oid_key_t, 1);
+
+		k->name = dict_cache_get_str(r);
+		k->num_subids = dict_cache_get_u32(r);
+		k->key_type = (oid_key_type_t)dict_cache_get_u32(r);
+		k->ft_type = (enum ftenum)dict_cache_get_u32(r);
+		k->display = (int)dict_cache_get_u32(r);
+		k->hfid = -2;
+
+		if (kl)
+			kl->next = k;
+		else
+			node->key = k;
+		kl = k;
+	}
+
+	return r->ok && node->name != NULL;
+}
+
+static void mib_node_clear(mib_node_t* node) {
+	g_free(node->name);
+	g_free(node->subids);
+	g_free(node->blurb);
+	free_enums(node->enums);
+	free_oid_keys(node->key);
+	memset(node, 0, sizeof *node);
+}
+
+/*
+ * Add a node to the OID tree and collect the fields for its value and
+ * index keys. Takes ownership of the node's keys and enums.
+ */
+static void register_mib_node(wmem_array_t* hfa, mib_node_t* node) {
+	oid_key_t* key;
+	char *sub;
+	oid_info_t* oid_data = add_oid(node->name,
+				       node->kind,
+				       node->type,
+				       node->key,
+				       node->oid_len,
+				       node->subids);
+
+	if (oid_data->key != node->key) {
+		/* The node already existed; it keeps its keys. */
+		free_oid_keys(node->key);
+	}
+	node->key = NULL;
+
+	sub = oid_subid2string(NULL, node->subids, node->oid_len);
+	D(4,("\t\tNode: kind=%d oid=%s name=%s ",
+		 oid_data->kind, sub, oid_data->name));
+	wmem_free(NULL, sub);
+
+	if ( node->type && oid_data->value_hfid == -2 ) {
+		hf_register_info hf;
+		char *name;
+		char *blurb;
+
+		name = g_strdup(oid_data->name);
+		blurb = g_strdup(node->blurb);
+		/* Don't allow duplicate blurb/name */
+		if (blurb && strcmp(blurb, name) == 0) {
+			g_free(blurb);
+			blurb = NULL;
+		}
+
+		hf.p_id                     = &(oid_data->value_hfid);
+		hf.hfinfo.name              = name;
+		hf.hfinfo.abbrev            = alnumerize(oid_data->name);
+		hf.hfinfo.type              = node->type->ft_type;
+		hf.hfinfo.display           = node->type->display;
+		hf.hfinfo.strings           = NULL;
+		hf.hfinfo.bitmask           = 0;
+		hf.hfinfo.blurb             = blurb;
+		/* HFILL */
+		HFILL_INIT(hf);
+
+		oid_data->value_hfid = -1;
+
+		if ( IS_ENUMABLE(hf.hfinfo.type) && node->enums ) {
+			hf.hfinfo.strings = g_array_free(node->enums, FALSE);
+			node->enums = NULL;
+		}
+
+		wmem_array_append_one(hfa,hf);
+	}
+
+	if ((key = oid_data->key)) {
+		for(; key; key = key->next) {
+			D(5,("\t\t\tIndex: name=%s subids=%u key_type=%d",
+				 key->name, key->num_subids, key->key_type ));
+
+			if (key->hfid == -2) {
+				hf_register_info hf;
+
+				hf.p_id                     = &(key->hfid);
+				hf.hfinfo.name              = key->name;
+				hf.hfinfo.abbrev            = alnumerize(key->name);
+				hf.hfinfo.type              = key->ft_type;
+				hf.hfinfo.display           = key->display;
+				hf.hfinfo.strings           = NULL;
+				hf.hfinfo.bitmask           = 0;
+				hf.hfinfo.blurb             = NULL;
+				/* HFILL */
+				HFILL_INIT(hf);
+
+				wmem_array_append_one(hfa,hf);
+				key->hfid = -1;
+			}
+		}
+	}
+}
+
+/* Returns FALSE, without registering anything, if there's no usable cache. */
+static gboolean register_mibs_from_cache(wmem_array_t* hfa, GChecksum* key) {
+	dict_cache_reader_t r;
+	GArray* nodes;
+	guint i;
+
+	if (!dict_cache_open(&r, MIB_CACHE_FILE, MIB_CACHE_MAGIC, MIB_CACHE_VERSION, key))
+		return FALSE;
+
+	/* Check the whole cache before adding anything to the tree. */
+	nodes = g_array_new(FALSE, FALSE, sizeof(mib_node_t));
+	while (!dict_cache_at_end(&r)) {
+		mib_node_t node;
+
+		if (!mib_cache_get_node(&r, &node)) {
+			D(1,("MIB cache is corrupt"));
+			mib_node_clear(&node);
+			for (i = 0; i < nodes->len; i++)
+				mib_node_clear(&g_array_index(nodes, mib_node_t, i));
+			g_array_free(nodes, TRUE);
+			dict_cache_close(&r);
+			return FALSE;
+		}
+		g_array_append_val(nodes, node);
+	}
+	dict_cache_close(&r);
+
+	for (i = 0; i < nodes->len; i++) {
+		mib_node_t* node = &g_array_index(nodes, mib_node_t, i);
+		register_mib_node(hfa, node);
+		mib_node_clear(node);
+	}
+	D(1,("Loaded %u MIB nodes from the cache", nodes->len));
+	g_array_free(nodes, TRUE);
+
+	return TRUE;
+}
+
+static void register_mibs_from_smi(wmem_array_t* hfa, const char* path_str, GChecksum* key) {
+	SmiModule *smiModule;
+	SmiNode *smiNode;
+	guint i;
+	GByteArray* cache;
+	gboolean cacheable = TRUE;
+
+	cache = dict_cache_new(MIB_CACHE_MAGIC, MIB_CACHE_VERSION, key);
 
 	smiInit(NULL);
 	smi_init_done = TRUE;
@@ -563,9 +825,6 @@ static void register_mibs(void) {
 	smi_errors = g_string_new("");
 	smiSetErrorHandler(smi_error_handler);
 
-	path_str = oid_get_default_mib_path();
-	D(1,("SMI Path: '%s'",path_str));
-
 	smiSetPath(path_str);
 
 	for(i=0;i<num_smi_modules;i++) {
@@ -591,9 +850,10 @@ static void register_mibs(void) {
 					   "installing them.\n" , smi_errors->str , path_str);
 		}
 		D(1,("Errors while loading:\n%s\n",smi_errors->str));
+		/* Don't cache, so that the errors are reported again. */
+		cacheable = FALSE;
 	}
 
-	g_free(path_str);
 	g_string_free(smi_errors,TRUE);
 
 	for (smiModule = smiGetFirstModule();
@@ -614,6 +874,7 @@ static void register_mibs(void) {
 					"See details at: https://bugs.debian.org/560325\n",
 					 smiModule->name, smiModule->conformance);
 			}
+			cacheable = FALSE;
 			continue;
 		}
 		for (smiNode = smiGetFirstNode(smiModule, SMI_NODEKIND_ANY);
@@ -621,128 +882,101 @@ static void register_mibs(void) {
 			 smiNode = smiGetNextNode(smiNode, SMI_NODEKIND_ANY)) {
 
 			SmiType* smiType =  smiGetNodeType(smiNode);
-			const oid_value_type_t* typedata =  get_typedata(smiType);
-			oid_key_t* key;
-			oid_kind_t kind = smikind(smiNode,&key);
-			char *sub;
-			char *oid = smiRenderOID(smiNode->oidlen, smiNode->oid, SMI_RENDER_QUALIFIED);
-			oid_info_t* oid_data = add_oid(oid,
-						       kind,
-						       typedata,
-						       key,
-						       smiNode->oidlen,
-						       smiNode->oid);
-			smi_free (oid);
+			mib_node_t node;
+			char *oid, *blurb;
 
-			sub = oid_subid2string(NULL, smiNode->oid, smiNode->oidlen);
-			D(4,("\t\tNode: kind=%d oid=%s name=%s ",
-				 oid_data->kind, sub, oid_data->name));
-			wmem_free(NULL, sub);
+			node.type = get_typedata(smiType);
+			node.kind = smikind(smiNode,&node.key);
+			node.oid_len = smiNode->oidlen;
+			node.subids = (guint32*)g_memdup2(smiNode->oid, smiNode->oidlen * sizeof(guint32));
 
-			if ( typedata && oid_data->value_hfid == -2 ) {
+			oid = smiRenderOID(smiNode->oidlen, smiNode->oid, SMI_RENDER_QUALIFIED);
+			node.name = g_strdup(oid);
+			smi_free (oid);
+
+			node.blurb = NULL;
+			node.enums = NULL;
+			if (node.type) {
 				SmiNamedNumber* smiEnum;
-				hf_register_info hf;
-				char *name;
-				char *blurb;
 
-				name = g_strdup(oid_data->name);
 				blurb = smiRenderOID(smiNode->oidlen, smiNode->oid, SMI_RENDER_ALL);
-				/* Don't allow duplicate blurb/name */
-				if (strcmp(blurb, name) == 0) {
-					smi_free(blurb);
-					blurb = NULL;
-				}
-
-				hf.p_id                     = &(oid_data->value_hfid);
-				hf.hfinfo.name              = name;
-				hf.hfinfo.abbrev            = alnumerize(oid_data->name);
-				hf.hfinfo.type              = typedata->ft_type;
-				hf.hfinfo.display           = typedata->display;
-				hf.hfinfo.strings           = NULL;
-				hf.hfinfo.bitmask           = 0;
-				hf.hfinfo.blurb             = blurb;
-				/* HFILL */
-				HFILL_INIT(hf);
-
-				oid_data->value_hfid = -1;
+				node.blurb = g_strdup(blurb);
+				smi_free(blurb);
 
-				if ( IS_ENUMABLE(hf.hfinfo.type) && (smiEnum = smiGetFirstNamedNumber(smiType))) {
-					GArray* vals = g_array_new(TRUE,TRUE,sizeof(value_string));
+				if ( IS_ENUMABLE(node.type->ft_type) && (smiEnum = smiGetFirstNamedNumber(smiType))) {
+					node.enums = g_array_new(TRUE,TRUE,sizeof(value_string));
 
 					for(;smiEnum; smiEnum = smiGetNextNamedNumber(smiEnum)) {
 						if (smiEnum->name) {
 							value_string val;
 							val.value  = (guint32)smiEnum->value.value.integer32;
 							val.strptr = g_strdup(smiEnum->name);
-							g_array_append_val(vals,val);
+							g_array_append_val(node.enums,val);
 						}
 					}
-
-					hf.hfinfo.strings = g_array_free(vals, FALSE);
 				}
-#if 0 /* packet-snmp does not handle bits yet */
-			} else if (smiType->basetype == SMI_BASETYPE_BITS && ( smiEnum = smiGetFirstNamedNumber(smiType) )) {
-				guint n = 0;
-				oid_bits_info_t* bits = g_new(oid_bits_info_t, 1);
-				gint* ettp = &(bits->ett);
-
-				bits->num = 0;
-				bits->ett = -1;
+			}
 
-				g_array_append_val(etta,ettp);
+			if (cacheable)
+				mib_cache_put_node(cache, &node);
+			register_mib_node(hfa, &node);
+			mib_node_clear(&node);
+		}
+	}
 
-				for(;smiEnum; smiEnum = smiGetNextNamedNumber(smiEnum), bits->num++);
+	if (cacheable)
+		dict_cache_save(MIB_CACHE_FILE, cache);
+	else
+		g_byte_array_free(cache, TRUE);
+}
 
-				bits->data = g_malloc(sizeof(struct _oid_bit_t)*bits->num);
+static void register_mibs(void) {
+	int proto_mibs = -1;
+	wmem_array_t* hfa;
+	GArray* etta;
+	gchar* path_str;
+	GChecksum* key;
+	gchar** dirs;
+	guint i;
 
-				for(smiEnum = smiGetFirstNamedNumber(smiType),n=0;
-					smiEnum;
-					smiEnum = smiGetNextNamedNumber(smiEnum),n++) {
-					guint mask = 1 << (smiEnum->value.value.integer32 % 8);
-					char* base = alnumerize(oid_data->name);
-					char* ext = alnumerize(smiEnum->name);
-					hf_register_info hf2 = { &(bits->data[n].hfid), { NULL, NULL, FT_UINT8, BASE_HEX, NULL, mask, NULL, HFILL }};
+	if (!load_smi_modules) {
+		D(1,("OID resolution not enabled"));
+		return;
+	}
 
-					bits->data[n].hfid = -1;
-					bits->data[n].offset = smiEnum->value.value.integer32 / 8;
+	/* TODO: Remove this workaround when unregistration of "MIBs" proto is solved.
+	 * Wireshark does not support that yet. :-( */
+	if (oids_init_done) {
+		D(1,("Exiting register_mibs() to avoid double registration of MIBs proto."));
+		return;
+	}
 
-					hf2.hfinfo.name = g_strconcat("%s:%s",oid_data->name, ":", smiEnum->name, NULL);
-					hf2.hfinfo.abbrev = g_strconcat(base, ".", ext, NULL);
+	hfa = wmem_array_new(wmem_epan_scope(), sizeof(hf_register_info));
+	etta = g_array_new(FALSE,TRUE,sizeof(gint*));
 
-					g_free(base);
-					g_free(ext);
-					g_array_append_val(hfa,hf2);
-				}
-#endif /* packet-snmp does not use this yet */
-				wmem_array_append_one(hfa,hf);
-			}
+	path_str = oid_get_default_mib_path();
+	D(1,("SMI Path: '%s'",path_str));
 
-			if ((key = oid_data->key)) {
-				for(; key; key = key->next) {
-					D(5,("\t\t\tIndex: name=%s subids=%u key_type=%d",
-						 key->name, key->num_subids, key->key_type ));
-
-					if (key->hfid == -2) {
-						hf_register_info hf;
-
-						hf.p_id                     = &(key->hfid);
-						hf.hfinfo.name              = key->name;
-						hf.hfinfo.abbrev            = alnumerize(key->name);
-						hf.hfinfo.type              = key->ft_type;
-						hf.hfinfo.display           = key->display;
-						hf.hfinfo.strings           = NULL;
-						hf.hfinfo.bitmask           = 0;
-						hf.hfinfo.blurb             = NULL;
-						/* HFILL */
-						HFILL_INIT(hf);
-
-						wmem_array_append_one(hfa,hf);
-						key->hfid = -1;
-					}
-				}
-			}
-		}
+	/*
+	 * The cache is only valid for the same path and modules, and as
+	 * long as no file in the MIB directories has changed.
+	 */
+	key = g_checksum_new(G_CHECKSUM_SHA256);
+	dict_cache_key_add_string(key, path_str);
+	for (i = 0; i < num_smi_modules; i++) {
+		if (smi_modules[i].name)
+			dict_cache_key_add_string(key, smi_modules[i].name);
 	}
+	dirs = g_strsplit(path_str, G_SEARCHPATH_SEPARATOR_S, -1);
+	for (i = 0; dirs[i]; i++)
+		dict_cache_key_add_dir(key, dirs[i]);
+	g_strfreev(dirs);
+
+	if (!register_mibs_from_cache(hfa, key))
+		register_mibs_from_smi(hfa, path_str, key);
+
+	g_checksum_free(key);
+	g_free(path_str);
 
 	proto_mibs = proto_register_protocol("MIBs", "MIBS", "mibs");
 
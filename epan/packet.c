@@ -69,7 +69,9 @@ struct data_source {
  * used in that table; not all of them are necessarily in the table,
  * as they may be for protocols that don't have a fixed uint value,
  * e.g. for TCP or UDP port number tables and protocols with no fixed
- * port number.
+ * port number.  Handles are prepended as they're registered and the
+ * list is only sorted by filter name when someone asks for it;
+ * "dissector_handles_sorted" is FALSE when that still needs doing.
  *
  * "ui_name" is the name the dissector table has in the user interface.
  *
@@ -86,14 +88,21 @@ struct data_source {
 struct dissector_table {
 	GHashTable	*hash_table;
 	GSList		*dissector_handles;
+	gboolean	dissector_handles_sorted;
 	const char	*ui_name;
 	ftenum_t	type;
 	int		param;
 	protocol_t	*protocol;
 	GHashFunc	hash_func;
 	gboolean	supports_decode_as;
+	/* For FT_UINT8 and FT_UINT16 tables, an array of pages of
+	 * DTBL_UINT_PAGE_SIZE entries, indexed by the upper and lower bits
+	 * of the value, built on the first lookup; NULL if not built. */
+	dtbl_entry_t	***uint_pages;
 };
 
+static void uint_dtbl_pages_free(dissector_table_t sub_dissectors);
+
 /*
  * Dissector tables. const char * -> dissector_table *
  */
@@ -192,6 +201,7 @@ destroy_dissector_table(void *data)
 	struct dissector_table *table = (struct dissector_table *)data;
 
 	g_hash_table_destroy(table->hash_table);
+	uint_dtbl_pages_free(table);
 	g_slist_free(table->dissector_handles);
 	g_slice_free(struct dissector_table, data);
 }
@@ -815,6 +825,142 @@ remove_last_layer(packet_info *pinfo, gboolean reduce_count)
  * The only time this function will return 0 is if it is a new style dissector
  * and if the dissector rejected the packet.
  */
+
+/* Dissector profiling, see dissector_profile_enable(). */
+typedef struct {
+	guint64 calls;
+	gint64  total_us;
+	gint64  self_us;
+} dissector_profile_t;
+
+typedef struct {
+	gint64  start;
+	gint64  child_us;	/* time spent in the dissectors we called */
+	gint64 *saved_child_us;
+} dissector_profile_frame_t;
+
+static gboolean dissector_profiling = FALSE;
+/* protocol_t * -> dissector_profile_t * */
+static GHashTable *dissector_profiles = NULL;
+/* child_us of the innermost running dissector, if any */
+static gint64 *dissector_profile_child_us = NULL;
+
+void
+dissector_profile_enable(gboolean enable)
+{
+	if (enable && dissector_profiles == NULL) {
+		dissector_profiles = g_hash_table_new_full(g_direct_hash,
+		    g_direct_equal, NULL, g_free);
+	}
+	dissector_profiling = enable;
+}
+
+void
+dissector_profile_reset(void)
+{
+	if (dissector_profiles != NULL)
+		g_hash_table_remove_all(dissector_profiles);
+}
+
+void
+dissector_profile_foreach(dissector_profile_func func, gpointer user_data)
+{
+	GHashTableIter iter;
+	gpointer key, value;
+
+	if (dissector_profiles == NULL)
+		return;
+
+	g_hash_table_iter_init(&iter, dissector_profiles);
+	while (g_hash_table_iter_next(&iter, &key, &value)) {
+		dissector_profile_t *p = (dissector_profile_t *)value;
+		func(proto_get_protocol_short_name((protocol_t *)key),
+		    p->calls, p->total_us, p->self_us, user_data);
+	}
+}
+
+static inline void
+dissector_profile_enter(dissector_profile_frame_t *frame)
+{
+	frame->start = g_get_monotonic_time();
+	frame->child_us = 0;
+	frame->saved_child_us = dissector_profile_child_us;
+	dissector_profile_child_us = &frame->child_us;
+}
+
+static void
+dissector_profile_leave(dissector_profile_frame_t *frame, protocol_t *protocol)
+{
+	gint64 elapsed = g_get_monotonic_time() - frame->start;
+	dissector_profile_t *p;
+
+	dissector_profile_child_us = frame->saved_child_us;
+	if (dissector_profile_child_us != NULL)
+		*dissector_profile_child_us += elapsed;
+
+	p = (dissector_profile_t *)g_hash_table_lookup(dissector_profiles, protocol);
+	if (p == NULL) {
+		p = g_new0(dissector_profile_t, 1);
+		g_hash_table_insert(dissector_profiles, protocol, p);
+	}
+	p->calls++;
+	p->total_us += elapsed;
+	p->self_us += elapsed - frame->child_us;
+}
+
+static int
+call_dissector_func(dissector_handle_t handle, tvbuff_t *tvb,
+		    packet_info *pinfo, proto_tree *tree, void *data)
+{
+	if (handle->dissector_type == DISSECTOR_TYPE_SIMPLE) {
+		return ((dissector_t)handle->dissector_func)(tvb, pinfo, tree, data);
+	}
+	else if (handle->dissector_type == DISSECTOR_TYPE_CALLBACK) {
+		return ((dissector_cb_t)handle->dissector_func)(tvb, pinfo, tree, data, handle->dissector_data);
+	}
+	ws_assert_not_reached();
+}
+
+static int
+call_dissector_func_profiled(dissector_handle_t handle, tvbuff_t *tvb,
+			     packet_info *pinfo, proto_tree *tree, void *data)
+{
+	dissector_profile_frame_t frame;
+	volatile int len = 0;
+
+	/* Dissectors throw all the time, so make sure the time is
+	 * accounted and the frame unlinked either way. */
+	dissector_profile_enter(&frame);
+	TRY {
+		len = call_dissector_func(handle, tvb, pinfo, tree, data);
+	}
+	FINALLY {
+		dissector_profile_leave(&frame, handle->protocol);
+	}
+	ENDTRY;
+
+	return len;
+}
+
+static int
+call_heur_dissector_profiled(heur_dtbl_entry_t *hdtbl_entry, tvbuff_t *tvb,
+			     packet_info *pinfo, proto_tree *tree, void *data)
+{
+	dissector_profile_frame_t frame;
+	volatile int len = 0;
+
+	dissector_profile_enter(&frame);
+	TRY {
+		len = (hdtbl_entry->dissector)(tvb, pinfo, tree, data);
+	}
+	FINALLY {
+		dissector_profile_leave(&frame, hdtbl_entry->protocol);
+	}
+	ENDTRY;
+
+	return len;
+}
+
 static int
 call_dissector_through_handle(dissector_handle_t handle, tvbuff_t *tvb,
 			      packet_info *pinfo, proto_tree *tree, void *data)
@@ -829,14 +975,11 @@ call_dissector_through_handle(dissector_handle_t handle, tvbuff_t *tvb,
 			proto_get_protocol_short_name(handle->protocol);
 	}
 
-	if (handle->dissector_type == DISSECTOR_TYPE_SIMPLE) {
-		len = ((dissector_t)handle->dissector_func)(tvb, pinfo, tree, data);
-	}
-	else if (handle->dissector_type == DISSECTOR_TYPE_CALLBACK) {
-		len = ((dissector_cb_t)handle->dissector_func)(tvb, pinfo, tree, data, handle->dissector_data);
+	if (G_UNLIKELY(dissector_profiling) && handle->protocol != NULL) {
+		len = call_dissector_func_profiled(handle, tvb, pinfo, tree, data);
 	}
 	else {
-		ws_assert_not_reached();
+		len = call_dissector_func(handle, tvb, pinfo, tree, data);
 	}
 	pinfo->current_proto = saved_proto;
 
@@ -1077,6 +1220,71 @@ find_dissector_table(const char *name)
 	return dissector_table;
 }
 
+/*
+ * Small uint tables (ethertype, ip.proto, tcp.port, ...) are looked up
+ * for most packets, so besides the hash table they get a two-level array
+ * indexed by value. Pages are only allocated for the ranges in use.
+ */
+#define DTBL_UINT_PAGE_SHIFT	8
+#define DTBL_UINT_PAGE_SIZE	(1 << DTBL_UINT_PAGE_SHIFT)
+#define DTBL_UINT_MAX_VALUE	0xffff
+
+static gboolean
+uint_dtbl_has_pages(dissector_table_t sub_dissectors)
+{
+	return sub_dissectors->type == FT_UINT8 || sub_dissectors->type == FT_UINT16;
+}
+
+static void
+uint_dtbl_pages_free(dissector_table_t sub_dissectors)
+{
+	guint i;
+
+	if (sub_dissectors->uint_pages == NULL)
+		return;
+
+	for (i = 0; i <= (DTBL_UINT_MAX_VALUE >> DTBL_UINT_PAGE_SHIFT); i++)
+		g_free(sub_dissectors->uint_pages[i]);
+	g_free(sub_dissectors->uint_pages);
+	sub_dissectors->uint_pages = NULL;
+}
+
+/* Update the entry for pattern, if the array has been built */
+static void
+uint_dtbl_pages_set(dissector_table_t sub_dissectors, const guint32 pattern,
+		    dtbl_entry_t *dtbl_entry)
+{
+	dtbl_entry_t **page;
+
+	if (sub_dissectors->uint_pages == NULL || pattern > DTBL_UINT_MAX_VALUE)
+		return;
+
+	page = sub_dissectors->uint_pages[pattern >> DTBL_UINT_PAGE_SHIFT];
+	if (page == NULL) {
+		if (dtbl_entry == NULL)
+			return;
+		page = g_new0(dtbl_entry_t *, DTBL_UINT_PAGE_SIZE);
+		sub_dissectors->uint_pages[pattern >> DTBL_UINT_PAGE_SHIFT] = page;
+	}
+	page[pattern & (DTBL_UINT_PAGE_SIZE - 1)] = dtbl_entry;
+}
+
+static void
+uint_dtbl_pages_add(gpointer key, gpointer value, gpointer user_data)
+{
+	uint_dtbl_pages_set((dissector_table_t)user_data, GPOINTER_TO_UINT(key),
+			    (dtbl_entry_t *)value);
+}
+
+static void
+uint_dtbl_pages_build(dissector_table_t sub_dissectors)
+{
+	sub_dissectors->uint_pages = g_new0(dtbl_entry_t **,
+					    (DTBL_UINT_MAX_VALUE >> DTBL_UINT_PAGE_SHIFT) + 1);
+	g_hash_table_foreach(sub_dissectors->hash_table, uint_dtbl_pages_add,
+			     sub_dissectors);
+}
+
 /* Find an entry in a uint dissector table. */
 static dtbl_entry_t *
 find_uint_dtbl_entry(dissector_table_t sub_dissectors, const guint32 pattern)
@@ -1106,6 +1314,16 @@ find_uint_dtbl_entry(dissector_table_t sub_dissectors, const guint32 pattern)
 	/*
 	 * Find the entry.
 	 */
+	if (uint_dtbl_has_pages(sub_dissectors) && pattern <= DTBL_UINT_MAX_VALUE) {
+		dtbl_entry_t **page;
+
+		if (sub_dissectors->uint_pages == NULL)
+			uint_dtbl_pages_build(sub_dissectors);
+
+		page = sub_dissectors->uint_pages[pattern >> DTBL_UINT_PAGE_SHIFT];
+		return page ? page[pattern & (DTBL_UINT_PAGE_SIZE - 1)] : NULL;
+	}
+
 	return (dtbl_entry_t *)g_hash_table_lookup(sub_dissectors->hash_table,
 				   GUINT_TO_POINTER(pattern));
 }
@@ -1189,6 +1407,7 @@ dissector_add_uint(const char *name, const guint32 pattern, dissector_handle_t h
 	/* do the table insertion */
 	g_hash_table_insert(sub_dissectors->hash_table,
 			     GUINT_TO_POINTER(pattern), (gpointer)dtbl_entry);
+	uint_dtbl_pages_set(sub_dissectors, pattern, dtbl_entry);
 
 	/*
 	 * Now, if this table supports "Decode As", add this handle
@@ -1338,6 +1557,7 @@ dissector_delete_uint(const char *name, const guint32 pattern,
 		/*
 		 * Found - remove it.
 		 */
+		uint_dtbl_pages_set(sub_dissectors, pattern, NULL);
 		g_hash_table_remove(sub_dissectors->hash_table,
 				    GUINT_TO_POINTER(pattern));
 	}
@@ -1381,6 +1601,7 @@ void dissector_delete_all(const char *name, dissector_handle_t handle)
 	ws_assert (sub_dissectors);
 
 	g_hash_table_foreach_remove (sub_dissectors->hash_table, dissector_delete_all_check, handle);
+	uint_dtbl_pages_free(sub_dissectors);
 }
 
 static void
@@ -1390,6 +1611,7 @@ dissector_delete_from_table(gpointer key _U_, gpointer value, gpointer user_data
 	ws_assert (sub_dissectors);
 
 	g_hash_table_foreach_remove(sub_dissectors->hash_table, dissector_delete_all_check, user_data);
+	uint_dtbl_pages_free(sub_dissectors);
 	sub_dissectors->dissector_handles = g_slist_remove(sub_dissectors->dissector_handles, user_data);
 }
 
@@ -1435,6 +1657,7 @@ dissector_change_uint(const char *name, const guint32 pattern, dissector_handle_
 	/* do the table insertion */
 	g_hash_table_insert(sub_dissectors->hash_table,
 			     GUINT_TO_POINTER(pattern), (gpointer)dtbl_entry);
+	uint_dtbl_pages_set(sub_dissectors, pattern, dtbl_entry);
 }
 
 /* Reset an entry in a uint dissector table to its initial value. */
@@ -1461,6 +1684,7 @@ dissector_reset_uint(const char *name, const guint32 pattern)
 	if (dtbl_entry->initial != NULL) {
 		dtbl_entry->current = dtbl_entry->initial;
 	} else {
+		uint_dtbl_pages_set(sub_dissectors, pattern, NULL);
 		g_hash_table_remove(sub_dissectors->hash_table,
 				    GUINT_TO_POINTER(pattern));
 	}
@@ -2156,6 +2380,7 @@ dissector_add_for_decode_as(const char *name, dissector_handle_t handle)
 	dissector_table_t  sub_dissectors = find_dissector_table(name);
 	GSList            *entry;
 	dissector_handle_t dup_handle;
+	dissector_handle_t same_desc_handle;
 
 	/*
 	 * Make sure the dissector table exists.
@@ -2194,50 +2419,54 @@ dissector_add_for_decode_as(const char *name, dissector_handle_t handle)
 	if (sub_dissectors->protocol != NULL)
 		register_depend_dissector(proto_get_protocol_short_name(sub_dissectors->protocol), proto_get_protocol_short_name(handle->protocol));
 
-	/* Is it already in this list? */
-	entry = g_slist_find(sub_dissectors->dissector_handles, (gpointer)handle);
-	if (entry != NULL) {
-		/*
-		 * Yes - don't insert it again.
-		 */
-		return;
-	}
-
-	/* Ensure the dissector's description is unique.  This prevents
-	   confusion when using Decode As; duplicate descriptions would
-	   make it impossible to distinguish between the dissectors
-	   with the same descriptions.
+	/* Is it already in this list?  If not, ensure the dissector's
+	   description is unique.  This prevents confusion when using
+	   Decode As; duplicate descriptions would make it impossible to
+	   distinguish between the dissectors with the same descriptions.
 
 	   FT_STRING can at least show the string value in the dialog,
-	   so we don't do the check for them. */
-	if (sub_dissectors->type != FT_STRING)
+	   so we don't do the description check for them.
+
+	   Both checks are done in a single walk of the list, as this is
+	   called for every Decode As registration at startup. */
+	same_desc_handle = NULL;
+	for (entry = sub_dissectors->dissector_handles; entry != NULL; entry = g_slist_next(entry))
 	{
-		for (entry = sub_dissectors->dissector_handles; entry != NULL; entry = g_slist_next(entry))
-		{
-			dup_handle = (dissector_handle_t)entry->data;
-			if (dup_handle->description != NULL &&
-			    strcmp(dup_handle->description, handle->description) == 0)
-			{
-				const char *dissector_name, *dup_dissector_name;
-
-				dissector_name = dissector_handle_get_dissector_name(handle);
-				if (dissector_name == NULL)
-					dissector_name = "(anonymous)";
-				dup_dissector_name = dissector_handle_get_dissector_name(dup_handle);
-				if (dup_dissector_name == NULL)
-					dup_dissector_name = "(anonymous)";
-				fprintf(stderr, "Dissectors %s and %s in dissector table %s have same dissector name %s\n",
-				    dissector_name, dup_dissector_name,
-				    name, handle->description);
-				if (wireshark_abort_on_dissector_bug)
-					abort();
-			}
+		dup_handle = (dissector_handle_t)entry->data;
+		if (dup_handle == handle) {
+			/*
+			 * Yes - don't insert it again.
+			 */
+			return;
 		}
+		if (same_desc_handle == NULL &&
+		    sub_dissectors->type != FT_STRING &&
+		    dup_handle->description != NULL &&
+		    strcmp(dup_handle->description, handle->description) == 0)
+			same_desc_handle = dup_handle;
+	}
+
+	if (same_desc_handle != NULL)
+	{
+		const char *dissector_name, *dup_dissector_name;
+
+		dissector_name = dissector_handle_get_dissector_name(handle);
+		if (dissector_name == NULL)
+			dissector_name = "(anonymous)";
+		dup_dissector_name = dissector_handle_get_dissector_name(same_desc_handle);
+		if (dup_dissector_name == NULL)
+			dup_dissector_name = "(anonymous)";
+		fprintf(stderr, "Dissectors %s and %s in dissector table %s have same dissector name %s\n",
+		    dissector_name, dup_dissector_name,
+		    name, handle->description);
+		if (wireshark_abort_on_dissector_bug)
+			abort();
 	}
 
-	/* Add it to the list. */
+	/* Add it to the list; it's sorted when it's next looked at. */
 	sub_dissectors->dissector_handles =
-		g_slist_insert_sorted(sub_dissectors->dissector_handles, (gpointer)handle, (GCompareFunc)dissector_compare_filter_name);
+		g_slist_prepend(sub_dissectors->dissector_handles, (gpointer)handle);
+	sub_dissectors->dissector_handles_sorted = FALSE;
 }
 
 void dissector_add_for_decode_as_with_preference(const char *name,
@@ -2258,11 +2487,29 @@ dtbl_entry_get_initial_handle (dtbl_entry_t *dtbl_entry)
 	return dtbl_entry->initial;
 }
 
+/*
+ * Sort a table's list of handles by filter name, if it has changed since
+ * it was last sorted.  The list is built newest first and the sort is
+ * stable, so same-named handles end up newest first, just as
+ * g_slist_insert_sorted() would have left them.
+ */
+static void
+dissector_table_sort_handles(dissector_table_t dissector_table)
+{
+	if (dissector_table->dissector_handles_sorted)
+		return;
+
+	dissector_table->dissector_handles =
+		g_slist_sort(dissector_table->dissector_handles, (GCompareFunc)dissector_compare_filter_name);
+	dissector_table->dissector_handles_sorted = TRUE;
+}
+
 GSList *
 dissector_table_get_dissector_handles(dissector_table_t dissector_table) {
 	if (!dissector_table)
 		return NULL;
 
+	dissector_table_sort_handles(dissector_table);
 	return dissector_table->dissector_handles;
 }
 
@@ -2296,6 +2543,7 @@ dissector_handle_t dissector_table_get_dissector_handle(dissector_table_t dissec
 	lookup.dissector_description = description;
 	lookup.handle = NULL;
 
+	dissector_table_sort_handles(dissector_table);
 	g_slist_foreach(dissector_table->dissector_handles, find_dissector_in_table, &lookup);
 	return lookup.handle;
 }
@@ -2445,6 +2693,7 @@ dissector_table_foreach_handle(const char     *table_name,
 	dissector_table_t sub_dissectors = find_dissector_table(table_name);
 	GSList *tmp;
 
+	dissector_table_sort_handles(sub_dissectors);
 	for (tmp = sub_dissectors->dissector_handles; tmp != NULL;
 	     tmp = g_slist_next(tmp))
 		func(table_name, tmp->data, user_data);
@@ -2637,11 +2886,13 @@ register_dissector_table(const char *name, const char *ui_name, const int proto,
 		ws_assert_not_reached();
 	}
 	sub_dissectors->dissector_handles = NULL;
+	sub_dissectors->dissector_handles_sorted = TRUE;
 	sub_dissectors->ui_name = ui_name;
 	sub_dissectors->type    = type;
 	sub_dissectors->param   = param;
 	sub_dissectors->protocol  = (proto == -1) ? NULL : find_protocol_by_id(proto);
 	sub_dissectors->supports_decode_as = FALSE;
+	sub_dissectors->uint_pages = NULL;
 	g_hash_table_insert(dissector_tables, (gpointer)name, (gpointer) sub_dissectors);
 	return sub_dissectors;
 }
@@ -2667,11 +2918,13 @@ dissector_table_t register_custom_dissector_table(const char *name,
 							       &g_free);
 
 	sub_dissectors->dissector_handles = NULL;
+	sub_dissectors->dissector_handles_sorted = TRUE;
 	sub_dissectors->ui_name = ui_name;
 	sub_dissectors->type    = FT_BYTES; /* Consider key a "blob" of data, no need to really create new type */
 	sub_dissectors->param   = BASE_NONE;
 	sub_dissectors->protocol  = (proto == -1) ? NULL : find_protocol_by_id(proto);
 	sub_dissectors->supports_decode_as = FALSE;
+	sub_dissectors->uint_pages = NULL;
 	g_hash_table_insert(dissector_tables, (gpointer)name, (gpointer) sub_dissectors);
 	return sub_dissectors;
 }
@@ -2827,6 +3080,8 @@ heur_dissector_add(const char *name, heur_dissector_t dissector, const char *dis
 	hdtbl_entry->short_name = g_strdup(internal_name);
 	hdtbl_entry->list_name = g_strdup(name);
 	hdtbl_entry->enabled   = (enable == HEURISTIC_ENABLE);
+	hdtbl_entry->tries     = 0;
+	hdtbl_entry->matches   = 0;
 
 	/* do the table insertion */
 	g_hash_table_insert(heuristic_short_names, (gpointer)hdtbl_entry->short_name, hdtbl_entry);
@@ -2949,7 +3204,13 @@ dissector_try_heuristic(heur_dissector_list_t sub_dissectors, tvbuff_t *tvb,
 
 		pinfo->heur_list_name = hdtbl_entry->list_name;
 
-		len = (hdtbl_entry->dissector)(tvb, pinfo, tree, data);
+		hdtbl_entry->tries++;
+		if (G_UNLIKELY(dissector_profiling) && hdtbl_entry->protocol != NULL) {
+			len = call_heur_dissector_profiled(hdtbl_entry, tvb, pinfo, tree, data);
+		}
+		else {
+			len = (hdtbl_entry->dissector)(tvb, pinfo, tree, data);
+		}
 		if (hdtbl_entry->protocol != NULL &&
 			(len == 0 || (tree && saved_tree_count == tree->tree_data->count))) {
 			/*
@@ -2973,11 +3234,23 @@ dissector_try_heuristic(heur_dissector_list_t sub_dissectors, tvbuff_t *tvb,
 			}
 
 			*heur_dtbl_entry = hdtbl_entry;
+			hdtbl_entry->matches++;
+
+			/* Move the matched entry in front of the entries which
+			 * matched less often, for faster search next time.
+			 * Unlike always moving it to the top, this doesn't
+			 * reshuffle the list when several protocols alternate. */
+			if (prev_entry != NULL &&
+			    ((heur_dtbl_entry_t *)prev_entry->data)->matches < hdtbl_entry->matches) {
+				GSList **link;
 
-			/* Bubble the matched entry to the top for faster search next time. */
-			if (prev_entry != NULL) {
 				sub_dissectors->dissectors = g_slist_remove_link(sub_dissectors->dissectors, entry);
-				sub_dissectors->dissectors = g_slist_concat(entry, sub_dissectors->dissectors);
+				for (link = &sub_dissectors->dissectors;
+				    ((heur_dtbl_entry_t *)(*link)->data)->matches >= hdtbl_entry->matches;
+				    link = &(*link)->next)
+					;
+				entry->next = *link;
+				*link = entry;
 			}
 			status = TRUE;
 			break;
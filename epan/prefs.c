@@ -3489,7 +3489,7 @@ prefs_register_modules(void)
 
     prefs_register_uint_preference(gui_module, "packet_list_cached_rows_max",
                                    "Maximum cached rows",
-                                   "Maximum number of rows that can be sorted by columns that require dissection. Increasing this increases memory consumption by caching column text",
+                                   "Maximum number of rows for which column text is cached. Increasing this increases memory consumption, but reduces redissection while scrolling",
                                    10,
                                    &prefs.gui_packet_list_cached_rows_max);
 
@@ -3779,6 +3779,13 @@ prefs_register_modules(void)
             "of cache entries to maintain. A 0 means no limit.",
             10, &prefs.ignore_dup_frames_cache_entries);
 
+    prefs_register_uint_preference(protocols_module, "max_incomplete_reassemblies",
+            "The max number of incomplete reassemblies to keep per reassembly table",
+            "When a reassembly table holds more than this many incomplete "
+            "reassemblies, the ones that have been idle the longest are discarded. "
+            "This bounds memory use on long live captures. A 0 means no limit.",
+            10, &prefs.max_incomplete_reassemblies);
+
     /* Obsolete preferences
      * These "modules" were reorganized/renamed to correspond to their GUI
      * configuration screen within the preferences dialog
@@ -4199,6 +4206,7 @@ pre_init_prefs(void)
     prefs.display_byte_fields_with_spaces = FALSE;
     prefs.ignore_dup_frames = FALSE;
     prefs.ignore_dup_frames_cache_entries = 10000;
+    prefs.max_incomplete_reassemblies = 0;
 
     /* set the default values for the io graph dialog */
     prefs.gui_io_graph_automatic_update = TRUE;
@@ -4724,6 +4732,9 @@ prefs_set_uat_pref(char *uat_entry, char **errmsg) {
         return FALSE;
     }
 
+    /* Add to the records from the file, even if it's loaded on demand. */
+    uat_ensure_loaded(uat);
+
     ret = uat_load_str(uat, p, errmsg);
     return ret;
 }
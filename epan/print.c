@@ -77,6 +77,9 @@ struct _output_fields {
     gchar         aggregator;
     GPtrArray    *fields;
     GHashTable   *field_indicies;
+    guint        *hfid_indicies;        /* field_indicies lookups cached by hfinfo->id */
+    guint         hfid_indicies_len;
+    GArray       *prime_hfids;          /* ids of the fields, for output_fields_prime_edt() */
     GPtrArray   **field_values;
     gchar         quote;
     gboolean      escape;
@@ -1808,73 +1811,74 @@ get_field_data(GSList *src_list, field_info *fi)
     return NULL;  /* not found */
 }
 
+/*
+ * Characters that print_escaped_xml() can't copy through unchanged:
+ * the five XML special characters, and control characters other than
+ * tab, LF and CR (and the terminating '\0').
+ */
+static const guint8 xml_escape_needed[256] = {
+    1, 1, 1, 1, 1, 1, 1, 1, 1, 0, 0, 1, 1, 0, 1, 1,   /* 0x00...0x0f */
+    1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1,   /* 0x10...0x1f */
+    0, 0, 1, 0, 0, 0, 1, 1, 0, 0, 0, 0, 0, 0, 0, 0,   /* 0x20...0x2f */
+    0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 1, 0, 1, 0,   /* 0x30...0x3f */
+    0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,   /* 0x40...0x4f */
+    0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,   /* 0x50...0x5f */
+    0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,   /* 0x60...0x6f */
+    0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 1,   /* 0x70...0x7f */
+};
+
 /* Print a string, escaping out certain characters that need to
  * escaped out for XML. */
 static void
 print_escaped_xml(FILE *fh, const char *unescaped_string)
 {
-    const char *p;
-
-#define ESCAPED_BUFFER_SIZE 256
-#define ESCAPED_BUFFER_LIMIT (ESCAPED_BUFFER_SIZE - (int)sizeof("&quot;"))
-    static char temp_buffer[ESCAPED_BUFFER_SIZE];
-    gint        offset = 0;
+    const char *p, *run;
 
     if (fh == NULL || unescaped_string == NULL) {
         return;
     }
 
     /* XXX: Why not use xml_escape() from epan/strutil.h ? */
-    for (p = unescaped_string; *p != '\0' && (offset <= ESCAPED_BUFFER_LIMIT); p++) {
+    p = unescaped_string;
+    for (;;) {
+        /*
+         * Write out the run of characters that don't need escaping
+         * in one go, rather than copying them a byte at a time.
+         */
+        for (run = p; !xml_escape_needed[(guint8)*p]; p++)
+            ;
+        if (p != run) {
+            fwrite(run, 1, p - run, fh);
+        }
+
         switch (*p) {
+        case '\0':
+            return;
         case '&':
-            (void) g_strlcpy(&temp_buffer[offset], "&amp;", ESCAPED_BUFFER_SIZE-offset);
-            offset += 5;
+            fputs("&amp;", fh);
             break;
         case '<':
-            (void) g_strlcpy(&temp_buffer[offset], "&lt;", ESCAPED_BUFFER_SIZE-offset);
-            offset += 4;
+            fputs("&lt;", fh);
             break;
         case '>':
-            (void) g_strlcpy(&temp_buffer[offset], "&gt;", ESCAPED_BUFFER_SIZE-offset);
-            offset += 4;
+            fputs("&gt;", fh);
             break;
         case '"':
-            (void) g_strlcpy(&temp_buffer[offset], "&quot;", ESCAPED_BUFFER_SIZE-offset);
-            offset += 6;
+            fputs("&quot;", fh);
             break;
         case '\'':
-            (void) g_strlcpy(&temp_buffer[offset], "&#x27;", ESCAPED_BUFFER_SIZE-offset);
-            offset += 6;
-            break;
-        case '\t':
-        case '\n':
-        case '\r':
-            temp_buffer[offset++] = *p;
+            fputs("&#x27;", fh);
             break;
         default:
             /* XML 1.0 doesn't allow ASCII control characters, except
-             * for the three whitespace ones above (which do *not*
-             * include '\v' and '\f', so not the same group as isspace),
-             * even as character references.
+             * for tab, LF and CR (which do *not* include '\v' and '\f',
+             * so not the same group as isspace), even as character
+             * references.
              * There's no official way to escape them, so we'll do this. */
-            if (g_ascii_iscntrl(*p)) {
-                offset += snprintf(&temp_buffer[offset], ESCAPED_BUFFER_SIZE-offset, "\\x%x", (guint8)*p);
-            } else {
-                temp_buffer[offset++] = *p;
-            }
-        }
-        if (offset > ESCAPED_BUFFER_LIMIT) {
-            /* Getting close to end of buffer so flush to fh */
-            temp_buffer[offset] = '\0';
-            fputs(temp_buffer, fh);
-            offset = 0;
+            fprintf(fh, "\\x%x", (guint8)*p);
+            break;
         }
-    }
-    if (offset) {
-        /* Flush any outstanding data */
-        temp_buffer[offset] = '\0';
-        fputs(temp_buffer, fh);
+        p++;
     }
 }
 
@@ -2073,6 +2077,11 @@ void output_fields_free(output_fields_t* fields)
             g_hash_table_destroy(fields->field_indicies);
         }
 
+        g_free(fields->hfid_indicies);
+        if (NULL != fields->prime_hfids) {
+            g_array_free(fields->prime_hfids, TRUE);
+        }
+
         if (NULL != fields->field_values) {
             g_free(fields->field_values);
         }
@@ -2285,6 +2294,63 @@ gboolean output_fields_has_cols(output_fields_t* fields)
     return fields->includes_col_fields;
 }
 
+gboolean output_fields_need_visible_tree(output_fields_t* fields)
+{
+    gsize i;
+
+    ws_assert(fields);
+    if (fields->fields == NULL) {
+        return FALSE;
+    }
+
+    for (i = 0; i < fields->fields->len; i++) {
+        gchar *field = (gchar *)g_ptr_array_index(fields->fields, i);
+        header_field_info *hfinfo;
+
+        if (!strncmp(field, COLUMN_FIELD_FILTER, strlen(COLUMN_FIELD_FILTER)))
+            continue;
+
+        hfinfo = proto_registrar_get_byname(field);
+        if (hfinfo == NULL) {
+            return TRUE;
+        }
+        /* Protocols and text items are output using their representation,
+         * which is only generated in a visible tree. */
+        for (; hfinfo != NULL; hfinfo = hfinfo->same_name_next) {
+            if (hfinfo->type == FT_PROTOCOL || hfinfo->id == hf_text_only) {
+                return TRUE;
+            }
+        }
+    }
+
+    return FALSE;
+}
+
+void output_fields_prime_edt(output_fields_t* fields, epan_dissect_t *edt)
+{
+    gsize i;
+
+    ws_assert(fields);
+    if (fields->fields == NULL) {
+        return;
+    }
+
+    if (fields->prime_hfids == NULL) {
+        fields->prime_hfids = g_array_new(FALSE, FALSE, sizeof(int));
+        for (i = 0; i < fields->fields->len; i++) {
+            gchar *field = (gchar *)g_ptr_array_index(fields->fields, i);
+            header_field_info *hfinfo = proto_registrar_get_byname(field);
+
+            /* Fields with the same name share an entry in the output. */
+            for (; hfinfo != NULL; hfinfo = hfinfo->same_name_next) {
+                g_array_append_val(fields->prime_hfids, hfinfo->id);
+            }
+        }
+    }
+
+    epan_dissect_prime_with_hfid_array(edt, fields->prime_hfids);
+}
+
 void write_fields_preamble(output_fields_t* fields, FILE *fh)
 {
     gsize i;
@@ -2368,6 +2434,41 @@ static void format_field_values(output_fields_t* fields, gpointer field_index, g
     g_ptr_array_add(fv_p, (gpointer)value);
 }
 
+/*
+ * Look up the index of a field in the list of fields to output, caching the
+ * result by field id so that each node in the tree doesn't need the field's
+ * abbreviation to be hashed and compared.
+ */
+#define HFID_INDEX_UNKNOWN      0
+#define HFID_INDEX_NOT_OUTPUT   G_MAXUINT
+
+static gpointer
+output_fields_lookup_hfinfo(output_fields_t *fields, const header_field_info *hfinfo)
+{
+    guint id = (guint)hfinfo->id;
+    gpointer field_index;
+
+    if (id >= fields->hfid_indicies_len) {
+        guint new_len = MAX(id + 1, fields->hfid_indicies_len * 2);
+
+        fields->hfid_indicies = g_renew(guint, fields->hfid_indicies, new_len);
+        memset(fields->hfid_indicies + fields->hfid_indicies_len, 0,
+               (new_len - fields->hfid_indicies_len) * sizeof(guint));
+        fields->hfid_indicies_len = new_len;
+    }
+
+    switch (fields->hfid_indicies[id]) {
+    case HFID_INDEX_UNKNOWN:
+        field_index = g_hash_table_lookup(fields->field_indicies, hfinfo->abbrev);
+        fields->hfid_indicies[id] = field_index ? GPOINTER_TO_UINT(field_index) : HFID_INDEX_NOT_OUTPUT;
+        return field_index;
+    case HFID_INDEX_NOT_OUTPUT:
+        return NULL;
+    default:
+        return GUINT_TO_POINTER(fields->hfid_indicies[id]);
+    }
+}
+
 static void proto_tree_get_node_field_values(proto_node *node, gpointer data)
 {
     write_field_data_t *call_data;
@@ -2380,7 +2481,7 @@ static void proto_tree_get_node_field_values(proto_node *node, gpointer data)
     /* dissection with an invisible proto tree? */
     ws_assert(fi);
 
-    field_index = g_hash_table_lookup(call_data->fields->field_indicies, fi->hfinfo->abbrev);
+    field_index = output_fields_lookup_hfinfo(call_data->fields, fi->hfinfo);
     if (NULL != field_index) {
         format_field_values(call_data->fields, field_index,
                             get_node_field_value(fi, call_data->edt) /* g_ alloc'd string */
@@ -2719,6 +2820,9 @@ output_fields_t* output_fields_new(void)
     fields->aggregator          = ',';
     fields->fields              = NULL; /*Do lazy initialisation */
     fields->field_indicies      = NULL;
+    fields->hfid_indicies       = NULL;
+    fields->hfid_indicies_len   = 0;
+    fields->prime_hfids         = NULL;
     fields->field_values        = NULL;
     fields->quote               ='\0';
     fields->escape              = TRUE;
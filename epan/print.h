@@ -71,6 +71,19 @@ WS_DLL_PUBLIC gboolean output_fields_set_option(output_fields_t* info, gchar* op
 WS_DLL_PUBLIC void output_fields_list_options(FILE *fh);
 WS_DLL_PUBLIC gboolean output_fields_has_cols(output_fields_t* info);
 
+/** Do any of the fields need a visible protocol tree to be output?
+ * Protocols and text items need their representation, which is only
+ * generated when the tree is visible. Other fields are output from their
+ * values, so they only need the tree to be primed with
+ * output_fields_prime_edt().
+ */
+WS_DLL_PUBLIC gboolean output_fields_need_visible_tree(output_fields_t* info);
+
+/** Prime an epan_dissect_t with the fields, so that they are added to
+ * the protocol tree even if it isn't visible.
+ */
+WS_DLL_PUBLIC void output_fields_prime_edt(output_fields_t* info, epan_dissect_t *edt);
+
 /*
  * Higher-level packet-printing code.
  */
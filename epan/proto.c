@@ -397,6 +397,9 @@ static GPtrArray *deregistered_fields = NULL;
 static GPtrArray *deregistered_data = NULL;
 static GPtrArray *deregistered_slice = NULL;
 
+/* Bumped whenever a field is registered or deregistered */
+static guint registrar_generation = 0;
+
 /* indexed by prefix, contains initializers */
 static GHashTable* prefixes = NULL;
 
@@ -450,11 +453,27 @@ static GHashTable *gpa_protocol_aliases = NULL;
 static char *last_field_name = NULL;
 static header_field_info *last_hfinfo;
 
+/*
+ * Protocols and fields sorted by abbreviation, for prefix searches such
+ * as field name completion. Built on first use and thrown away whenever
+ * a name is registered or deregistered.
+ */
+static GPtrArray *gpa_name_index = NULL;
+
 static void save_same_name_hfinfo(gpointer data)
 {
 	same_name_hfinfo = (header_field_info*)data;
 }
 
+static void
+gpa_name_index_invalidate(void)
+{
+	if (gpa_name_index) {
+		g_ptr_array_free(gpa_name_index, TRUE);
+		gpa_name_index = NULL;
+	}
+}
+
 /* Points to the first element of an array of bits, indexed by
    a subtree item type; that array element is TRUE if subtrees of
    an item of that type are to be expanded. */
@@ -642,6 +661,7 @@ proto_cleanup_base(void)
 	}
 	g_free(last_field_name);
 	last_field_name = NULL;
+	gpa_name_index_invalidate();
 
 	while (protocols) {
 		protocol = (protocol_t *)protocols->data;
@@ -1027,6 +1047,85 @@ proto_registrar_get_byname(const char *field_name)
 	return hfinfo;
 }
 
+static int
+hfinfo_abbrev_cmp(gconstpointer a, gconstpointer b)
+{
+	const header_field_info *hfinfo_a = *(const header_field_info * const *)a;
+	const header_field_info *hfinfo_b = *(const header_field_info * const *)b;
+
+	return g_ascii_strcasecmp(hfinfo_a->abbrev, hfinfo_b->abbrev);
+}
+
+static GPtrArray *
+gpa_name_index_get(void)
+{
+	header_field_info *hfinfo;
+	guint i;
+
+	if (gpa_name_index)
+		return gpa_name_index;
+
+	/* Make sure fields registered via prefixes are included. */
+	if (prefixes)
+		proto_initialize_all_prefixes();
+
+	gpa_name_index = g_ptr_array_sized_new(gpa_hfinfo.len);
+	for (i = 0; i < gpa_hfinfo.len; i++) {
+		hfinfo = gpa_hfinfo.hfi[i];
+		if (hfinfo == NULL)
+			continue; /* This is a deregistered protocol or header field */
+		if (hfinfo->id == hf_text_only)
+			continue;
+		/* Only list each name once. */
+		if (hfinfo->same_name_prev_id != -1)
+			continue;
+		g_ptr_array_add(gpa_name_index, hfinfo);
+	}
+	g_ptr_array_sort(gpa_name_index, hfinfo_abbrev_cmp);
+
+	return gpa_name_index;
+}
+
+header_field_info *
+proto_registrar_get_first_with_prefix(const char *prefix, void **cookie)
+{
+	GPtrArray *index = gpa_name_index_get();
+	size_t prefix_len = strlen(prefix);
+	guint lo = 0, hi = index->len, mid;
+	header_field_info *hfinfo;
+
+	/* Find the first name that doesn't sort before the prefix. */
+	while (lo < hi) {
+		mid = lo + (hi - lo) / 2;
+		hfinfo = (header_field_info *)g_ptr_array_index(index, mid);
+		if (g_ascii_strncasecmp(hfinfo->abbrev, prefix, prefix_len) < 0)
+			lo = mid + 1;
+		else
+			hi = mid;
+	}
+
+	*cookie = GUINT_TO_POINTER(lo);
+	return proto_registrar_get_next_with_prefix(prefix, cookie);
+}
+
+header_field_info *
+proto_registrar_get_next_with_prefix(const char *prefix, void **cookie)
+{
+	GPtrArray *index = gpa_name_index_get();
+	guint i = GPOINTER_TO_UINT(*cookie);
+	header_field_info *hfinfo;
+
+	if (i >= index->len)
+		return NULL;
+
+	hfinfo = (header_field_info *)g_ptr_array_index(index, i);
+	if (g_ascii_strncasecmp(hfinfo->abbrev, prefix, strlen(prefix)) != 0)
+		return NULL;
+
+	*cookie = GUINT_TO_POINTER(i + 1);
+	return hfinfo;
+}
+
 header_field_info*
 proto_registrar_get_byalias(const char *alias_name)
 {
@@ -6455,6 +6554,7 @@ hfinfo_remove_from_gpa_name_map(const header_field_info *hfinfo)
 {
 	g_free(last_field_name);
 	last_field_name = NULL;
+	gpa_name_index_invalidate();
 
 	if (!hfinfo->same_name_next && hfinfo->same_name_prev_id == -1) {
 		/* No hfinfo with the same name */
@@ -6762,13 +6862,11 @@ proto_custom_set(proto_tree* tree, GSList *field_ids, gint occurrence,
 
 	const char *hf_str_val;
 	char *str;
-	int *field_idx;
 	int field_id;
-	int ii = 0;
 
 	ws_assert(field_ids != NULL);
-	while ((field_idx = (int *) g_slist_nth_data(field_ids, ii++))) {
-		field_id = *field_idx;
+	for (GSList *iter = field_ids; iter; iter = iter->next) {
+		field_id = *(int *)iter->data;
 		PROTO_REGISTRAR_GET_NTH((guint)field_id, hfinfo);
 
 		/* do we need to rewind ? */
@@ -7672,6 +7770,7 @@ proto_deregister_protocol(const char *short_name)
 
 	g_free(last_field_name);
 	last_field_name = NULL;
+	gpa_name_index_invalidate();
 
 	return TRUE;
 }
@@ -8122,6 +8221,12 @@ proto_register_field_array(const int parent, hf_register_info *hf, const int num
 	}
 }
 
+guint
+proto_registrar_generation(void)
+{
+	return registrar_generation;
+}
+
 /* deregister already registered fields */
 void
 proto_deregister_field (const int parent, gint hf_id)
@@ -8132,6 +8237,7 @@ proto_deregister_field (const int parent, gint hf_id)
 
 	g_free(last_field_name);
 	last_field_name = NULL;
+	gpa_name_index_invalidate();
 
 	if (hf_id == -1 || hf_id == 0)
 		return;
@@ -8148,6 +8254,7 @@ proto_deregister_field (const int parent, gint hf_id)
 			g_hash_table_steal(gpa_name_map, hfi->abbrev);
 			g_ptr_array_remove_index_fast(proto->fields, i);
 			g_ptr_array_add(deregistered_fields, gpa_hfinfo.hfi[hf_id]);
+			registrar_generation++;
 			return;
 		}
 	}
@@ -9008,6 +9115,8 @@ proto_register_field_init(header_field_info *hfinfo, const int parent)
 	hfinfo->same_name_next = NULL;
 	hfinfo->same_name_prev_id = -1;
 
+	registrar_generation++;
+
 	/* if we always add and never delete, then id == len - 1 is correct */
 	if (gpa_hfinfo.len >= gpa_hfinfo.allocated_len) {
 		if (!gpa_hfinfo.hfi) {
@@ -9053,6 +9162,7 @@ proto_register_field_init(header_field_info *hfinfo, const int parent)
 
 		same_name_hfinfo = NULL;
 
+		gpa_name_index_invalidate();
 		g_hash_table_insert(gpa_name_map, (gpointer) (hfinfo->abbrev), hfinfo);
 		/* GLIB 2.x - if it is already present
 		 * the previous hfinfo with the same name is saved
@@ -11465,53 +11575,20 @@ gboolean
 proto_registrar_dump_field_completions(char *prefix)
 {
 	header_field_info *hfinfo;
-	int		   i, len;
+	void		  *cookie;
 	size_t		   prefix_len;
 	gboolean	   matched = FALSE;
 
 	prefix_len = strlen(prefix);
-	len = gpa_hfinfo.len;
-	for (i = 0; i < len ; i++) {
-		if (gpa_hfinfo.hfi[i] == NULL)
-			continue; /* This is a deregistered protocol or header field */
-
-		PROTO_REGISTRAR_GET_NTH(i, hfinfo);
-
+	for (hfinfo = proto_registrar_get_first_with_prefix(prefix, &cookie); hfinfo != NULL;
+	     hfinfo = proto_registrar_get_next_with_prefix(prefix, &cookie)) {
 		/*
-		 * Skip the pseudo-field for "proto_tree_add_text()" since
-		 * we don't want it in the list of filterable fields.
+		 * The index is case-insensitive; keep the completions
+		 * case-sensitive, as they always have been.
 		 */
-		if (hfinfo->id == hf_text_only)
-			continue;
-
-		/* format for protocols */
-		if (proto_registrar_is_protocol(i)) {
-			if(0 == strncmp(hfinfo->abbrev, prefix, prefix_len)) {
-				matched = TRUE;
-				printf("%s\t%s\n", hfinfo->abbrev, hfinfo->name);
-			}
-		}
-		/* format for header fields */
-		else {
-			/*
-			 * If this field isn't at the head of the list of
-			 * fields with this name, skip this field - all
-			 * fields with the same name are really just versions
-			 * of the same field stored in different bits, and
-			 * should have the same type/radix/value list, and
-			 * just differ in their bit masks.	(If a field isn't
-			 * a bitfield, but can be, say, 1 or 2 bytes long,
-			 * it can just be made FT_UINT16, meaning the
-			 * *maximum* length is 2 bytes, and be used
-			 * for all lengths.)
-			 */
-			if (hfinfo->same_name_prev_id != -1)
-				continue;
-
-			if(0 == strncmp(hfinfo->abbrev, prefix, prefix_len)) {
-				matched = TRUE;
-				printf("%s\t%s\n", hfinfo->abbrev, hfinfo->name);
-			}
+		if (0 == strncmp(hfinfo->abbrev, prefix, prefix_len)) {
+			matched = TRUE;
+			printf("%s\t%s\n", hfinfo->abbrev, hfinfo->name);
 		}
 	}
 	return matched;
@@ -11747,6 +11824,7 @@ proto_item_add_bitmask_tree(proto_item *item, tvbuff_t *tvb, const int offset,
 	guint32            integer32;
 	gint               bit_offset;
 	gint               no_of_bits;
+	gboolean           append;
 
 	if (!*fields)
 		REPORT_DISSECTOR_BUG("Illegal call of proto_item_add_bitmask_tree without fields");
@@ -11765,6 +11843,10 @@ proto_item_add_bitmask_tree(proto_item *item, tvbuff_t *tvb, const int offset,
 	if (use_parent_tree == FALSE)
 		tree = proto_item_add_subtree(item, ett);
 
+	/* Appending text to an item which isn't visible does nothing, so
+	 * don't spend time formatting the values for it. */
+	append = !(flags & BMT_NO_APPEND) && item && PTREE_DATA(item)->visible;
+
 	while (*fields) {
 		guint64 present_bits;
 		PROTO_REGISTRAR_GET_NTH(**fields,hf);
@@ -11820,7 +11902,7 @@ proto_item_add_bitmask_tree(proto_item *item, tvbuff_t *tvb, const int offset,
 					     ftype_name(hf->type));
 			break;
 		}
-		if (flags & BMT_NO_APPEND) {
+		if (!append) {
 			fields++;
 			continue;
 		}
@@ -2554,6 +2554,20 @@ WS_DLL_PUBLIC header_field_info* proto_registrar_get_byname(const char *field_na
  @return the registered item */
 WS_DLL_PUBLIC header_field_info* proto_registrar_get_byalias(const char *alias_name);
 
+/** Get the first protocol or field, in case-insensitive sorted order, whose
+ name starts with a prefix. Fields registered more than once under the same
+ name are only returned once.
+ @param prefix the (case-insensitive) name prefix to search for
+ @param cookie state for proto_registrar_get_next_with_prefix()
+ @return the first matching item, or NULL if none */
+WS_DLL_PUBLIC header_field_info* proto_registrar_get_first_with_prefix(const char *prefix, void **cookie);
+
+/** Get the next protocol or field whose name starts with a prefix.
+ @param prefix the same prefix passed to proto_registrar_get_first_with_prefix()
+ @param cookie state from proto_registrar_get_first_with_prefix()
+ @return the next matching item, or NULL if there are no more */
+WS_DLL_PUBLIC header_field_info* proto_registrar_get_next_with_prefix(const char *prefix, void **cookie);
+
 /** Get the header_field id based upon a field name.
  @param field_name the field name to search for
  @return the field id for the registered item */
@@ -2574,6 +2588,12 @@ WS_DLL_PUBLIC int proto_registrar_get_parent(const int n);
  @return TRUE if it's a protocol, FALSE if it's not */
 WS_DLL_PUBLIC gboolean proto_registrar_is_protocol(const int n);
 
+/** Get a counter that changes whenever a field is registered or
+ deregistered, so that anything derived from the set of registered
+ fields (such as compiled display filters) can tell when it is stale.
+ @return the current registration generation */
+WS_DLL_PUBLIC guint proto_registrar_generation(void);
+
 /** Get length of registered field according to field type.
  @param n item # n (0-indexed)
  @return 0 means undeterminable at registration time, -1 means unknown field */
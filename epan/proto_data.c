@@ -26,24 +26,21 @@ typedef struct _proto_data {
   void *proto_data;
 } proto_data_t;
 
-static gint
-p_compare(gconstpointer a, gconstpointer b)
+/* Find the list link holding the (proto, key) entry. This is called for
+   nearly every p_get_proto_data(), so compare the fields inline rather
+   than going through g_slist_find_custom() and a comparison callback. */
+static GSList *
+p_find(GSList *list, int proto, guint32 key)
 {
-  const proto_data_t *ap = (const proto_data_t *)a;
-  const proto_data_t *bp = (const proto_data_t *)b;
-
-  if (ap -> proto > bp -> proto) {
-    return 1;
-  } else if (ap -> proto == bp -> proto) {
-    if (ap->key > bp->key){
-      return 1;
-    } else if (ap -> key == bp -> key) {
-      return 0;
+  for (; list != NULL; list = list->next) {
+    const proto_data_t *pd = (const proto_data_t *)list->data;
+
+    if (pd->proto == proto && pd->key == key) {
+      return list;
     }
-    return -1;
-  } else {
-    return -1;
   }
+
+  return NULL;
 }
 
 void
@@ -76,17 +73,12 @@ p_add_proto_data(wmem_allocator_t *tmp_scope, struct _packet_info* pinfo, int pr
 void
 p_set_proto_data(wmem_allocator_t *scope, struct _packet_info* pinfo, int proto, guint32 key, void *proto_data)
 {
-  proto_data_t  temp;
   GSList       *item;
 
-  temp.proto = proto;
-  temp.key = key;
-  temp.proto_data = NULL;
-
   if (scope == pinfo->pool) {
-    item = g_slist_find_custom(pinfo->proto_data, &temp, p_compare);
+    item = p_find(pinfo->proto_data, proto, key);
   } else if (scope == wmem_file_scope()) {
-    item = g_slist_find_custom(pinfo->fd->pfd, &temp, p_compare);
+    item = p_find(pinfo->fd->pfd, proto, key);
   } else {
     DISSECTOR_ASSERT(!"invalid wmem scope");
   }
@@ -103,17 +95,13 @@ p_set_proto_data(wmem_allocator_t *scope, struct _packet_info* pinfo, int proto,
 void *
 p_get_proto_data(wmem_allocator_t *scope, struct _packet_info* pinfo, int proto, guint32 key)
 {
-  proto_data_t  temp, *p1;
+  proto_data_t *p1;
   GSList       *item;
 
-  temp.proto = proto;
-  temp.key = key;
-  temp.proto_data = NULL;
-
   if (scope == pinfo->pool) {
-    item = g_slist_find_custom(pinfo->proto_data, &temp, p_compare);
+    item = p_find(pinfo->proto_data, proto, key);
   } else if (scope == wmem_file_scope()) {
-    item = g_slist_find_custom(pinfo->fd->pfd, &temp, p_compare);
+    item = p_find(pinfo->fd->pfd, proto, key);
   } else {
     DISSECTOR_ASSERT(!"invalid wmem scope");
   }
@@ -129,26 +117,21 @@ p_get_proto_data(wmem_allocator_t *scope, struct _packet_info* pinfo, int proto,
 void
 p_remove_proto_data(wmem_allocator_t *scope, struct _packet_info* pinfo, int proto, guint32 key)
 {
-  proto_data_t  temp;
   GSList       *item;
   GSList      **proto_list;
 
-  temp.proto = proto;
-  temp.key = key;
-  temp.proto_data = NULL;
-
   if (scope == pinfo->pool) {
-    item = g_slist_find_custom(pinfo->proto_data, &temp, p_compare);
+    item = p_find(pinfo->proto_data, proto, key);
     proto_list = &pinfo->proto_data;
   } else if (scope == wmem_file_scope()) {
-    item = g_slist_find_custom(pinfo->fd->pfd, &temp, p_compare);
+    item = p_find(pinfo->fd->pfd, proto, key);
     proto_list = &pinfo->fd->pfd;
   } else {
     DISSECTOR_ASSERT(!"invalid wmem scope");
   }
 
   if (item) {
-    *proto_list = g_slist_remove(*proto_list, item->data);
+    *proto_list = g_slist_delete_link(*proto_list, item);
   }
 }
 
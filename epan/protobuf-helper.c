@@ -45,6 +45,16 @@ pbw_load_proto_file(PbwDescriptorPool* pool, const char* filename) {
     }
 }
 
+gchar**
+pbw_scan_proto_file_names(const char* filename) {
+    return pbl_scan_proto_file_names(filename);
+}
+
+int
+pbw_defer_proto_file(PbwDescriptorPool* pool, const char* filename, const char* const* names) {
+    return pbl_defer_proto_file((pbl_descriptor_pool_t*) pool, filename, names) ? 0 : 2;
+}
+
 /* like DescriptorPool::FindMethodByName */
 const PbwMethodDescriptor*
 pbw_DescriptorPool_FindMethodByName(const PbwDescriptorPool* pool, const char* name) {
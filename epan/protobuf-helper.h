@@ -85,6 +85,16 @@ pbw_reinit_DescriptorPool(PbwDescriptorPool** pool, const char** directories, pb
 int
 pbw_load_proto_file(PbwDescriptorPool* pool, const char* filename);
 
+/* get the full names of the top level messages, enums and services of a proto file without
+   loading it, NULL if the file cannot be read. The result should be released by g_strfreev(). */
+gchar**
+pbw_scan_proto_file_names(const char* filename);
+
+/* add a proto file that will be loaded only when one of its top level names is looked up,
+   return 0 if successed */
+int
+pbw_defer_proto_file(PbwDescriptorPool* pool, const char* filename, const char* const* names);
+
 /* like DescriptorPool::FindMethodByName */
 const PbwMethodDescriptor*
 pbw_DescriptorPool_FindMethodByName(const PbwDescriptorPool* pool, const char* name);
@@ -250,7 +260,7 @@ pbw_EnumValueDescriptor_full_name(const PbwEnumValueDescriptor* enumValue);
 int
 pbw_EnumValueDescriptor_number(const PbwEnumValueDescriptor* enumValue);
 
-/* visit all messages of this pool */
+/* visit all messages of this pool (not including deferred files not loaded yet) */
 void
 pbw_foreach_message(const PbwDescriptorPool* pool, void (*cb)(const PbwDescriptor* message, void* userdata), void* userdata);
 
@@ -104,6 +104,7 @@ pbl_reinit_descriptor_pool(pbl_descriptor_pool_t** ppool, const char** directori
     p->packages = g_hash_table_new_full(g_str_hash, g_str_equal, g_free, pbl_free_node);
     p->proto_files = g_hash_table_new_full(g_str_hash, g_str_equal, g_free, g_free);
     p->proto_files_to_be_parsed = NULL;
+    p->deferred_names = g_hash_table_new_full(g_str_hash, g_str_equal, g_free, g_free);
 
     *ppool = p;
 }
@@ -118,6 +119,7 @@ pbl_free_pool(pbl_descriptor_pool_t* pool)
     g_hash_table_destroy(pool->packages);
     g_slist_free(pool->proto_files_to_be_parsed); /* elements will be removed in p->proto_files */
     g_hash_table_destroy(pool->proto_files);
+    g_hash_table_destroy(pool->deferred_names);
 
     g_free(pool);
 }
@@ -165,8 +167,8 @@ pbl_canonicalize_absolute_filepath(const char* path)
 }
 
 /* Add a file into to do list */
-gboolean
-pbl_add_proto_file_to_be_parsed(pbl_descriptor_pool_t* pool, const char* filepath)
+static char*
+pbl_find_proto_file(pbl_descriptor_pool_t* pool, const char* filepath)
 {
     char* path = NULL;
     GSList* it = NULL;
@@ -195,6 +197,16 @@ pbl_add_proto_file_to_be_parsed(pbl_descriptor_pool_t* pool, const char* filepat
             /* normally happened during initializing a pool by adding files that need be loaded */
             pool->error_cb("Protobuf: file [%s] does not exist!\n", filepath);
         }
+    }
+    return path;
+}
+
+gboolean
+pbl_add_proto_file_to_be_parsed(pbl_descriptor_pool_t* pool, const char* filepath)
+{
+    char* path = pbl_find_proto_file(pool, filepath);
+
+    if (path == NULL) {
         return FALSE;
     }
 
@@ -217,9 +229,168 @@ pbl_add_proto_file_to_be_parsed(pbl_descriptor_pool_t* pool, const char* filepat
     return TRUE;
 }
 
-/* find node according to full_name */
+gboolean
+pbl_defer_proto_file(pbl_descriptor_pool_t* pool, const char* filepath, const char* const* names)
+{
+    char* path = pbl_find_proto_file(pool, filepath);
+    int i;
+
+    if (path == NULL) {
+        return FALSE;
+    }
+
+    /* a name defined in several files stays with the first one, like in the parsed tree */
+    for (i = 0; names[i]; i++) {
+        if (!g_hash_table_contains(pool->deferred_names, names[i])) {
+            g_hash_table_insert(pool->deferred_names, g_strdup(names[i]), g_strdup(path));
+        }
+    }
+    g_free(path);
+    return TRUE;
+}
+
+/* Skip white spaces, comments and string literals. */
+static const char*
+pbl_scan_skip(const char* p, const char* end)
+{
+    while (p < end) {
+        if (g_ascii_isspace(*p)) {
+            p++;
+        } else if (*p == '/' && p + 1 < end && p[1] == '/') {
+            while (p < end && *p != '\n') p++;
+        } else if (*p == '/' && p + 1 < end && p[1] == '*') {
+            for (p += 2; p < end && !(*p == '*' && p + 1 < end && p[1] == '/'); p++);
+            p = (p < end) ? p + 2 : end;
+        } else if (*p == '"' || *p == '\'') {
+            char quote = *p++;
+            while (p < end && *p != quote && *p != '\n') {
+                p += (*p == '\\' && p + 1 < end) ? 2 : 1;
+            }
+            if (p < end) p++;
+        } else {
+            break;
+        }
+    }
+    return p;
+}
+
+gchar**
+pbl_scan_proto_file_names(const char* filepath)
+{
+    gchar* contents;
+    gsize length;
+    const char *p, *end, *word;
+    GPtrArray* names;
+    char* package = NULL;
+    char* word_buf;
+    int depth = 0;
+    enum { EXPECT_NONE, EXPECT_PACKAGE, EXPECT_NAME } expect = EXPECT_NONE;
+
+    if (!g_file_get_contents(filepath, &contents, &length, NULL)) {
+        return NULL;
+    }
+
+    names = g_ptr_array_new();
+    end = contents + length;
+    for (p = pbl_scan_skip(contents, end); p < end; p = pbl_scan_skip(p, end)) {
+        if (g_ascii_isalpha(*p) || *p == '_') {
+            for (word = p; p < end && (g_ascii_isalnum(*p) || *p == '_' || *p == '.'); p++);
+            if (depth != 0) {
+                continue;
+            }
+            word_buf = g_strndup(word, p - word);
+            if (expect == EXPECT_PACKAGE) {
+                g_free(package);
+                package = word_buf;
+                expect = EXPECT_NONE;
+            } else if (expect == EXPECT_NAME) {
+                g_ptr_array_add(names, package ? g_strconcat(package, ".", word_buf, NULL) : g_strdup(word_buf));
+                g_free(word_buf);
+                expect = EXPECT_NONE;
+            } else {
+                if (strcmp(word_buf, "package") == 0) {
+                    expect = EXPECT_PACKAGE;
+                } else if (strcmp(word_buf, "message") == 0 || strcmp(word_buf, "enum") == 0
+                           || strcmp(word_buf, "service") == 0) {
+                    expect = EXPECT_NAME;
+                }
+                g_free(word_buf);
+            }
+        } else {
+            if (*p == '{') {
+                depth++;
+            } else if (*p == '}' && depth > 0) {
+                depth--;
+            }
+            expect = EXPECT_NONE;
+            p++;
+        }
+    }
+
+    g_free(package);
+    g_free(contents);
+    g_ptr_array_add(names, NULL);
+    return (gchar**) g_ptr_array_free(names, FALSE);
+}
+
+/* Parse the deferred file defining full_name or one of its parents (for example
+   the message of a nested message or the service of a method).
+   Return TRUE if a file was parsed. */
+static gboolean
+pbl_parse_deferred_file(pbl_descriptor_pool_t* pool, const char* full_name)
+{
+    char* name_buf;
+    char* dot;
+    char* path = NULL;
+    gboolean parsed = FALSE;
+
+    /* never start parsing while parsing */
+    if (pool->parser_state || g_hash_table_size(pool->deferred_names) == 0) {
+        return FALSE;
+    }
+
+    name_buf = g_strdup(full_name);
+    while (!(path = (char*) g_hash_table_lookup(pool->deferred_names, name_buf))
+           && (dot = strrchr(name_buf, '.')) != NULL) {
+        *dot = '\0';
+    }
+
+    if (path && !g_hash_table_contains(pool->proto_files, path)) {
+        if (pbl_add_proto_file_to_be_parsed(pool, path)) {
+            run_pbl_parser(pool);
+            parsed = TRUE;
+        }
+    }
+    if (path) {
+        /* parse each file only once, even if the name is not found in it */
+        g_hash_table_remove(pool->deferred_names, name_buf);
+    }
+    g_free(name_buf);
+    return parsed;
+}
+
+static pbl_node_t*
+pbl_find_parsed_node_in_pool(const pbl_descriptor_pool_t* pool, const char* full_name, pbl_node_type_t nodetype);
+
+/* find node according to full_name, parsing the file defining it if it was deferred */
 static pbl_node_t*
 pbl_find_node_in_pool(const pbl_descriptor_pool_t* pool, const char* full_name, pbl_node_type_t nodetype)
+{
+    pbl_node_t* node = pbl_find_parsed_node_in_pool(pool, full_name, nodetype);
+
+    if (node == NULL && pool && full_name) {
+        /* The lookup functions take a const pool, but parsing on demand only
+           completes what was deferred; it does not change what is found. */
+        if (pbl_parse_deferred_file((pbl_descriptor_pool_t*) pool, full_name[0] == '.' ? full_name + 1 : full_name)) {
+            node = pbl_find_parsed_node_in_pool(pool, full_name, nodetype);
+        }
+    }
+    return node;
+}
+
+/* find node according to full_name in the files already parsed */
+static pbl_node_t*
+pbl_find_parsed_node_in_pool(const pbl_descriptor_pool_t* pool, const char* full_name, pbl_node_type_t nodetype)
 {
     char* full_name_buf;
     int len, i;
@@ -49,6 +49,7 @@ typedef struct {
     GHashTable* packages; /* all packages parsed from proto files */
     GHashTable* proto_files; /* all proto files that are parsed or to be parsed */
     GSList* proto_files_to_be_parsed; /* files is to be parsed */
+    GHashTable* deferred_names; /* top level names of deferred files -> file path, parsed on first lookup */
     struct _protobuf_lang_state_t *parser_state; /* current parser state */
 } pbl_descriptor_pool_t;
 
@@ -200,6 +201,17 @@ pbl_add_proto_file_to_be_parsed(pbl_descriptor_pool_t* pool, const char* filepat
 /* run C protocol buffers languange parser, return 0 if successed */
 int run_pbl_parser(pbl_descriptor_pool_t* pool);
 
+/* Get the full names of the messages, enums and services defined at the top level
+   of a proto file, without parsing it. Return NULL if the file cannot be read.
+   The result should be released by g_strfreev(). */
+gchar**
+pbl_scan_proto_file_names(const char* filepath);
+
+/* Add a proto file to pool that will be parsed only when one of the names (top level
+   definitions of this file, as returned by pbl_scan_proto_file_names) is looked up. */
+gboolean
+pbl_defer_proto_file(pbl_descriptor_pool_t* pool, const char* filepath, const char* const* names);
+
 /* like descriptor_pool::FindMethodByName */
 const pbl_method_descriptor_t*
 pbl_message_descriptor_pool_FindMethodByName(const pbl_descriptor_pool_t* pool, const char* name);
@@ -365,7 +377,7 @@ pbl_enum_value_descriptor_full_name(const pbl_enum_value_descriptor_t* enumValue
 int
 pbl_enum_value_descriptor_number(const pbl_enum_value_descriptor_t* enumValue);
 
-/* visit all message in this pool */
+/* visit all message in this pool (deferred files that were not looked up yet are not visited) */
 void
 pbl_foreach_message(const pbl_descriptor_pool_t* pool, void (*cb)(const pbl_message_descriptor_t*, void*), void* userdata);
 
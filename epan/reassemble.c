@@ -13,7 +13,9 @@
 #include <string.h>
 
 #include <epan/packet.h>
+#include <epan/app_mem_usage.h>
 #include <epan/exceptions.h>
+#include <epan/prefs.h>
 #include <epan/reassemble.h>
 #include <epan/tvbuff-int.h>
 
@@ -578,6 +580,91 @@ lookup_fd_head(reassembly_table *table, const packet_info *pinfo,
 	return (fragment_head *)value;
 }
 
+/*
+ * Number of incomplete reassemblies discarded because a fragment table
+ * grew past prefs.max_incomplete_reassemblies.
+ */
+static guint64 reassembly_evicted_count = 0;
+
+guint64
+reassembly_get_evicted_count(void)
+{
+	return reassembly_evicted_count;
+}
+
+/*
+ * A reassembly can be evicted if it is incomplete, is not referenced from
+ * the reassembled table and has not been touched by the current frame.
+ */
+static gboolean
+fragment_head_evictable(const fragment_head *fd_head, guint32 cur_frame)
+{
+	return !(fd_head->flags & FD_DEFRAGMENTED) && fd_head->ref_count == 0 &&
+	    fd_head->frame < cur_frame;
+}
+
+typedef struct {
+	guint32 cur_frame;
+	guint32 threshold;
+	GArray *frames;
+} evict_fragments_data;
+
+static void
+collect_evictable_frames(gpointer key _U_, gpointer value, gpointer user_data)
+{
+	fragment_head *fd_head = (fragment_head *)value;
+	evict_fragments_data *evict = (evict_fragments_data *)user_data;
+
+	if (fragment_head_evictable(fd_head, evict->cur_frame))
+		g_array_append_val(evict->frames, fd_head->frame);
+}
+
+static gboolean
+evict_fragments(gpointer key, gpointer value, gpointer user_data)
+{
+	fragment_head *fd_head = (fragment_head *)value;
+	evict_fragments_data *evict = (evict_fragments_data *)user_data;
+
+	if (!fragment_head_evictable(fd_head, evict->cur_frame) ||
+	    fd_head->frame > evict->threshold)
+		return FALSE;
+	reassembly_evicted_count++;
+	return free_all_fragments(key, value, NULL);
+}
+
+static gint
+compare_frame_nums(gconstpointer a, gconstpointer b)
+{
+	guint32 fa = *(const guint32 *)a, fb = *(const guint32 *)b;
+
+	return (fa > fb) - (fa < fb);
+}
+
+/*
+ * Discard the quarter of the incomplete reassemblies that have gone the
+ * longest without a new fragment. Evicting a fixed fraction rather than a
+ * single entry keeps the cost of the scan amortized over many insertions.
+ */
+static void
+fragment_table_evict(reassembly_table *table, const packet_info *pinfo)
+{
+	evict_fragments_data evict;
+
+	evict.cur_frame = pinfo->num;
+	evict.frames = g_array_sized_new(FALSE, FALSE, sizeof(guint32),
+	    g_hash_table_size(table->fragment_table));
+	g_hash_table_foreach(table->fragment_table, collect_evictable_frames,
+	    &evict);
+	if (evict.frames->len > 0) {
+		g_array_sort(evict.frames, compare_frame_nums);
+		evict.threshold = g_array_index(evict.frames, guint32,
+		    evict.frames->len / 4);
+		g_hash_table_foreach_remove(table->fragment_table,
+		    evict_fragments, &evict);
+	}
+	g_array_free(evict.frames, TRUE);
+}
+
 /*
  * Insert an fd_head into the fragment table, and return the key used.
  */
@@ -587,6 +674,10 @@ insert_fd_head(reassembly_table *table, fragment_head *fd_head,
 {
 	gpointer key;
 
+	if (prefs.max_incomplete_reassemblies != 0 && !pinfo->fd->visited &&
+	    g_hash_table_size(table->fragment_table) >= prefs.max_incomplete_reassemblies)
+		fragment_table_evict(table, pinfo);
+
 	/*
 	 * We're going to use the key to insert the fragment,
 	 * so make a persistent version of it.
@@ -746,6 +837,8 @@ static void fragment_reset_first_gap(fragment_head *fd_head)
  */
 static void fragment_items_removed(fragment_head *fd_head, fragment_item *modified)
 {
+	/* The removed elements may have included the tail. */
+	fd_head->last_frag = NULL;
 	if ((fd_head->first_gap == modified) ||
 	    ((modified != NULL) && (modified->offset > fd_head->contiguous_len))) {
 		/* Removed elements were after first gap */
@@ -1103,6 +1196,14 @@ LINK_FRAG(fragment_head *fd_head,fragment_item *fd)
 		/* New first fragment */
 		fd->next = fd_head->next;
 		fd_head->next = fd;
+	} else if (fd_head->last_frag != NULL &&
+	    fd->offset >= fd_head->last_frag->offset) {
+		/* New last fragment. This is the common case for a stream
+		 * with a gap (e.g. a lost TCP segment) followed by in-order
+		 * data, where walking from the first gap would make every
+		 * insertion linear in the number of fragments. */
+		fd->next = NULL;
+		fd_head->last_frag->next = fd;
 	} else {
 		fd_i = fd_head->next;
 		if (fd_head->first_gap != NULL) {
@@ -1118,6 +1219,9 @@ LINK_FRAG(fragment_head *fd_head,fragment_item *fd)
 		fd->next = fd_i->next;
 		fd_i->next = fd;
 	}
+	if (fd->next == NULL) {
+		fd_head->last_frag = fd;
+	}
 
 	update_first_gap(fd_head, fd, FALSE);
 }
@@ -1132,6 +1236,9 @@ MERGE_FRAG(fragment_head *fd_head, fragment_item *fd)
 
 	multi_insert = (fd->next != NULL);
 
+	/* The tail of the merged list is not tracked here. */
+	fd_head->last_frag = NULL;
+
 	if (fd_head->next == NULL) {
 		fd_head->next = fd;
 		update_first_gap(fd_head, fd, multi_insert);
@@ -1169,6 +1276,9 @@ MERGE_FRAG(fragment_head *fd_head, fragment_item *fd)
 	}
 	/* Reached "main" list end, attach remaining elements */
 	fd_i->next = fd;
+	if (fd == NULL) {
+		fd_head->last_frag = fd_i;
+	}
 
 	update_first_gap(fd_head, inserted, multi_insert);
 }
@@ -2453,6 +2563,7 @@ fragment_add_seq_single_move(reassembly_table *table, const packet_info *pinfo,
 			} else {
 				fh->next = fd;
 			}
+			fh->last_frag = NULL;
 			for (; fd; fd=fd->next) {
 				fd->offset += offset;
 				if (fh->frame < fd->frame) {
@@ -2758,6 +2869,7 @@ fragment_start_seq_check(reassembly_table *table, const packet_info *pinfo,
 		fd_head = g_slice_new(fragment_head);
 		fd_head->next = NULL;
 		fd_head->first_gap = NULL;
+		fd_head->last_frag = NULL;
 		fd_head->contiguous_len = 0;
 		fd_head->frame = 0;
 		fd_head->len = 0;
@@ -3152,10 +3264,65 @@ reassembly_table_cleanup_reg_tables(void)
 	g_list_foreach(reassembly_table_list, reassembly_table_cleanup_reg_table, NULL);
 }
 
+static gsize
+fragment_head_data_size(fragment_head *fd_head)
+{
+	fragment_item *fd_i;
+	gsize size = 0;
+
+	if (fd_head->tvb_data)
+		size += tvb_captured_length(fd_head->tvb_data);
+	for (fd_i = fd_head->next; fd_i; fd_i = fd_i->next) {
+		if (fd_i->tvb_data)
+			size += tvb_captured_length(fd_i->tvb_data);
+	}
+
+	return size;
+}
+
+/*
+ * Sum the data held by the registered reassembly tables, both by
+ * reassemblies in progress and by completed ones.
+ */
+static gsize
+reassembly_mem_usage(void)
+{
+	GHashTable *seen;
+	GHashTableIter iter;
+	gpointer value;
+	gsize size = 0;
+
+	seen = g_hash_table_new(g_direct_hash, g_direct_equal);
+	for (GList *l = reassembly_table_list; l; l = l->next) {
+		reassembly_table *table = ((register_reassembly_table_t *)l->data)->table;
+
+		if (table->fragment_table) {
+			g_hash_table_iter_init(&iter, table->fragment_table);
+			while (g_hash_table_iter_next(&iter, NULL, &value))
+				size += fragment_head_data_size((fragment_head *)value);
+		}
+		if (table->reassembled_table) {
+			/* A completed reassembly is in this table once per frame
+			 * that it spans; count it once. */
+			g_hash_table_iter_init(&iter, table->reassembled_table);
+			while (g_hash_table_iter_next(&iter, NULL, &value)) {
+				if (g_hash_table_add(seen, value))
+					size += fragment_head_data_size((fragment_head *)value);
+			}
+		}
+	}
+	g_hash_table_destroy(seen);
+
+	return size;
+}
+
+static const ws_mem_usage_t reassembly_mem_usage_component = { "Reassembly", reassembly_mem_usage, NULL };
+
 void reassembly_tables_init(void)
 {
 	register_init_routine(&reassembly_table_init_reg_tables);
 	register_cleanup_routine(&reassembly_table_cleanup_reg_tables);
+	memory_usage_component_register(&reassembly_mem_usage_component);
 }
 
 static void
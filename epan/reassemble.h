@@ -65,6 +65,8 @@ typedef struct _fragment_head {
 	struct _fragment_item *next;
 	struct _fragment_item *first_gap;	/**< pointer to last fragment before first gap.
 					 * NULL if there is no fragment starting at offset 0 */
+	struct _fragment_item *last_frag;	/**< pointer to last fragment in list.
+					 * NULL if not known */
 	guint ref_count; 		/**< reference count in reassembled_table */
 	guint32 contiguous_len;	/**< contigous length from head up to first gap */
 	guint32 frame;			/**< maximum of all frame numbers added to reassembly */
@@ -186,6 +188,13 @@ reassembly_table_init(reassembly_table *table,
 WS_DLL_PUBLIC void
 reassembly_table_destroy(reassembly_table *table);
 
+/*
+ * Number of incomplete reassemblies discarded since startup because a
+ * table exceeded the "protocols.max_incomplete_reassemblies" preference.
+ */
+WS_DLL_PUBLIC guint64
+reassembly_get_evicted_count(void);
+
 /*
  * This function adds a new fragment to the reassembly table
  * If this is the first fragment seen for this datagram, a new entry
@@ -1651,6 +1651,77 @@ test_simple_fragment_add(void)
     }
 }
 
+/* This tests fragment_add with a missing first fragment followed by a run
+ * of in-order fragments, which are appended at the tail of the list, and
+ * then an out-of-order fragment which has to be inserted before the tail.
+ *    seq_off   frame  tvb_off   len   more_frags
+ *    -------   -----  -------   ---   ----------
+ *       40       1        0      40   true
+ *       80       2       40      40   true
+ *      140       3      100      20   false
+ *      120       4       80      20   true
+ *        0       5       10      40   true
+ */
+static void
+test_fragment_add_gap_then_in_order(void)
+{
+    fragment_head *fd_head;
+    fragment_item *fd;
+    static const guint32 offsets[] = { 0, 40, 80, 120, 140 };
+    static const guint32 frames[] = { 5, 1, 2, 4, 3 };
+    unsigned int i;
+
+    printf("Starting test test_fragment_add_gap_then_in_order\n");
+
+    pinfo.num = 1;
+    fd_head=fragment_add(&test_reassembly_table, tvb, 0, &pinfo, 12, NULL,
+                         40, 40, TRUE);
+    ASSERT_EQ_POINTER(NULL,fd_head);
+
+    pinfo.num = 2;
+    fd_head=fragment_add(&test_reassembly_table, tvb, 40, &pinfo, 12, NULL,
+                         80, 40, TRUE);
+    ASSERT_EQ_POINTER(NULL,fd_head);
+
+    pinfo.num = 3;
+    fd_head=fragment_add(&test_reassembly_table, tvb, 100, &pinfo, 12, NULL,
+                         140, 20, FALSE);
+    ASSERT_EQ_POINTER(NULL,fd_head);
+
+    pinfo.num = 4;
+    fd_head=fragment_add(&test_reassembly_table, tvb, 80, &pinfo, 12, NULL,
+                         120, 20, TRUE);
+    ASSERT_EQ_POINTER(NULL,fd_head);
+
+    pinfo.num = 5;
+    fd_head=fragment_add(&test_reassembly_table, tvb, 10, &pinfo, 12, NULL,
+                         0, 40, TRUE);
+    ASSERT_NE_POINTER(NULL,fd_head);
+
+    ASSERT_EQ(5,fd_head->frame);
+    ASSERT_EQ(160,fd_head->datalen);
+    ASSERT_EQ(5,fd_head->reassembled_in);
+    ASSERT_EQ(FD_DEFRAGMENTED|FD_DATALEN_SET,fd_head->flags);
+    ASSERT_NE_POINTER(NULL,fd_head->tvb_data);
+
+    fd = fd_head->next;
+    for (i = 0; i < G_N_ELEMENTS(offsets); i++) {
+        ASSERT_NE_POINTER(NULL,fd);
+        ASSERT_EQ(frames[i],fd->frame);
+        ASSERT_EQ(offsets[i],fd->offset);
+        fd = fd->next;
+    }
+    ASSERT_EQ_POINTER(NULL,fd);
+
+    ASSERT(!tvb_memeql(fd_head->tvb_data,0,data+10,40));
+    ASSERT(!tvb_memeql(fd_head->tvb_data,40,data,120));
+    ASSERT(!tvb_memeql(fd_head->tvb_data,140,data+100,20));
+
+    if (debug) {
+        print_fragment_table();
+    }
+}
+
 /* This tests the functionality of fragment_set_partial_reassembly for
  * fragment_add based reassembly.
  *
@@ -3279,6 +3350,7 @@ main(int argc _U_, char **argv _U_)
         test_fragment_add_seq_check_multiple
 #endif
         test_simple_fragment_add,              /* frag table only   */
+        test_fragment_add_gap_then_in_order,
         test_fragment_add_partial_reassembly,
         test_fragment_add_duplicate_first,
         test_fragment_add_duplicate_middle,
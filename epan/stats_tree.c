@@ -554,6 +554,91 @@ stats_tree_create_node_by_pname(stats_tree *st, const gchar *name,
     return stats_tree_create_node(st,name,stats_tree_parent_id_by_name(st,parent_name),datatype,with_children);
 }
 
+/* finds the child of node with the given name */
+static stat_node*
+stats_tree_find_child(stat_node *node, const gchar *name)
+{
+    stat_node *child;
+
+    if (node->hash)
+        return (stat_node *)g_hash_table_lookup(node->hash, name);
+
+    for (child = node->children; child; child = child->next) {
+        if (strcmp(child->name, name) == 0)
+            return child;
+    }
+
+    return NULL;
+}
+
+/* adds the values of src into dst, both nodes of the same kind */
+static void
+merge_stat_node(stats_tree *st, stat_node *dst, const stat_node *src)
+{
+    const stat_node *src_child;
+    stat_node *dst_child;
+
+    dst->counter += src->counter;
+    switch (dst->datatype)
+    {
+    case STAT_DT_INT:
+        dst->total.int_total += src->total.int_total;
+        if (dst->minvalue.int_min > src->minvalue.int_min)
+            dst->minvalue.int_min = src->minvalue.int_min;
+        if (dst->maxvalue.int_max < src->maxvalue.int_max)
+            dst->maxvalue.int_max = src->maxvalue.int_max;
+        break;
+    case STAT_DT_FLOAT:
+        dst->total.float_total += src->total.float_total;
+        if (dst->minvalue.float_min > src->minvalue.float_min)
+            dst->minvalue.float_min = src->minvalue.float_min;
+        if (dst->maxvalue.float_max < src->maxvalue.float_max)
+            dst->maxvalue.float_max = src->maxvalue.float_max;
+        break;
+    }
+    dst->st_flags |= src->st_flags;
+
+    /* bursts can't be summed, keep the highest one */
+    if (src->max_burst > dst->max_burst) {
+        dst->max_burst = src->max_burst;
+        dst->burst_time = src->burst_time;
+    }
+
+    for (src_child = src->children; src_child; src_child = src_child->next) {
+        dst_child = stats_tree_find_child(dst, src_child->name);
+
+        if (dst_child == NULL) {
+            if (dst->id < 0)
+                continue;
+
+            dst_child = new_stat_node(st, src_child->name, dst->id, src_child->datatype,
+                                      src_child->hash != NULL, src_child->id >= 0);
+            if (src_child->rng)
+                dst_child->rng = (range_pair_t *)g_memdup2(src_child->rng, sizeof(range_pair_t));
+        }
+
+        merge_stat_node(st, dst_child, src_child);
+    }
+}
+
+/* adds the counters of src, a tree of the same cfg filled from another
+   part of the capture, into dst */
+extern void
+stats_tree_merge(stats_tree *dst, const stats_tree *src)
+{
+    ws_assert(dst->cfg == src->cfg);
+
+    if (src->start >= 0.0) {
+        if (dst->start < 0.0 || src->start < dst->start)
+            dst->start = src->start;
+        if (src->now > dst->now)
+            dst->now = src->now;
+        dst->elapsed = dst->now - dst->start;
+    }
+
+    merge_stat_node(dst, &dst->root, &src->root);
+}
+
 /* Internal function to update the burst calculation data - add entry to bucket */
 static void
 update_burst_calc(stat_node *node, gint value)
@@ -189,6 +189,10 @@ WS_DLL_PUBLIC void stats_tree_reinit(void *p_st);
 /* callback for destoy */
 WS_DLL_PUBLIC void stats_tree_free(stats_tree *st);
 
+/** adds the counters of src into dst; both trees must have been created
+ *  from the same cfg, e.g. for different parts of a capture */
+WS_DLL_PUBLIC void stats_tree_merge(stats_tree *dst, const stats_tree *src);
+
 /** given an ws_optarg splits the abbr part
    and returns a newly allocated buffer containing it */
 WS_DLL_PUBLIC gchar *stats_tree_get_abbr(const gchar *ws_optarg);
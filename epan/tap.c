@@ -80,12 +80,16 @@ static guint tap_packet_index;
 
 typedef struct _tap_listener_t {
 	struct _tap_listener_t *next;
+	struct _tap_listener_t *next_in_tap;	/* next listener with the same tap_id */
+	struct _tap_listener_t *filter_leader;	/* first listener with the same fstring */
 	int tap_id;
 	gboolean needs_redraw;
 	gboolean failed;
 	guint flags;
 	gchar *fstring;
 	dfilter_t *code;
+	guint filter_seq;	/* tap_push_seq value filter_passed is valid for */
+	gboolean filter_passed;	/* only valid for a filter leader */
 	void *tapdata;
 	tap_reset_cb reset;
 	tap_packet_cb packet;
@@ -95,6 +99,17 @@ typedef struct _tap_listener_t {
 
 static tap_listener_t *tap_listener_queue=NULL;
 
+/* The listeners of tap_listener_queue bucketed by tap_id, each bucket
+   chained through next_in_tap in queue order. Rebuilt lazily whenever
+   the set of listeners or their filters change. */
+static tap_listener_t **tap_listeners_by_id=NULL;
+static int tap_listeners_by_id_len;
+static gboolean tap_listener_index_valid=FALSE;
+
+/* Incremented for every tap_push_tapped_queue() call, used to reuse filter
+   results within one dissected packet. */
+static guint tap_push_seq;
+
 static GSList *tap_plugins = NULL;
 
 #ifdef HAVE_PLUGINS
@@ -278,6 +293,68 @@ void tap_build_interesting (epan_dissect_t *edt)
 	}
 }
 
+static void
+tap_listener_index_build(void)
+{
+	tap_listener_t *tl, *other;
+	tap_listener_t **tails;
+	int max_id=0;
+
+	for(tl=tap_listener_queue;tl;tl=tl->next){
+		if(tl->tap_id>max_id){
+			max_id=tl->tap_id;
+		}
+	}
+
+	g_free(tap_listeners_by_id);
+	tap_listeners_by_id_len=max_id+1;
+	tap_listeners_by_id=g_new0(tap_listener_t *, tap_listeners_by_id_len);
+	tails=g_new0(tap_listener_t *, tap_listeners_by_id_len);
+
+	for(tl=tap_listener_queue;tl;tl=tl->next){
+		tl->next_in_tap=NULL;
+		if(tails[tl->tap_id]){
+			tails[tl->tap_id]->next_in_tap=tl;
+		} else {
+			tap_listeners_by_id[tl->tap_id]=tl;
+		}
+		tails[tl->tap_id]=tl;
+
+		/* Listeners with the same filter string share one evaluation */
+		tl->filter_leader=tl;
+		if(tl->code){
+			for(other=tap_listener_queue;other!=tl;other=other->next){
+				if(other->code && !strcmp(other->fstring, tl->fstring)){
+					tl->filter_leader=other->filter_leader;
+					break;
+				}
+			}
+		}
+		tl->filter_seq=0;
+	}
+
+	g_free(tails);
+	tap_listener_index_valid=TRUE;
+}
+
+/* Returns whether the packet in edt passes the filter of the listener.
+ * The filter result doesn't change while the tapped queue of one packet is
+ * pushed, so evaluate it only once per filter string and share the result
+ * between all listeners using it.
+ */
+static gboolean
+tap_listener_filter_passed(tap_listener_t *tl, epan_dissect_t *edt)
+{
+	tap_listener_t *leader=tl->filter_leader;
+
+	if(leader->filter_seq!=tap_push_seq){
+		leader->filter_passed=dfilter_apply_edt(leader->code, edt);
+		leader->filter_seq=tap_push_seq;
+	}
+
+	return leader->filter_passed;
+}
+
 /* This function is used to delete/initialize the tap queue and prime an
    epan_dissect_t with all the filters for tap listeners.
    To free the tap queue, we just prepend the used queue to the free queue.
@@ -319,65 +396,75 @@ tap_push_tapped_queue(epan_dissect_t *edt)
 		return;
 	}
 
-	/* loop over all tap listeners and call the listener callback
-	   for all packets that match the filter. */
+	/* 0 is the initial value of filter_seq, never use it */
+	if(++tap_push_seq==0){
+		tap_push_seq=1;
+	}
+
+	if(!tap_listener_index_valid){
+		tap_listener_index_build();
+	}
+
+	/* loop over the tap listeners of each queued packet's tap and call
+	   the listener callback for all packets that match the filter. */
 	for(i=0;i<tap_packet_index;i++){
-		for(tl=tap_listener_queue;tl;tl=tl->next){
-			tp=&tap_packet_array[i];
+		tp=&tap_packet_array[i];
+		if(tp->tap_id<=0 || tp->tap_id>=tap_listeners_by_id_len){
+			continue;
+		}
+		for(tl=tap_listeners_by_id[tp->tap_id];tl;tl=tl->next_in_tap){
 			/* Don't tap the packet if it's an "error packet"
 			 * unless the listener has requested that we do so.
 			 */
 			if (!(tp->flags & TAP_PACKET_IS_ERROR_PACKET) || (tl->flags & TL_REQUIRES_ERROR_PACKETS))
 			{
-				if(tp->tap_id==tl->tap_id){
-					if(!tl->packet){
-						/* There isn't a per-packet
-						 * routine for this tap.
-						 */
-						continue;
-					}
-					if(tl->failed){
-						/* A previous call failed,
-						 * meaning "stop running this
-						 * tap", so don't call the
-						 * packet routine.
-						 */
-						continue;
-					}
-
-					/* If we have a filter, see if the
-					 * packet passes.
+				if(!tl->packet){
+					/* There isn't a per-packet
+					 * routine for this tap.
 					 */
-					guint flags = tl->flags;
-					if(tl->code){
-						if (!dfilter_apply_edt(tl->code, edt)){
-							/* The packet didn't
-							 * pass the filter. */
-							if (tl->flags & TL_IGNORE_DISPLAY_FILTER)
-								flags |= TL_DISPLAY_FILTER_IGNORED;
-							else
-								continue;
-						}
+					continue;
+				}
+				if(tl->failed){
+					/* A previous call failed,
+					 * meaning "stop running this
+					 * tap", so don't call the
+					 * packet routine.
+					 */
+					continue;
+				}
+
+				/* If we have a filter, see if the
+				 * packet passes.
+				 */
+				guint flags = tl->flags;
+				if(tl->code){
+					if (!tap_listener_filter_passed(tl, edt)){
+						/* The packet didn't
+						 * pass the filter. */
+						if (tl->flags & TL_IGNORE_DISPLAY_FILTER)
+							flags |= TL_DISPLAY_FILTER_IGNORED;
+						else
+							continue;
 					}
+				}
 
-					/* So call the per-packet routine. */
-					tap_packet_status status;
+				/* So call the per-packet routine. */
+				tap_packet_status status;
 
-					status = tl->packet(tl->tapdata, tp->pinfo, edt, tp->tap_specific_data, flags);
+				status = tl->packet(tl->tapdata, tp->pinfo, edt, tp->tap_specific_data, flags);
 
-					switch (status) {
+				switch (status) {
 
-					case TAP_PACKET_DONT_REDRAW:
-						break;
+				case TAP_PACKET_DONT_REDRAW:
+					break;
 
-					case TAP_PACKET_REDRAW:
-						tl->needs_redraw=TRUE;
-						break;
+				case TAP_PACKET_REDRAW:
+					tl->needs_redraw=TRUE;
+					break;
 
-					case TAP_PACKET_FAILED:
-						tl->failed=TRUE;
-						break;
-					}
+				case TAP_PACKET_FAILED:
+					tl->failed=TRUE;
+					break;
 				}
 			}
 		}
@@ -577,6 +664,7 @@ register_tap_listener(const char *tapname, void *tapdata, const char *fstring,
 	tl->next=tap_listener_queue;
 
 	tap_listener_queue=tl;
+	tap_listener_index_valid=FALSE;
 
 	return NULL;
 }
@@ -608,6 +696,8 @@ set_tap_dfilter(void *tapdata, const char *fstring)
 	}
 
 	if(tl){
+		/* The filter leaders may change */
+		tap_listener_index_valid=FALSE;
 		if(tl->code){
 			dfilter_free(tl->code);
 			tl->code=NULL;
@@ -685,6 +775,7 @@ remove_tap_listener(void *tapdata)
 			return;
 		}
 	}
+	tap_listener_index_valid=FALSE;
 	free_tap_listener(tl);
 }
 
@@ -712,16 +803,27 @@ tap_listeners_require_dissection(void)
 gboolean
 have_tap_listener(int tap_id)
 {
-	tap_listener_t *tap_queue = tap_listener_queue;
+	if(!tap_listener_index_valid){
+		tap_listener_index_build();
+	}
 
-	while(tap_queue) {
-		if(tap_queue->tap_id == tap_id)
-			return TRUE;
+	return tap_id > 0 && tap_id < tap_listeners_by_id_len &&
+	    tap_listeners_by_id[tap_id] != NULL;
+}
 
-		tap_queue = tap_queue->next;
-	}
+/*
+ * Return the number of registered tap listeners.
+ */
+guint
+num_tap_listeners(void)
+{
+	tap_listener_t *tl;
+	guint count = 0;
 
-	return FALSE;
+	for(tl=tap_listener_queue;tl;tl=tl->next){
+		count++;
+	}
+	return count;
 }
 
 /*
@@ -780,6 +882,10 @@ void tap_cleanup(void)
 		free_tap_listener(elem_lq);
 	}
 	tap_listener_queue = NULL;
+	g_free(tap_listeners_by_id);
+	tap_listeners_by_id = NULL;
+	tap_listeners_by_id_len = 0;
+	tap_listener_index_valid = FALSE;
 
 	while(head_dl){
 		elem_dl = head_dl;
@@ -251,6 +251,9 @@ WS_DLL_PUBLIC gboolean tap_listeners_require_dissection(void);
 /** Returns TRUE there is an active tap listener for the specified tap id. */
 WS_DLL_PUBLIC gboolean have_tap_listener(int tap_id);
 
+/** Return the number of registered tap listeners. */
+WS_DLL_PUBLIC guint num_tap_listeners(void);
+
 /** Return TRUE if we have any tap listeners with filters, FALSE otherwise. */
 WS_DLL_PUBLIC gboolean have_filtering_tap_listeners(void);
 
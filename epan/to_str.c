@@ -20,6 +20,7 @@
 #include "to_str.h"
 #include "strutil.h"
 #include <wsutil/pint.h>
+#include <wsutil/time_util.h>
 #include <wsutil/utf8_entities.h>
 
 /*
@@ -46,7 +47,7 @@ static const char mon_names[12][4] = {
 };
 
 static const gchar *
-get_zonename(struct tm *tmp)
+get_zonename(const struct tm *tmp)
 {
 #if defined(_WIN32)
 	/*
@@ -93,16 +94,16 @@ get_zonename(struct tm *tmp)
 #endif /* _WIN32 */
 }
 
-static struct tm *
+static const struct tm *
 get_fmt_broken_down_time(field_display_e fmt, const time_t *secs)
 {
 	switch (fmt) {
 		case ABSOLUTE_TIME_UTC:
 		case ABSOLUTE_TIME_DOY_UTC:
 		case ABSOLUTE_TIME_NTP_UTC:
-			return gmtime(secs);
+			return ws_gmtime_cached(*secs);
 		case ABSOLUTE_TIME_LOCAL:
-			return localtime(secs);
+			return ws_localtime_cached(*secs);
 		default:
 			break;
 	}
@@ -111,7 +112,7 @@ get_fmt_broken_down_time(field_display_e fmt, const time_t *secs)
 
 static char *
 snprint_abs_time_secs(wmem_allocator_t *scope,
-				field_display_e fmt, struct tm *tmp,
+				field_display_e fmt, const struct tm *tmp,
 				const char *nsecs_str, const char *tzone_sep,
 				const char *tzone_str, gboolean add_quotes)
 {
@@ -159,7 +160,7 @@ char *
 abs_time_to_str_ex(wmem_allocator_t *scope, const nstime_t *abs_time, field_display_e fmt,
 			int flags)
 {
-	struct tm *tmp;
+	const struct tm *tmp;
 	char buf_nsecs[32];
 	const char *tzone_sep, *tzone_str;
 
@@ -59,6 +59,7 @@ tvb_uncompress_brotli(tvbuff_t *tvb, const int offset, int comprlen)
     size_t               available_out;
     guint8              *next_out;
     size_t               total_out;
+    size_t               uncompr_size   = 0;
     guint                needs_more_output;
     guint                finished;
 
@@ -129,7 +130,14 @@ tvb_uncompress_brotli(tvbuff_t *tvb, const int offset, int comprlen)
          */
         size_t pass_out = bufsiz - available_out;
         if (pass_out > 0) {
-            uncompr = (guint8 *)g_realloc(uncompr, total_out);
+            if (total_out > uncompr_size) {
+                /*
+                 * Grow geometrically so that large bodies aren't copied
+                 * on every pass; the slack is trimmed below.
+                 */
+                uncompr_size = MAX(uncompr_size * 2, total_out);
+                uncompr = (guint8 *)g_realloc(uncompr, uncompr_size);
+            }
             memcpy(uncompr + (total_out - pass_out), strmbuf, pass_out);
         }
     }
@@ -144,6 +152,8 @@ tvb_uncompress_brotli(tvbuff_t *tvb, const int offset, int comprlen)
         } else {
             goto cleanup;
         }
+    } else if (uncompr_size > total_out) {
+        uncompr = (guint8 *)g_realloc(uncompr, total_out);
     }
 
     uncompr_tvb = tvb_new_real_data((guint8 *)uncompr, (guint)total_out, (gint)total_out);
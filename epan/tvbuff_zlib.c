@@ -41,6 +41,7 @@ tvb_uncompress(tvbuff_t *tvb, const int offset, int comprlen)
 	guint      bytes_out      = 0;
 	guint8    *compr;
 	guint8    *uncompr        = NULL;
+	guint      uncompr_size   = 0;
 	tvbuff_t  *uncompr_tvb    = NULL;
 	z_streamp  strm;
 	Bytef     *strmbuf;
@@ -90,7 +91,6 @@ tvb_uncompress(tvbuff_t *tvb, const int offset, int comprlen)
 	}
 
 	while (1) {
-		memset(strmbuf, '\0', bufsiz);
 		strm->next_out  = strmbuf;
 		strm->avail_out = bufsiz;
 
@@ -113,8 +113,18 @@ tvb_uncompress(tvbuff_t *tvb, const int offset, int comprlen)
 				uncompr = (guint8 *)((bytes_pass || err != Z_STREAM_END) ?
 						g_memdup2(strmbuf, bytes_pass) :
 						g_strdup(""));
+				uncompr_size = bytes_pass ? bytes_pass : 1;
 			} else {
-				uncompr = (guint8 *)g_realloc(uncompr, bytes_out + bytes_pass);
+				if (bytes_out + bytes_pass > uncompr_size) {
+					/*
+					 * Grow geometrically, so that large
+					 * bodies aren't reallocated and copied
+					 * on every pass; the slack is trimmed
+					 * at the end.
+					 */
+					uncompr_size = MAX(uncompr_size * 2, bytes_out + bytes_pass);
+					uncompr = (guint8 *)g_realloc(uncompr, uncompr_size);
+				}
 				memcpy(uncompr + bytes_out, strmbuf, bytes_pass);
 			}
 
@@ -295,6 +305,8 @@ tvb_uncompress(tvbuff_t *tvb, const int offset, int comprlen)
 	ws_debug("bytes  in: %u\nbytes out: %u\n\n", bytes_in, bytes_out);
 
 	if (uncompr != NULL) {
+		if (bytes_out > 0 && uncompr_size > bytes_out)
+			uncompr = (guint8 *)g_realloc(uncompr, bytes_out);
 		uncompr_tvb =  tvb_new_real_data(uncompr, bytes_out, bytes_out);
 		tvb_set_free_cb(uncompr_tvb, g_free);
 	}
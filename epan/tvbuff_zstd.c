@@ -39,6 +39,7 @@ tvbuff_t *tvb_uncompress_zstd(tvbuff_t *tvb, const int offset, int comprlen)
     size_t rc = 0;
     uint8_t *uncompr = NULL;
     size_t uncompr_len = 0;
+    size_t uncompr_size = 0;
     bool ok = false;
     int count = 0;
 
@@ -55,12 +56,12 @@ tvbuff_t *tvb_uncompress_zstd(tvbuff_t *tvb, const int offset, int comprlen)
 
         if (output.pos > 0)
         {
-            if (!uncompr)
+            if (uncompr_len + output.pos > uncompr_size)
             {
-                DISSECTOR_ASSERT (uncompr_len == 0);
-                uncompr = g_malloc(output.pos);
-            } else {
-                uncompr = g_realloc(uncompr, uncompr_len + output.pos);
+                // Grow geometrically so that large bodies aren't copied on
+                // every pass; the slack is trimmed at the end.
+                uncompr_size = MAX(uncompr_size * 2, uncompr_len + output.pos);
+                uncompr = g_realloc(uncompr, uncompr_size);
             }
             memcpy (uncompr + uncompr_len, output.dst, output.pos);
             uncompr_len += output.pos;
@@ -84,6 +85,10 @@ end:
     if (ok)
     {
         tvbuff_t *uncompr_tvb;
+        if (uncompr_len > 0 && uncompr_size > uncompr_len)
+        {
+            uncompr = g_realloc(uncompr, uncompr_len);
+        }
         uncompr_tvb = tvb_new_real_data (uncompr, (guint)uncompr_len, (guint)uncompr_len);
         tvb_set_free_cb (uncompr_tvb, g_free);
         return uncompr_tvb;
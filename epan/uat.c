@@ -97,6 +97,8 @@ uat_t* uat_new(const char* name,
     uat->help = g_strdup(help);
     uat->flags = flags;
 
+    ws_assert(!((flags & UAT_LOAD_ON_DEMAND) && (flags & UAT_AFFECTS_FIELDS)));
+
     for (i=0;flds_array[i].title;i++) {
         fld_data_t* f = g_new(fld_data_t, 1);
 
@@ -259,6 +261,8 @@ uat_t* uat_get_table_by_name(const char* name) {
     for (i=0; i < all_uats->len; i++) {
         uat_t* u = (uat_t *)g_ptr_array_index(all_uats,i);
         if ( g_str_equal(u->name,name) ) {
+            /* The caller will probably look at the records. */
+            uat_ensure_loaded(u);
             return (u);
         }
     }
@@ -529,6 +533,22 @@ void uat_foreach_table(uat_cb_t cb,void* user_data) {
 
 }
 
+void uat_ensure_loaded(uat_t* uat) {
+    gchar* err = NULL;
+
+    if (G_LIKELY(uat->loaded))
+        return;
+
+    if (!uat_load(uat, NULL, &err)) {
+        report_failure("Error loading table '%s': %s",uat->name,err);
+        g_free(err);
+    }
+
+    /* uat_load() only sets this if it read a file. Set it anyway, so
+     * that a missing or broken file isn't looked for on every call. */
+    uat->loaded = TRUE;
+}
+
 void uat_load_all(void) {
     guint i;
     gchar* err;
@@ -536,6 +556,9 @@ void uat_load_all(void) {
     for (i=0; i < all_uats->len; i++) {
         uat_t* u = (uat_t *)g_ptr_array_index(all_uats,i);
 
+        if (u->flags & UAT_LOAD_ON_DEMAND)
+            continue;
+
         if (!u->loaded) {
             err = NULL;
             if (!uat_load(u, NULL, &err)) {
@@ -259,9 +259,16 @@ typedef struct _uat_field_t {
  * UAT_AFFECTS_FIELDS does *not* trigger a redissection, so usually one
  * will also want UAT_AFFECTS_DISSECTION. A rare exception is changing
  * the defined dfilter macros.
+ *
+ * UAT_LOAD_ON_DEMAND keeps the table from being loaded at startup, for
+ * tables that can get large. The owning dissector must call
+ * uat_ensure_loaded() before using the records; until then they are
+ * empty. It can't be combined with UAT_AFFECTS_FIELDS, since fields must
+ * exist before any filter is compiled.
  */
 #define UAT_AFFECTS_DISSECTION	0x00000001	/* affects packet dissection */
 #define UAT_AFFECTS_FIELDS	0x00000002	/* affects what named fields exist */
+#define UAT_LOAD_ON_DEMAND	0x00000004	/* loaded on first use, not at startup */
 
 /** Create a new UAT.
  *
@@ -314,6 +321,17 @@ void uat_cleanup(void);
 WS_DLL_PUBLIC
 gboolean uat_load(uat_t* uat_in, const gchar *filename, char** err);
 
+/** Load a UAT from its file if that hasn't been done yet. Errors are
+ * reported with report_failure(), once.
+ *
+ * This is cheap once the UAT is loaded, so dissectors of UATs created
+ * with UAT_LOAD_ON_DEMAND can call it for every packet.
+ *
+ * @param uat_in Pointer to a uat. Must not be NULL.
+ */
+WS_DLL_PUBLIC
+void uat_ensure_loaded(uat_t* uat_in);
+
 /** Create or update a single UAT entry using a string.
  *
  * @param uat_in Pointer to a uat. Must not be NULL.
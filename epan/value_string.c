@@ -281,6 +281,7 @@ value_string_ext_new(const value_string *vs, guint vs_tot_num_entries,
     vse->_vs_first_value = 0;
     vse->_vs_match2      = _try_val_to_str_ext_init;
     vse->_vs_name        = vs_name;
+    vse->_vs_dense       = NULL;
 
     return vse;
 }
@@ -288,6 +289,7 @@ value_string_ext_new(const value_string *vs, guint vs_tot_num_entries,
 void
 value_string_ext_free(value_string_ext *vse)
 {
+    g_free(vse->_vs_dense);
     wmem_free(wmem_epan_scope(), vse);
 }
 
@@ -414,6 +416,23 @@ _try_val_to_str_bsearch(const guint32 val, value_string_ext *vse)
     return NULL;
 }
 
+/* Constant-time matching algorithm for sorted extended value strings whose
+ * values only have small gaps */
+static const value_string *
+_try_val_to_str_dense(const guint32 val, value_string_ext *vse)
+{
+    guint32 i;
+
+    i = val - vse->_vs_first_value;
+    if (i <= vse->_vs_p[vse->_vs_num_entries - 1].value - vse->_vs_first_value) {
+        return vse->_vs_dense[i];
+    }
+    return NULL;
+}
+
+/* Use a dense table if it has at most this many slots per entry */
+#define VS_DENSE_MAX_SLOTS_PER_ENTRY 2
+
 /* Initializes an extended value string. Behaves like a match function to
  * permit lazy initialization of extended value strings.
  * - Goes through the value_string array to determine the fastest possible
@@ -431,8 +450,10 @@ _try_val_to_str_ext_init(const guint32 val, value_string_ext *vse)
      * VS_SEARCH   - slow sequential search (as in a normal value string)
      * VS_BIN_TREE - log(n)-time binary search, the values must be sorted
      * VS_INDEX    - constant-time index lookup, the values must be contiguous
+     * VS_DENSE    - constant-time table lookup, the values must be sorted and
+     *               only have small gaps
      */
-    enum { VS_SEARCH, VS_BIN_TREE, VS_INDEX } type = VS_INDEX;
+    enum { VS_SEARCH, VS_BIN_TREE, VS_INDEX, VS_DENSE } type = VS_INDEX;
 
     /* Note: The value_string 'value' is *unsigned*, but we do a little magic
      * to help with value strings that have negative values.
@@ -490,6 +511,19 @@ _try_val_to_str_ext_init(const guint32 val, value_string_ext *vse)
         prev_value = vs_p[i].value;
     }
 
+    if (type == VS_BIN_TREE &&
+            (guint64)prev_value - first_value < (guint64)vs_num_entries * VS_DENSE_MAX_SLOTS_PER_ENTRY) {
+        guint32 span = prev_value - first_value + 1;
+
+        /* Fill backwards so that the first of duplicate values wins,
+         * as with a linear search. */
+        vse->_vs_dense = g_new0(const value_string *, span);
+        for (i = vs_num_entries; i-- > 0; ) {
+            vse->_vs_dense[vs_p[i].value - first_value] = &vs_p[i];
+        }
+        type = VS_DENSE;
+    }
+
     switch (type) {
         case VS_SEARCH:
             vse->_vs_match2 = _try_val_to_str_linear;
@@ -500,6 +534,9 @@ _try_val_to_str_ext_init(const guint32 val, value_string_ext *vse)
         case VS_INDEX:
             vse->_vs_match2 = _try_val_to_str_index;
             break;
+        case VS_DENSE:
+            vse->_vs_match2 = _try_val_to_str_dense;
+            break;
         default:
             ws_assert_not_reached();
             break;
@@ -1024,7 +1061,8 @@ value_string_ext_validate(const value_string_ext *vse)
     if ((vse->_vs_match2 != _try_val_to_str_ext_init) &&
         (vse->_vs_match2 != _try_val_to_str_linear)   &&
         (vse->_vs_match2 != _try_val_to_str_bsearch)  &&
-        (vse->_vs_match2 != _try_val_to_str_index))
+        (vse->_vs_match2 != _try_val_to_str_index)    &&
+        (vse->_vs_match2 != _try_val_to_str_dense))
         return FALSE;
 #endif
     return TRUE;
@@ -1041,6 +1079,8 @@ value_string_ext_match_type_str(const value_string_ext *vse)
         return "[Binary Search]";
     if (vse->_vs_match2 == _try_val_to_str_index)
         return "[Direct (indexed) Access]";
+    if (vse->_vs_match2 == _try_val_to_str_dense)
+        return "[Direct (table) Access]";
     return "[Invalid]";
 }
 
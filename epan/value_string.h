@@ -174,6 +174,8 @@ struct _value_string_ext {
                                             /*  (excluding final {0, NULL})                */
     const value_string    *_vs_p;           /* the value string array address              */
     const gchar           *_vs_name;        /* vse "Name" (for error messages)             */
+    const value_string   **_vs_dense;       /* lookup table indexed by value - first value */
+                                            /*  (for sorted arrays with small gaps)        */
 };
 
 #define VALUE_STRING_EXT_VS_P(x)           (x)->_vs_p
@@ -183,7 +185,7 @@ struct _value_string_ext {
 WS_DLL_PUBLIC
 const value_string *
 _try_val_to_str_ext_init(const guint32 val, value_string_ext *vse);
-#define VALUE_STRING_EXT_INIT(x) { _try_val_to_str_ext_init, 0, G_N_ELEMENTS(x)-1, x, #x }
+#define VALUE_STRING_EXT_INIT(x) { _try_val_to_str_ext_init, 0, G_N_ELEMENTS(x)-1, x, #x, NULL }
 
 WS_DLL_PUBLIC
 value_string_ext *
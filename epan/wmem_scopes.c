@@ -12,6 +12,7 @@
 #include <glib.h>
 
 #include "wmem_scopes.h"
+#include "app_mem_usage.h"
 
 #include <wsutil/ws_assert.h>
 
@@ -112,6 +113,49 @@ wmem_epan_scope(void)
     return epan_scope;
 }
 
+/* Memory Usage */
+
+static gsize
+scope_bytes_requested(wmem_allocator_t *scope, gboolean peak)
+{
+    wmem_allocator_stats_t stats;
+
+    if (scope == NULL)
+        return 0;
+
+    wmem_get_allocator_stats(scope, &stats);
+
+    return peak ? stats.peak_bytes_requested : stats.bytes_requested;
+}
+
+static gsize
+packet_scope_usage(void)
+{
+    /* The packet scope is emptied after every packet, so its current
+     * size says nothing; the largest packet is more interesting. */
+    return scope_bytes_requested(packet_scope, TRUE);
+}
+
+static gsize
+file_scope_usage(void)
+{
+    return scope_bytes_requested(file_scope, FALSE);
+}
+
+static gsize
+epan_scope_usage(void)
+{
+    return scope_bytes_requested(epan_scope, FALSE);
+}
+
+static const ws_mem_usage_t packet_scope_mem_usage = { "Packet scope (peak)", packet_scope_usage, NULL };
+static const ws_mem_usage_t file_scope_mem_usage = { "File scope", file_scope_usage, NULL };
+static const ws_mem_usage_t epan_scope_mem_usage = { "Epan scope", epan_scope_usage, NULL };
+
+/* The scopes can be set up again after wmem_cleanup_scopes(), but the memory
+ * usage components can't be unregistered. */
+static gboolean mem_usage_registered = FALSE;
+
 /* Scope Management */
 
 void
@@ -130,6 +174,13 @@ wmem_init_scopes(void)
     /* Scopes are initialized to TRUE by default on creation */
     wmem_leave_scope(packet_scope);
     wmem_leave_scope(file_scope);
+
+    if (!mem_usage_registered) {
+        memory_usage_component_register(&packet_scope_mem_usage);
+        memory_usage_component_register(&file_scope_mem_usage);
+        memory_usage_component_register(&epan_scope_mem_usage);
+        mem_usage_registered = TRUE;
+    }
 }
 
 void
@@ -196,12 +196,12 @@ static int File_read_line(lua_State *L, FILE_T ft) {
 }
 
 /* This internal function reads X number of bytes from the file, same as `io.read(num)` in Lua.
- * Since we have to use file_wrappers.c, and an intermediate buffer, we read it in chunks
- * of 1024 bytes at a time. (or less if called with a smaller number)  To do that, we use
- * Lua's buffer manager to push it into Lua as those chunks, while ending up with one long
- * Lua string in the end.
+ * Since we have to use file_wrappers.c, we read it in chunks, straight into the space handed
+ * out by Lua's buffer manager, while ending up with one long Lua string in the end. Lua 5.2
+ * and later let us ask for larger chunks than the fixed LUAL_BUFFERSIZE of Lua 5.1, so large
+ * records are read with few file_read() calls and no intermediate copy.
  */
-#define WSLUA_BUFFERSIZE 1024
+#define WSLUA_BUFFERSIZE (64 * 1024)
 
 /* Lua 5.1 used lua_objlen() instead of lua_rawlen() */
 #if LUA_VERSION_NUM == 501
@@ -216,18 +216,27 @@ static int File_read_chars(lua_State *L, FILE_T ft, size_t n) {
     size_t rlen;  /* how much to read */
     size_t nr;  /* number of chars actually read */
     int    nri; /* temp number of chars read, as an int to handle -1 errors */
-    gchar buff[WSLUA_BUFFERSIZE];  /* for file_read to write to, and we push into Lua */
+    char  *buff;  /* for file_read to write to, owned by the Lua buffer */
     luaL_Buffer b;
 
+#if LUA_VERSION_NUM >= 502
     rlen = WSLUA_BUFFERSIZE;  /* try to read that much each time */
+#else
+    rlen = LUAL_BUFFERSIZE;
+#endif
     luaL_buffinit(L, &b); /* initialize Lua buffer */
 
     do {
         if (rlen > n) rlen = n;  /* cannot read more than asked */
+#if LUA_VERSION_NUM >= 502
+        buff = luaL_prepbuffsize(&b, rlen);
+#else
+        buff = luaL_prepbuffer(&b);
+#endif
         nri = file_read(buff, (unsigned int)rlen, ft);
         if (nri < 1) break;
         nr = (size_t) nri;
-        luaL_addlstring(&b, buff, nr);
+        luaL_addsize(&b, nr);
         n -= nr;  /* still have to read `n' chars */
     } while (n > 0 && nr == rlen);  /* until end of count or eof */
 
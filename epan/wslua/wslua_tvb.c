@@ -219,6 +219,31 @@ WSLUA_METAMETHOD Tvb__call(lua_State* L) {
 #endif
 
 
+/*
+ * Push the 1-4 octet unsigned integer at offset. Shared by Tvb:uint() and
+ * TvbRange:uint() (and their little endian variants), with the range
+ * already checked by the caller.
+ */
+static int push_tvb_uint(lua_State* L, tvbuff_t* ws_tvb, int offset, int len, gboolean little_endian, const char* method) {
+    switch (len) {
+        case 1:
+            lua_pushnumber(L,tvb_get_guint8(ws_tvb,offset));
+            return 1;
+        case 2:
+            lua_pushnumber(L,little_endian ? tvb_get_letohs(ws_tvb,offset) : tvb_get_ntohs(ws_tvb,offset));
+            return 1;
+        case 3:
+            lua_pushnumber(L,little_endian ? tvb_get_letoh24(ws_tvb,offset) : tvb_get_ntoh24(ws_tvb,offset));
+            return 1;
+        case 4:
+            lua_pushnumber(L,little_endian ? tvb_get_letohl(ws_tvb,offset) : tvb_get_ntohl(ws_tvb,offset));
+            return 1;
+        default:
+            luaL_error(L,"%s does not handle %d byte integers",method,len);
+            return 0;
+    }
+}
+
 WSLUA_METHOD Tvb_range(lua_State* L) {
     /* Creates a <<lua_class_TvbRange,`TvbRange`>> from this <<lua_class_Tvb,`Tvb`>>. */
 #define WSLUA_OPTARG_Tvb_range_OFFSET 2 /* The offset (in octets) from the beginning of the <<lua_class_Tvb,`Tvb`>>. Defaults to 0. */
@@ -235,6 +260,48 @@ WSLUA_METHOD Tvb_range(lua_State* L) {
     return 0;
 }
 
+WSLUA_METHOD Tvb_uint(lua_State* L) {
+    /* Get a Big Endian (network order) unsigned integer from this <<lua_class_Tvb,`Tvb`>>.
+       This is equivalent to `tvb:range(offset, length):uint()`, without
+       creating the intermediate <<lua_class_TvbRange,`TvbRange`>>.
+
+       @since 4.1.0
+     */
+#define WSLUA_ARG_Tvb_uint_OFFSET 2 /* The offset (in octets) from the beginning of the <<lua_class_Tvb,`Tvb`>>. */
+#define WSLUA_ARG_Tvb_uint_LENGTH 3 /* The length (in octets) of the integer, 1-4. */
+    Tvb tvb = checkTvb(L,1);
+    int offset = (int) luaL_checkinteger(L,WSLUA_ARG_Tvb_uint_OFFSET);
+    int len = (int) luaL_checkinteger(L,WSLUA_ARG_Tvb_uint_LENGTH);
+
+    if (offset < 0 || len < 0 || !tvb_bytes_exist(tvb->ws_tvb,offset,len)) {
+        luaL_error(L,"Range is out of bounds");
+        return 0;
+    }
+
+    WSLUA_RETURN(push_tvb_uint(L,tvb->ws_tvb,offset,len,FALSE,"Tvb:uint()")); /* The unsigned integer value. */
+}
+
+WSLUA_METHOD Tvb_le_uint(lua_State* L) {
+    /* Get a Little Endian unsigned integer from this <<lua_class_Tvb,`Tvb`>>.
+       This is equivalent to `tvb:range(offset, length):le_uint()`, without
+       creating the intermediate <<lua_class_TvbRange,`TvbRange`>>.
+
+       @since 4.1.0
+     */
+#define WSLUA_ARG_Tvb_le_uint_OFFSET 2 /* The offset (in octets) from the beginning of the <<lua_class_Tvb,`Tvb`>>. */
+#define WSLUA_ARG_Tvb_le_uint_LENGTH 3 /* The length (in octets) of the integer, 1-4. */
+    Tvb tvb = checkTvb(L,1);
+    int offset = (int) luaL_checkinteger(L,WSLUA_ARG_Tvb_le_uint_OFFSET);
+    int len = (int) luaL_checkinteger(L,WSLUA_ARG_Tvb_le_uint_LENGTH);
+
+    if (offset < 0 || len < 0 || !tvb_bytes_exist(tvb->ws_tvb,offset,len)) {
+        luaL_error(L,"Range is out of bounds");
+        return 0;
+    }
+
+    WSLUA_RETURN(push_tvb_uint(L,tvb->ws_tvb,offset,len,TRUE,"Tvb:le_uint()")); /* The unsigned integer value. */
+}
+
 WSLUA_METHOD Tvb_raw(lua_State* L) {
     /* Obtain a Lua string of the binary bytes in a <<lua_class_Tvb,`Tvb`>>.
 
@@ -308,6 +375,8 @@ WSLUA_METAMETHOD Tvb__eq(lua_State* L) {
 WSLUA_METHODS Tvb_methods[] = {
     WSLUA_CLASS_FNREG(Tvb,bytes),
     WSLUA_CLASS_FNREG(Tvb,range),
+    WSLUA_CLASS_FNREG(Tvb,uint),
+    WSLUA_CLASS_FNREG(Tvb,le_uint),
     WSLUA_CLASS_FNREG(Tvb,offset),
     WSLUA_CLASS_FNREG(Tvb,reported_len),
     WSLUA_CLASS_FNREG(Tvb,reported_length_remaining),
@@ -342,13 +411,21 @@ WSLUA_CLASS_DEFINE(TvbRange,FAIL_ON_NULL("TvbRange"));
     If the <<lua_class_TvbRange,`TvbRange`>> span is outside the <<lua_class_Tvb,`Tvb`>>'s range the creation will cause a runtime error.
     */
 
+/*
+ * push_TvbRange() allocates a TvbRange and the Tvb it refers to as one
+ * block, since scripts tend to create lots of short lived ranges.
+ */
+typedef struct _wslua_tvbrange_block {
+    struct _wslua_tvbrange tvbr;
+    struct _wslua_tvb tvb;
+} wslua_tvbrange_block;
+
 static void free_TvbRange(TvbRange tvbr) {
     if (!(tvbr && tvbr->tvb)) return;
 
     if (!tvbr->tvb->expired) {
         tvbr->tvb->expired = TRUE;
     } else {
-        free_Tvb(tvbr->tvb);
         g_free(tvbr);
     }
 }
@@ -362,6 +439,7 @@ void clear_outstanding_TvbRange(void) {
 
 
 gboolean push_TvbRange(lua_State* L, tvbuff_t* ws_tvb, int offset, int len) {
+    wslua_tvbrange_block *block;
     TvbRange tvbr;
 
     if (!ws_tvb) {
@@ -383,8 +461,9 @@ gboolean push_TvbRange(lua_State* L, tvbuff_t* ws_tvb, int offset, int len) {
         return FALSE;
     }
 
-    tvbr = (TvbRange)g_malloc(sizeof(struct _wslua_tvbrange));
-    tvbr->tvb = (Tvb)g_malloc(sizeof(struct _wslua_tvb));
+    block = g_new(wslua_tvbrange_block, 1);
+    tvbr = &block->tvbr;
+    tvbr->tvb = &block->tvb;
     tvbr->tvb->ws_tvb = ws_tvb;
     tvbr->tvb->expired = FALSE;
     tvbr->tvb->need_free = FALSE;
@@ -435,23 +514,7 @@ WSLUA_METHOD TvbRange_uint(lua_State* L) {
         return 0;
     }
 
-    switch (tvbr->len) {
-        case 1:
-            lua_pushnumber(L,tvb_get_guint8(tvbr->tvb->ws_tvb,tvbr->offset));
-            return 1;
-        case 2:
-            lua_pushnumber(L,tvb_get_ntohs(tvbr->tvb->ws_tvb,tvbr->offset));
-            return 1;
-        case 3:
-            lua_pushnumber(L,tvb_get_ntoh24(tvbr->tvb->ws_tvb,tvbr->offset));
-            return 1;
-        case 4:
-            lua_pushnumber(L,tvb_get_ntohl(tvbr->tvb->ws_tvb,tvbr->offset));
-            WSLUA_RETURN(1); /* The unsigned integer value. */
-        default:
-            luaL_error(L,"TvbRange:uint() does not handle %d byte integers",tvbr->len);
-            return 0;
-    }
+    WSLUA_RETURN(push_tvb_uint(L,tvbr->tvb->ws_tvb,tvbr->offset,tvbr->len,FALSE,"TvbRange:uint()")); /* The unsigned integer value. */
 }
 
 /*
@@ -467,24 +530,7 @@ WSLUA_METHOD TvbRange_le_uint(lua_State* L) {
         return 0;
     }
 
-    switch (tvbr->len) {
-        case 1:
-            /* XXX unsigned anyway */
-            lua_pushnumber(L,(lua_Number)(guint)tvb_get_guint8(tvbr->tvb->ws_tvb,tvbr->offset));
-            return 1;
-        case 2:
-            lua_pushnumber(L,tvb_get_letohs(tvbr->tvb->ws_tvb,tvbr->offset));
-            return 1;
-        case 3:
-            lua_pushnumber(L,tvb_get_letoh24(tvbr->tvb->ws_tvb,tvbr->offset));
-            return 1;
-        case 4:
-            lua_pushnumber(L,tvb_get_letohl(tvbr->tvb->ws_tvb,tvbr->offset));
-            WSLUA_RETURN(1); /* The unsigned integer value */
-        default:
-            luaL_error(L,"TvbRange:le_uint() does not handle %d byte integers",tvbr->len);
-            return 0;
-    }
+    WSLUA_RETURN(push_tvb_uint(L,tvbr->tvb->ws_tvb,tvbr->offset,tvbr->len,TRUE,"TvbRange:le_uint()")); /* The unsigned integer value. */
 }
 
 /*
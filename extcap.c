@@ -84,6 +84,14 @@ static GHashTable *_toolbars = NULL;
  */
 static GHashTable *_extcap_prefs_dynamic_vals = NULL;
 
+/* Discovery results of the last run are cached in the personal configuration
+ * directory, so that interfaces can be listed right away at startup. This
+ * thread refreshes the cache after it has been used.
+ */
+#define EXTCAP_CACHE_FILE "extcap_cache"
+#define EXTCAP_CACHE_GROUP "Wireshark"
+static GThread *_cache_refresh_thread = NULL;
+
 typedef struct _extcap_callback_info_t
 {
     const gchar * extcap;
@@ -135,6 +143,7 @@ typedef struct extcap_run_extcaps_info {
 
 
 static void extcap_load_interface_list(void);
+static void extcap_cache_refresh_wait(void);
 
 /* Used for lazily loading our interfaces. */
 static void extcap_ensure_all_interfaces_loaded(void) {
@@ -746,6 +755,8 @@ void extcap_register_preferences(void)
  */
 void extcap_cleanup(void)
 {
+    extcap_cache_refresh_wait();
+
     if (_extcap_prefs_dynamic_vals)
         g_hash_table_destroy(_extcap_prefs_dynamic_vals);
 
@@ -2134,6 +2145,250 @@ extcap_list_interfaces_cb(thread_pool_t *pool, void *data, char *output)
 }
 
 
+/*
+ * Runs --extcap-interfaces (and --extcap-config for each discovered
+ * interface) for every extcap program. Safe to call from any thread.
+ */
+static extcap_run_extcaps_info_t *
+extcap_run_discovery(guint *count)
+{
+    int major = 0;
+    int minor = 0;
+    extcap_run_extcaps_info_t *infos;
+
+    get_ws_version_number(&major, &minor, NULL);
+    char *arg_version = ws_strdup_printf("%s=%d.%d", EXTCAP_ARGUMENT_VERSION, major, minor);
+    const char *argv[] = {
+        EXTCAP_ARGUMENT_LIST_INTERFACES,
+        arg_version,
+        NULL
+    };
+    infos = (extcap_run_extcaps_info_t *)extcap_run_all(argv,
+            extcap_list_interfaces_cb, sizeof(extcap_run_extcaps_info_t),
+            count);
+    g_free(arg_version);
+    return infos;
+}
+
+static char *
+extcap_cache_version(void)
+{
+    int major = 0;
+    int minor = 0;
+    int micro = 0;
+
+    get_ws_version_number(&major, &minor, &micro);
+    return ws_strdup_printf("%d.%d.%d", major, minor, micro);
+}
+
+static gboolean
+extcap_cache_stat(const char *extcap_path, gint64 *mtime, gint64 *size)
+{
+    ws_statb64 st;
+
+    if (ws_stat64(extcap_path, &st) != 0) {
+        return FALSE;
+    }
+    *mtime = (gint64)st.st_mtime;
+    *size = (gint64)st.st_size;
+    return TRUE;
+}
+
+/*
+ * Loads the discovery results of a previous run from the cache file. The
+ * cache is only used if it was written by this version and if it has an
+ * entry for every extcap program we find now, with the same modification
+ * time and size.
+ *
+ * @param [OUT] count Size of the returned array.
+ * @return Array of information as returned by extcap_run_discovery(), or
+ * NULL if the cache cannot be used.
+ */
+static extcap_run_extcaps_info_t *
+extcap_cache_load(guint *count)
+{
+    char *cache_path = get_persconffile_path(EXTCAP_CACHE_FILE, FALSE);
+    GKeyFile *key_file = g_key_file_new();
+    extcap_run_extcaps_info_t *infos = NULL;
+    GSList *paths = NULL;
+    gsize num_groups = 0;
+    gchar **groups = NULL;
+    char *version = NULL;
+    char *cached_version = NULL;
+    guint paths_count;
+    guint i;
+
+    if (!g_key_file_load_from_file(key_file, cache_path, G_KEY_FILE_NONE, NULL)) {
+        goto out;
+    }
+
+    version = extcap_cache_version();
+    cached_version = g_key_file_get_string(key_file, EXTCAP_CACHE_GROUP, "version", NULL);
+    if (g_strcmp0(version, cached_version) != 0) {
+        goto out;
+    }
+
+    /* Any extcap program that was added or removed invalidates the cache. */
+    paths = extcap_get_extcap_paths();
+    paths_count = g_slist_length(paths);
+    groups = g_key_file_get_groups(key_file, &num_groups);
+    if (paths_count == 0 || num_groups != paths_count + 1) {
+        g_slist_free_full(paths, g_free);
+        goto out;
+    }
+
+    infos = g_new0(extcap_run_extcaps_info_t, paths_count);
+    i = 0;
+    for (GSList *path = paths; path; path = g_slist_next(path), i++) {
+        infos[i].extcap_path = (char *)path->data;
+    }
+    g_slist_free(paths);    /* Note: the contents are transferred to 'infos'. */
+
+    for (i = 0; i < paths_count; i++) {
+        const char *group = infos[i].extcap_path;
+        gint64 mtime, size;
+        gsize num_ifnames = 0;
+        gchar **ifnames;
+
+        if (!g_key_file_has_group(key_file, group) ||
+            !extcap_cache_stat(group, &mtime, &size) ||
+            g_key_file_get_int64(key_file, group, "mtime", NULL) != mtime ||
+            g_key_file_get_int64(key_file, group, "size", NULL) != size) {
+            extcap_free_extcaps_info_array(infos, paths_count);
+            infos = NULL;
+            goto out;
+        }
+
+        /* Programs that failed to run when the cache was written have no output. */
+        infos[i].output = g_key_file_get_string(key_file, group, "interfaces", NULL);
+        ifnames = g_key_file_get_string_list(key_file, group, "ifnames", &num_ifnames, NULL);
+        if (infos[i].output && num_ifnames > 0) {
+            infos[i].iface_infos = g_new0(extcap_iface_info_t, num_ifnames);
+            infos[i].num_interfaces = (guint)num_ifnames;
+            for (gsize j = 0; j < num_ifnames; j++) {
+                char *key = ws_strdup_printf("config.%" G_GSIZE_FORMAT, j);
+
+                infos[i].iface_infos[j].ifname = g_strdup(ifnames[j]);
+                infos[i].iface_infos[j].output = g_key_file_get_string(key_file, group, key, NULL);
+                g_free(key);
+            }
+        }
+        g_strfreev(ifnames);
+    }
+    *count = paths_count;
+
+out:
+    g_strfreev(groups);
+    g_free(cached_version);
+    g_free(version);
+    g_key_file_free(key_file);
+    g_free(cache_path);
+    return infos;
+}
+
+/*
+ * Whether the results of one extcap program can be stored in a key file.
+ * Programs that cannot be stored are left out, which makes extcap_cache_load()
+ * reject the whole cache.
+ */
+static gboolean
+extcap_cache_storable(const extcap_run_extcaps_info_t *info)
+{
+    if (strpbrk(info->extcap_path, "[]\r\n") != NULL) {
+        return FALSE;
+    }
+    if (info->output && !g_utf8_validate(info->output, -1, NULL)) {
+        return FALSE;
+    }
+    for (guint j = 0; j < info->num_interfaces; j++) {
+        if (!info->iface_infos[j].ifname || !g_utf8_validate(info->iface_infos[j].ifname, -1, NULL)) {
+            return FALSE;
+        }
+        if (info->iface_infos[j].output && !g_utf8_validate(info->iface_infos[j].output, -1, NULL)) {
+            return FALSE;
+        }
+    }
+    return TRUE;
+}
+
+/* Writes the discovery results to the cache file. Safe to call from any thread. */
+static void
+extcap_cache_save(const char *cache_path, extcap_run_extcaps_info_t *infos, guint count)
+{
+    GKeyFile *key_file = g_key_file_new();
+    char *version = extcap_cache_version();
+    GError *error = NULL;
+
+    g_key_file_set_string(key_file, EXTCAP_CACHE_GROUP, "version", version);
+    for (guint i = 0; i < count; i++) {
+        const char *group = infos[i].extcap_path;
+        gint64 mtime, size;
+
+        if (!extcap_cache_storable(&infos[i]) || !extcap_cache_stat(group, &mtime, &size)) {
+            continue;
+        }
+        g_key_file_set_int64(key_file, group, "mtime", mtime);
+        g_key_file_set_int64(key_file, group, "size", size);
+        if (!infos[i].output) {
+            continue;
+        }
+        g_key_file_set_string(key_file, group, "interfaces", infos[i].output);
+        if (infos[i].num_interfaces == 0) {
+            continue;
+        }
+
+        const gchar **ifnames = g_new0(const gchar *, infos[i].num_interfaces + 1);
+        for (guint j = 0; j < infos[i].num_interfaces; j++) {
+            ifnames[j] = infos[i].iface_infos[j].ifname;
+            if (infos[i].iface_infos[j].output) {
+                char *key = ws_strdup_printf("config.%u", j);
+
+                g_key_file_set_string(key_file, group, key, infos[i].iface_infos[j].output);
+                g_free(key);
+            }
+        }
+        g_key_file_set_string_list(key_file, group, "ifnames", ifnames, infos[i].num_interfaces);
+        g_free(ifnames);
+    }
+
+    if (!g_key_file_save_to_file(key_file, cache_path, &error)) {
+        ws_debug("extcap: could not write cache %s: %s", cache_path, error->message);
+        g_error_free(error);
+    }
+    g_free(version);
+    g_key_file_free(key_file);
+}
+
+/*
+ * Reruns the discovery after the interfaces were loaded from the cache,
+ * so that the next start picks up interfaces that appeared or went away
+ * in the meantime (e.g. devices found by network discovery).
+ */
+static gpointer
+extcap_cache_refresh_thread_func(gpointer data)
+{
+    char *cache_path = (char *)data;
+    extcap_run_extcaps_info_t *infos;
+    guint count = 0;
+
+    infos = extcap_run_discovery(&count);
+    if (infos) {
+        extcap_cache_save(cache_path, infos, count);
+        extcap_free_extcaps_info_array(infos, count);
+    }
+    g_free(cache_path);
+    return NULL;
+}
+
+static void
+extcap_cache_refresh_wait(void)
+{
+    if (_cache_refresh_thread) {
+        g_thread_join(_cache_refresh_thread);
+        _cache_refresh_thread = NULL;
+    }
+}
+
 /* Handles loading of the interfaces. */
 static void
 extcap_load_interface_list(void)
@@ -2159,10 +2414,9 @@ extcap_load_interface_list(void)
 
     if (_loaded_interfaces == NULL)
     {
-        int major = 0;
-        int minor = 0;
+        static gboolean cache_tried = FALSE;
         guint count = 0;
-        extcap_run_extcaps_info_t *infos;
+        extcap_run_extcaps_info_t *infos = NULL;
         GList *unused_arguments = NULL;
 
         _loaded_interfaces = g_hash_table_new_full(g_str_hash, g_str_equal, g_free, extcap_free_interface_info);
@@ -2175,16 +2429,28 @@ extcap_load_interface_list(void)
             _tool_for_ifname = g_hash_table_new_full(g_str_hash, g_str_equal, g_free, g_free);
         }
 
-        get_ws_version_number(&major, &minor, NULL);
-        char *arg_version = ws_strdup_printf("%s=%d.%d", EXTCAP_ARGUMENT_VERSION, major, minor);
-        const char *argv[] = {
-            EXTCAP_ARGUMENT_LIST_INTERFACES,
-            arg_version,
-            NULL
-        };
-        infos = (extcap_run_extcaps_info_t *)extcap_run_all(argv,
-                extcap_list_interfaces_cb, sizeof(extcap_run_extcaps_info_t),
-                &count);
+        /* At startup, use the results of the previous run and refresh them
+         * in the background. Explicit reloads always run the extcaps. */
+        if (!cache_tried) {
+            cache_tried = TRUE;
+            infos = extcap_cache_load(&count);
+            if (infos) {
+                ws_debug("extcap: loaded discovery of %u tools from cache", count);
+                _cache_refresh_thread = g_thread_new("extcap cache",
+                        extcap_cache_refresh_thread_func,
+                        get_persconffile_path(EXTCAP_CACHE_FILE, FALSE));
+            }
+        }
+        if (!infos) {
+            char *cache_path = get_persconffile_path(EXTCAP_CACHE_FILE, FALSE);
+
+            extcap_cache_refresh_wait();
+            infos = extcap_run_discovery(&count);
+            if (infos) {
+                extcap_cache_save(cache_path, infos, count);
+            }
+            g_free(cache_path);
+        }
         for (guint i = 0; i < count; i++) {
             if (!infos[i].output) {
                 continue;
@@ -2210,7 +2476,6 @@ extcap_load_interface_list(void)
         /* XXX rework cb_preference such that this unused list can be removed. */
         extcap_free_if_configuration(unused_arguments, TRUE);
         extcap_free_extcaps_info_array(infos, count);
-        g_free(arg_version);
     }
 }
 
@@ -74,7 +74,8 @@
 #endif
 
 static gboolean read_record(capture_file *cf, wtap_rec *rec, Buffer *buf,
-    dfilter_t *dfcode, epan_dissect_t *edt, column_info *cinfo, gint64 offset,
+    dfilter_t *dfcode, epan_dissect_t *edt, epan_dissect_t *rf_edt,
+    column_info *cinfo, gint64 offset,
     fifo_string_cache_t *frame_dup_cache, GChecksum *frame_cksum);
 
 static void rescan_packets(capture_file *cf, const char *action, const char *action_item, gboolean redissect);
@@ -489,6 +490,7 @@ cf_read(capture_file *cf, gboolean reloading)
     gint64               size;
     gint64               start_time;
     epan_dissect_t       edt;
+    epan_dissect_t       rf_edt;
     wtap_rec             rec;
     Buffer               buf;
     dfilter_t           *dfcode = NULL;
@@ -559,6 +561,8 @@ cf_read(capture_file *cf, gboolean reloading)
     start_time = g_get_monotonic_time();
 
     epan_dissect_init(&edt, cf->epan, create_proto_tree, FALSE);
+    if (cf->rfcode)
+        epan_dissect_init(&rf_edt, cf->epan, TRUE, FALSE);
 
     /* If any tap listeners require the columns, construct them. */
     cinfo = (tap_flags & TL_REQUIRES_COLUMNS) ? &cf->cinfo : NULL;
@@ -647,7 +651,7 @@ cf_read(capture_file *cf, gboolean reloading)
                    hours even on fast machines) just to see that it was the wrong file. */
                 break;
             }
-            read_record(cf, &rec, &buf, dfcode, &edt, cinfo, data_offset, &frame_dup_cache, cksum);
+            read_record(cf, &rec, &buf, dfcode, &edt, &rf_edt, cinfo, data_offset, &frame_dup_cache, cksum);
             wtap_rec_reset(&rec);
         }
     }
@@ -688,6 +692,8 @@ cf_read(capture_file *cf, gboolean reloading)
     dfilter_free(dfcode);
 
     epan_dissect_cleanup(&edt);
+    if (cf->rfcode)
+        epan_dissect_cleanup(&rf_edt);
     wtap_rec_cleanup(&rec);
     ws_buffer_free(&buf);
 
@@ -784,6 +790,7 @@ cf_continue_tail(capture_file *cf, volatile int to_read, wtap_rec *rec,
     volatile int      newly_displayed_packets = 0;
     dfilter_t        *dfcode = NULL;
     epan_dissect_t    edt;
+    epan_dissect_t    rf_edt;
     gboolean          create_proto_tree;
     guint             tap_flags;
     gboolean          compiled _U_;
@@ -823,6 +830,8 @@ cf_continue_tail(capture_file *cf, volatile int to_read, wtap_rec *rec,
     /*packet_list_freeze();*/
 
     epan_dissect_init(&edt, cf->epan, create_proto_tree, FALSE);
+    if (cf->rfcode)
+        epan_dissect_init(&rf_edt, cf->epan, TRUE, FALSE);
 
     TRY {
         gint64 data_offset = 0;
@@ -843,7 +852,7 @@ cf_continue_tail(capture_file *cf, volatile int to_read, wtap_rec *rec,
                    aren't any packets left to read) exit. */
                 break;
             }
-            if (read_record(cf, rec, buf, dfcode, &edt, cinfo, data_offset, frame_dup_cache, frame_cksum)) {
+            if (read_record(cf, rec, buf, dfcode, &edt, &rf_edt, cinfo, data_offset, frame_dup_cache, frame_cksum)) {
                 newly_displayed_packets++;
             }
             to_read--;
@@ -873,6 +882,8 @@ cf_continue_tail(capture_file *cf, volatile int to_read, wtap_rec *rec,
     dfilter_free(dfcode);
 
     epan_dissect_cleanup(&edt);
+    if (cf->rfcode)
+        epan_dissect_cleanup(&rf_edt);
 
     /* Don't freeze/thaw the list when doing live capture */
     /*packet_list_thaw();*/
@@ -922,6 +933,7 @@ cf_finish_tail(capture_file *cf, wtap_rec *rec, Buffer *buf, int *err,
     dfilter_t *dfcode = NULL;
     column_info *cinfo;
     epan_dissect_t edt;
+    epan_dissect_t rf_edt;
     gboolean   create_proto_tree;
     guint      tap_flags;
     gboolean   compiled _U_;
@@ -967,6 +979,8 @@ cf_finish_tail(capture_file *cf, wtap_rec *rec, Buffer *buf, int *err,
     /*packet_list_freeze();*/
 
     epan_dissect_init(&edt, cf->epan, create_proto_tree, FALSE);
+    if (cf->rfcode)
+        epan_dissect_init(&rf_edt, cf->epan, TRUE, FALSE);
 
     while ((wtap_read(cf->provider.wth, rec, buf, err, &err_info, &data_offset))) {
         if (cf->state == FILE_READ_ABORTED) {
@@ -975,7 +989,7 @@ cf_finish_tail(capture_file *cf, wtap_rec *rec, Buffer *buf, int *err,
                aren't any packets left to read) exit. */
             break;
         }
-        read_record(cf, rec, buf, dfcode, &edt, cinfo, data_offset, frame_dup_cache, frame_cksum);
+        read_record(cf, rec, buf, dfcode, &edt, &rf_edt, cinfo, data_offset, frame_dup_cache, frame_cksum);
         wtap_rec_reset(rec);
     }
 
@@ -983,6 +997,8 @@ cf_finish_tail(capture_file *cf, wtap_rec *rec, Buffer *buf, int *err,
     dfilter_free(dfcode);
 
     epan_dissect_cleanup(&edt);
+    if (cf->rfcode)
+        epan_dissect_cleanup(&rf_edt);
 
     /* Don't freeze/thaw the list when doing live capture */
     /*packet_list_thaw();*/
@@ -1257,6 +1273,32 @@ add_packet_to_packet_list(frame_data *fdata, capture_file *cf,
     epan_dissect_reset(edt);
 }
 
+/*
+ * Mark a frame as displayed without reading or dissecting it.
+ * This is only valid when nothing needs the dissection: there's no
+ * display filter, no tap listener wants to see the packets, and the
+ * packet list itself isn't being rebuilt.  All frames pass in that case,
+ * so only the time reference and cumulative byte bookkeeping that
+ * add_packet_to_packet_list() would have done needs to be redone.
+ */
+static void
+mark_packet_displayed(frame_data *fdata, capture_file *cf)
+{
+    frame_data_set_before_dissect(fdata, &cf->elapsed_time,
+            &cf->provider.ref, cf->provider.prev_dis);
+    cf->provider.prev_cap = fdata;
+
+    fdata->passed_dfilter = 1;
+    cf->displayed_count++;
+
+    frame_data_set_after_dissect(fdata, &cf->cum_bytes);
+    cf->provider.prev_dis = fdata;
+
+    if (cf->first_displayed == 0)
+        cf->first_displayed = fdata->num;
+    cf->last_displayed = fdata->num;
+}
+
 /*
  * Read in a new record.
  * Returns TRUE if the packet was added to the packet (record) list,
@@ -1264,7 +1306,7 @@ add_packet_to_packet_list(frame_data *fdata, capture_file *cf,
  */
 static gboolean
 read_record(capture_file *cf, wtap_rec *rec, Buffer *buf, dfilter_t *dfcode,
-        epan_dissect_t *edt, column_info *cinfo, gint64 offset,
+        epan_dissect_t *edt, epan_dissect_t *rf_edt, column_info *cinfo, gint64 offset,
         fifo_string_cache_t *frame_dup_cache, GChecksum *frame_cksum)
 {
     frame_data    fdlocal;
@@ -1289,15 +1331,14 @@ read_record(capture_file *cf, wtap_rec *rec, Buffer *buf, dfilter_t *dfcode,
     frame_data_init(&fdlocal, cf->count + 1, rec, offset, cf->cum_bytes);
 
     if (cf->rfcode) {
-        epan_dissect_t rf_edt;
-
-        epan_dissect_init(&rf_edt, cf->epan, TRUE, FALSE);
-        epan_dissect_prime_with_dfilter(&rf_edt, cf->rfcode);
-        epan_dissect_run(&rf_edt, cf->cd_t, rec,
+        /* rf_edt is set up by our caller whenever there's a read filter,
+           and is reset rather than torn down after each record. */
+        epan_dissect_prime_with_dfilter(rf_edt, cf->rfcode);
+        epan_dissect_run(rf_edt, cf->cd_t, rec,
                 frame_tvbuff_new_buffer(&cf->provider, &fdlocal, buf),
                 &fdlocal, NULL);
-        passed = dfilter_apply_edt(cf->rfcode, &rf_edt);
-        epan_dissect_cleanup(&rf_edt);
+        passed = dfilter_apply_edt(cf->rfcode, rf_edt);
+        epan_dissect_reset(rf_edt);
     }
 
     if (passed) {
@@ -1678,6 +1719,7 @@ rescan_packets(capture_file *cf, const char *action, const char *action_item, gb
     gboolean    filtering_tap_listeners = FALSE;
     guint       tap_flags;
     gboolean    add_to_packet_list = FALSE;
+    gboolean    skip_dissection;
     gboolean    compiled _U_;
     guint32     frames_count;
     gboolean    queued_rescan_type = RESCAN_NONE;
@@ -1791,6 +1833,14 @@ rescan_packets(capture_file *cf, const char *action, const char *action_item, gb
         add_to_packet_list = TRUE;
     }
 
+    /*
+     * If we're just clearing the display filter and nobody else wants to
+     * see the packets, every frame is displayed and there's no need to
+     * read and dissect them all again.
+     */
+    skip_dissection = (!redissect && dfcode == NULL &&
+                       !tap_listeners_require_dissection());
+
     /* We don't yet know which will be the first and last frames displayed. */
     cf->first_displayed = 0;
     cf->last_displayed = 0;
@@ -1919,6 +1969,25 @@ rescan_packets(capture_file *cf, const char *action, const char *action_item, gb
         /* Frame dependencies from the previous dissection/filtering are no longer valid. */
         fdata->dependent_of_displayed = 0;
 
+        if (skip_dissection) {
+            if (prev_frame_num != -1 && !selected_frame_seen) {
+                preceding_frame_num = prev_frame_num;
+                preceding_frame = prev_frame;
+            }
+            mark_packet_displayed(fdata, cf);
+            if (selected_frame_seen && following_frame_num == -1) {
+                following_frame_num = fdata->num;
+                following_frame = fdata;
+            }
+            if (fdata == selected_frame) {
+                selected_frame_seen = TRUE;
+                selected_frame_num = fdata->num;
+            }
+            prev_frame_num = fdata->num;
+            prev_frame = fdata;
+            continue;
+        }
+
         if (!cf_read_record(cf, fdata, &rec, &buf))
             break; /* error reading the frame */
 
@@ -2070,6 +2139,63 @@ rescan_packets(capture_file *cf, const char *action, const char *action_item, gb
 }
 
 
+/*
+ * Compute the reference frame, relative time and cumulative bytes of one
+ * frame, given cf->provider.ref and cf->cum_bytes as left by the frame
+ * before it, and advance those for the next frame.
+ */
+static void
+reftime_frame(capture_file *cf, frame_data *fdata)
+{
+    nstime_t rel_ts;
+
+    /* just add some value here until we know if it is being displayed or not */
+    fdata->cum_bytes = cf->cum_bytes + fdata->pkt_len;
+
+    /*
+     *Timestamps
+     */
+
+    /* If we don't have the time stamp of the first packet in the
+       capture, it's because this is the first packet.  Save the time
+       stamp of this packet as the time stamp of the first packet. */
+    if (cf->provider.ref == NULL)
+        cf->provider.ref = fdata;
+    /* if this frames is marked as a reference time frame, reset
+       firstsec and firstusec to this frame */
+    if (fdata->ref_time)
+        cf->provider.ref = fdata;
+
+    /* Get the time elapsed between the first packet and this packet. */
+    fdata->frame_ref_num = (fdata != cf->provider.ref) ? cf->provider.ref->num : 0;
+    nstime_delta(&rel_ts, &fdata->abs_ts, &cf->provider.ref->abs_ts);
+
+    /* If it's greater than the current elapsed time, set the elapsed time
+       to it (we check for "greater than" so as not to be confused by
+       time moving backwards). */
+    if ((gint32)cf->elapsed_time.secs < rel_ts.secs
+            || ((gint32)cf->elapsed_time.secs == rel_ts.secs && (gint32)cf->elapsed_time.nsecs < rel_ts.nsecs)) {
+        cf->elapsed_time = rel_ts;
+    }
+
+    /*
+     * Byte counts
+     */
+    if ( (fdata->passed_dfilter) || (fdata->ref_time) ) {
+        /* This frame either passed the display filter list or is marked as
+           a time reference frame.  All time reference frames are displayed
+           even if they don't pass the display filter */
+        if (fdata->ref_time) {
+            /* if this was a TIME REF frame we should reset the cum_bytes field */
+            cf->cum_bytes = fdata->pkt_len;
+            fdata->cum_bytes = cf->cum_bytes;
+        } else {
+            /* increase cum_bytes with this packets length */
+            cf->cum_bytes += fdata->pkt_len;
+        }
+    }
+}
+
 /*
  * Scan through all frame data and recalculate the ref time
  * without rereading the file.
@@ -2080,7 +2206,6 @@ cf_reftime_packets(capture_file* cf)
 {
     guint32     framenum;
     frame_data *fdata;
-    nstime_t rel_ts;
 
     cf->provider.ref = NULL;
     cf->provider.prev_dis = NULL;
@@ -2089,22 +2214,7 @@ cf_reftime_packets(capture_file* cf)
     for (framenum = 1; framenum <= cf->count; framenum++) {
         fdata = frame_data_sequence_find(cf->provider.frames, framenum);
 
-        /* just add some value here until we know if it is being displayed or not */
-        fdata->cum_bytes = cf->cum_bytes + fdata->pkt_len;
-
-        /*
-         *Timestamps
-         */
-
-        /* If we don't have the time stamp of the first packet in the
-           capture, it's because this is the first packet.  Save the time
-           stamp of this packet as the time stamp of the first packet. */
-        if (cf->provider.ref == NULL)
-            cf->provider.ref = fdata;
-        /* if this frames is marked as a reference time frame, reset
-           firstsec and firstusec to this frame */
-        if (fdata->ref_time)
-            cf->provider.ref = fdata;
+        reftime_frame(cf, fdata);
 
         /* If we don't have the time stamp of the previous displayed packet,
            it's because this is the first displayed packet.  Save the time
@@ -2114,41 +2224,49 @@ cf_reftime_packets(capture_file* cf)
             cf->provider.prev_dis = fdata;
         }
 
-        /* Get the time elapsed between the first packet and this packet. */
-        fdata->frame_ref_num = (fdata != cf->provider.ref) ? cf->provider.ref->num : 0;
-        nstime_delta(&rel_ts, &fdata->abs_ts, &cf->provider.ref->abs_ts);
-
-        /* If it's greater than the current elapsed time, set the elapsed time
-           to it (we check for "greater than" so as not to be confused by
-           time moving backwards). */
-        if ((gint32)cf->elapsed_time.secs < rel_ts.secs
-                || ((gint32)cf->elapsed_time.secs == rel_ts.secs && (gint32)cf->elapsed_time.nsecs < rel_ts.nsecs)) {
-            cf->elapsed_time = rel_ts;
-        }
-
         /* If this frame is displayed, get the time elapsed between the
            previous displayed packet and this packet. */
         if ( fdata->passed_dfilter ) {
             fdata->prev_dis_num = cf->provider.prev_dis->num;
             cf->provider.prev_dis = fdata;
         }
+    }
+}
 
-        /*
-         * Byte counts
-         */
-        if ( (fdata->passed_dfilter) || (fdata->ref_time) ) {
-            /* This frame either passed the display filter list or is marked as
-               a time reference frame.  All time reference frames are displayed
-               even if they don't pass the display filter */
-            if (fdata->ref_time) {
-                /* if this was a TIME REF frame we should reset the cum_bytes field */
-                cf->cum_bytes = fdata->pkt_len;
-                fdata->cum_bytes = cf->cum_bytes;
-            } else {
-                /* increase cum_bytes with this packets length */
-                cf->cum_bytes += fdata->pkt_len;
-            }
+/*
+ * Recalculate the ref time after the time reference flag of one frame
+ * was set or cleared. Only the frames from that one up to the next time
+ * reference frame depend on it, so only those are updated.
+ */
+void
+cf_reftime_packets_update(capture_file *cf, frame_data *changed)
+{
+    guint32     framenum;
+    frame_data *fdata;
+    frame_data *saved_ref = cf->provider.ref;
+    guint32     saved_cum_bytes = cf->cum_bytes;
+
+    /* Restore the state the full scan had after the previous frame. */
+    cf->provider.ref = NULL;
+    cf->cum_bytes = 0;
+    if (changed->num > 1) {
+        fdata = frame_data_sequence_find(cf->provider.frames, changed->num - 1);
+        cf->provider.ref = fdata->frame_ref_num ?
+            frame_data_sequence_find(cf->provider.frames, fdata->frame_ref_num) : fdata;
+        cf->cum_bytes = fdata->cum_bytes;
+        if (!fdata->passed_dfilter && !fdata->ref_time)
+            cf->cum_bytes -= fdata->pkt_len;
+    }
+
+    for (framenum = changed->num; framenum <= cf->count; framenum++) {
+        fdata = frame_data_sequence_find(cf->provider.frames, framenum);
+        if (fdata->ref_time && fdata != changed) {
+            /* The rest of the file is unaffected. */
+            cf->provider.ref = saved_ref;
+            cf->cum_bytes = saved_cum_bytes;
+            return;
         }
+        reftime_frame(cf, fdata);
     }
 }
 
@@ -2196,6 +2314,11 @@ process_specified_records(capture_file *cf, packet_range_t *range,
 
     cf->stop_flag = FALSE;
 
+    /* We'll be reading frames in order, so in increasing file offset
+       order (for a file that isn't being read from a pipe or merged). */
+    if (cf->provider.wth != NULL)
+        wtap_set_random_read_sequential(cf->provider.wth, TRUE);
+
     if (range != NULL)
         packet_range_process_init(range);
 
@@ -2278,6 +2401,9 @@ process_specified_records(capture_file *cf, packet_range_t *range,
         destroy_progress_dlg(progbar);
     g_timer_destroy(prog_timer);
 
+    if (cf->provider.wth != NULL)
+        wtap_set_random_read_sequential(cf->provider.wth, FALSE);
+
     ws_assert(cf->read_lock);
     cf->read_lock = FALSE;
 
@@ -2308,6 +2434,16 @@ retap_packet(capture_file *cf, frame_data *fdata, wtap_rec *rec, Buffer *buf,
 
 cf_read_status_t
 cf_retap_packets(capture_file *cf)
+{
+    if (cf == NULL) {
+        return CF_READ_ABORTED;
+    }
+
+    return cf_retap_packets_range(cf, 1, cf->count);
+}
+
+cf_read_status_t
+cf_retap_packets_range(capture_file *cf, guint32 first_frame, guint32 last_frame)
 {
     packet_range_t        range;
     retap_callback_args_t callback_args;
@@ -2358,11 +2494,20 @@ cf_retap_packets(capture_file *cf)
     /* Iterate through the list of packets, dissecting all packets and
        re-running the taps. */
     packet_range_init(&range, cf);
+    /* Every other tap listener has just been reset and expects to see
+     * all of the frames again, so we can only skip frames if the caller's
+     * listener is the only one. */
+    if ((first_frame > 1 || last_frame < cf->count) && num_tap_listeners() == 1) {
+        char *range_str = ws_strdup_printf("%u-%u", first_frame, last_frame);
+        packet_range_convert_str(&range, range_str);
+        g_free(range_str);
+        range.process = range_process_user_range;
+    }
     packet_range_process_init(&range);
 
     ret = process_specified_records(cf, &range, "Recalculating statistics on",
-            "all packets", TRUE, retap_packet,
-            &callback_args, TRUE);
+            range.process == range_process_all ? "all packets" : "selected packets",
+            TRUE, retap_packet, &callback_args, TRUE);
 
     packet_range_cleanup(&range);
     epan_dissect_cleanup(&callback_args.edt);
@@ -2771,6 +2916,12 @@ write_pdml_packet(capture_file *cf, frame_data *fdata, wtap_rec *rec,
     return !ferror(args->fh);
 }
 
+/*
+ * PDML and PSML are written as many small strings; give the output
+ * file a larger buffer than stdio's default to cut down on writes.
+ */
+#define XML_EXPORT_BUFFER_SIZE  (256 * 1024)
+
 cf_print_status_t
 cf_write_pdml_packets(capture_file *cf, print_args_t *print_args)
 {
@@ -2781,6 +2932,7 @@ cf_write_pdml_packets(capture_file *cf, print_args_t *print_args)
     fh = ws_fopen(print_args->file, "w");
     if (fh == NULL)
         return CF_PRINT_OPEN_ERROR; /* attempt to open destination failed */
+    setvbuf(fh, NULL, _IOFBF, XML_EXPORT_BUFFER_SIZE);
 
     write_pdml_preamble(fh, cf->filename);
     if (ferror(fh)) {
@@ -2861,6 +3013,7 @@ cf_write_psml_packets(capture_file *cf, print_args_t *print_args)
     fh = ws_fopen(print_args->file, "w");
     if (fh == NULL)
         return CF_PRINT_OPEN_ERROR; /* attempt to open destination failed */
+    setvbuf(fh, NULL, _IOFBF, XML_EXPORT_BUFFER_SIZE);
 
     write_psml_preamble(&cf->cinfo, fh);
     if (ferror(fh)) {
@@ -3133,11 +3286,19 @@ gboolean
 cf_find_packet_protocol_tree(capture_file *cf, const char *string,
         search_direction dir)
 {
-    match_data mdata;
+    match_data     mdata;
+    epan_dissect_t edt;
+    gboolean       result;
 
     mdata.string = string;
     mdata.string_len = strlen(string);
-    return find_packet(cf, match_protocol_tree, &mdata, dir);
+
+    /* Construct the protocol tree, including the displayed text */
+    epan_dissect_init(&edt, cf->epan, TRUE, TRUE);
+    mdata.edt = &edt;
+    result = find_packet(cf, match_protocol_tree, &mdata, dir);
+    epan_dissect_cleanup(&edt);
+    return result;
 }
 
 field_info*
@@ -3159,7 +3320,6 @@ match_protocol_tree(capture_file *cf, frame_data *fdata,
         wtap_rec *rec, Buffer *buf, void *criterion)
 {
     match_data     *mdata = (match_data *)criterion;
-    epan_dissect_t  edt;
 
     /* Load the frame's data. */
     if (!cf_read_record(cf, fdata, rec, buf)) {
@@ -3167,18 +3327,16 @@ match_protocol_tree(capture_file *cf, frame_data *fdata,
         return MR_ERROR;
     }
 
-    /* Construct the protocol tree, including the displayed text */
-    epan_dissect_init(&edt, cf->epan, TRUE, TRUE);
     /* We don't need the column information */
-    epan_dissect_run(&edt, cf->cd_t, rec,
+    epan_dissect_run(mdata->edt, cf->cd_t, rec,
             frame_tvbuff_new_buffer(&cf->provider, fdata, buf),
             fdata, NULL);
 
     /* Iterate through all the nodes, seeing if they have text that matches. */
     mdata->cf = cf;
     mdata->frame_matched = FALSE;
-    proto_tree_children_foreach(edt.tree, match_subtree_text, mdata);
-    epan_dissect_cleanup(&edt);
+    proto_tree_children_foreach(mdata->edt->tree, match_subtree_text, mdata);
+    epan_dissect_reset(mdata->edt);
     return mdata->frame_matched ? MR_MATCHED : MR_NOTMATCHED;
 }
 
@@ -3267,11 +3425,19 @@ gboolean
 cf_find_packet_summary_line(capture_file *cf, const char *string,
         search_direction dir)
 {
-    match_data mdata;
+    match_data     mdata;
+    epan_dissect_t edt;
+    gboolean       result;
 
     mdata.string = string;
     mdata.string_len = strlen(string);
-    return find_packet(cf, match_summary_line, &mdata, dir);
+
+    /* Don't bother constructing the protocol tree */
+    epan_dissect_init(&edt, cf->epan, FALSE, FALSE);
+    mdata.edt = &edt;
+    result = find_packet(cf, match_summary_line, &mdata, dir);
+    epan_dissect_cleanup(&edt);
+    return result;
 }
 
 static match_result
@@ -3281,7 +3447,7 @@ match_summary_line(capture_file *cf, frame_data *fdata,
     match_data     *mdata      = (match_data *)criterion;
     const gchar    *string     = mdata->string;
     size_t          string_len = mdata->string_len;
-    epan_dissect_t  edt;
+    epan_dissect_t *edt        = mdata->edt;
     const char     *info_column;
     size_t          info_column_len;
     match_result    result     = MR_NOTMATCHED;
@@ -3296,10 +3462,8 @@ match_summary_line(capture_file *cf, frame_data *fdata,
         return MR_ERROR;
     }
 
-    /* Don't bother constructing the protocol tree */
-    epan_dissect_init(&edt, cf->epan, FALSE, FALSE);
     /* Get the column information */
-    epan_dissect_run(&edt, cf->cd_t, rec,
+    epan_dissect_run(edt, cf->cd_t, rec,
             frame_tvbuff_new_buffer(&cf->provider, fdata, buf),
             fdata, &cf->cinfo);
 
@@ -3307,7 +3471,7 @@ match_summary_line(capture_file *cf, frame_data *fdata,
     for (colx = 0; colx < cf->cinfo.num_cols; colx++) {
         if (cf->cinfo.columns[colx].fmt_matx[COL_INFO]) {
             /* Found it.  See if we match. */
-            info_column = get_column_text(edt.pi.cinfo, colx);
+            info_column = get_column_text(edt->pi.cinfo, colx);
             info_column_len = strlen(info_column);
             if (cf->regex) {
                 if (ws_regex_matches(cf->regex, info_column)) {
@@ -3345,7 +3509,7 @@ match_summary_line(capture_file *cf, frame_data *fdata,
             break;
         }
     }
-    epan_dissect_cleanup(&edt);
+    epan_dissect_reset(edt);
     return result;
 }
 
@@ -3579,19 +3743,17 @@ done:
     return result;
 }
 
+/*
+ * Exact, case sensitive byte string search, shared by the narrow string
+ * and hex searches. memmem() (where available) uses a two-way search
+ * instead of restarting a byte-by-byte comparison at every occurrence
+ * of the first byte.
+ */
 static match_result
-match_narrow(capture_file *cf, frame_data *fdata,
-        wtap_rec *rec, Buffer *buf, void *criterion)
+match_bytes(capture_file *cf, frame_data *fdata,
+        wtap_rec *rec, Buffer *buf, const cbs_t *info)
 {
-    cbs_t        *info       = (cbs_t *)criterion;
-    const guint8 *ascii_text = info->data;
-    size_t        textlen    = info->data_len;
-    match_result  result;
-    guint32       buf_len;
-    guint8       *pd, *buf_start, *buf_end;
-    guint32       i;
-    guint8        c_char;
-    size_t        c_match    = 0;
+    const guint8 *buf_start, *pd;
 
     /* Load the frame's data. */
     if (!cf_read_record(cf, fdata, rec, buf)) {
@@ -3599,34 +3761,27 @@ match_narrow(capture_file *cf, frame_data *fdata,
         return MR_ERROR;
     }
 
-    result = MR_NOTMATCHED;
-    buf_len = fdata->cap_len;
+    if (info->data_len == 0) {
+        return MR_NOTMATCHED;
+    }
+
     buf_start = ws_buffer_start_ptr(buf);
-    buf_end = buf_start + buf_len;
-    for (pd = buf_start; pd < buf_end; pd++) {
-        pd = (guint8 *)memchr(pd, ascii_text[0], buf_end - pd);
-        if (pd == NULL) break;
-        c_match = 0;
-        for (i = 0; pd + i < buf_end; i++) {
-            c_char = pd[i];
-            if (c_char == ascii_text[c_match]) {
-                c_match++;
-                if (c_match == textlen) {
-                    result = MR_MATCHED;
-                    cf->search_pos = i + (guint32)(pd - buf_start);
-                    /* Save the position of the last character
-                       for highlighting the field. */
-                    cf->search_len = i + 1;
-                    goto done;
-                }
-            } else {
-                break;
-            }
-        }
+    pd = ws_memmem(buf_start, fdata->cap_len, info->data, info->data_len);
+    if (pd == NULL) {
+        return MR_NOTMATCHED;
     }
 
-done:
-    return result;
+    /* Save the position of the last character for highlighting the field. */
+    cf->search_pos = (guint32)(pd - buf_start + info->data_len - 1);
+    cf->search_len = (guint32)info->data_len;
+    return MR_MATCHED;
+}
+
+static match_result
+match_narrow(capture_file *cf, frame_data *fdata,
+        wtap_rec *rec, Buffer *buf, void *criterion)
+{
+    return match_bytes(cf, fdata, rec, buf, (cbs_t *)criterion);
 }
 
 /* Case insensitive match */
@@ -3795,51 +3950,7 @@ static match_result
 match_binary(capture_file *cf, frame_data *fdata,
         wtap_rec *rec, Buffer *buf, void *criterion)
 {
-    cbs_t        *info        = (cbs_t *)criterion;
-    const guint8 *binary_data = info->data;
-    size_t        datalen     = info->data_len;
-    match_result  result;
-    guint32       buf_len;
-    guint8       *pd, *buf_start, *buf_end;
-    guint32       i;
-    size_t        c_match     = 0;
-
-    /* Load the frame's data. */
-    if (!cf_read_record(cf, fdata, rec, buf)) {
-        /* Attempt to get the packet failed. */
-        return MR_ERROR;
-    }
-
-    result = MR_NOTMATCHED;
-    buf_len = fdata->cap_len;
-    buf_start = ws_buffer_start_ptr(buf);
-    buf_end = buf_start + buf_len;
-    /* Not clear if using memcmp() is faster. memmem() on systems that
-     * have it should be faster, though.
-     */
-    for (pd = buf_start; pd < buf_end; pd++) {
-        pd = (guint8 *)memchr(pd, binary_data[0], buf_end - pd);
-        if (pd == NULL) break;
-        c_match = 0;
-        for (i = 0; pd + i < buf_end; i++) {
-            if (pd[i] == binary_data[c_match]) {
-                c_match++;
-                if (c_match == datalen) {
-                    result = MR_MATCHED;
-                    cf->search_pos = i + (guint32)(pd - buf_start);
-                    /* Save the position of the last character
-                       for highlighting the field. */
-                    cf->search_len = i + 1;
-                    goto done;
-                }
-            } else {
-                break;
-            }
-        }
-    }
-
-done:
-    return result;
+    return match_bytes(cf, fdata, rec, buf, (cbs_t *)criterion);
 }
 
 static match_result
@@ -80,6 +80,7 @@ typedef struct {
     capture_file  *cf;
     gboolean       frame_matched;
     field_info    *finfo;
+    epan_dissect_t *edt;        /* reused for every frame searched */
 } match_data;
 
 /**
@@ -407,6 +408,15 @@ cf_status_t cf_filter_packets(capture_file *cf, gchar *dfilter, gboolean force);
  */
 void cf_reftime_packets(capture_file *cf);
 
+/**
+ * Recalculate the ref time after the time reference flag of one frame
+ * changed. Only the frames up to the next time reference are updated.
+ *
+ * @param cf the capture file
+ * @param fdata the frame whose time reference flag changed
+ */
+void cf_reftime_packets_update(capture_file *cf, frame_data *fdata);
+
 /**
  * Return the time it took to load the file (in msec).
  */
@@ -427,6 +437,19 @@ void cf_redissect_packets(capture_file *cf);
  */
 cf_read_status_t cf_retap_packets(capture_file *cf);
 
+/**
+ * Rescan the packets in a range of frames and just run taps. This is
+ * for taps that are known to only care about those frames, e.g. a
+ * single TCP stream. If other tap listeners are registered, all
+ * packets are rescanned.
+ *
+ * @param cf the capture file
+ * @param first_frame the first frame to retap
+ * @param last_frame the last frame to retap
+ * @return one of cf_read_status_t
+ */
+cf_read_status_t cf_retap_packets_range(capture_file *cf, guint32 first_frame, guint32 last_frame);
+
 /* print_range, enum which frames should be printed */
 typedef enum {
     print_range_selected_only,    /* selected frame(s) only (currently only one) */
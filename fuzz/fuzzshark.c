@@ -52,6 +52,20 @@ static column_info fuzz_cinfo;
 static epan_t *fuzz_epan;
 static epan_dissect_t *fuzz_edt;
 
+/*
+ * Optional tuning for long-running fuzzing processes, from the
+ * environment:
+ *
+ *   FUZZSHARK_RESET_INTERVAL=N  start a new dissection session, which
+ *                               frees the file scope and runs the cleanup
+ *                               and init routines (conversations,
+ *                               reassembly tables, ...), every N inputs;
+ *   FUZZSHARK_SLOW_MS=T         report every input whose dissection takes
+ *                               at least T milliseconds (0 reports all).
+ */
+static guint fuzz_reset_interval;
+static gint64 fuzz_slow_us = -1;
+
 /*
  * Report an error in command-line arguments.
  */
@@ -172,6 +186,7 @@ fuzz_init(int argc _U_, char **argv)
 	e_prefs             *prefs_p;
 	int                  ret = EXIT_SUCCESS;
 	size_t               i;
+	const char          *env;
 
 	const char *fuzz_target =
 #if defined(FUZZ_DISSECTOR_TARGET)
@@ -210,6 +225,10 @@ fuzz_init(int argc _U_, char **argv)
 "crash. Mode (2) can be used if a dissector (such as 'ospf') is not available\n"
 "through (1).\n"
 "\n"
+"When many inputs are run in one process, FUZZSHARK_RESET_INTERVAL=N discards\n"
+"conversation and reassembly state every N inputs, and FUZZSHARK_SLOW_MS=T\n"
+"reports inputs that take at least T milliseconds to dissect.\n"
+"\n"
 "For best results, build dedicated fuzzshark_* targets with:\n"
 "    cmake -GNinja -DCMAKE_C_COMPILER=clang -DCMAKE_CXX_COMPILER=clang++\\\n"
 "      -DENABLE_FUZZER=1 -DENABLE_ASAN=1 -DENABLE_UBSAN=1\n"
@@ -345,6 +364,13 @@ fuzz_init(int argc _U_, char **argv)
 	register_postdissector(fuzz_handle);
 #endif
 
+	if ((env = getenv("FUZZSHARK_RESET_INTERVAL")) != NULL) {
+		fuzz_reset_interval = (guint)strtoul(env, NULL, 10);
+	}
+	if ((env = getenv("FUZZSHARK_SLOW_MS")) != NULL) {
+		fuzz_slow_us = (gint64)strtoul(env, NULL, 10) * 1000;
+	}
+
 	fuzz_epan = fuzzshark_epan_new();
 	fuzz_edt = epan_dissect_new(fuzz_epan, TRUE, FALSE);
 
@@ -356,17 +382,45 @@ clean_exit:
 }
 
 #ifdef FUZZ_EPAN
+/*
+ * Start a new dissection session, as if a new capture file was opened,
+ * so that state left behind by earlier inputs can't affect the next one.
+ * This is much cheaper than starting a new process.
+ */
+static void
+fuzzshark_epan_reset(void)
+{
+	epan_dissect_free(fuzz_edt);
+	epan_free(fuzz_epan);
+
+	fuzz_epan = fuzzshark_epan_new();
+	fuzz_edt = epan_dissect_new(fuzz_epan, TRUE, FALSE);
+}
+
 int
 LLVMFuzzerTestOneInput(const guint8 *buf, size_t real_len)
 {
 	static guint32 framenum = 0;
-	epan_dissect_t *edt = fuzz_edt;
+	static guint inputs = 0;
+	epan_dissect_t *edt;
+	gint64 start_time = 0;
 
 	guint32 len = (guint32) real_len;
 
 	wtap_rec rec;
 	frame_data fdlocal;
 
+	if (fuzz_reset_interval && inputs++ == fuzz_reset_interval) {
+		fuzzshark_epan_reset();
+		framenum = 0;
+		inputs = 1;
+	}
+	edt = fuzz_edt;
+
+	if (fuzz_slow_us >= 0) {
+		start_time = g_get_monotonic_time();
+	}
+
 	memset(&rec, 0, sizeof(rec));
 
 	rec.rec_type = REC_TYPE_PACKET;
@@ -383,6 +437,15 @@ LLVMFuzzerTestOneInput(const guint8 *buf, size_t real_len)
 	frame_data_destroy(&fdlocal);
 
 	epan_dissect_reset(edt);
+
+	if (fuzz_slow_us >= 0) {
+		gint64 elapsed = g_get_monotonic_time() - start_time;
+
+		if (elapsed >= fuzz_slow_us) {
+			fprintf(stderr, "oss-fuzzshark: frame %u (%u bytes) took %" G_GINT64_FORMAT ".%03" G_GINT64_FORMAT " ms\n",
+			    framenum, len, elapsed / 1000, elapsed % 1000);
+		}
+	}
 	return 0;
 }
 
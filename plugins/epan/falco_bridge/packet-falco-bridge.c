@@ -531,18 +531,33 @@ dissect_sinsp_span(tvbuff_t* tvb, packet_info* pinfo, proto_tree* tree, void* bi
 
     guint8* payload = (guint8*)tvb_get_ptr(tvb, 0, plen);
 
+    /*
+     * Only ask the plugin for the fields we are going to use. Fields that
+     * feed the Info column, conversations, or addresses are always needed;
+     * everything else only if it's in a visible tree or referenced by a
+     * filter or column.
+     */
     sinsp_field_extract_t *sinsp_fields = (sinsp_field_extract_t*) wmem_alloc(pinfo->pool, sizeof(sinsp_field_extract_t) * bi->visible_fields);
+    uint32_t *sinsp_field_idx = (uint32_t*) wmem_alloc(pinfo->pool, sizeof(uint32_t) * bi->visible_fields);
+    uint32_t sinsp_field_len = 0;
     for (uint32_t fld_idx = 0; fld_idx < bi->visible_fields; fld_idx++) {
         header_field_info* hfinfo = &(bi->hf[fld_idx].hfinfo);
-        sinsp_field_extract_t *sfe = &sinsp_fields[fld_idx];
 
+        if ((bi->field_flags[fld_idx] & (BFF_INFO|BFF_CONVERSATION)) == 0 &&
+                !(bi->hf_id_to_addr_id && bi->hf_id_to_addr_id[fld_idx] >= 0) &&
+                !proto_field_is_referenced(tree, bi->hf_ids[fld_idx])) {
+            continue;
+        }
+
+        sinsp_field_extract_t *sfe = &sinsp_fields[sinsp_field_len];
         sfe->field_id = bi->field_ids[fld_idx];
         sfe->field_name = hfinfo->abbrev;
         sfe->type = hfinfo->type == FT_STRINGZ ? SFT_STRINGZ : SFT_UINT64;
+        sinsp_field_idx[sinsp_field_len++] = fld_idx;
     }
 
     // If we have a failure, try to dissect what we can first, then bail out with an error.
-    bool rc = extract_sisnp_source_fields(bi->ssi, pinfo->num, payload, plen, pinfo->pool, sinsp_fields, bi->visible_fields);
+    bool rc = extract_sisnp_source_fields(bi->ssi, pinfo->num, payload, plen, pinfo->pool, sinsp_fields, sinsp_field_len);
 
     for (uint32_t idx = 0; idx < bi->num_conversation_filters; idx++) {
         bi->conversation_filters[idx].is_present = false;
@@ -551,8 +566,9 @@ dissect_sinsp_span(tvbuff_t* tvb, packet_info* pinfo, proto_tree* tree, void* bi
 
     conversation_element_t *first_conv_els = NULL; // hfid + field val + CONVERSATION_LOG
 
-    for (uint32_t fld_idx = 0; fld_idx < bi->visible_fields; fld_idx++) {
-        sinsp_field_extract_t *sfe = &sinsp_fields[fld_idx];
+    for (uint32_t sfe_idx = 0; sfe_idx < sinsp_field_len; sfe_idx++) {
+        sinsp_field_extract_t *sfe = &sinsp_fields[sfe_idx];
+        uint32_t fld_idx = sinsp_field_idx[sfe_idx];
         header_field_info* hfinfo = &(bi->hf[fld_idx].hfinfo);
 
         if (!sfe->is_present) {
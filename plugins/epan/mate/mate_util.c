@@ -741,13 +741,16 @@ extern AVP* get_next_avp(AVPL* avpl, void** cookie) {
 gchar* avpl_to_str(AVPL* avpl) {
 	AVPN* c;
 	GString* s = g_string_new("");
-	gchar* avp_s;
 	gchar* r;
 
+	/* Same format as avp_to_str(), without a temporary string per AVP;
+	 * this builds the gop and gog keys for every PDU. */
 	for(c=avpl->null.next; c->avp; c = c->next) {
-		avp_s = avp_to_str(c->avp);
-		g_string_append_printf(s," %s;",avp_s);
-		g_free(avp_s);
+		g_string_append_c(s,' ');
+		g_string_append(s,c->avp->n);
+		g_string_append_c(s,c->avp->o);
+		g_string_append(s,c->avp->v);
+		g_string_append_c(s,';');
 	}
 
 	r = g_string_free(s,FALSE);
@@ -890,8 +893,6 @@ extern AVPL* new_avpl_from_avpl(const gchar* name, AVPL* avpl, gboolean copy_avp
  *
  **/
 extern AVP* match_avp(AVP* src, AVP* op) {
-	gchar** splited;
-	int i;
 	gchar* p;
 	guint ls;
 	guint lo;
@@ -917,15 +918,19 @@ extern AVP* match_avp(AVP* src, AVP* op) {
 		case AVP_OP_STARTS:
 			return strncmp(src->v,op->v,strlen(op->v)) == 0 ? src : NULL;
 		case AVP_OP_ONEOFF:
-			splited = g_strsplit(op->v,"|",0);
-			if (splited) {
-				for (i=0;splited[i];i++) {
-					if(g_str_equal(splited[i],src->v)) {
-						g_strfreev(splited);
-						return src;
-					}
+			/* Walk the "|" separated alternatives in place. Like
+			 * g_strsplit(), an empty list has no alternatives. */
+			if (*op->v == '\0') return NULL;
+			ls = (guint) strlen(src->v);
+			for (p = op->v; ; p++) {
+				gchar* end = strchr(p,'|');
+
+				lo = end ? (guint) (end - p) : (guint) strlen(p);
+				if (lo == ls && strncmp(p,src->v,ls) == 0) {
+					return src;
 				}
-				g_strfreev(splited);
+				if (!end) break;
+				p = end;
 			}
 			return NULL;
 
@@ -105,8 +105,11 @@ static wmem_map_t *dcerpc_context_zero;
 
 /*
     The rrpd_list holds information about all of the APDU Request-Response Pairs seen in the trace.
+    It is split by stream: rrpd_list maps an ip_proto:stream_no key (see rrpd_stream_key) to a list
+    of the RRPDs for that stream in the order they were created, so that matching a packet only has
+    to look at the RRPDs of its own stream rather than every RRPD in the trace.
  */
-static wmem_list_t *rrpd_list = NULL;
+static wmem_map_t *rrpd_list = NULL;
 
 /*
     output_rrpd is a hash of pointers to RRPDs on the rrpd_list.  The index is the frame number.  This hash is
@@ -120,9 +123,9 @@ static wmem_map_t *output_rrpd;
     fully qualify the identification of the RRPD (the identification being ip_proto:stream_no:session_id:msg_id).
     This only occurs when a) we are using one of the decode_based calculations (such as SMB2), and b) when we have
     TCP Reassembly enabled.  Once we receive a header packet for an APDU we migrate the entry from this array to the
-    main rrpd_list.
+    main rrpd_list.  There is at most one entry per stream, so this is keyed in the same way as the rrpd_list.
  */
-static wmem_list_t *temp_rsp_rrpd_list = NULL;  /* Reuse these for speed and efficient memory use - issue a warning if we run out */
+static wmem_map_t *temp_rsp_rrpd_list = NULL;
 
 /* Optimisation data - the following is used for various optimisation measures */
 static int highest_tcp_stream_no;
@@ -225,14 +228,38 @@ static void update_output_rrpd(RRPD *in_rrpd)
         wmem_map_insert(output_rrpd, GUINT_TO_POINTER(in_rrpd->rsp_last_frame), in_rrpd);
 }
 
+/* Build the key used to index the rrpd_list and temp_rsp_rrpd_list by stream. */
+static guint64 rrpd_stream_key(const RRPD *in_rrpd)
+{
+    return ((guint64)in_rrpd->ip_proto << 32) | in_rrpd->stream_no;
+}
+
+/* Return the list of RRPDs for the stream of in_rrpd, or NULL if there are none yet. */
+static wmem_list_t *find_rrpd_stream_list(const RRPD *in_rrpd)
+{
+    guint64 key = rrpd_stream_key(in_rrpd);
+
+    return (wmem_list_t*)wmem_map_lookup(rrpd_list, &key);
+}
+
 /* Return the index of the RRPD that has been appended */
 static RRPD* append_to_rrpd_list(RRPD *in_rrpd)
 {
     RRPD *next_rrpd = (RRPD*)wmem_memdup(wmem_file_scope(), in_rrpd, sizeof(RRPD));
+    wmem_list_t *stream_list = find_rrpd_stream_list(in_rrpd);
 
     update_output_rrpd(next_rrpd);
 
-    wmem_list_append(rrpd_list, next_rrpd);
+    if (stream_list == NULL)
+    {
+        guint64 *key = wmem_new(wmem_file_scope(), guint64);
+
+        *key = rrpd_stream_key(in_rrpd);
+        stream_list = wmem_list_new(wmem_file_scope());
+        wmem_map_insert(rrpd_list, key, stream_list);
+    }
+
+    wmem_list_append(stream_list, next_rrpd);
 
     return next_rrpd;
 }
@@ -241,8 +268,12 @@ static RRPD *find_latest_rrpd_dcerpc(RRPD *in_rrpd)
 {
     RRPD *rrpd;
     wmem_list_frame_t* i;
+    wmem_list_t *stream_list = find_rrpd_stream_list(in_rrpd);
+
+    if (stream_list == NULL)
+        return NULL;
 
-    for (i = wmem_list_tail(rrpd_list); i != NULL; i = wmem_list_frame_prev(i))
+    for (i = wmem_list_tail(stream_list); i != NULL; i = wmem_list_frame_prev(i))
     {
         rrpd = (RRPD*)wmem_list_frame_data(i);
 
@@ -317,8 +348,12 @@ static RRPD *find_latest_rrpd_dns(RRPD *in_rrpd)
 {
     RRPD *rrpd;
     wmem_list_frame_t* i;
+    wmem_list_t *stream_list = find_rrpd_stream_list(in_rrpd);
+
+    if (stream_list == NULL)
+        return NULL;
 
-    for (i = wmem_list_tail(rrpd_list); i != NULL; i = wmem_list_frame_prev(i))
+    for (i = wmem_list_tail(stream_list); i != NULL; i = wmem_list_frame_prev(i))
     {
         rrpd = (RRPD*)wmem_list_frame_data(i);
 
@@ -350,8 +385,12 @@ static RRPD *find_latest_rrpd_gtcp(RRPD *in_rrpd)
 {
     RRPD *rrpd;
     wmem_list_frame_t* i;
+    wmem_list_t *stream_list = find_rrpd_stream_list(in_rrpd);
 
-    for (i = wmem_list_tail(rrpd_list); i != NULL; i = wmem_list_frame_prev(i))
+    if (stream_list == NULL)
+        return NULL;
+
+    for (i = wmem_list_tail(stream_list); i != NULL; i = wmem_list_frame_prev(i))
     {
         rrpd = (RRPD*)wmem_list_frame_data(i);
 
@@ -380,8 +419,12 @@ static RRPD *find_latest_rrpd_gudp(RRPD *in_rrpd)
 {
     RRPD *rrpd;
     wmem_list_frame_t* i;
+    wmem_list_t *stream_list = find_rrpd_stream_list(in_rrpd);
+
+    if (stream_list == NULL)
+        return NULL;
 
-    for (i = wmem_list_tail(rrpd_list); i != NULL; i = wmem_list_frame_prev(i))
+    for (i = wmem_list_tail(stream_list); i != NULL; i = wmem_list_frame_prev(i))
     {
         rrpd = (RRPD*)wmem_list_frame_data(i);
 
@@ -410,8 +453,12 @@ static RRPD *find_latest_rrpd_smb2(RRPD *in_rrpd)
 {
     RRPD *rrpd;
     wmem_list_frame_t* i;
+    wmem_list_t *stream_list = find_rrpd_stream_list(in_rrpd);
+
+    if (stream_list == NULL)
+        return NULL;
 
-    for (i = wmem_list_tail(rrpd_list); i != NULL; i = wmem_list_frame_prev(i))
+    for (i = wmem_list_tail(stream_list); i != NULL; i = wmem_list_frame_prev(i))
     {
         rrpd = (RRPD*)wmem_list_frame_data(i);
 
@@ -486,8 +533,12 @@ static RRPD *find_latest_rrpd_syn(RRPD *in_rrpd)
 {
     RRPD *rrpd;
     wmem_list_frame_t* i;
+    wmem_list_t *stream_list = find_rrpd_stream_list(in_rrpd);
+
+    if (stream_list == NULL)
+        return NULL;
 
-    for (i = wmem_list_tail(rrpd_list); i != NULL; i = wmem_list_frame_prev(i))
+    for (i = wmem_list_tail(stream_list); i != NULL; i = wmem_list_frame_prev(i))
     {
         rrpd = (RRPD*)wmem_list_frame_data(i);
 
@@ -610,25 +661,19 @@ static void update_rrpd_list_entry_req(RRPD *in_rrpd)
 static RRPD* insert_into_temp_rsp_rrpd_list(RRPD *in_rrpd)
 {
     RRPD *rrpd = (RRPD*)wmem_memdup(wmem_file_scope(), in_rrpd, sizeof(RRPD));
+    guint64 *key = wmem_new(wmem_file_scope(), guint64);
 
-    wmem_list_append(temp_rsp_rrpd_list, rrpd);
+    *key = rrpd_stream_key(in_rrpd);
+    wmem_map_insert(temp_rsp_rrpd_list, key, rrpd);
 
     return rrpd;
 }
 
 static RRPD* find_temp_rsp_rrpd(RRPD *in_rrpd)
 {
-    wmem_list_frame_t *i;
-    RRPD* rrpd;
+    guint64 key = rrpd_stream_key(in_rrpd);
 
-    for (i = wmem_list_head(temp_rsp_rrpd_list); i; i = wmem_list_frame_next(i))
-    {
-        rrpd = (RRPD*)wmem_list_frame_data(i);
-        if (rrpd->ip_proto == in_rrpd->ip_proto && rrpd->stream_no == in_rrpd->stream_no)
-            return rrpd;
-    }
-
-    return NULL;
+    return (RRPD*)wmem_map_lookup(temp_rsp_rrpd_list, &key);
 }
 
 static void update_temp_rsp_rrpd(RRPD *temp_list, RRPD *in_rrpd)
@@ -640,9 +685,11 @@ static void update_temp_rsp_rrpd(RRPD *temp_list, RRPD *in_rrpd)
 /* This function migrates an entry from the temp_rsp_rrpd_list to the main rrpd_list. */
 static void migrate_temp_rsp_rrpd(RRPD *main_list, RRPD *temp_list)
 {
+    guint64 key = rrpd_stream_key(temp_list);
+
     update_rrpd_list_entry(main_list, temp_list);
 
-    wmem_list_remove(temp_rsp_rrpd_list, temp_list);
+    wmem_map_remove(temp_rsp_rrpd_list, &key);
 }
 
 static void update_rrpd_list_entry_rsp(RRPD *in_rrpd)
@@ -764,8 +811,8 @@ static void init_globals(void)
     /* Create and initialise some dynamic memory areas */
     tcp_stream_exceptions = wmem_map_new(wmem_file_scope(), g_direct_hash, g_direct_equal);
     detected_tcp_svc = wmem_map_new(wmem_file_scope(), g_direct_hash, g_direct_equal);
-    rrpd_list = wmem_list_new(wmem_file_scope());
-    temp_rsp_rrpd_list = wmem_list_new(wmem_file_scope());
+    rrpd_list = wmem_map_new(wmem_file_scope(), g_int64_hash, g_int64_equal);
+    temp_rsp_rrpd_list = wmem_map_new(wmem_file_scope(), g_int64_hash, g_int64_equal);
 
     /* Indicate what fields we're interested in. */
     GArray *wanted_fields = g_array_sized_new(FALSE, FALSE, (guint)sizeof(int), HF_INTEREST_END_OF_LIST);
@@ -19,6 +19,7 @@
 #include <stdlib.h>
 #include <string.h>
 #include <wsutil/file_util.h>
+#include <wsutil/pint.h>
 #include <wsutil/wslog.h>
 #include <wiretap/wtap_opttypes.h>
 
@@ -52,6 +53,7 @@ enum {
 	PKT_SCTP,
 	PKT_SYSLOG,
 	PKT_TCP,
+	PKT_TCP_FLOW,
 	PKT_TDS,
 	PKT_TR,
 	PKT_UDP,
@@ -509,6 +511,14 @@ static randpkt_example examples[] = {
 		1000,
 	},
 
+	{ "tcp-flow", "TCP connections carrying HTTP (protocol-valid)",
+		PKT_TCP_FLOW,	WTAP_ENCAP_ETHERNET,
+		NULL,		0,
+		NULL,		0,
+		NULL,		NULL,
+		1000,
+	},
+
 	{ "tr",	 "Token-Ring",
 		PKT_TR,		WTAP_ENCAP_TOKEN_RING,
 		NULL,		0,
@@ -557,6 +567,255 @@ randpkt_example* randpkt_find_example(int type)
 	return NULL;
 }
 
+/*
+ * Generation of protocol-valid TCP connections, for benchmarking
+ * dissection and capture with realistic traffic rather than random
+ * bytes.  Each connection is a three-way handshake, an HTTP request
+ * and response, and a FIN exchange, with correct sequence numbers and
+ * checksums.  The connection state is kept between calls so that
+ * "randpkt -r" can interleave it with the other packet types.
+ */
+#define FLOW_ETH_LEN	14
+#define FLOW_IP_LEN	20
+#define FLOW_TCP_LEN	20
+#define FLOW_HDR_LEN	(FLOW_ETH_LEN + FLOW_IP_LEN + FLOW_TCP_LEN)
+#define FLOW_MSS	1460
+
+#define TH_FIN	0x01
+#define TH_SYN	0x02
+#define TH_PUSH	0x08
+#define TH_ACK	0x10
+
+enum {
+	FLOW_SYN,
+	FLOW_SYN_ACK,
+	FLOW_ACK,
+	FLOW_REQUEST,
+	FLOW_REQUEST_ACK,
+	FLOW_RESPONSE,
+	FLOW_RESPONSE_ACK,
+	FLOW_CLIENT_FIN,
+	FLOW_SERVER_FIN,
+	FLOW_LAST_ACK,
+	FLOW_NUM_STEPS
+};
+
+static struct {
+	guint32	connections;
+	guint	step;
+	guint32	client_addr;
+	guint16	client_port;
+	guint32	client_seq;
+	guint32	server_seq;
+	nstime_t ts;
+} flow;
+
+static const guint8 flow_client_mac[6] = { 0x00, 0x00, 0x5e, 0x00, 0x53, 0x01 };
+static const guint8 flow_server_mac[6] = { 0x00, 0x00, 0x5e, 0x00, 0x53, 0x02 };
+#define FLOW_SERVER_ADDR	0xc6336401	/* 198.51.100.1 */
+#define FLOW_SERVER_PORT	80
+
+static guint32 flow_cksum_add(guint32 sum, const guint8 *p, guint len)
+{
+	while (len > 1) {
+		sum += (p[0] << 8) | p[1];
+		p += 2;
+		len -= 2;
+	}
+	if (len)
+		sum += p[0] << 8;
+	return sum;
+}
+
+static guint16 flow_cksum_fold(guint32 sum)
+{
+	while (sum >> 16)
+		sum = (sum & 0xffff) + (sum >> 16);
+	return (guint16)~sum;
+}
+
+/*
+ * Fill in the Ethernet, IPv4 and TCP headers in front of the payload_len
+ * bytes of payload already at buf + FLOW_HDR_LEN, and advance the sender's
+ * sequence number.  Returns the length of the frame.
+ */
+static guint flow_fill_headers(guint8 *buf, gboolean from_client, guint8 flags, guint payload_len)
+{
+	guint8 *ip = buf + FLOW_ETH_LEN;
+	guint8 *tcp = ip + FLOW_IP_LEN;
+	guint32 src = from_client ? flow.client_addr : FLOW_SERVER_ADDR;
+	guint32 dst = from_client ? FLOW_SERVER_ADDR : flow.client_addr;
+	guint16 sport = from_client ? flow.client_port : FLOW_SERVER_PORT;
+	guint16 dport = from_client ? FLOW_SERVER_PORT : flow.client_port;
+	guint32 *seq = from_client ? &flow.client_seq : &flow.server_seq;
+	guint32 ack = from_client ? flow.server_seq : flow.client_seq;
+	guint tcp_len = FLOW_TCP_LEN + payload_len;
+	guint32 sum;
+
+	memcpy(buf, from_client ? flow_server_mac : flow_client_mac, 6);
+	memcpy(buf + 6, from_client ? flow_client_mac : flow_server_mac, 6);
+	phton16(buf + 12, 0x0800);
+
+	ip[0] = 0x45;
+	ip[1] = 0;
+	phton16(ip + 2, FLOW_IP_LEN + tcp_len);
+	phton16(ip + 4, (guint16)(flow.connections * FLOW_NUM_STEPS + flow.step));
+	phton16(ip + 6, 0x4000);	/* Don't Fragment */
+	ip[8] = 64;
+	ip[9] = 6;			/* TCP */
+	phton16(ip + 10, 0);
+	phton32(ip + 12, src);
+	phton32(ip + 16, dst);
+	phton16(ip + 10, flow_cksum_fold(flow_cksum_add(0, ip, FLOW_IP_LEN)));
+
+	phton16(tcp, sport);
+	phton16(tcp + 2, dport);
+	phton32(tcp + 4, *seq);
+	phton32(tcp + 8, (flags & TH_ACK) ? ack : 0);
+	tcp[12] = (FLOW_TCP_LEN / 4) << 4;
+	tcp[13] = flags;
+	phton16(tcp + 14, 65535);
+	phton16(tcp + 16, 0);
+	phton16(tcp + 18, 0);
+
+	/* Pseudo-header, then the segment */
+	sum = flow_cksum_add(0, ip + 12, 8);
+	sum += 6 + tcp_len;
+	sum = flow_cksum_add(sum, tcp, tcp_len);
+	phton16(tcp + 16, flow_cksum_fold(sum));
+
+	*seq += payload_len;
+	if (flags & (TH_SYN | TH_FIN))
+		(*seq)++;
+
+	return FLOW_HDR_LEN + payload_len;
+}
+
+/* Build the next packet of the current connection into buf; returns its length. */
+static guint flow_next_packet(guint8 *buf, guint max_payload)
+{
+	guint8 *payload = buf + FLOW_HDR_LEN;
+	guint len;
+
+	if (flow.step == FLOW_SYN) {
+		flow.client_addr = 0xc0000200 | (1 + flow.connections % 254);	/* 192.0.2.0/24 */
+		flow.client_port = 1024 + flow.connections % (65536 - 1024);
+		flow.client_seq = g_rand_int(pkt_rand);
+		flow.server_seq = g_rand_int(pkt_rand);
+	}
+
+	switch (flow.step) {
+
+	case FLOW_SYN:
+		len = flow_fill_headers(buf, TRUE, TH_SYN, 0);
+		break;
+
+	case FLOW_SYN_ACK:
+		len = flow_fill_headers(buf, FALSE, TH_SYN|TH_ACK, 0);
+		break;
+
+	case FLOW_ACK:
+	case FLOW_RESPONSE_ACK:
+	case FLOW_LAST_ACK:
+		len = flow_fill_headers(buf, TRUE, TH_ACK, 0);
+		break;
+
+	case FLOW_REQUEST:
+		len = snprintf((char *)payload, FLOW_MSS,
+		    "GET /object/%u HTTP/1.1\r\n"
+		    "Host: www.example.com\r\n"
+		    "User-Agent: randpkt\r\n"
+		    "Accept: */*\r\n"
+		    "\r\n", flow.connections);
+		len = flow_fill_headers(buf, TRUE, TH_PUSH|TH_ACK, len);
+		break;
+
+	case FLOW_REQUEST_ACK:
+		len = flow_fill_headers(buf, FALSE, TH_ACK, 0);
+		break;
+
+	case FLOW_RESPONSE:
+	{
+		/* Leave room for the response headers within one segment */
+		guint max_body = MIN(max_payload, FLOW_MSS - 128);
+		guint body_len = g_rand_int_range(pkt_rand, 0, max_body + 1);
+
+		len = snprintf((char *)payload, FLOW_MSS,
+		    "HTTP/1.1 200 OK\r\n"
+		    "Content-Type: text/plain\r\n"
+		    "Content-Length: %u\r\n"
+		    "\r\n", body_len);
+		memset(payload + len, 'x', body_len);
+		len = flow_fill_headers(buf, FALSE, TH_PUSH|TH_ACK, len + body_len);
+		break;
+	}
+
+	case FLOW_CLIENT_FIN:
+		len = flow_fill_headers(buf, TRUE, TH_FIN|TH_ACK, 0);
+		break;
+
+	case FLOW_SERVER_FIN:
+	default:
+		len = flow_fill_headers(buf, FALSE, TH_FIN|TH_ACK, 0);
+		break;
+	}
+
+	if (++flow.step == FLOW_NUM_STEPS) {
+		flow.step = FLOW_SYN;
+		flow.connections++;
+	}
+
+	return len;
+}
+
+static void randpkt_flow_loop(randpkt_example* example, guint64 produce_count, guint64 packet_delay_ms)
+{
+	guint64 i;
+	int err;
+	gchar* err_info;
+	guint8* buffer;
+	wtap_rec* rec;
+
+	rec = g_new0(wtap_rec, 1);
+	buffer = (guint8*)g_malloc0(FLOW_HDR_LEN + FLOW_MSS);
+
+	rec->rec_type = REC_TYPE_PACKET;
+	rec->presence_flags = WTAP_HAS_TS;
+	rec->rec_header.packet_header.pkt_encap = example->sample_wtap_encap;
+
+	for (i = 0; i < produce_count; i++) {
+		guint len_this_pkt = flow_next_packet(buffer, example->produce_max_bytes);
+
+		rec->rec_header.packet_header.caplen = len_this_pkt;
+		rec->rec_header.packet_header.len = len_this_pkt;
+
+		/* 100us between packets */
+		flow.ts.nsecs += 100000;
+		if (flow.ts.nsecs >= 1000000000) {
+			flow.ts.secs++;
+			flow.ts.nsecs -= 1000000000;
+		}
+		rec->ts = flow.ts;
+
+		if (!wtap_dump(example->dump, rec, buffer, &err, &err_info)) {
+			cfile_write_failure_message(NULL,
+			    example->filename, err, err_info, 0,
+			    wtap_dump_file_type_subtype(example->dump));
+		}
+		if (packet_delay_ms) {
+			g_usleep(1000 * (gulong)packet_delay_ms);
+			if (!wtap_dump_flush(example->dump, &err)) {
+				cfile_write_failure_message(NULL,
+				    example->filename, err, NULL, 0,
+				    wtap_dump_file_type_subtype(example->dump));
+			}
+		}
+	}
+
+	g_free(rec);
+	g_free(buffer);
+}
+
 void randpkt_loop(randpkt_example* example, guint64 produce_count, guint64 packet_delay_ms)
 {
 	guint i, j;
@@ -568,6 +827,11 @@ void randpkt_loop(randpkt_example* example, guint64 produce_count, guint64 packe
 	guint8* buffer;
 	wtap_rec* rec;
 
+	if (example->produceable_type == PKT_TCP_FLOW) {
+		randpkt_flow_loop(example, produce_count, packet_delay_ms);
+		return;
+	}
+
 	rec = g_new0(wtap_rec, 1);
 	buffer = (guint8*)g_malloc0(65536);
 
@@ -811,6 +811,64 @@ clean_exit:
     return ret;
 }
 
+/*
+ * Data read from the pipe but not yet returned.  Records are usually
+ * small, so reading as much as the pipe has ready, rather than exactly
+ * the header and then exactly the payload, saves a couple of system
+ * calls per record when the producer writes faster than we dissect.
+ * read() returns whatever is available, so this never waits for more
+ * data than the record being read needs.
+ */
+#define RAW_PIPE_BUF_SIZE (64 * 1024)
+static guint8 raw_pipe_buf[RAW_PIPE_BUF_SIZE];
+static unsigned int raw_pipe_buf_len = 0;
+static unsigned int raw_pipe_buf_off = 0;
+
+/*
+ * Copy the next len bytes from the pipe to dst.
+ * Returns 1 on success, 0 if the pipe hit EOF first, or -1 on error,
+ * with errno set.
+ */
+static int
+raw_pipe_get(void *dst, unsigned int len, gint64 *data_offset)
+{
+    guchar *ptr = (guchar *)dst;
+
+    while (len > 0) {
+        unsigned int avail = raw_pipe_buf_len - raw_pipe_buf_off;
+        ssize_t bytes_read;
+
+        if (avail > 0) {
+            if (avail > len)
+                avail = len;
+            memcpy(ptr, raw_pipe_buf + raw_pipe_buf_off, avail);
+            raw_pipe_buf_off += avail;
+            *data_offset += avail;
+            ptr += avail;
+            len -= avail;
+            continue;
+        }
+
+        /* Read large payloads straight into place. */
+        if (len >= RAW_PIPE_BUF_SIZE) {
+            bytes_read = ws_read(fd, ptr, len);
+            if (bytes_read <= 0)
+                return bytes_read == 0 ? 0 : -1;
+            *data_offset += bytes_read;
+            ptr += bytes_read;
+            len -= (unsigned int)bytes_read;
+            continue;
+        }
+
+        bytes_read = ws_read(fd, raw_pipe_buf, RAW_PIPE_BUF_SIZE);
+        if (bytes_read <= 0)
+            return bytes_read == 0 ? 0 : -1;
+        raw_pipe_buf_len = (unsigned int)bytes_read;
+        raw_pipe_buf_off = 0;
+    }
+    return 1;
+}
+
 /**
  * Read data from a raw pipe.  The "raw" data consists of a libpcap
  * packet header followed by the payload.
@@ -825,7 +883,7 @@ static gboolean
 raw_pipe_read(wtap_rec *rec, Buffer *buf, int *err, gchar **err_info, gint64 *data_offset) {
     struct pcap_pkthdr mem_hdr;
     struct pcaprec_hdr disk_hdr;
-    ssize_t bytes_read = 0;
+    int got;
     unsigned int bytes_needed = (unsigned int) sizeof(disk_hdr);
     guchar *ptr = (guchar*) &disk_hdr;
 
@@ -853,21 +911,15 @@ raw_pipe_read(wtap_rec *rec, Buffer *buf, int *err, gchar **err_info, gint64 *da
     }
 #endif
 
-    /* Copied from capture_loop.c */
-    while (bytes_needed > 0) {
-        bytes_read = ws_read(fd, ptr, bytes_needed);
-        if (bytes_read == 0) {
-            *err = 0;
-            *err_info = NULL;
-            return FALSE;
-        } else if (bytes_read < 0) {
-            *err = errno;
-            *err_info = NULL;
-            return FALSE;
-        }
-        bytes_needed -= (unsigned int)bytes_read;
-        *data_offset += bytes_read;
-        ptr += bytes_read;
+    got = raw_pipe_get(ptr, bytes_needed, data_offset);
+    if (got == 0) {
+        *err = 0;
+        *err_info = NULL;
+        return FALSE;
+    } else if (got < 0) {
+        *err = errno;
+        *err_info = NULL;
+        return FALSE;
     }
 
     rec->rec_type = REC_TYPE_PACKET;
@@ -903,20 +955,15 @@ raw_pipe_read(wtap_rec *rec, Buffer *buf, int *err, gchar **err_info, gint64 *da
 
     ws_buffer_assure_space(buf, bytes_needed);
     ptr = ws_buffer_start_ptr(buf);
-    while (bytes_needed > 0) {
-        bytes_read = ws_read(fd, ptr, bytes_needed);
-        if (bytes_read == 0) {
-            *err = WTAP_ERR_SHORT_READ;
-            *err_info = NULL;
-            return FALSE;
-        } else if (bytes_read < 0) {
-            *err = errno;
-            *err_info = NULL;
-            return FALSE;
-        }
-        bytes_needed -= (unsigned int)bytes_read;
-        *data_offset += bytes_read;
-        ptr += bytes_read;
+    got = raw_pipe_get(ptr, bytes_needed, data_offset);
+    if (got == 0) {
+        *err = WTAP_ERR_SHORT_READ;
+        *err_info = NULL;
+        return FALSE;
+    } else if (got < 0) {
+        *err = errno;
+        *err_info = NULL;
+        return FALSE;
     }
     return TRUE;
 }
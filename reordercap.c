@@ -20,7 +20,9 @@
 #include <wsutil/ws_getopt.h>
 
 #include <wiretap/wtap.h>
+#include <wiretap/merge.h>
 
+#include <wsutil/clopts_common.h>
 #include <wsutil/cmdarg_err.h>
 #include <wsutil/filesystem.h>
 #include <wsutil/file_util.h>
@@ -50,6 +52,10 @@ print_usage(FILE *output)
     fprintf(output, "\n");
     fprintf(output, "Options:\n");
     fprintf(output, "  -n        don't write to output file if the input file is ordered.\n");
+    fprintf(output, "  -w <count> reorder within a window of <count> frames, reading\n");
+    fprintf(output, "            and writing the file in a single sequential pass.\n");
+    fprintf(output, "  -m <count> hold at most <count> frames in memory, sorting\n");
+    fprintf(output, "            larger files in temporary files and merging them.\n");
     fprintf(output, "  -h        display this help and exit.\n");
     fprintf(output, "  -v        print version information and exit.\n");
 }
@@ -132,6 +138,596 @@ frames_compare(gconstpointer a, gconstpointer b)
     return nstime_cmp(time1, time2);
 }
 
+/*
+ * Read the whole file, sort the frames by timestamp and then write them
+ * out, re-reading each one from its place in the input file.
+ */
+static void
+reorder_whole_file(wtap *wth, wtap_dumper *pdh, gboolean write_output_regardless,
+                   const char *infile, const char *outfile)
+{
+    wtap_rec rec;
+    Buffer buf;
+    int err;
+    gchar *err_info;
+    gint64 data_offset;
+    guint wrong_order_count = 0;
+    guint i;
+    GPtrArray *frames;
+    FrameRecord_t *prevFrame = NULL;
+
+    /* Allocate the array of frame pointers. */
+    frames = g_ptr_array_new();
+
+    /* Read each frame from infile */
+    wtap_rec_init(&rec);
+    ws_buffer_init(&buf, 1514);
+    while (wtap_read(wth, &rec, &buf, &err, &err_info, &data_offset)) {
+        FrameRecord_t *newFrameRecord;
+
+        newFrameRecord = g_slice_new(FrameRecord_t);
+        newFrameRecord->num = frames->len + 1;
+        newFrameRecord->offset = data_offset;
+        if (rec.presence_flags & WTAP_HAS_TS) {
+            newFrameRecord->frame_time = rec.ts;
+        } else {
+            nstime_set_unset(&newFrameRecord->frame_time);
+        }
+
+        if (prevFrame && frames_compare(&newFrameRecord, &prevFrame) < 0) {
+           wrong_order_count++;
+        }
+
+        g_ptr_array_add(frames, newFrameRecord);
+        prevFrame = newFrameRecord;
+        wtap_rec_reset(&rec);
+    }
+    wtap_rec_cleanup(&rec);
+    ws_buffer_free(&buf);
+    if (err != 0) {
+      /* Print a message noting that the read failed somewhere along the line. */
+      cfile_read_failure_message(infile, err, err_info);
+    }
+
+    printf("%u frames, %u out of order\n", frames->len, wrong_order_count);
+
+    /* Sort the frames */
+    if (wrong_order_count > 0) {
+        g_ptr_array_sort(frames, frames_compare);
+    }
+
+    /* Write out each sorted frame in turn */
+    wtap_rec_init(&rec);
+    ws_buffer_init(&buf, 1514);
+    for (i = 0; i < frames->len; i++) {
+        FrameRecord_t *frame = (FrameRecord_t *)frames->pdata[i];
+
+        /* Avoid writing if already sorted and configured to */
+        if (write_output_regardless || (wrong_order_count > 0)) {
+            frame_write(frame, wth, pdh, &rec, &buf, infile, outfile);
+        }
+        g_slice_free(FrameRecord_t, frame);
+    }
+    wtap_rec_cleanup(&rec);
+    ws_buffer_free(&buf);
+
+    if (!write_output_regardless && (wrong_order_count == 0)) {
+        printf("Not writing output file because input file is already in order.\n");
+    }
+
+    /* Free the whole array */
+    g_ptr_array_free(frames, TRUE);
+}
+
+/* A frame held in the reorder window, read into its own record and buffer */
+typedef struct WindowFrame_t {
+    wtap_rec     rec;
+    Buffer       buf;
+    guint        num;
+
+    nstime_t     frame_time;
+} WindowFrame_t;
+
+/* Heap order: earliest timestamp first, file order for equal timestamps */
+static gboolean
+window_frame_before(const WindowFrame_t *frame1, const WindowFrame_t *frame2)
+{
+    int cmp = nstime_cmp(&frame1->frame_time, &frame2->frame_time);
+
+    return cmp < 0 || (cmp == 0 && frame1->num < frame2->num);
+}
+
+static void
+window_heap_push(GPtrArray *heap, WindowFrame_t *frame)
+{
+    guint i = heap->len;
+
+    g_ptr_array_add(heap, frame);
+    while (i > 0) {
+        guint parent = (i - 1) / 2;
+
+        if (!window_frame_before(frame, (WindowFrame_t *)heap->pdata[parent]))
+            break;
+        heap->pdata[i] = heap->pdata[parent];
+        i = parent;
+    }
+    heap->pdata[i] = frame;
+}
+
+static WindowFrame_t *
+window_heap_pop(GPtrArray *heap)
+{
+    WindowFrame_t *top = (WindowFrame_t *)heap->pdata[0];
+    WindowFrame_t *last = (WindowFrame_t *)g_ptr_array_remove_index(heap, heap->len - 1);
+    guint i = 0;
+
+    if (heap->len == 0)
+        return top;
+
+    for (;;) {
+        guint child = 2 * i + 1;
+
+        if (child >= heap->len)
+            break;
+        if (child + 1 < heap->len &&
+            window_frame_before((WindowFrame_t *)heap->pdata[child + 1], (WindowFrame_t *)heap->pdata[child]))
+            child++;
+        if (!window_frame_before((WindowFrame_t *)heap->pdata[child], last))
+            break;
+        heap->pdata[i] = heap->pdata[child];
+        i = child;
+    }
+    heap->pdata[i] = last;
+    return top;
+}
+
+static void
+window_frame_write(WindowFrame_t *frame, wtap *wth, wtap_dumper *pdh,
+                   const char *infile, const char *outfile)
+{
+    int    err;
+    gchar  *err_info;
+
+    DEBUG_PRINT("\nDumping frame (num=%u)\n", frame->num);
+
+    if (!wtap_dump(pdh, &frame->rec, ws_buffer_start_ptr(&frame->buf), &err, &err_info)) {
+        cfile_write_failure_message(infile, outfile, err, err_info, frame->num,
+                                    wtap_file_type_subtype(wth));
+        exit(1);
+    }
+    wtap_rec_reset(&frame->rec);
+}
+
+/*
+ * Reorder frames that are at most "window" frames away from their place
+ * in time order, reading and writing the files sequentially.  Up to
+ * "window" frames are held in a min-heap; once it is full, the earliest
+ * frame is written out for every frame read.  A frame that is earlier
+ * than one already written can't be put in its place any more; it is
+ * written as soon as it's read and counted, so that the user knows to
+ * rerun with a larger window or without one.
+ */
+static void
+reorder_in_window(wtap *wth, wtap_dumper *pdh, guint32 window,
+                  const char *infile, const char *outfile)
+{
+    int err;
+    gchar *err_info;
+    gint64 data_offset;
+    guint num_frames = 0;
+    guint wrong_order_count = 0;
+    guint late_count = 0;
+    GPtrArray *heap;
+    GPtrArray *free_frames;
+    WindowFrame_t *frame;
+    gboolean written_any = FALSE;
+    nstime_t last_written;
+    guint prev_num = 0;
+    nstime_t prev_time;
+
+    heap = g_ptr_array_sized_new(window + 1);
+    free_frames = g_ptr_array_new();
+    nstime_set_unset(&last_written);
+    nstime_set_unset(&prev_time);
+
+    for (;;) {
+        if (free_frames->len > 0) {
+            frame = (WindowFrame_t *)g_ptr_array_remove_index(free_frames, free_frames->len - 1);
+        } else {
+            frame = g_new(WindowFrame_t, 1);
+            wtap_rec_init(&frame->rec);
+            ws_buffer_init(&frame->buf, 1514);
+        }
+
+        if (!wtap_read(wth, &frame->rec, &frame->buf, &err, &err_info, &data_offset)) {
+            g_ptr_array_add(free_frames, frame);
+            break;
+        }
+
+        frame->num = ++num_frames;
+        if (frame->rec.presence_flags & WTAP_HAS_TS) {
+            frame->frame_time = frame->rec.ts;
+        } else {
+            nstime_set_unset(&frame->frame_time);
+        }
+
+        if (prev_num != 0 && nstime_cmp(&frame->frame_time, &prev_time) < 0) {
+            wrong_order_count++;
+        }
+        prev_num = frame->num;
+        prev_time = frame->frame_time;
+
+        if (written_any && nstime_cmp(&frame->frame_time, &last_written) < 0) {
+            /* Too late to put it in its place; write it now. */
+            late_count++;
+            window_frame_write(frame, wth, pdh, infile, outfile);
+            g_ptr_array_add(free_frames, frame);
+            continue;
+        }
+
+        window_heap_push(heap, frame);
+        if (heap->len > window) {
+            frame = window_heap_pop(heap);
+            written_any = TRUE;
+            last_written = frame->frame_time;
+            window_frame_write(frame, wth, pdh, infile, outfile);
+            g_ptr_array_add(free_frames, frame);
+        }
+    }
+    if (err != 0) {
+      /* Print a message noting that the read failed somewhere along the line. */
+      cfile_read_failure_message(infile, err, err_info);
+    }
+
+    /* Write out what is left in the window */
+    while (heap->len > 0) {
+        frame = window_heap_pop(heap);
+        window_frame_write(frame, wth, pdh, infile, outfile);
+        g_ptr_array_add(free_frames, frame);
+    }
+
+    printf("%u frames, %u out of order\n", num_frames, wrong_order_count);
+    if (late_count > 0) {
+        printf("%u frames were further out of order than the window of %u frames and were left in place\n",
+               late_count, window);
+    }
+
+    for (guint i = 0; i < free_frames->len; i++) {
+        frame = (WindowFrame_t *)free_frames->pdata[i];
+        wtap_rec_cleanup(&frame->rec);
+        ws_buffer_free(&frame->buf);
+        g_free(frame);
+    }
+    g_ptr_array_free(free_frames, TRUE);
+    g_ptr_array_free(heap, TRUE);
+}
+
+/*
+ * Open the output file, or the standard output for "-", with the same
+ * file type and encapsulation as the input file.
+ */
+static wtap_dumper *
+dump_open(wtap *wth, wtap_dump_params *params, const char *outfile)
+{
+    wtap_dumper *pdh;
+    int err;
+    gchar *err_info;
+
+    if (strcmp(outfile, "-") == 0) {
+      pdh = wtap_dump_open_stdout(wtap_file_type_subtype(wth),
+                                  WTAP_UNCOMPRESSED, params, &err, &err_info);
+    } else {
+      pdh = wtap_dump_open(outfile, wtap_file_type_subtype(wth),
+                           WTAP_UNCOMPRESSED, params, &err, &err_info);
+    }
+    g_free(params->idb_inf);
+    params->idb_inf = NULL;
+
+    if (pdh == NULL) {
+        cfile_dump_open_failure_message(outfile, err, err_info,
+                                        wtap_file_type_subtype(wth));
+    }
+    return pdh;
+}
+
+/* Most temporary files merged at once, to stay well clear of fd limits */
+#define MAX_MERGE_RUNS 256
+
+static int
+window_frames_compare(gconstpointer a, gconstpointer b)
+{
+    const WindowFrame_t *frame1 = *(const WindowFrame_t *const *) a;
+    const WindowFrame_t *frame2 = *(const WindowFrame_t *const *) b;
+
+    if (window_frame_before(frame1, frame2))
+        return -1;
+    return window_frame_before(frame2, frame1) ? 1 : 0;
+}
+
+/*
+ * Sort the first count frames in run and write them to pdh.
+ */
+static void
+run_write(GPtrArray *run, guint count, wtap *wth, wtap_dumper *pdh,
+          const char *infile, const char *outfile)
+{
+    guint i;
+
+    qsort(run->pdata, count, sizeof(gpointer), window_frames_compare);
+    for (i = 0; i < count; i++) {
+        window_frame_write((WindowFrame_t *)run->pdata[i], wth, pdh, infile, outfile);
+    }
+}
+
+/*
+ * Sort the first count frames in run and write them to a new temporary
+ * file, returning its name, or NULL on failure.
+ */
+static char *
+run_spill(GPtrArray *run, guint count, wtap *wth, const char *infile)
+{
+    wtap_dump_params params;
+    wtap_dumper *pdh;
+    char *tmpname;
+    int err;
+    gchar *err_info;
+
+    wtap_dump_params_init(&params, wth);
+    pdh = wtap_dump_open_tempfile(NULL, &tmpname, "reordercap",
+                                  wtap_file_type_subtype(wth),
+                                  WTAP_UNCOMPRESSED, &params, &err, &err_info);
+    g_free(params.idb_inf);
+    params.idb_inf = NULL;
+    if (pdh == NULL) {
+        cfile_dump_open_failure_message("temporary file", err, err_info,
+                                        wtap_file_type_subtype(wth));
+        wtap_dump_params_cleanup(&params);
+        return NULL;
+    }
+
+    run_write(run, count, wth, pdh, infile, tmpname);
+
+    if (!wtap_dump_close(pdh, NULL, &err, &err_info)) {
+        cfile_close_failure_message(tmpname, err, err_info);
+        wtap_dump_params_cleanup(&params);
+        ws_unlink(tmpname);
+        g_free(tmpname);
+        return NULL;
+    }
+    wtap_dump_params_cleanup(&params);
+    return tmpname;
+}
+
+static void
+report_merge_failure(merge_result status, const char *const *in_filenames,
+                     guint err_fileno, const char *out_filename, int file_type,
+                     int err, gchar *err_info, guint32 err_framenum)
+{
+    switch (status) {
+        case MERGE_ERR_CANT_OPEN_INFILE:
+            cfile_open_failure_message(in_filenames[err_fileno], err, err_info);
+            break;
+
+        case MERGE_ERR_CANT_OPEN_OUTFILE:
+            cfile_dump_open_failure_message(out_filename, err, err_info, file_type);
+            break;
+
+        case MERGE_ERR_CANT_READ_INFILE:
+            cfile_read_failure_message(in_filenames[err_fileno], err, err_info);
+            break;
+
+        case MERGE_ERR_CANT_WRITE_OUTFILE:
+            cfile_write_failure_message(in_filenames[err_fileno], out_filename,
+                    err, err_info, err_framenum, file_type);
+            break;
+
+        case MERGE_ERR_CANT_CLOSE_OUTFILE:
+            cfile_close_failure_message(out_filename, err, err_info);
+            break;
+
+        default:
+            cmdarg_err("Unknown merge_files error %d", status);
+            break;
+    }
+}
+
+/*
+ * Merge up to MAX_MERGE_RUNS sorted runs, names[0..count-1] in file
+ * order, into outfile, or into a new temporary file whose name is
+ * returned in tmpnamep if outfile is NULL.
+ *
+ * merge_files() takes equal time stamps from the highest-numbered input
+ * first, so the runs are passed last one first to keep frames with
+ * equal time stamps in their original order.
+ */
+static gboolean
+runs_merge(char **names, guint count, int file_type, guint snaplen,
+           const char *outfile, char **tmpnamep)
+{
+    const char **in_filenames;
+    merge_result status;
+    int err;
+    gchar *err_info = NULL;
+    guint err_fileno;
+    guint32 err_framenum;
+    guint i;
+
+    in_filenames = g_new(const char *, count);
+    for (i = 0; i < count; i++) {
+        in_filenames[i] = names[count - 1 - i];
+    }
+
+    if (outfile == NULL) {
+        status = merge_files_to_tempfile(NULL, tmpnamep, "reordercap", file_type,
+                                         in_filenames, count, FALSE,
+                                         IDB_MERGE_MODE_ALL_SAME, snaplen,
+                                         "Reordercap", NULL,
+                                         &err, &err_info, &err_fileno, &err_framenum);
+    } else if (strcmp(outfile, "-") == 0) {
+        status = merge_files_to_stdout(file_type, in_filenames, count, FALSE,
+                                       IDB_MERGE_MODE_ALL_SAME, snaplen,
+                                       "Reordercap", NULL,
+                                       &err, &err_info, &err_fileno, &err_framenum);
+    } else {
+        status = merge_files(outfile, file_type, in_filenames, count, FALSE,
+                             IDB_MERGE_MODE_ALL_SAME, snaplen,
+                             "Reordercap", NULL,
+                             &err, &err_info, &err_fileno, &err_framenum);
+    }
+    if (status != MERGE_OK) {
+        report_merge_failure(status, in_filenames, err_fileno,
+                             outfile ? outfile : "temporary file", file_type,
+                             err, err_info, err_framenum);
+    }
+    g_free(in_filenames);
+    return status == MERGE_OK;
+}
+
+/*
+ * Sort a file that may not fit in memory: read it in runs of at most
+ * max_in_memory frames, sort each run and write it to a temporary file,
+ * then merge the runs, MAX_MERGE_RUNS at a time, into the output file.
+ * Both the input and the temporary files are only read sequentially.
+ * If the whole file fits in one run it is written straight out.
+ */
+static gboolean
+reorder_external(wtap *wth, guint32 max_in_memory, gboolean write_output_regardless,
+                 const char *infile, const char *outfile)
+{
+    int file_type = wtap_file_type_subtype(wth);
+    guint snaplen = wtap_snapshot_length(wth);
+    int err;
+    gchar *err_info;
+    gint64 data_offset;
+    guint num_frames = 0;
+    guint wrong_order_count = 0;
+    nstime_t prev_time;
+    guint in_run = 0;
+    GPtrArray *run;
+    GPtrArray *runs;
+    WindowFrame_t *frame;
+    gboolean ok = TRUE;
+    guint i;
+
+    run = g_ptr_array_new();
+    runs = g_ptr_array_new();
+    nstime_set_unset(&prev_time);
+
+    for (;;) {
+        if (in_run == run->len) {
+            frame = g_new(WindowFrame_t, 1);
+            wtap_rec_init(&frame->rec);
+            ws_buffer_init(&frame->buf, 1514);
+            g_ptr_array_add(run, frame);
+        }
+        frame = (WindowFrame_t *)run->pdata[in_run];
+
+        if (!wtap_read(wth, &frame->rec, &frame->buf, &err, &err_info, &data_offset)) {
+            break;
+        }
+
+        frame->num = ++num_frames;
+        if (frame->rec.presence_flags & WTAP_HAS_TS) {
+            frame->frame_time = frame->rec.ts;
+        } else {
+            nstime_set_unset(&frame->frame_time);
+        }
+        if (num_frames > 1 && nstime_cmp(&frame->frame_time, &prev_time) < 0) {
+            wrong_order_count++;
+        }
+        prev_time = frame->frame_time;
+
+        if (++in_run == max_in_memory) {
+            char *tmpname;
+
+            tmpname = run_spill(run, in_run, wth, infile);
+            if (tmpname == NULL) {
+                ok = FALSE;
+                break;
+            }
+            g_ptr_array_add(runs, tmpname);
+            in_run = 0;
+        }
+    }
+    if (ok && err != 0) {
+      /* Print a message noting that the read failed somewhere along the line. */
+      cfile_read_failure_message(infile, err, err_info);
+    }
+
+    printf("%u frames, %u out of order\n", num_frames, wrong_order_count);
+
+    if (ok && !write_output_regardless && wrong_order_count == 0) {
+        printf("Not writing output file because input file is already in order.\n");
+    } else if (ok && runs->len == 0) {
+        /* Everything fit in memory; no need for temporary files */
+        wtap_dump_params params;
+        wtap_dumper *pdh;
+
+        wtap_dump_params_init(&params, wth);
+        pdh = dump_open(wth, &params, outfile);
+        if (pdh == NULL) {
+            ok = FALSE;
+        } else {
+            run_write(run, in_run, wth, pdh, infile, outfile);
+            if (!wtap_dump_close(pdh, NULL, &err, &err_info)) {
+                cfile_close_failure_message(outfile, err, err_info);
+                ok = FALSE;
+            }
+        }
+        wtap_dump_params_cleanup(&params);
+    } else if (ok) {
+        /* Spill the last, partly filled, run, then merge them all */
+        if (in_run > 0) {
+            char *tmpname;
+
+            tmpname = run_spill(run, in_run, wth, infile);
+            if (tmpname == NULL) {
+                ok = FALSE;
+            } else {
+                g_ptr_array_add(runs, tmpname);
+            }
+        }
+
+        while (ok && runs->len > MAX_MERGE_RUNS) {
+            GPtrArray *merged = g_ptr_array_new();
+
+            for (i = 0; ok && i < runs->len; i += MAX_MERGE_RUNS) {
+                char *tmpname = NULL;
+
+                ok = runs_merge((char **)&runs->pdata[i], MIN(runs->len - i, MAX_MERGE_RUNS),
+                                file_type, snaplen, NULL, &tmpname);
+                if (tmpname != NULL) {
+                    g_ptr_array_add(merged, tmpname);
+                }
+            }
+            for (i = 0; i < runs->len; i++) {
+                ws_unlink((char *)runs->pdata[i]);
+                g_free(runs->pdata[i]);
+            }
+            g_ptr_array_free(runs, TRUE);
+            runs = merged;
+        }
+        if (ok) {
+            ok = runs_merge((char **)runs->pdata, runs->len, file_type, snaplen,
+                            outfile, NULL);
+        }
+    }
+
+    for (i = 0; i < runs->len; i++) {
+        ws_unlink((char *)runs->pdata[i]);
+        g_free(runs->pdata[i]);
+    }
+    g_ptr_array_free(runs, TRUE);
+    for (i = 0; i < run->len; i++) {
+        frame = (WindowFrame_t *)run->pdata[i];
+        wtap_rec_cleanup(&frame->rec);
+        ws_buffer_free(&frame->buf);
+        g_free(frame);
+    }
+    g_ptr_array_free(run, TRUE);
+    return ok;
+}
+
 /*
  * General errors and warnings are reported with an console message
  * in reordercap.
@@ -175,20 +771,14 @@ main(int argc, char *argv[])
     };
     wtap *wth = NULL;
     wtap_dumper *pdh = NULL;
-    wtap_rec rec;
-    Buffer buf;
     int err;
     gchar *err_info;
-    gint64 data_offset;
-    guint wrong_order_count = 0;
     gboolean write_output_regardless = TRUE;
-    guint i;
+    guint32 reorder_window = 0;
+    guint32 max_in_memory = 0;
     wtap_dump_params params;
     int                          ret = EXIT_SUCCESS;
 
-    GPtrArray *frames;
-    FrameRecord_t *prevFrame = NULL;
-
     int opt;
     static const struct ws_option long_options[] = {
         {"help", ws_no_argument, NULL, 'h'},
@@ -234,11 +824,17 @@ main(int argc, char *argv[])
     wtap_init(TRUE);
 
     /* Process the options first */
-    while ((opt = ws_getopt_long(argc, argv, "hnv", long_options, NULL)) != -1) {
+    while ((opt = ws_getopt_long(argc, argv, "hm:nvw:", long_options, NULL)) != -1) {
         switch (opt) {
             case 'n':
                 write_output_regardless = FALSE;
                 break;
+            case 'm':
+                max_in_memory = get_nonzero_guint32(ws_optarg, "maximum frames in memory");
+                break;
+            case 'w':
+                reorder_window = get_nonzero_guint32(ws_optarg, "reorder window");
+                break;
             case 'h':
                 show_help_header("Reorder timestamps of input file frames into output file.");
                 print_usage(stdout);
@@ -253,6 +849,17 @@ main(int argc, char *argv[])
         }
     }
 
+    if (reorder_window > 0 && max_in_memory > 0) {
+        cmdarg_err("-m can't be used with -w.");
+        ret = WS_EXIT_INVALID_OPTION;
+        goto clean_exit;
+    }
+    if (reorder_window > 0 && !write_output_regardless) {
+        cmdarg_err("-n can't be used with -w, as the output is written while the input is read.");
+        ret = WS_EXIT_INVALID_OPTION;
+        goto clean_exit;
+    }
+
     /* Remaining args are file names */
     file_count = argc - ws_optind;
     if (file_count == 2) {
@@ -278,87 +885,31 @@ main(int argc, char *argv[])
 
     wtap_dump_params_init(&params, wth);
 
-    /* Open outfile (same filetype/encap as input file) */
-    if (strcmp(outfile, "-") == 0) {
-      pdh = wtap_dump_open_stdout(wtap_file_type_subtype(wth),
-                                  WTAP_UNCOMPRESSED, &params, &err, &err_info);
-    } else {
-      pdh = wtap_dump_open(outfile, wtap_file_type_subtype(wth),
-                           WTAP_UNCOMPRESSED, &params, &err, &err_info);
+    if (max_in_memory > 0) {
+        /* The output is written by the merge, or by reorder_external()
+           itself if the whole file fits in memory. */
+        wtap_dump_params_cleanup(&params);
+        if (!reorder_external(wth, max_in_memory, write_output_regardless, infile, outfile)) {
+            ret = OUTPUT_FILE_ERROR;
+        }
+        wtap_close(wth);
+        goto clean_exit;
     }
-    g_free(params.idb_inf);
-    params.idb_inf = NULL;
 
+    /* Open outfile (same filetype/encap as input file) */
+    pdh = dump_open(wth, &params, outfile);
     if (pdh == NULL) {
-        cfile_dump_open_failure_message(outfile, err, err_info,
-                                        wtap_file_type_subtype(wth));
         wtap_dump_params_cleanup(&params);
         ret = OUTPUT_FILE_ERROR;
         goto clean_exit;
     }
 
-    /* Allocate the array of frame pointers. */
-    frames = g_ptr_array_new();
-
-    /* Read each frame from infile */
-    wtap_rec_init(&rec);
-    ws_buffer_init(&buf, 1514);
-    while (wtap_read(wth, &rec, &buf, &err, &err_info, &data_offset)) {
-        FrameRecord_t *newFrameRecord;
-
-        newFrameRecord = g_slice_new(FrameRecord_t);
-        newFrameRecord->num = frames->len + 1;
-        newFrameRecord->offset = data_offset;
-        if (rec.presence_flags & WTAP_HAS_TS) {
-            newFrameRecord->frame_time = rec.ts;
-        } else {
-            nstime_set_unset(&newFrameRecord->frame_time);
-        }
-
-        if (prevFrame && frames_compare(&newFrameRecord, &prevFrame) < 0) {
-           wrong_order_count++;
-        }
-
-        g_ptr_array_add(frames, newFrameRecord);
-        prevFrame = newFrameRecord;
-        wtap_rec_reset(&rec);
-    }
-    wtap_rec_cleanup(&rec);
-    ws_buffer_free(&buf);
-    if (err != 0) {
-      /* Print a message noting that the read failed somewhere along the line. */
-      cfile_read_failure_message(infile, err, err_info);
-    }
-
-    printf("%u frames, %u out of order\n", frames->len, wrong_order_count);
-
-    /* Sort the frames */
-    if (wrong_order_count > 0) {
-        g_ptr_array_sort(frames, frames_compare);
-    }
-
-    /* Write out each sorted frame in turn */
-    wtap_rec_init(&rec);
-    ws_buffer_init(&buf, 1514);
-    for (i = 0; i < frames->len; i++) {
-        FrameRecord_t *frame = (FrameRecord_t *)frames->pdata[i];
-
-        /* Avoid writing if already sorted and configured to */
-        if (write_output_regardless || (wrong_order_count > 0)) {
-            frame_write(frame, wth, pdh, &rec, &buf, infile, outfile);
-        }
-        g_slice_free(FrameRecord_t, frame);
-    }
-    wtap_rec_cleanup(&rec);
-    ws_buffer_free(&buf);
-
-    if (!write_output_regardless && (wrong_order_count == 0)) {
-        printf("Not writing output file because input file is already in order.\n");
+    if (reorder_window > 0) {
+        reorder_in_window(wth, pdh, reorder_window, infile, outfile);
+    } else {
+        reorder_whole_file(wth, pdh, write_output_regardless, infile, outfile);
     }
 
-    /* Free the whole array */
-    g_ptr_array_free(frames, TRUE);
-
     /* Close outfile */
     if (!wtap_dump_close(pdh, NULL, &err, &err_info)) {
         cfile_close_failure_message(outfile, err, err_info);
@@ -53,11 +53,23 @@
 
 #include "ringbuffer.h"
 #include <wsutil/file_util.h>
+#include <wsutil/wslog.h>
 
 #ifdef HAVE_ZLIB
 #include <zlib.h>
 #endif
 
+#ifdef HAVE_ZSTD
+#include <zstd.h>
+#ifndef ZSTD_CLEVEL_DEFAULT
+#define ZSTD_CLEVEL_DEFAULT 3
+#endif
+#endif
+
+#if defined(HAVE_ZLIB) || defined(HAVE_ZSTD)
+#define HAVE_RINGBUF_COMPRESS
+#endif
+
 /* Ringbuffer file structure */
 typedef struct _rb_file {
     gchar         *name;
@@ -65,6 +77,9 @@ typedef struct _rb_file {
 
 #define MAX_FILENAME_QUEUE  100
 
+/* Upper bound on the number of files compressed at the same time */
+#define MAX_COMPRESS_THREADS 4
+
 /** Ringbuffer data structure */
 typedef struct _ringbuf_data {
     rb_file      *files;
@@ -84,6 +99,9 @@ typedef struct _ringbuf_data {
 
     GMutex        mutex;               /**< mutex for oldnames */
     gchar        *oldnames[MAX_FILENAME_QUEUE];       /**< filename list of pending to be deleted */
+
+    GThreadPool  *compress_pool;       /**< workers compressing rotated files */
+    GThreadPool  *unlink_pool;         /**< worker removing files that dropped off the ring */
 } ringbuf_data;
 
 static ringbuf_data rb_data;
@@ -127,53 +145,148 @@ CleanupOldCap(gchar* name)
 
 #ifdef HAVE_ZLIB
 /*
- * compress capture file
+ * gzip the contents of fd into name.gz
  */
-static int
-ringbuf_exec_compress(gchar* name)
+static gboolean
+ringbuf_compress_gzip(int fd, const gchar *name, guint8 *buffer, size_t buffer_size)
 {
-    guint8  *buffer = NULL;
     gchar* outgz = NULL;
-    int  fd = -1;
     ssize_t nread;
-    gboolean delete_org_file = TRUE;
+    gboolean ok = TRUE;
     gzFile fi = NULL;
 
-    fd = ws_open(name, O_RDONLY | O_BINARY, 0000);
-    if (fd < 0) {
-        return -1;
-    }
-
     outgz = ws_strdup_printf("%s.gz", name);
     fi = gzopen(outgz, "wb");
     g_free(outgz);
     if (fi == NULL) {
-        ws_close(fd);
-        return -1;
-    }
-
-#define FS_READ_SIZE 65536
-    buffer = (guint8*)g_malloc(FS_READ_SIZE);
-    if (buffer == NULL) {
-        ws_close(fd);
-        gzclose(fi);
-        return -1;
+        return FALSE;
     }
 
-    while ((nread = ws_read(fd, buffer, FS_READ_SIZE)) > 0) {
+    while ((nread = ws_read(fd, buffer, (unsigned int)buffer_size)) > 0) {
         int n = gzwrite(fi, buffer, (unsigned int)nread);
         if (n <= 0) {
             /* mark compression as failed */
-            delete_org_file = FALSE;
+            ok = FALSE;
             break;
         }
     }
     if (nread < 0) {
         /* mark compression as failed */
-        delete_org_file = FALSE;
+        ok = FALSE;
+    }
+    if (gzclose(fi) != Z_OK) {
+        ok = FALSE;
+    }
+    return ok;
+}
+#endif
+
+#ifdef HAVE_ZSTD
+/*
+ * zstd-compress the contents of fd into name.zst
+ */
+static gboolean
+ringbuf_compress_zstd(int fd, const gchar *name, guint8 *buffer, size_t buffer_size)
+{
+    gchar* outzst = NULL;
+    FILE *fo;
+    ZSTD_CStream *cstream;
+    size_t out_size = ZSTD_CStreamOutSize();
+    guint8 *out_buffer;
+    ssize_t nread;
+    gboolean ok = TRUE;
+
+    outzst = ws_strdup_printf("%s.zst", name);
+    fo = ws_fopen(outzst, "wb");
+    g_free(outzst);
+    if (fo == NULL) {
+        return FALSE;
+    }
+
+    /* The ZSTD_CStream API goes back to 1.0, our minimum version. */
+    cstream = ZSTD_createCStream();
+    if (cstream == NULL || ZSTD_isError(ZSTD_initCStream(cstream, ZSTD_CLEVEL_DEFAULT))) {
+        ZSTD_freeCStream(cstream);
+        fclose(fo);
+        return FALSE;
+    }
+    out_buffer = (guint8*)g_malloc(out_size);
+
+    while ((nread = ws_read(fd, buffer, (unsigned int)buffer_size)) > 0) {
+        ZSTD_inBuffer input = { buffer, (size_t)nread, 0 };
+
+        while (input.pos < input.size) {
+            ZSTD_outBuffer output = { out_buffer, out_size, 0 };
+
+            if (ZSTD_isError(ZSTD_compressStream(cstream, &output, &input)) ||
+                fwrite(out_buffer, 1, output.pos, fo) != output.pos) {
+                ok = FALSE;
+                break;
+            }
+        }
+        if (!ok) {
+            break;
+        }
+    }
+    if (nread < 0) {
+        /* mark compression as failed */
+        ok = FALSE;
+    }
+
+    /* Flush the rest of the frame and write its epilogue. */
+    while (ok) {
+        ZSTD_outBuffer output = { out_buffer, out_size, 0 };
+        size_t remaining = ZSTD_endStream(cstream, &output);
+
+        if (ZSTD_isError(remaining) ||
+            fwrite(out_buffer, 1, output.pos, fo) != output.pos) {
+            ok = FALSE;
+        } else if (remaining == 0) {
+            break;
+        }
+    }
+
+    ZSTD_freeCStream(cstream);
+    g_free(out_buffer);
+    if (fclose(fo) == EOF) {
+        ok = FALSE;
+    }
+    return ok;
+}
+#endif
+
+#ifdef HAVE_RINGBUF_COMPRESS
+/*
+ * compress capture file
+ */
+static int
+ringbuf_exec_compress(gchar* name)
+{
+    guint8  *buffer = NULL;
+    int  fd = -1;
+    gboolean delete_org_file = FALSE;
+
+    fd = ws_open(name, O_RDONLY | O_BINARY, 0000);
+    if (fd < 0) {
+        g_free(name);
+        return -1;
+    }
+
+#define FS_READ_SIZE 65536
+    buffer = (guint8*)g_malloc(FS_READ_SIZE);
+
+#ifdef HAVE_ZLIB
+    if (strcmp(rb_data.compress_type, "gzip") == 0) {
+        delete_org_file = ringbuf_compress_gzip(fd, name, buffer, FS_READ_SIZE);
+    }
+#endif
+#ifdef HAVE_ZSTD
+    if (strcmp(rb_data.compress_type, "zstd") == 0) {
+        delete_org_file = ringbuf_compress_zstd(fd, name, buffer, FS_READ_SIZE);
     }
+#endif
+
     ws_close(fd);
-    gzclose(fi);
     g_free(buffer);
 
     /* delete the original file only if compression succeeds */
@@ -186,27 +299,102 @@ ringbuf_exec_compress(gchar* name)
 }
 
 /*
- * thread to compress capture file
+ * thread pool worker to compress capture file
  */
-static void*
-exec_compress_thread(void* arg)
+static void
+exec_compress_thread(gpointer data, gpointer user_data _U_)
 {
-    ringbuf_exec_compress((gchar*)arg);
-    return NULL;
+    ringbuf_exec_compress((gchar*)data);
 }
 
 /*
- * start a thread to compress capture file
+ * queue a capture file for compression
  */
 static int
 ringbuf_start_compress_file(rb_file* rfile)
 {
-    gchar* name = g_strdup(rfile->name);
-    g_thread_new("exec_compress", &exec_compress_thread, name);
+    gchar* name;
+
+    if (rb_data.compress_pool == NULL) {
+        rb_data.compress_pool = g_thread_pool_new(exec_compress_thread, NULL,
+                MIN((gint)g_get_num_processors(), MAX_COMPRESS_THREADS), FALSE, NULL);
+    }
+
+    /*
+     * If compression can't keep up with the rotation rate, leave the
+     * file uncompressed rather than letting the queue (and the disk
+     * space held by uncompressed files) grow without bound.
+     */
+    if (g_thread_pool_unprocessed(rb_data.compress_pool) >= MAX_FILENAME_QUEUE) {
+        ws_warning("Compression is %u files behind, leaving %s uncompressed",
+                g_thread_pool_unprocessed(rb_data.compress_pool), rfile->name);
+        return -1;
+    }
+
+    name = g_strdup(rfile->name);
+    g_thread_pool_push(rb_data.compress_pool, name, NULL);
     return 0;
 }
+
+/*
+ * wait for queued compressions to finish
+ */
+static void
+ringbuf_finish_compress(void)
+{
+    if (rb_data.compress_pool != NULL) {
+        g_thread_pool_free(rb_data.compress_pool, FALSE, TRUE);
+        rb_data.compress_pool = NULL;
+    }
+}
 #endif
 
+/*
+ * thread pool worker to remove a file that dropped off the ring
+ */
+static void
+exec_unlink_thread(gpointer data, gpointer user_data _U_)
+{
+    ws_unlink((gchar*)data);
+    g_free(data);
+}
+
+/*
+ * queue a file that dropped off the ring for removal; takes ownership of name
+ *
+ * Removing a large file can take a while on some file systems, and we
+ * don't want the capture to wait for it when switching files.
+ */
+static void
+ringbuf_start_unlink_file(gchar* name)
+{
+    if (rb_data.unlink_pool == NULL) {
+        rb_data.unlink_pool = g_thread_pool_new(exec_unlink_thread, NULL, 1, FALSE, NULL);
+    }
+
+    /* If removal can't keep up with the rotation rate, do it here. */
+    if (rb_data.unlink_pool == NULL ||
+        g_thread_pool_unprocessed(rb_data.unlink_pool) >= MAX_FILENAME_QUEUE) {
+        ws_unlink(name);
+        g_free(name);
+        return;
+    }
+
+    g_thread_pool_push(rb_data.unlink_pool, name, NULL);
+}
+
+/*
+ * wait for queued removals to finish
+ */
+static void
+ringbuf_finish_unlink(void)
+{
+    if (rb_data.unlink_pool != NULL) {
+        g_thread_pool_free(rb_data.unlink_pool, FALSE, TRUE);
+        rb_data.unlink_pool = NULL;
+    }
+}
+
 /*
  * create the next filename and open a new binary file with that name
  */
@@ -217,14 +405,16 @@ ringbuf_open_file(rb_file *rfile, int *err)
     char    timestr[14+1];
     time_t  current_time;
     struct tm *tm;
+    gchar   *old_name = NULL;
 
     if (rfile->name != NULL) {
         if (rb_data.unlimited == FALSE) {
-            /* remove old file (if any, so ignore error) */
-            ws_unlink(rfile->name);
+            /* remove old file (if any, so ignore error) once we know the new name */
+            old_name = rfile->name;
+            rfile->name = NULL;
         }
-#ifdef HAVE_ZLIB
-        else if (rb_data.compress_type != NULL && strcmp(rb_data.compress_type, "gzip") == 0) {
+#ifdef HAVE_RINGBUF_COMPRESS
+        else if (rb_data.compress_type != NULL && strcmp(rb_data.compress_type, "none") != 0) {
             ringbuf_start_compress_file(rfile);
         }
 #endif
@@ -248,6 +438,16 @@ ringbuf_open_file(rb_file *rfile, int *err)
         rfile->name = g_strconcat(rb_data.fprefix, "_", filenum, "_", timestr, rb_data.fsuffix, NULL);
     }
 
+    if (old_name != NULL) {
+        if (rfile->name != NULL && strcmp(old_name, rfile->name) != 0) {
+            ringbuf_start_unlink_file(old_name);
+        } else {
+            /* We're about to reuse the name, so remove it right away */
+            ws_unlink(old_name);
+            g_free(old_name);
+        }
+    }
+
     if (rfile->name == NULL) {
         if (err != NULL)
             *err = ENOMEM;
@@ -287,6 +487,7 @@ ringbuf_init(const char *capfile_name, guint num_files, gboolean group_read_acce
     rb_data.group_read_access = group_read_access;
     rb_data.name_h = NULL;
     rb_data.compress_type = compress_type;
+    rb_data.compress_pool = NULL;
     g_mutex_init(&rb_data.mutex);
 
     /* just to be sure ... */
@@ -550,6 +751,10 @@ ringbuf_free(void)
         rb_data.fsuffix = NULL;
     }
 
+#ifdef HAVE_RINGBUF_COMPRESS
+    ringbuf_finish_compress();
+#endif
+    ringbuf_finish_unlink();
     CleanupOldCap(NULL);
 }
 
@@ -489,9 +489,14 @@ sharkd_cmdarg_err_cont(const char *msg_format, va_list ap)
     fprintf(stderr, "\n");
 }
 
+/* Set if cfile holds a file loaded with sharkd_preload_cap_file(). */
+static gboolean cap_file_preloaded = FALSE;
+
 cf_status_t
 sharkd_cf_open(const char *fname, unsigned int type, gboolean is_tempfile, int *err)
 {
+    /* Loading another file replaces a preloaded one. */
+    cap_file_preloaded = FALSE;
     return cf_open(&cfile, fname, type, is_tempfile, err);
 }
 
@@ -501,6 +506,41 @@ sharkd_load_cap_file(void)
     return load_cap_file(&cfile, 0, 0);
 }
 
+int
+sharkd_preload_cap_file(const char *fname)
+{
+    int err = 0;
+
+    if (sharkd_cf_open(fname, WTAP_TYPE_AUTO, FALSE, &err) != CF_OK)
+        return err ? err : -1;
+
+    err = sharkd_load_cap_file();
+    cap_file_preloaded = (err == 0);
+    return err;
+}
+
+/*
+ * Reopen the random access file descriptor of the preloaded file, so that
+ * a forked session doesn't share its file offset with the other sessions.
+ */
+gboolean
+sharkd_reopen_cap_file(void)
+{
+    int err;
+
+    if (!cap_file_preloaded || cfile.provider.wth == NULL)
+        return TRUE;
+
+    return wtap_fdreopen(cfile.provider.wth, cfile.filename, &err);
+}
+
+/* Is fname the file that was preloaded and is still loaded? */
+gboolean
+sharkd_is_preloaded(const char *fname)
+{
+    return cap_file_preloaded && g_strcmp0(cfile.filename, fname) == 0;
+}
+
 frame_data *
 sharkd_get_frame(guint32 framenum)
 {
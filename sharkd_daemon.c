@@ -52,6 +52,7 @@
 
 static int mode = 0;
 static socket_handle_t _server_fd = INVALID_SOCKET;
+static const char *_preload_file = NULL;
 
 static socket_handle_t
 socket_init(char *path)
@@ -183,11 +184,15 @@ print_usage(FILE* output)
     fprintf(output, "  -v, --version            show version information\n");
     fprintf(output, "  -C <config profile>, --config-profile <config profile>\n");
     fprintf(output, "                           start with specified configuration profile\n");
+    fprintf(output, "  -l <file>, --preload <file>\n");
+    fprintf(output, "                           load this capture file before accepting sessions; sessions\n");
+    fprintf(output, "                           start with it loaded and share its memory where possible\n");
 
     fprintf(output, "\n");
     fprintf(output, "  Examples:\n");
     fprintf(output, "    sharkd -C myprofile\n");
     fprintf(output, "    sharkd -a tcp:127.0.0.1:4446 -C myprofile\n");
+    fprintf(output, "    sharkd -a tcp:127.0.0.1:4446 -l /captures/big.pcapng\n");
 
     fprintf(output, "\n");
     fprintf(output, "See the sharkd page of the Wireshark wiki for full details.\n");
@@ -217,7 +222,7 @@ sharkd_init(int argc, char **argv)
      * platform-dependent.
      */
 
-#define OPTSTRING "+" "a:hmvC:"
+#define OPTSTRING "+" "a:hl:mvC:"
 
     static const char    optstring[] = OPTSTRING;
 
@@ -227,6 +232,7 @@ sharkd_init(int argc, char **argv)
         {"help", ws_no_argument, NULL, 'h'},
         {"version", ws_no_argument, NULL, 'v'},
         {"config-profile", ws_required_argument, NULL, 'C'},
+        {"preload", ws_required_argument, NULL, 'l'},
         {0, 0, 0, 0 }
     };
 
@@ -316,6 +322,10 @@ sharkd_init(int argc, char **argv)
                     exit(0);
                     break;
 
+                case 'l':
+                    _preload_file = ws_optarg;
+                    break;
+
                 case 'm':
                     // m is an internal-only option used when the daemon session process is created
                     mode = SHARKD_MODE_GOLD_CONSOLE;
@@ -362,6 +372,26 @@ sharkd_loop(int argc _U_, char* argv[] _U_)
 sharkd_loop(int argc _U_, char* argv[])
 #endif
 {
+    /*
+     * Load the capture file before the session processes are created, so
+     * that they inherit the parsed file, the frame data and the dissection
+     * state, and share their memory until it is modified. On Windows the
+     * sessions are separate processes started with the same options, so
+     * each of them loads the file itself.
+     */
+#ifndef _WIN32
+    if (_preload_file != NULL)
+#else
+    if (_preload_file != NULL && (mode == SHARKD_MODE_CLASSIC_CONSOLE || mode == SHARKD_MODE_GOLD_CONSOLE))
+#endif
+    {
+        if (sharkd_preload_cap_file(_preload_file) != 0)
+        {
+            fprintf(stderr, "cannot preload %s\n", _preload_file);
+            return -1;
+        }
+    }
+
     if (mode == SHARKD_MODE_CLASSIC_CONSOLE || mode == SHARKD_MODE_GOLD_CONSOLE)
     {
         return sharkd_session_main(mode);
@@ -399,6 +429,14 @@ sharkd_loop(int argc _U_, char* argv[])
             dup2(fd, 1);
             close(fd);
 
+            /* The preloaded file's descriptor is shared with the other
+             * sessions, including its file offset, so get our own. */
+            if (_preload_file != NULL && !sharkd_reopen_cap_file())
+            {
+                fprintf(stderr, "cannot reopen %s\n", _preload_file);
+                exit(1);
+            }
+
             exit(sharkd_session_main(mode));
         }
 
@@ -25,6 +25,7 @@
 #include <wsutil/ws_assert.h>
 
 #include <file.h>
+#include <epan/app_mem_usage.h>
 #include <epan/epan_dissect.h>
 #include <epan/exceptions.h>
 #include <epan/color_filters.h>
@@ -81,6 +82,21 @@ struct sharkd_filter_item
 
 static GHashTable *filter_table = NULL;
 
+/*
+ * Column text of already rendered frames (default column set only), so that
+ * paging through a capture with "frames" requests doesn't dissect the same
+ * frames over and over again.
+ */
+struct sharkd_frames_cache_item
+{
+    gchar **cols;
+    gboolean has_comment; /* comment in the original block */
+};
+
+#define SHARKD_FRAMES_CACHE_MAX_ITEMS 100000
+
+static GHashTable *frames_cache = NULL;
+
 static int mode;
 static guint32 rpcid;
 
@@ -146,12 +162,30 @@ sharkd_json_value_stringf(const char *key, const char *format, ...)
     if (key)
         json_dumper_set_member_name(&dumper, key);
 
+    /*
+     * Format into a stack buffer and write it as a string value, so that
+     * the (short) values written for every frame neither allocate nor
+     * bypass JSON string escaping.
+     */
+    char sbuf[64];
+    char *str = sbuf;
+    int len;
+
     va_list ap;
     va_start(ap, format);
-    char* sformat = ws_strdup_printf("\"%s\"", format);
-    json_dumper_value_va_list(&dumper, sformat, ap);
-    g_free(sformat);
+    len = vsnprintf(sbuf, sizeof(sbuf), format, ap);
     va_end(ap);
+    if (len >= (int) sizeof(sbuf))
+    {
+        va_start(ap, format);
+        str = ws_strdup_vprintf(format, ap);
+        va_end(ap);
+    }
+
+    json_dumper_value_string(&dumper, len >= 0 ? str : "");
+
+    if (str != sbuf)
+        g_free(str);
 }
 
 static void
@@ -746,6 +780,22 @@ sharkd_session_filter_data(const char *filter)
     return l;
 }
 
+static void
+sharkd_session_frames_cache_item_free(gpointer data)
+{
+    struct sharkd_frames_cache_item *item = (struct sharkd_frames_cache_item *) data;
+
+    g_strfreev(item->cols);
+    g_free(item);
+}
+
+static void
+sharkd_session_frames_cache_clear(void)
+{
+    if (frames_cache)
+        g_hash_table_remove_all(frames_cache);
+}
+
 static gboolean
 sharkd_rtp_match_init(rtpstream_id_t *id, const char *init_str)
 {
@@ -1083,6 +1133,16 @@ sharkd_session_process_load(const char *buf, const jsmntok_t *tokens, int count)
 
     fprintf(stderr, "load: filename=%s\n", tok_file);
 
+    sharkd_session_frames_cache_clear();
+    sharkd_session_analyse_cache_clear();
+
+    /* The file was already loaded at startup; don't read it again. */
+    if (sharkd_is_preloaded(tok_file))
+    {
+        sharkd_json_simple_ok(rpcid);
+        return;
+    }
+
     if (sharkd_cf_open(tok_file, WTAP_TYPE_AUTO, FALSE, &err) != CF_OK)
     {
         sharkd_json_error(
@@ -1132,10 +1192,16 @@ sharkd_session_process_load(const char *buf, const jsmntok_t *tokens, int count)
  *   (o) filename - capture filename
  *   (o) filesize - capture filesize
  *   (o) columns  - array of column titles
+ *   (m) memory   - array of memory usage components:
+ *                  'name'  - component name
+ *                  'bytes' - memory used by the component
  */
 static void
 sharkd_session_process_status(void)
 {
+    const char *mem_name;
+    gsize mem_value;
+
     sharkd_json_result_prologue(rpcid);
 
     sharkd_json_value_anyf("frames", "%u", cfile.count);
@@ -1167,16 +1233,52 @@ sharkd_session_process_status(void)
         sharkd_json_array_close();
     }
 
+    sharkd_json_array_open("memory");
+    for (guint i = 0; (mem_name = memory_usage_get(i, &mem_value)) != NULL; i++)
+    {
+        json_dumper_begin_object(&dumper);
+        sharkd_json_value_string("name", mem_name);
+        sharkd_json_value_anyf("bytes", "%" G_GSIZE_FORMAT, mem_value);
+        json_dumper_end_object(&dumper);
+    }
+    sharkd_json_array_close();
+
     sharkd_json_result_epilogue();
 }
 
 struct sharkd_analyse_data
 {
     GHashTable *protocols_set;
+    GArray *protocols;
     nstime_t *first_time;
     nstime_t *last_time;
 };
 
+/*
+ * Result of the last "analyse" request. Computing it dissects every frame,
+ * so it's kept until the file is reloaded or a preference is changed.
+ */
+static struct
+{
+    gboolean valid;
+    guint32 frames;
+    GArray *protocols;      /* protocol ids, in order of first appearance */
+    gboolean has_time;
+    nstime_t first_time;
+    nstime_t last_time;
+} analyse_cache;
+
+static void
+sharkd_session_analyse_cache_clear(void)
+{
+    analyse_cache.valid = FALSE;
+    if (analyse_cache.protocols)
+    {
+        g_array_free(analyse_cache.protocols, TRUE);
+        analyse_cache.protocols = NULL;
+    }
+}
+
 static void
 sharkd_session_process_analyse_cb(epan_dissect_t *edt, proto_tree *tree _U_,
         struct epan_column_info *cinfo _U_, const GSList *data_src _U_, void *data)
@@ -1202,26 +1304,15 @@ sharkd_session_process_analyse_cb(epan_dissect_t *edt, proto_tree *tree _U_,
             if (!g_hash_table_lookup_extended(analyser->protocols_set, GUINT_TO_POINTER(proto_id), NULL, NULL))
             {
                 g_hash_table_insert(analyser->protocols_set, GUINT_TO_POINTER(proto_id), GUINT_TO_POINTER(proto_id));
-                sharkd_json_value_string(NULL, proto_get_protocol_filter_name(proto_id));
+                g_array_append_val(analyser->protocols, proto_id);
             }
         }
     }
 
 }
 
-/**
- * sharkd_session_process_status()
- *
- * Process analyse request
- *
- * Output object with attributes:
- *   (m) frames  - count of currently loaded frames
- *   (m) protocols - protocol list
- *   (m) first     - earliest frame time
- *   (m) last      - latest frame time
- */
 static void
-sharkd_session_process_analyse(void)
+sharkd_session_analyse_compute(void)
 {
     struct sharkd_analyse_data analyser;
     wtap_rec rec; /* Record metadata */
@@ -1230,12 +1321,7 @@ sharkd_session_process_analyse(void)
     analyser.first_time = NULL;
     analyser.last_time  = NULL;
     analyser.protocols_set = g_hash_table_new(NULL /* g_direct_hash() */, NULL /* g_direct_equal */);
-
-    sharkd_json_result_prologue(rpcid);
-
-    sharkd_json_value_anyf("frames", "%u", cfile.count);
-
-    sharkd_json_array_open("protocols");
+    analyser.protocols = g_array_new(FALSE, FALSE, sizeof(int));
 
     wtap_rec_init(&rec);
     ws_buffer_init(&rec_buf, 1514);
@@ -1270,15 +1356,16 @@ sharkd_session_process_analyse(void)
         }
     }
 
-    sharkd_json_array_close();
-
-    if (analyser.first_time)
-        sharkd_json_value_anyf("first", "%.9f", nstime_to_sec(analyser.first_time));
-
-    if (analyser.last_time)
-        sharkd_json_value_anyf("last", "%.9f", nstime_to_sec(analyser.last_time));
-
-    sharkd_json_result_epilogue();
+    sharkd_session_analyse_cache_clear();
+    analyse_cache.valid = TRUE;
+    analyse_cache.frames = cfile.count;
+    analyse_cache.protocols = analyser.protocols;
+    analyse_cache.has_time = (analyser.first_time != NULL);
+    if (analyse_cache.has_time)
+    {
+        analyse_cache.first_time = *analyser.first_time;
+        analyse_cache.last_time = *analyser.last_time;
+    }
 
     wtap_rec_cleanup(&rec);
     ws_buffer_free(&rec_buf);
@@ -1286,6 +1373,43 @@ sharkd_session_process_analyse(void)
     g_hash_table_destroy(analyser.protocols_set);
 }
 
+/**
+ * sharkd_session_process_status()
+ *
+ * Process analyse request
+ *
+ * Output object with attributes:
+ *   (m) frames  - count of currently loaded frames
+ *   (m) protocols - protocol list
+ *   (m) first     - earliest frame time
+ *   (m) last      - latest frame time
+ *
+ * The result is cached, see analyse_cache.
+ */
+static void
+sharkd_session_process_analyse(void)
+{
+    if (!analyse_cache.valid || analyse_cache.frames != cfile.count)
+        sharkd_session_analyse_compute();
+
+    sharkd_json_result_prologue(rpcid);
+
+    sharkd_json_value_anyf("frames", "%u", cfile.count);
+
+    sharkd_json_array_open("protocols");
+    for (guint i = 0; i < analyse_cache.protocols->len; i++)
+        sharkd_json_value_string(NULL, proto_get_protocol_filter_name(g_array_index(analyse_cache.protocols, int, i)));
+    sharkd_json_array_close();
+
+    if (analyse_cache.has_time)
+    {
+        sharkd_json_value_anyf("first", "%.9f", nstime_to_sec(&analyse_cache.first_time));
+        sharkd_json_value_anyf("last", "%.9f", nstime_to_sec(&analyse_cache.last_time));
+    }
+
+    sharkd_json_result_epilogue();
+}
+
 static column_info *
 sharkd_session_create_columns(column_info *cinfo, const char *buf, const jsmntok_t *tokens, int count)
 {
@@ -1358,39 +1482,36 @@ sharkd_session_create_columns(column_info *cinfo, const char *buf, const jsmntok
     return cinfo;
 }
 
-static void
-sharkd_session_process_frames_cb(epan_dissect_t *edt, proto_tree *tree _U_,
-        struct epan_column_info *cinfo, const GSList *data_src _U_, void *data _U_)
+static gboolean
+sharkd_session_block_has_comment(wtap_block_t pkt_block)
 {
-    packet_info *pi = &edt->pi;
-    frame_data *fdata = pi->fd;
-    wtap_block_t pkt_block = NULL;
     char *comment;
 
+    return (pkt_block != NULL &&
+            WTAP_OPTTYPE_SUCCESS == wtap_block_get_nth_string_option_value(pkt_block, OPT_COMMENT, 0, &comment));
+}
+
+static void
+sharkd_session_process_frames_write(frame_data *fdata, gchar **cols, gboolean has_comment)
+{
     json_dumper_begin_object(&dumper);
 
     sharkd_json_array_open("c");
-    for (int col = 0; col < cinfo->num_cols; ++col)
+    for (int col = 0; cols[col]; ++col)
     {
-        sharkd_json_value_string(NULL, get_column_text(cinfo, col));
+        sharkd_json_value_string(NULL, cols[col]);
     }
     sharkd_json_array_close();
 
-    sharkd_json_value_anyf("num", "%u", pi->num);
+    sharkd_json_value_anyf("num", "%u", fdata->num);
 
     /*
-     * Get the block for this record, if it has one.
+     * Does this record have any comments?
      */
     if (fdata->has_modified_block)
-        pkt_block = sharkd_get_modified_block(fdata);
-    else
-        pkt_block = pi->rec->block;
+        has_comment = sharkd_session_block_has_comment(sharkd_get_modified_block(fdata));
 
-    /*
-     * Does this record have any comments?
-     */
-    if (pkt_block != NULL &&
-            WTAP_OPTTYPE_SUCCESS == wtap_block_get_nth_string_option_value(pkt_block, OPT_COMMENT, 0, &comment))
+    if (has_comment)
         sharkd_json_value_anyf("ct", "true");
 
     if (fdata->ignored)
@@ -1408,6 +1529,42 @@ sharkd_session_process_frames_cb(epan_dissect_t *edt, proto_tree *tree _U_,
     json_dumper_end_object(&dumper);
 }
 
+static void
+sharkd_session_process_frames_cb(epan_dissect_t *edt, proto_tree *tree _U_,
+        struct epan_column_info *cinfo, const GSList *data_src _U_, void *data)
+{
+    packet_info *pi = &edt->pi;
+    frame_data *fdata = pi->fd;
+    gboolean cache = (data != NULL);
+    gchar **cols;
+    gboolean has_comment;
+
+    cols = g_new(gchar *, cinfo->num_cols + 1);
+    for (int col = 0; col < cinfo->num_cols; ++col)
+        cols[col] = g_strdup(get_column_text(cinfo, col));
+    cols[cinfo->num_cols] = NULL;
+
+    has_comment = sharkd_session_block_has_comment(pi->rec->block);
+
+    sharkd_session_process_frames_write(fdata, cols, has_comment);
+
+    if (cache)
+    {
+        struct sharkd_frames_cache_item *item;
+
+        /* Keep the memory bounded, start over when the cache is full. */
+        if (g_hash_table_size(frames_cache) >= SHARKD_FRAMES_CACHE_MAX_ITEMS)
+            g_hash_table_remove_all(frames_cache);
+
+        item = g_new(struct sharkd_frames_cache_item, 1);
+        item->cols = cols;
+        item->has_comment = has_comment;
+        g_hash_table_insert(frames_cache, GUINT_TO_POINTER(fdata->num), item);
+    }
+    else
+        g_strfreev(cols);
+}
+
 /**
  * sharkd_session_process_frames()
  *
@@ -1421,6 +1578,10 @@ sharkd_session_process_frames_cb(epan_dissect_t *edt, proto_tree *tree _U_,
  *   (o) limit=N  - show only N frames
  *   (o) refs  - list (comma separated) with sorted time reference frame numbers.
  *
+ * Column text of the default column set is cached between requests (and
+ * dropped on load or preference change), so paging with skip/limit
+ * only dissects frames which were not shown before.
+ *
  * Output array of frames with attributes:
  *   (m) c   - array of column data
  *   (m) num - frame number
@@ -1449,6 +1610,7 @@ sharkd_session_process_frames(const char *buf, const jsmntok_t *tokens, int coun
     Buffer rec_buf;   /* Record data */
     column_info *cinfo = &cfile.cinfo;
     column_info user_cinfo;
+    gboolean use_cache;
 
     if (tok_column)
     {
@@ -1501,6 +1663,8 @@ sharkd_session_process_frames(const char *buf, const jsmntok_t *tokens, int coun
             return;
     }
 
+    use_cache = (cinfo == &cfile.cinfo && !tok_refs);
+
     sharkd_json_result_array_prologue(rpcid);
 
     wtap_rec_init(&rec);
@@ -1546,11 +1710,27 @@ sharkd_session_process_frames(const char *buf, const jsmntok_t *tokens, int coun
         }
 
         fdata = sharkd_get_frame(framenum);
+
+        if (use_cache && fdata->color_filter != NULL)
+        {
+            const struct sharkd_frames_cache_item *item;
+
+            item = (const struct sharkd_frames_cache_item *) g_hash_table_lookup(frames_cache, GUINT_TO_POINTER(framenum));
+            if (item)
+            {
+                sharkd_session_process_frames_write(fdata, item->cols, item->has_comment);
+
+                if (limit && --limit == 0)
+                    break;
+                continue;
+            }
+        }
+
         status = sharkd_dissect_request(framenum,
                 (framenum != 1) ? 1 : 0, framenum - 1,
                 &rec, &rec_buf, cinfo,
                 (fdata->color_filter == NULL) ? SHARKD_DISSECT_FLAG_COLOR : SHARKD_DISSECT_FLAG_NULL,
-                &sharkd_session_process_frames_cb, NULL,
+                &sharkd_session_process_frames_cb, use_cache ? frames_cache : NULL,
                 &err, &err_info);
         switch (status) {
 
@@ -4328,6 +4508,7 @@ sharkd_session_process_complete(char *buf, const jsmntok_t *tokens, int count)
         void *proto_cookie;
         void *field_cookie;
         int proto_id;
+        header_field_info *hfinfo;
 
         sharkd_json_array_open("field");
 
@@ -4336,7 +4517,6 @@ sharkd_session_process_complete(char *buf, const jsmntok_t *tokens, int count)
             protocol_t *protocol = find_protocol_by_id(proto_id);
             const char *protocol_filter;
             const char *protocol_name;
-            header_field_info *hfinfo;
 
             if (!proto_is_protocol_enabled(protocol))
                 continue;
@@ -4354,30 +4534,31 @@ sharkd_session_process_complete(char *buf, const jsmntok_t *tokens, int count)
                 }
                 json_dumper_end_object(&dumper);
             }
+        }
 
-            if (!filter_with_dot)
-                continue;
-
-            for (hfinfo = proto_get_first_protocol_field(proto_id, &field_cookie); hfinfo != NULL; hfinfo = proto_get_next_protocol_field(proto_id, &field_cookie))
+        if (filter_with_dot)
+        {
+            /* Only the names sharing the prefix are visited, via the sorted name index */
+            for (hfinfo = proto_registrar_get_first_with_prefix(tok_field, &field_cookie); hfinfo != NULL; hfinfo = proto_registrar_get_next_with_prefix(tok_field, &field_cookie))
             {
-                if (hfinfo->same_name_prev_id != -1) /* ignore duplicate names */
+                if (hfinfo->parent == -1) /* protocols are listed above */
                     continue;
 
-                if (strlen(hfinfo->abbrev) >= filter_length && !g_ascii_strncasecmp(tok_field, hfinfo->abbrev, filter_length))
+                if (!proto_is_protocol_enabled(find_protocol_by_id(hfinfo->parent)))
+                    continue;
+
+                json_dumper_begin_object(&dumper);
                 {
-                    json_dumper_begin_object(&dumper);
-                    {
-                        sharkd_json_value_string("f", hfinfo->abbrev);
+                    sharkd_json_value_string("f", hfinfo->abbrev);
 
-                        /* XXX, skip displaying name, if there are multiple (to not confuse user) */
-                        if (hfinfo->same_name_next == NULL)
-                        {
-                            sharkd_json_value_anyf("t", "%d", hfinfo->type);
-                            sharkd_json_value_string("n", hfinfo->name);
-                        }
+                    /* XXX, skip displaying name, if there are multiple (to not confuse user) */
+                    if (hfinfo->same_name_next == NULL)
+                    {
+                        sharkd_json_value_anyf("t", "%d", hfinfo->type);
+                        sharkd_json_value_string("n", hfinfo->name);
                     }
-                    json_dumper_end_object(&dumper);
                 }
+                json_dumper_end_object(&dumper);
             }
         }
 
@@ -4525,6 +4706,12 @@ sharkd_session_process_setconf(char *buf, const jsmntok_t *tokens, int count)
 
     ret = prefs_set_pref(pref, &errmsg);
 
+    if (ret == PREFS_SET_OK)
+    {
+        sharkd_session_frames_cache_clear();
+        sharkd_session_analyse_cache_clear();
+    }
+
     switch (ret)
     {
         case PREFS_SET_OK:
@@ -5184,6 +5371,7 @@ sharkd_session_main(int mode_setting)
     dumper.output_file = stdout;
 
     filter_table = g_hash_table_new_full(g_str_hash, g_str_equal, g_free, sharkd_session_filter_free);
+    frames_cache = g_hash_table_new_full(g_direct_hash, g_direct_equal, NULL, sharkd_session_frames_cache_item_free);
 
 #ifdef HAVE_MAXMINDDB
     /* mmdbresolve was stopped before fork(), force starting it */
@@ -5232,6 +5420,8 @@ sharkd_session_main(int mode_setting)
     }
 
     g_hash_table_destroy(filter_table);
+    g_hash_table_destroy(frames_cache);
+    sharkd_session_analyse_cache_clear();
     g_free(tokens);
 
     return 0;
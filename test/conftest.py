@@ -19,6 +19,11 @@ def pytest_addoption(parser):
     parser.addoption('--enable-release', action='store_true',
         help='Enable release tests'
     )
+    parser.addoption('--enable-benchmark', action='store_true',
+        help='Enable benchmarks'
+    )
+    parser.addoption('--benchmark-output',
+        help='Append benchmark results to this file as JSON lines')
 
 from fixtures_ws import *
 
@@ -54,7 +54,7 @@ end
 --     number of verifyFields() * (1 + number of fields) +
 --     number of verifyResults() * (1 + 2 * number of values)
 --
-local taptests = { [FRAME]=4, [OTHER]=413 }
+local taptests = { [FRAME]=4, [OTHER]=417 }
 
 local function getResults()
     print("\n-----------------------------\n")
@@ -439,6 +439,14 @@ function test_proto.dissector(tvbuf,pktinfo,root)
 
     verifyFields("basic.UINT16", uint16_match_fields)
 
+----------------------------------------
+    testing(OTHER, "Tvb uint getters")
+
+    execute ("tvb-uint", tvb_bytes:uint(0,2) == 255 )
+    execute ("tvb-uint", tvb_bytes:uint(4,2) == tvb_bytes:range(4,2):uint() )
+    execute ("tvb-le-uint", tvb_bytes:le_uint(4,2) == 128 )
+    execute ("tvb-uint-bad-length", not pcall (tvb_bytes.uint, tvb_bytes, 0, 5) )
+
 ----------------------------------------
     testing(OTHER, "Basic int24")
 
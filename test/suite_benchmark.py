@@ -0,0 +1,163 @@
+#
+# Wireshark tests
+#
+# SPDX-License-Identifier: GPL-2.0-or-later
+#
+'''Performance benchmarks
+
+These measure throughput rather than correctness and are skipped unless
+--enable-benchmark is passed. Run them on their own and without
+parallelism so that they don't compete with each other for CPU time:
+
+    pytest -n0 --enable-benchmark --benchmark-output=bench.json test/suite_benchmark.py
+
+Each benchmark appends one JSON object per line to the --benchmark-output
+file (or prints it if none is given), so results from different commits
+can be compared with any JSON tool.
+
+The workload is built deterministically by concatenating checked-in
+captures, so runs on the same machine are comparable.
+'''
+
+import json
+import os
+import subprocess
+import time
+import pytest
+
+# Captures making up the protocol mix, and how many times it is repeated.
+bench_mix = (
+    'dhcp.pcap',
+    'dns+icmp.pcapng.gz',
+    'http.pcap',
+    'sip-rtp.pcapng',
+    'tls12-aes256gcm.pcap',
+    'nfs.pcap',
+    'ntp.pcap',
+    'ipv6.pcap',
+)
+bench_repeat = 200
+
+# Each measurement is the best of this many runs.
+bench_runs = 3
+
+
+@pytest.fixture(scope='session')
+def benchmark_enabled(request):
+    if not request.config.getoption('--enable-benchmark', default=False):
+        pytest.skip('Benchmarks are not enabled via --enable-benchmark')
+
+
+@pytest.fixture(scope='session')
+def bench_version(cmd_tshark, make_env, benchmark_enabled):
+    version = subprocess.check_output((cmd_tshark, '--version'),
+        encoding='utf-8', env=make_env())
+    return version.splitlines()[0]
+
+
+@pytest.fixture(scope='session')
+def bench_capture(cmd_mergecap, capture_file, tmp_path_factory, make_env, benchmark_enabled):
+    '''Returns a pcapng file with the protocol mix repeated bench_repeat times.'''
+    path = str(tmp_path_factory.mktemp('benchmark') / 'mix.pcapng')
+    inputs = [capture_file(f) for f in bench_mix] * bench_repeat
+    subprocess.check_call([cmd_mergecap, '-a', '-F', 'pcapng', '-w', path] + inputs,
+        env=make_env())
+    return path
+
+
+@pytest.fixture(scope='session')
+def bench_packets(cmd_capinfos, bench_capture, make_env):
+    out = subprocess.check_output((cmd_capinfos, '-M', '-c', '-T', '-r', bench_capture),
+        encoding='utf-8', env=make_env())
+    return int(out.strip().split('\t')[-1])
+
+
+@pytest.fixture(scope='session')
+def bench_record(request, bench_version):
+    '''Returns a function that records a benchmark result.'''
+    output = request.config.getoption('--benchmark-output', default=None)
+
+    def record(name, seconds, packets=None, nbytes=None):
+        result = {
+            'benchmark': name,
+            'version': bench_version,
+            'seconds': round(seconds, 6),
+        }
+        if packets:
+            result['packets_per_second'] = round(packets / seconds)
+            result['ns_per_packet'] = round(seconds * 1e9 / packets)
+        if nbytes:
+            result['mb_per_second'] = round(nbytes / seconds / 1e6, 3)
+        line = json.dumps(result, sort_keys=True)
+        if output:
+            with open(output, 'a') as f:
+                f.write(line + '\n')
+        else:
+            print(line)
+    return record
+
+
+def best_time(args, env):
+    '''Runs a command bench_runs times, discarding its output, and returns
+    the shortest wall clock time.'''
+    best = None
+    for _ in range(bench_runs):
+        start = time.perf_counter()
+        subprocess.check_call(args, stdout=subprocess.DEVNULL, env=env)
+        elapsed = time.perf_counter() - start
+        best = elapsed if best is None else min(best, elapsed)
+    return best
+
+
+class TestBenchmarkFileIO:
+    def test_read_pcapng(self, cmd_capinfos, bench_capture, bench_packets, bench_record, test_env):
+        '''Raw wiretap read throughput.'''
+        elapsed = best_time((cmd_capinfos, '-c', bench_capture), test_env)
+        bench_record('read_pcapng', elapsed, bench_packets, os.path.getsize(bench_capture))
+
+    def test_read_pcap(self, cmd_capinfos, cmd_editcap, bench_capture, bench_packets, bench_record, result_file, test_env):
+        '''Raw wiretap read throughput for pcap. pcap has one link-layer
+        type per file, so the encapsulation is forced to Ethernet; only
+        the read speed matters here.'''
+        path = result_file('mix.pcap')
+        subprocess.check_call((cmd_editcap, '-F', 'pcap', '-T', 'ether', bench_capture, path), env=test_env)
+        elapsed = best_time((cmd_capinfos, '-c', path), test_env)
+        bench_record('read_pcap', elapsed, bench_packets, os.path.getsize(path))
+
+    def test_editcap(self, cmd_editcap, bench_capture, bench_packets, bench_record, result_file, test_env):
+        elapsed = best_time((cmd_editcap, bench_capture, result_file('out.pcapng')), test_env)
+        bench_record('editcap', elapsed, bench_packets, os.path.getsize(bench_capture))
+
+    def test_mergecap(self, cmd_mergecap, bench_capture, bench_packets, bench_record, result_file, test_env):
+        elapsed = best_time((cmd_mergecap, '-w', result_file('out.pcapng'), bench_capture, bench_capture), test_env)
+        bench_record('mergecap', elapsed, 2 * bench_packets, 2 * os.path.getsize(bench_capture))
+
+
+class TestBenchmarkDissection:
+    def test_dissect_no_tree(self, cmd_tshark, bench_capture, bench_packets, bench_record, test_env):
+        '''Dissection without building a protocol tree, as for plain tshark -r.'''
+        elapsed = best_time((cmd_tshark, '-n', '-r', bench_capture), test_env)
+        bench_record('dissect_summary', elapsed, bench_packets)
+
+    def test_dissect_tree(self, cmd_tshark, bench_capture, bench_packets, bench_record, test_env):
+        '''Dissection with a full protocol tree.'''
+        elapsed = best_time((cmd_tshark, '-n', '-V', '-r', bench_capture), test_env)
+        bench_record('dissect_verbose', elapsed, bench_packets)
+
+    def test_dfilter(self, cmd_tshark, bench_capture, bench_packets, bench_record, test_env):
+        '''Display filter evaluation, relative to plain dissection.'''
+        dfilter = 'ip.addr in {10.0.0.0/8 192.168.0.0/16} && (udp.port == 53 || tcp.port in {80 443 2049}) && frame.len > 100'
+        baseline = best_time((cmd_tshark, '-n', '-r', bench_capture, '-T', 'fields', '-e', 'frame.number'), test_env)
+        elapsed = best_time((cmd_tshark, '-n', '-r', bench_capture, '-Y', dfilter, '-T', 'fields', '-e', 'frame.number'), test_env)
+        bench_record('dfilter_overhead', max(elapsed - baseline, 1e-6), bench_packets)
+
+
+class TestBenchmarkOutput:
+    def test_output_fields(self, cmd_tshark, bench_capture, bench_packets, bench_record, test_env):
+        elapsed = best_time((cmd_tshark, '-n', '-r', bench_capture, '-T', 'fields',
+            '-e', 'frame.number', '-e', 'ip.src', '-e', 'ip.dst', '-e', '_ws.col.Protocol', '-e', '_ws.col.Info'), test_env)
+        bench_record('output_fields', elapsed, bench_packets)
+
+    def test_output_ek(self, cmd_tshark, bench_capture, bench_packets, bench_record, test_env):
+        elapsed = best_time((cmd_tshark, '-n', '-r', bench_capture, '-T', 'ek'), test_env)
+        bench_record('output_ek', elapsed, bench_packets)
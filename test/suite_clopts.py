@@ -121,6 +121,26 @@ class TestTsharkOptions:
         assert obj.get('ip.proto', 'NOT FOUND') == ['6']
         assert obj.get('http.host', 'NOT FOUND') == 'NOT FOUND'
 
+    def test_tshark_print_memory_stats(self, cmd_tshark, capture_file, test_env):
+        process = subprocesstest.run((cmd_tshark, "-r", capture_file("http.pcap"),
+                    "--print-memory-stats",
+                    ), capture_output=True, env=test_env)
+        assert process.returncode == ExitCodes.OK
+        assert 'Memory usage:' in process.stderr
+        assert 'File scope' in process.stderr
+        assert 'Reassembly' in process.stderr
+
+    def test_tshark_metrics_file(self, cmd_tshark, capture_file, result_file, test_env):
+        metrics_file = result_file('metrics.prom')
+        process = subprocesstest.run((cmd_tshark, "-r", capture_file("http.pcap"),
+                    "--metrics-file", metrics_file,
+                    ), capture_output=True, env=test_env)
+        assert process.returncode == ExitCodes.OK
+        with open(metrics_file) as f:
+            metrics = f.read()
+        assert '# TYPE tshark_packets_read_total counter' in metrics
+        assert 'tshark_packets_read_total 1\n' in metrics
+
 
 class TestTsharkCaptureClopts:
     def test_tshark_invalid_capfilter(self, cmd_tshark, capture_interface, result_file, test_env):
@@ -203,6 +223,27 @@ class TestTsharkDumpGlossaries:
                 del ip_props[key]
         assert actual_obj == expected_obj
 
+    def test_tshark_glossary_dictionary_cache(self, cmd_tshark, base_env, conf_path):
+        '''Fields loaded from the Diameter and RADIUS dictionary caches'''
+        def dictionary_fields():
+            proc = subprocesstest.run((cmd_tshark, '-G', 'fields'), capture_output=True, env=base_env)
+            return [line for line in proc.stdout.splitlines()
+                    if '\tdiameter.' in line or '\tradius.' in line]
+        parsed = dictionary_fields()
+        assert os.path.isfile(os.path.join(conf_path, 'diameter_dict_cache'))
+        assert os.path.isfile(os.path.join(conf_path, 'radius_dict_cache'))
+        assert dictionary_fields() == parsed
+
+    def test_tshark_glossary_field_completions(self, cmd_tshark, base_env):
+        '''Field name completions are sorted and match the prefix'''
+        proc = subprocesstest.run((cmd_tshark, '-G', 'fields', 'tcp.fl'), capture_output=True, env=base_env)
+        names = [line.split('\t', 1)[0] for line in proc.stdout.splitlines()]
+        assert 'tcp.flags' in names
+        assert 'tcp.flags.syn' in names
+        assert all(name.startswith('tcp.fl') for name in names)
+        assert names == sorted(names, key=str.lower)
+        assert len(names) == len(set(names))
+
     def test_tshark_unicode_folders(self, cmd_tshark, unicode_env, features):
         '''Folders output with unicode'''
         if not features.have_lua:
@@ -90,3 +90,19 @@ class TestDfilterMembership:
     def test_membership_12_value_string(self, checkDFilterCount):
         dfilter = 'tcp.checksum.status in {"Unverified", "Good"}'
         checkDFilterCount(dfilter, 1)
+
+    def test_membership_13_large_set(self, checkDFilterCount):
+        dfilter = 'tcp.port in {1, 2, 3, 4, 5, 6, 7, 80}'
+        checkDFilterCount(dfilter, 1)
+
+    def test_membership_14_large_set_no_match(self, checkDFilterCount):
+        dfilter = 'tcp.port in {1, 2, 3, 4, 5, 6, 7, 8}'
+        checkDFilterCount(dfilter, 0)
+
+    def test_membership_15_large_set_range(self, checkDFilterCount):
+        dfilter = 'tcp.port in {1, 2, 3, 4, 5, 6, 10..2000, 3000..3300}'
+        checkDFilterCount(dfilter, 1)
+
+    def test_membership_16_large_set_subnet(self, checkDFilterCount):
+        dfilter = 'ip.addr in {1.1.1.1, 1.1.1.2, 1.1.1.3, 1.1.1.4, 1.1.1.5, 1.1.1.6, 1.1.1.7, 10.0.0.0/24}'
+        checkDFilterCount(dfilter, 1)
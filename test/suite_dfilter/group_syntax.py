@@ -322,6 +322,11 @@ class TestDfilterArithmetic:
         dfilter = 'udp.dstport * { udp.srcport / {5 - 4} } == udp.srcport * { 2 * udp.dstport - 68 }'
         checkDFilterCount(dfilter, 2)
 
+    def test_expr_3(self, checkDFilterCount):
+        # Constant division by zero isn't folded, and fails at run time.
+        dfilter = 'udp.dstport == 67 / 0'
+        checkDFilterCount(dfilter, 0)
+
 class TestDfilterFieldReference:
     trace_file = "ipoipoip.pcap"
 
@@ -41,6 +41,14 @@ class TestDfilterProtocol:
         dfilter = 'http contains "HEAD"'
         checkDFilterCount(dfilter, 1)
 
+    def test_contains_any_1(self, checkDFilterCount):
+        dfilter = 'http contains "XYZZY" or http contains "PLUGH" or http contains "HEAX" or http contains "EAD"'
+        checkDFilterCount(dfilter, 1)
+
+    def test_contains_any_2(self, checkDFilterCount):
+        dfilter = 'http contains "XYZZY" or http contains "PLUGH" or http contains "HEAX" or http contains "ZORK"'
+        checkDFilterCount(dfilter, 0)
+
     def test_protocol_1(self, checkDFilterSucceed):
         dfilter = 'frame contains aa.bb.ff'
         checkDFilterSucceed(dfilter)
@@ -75,7 +75,8 @@ class TestSharkd:
         check_sharkd_session((
             {"jsonrpc":"2.0", "id":1, "method":"status"},
         ), (
-            {"jsonrpc":"2.0","id":1,"result":{"frames":0,"duration":0.000000000,"columns":["No.","Time","Source","Destination","Protocol","Length","Info"]}},
+            {"jsonrpc":"2.0","id":1,"result":{"frames":0,"duration":0.000000000,"columns":["No.","Time","Source","Destination","Protocol","Length","Info"],
+                "memory": MatchList({"name": MatchAny(str), "bytes": MatchAny(int)})}},
         ))
 
     def test_sharkd_req_status(self, check_sharkd_session, capture_file):
@@ -88,7 +89,8 @@ class TestSharkd:
             {"jsonrpc":"2.0","id":1,"result":{"status":"OK"}},
             {"jsonrpc":"2.0","id":2,"result":{"frames": 4, "duration": 0.070345000,
                 "filename": "dhcp.pcap", "filesize": 1400,
-                "columns":["No.","Time","Source","Destination","Protocol","Length","Info"]}},
+                "columns":["No.","Time","Source","Destination","Protocol","Length","Info"],
+                "memory": MatchList({"name": MatchAny(str), "bytes": MatchAny(int)})}},
         ))
 
     def test_sharkd_req_analyse(self, check_sharkd_session, capture_file):
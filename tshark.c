@@ -36,6 +36,7 @@
 
 #include <epan/exceptions.h>
 #include <epan/epan.h>
+#include <epan/app_mem_usage.h>
 
 #include <ws_exit_codes.h>
 #include <wsutil/clopts_common.h>
@@ -66,6 +67,7 @@
 #include <epan/column.h>
 #include <epan/decode_as.h>
 #include <epan/print.h>
+#include <epan/reassemble.h>
 #include <epan/addr_resolv.h>
 #ifdef HAVE_LIBPCAP
 #include "ui/capture_ui_utils.h"
@@ -138,6 +140,8 @@
 #define LONGOPT_CAPTURE_COMMENT         LONGOPT_BASE_APPLICATION+6
 #define LONGOPT_HEXDUMP                 LONGOPT_BASE_APPLICATION+7
 #define LONGOPT_SELECTED_FRAME          LONGOPT_BASE_APPLICATION+8
+#define LONGOPT_PRINT_MEMORY_STATS      LONGOPT_BASE_APPLICATION+9
+#define LONGOPT_METRICS_FILE            LONGOPT_BASE_APPLICATION+10
 
 capture_file cfile;
 
@@ -171,6 +175,7 @@ static gboolean do_dissection;     /* TRUE if we have to dissect each packet */
 static gboolean print_packet_info; /* TRUE if we're to print packet information */
 static gboolean print_summary;     /* TRUE if we're to print packet summary information */
 static gboolean print_details;     /* TRUE if we're to print packet details information */
+static gboolean visible_proto_tree; /* TRUE if the protocol tree is "visible", i.e. fully built */
 static gboolean print_hex;         /* TRUE if we're to print hex/ascii information */
 static gboolean line_buffered;
 static gboolean quiet = FALSE;
@@ -193,6 +198,13 @@ static proto_node_children_grouper_func node_children_grouper = proto_node_group
 
 static json_dumper jdumper;
 
+/*
+ * Size of the standard I/O buffer used for packet output when we're not
+ * line-buffering; the default buffer for pipes is typically only a page,
+ * which means one write() every few packets with "-T fields" or "-T ek".
+ */
+#define OUTPUT_BUFFER_SIZE (1024 * 1024)
+
 /* The line separator used between packets, changeable via the -S option */
 static const char *separator = "";
 
@@ -201,6 +213,17 @@ static GPtrArray *capture_comments = NULL;
 
 static gboolean prefs_loaded = FALSE;
 
+static gboolean print_memory_stats = FALSE;
+
+/* --metrics-file; the counters are only kept when it's set */
+#define METRICS_INTERVAL_US G_USEC_PER_SEC
+static const char *metrics_file = NULL;
+static gint64 metrics_next_write;
+static guint64 metrics_packets_dissected;
+static guint64 metrics_packets_passed;
+static guint64 metrics_packets_dropped;
+static gint64 metrics_process_us;
+
 #ifdef HAVE_LIBPCAP
 /*
  * TRUE if we're to print packet counts to keep track of captured packets.
@@ -263,6 +286,71 @@ static void tshark_cmdarg_err_cont(const char *msg_format, va_list ap);
 
 static GHashTable *output_only_tables = NULL;
 
+static void
+metrics_append(GString *str, const char *name, const char *type, const char *help,
+               const char *value_fmt, ...) G_GNUC_PRINTF(5, 6);
+
+static void
+metrics_append(GString *str, const char *name, const char *type, const char *help,
+               const char *value_fmt, ...)
+{
+    va_list ap;
+
+    g_string_append_printf(str, "# HELP %s %s\n# TYPE %s %s\n%s ", name, help, name, type, name);
+    va_start(ap, value_fmt);
+    g_string_append_vprintf(str, value_fmt, ap);
+    va_end(ap);
+    g_string_append_c(str, '\n');
+}
+
+/*
+ * Write the packet counters to the --metrics-file, in the Prometheus
+ * text exposition format. The file is replaced atomically, so readers
+ * never see a partial update.
+ */
+static void
+write_metrics_file(capture_file *cf)
+{
+    static gboolean reported_error = FALSE;
+    GString *str = g_string_new(NULL);
+    GError *error = NULL;
+
+    metrics_append(str, "tshark_packets_read_total", "counter",
+                   "Packets read from the capture.", "%u", cf->count);
+    metrics_append(str, "tshark_packets_dissected_total", "counter",
+                   "Packets dissected.", "%" PRIu64, metrics_packets_dissected);
+    metrics_append(str, "tshark_packets_passed_total", "counter",
+                   "Packets that passed the read or display filter.", "%" PRIu64, metrics_packets_passed);
+    metrics_append(str, "tshark_packets_dropped_total", "counter",
+                   "Packets dropped while capturing, as reported by dumpcap.", "%" PRIu64, metrics_packets_dropped);
+    metrics_append(str, "tshark_process_seconds_total", "counter",
+                   "Time spent dissecting, filtering, tapping and printing packets.", "%.6f", metrics_process_us / 1e6);
+
+    if (!g_file_set_contents(metrics_file, str->str, str->len, &error)) {
+        /* Don't flood the terminal if the file can't be written. */
+        if (!reported_error) {
+            cmdarg_err("Can't write metrics file: %s", error->message);
+            reported_error = TRUE;
+        }
+        g_error_free(error);
+    }
+    g_string_free(str, TRUE);
+}
+
+static void
+write_memory_stats(FILE *output)
+{
+    const char *name;
+    gsize value;
+
+    fprintf(output, "Memory usage:\n");
+    for (guint i = 0; (name = memory_usage_get(i, &value)) != NULL; i++) {
+        char *size_str = format_size(value, FORMAT_SIZE_UNIT_BYTES, FORMAT_SIZE_PREFIX_SI);
+        fprintf(output, "  %-24s %s\n", name, size_str);
+        g_free(size_str);
+    }
+}
+
 static void
 list_capture_types(void)
 {
@@ -492,6 +580,10 @@ print_usage(FILE *output)
     fprintf(output, "                           specified protocols within the mapping file\n");
     fprintf(output, "  --temp-dir <directory>   write temporary files to this directory\n");
     fprintf(output, "                           (default: %s)\n", g_get_tmp_dir());
+    fprintf(output, "  --print-memory-stats     print memory usage per component to stderr before\n");
+    fprintf(output, "                           exiting\n");
+    fprintf(output, "  --metrics-file <file>    periodically write packet counters to <file>, in the\n");
+    fprintf(output, "                           Prometheus text format\n");
     fprintf(output, "\n");
 
     ws_log_print_usage(output);
@@ -856,6 +948,8 @@ main(int argc, char *argv[])
         {"capture-comment", ws_required_argument, NULL, LONGOPT_CAPTURE_COMMENT},
         {"hexdump", ws_required_argument, NULL, LONGOPT_HEXDUMP},
         {"selected-frame", ws_required_argument, NULL, LONGOPT_SELECTED_FRAME},
+        {"print-memory-stats", ws_no_argument, NULL, LONGOPT_PRINT_MEMORY_STATS},
+        {"metrics-file", ws_required_argument, NULL, LONGOPT_METRICS_FILE},
         {0, 0, 0, 0}
     };
     gboolean             arg_error = FALSE;
@@ -1712,6 +1806,12 @@ main(int argc, char *argv[])
                     goto clean_exit;
                 }
                 break;
+            case LONGOPT_PRINT_MEMORY_STATS:
+                print_memory_stats = TRUE;
+                break;
+            case LONGOPT_METRICS_FILE:
+                metrics_file = ws_optarg;
+                break;
             default:
             case '?':        /* Bad flag - print usage message */
                 switch(ws_optopt) {
@@ -2121,6 +2221,16 @@ main(int argc, char *argv[])
             goto clean_exit;
         }
     }
+
+    /* The protocol tree will be "visible", i.e., printed, only if we're
+       printing packet details, which is true if we're printing stuff
+       ("print_packet_info" is true) and we're in verbose mode
+       ("packet_details" is true). Fields written with "-T fields" are
+       output from their values, so unless some of them need their
+       text representation, it's enough to prime the tree with them. */
+    visible_proto_tree = print_packet_info && print_details;
+    if (output_action == WRITE_FIELDS && !output_fields_need_visible_tree(output_fields))
+        visible_proto_tree = FALSE;
 #ifdef HAVE_LIBPCAP
     /* We currently don't support taps, or printing dissected packets,
        if we're writing to a pipe. */
@@ -2203,6 +2313,12 @@ main(int argc, char *argv[])
     cfile.dfcode = dfcode;
 
     if (print_packet_info) {
+        /* Unless we've been asked to flush after every packet, give
+           the standard output a large buffer, so that dissection
+           isn't interrupted by a system call every few packets. */
+        if (!line_buffered)
+            setvbuf(stdout, NULL, _IOFBF, OUTPUT_BUFFER_SIZE);
+
         /* If we're printing as text or PostScript, we have
            to create a print stream. */
         if (output_action == WRITE_TEXT) {
@@ -2533,6 +2649,17 @@ main(int argc, char *argv[])
     if (draw_taps)
         draw_tap_listeners(TRUE);
 
+    if (reassembly_get_evicted_count() > 0 && !really_quiet) {
+        fprintf(stderr, "%" PRIu64 " incomplete reassemblies discarded (protocols.max_incomplete_reassemblies)\n",
+                reassembly_get_evicted_count());
+    }
+
+    if (print_memory_stats)
+        write_memory_stats(stderr);
+
+    if (metrics_file)
+        write_metrics_file(&cfile);
+
     if (tls_session_keys_file) {
         gsize keylist_length;
         gchar *keylist = ssl_export_sessions(&keylist_length);
@@ -2604,6 +2731,22 @@ tshark_epan_new(capture_file *cf)
     return epan_new(&cf->provider, &funcs);
 }
 
+/*
+ * Hidden columns are never printed, so, unless a tap wants the columns,
+ * don't bother filling them in; dissectors can then skip formatting
+ * text that would only go into them.
+ */
+static void
+set_needed_columns(column_info *cinfo, guint flags)
+{
+    gint i;
+
+    for (i = 0; i < cinfo->num_cols; i++) {
+        col_set_needed(cinfo, i,
+                       (flags & TL_REQUIRES_COLUMNS) || get_column_visible(i));
+    }
+}
+
 #ifdef HAVE_LIBPCAP
 static gboolean
 capture(void)
@@ -2846,6 +2989,7 @@ capture_input_new_packets(capture_session *cap_session, int to_read)
 
     /* Get the union of the flags for all tap listeners. */
     tap_flags = union_of_tap_listener_flags();
+    set_needed_columns(&cf->cinfo, tap_flags);
 
     if (do_dissection) {
         gboolean create_proto_tree;
@@ -2878,11 +3022,8 @@ capture_input_new_packets(capture_session *cap_session, int to_read)
              (tap_flags & TL_REQUIRES_PROTO_TREE) || postdissectors_want_hfids() ||
              have_custom_cols(&cf->cinfo) || dissect_color);
 
-        /* The protocol tree will be "visible", i.e., printed, only if we're
-           printing packet details, which is true if we're printing stuff
-           ("print_packet_info" is true) and we're in verbose mode
-           ("packet_details" is true). */
-        edt = epan_dissect_new(cf->epan, create_proto_tree, print_packet_info && print_details);
+        /* See main() for when the protocol tree is "visible". */
+        edt = epan_dissect_new(cf->epan, create_proto_tree, visible_proto_tree);
 
         wtap_rec_init(&rec);
         ws_buffer_init(&buf, 1514);
@@ -2890,7 +3031,7 @@ capture_input_new_packets(capture_session *cap_session, int to_read)
         while (to_read-- && cf->provider.wth) {
             wtap_cleareof(cf->provider.wth);
             ret = wtap_read(cf->provider.wth, &rec, &buf, &err, &err_info, &data_offset);
-            reset_epan_mem(cf, edt, create_proto_tree, print_packet_info && print_details);
+            reset_epan_mem(cf, edt, create_proto_tree, visible_proto_tree);
             if (ret == FALSE) {
                 /* read from file failed, tell the capture child to stop */
                 sync_pipe_stop(cap_session);
@@ -2984,6 +3125,8 @@ capture_input_drops(capture_session *cap_session _U_, guint32 dropped, const cha
         fprintf(stderr, "\n");
     }
 
+    metrics_packets_dropped += dropped;
+
     if (dropped != 0) {
         /* We're printing packet counts to stderr.
            Send a newline so that we move to the line after the packet count. */
@@ -3315,6 +3458,9 @@ process_packet_second_pass(capture_file *cf, epan_dissect_t *edt,
 
         col_custom_prime_edt(edt, &cf->cinfo);
 
+        if (output_action == WRITE_FIELDS)
+            output_fields_prime_edt(output_fields, edt);
+
         /* We only need the columns if either
            1) some tap needs the columns
            or
@@ -3437,6 +3583,7 @@ process_cap_file_second_pass(capture_file *cf, wtap_dumper *pdh,
 
     /* Get the union of the flags for all tap listeners. */
     tap_flags = union_of_tap_listener_flags();
+    set_needed_columns(&cf->cinfo, tap_flags);
 
     if (do_dissection) {
         gboolean create_proto_tree;
@@ -3460,11 +3607,8 @@ process_cap_file_second_pass(capture_file *cf, wtap_dumper *pdh,
 
         ws_debug("tshark: create_proto_tree = %s", create_proto_tree ? "TRUE" : "FALSE");
 
-        /* The protocol tree will be "visible", i.e., printed, only if we're
-           printing packet details, which is true if we're printing stuff
-           ("print_packet_info" is true) and we're in verbose mode
-           ("packet_details" is true). */
-        edt = epan_dissect_new(cf->epan, create_proto_tree, print_packet_info && print_details);
+        /* See main() for when the protocol tree is "visible". */
+        edt = epan_dissect_new(cf->epan, create_proto_tree, visible_proto_tree);
     }
 
     /*
@@ -3546,6 +3690,7 @@ process_cap_file_single_pass(capture_file *cf, wtap_dumper *pdh,
 
     /* Get the union of the flags for all tap listeners. */
     tap_flags = union_of_tap_listener_flags();
+    set_needed_columns(&cf->cinfo, tap_flags);
 
     if (do_dissection) {
         /*
@@ -3575,11 +3720,8 @@ process_cap_file_single_pass(capture_file *cf, wtap_dumper *pdh,
 
         ws_debug("tshark: create_proto_tree = %s", create_proto_tree ? "TRUE" : "FALSE");
 
-        /* The protocol tree will be "visible", i.e., printed, only if we're
-           printing packet details, which is true if we're printing stuff
-           ("print_packet_info" is true) and we're in verbose mode
-           ("packet_details" is true). */
-        edt = epan_dissect_new(cf->epan, create_proto_tree, print_packet_info && print_details);
+        /* See main() for when the protocol tree is "visible". */
+        edt = epan_dissect_new(cf->epan, create_proto_tree, visible_proto_tree);
     }
 
     /*
@@ -3608,7 +3750,7 @@ process_cap_file_single_pass(capture_file *cf, wtap_dumper *pdh,
 
         ws_debug("tshark: processing packet #%d", framenum);
 
-        reset_epan_mem(cf, edt, create_proto_tree, print_packet_info && print_details);
+        reset_epan_mem(cf, edt, create_proto_tree, visible_proto_tree);
 
         if (process_packet_single_pass(cf, edt, data_offset, &rec, &buf, tap_flags)) {
             /* Either there's no read filtering or this packet passed the
@@ -3953,10 +4095,14 @@ process_packet_single_pass(capture_file *cf, epan_dissect_t *edt, gint64 offset,
     column_info    *cinfo;
     gboolean        passed;
     wtap_block_t    block = NULL;
+    gint64          start_time = 0;
 
     /* Count this packet. */
     cf->count++;
 
+    if (metrics_file)
+        start_time = g_get_monotonic_time();
+
     /* If we're not running a display filter and we're not printing any
        packet information, we don't need to do a dissection. This means
        that all packets can be marked as 'passed'. */
@@ -3981,6 +4127,9 @@ process_packet_single_pass(capture_file *cf, epan_dissect_t *edt, gint64 offset,
 
         col_custom_prime_edt(edt, &cf->cinfo);
 
+        if (output_action == WRITE_FIELDS)
+            output_fields_prime_edt(output_fields, edt);
+
         /* We only need the columns if either
            1) some tap needs the columns
            or
@@ -4052,6 +4201,20 @@ process_packet_single_pass(capture_file *cf, epan_dissect_t *edt, gint64 offset,
         frame_data_destroy(&fdata);
         rec->block = block;
     }
+
+    if (metrics_file) {
+        gint64 now = g_get_monotonic_time();
+
+        if (edt)
+            metrics_packets_dissected++;
+        if (passed)
+            metrics_packets_passed++;
+        metrics_process_us += now - start_time;
+        if (now >= metrics_next_write) {
+            write_metrics_file(cf);
+            metrics_next_write = now + METRICS_INTERVAL_US;
+        }
+    }
     return passed;
 }
 
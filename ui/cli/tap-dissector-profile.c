@@ -0,0 +1,162 @@
+/* tap-dissector-profile.c
+ *
+ * Wireshark - Network traffic analyzer
+ * By Gerald Combs <gerald@wireshark.org>
+ * Copyright 1998 Gerald Combs
+ *
+ * SPDX-License-Identifier: GPL-2.0-or-later
+ */
+
+/* This module reports the time spent in each protocol's dissectors,
+ * as collected by dissector_profile_enable(). */
+
+#include "config.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include <epan/packet.h>
+#include <epan/tap.h>
+#include <epan/stat_tap_ui.h>
+
+#include <wsutil/cmdarg_err.h>
+
+void register_tap_listener_dissector_profile(void);
+
+typedef struct _dprof_entry_t {
+	const char *proto_name;
+	guint64 calls;
+	gint64 total_us;
+	gint64 self_us;
+} dprof_entry_t;
+
+typedef struct _dprof_t {
+	guint32 frames;
+} dprof_t;
+
+static tap_packet_status
+dissector_profile_packet(void *pds, packet_info *pinfo _U_, epan_dissect_t *edt _U_, const void *dummy _U_, tap_flags_t flags _U_)
+{
+	dprof_t *ds = (dprof_t *)pds;
+
+	ds->frames++;
+	return TAP_PACKET_DONT_REDRAW;
+}
+
+static void
+dissector_profile_collect(const char *proto_name, guint64 calls,
+		gint64 total_us, gint64 self_us, gpointer user_data)
+{
+	GArray *entries = (GArray *)user_data;
+	dprof_entry_t entry;
+
+	entry.proto_name = proto_name;
+	entry.calls = calls;
+	entry.total_us = total_us;
+	entry.self_us = self_us;
+	g_array_append_val(entries, entry);
+}
+
+static gint
+dissector_profile_compare(gconstpointer a, gconstpointer b)
+{
+	const dprof_entry_t *ea = (const dprof_entry_t *)a;
+	const dprof_entry_t *eb = (const dprof_entry_t *)b;
+
+	/* Most expensive first */
+	if (ea->self_us != eb->self_us)
+		return ea->self_us < eb->self_us ? 1 : -1;
+	return strcmp(ea->proto_name, eb->proto_name);
+}
+
+static void
+dissector_profile_draw(void *pds)
+{
+	dprof_t *ds = (dprof_t *)pds;
+	GArray *entries = g_array_new(FALSE, FALSE, sizeof(dprof_entry_t));
+	gint64 self_sum = 0;
+
+	dissector_profile_foreach(dissector_profile_collect, entries);
+	g_array_sort(entries, dissector_profile_compare);
+
+	for (guint i = 0; i < entries->len; i++)
+		self_sum += g_array_index(entries, dprof_entry_t, i).self_us;
+
+	printf("\n");
+	printf("===================================================================\n");
+	printf("Dissector Profile\n");
+	printf("Frames: %u\n\n", ds->frames);
+	printf("%-24s %12s %14s %14s %7s\n", "Protocol", "Calls", "Total (us)", "Self (us)", "Self %");
+	for (guint i = 0; i < entries->len; i++) {
+		dprof_entry_t *e = &g_array_index(entries, dprof_entry_t, i);
+		printf("%-24s %12" PRIu64 " %14" PRId64 " %14" PRId64 " %6.2f%%\n",
+			e->proto_name, e->calls, e->total_us, e->self_us,
+			self_sum ? 100.0 * (double)e->self_us / (double)self_sum : 0.0);
+	}
+	printf("===================================================================\n");
+
+	g_array_free(entries, TRUE);
+}
+
+static void
+dissector_profile_finish(void *pds)
+{
+	dissector_profile_enable(FALSE);
+	g_free(pds);
+}
+
+static void
+dissector_profile_init(const char *opt_arg, void *userdata _U_)
+{
+	dprof_t *ds;
+	GString *error_string;
+
+	if (strcmp("dissector-profile", opt_arg) != 0) {
+		cmdarg_err("invalid \"-z dissector-profile\" argument");
+		exit(1);
+	}
+
+	ds = g_new0(dprof_t, 1);
+
+	error_string = register_tap_listener("frame", ds, NULL, 0, NULL, dissector_profile_packet, dissector_profile_draw, dissector_profile_finish);
+	if (error_string) {
+		g_free(ds);
+
+		cmdarg_err("Couldn't register dissector-profile tap: %s",
+			error_string->str);
+		g_string_free(error_string, TRUE);
+		exit(1);
+	}
+
+	dissector_profile_reset();
+	dissector_profile_enable(TRUE);
+}
+
+static stat_tap_ui dissector_profile_ui = {
+	REGISTER_STAT_GROUP_GENERIC,
+	NULL,
+	"dissector-profile",
+	dissector_profile_init,
+	0,
+	NULL
+};
+
+void
+register_tap_listener_dissector_profile(void)
+{
+	register_stat_tap_ui(&dissector_profile_ui, NULL);
+}
+
+/*
+ * Editor modelines  -  https://www.wireshark.org/tools/modelines.html
+ *
+ * Local variables:
+ * c-basic-offset: 8
+ * tab-width: 8
+ * indent-tabs-mode: t
+ * End:
+ *
+ * vi: set shiftwidth=8 tabstop=8 noexpandtab:
+ * :indentSize=8:tabSize=8:noTabs=false:
+ */
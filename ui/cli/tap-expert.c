@@ -46,12 +46,38 @@ typedef struct expert_entry
 } expert_entry;
 
 
+/* Protocol and summary strings are interned in the GStringChunk, so
+   entries can be matched by comparing pointers. */
+typedef struct expert_entry_key
+{
+    const gchar *protocol;
+    const gchar *summary;
+} expert_entry_key;
+
 /* Overall struct for storing all data seen */
 typedef struct expert_tapdata_t {
     GArray       *ei_array[max_level]; /* expert info items */
+    GHashTable   *ei_index[max_level]; /* expert_entry_key -> ei_array index + 1 */
     GStringChunk *text;         /* for efficient storage of summary strings */
 } expert_tapdata_t;
 
+static guint
+expert_entry_key_hash(gconstpointer key)
+{
+    const expert_entry_key *k = (const expert_entry_key *)key;
+
+    return g_direct_hash(k->protocol) ^ (g_direct_hash(k->summary) * 31);
+}
+
+static gboolean
+expert_entry_key_equal(gconstpointer a, gconstpointer b)
+{
+    const expert_entry_key *ka = (const expert_entry_key *)a;
+    const expert_entry_key *kb = (const expert_entry_key *)b;
+
+    return ka->protocol == kb->protocol && ka->summary == kb->summary;
+}
+
 
 /* Reset expert stats */
 static void
@@ -67,6 +93,7 @@ expert_stat_reset(void *tapdata)
     /* Empty each of the arrays */
     for (n=0; n < max_level; n++) {
         g_array_set_size(etd->ei_array[n], 0);
+        g_hash_table_remove_all(etd->ei_index[n]);
     }
 }
 
@@ -80,6 +107,8 @@ expert_stat_packet(void *tapdata, packet_info *pinfo _U_, epan_dissect_t *edt _U
     severity_level_t     severity_level;
     expert_entry         tmp_entry;
     expert_entry        *entry;
+    expert_entry_key     key;
+    expert_entry_key    *new_key;
     guint                n;
 
     switch (ei->severity) {
@@ -108,27 +137,31 @@ expert_stat_packet(void *tapdata, packet_info *pinfo _U_, epan_dissect_t *edt _U
         return TAP_PACKET_REDRAW; /* XXX - TAP_PACKET_DONT_REDRAW? */
     }
 
-    /* If a duplicate just bump up frequency.
-       TODO: could make more efficient by avoiding linear search...*/
-    for (n=0; n < data->ei_array[severity_level]->len; n++) {
-        entry = &g_array_index(data->ei_array[severity_level], expert_entry, n);
-        if ((strcmp(ei->protocol, entry->protocol) == 0) &&
-            (strcmp(ei->summary, entry->summary) == 0)) {
-            entry->frequency++;
-            return TAP_PACKET_REDRAW;
-        }
+    /* Copy/Store protocol and summary strings efficiently using GStringChunk */
+    key.protocol = g_string_chunk_insert_const(data->text, ei->protocol);
+    key.summary = g_string_chunk_insert_const(data->text, ei->summary);
+
+    /* If a duplicate just bump up frequency */
+    n = GPOINTER_TO_UINT(g_hash_table_lookup(data->ei_index[severity_level], &key));
+    if (n != 0) {
+        entry = &g_array_index(data->ei_array[severity_level], expert_entry, n - 1);
+        entry->frequency++;
+        return TAP_PACKET_REDRAW;
     }
 
     /* Else Add new item to end of list for severity level */
     entry = &tmp_entry;
-    /* Copy/Store protocol and summary strings efficiently using GStringChunk */
-    entry->protocol = g_string_chunk_insert_const(data->text, ei->protocol);
-    entry->summary = g_string_chunk_insert_const(data->text, ei->summary);
+    entry->protocol = key.protocol;
+    entry->summary = (gchar *)key.summary;
     entry->group = ei->group;
     entry->frequency = 1;
     /* Store a copy of the expert entry */
     g_array_append_val(data->ei_array[severity_level], tmp_entry);
 
+    new_key = (expert_entry_key *)g_memdup2(&key, sizeof key);
+    g_hash_table_insert(data->ei_index[severity_level], new_key,
+                        GUINT_TO_POINTER(data->ei_array[severity_level]->len));
+
     return TAP_PACKET_REDRAW;
 }
 
@@ -189,6 +222,7 @@ expert_tapdata_free(expert_tapdata_t* hs)
 {
     for (int n = 0; n < max_level; n++) {
         g_array_free(hs->ei_array[n], TRUE);
+        g_hash_table_destroy(hs->ei_index[n]);
     }
     g_string_chunk_free(hs->text);
     g_free(hs);
@@ -250,6 +284,7 @@ static void expert_stat_init(const char *opt_arg, void *userdata _U_)
     /* Allocate GArray for each severity level */
     for (n=0; n < max_level; n++) {
         hs->ei_array[n] = g_array_sized_new(FALSE, FALSE, sizeof(expert_entry), 1000);
+        hs->ei_index[n] = g_hash_table_new_full(expert_entry_key_hash, expert_entry_key_equal, g_free, NULL);
     }
 
     /**********************************************/
@@ -27,7 +27,7 @@
 #include "tap-exportobject.h"
 
 typedef struct _export_object_list_gui_t {
-    GSList *entries;
+    GPtrArray *entries;
     register_eo_t* eo;
 } export_object_list_gui_t;
 
@@ -87,14 +87,17 @@ object_list_add_entry(void *gui_data, export_object_entry_t *entry)
 {
     export_object_list_gui_t *object_list = (export_object_list_gui_t*)gui_data;
 
-    object_list->entries = g_slist_append(object_list->entries, entry);
+    g_ptr_array_add(object_list->entries, entry);
 }
 
 static export_object_entry_t*
 object_list_get_entry(void *gui_data, int row) {
     export_object_list_gui_t *object_list = (export_object_list_gui_t*)gui_data;
 
-    return (export_object_entry_t *)g_slist_nth_data(object_list->entries, row);
+    if (row < 0 || (guint)row >= object_list->entries->len)
+        return NULL;
+
+    return (export_object_entry_t *)g_ptr_array_index(object_list->entries, row);
 }
 
 /* This is just for writing Exported Objects to a file */
@@ -103,8 +106,8 @@ eo_draw(void *tapdata)
 {
     export_object_list_t *tap_object = (export_object_list_t *)tapdata;
     export_object_list_gui_t *object_list = (export_object_list_gui_t*)tap_object->gui_data;
-    GSList *slist = object_list->entries;
     export_object_entry_t *entry;
+    guint i;
     gchar* save_in_path = (gchar*)g_hash_table_lookup(eo_opts, proto_get_protocol_filter_name(get_eo_proto_id(object_list->eo)));
     GString *safe_filename = NULL;
     gchar *save_as_fullpath = NULL;
@@ -119,8 +122,8 @@ eo_draw(void *tapdata)
         }
     }
 
-    while (slist) {
-        entry = (export_object_entry_t *)slist->data;
+    for (i = 0; i < object_list->entries->len; i++) {
+        entry = (export_object_entry_t *)g_ptr_array_index(object_list->entries, i);
         do {
             g_free(save_as_fullpath);
             if (entry->filename) {
@@ -142,7 +145,6 @@ eo_draw(void *tapdata)
         write_file_binary_mode(save_as_fullpath, entry->payload_data, entry->payload_len);
         g_free(save_as_fullpath);
         save_as_fullpath = NULL;
-        slist = slist->next;
     }
 }
 
@@ -168,6 +170,7 @@ exportobject_handler(gpointer key, gpointer value _U_, gpointer user_data _U_)
     tap_data->get_entry = object_list_get_entry;
     tap_data->gui_data = (void*)object_list;
 
+    object_list->entries = g_ptr_array_new();
     object_list->eo = eo;
 
     /* Data will be gathered via a tap callback */
@@ -177,6 +180,7 @@ exportobject_handler(gpointer key, gpointer value _U_, gpointer user_data _U_)
     if (error_msg) {
         cmdarg_err("Can't register %s tap: %s", (const char*)key, error_msg->str);
         g_string_free(error_msg, TRUE);
+        g_ptr_array_free(object_list->entries, TRUE);
         g_free(tap_data);
         g_free(object_list);
         return;
@@ -36,6 +36,13 @@ typedef struct _cli_follow_info {
   guint32       chunkMin;
   guint32       chunkMax;
 
+  /* Chunks outside the range are dropped as they arrive, see
+   * follow_cli_tap_listener(). */
+  tap_packet_cb tap_handler;
+  guint32       chunks_seen;
+  guint32       chunks_skipped;     /* dropped chunks before chunkMin */
+  guint32       skipped_len[2];     /* their length, client and server */
+
   /* filter */
   int           stream_index;
   int           sub_stream_index;
@@ -164,7 +171,8 @@ static void follow_draw(void *contextp)
   follow_info_t *follow_info = (follow_info_t*)contextp;
   cli_follow_info_t* cli_follow_info = (cli_follow_info_t*)follow_info->gui_data;
   gchar             buf[WS_INET6_ADDRSTRLEN];
-  guint32 global_client_pos = 0, global_server_pos = 0;
+  guint32 global_client_pos = cli_follow_info->skipped_len[0];
+  guint32 global_server_pos = cli_follow_info->skipped_len[1];
   guint32 *global_pos;
   guint32           ii, jj;
   char              *buffer;
@@ -209,7 +217,7 @@ static void follow_draw(void *contextp)
       break;
   }
 
-  for (cur = g_list_last(follow_info->payload), chunk = 1;
+  for (cur = g_list_last(follow_info->payload), chunk = cli_follow_info->chunks_skipped + 1;
        cur != NULL;
        cur = g_list_previous(cur), chunk++)
   {
@@ -333,6 +341,53 @@ static void follow_draw(void *contextp)
   }
 }
 
+/*
+ * Run the follower's tap, then drop any new chunks that are outside the
+ * requested range, so that e.g. "-z follow,tcp,raw,0,1" on a multi-GB
+ * transfer doesn't hold the whole stream in memory until follow_draw().
+ * Followers only ever prepend chunks to the payload list, so the new ones
+ * are those in front of the previous head.
+ */
+static tap_packet_status
+follow_cli_tap_listener(void *tapdata, packet_info *pinfo,
+                        epan_dissect_t *edt, const void *data, tap_flags_t flags)
+{
+  follow_info_t *follow_info = (follow_info_t *)tapdata;
+  cli_follow_info_t* cli_follow_info = (cli_follow_info_t*)follow_info->gui_data;
+  GList *old_head = follow_info->payload;
+  GList *cur, *next;
+  follow_record_t *follow_record;
+  tap_packet_status status;
+  guint32 new_chunks = 0;
+  guint32 chunk;
+
+  status = cli_follow_info->tap_handler(tapdata, pinfo, edt, data, flags);
+
+  for (cur = follow_info->payload; cur != old_head; cur = g_list_next(cur))
+    new_chunks++;
+
+  /* The head of the list is the newest chunk */
+  chunk = cli_follow_info->chunks_seen + new_chunks;
+  for (cur = follow_info->payload; cur != old_head; cur = next, chunk--)
+  {
+    next = g_list_next(cur);
+    if ((chunk >= cli_follow_info->chunkMin) && (chunk <= cli_follow_info->chunkMax))
+      continue;
+
+    follow_record = (follow_record_t *)cur->data;
+    if (chunk < cli_follow_info->chunkMin) {
+      cli_follow_info->chunks_skipped++;
+      cli_follow_info->skipped_len[follow_record->is_server] += follow_record->data->len;
+    }
+    g_byte_array_free(follow_record->data, TRUE);
+    g_free(follow_record);
+    follow_info->payload = g_list_delete_link(follow_info->payload, cur);
+  }
+  cli_follow_info->chunks_seen += new_chunks;
+
+  return status;
+}
+
 static gboolean follow_arg_strncmp(const char **opt_argp, const char *strp)
 {
   size_t len = strlen(strp);
@@ -549,8 +604,9 @@ static void follow_stream(const char *opt_argp, void *userdata)
     }
   }
 
+  cli_follow_info->tap_handler = get_follow_tap_handler(follower);
   errp = register_tap_listener(get_follow_tap_string(follower), follow_info, follow_info->filter_out_filter, 0,
-                               NULL, get_follow_tap_handler(follower), follow_draw, (tap_finish_cb)follow_free);
+                               NULL, follow_cli_tap_listener, follow_draw, (tap_finish_cb)follow_free);
 
   if (errp != NULL)
   {
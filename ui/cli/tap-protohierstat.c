@@ -30,6 +30,7 @@ typedef struct _phs_t {
 	struct _phs_t *sibling;
 	struct _phs_t *child;
 	struct _phs_t *parent;
+	struct _phs_t *last_hit; /* in the first sibling: last node matched in this list */
 	char *filter;
 	int protocol;
 	const char *proto_name;
@@ -46,6 +47,7 @@ new_phs_t(phs_t *parent)
 	rs->sibling    = NULL;
 	rs->child      = NULL;
 	rs->parent     = parent;
+	rs->last_hit   = NULL;
 	rs->filter     = NULL;
 	rs->protocol   = -1;
 	rs->proto_name = NULL;
@@ -59,7 +61,7 @@ static tap_packet_status
 protohierstat_packet(void *prs, packet_info *pinfo, epan_dissect_t *edt, const void *dummy _U_, tap_flags_t flags _U_)
 {
 	phs_t *rs = (phs_t *)prs;
-	phs_t *tmprs;
+	phs_t *tmprs, *lastrs;
 	proto_node *node;
 	field_info *fi;
 
@@ -87,24 +89,29 @@ protohierstat_packet(void *prs, packet_info *pinfo, epan_dissect_t *edt, const v
 			continue;
 		}
 
-		/* find this protocol in the list of siblings */
-		for (tmprs=rs; tmprs; tmprs=tmprs->sibling) {
-			if (tmprs->protocol == fi->hfinfo->id) {
-				break;
+		/*
+		 * find this protocol in the list of siblings; consecutive
+		 * packets mostly take the same path, so try the node
+		 * matched last time first
+		 */
+		tmprs = rs->last_hit;
+		if (!tmprs || tmprs->protocol != fi->hfinfo->id) {
+			lastrs = NULL;
+			for (tmprs=rs; tmprs; lastrs=tmprs, tmprs=tmprs->sibling) {
+				if (tmprs->protocol == fi->hfinfo->id) {
+					break;
+				}
 			}
-		}
 
-		/* not found, then we must add it to the end of the list */
-		if (!tmprs) {
-			for (tmprs=rs; tmprs->sibling; tmprs=tmprs->sibling)
-				;
-			tmprs->sibling = new_phs_t(rs->parent);
-			rs = tmprs->sibling;
-			rs->protocol = fi->hfinfo->id;
-			rs->proto_name = fi->hfinfo->abbrev;
-		} else {
-			rs = tmprs;
+			/* not found, then we must add it to the end of the list */
+			if (!tmprs) {
+				tmprs = lastrs->sibling = new_phs_t(rs->parent);
+				tmprs->protocol = fi->hfinfo->id;
+				tmprs->proto_name = fi->hfinfo->abbrev;
+			}
+			rs->last_hit = tmprs;
 		}
+		rs = tmprs;
 
 		rs->frames++;
 		rs->bytes += pinfo->fd->pkt_len;
@@ -199,8 +199,15 @@ void DecodeAsDialog::on_clearToolButton_clicked()
 
 void DecodeAsDialog::applyChanges()
 {
+    QStringList old_entries = DecodeAsModel::activeEntries();
+
     model_->applyChanges();
-    mainApp->queueAppSignal(MainApplication::PacketDissectionChanged);
+
+    // Pressing OK without changing anything shouldn't redissect
+    // the whole capture.
+    if (DecodeAsModel::activeEntries() != old_entries) {
+        mainApp->queueAppSignal(MainApplication::PacketDissectionChanged);
+    }
 }
 
 void DecodeAsDialog::on_buttonBox_clicked(QAbstractButton *button)
@@ -1287,8 +1287,7 @@ void IOGraphDialog::on_intervalComboBox_currentIndexChanged(int)
         for (int row = 0; row < uat_model_->rowCount(); row++) {
             IOGraph *iog = ioGraphs_.value(row, NULL);
             if (iog) {
-                iog->setInterval(interval);
-                if (iog->visible()) {
+                if (!iog->setInterval(interval) && iog->visible()) {
                     need_retap = true;
                 }
             }
@@ -1297,6 +1296,8 @@ void IOGraphDialog::on_intervalComboBox_currentIndexChanged(int)
 
     if (need_retap) {
         scheduleRetap(true);
+    } else {
+        scheduleRecalc(true);
     }
 
     updateLegend();
@@ -1704,6 +1705,7 @@ IOGraph::IOGraph(QCustomPlot *parent) :
     bars_(NULL),
     val_units_(IOG_ITEM_UNIT_FIRST),
     hf_index_(-1),
+    interval_(0),
     cur_idx_(-1)
 {
     Q_ASSERT(parent_ != NULL);
@@ -2264,9 +2266,43 @@ bool IOGraph::hasItemToShow(int idx, double value) const
     return result;
 }
 
-void IOGraph::setInterval(int interval)
+// Returns true if the collected data could be kept, otherwise the graph
+// must be retapped.
+bool IOGraph::setInterval(int interval)
 {
+    bool kept = false;
+
+    if (interval == interval_) {
+        return true;
+    }
+
+    // A larger interval which is a multiple of the current one can be built
+    // from the current items. This doesn't work if items were dropped
+    // because we ran out of them.
+    if (interval_ > 0 && interval > interval_ && interval % interval_ == 0 && cur_idx_ < max_io_items_ - 1) {
+        int factor = interval / interval_;
+        int new_idx = -1;
+
+        for (int idx = 0; idx <= cur_idx_; idx++) {
+            new_idx = idx / factor;
+            if (new_idx == idx) {
+                continue;
+            }
+            if (idx % factor == 0) {
+                items_[new_idx] = items_[idx];
+            } else {
+                merge_io_graph_item(&items_[new_idx], &items_[idx], hf_index_, val_units_);
+            }
+        }
+        if (cur_idx_ > new_idx) {
+            reset_io_graph_items(&items_[new_idx + 1], cur_idx_ - new_idx);
+        }
+        cur_idx_ = new_idx;
+        kept = true;
+    }
+
     interval_ = interval;
+    return kept;
 }
 
 // Get the value at the given interval (idx) for the current value unit.
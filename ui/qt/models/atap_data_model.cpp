@@ -43,6 +43,7 @@ ATapDataModel::ATapDataModel(dataModelType type, int protoId, QString filter, QO
     hash_.user_data = this;
 
     storage_ = nullptr;
+    storage_rows_ = 0;
     _resolveNames = false;
     _absoluteTime = false;
     _nanoseconds = false;
@@ -139,7 +140,7 @@ void ATapDataModel::disableTap()
 
 int ATapDataModel::rowCount(const QModelIndex &parent) const
 {
-    return (storage_ && !parent.isValid()) ? (int) storage_->len : 0;
+    return (storage_ && !parent.isValid()) ? storage_rows_ : 0;
 }
 
 void ATapDataModel::tapReset(void *tapdata) {
@@ -196,6 +197,7 @@ void ATapDataModel::resetData()
 
     beginResetModel();
     storage_ = nullptr;
+    storage_rows_ = 0;
     if (_type == ATapDataModel::DATAMODEL_ENDPOINT)
         reset_endpoint_table_data(&hash_);
     else if (_type == ATapDataModel::DATAMODEL_CONVERSATION)
@@ -212,9 +214,29 @@ void ATapDataModel::updateData(GArray * newData)
     if (_disableTap)
         return;
 
-    beginResetModel();
-    storage_ = newData;
-    endResetModel();
+    int old_rows = storage_ ? storage_rows_ : 0;
+    int new_rows = newData ? (int) newData->len : 0;
+
+    // The tap only ever appends items to the array while it runs and
+    // updates the counters of the existing ones in place, so as long as
+    // we are looking at the same array we can tell the views about the
+    // changed and added rows instead of resetting the whole model. That
+    // keeps the periodic updates during a retap cheap and preserves the
+    // current selection and scroll position.
+    if (!storage_ || storage_ != newData || new_rows < old_rows) {
+        beginResetModel();
+        storage_ = newData;
+        storage_rows_ = new_rows;
+        endResetModel();
+    } else {
+        if (old_rows > 0)
+            emit dataChanged(index(0, 0), index(old_rows - 1, columnCount() - 1));
+        if (new_rows > old_rows) {
+            beginInsertRows(QModelIndex(), old_rows, new_rows - 1);
+            storage_rows_ = new_rows;
+            endInsertRows();
+        }
+    }
 
     if (_type == ATapDataModel::DATAMODEL_CONVERSATION)
         ((ConversationDataModel *)(this))->doDataUpdate();
@@ -840,7 +862,7 @@ conv_item_t * ConversationDataModel::itemForRow(int row)
 
 bool ConversationDataModel::showConversationId(int row) const
 {
-    if (!storage_ || row < 0 || row >= (int) storage_->len)
+    if (!storage_ || row < 0 || row >= rowCount())
         return false;
 
     conv_item_t *conv_item = (conv_item_t *)&g_array_index(storage_, conv_item_t, row);
@@ -226,6 +226,7 @@ protected:
 
     dataModelType _type;
     GArray * storage_;
+    int storage_rows_;
     QString _filter;
 
     bool _absoluteTime;
@@ -689,6 +689,50 @@ void DecodeAsModel::buildDceRpcChangedList(gpointer data, gpointer user_data)
     model->decode_as_items_ << item;
 }
 
+void DecodeAsModel::gatherActiveEntry(const gchar *table_name, ftenum_t selector_type,
+        gpointer key, gpointer value, gpointer user_data)
+{
+    QStringList *entries = (QStringList *)user_data;
+    dissector_handle_t handle = dtbl_entry_get_handle((dtbl_entry_t *)value);
+
+    *entries << QString("%1\t%2\t%3")
+        .arg(table_name)
+        .arg(selector_type == FT_NONE ? QString() : entryString(table_name, key))
+        .arg(handle ? dissector_handle_get_description(handle) : DECODE_AS_NONE);
+}
+
+void DecodeAsModel::gatherActiveDceRpcEntry(gpointer data, gpointer user_data)
+{
+    QStringList *entries = (QStringList *)user_data;
+    decode_dcerpc_bind_values_t *binding = (decode_dcerpc_bind_values_t *)data;
+    dissector_table_t sub_dissectors = find_dissector_table(DCERPC_TABLE_NAME);
+    guid_key guid_val;
+
+    guid_val.ver = binding->ver;
+    guid_val.guid = binding->uuid;
+    dissector_handle_t handle = dissector_get_guid_handle(sub_dissectors, &guid_val);
+
+    *entries << QString("%1\t%2-%3-%4-%5 v%6\t%7")
+        .arg(DCERPC_TABLE_NAME)
+        .arg(binding->uuid.data1, 8, 16, QChar('0'))
+        .arg(binding->uuid.data2, 4, 16, QChar('0'))
+        .arg(binding->uuid.data3, 4, 16, QChar('0'))
+        .arg(QByteArray((const char *)binding->uuid.data4, sizeof(binding->uuid.data4)).toHex().constData())
+        .arg(binding->ver)
+        .arg(handle ? dissector_handle_get_description(handle) : DECODE_AS_NONE);
+}
+
+QStringList DecodeAsModel::activeEntries()
+{
+    QStringList entries;
+
+    dissector_all_tables_foreach_changed(gatherActiveEntry, &entries);
+    decode_dcerpc_add_show_list(gatherActiveDceRpcEntry, &entries);
+    entries.sort();
+
+    return entries;
+}
+
 typedef QPair<const char *, guint32> UintPair;
 typedef QPair<const char *, const char *> CharPtrPair;
 
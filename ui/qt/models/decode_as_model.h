@@ -101,12 +101,19 @@ public:
 
     void applyChanges();
 
+    // A description of every Decode As entry currently in effect, used
+    // to tell whether applyChanges() actually changed anything.
+    static QStringList activeEntries();
+
 protected:
     static void buildChangedList(const gchar *table_name, ftenum_t selector_type,
                           gpointer key, gpointer value, gpointer user_data);
     static void buildDceRpcChangedList(gpointer data, gpointer user_data);
     static void gatherChangedEntries(const gchar *table_name, ftenum_t selector_type,
                           gpointer key, gpointer value, gpointer user_data);
+    static void gatherActiveEntry(const gchar *table_name, ftenum_t selector_type,
+                          gpointer key, gpointer value, gpointer user_data);
+    static void gatherActiveDceRpcEntry(gpointer data, gpointer user_data);
     static prefs_set_pref_e readDecodeAsEntry(gchar *key, const gchar *value,
                           void *user_data, gboolean return_range_errors);
 
@@ -20,7 +20,8 @@ ExpertPacketItem::ExpertPacketItem(const expert_info_t& expert_info, column_info
     hf_id_(expert_info.hf_index),
     protocol_(expert_info.protocol),
     summary_(expert_info.summary),
-    parentItem_(parent)
+    parentItem_(parent),
+    row_(0)
 {
     if (cinfo) {
         info_ = col_get_text(cinfo, COL_INFO);
@@ -55,6 +56,7 @@ QString ExpertPacketItem::groupKey(bool group_by_summary) {
 
 void ExpertPacketItem::appendChild(ExpertPacketItem* child, QString hash)
 {
+    child->row_ = static_cast<int>(childItems_.count());
     childItems_.append(child);
     hashChild_[hash] = child;
 }
@@ -76,10 +78,9 @@ int ExpertPacketItem::childCount() const
 
 int ExpertPacketItem::row() const
 {
-    if (parentItem_)
-        return static_cast<int>(parentItem_->childItems_.indexOf(const_cast<ExpertPacketItem*>(this)));
-
-    return 0;
+    // Set by appendChild. Groups can have millions of children, so
+    // searching the parent's list here made views quadratic.
+    return row_;
 }
 
 ExpertPacketItem* ExpertPacketItem::parentItem()
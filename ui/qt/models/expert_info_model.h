@@ -61,6 +61,7 @@ private:
 
     QList<ExpertPacketItem*> childItems_;
     ExpertPacketItem* parentItem_;
+    int row_;
     QHash<QString, ExpertPacketItem*> hashChild_;    //optimization for insertion
 };
 
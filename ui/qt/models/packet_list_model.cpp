@@ -79,7 +79,10 @@ PacketListModel::PacketListModel(QObject *parent, capture_file *cf) :
     number_to_row_(QVector<int>()),
     max_row_height_(0),
     max_line_count_(1),
-    idle_dissection_row_(0)
+    idle_dissection_row_(0),
+    prefetch_row_(0),
+    prefetch_end_(0),
+    prefetch_scheduled_(false)
 {
     Q_ASSERT(glbl_plist_model == Q_NULLPTR);
     glbl_plist_model = this;
@@ -150,14 +153,16 @@ guint PacketListModel::recreateVisibleRows()
     number_to_row_.fill(0);
     endResetModel();
 
+    // Frame numbers run from 1 to the number of physical rows, so size the
+    // lookup table once instead of growing it as we go.
+    visible_rows_.reserve(physical_rows_.count());
+    number_to_row_.resize(physical_rows_.count() + 1);
+
     foreach (PacketListRecord *record, physical_rows_) {
         frame_data *fdata = record->frameData();
 
         if (fdata->passed_dfilter || fdata->ref_time) {
             visible_rows_ << record;
-            if (static_cast<guint32>(number_to_row_.size()) <= fdata->num) {
-                number_to_row_.resize(fdata->num + 10000);
-            }
             number_to_row_[fdata->num] = static_cast<int>(visible_rows_.count());
         }
     }
@@ -181,6 +186,7 @@ void PacketListModel::clear() {
     max_row_height_ = 0;
     max_line_count_ = 1;
     idle_dissection_row_ = 0;
+    prefetch_row_ = prefetch_end_ = 0;
 }
 
 void PacketListModel::invalidateAllColumnStrings()
@@ -308,7 +314,7 @@ void PacketListModel::toggleFrameRefTime(const QModelIndex &rt_index)
         fdata->ref_time=1;
         cap_file_->ref_time_count++;
     }
-    cf_reftime_packets(cap_file_);
+    cf_reftime_packets_update(cap_file_, fdata);
     if (!fdata->ref_time && !fdata->passed_dfilter) {
         cap_file_->displayed_count--;
     }
@@ -509,27 +515,6 @@ void PacketListModel::sort(int column, Qt::SortOrder order)
 
     QString col_title = get_column_title(column);
 
-    if (text_sort_column_ >= 0 && (guint)visible_rows_.count() > prefs.gui_packet_list_cached_rows_max) {
-        /* Column not based on frame data but by column text that requires
-         * dissection, so to sort in a reasonable amount of time the column
-         * text needs to be cached.
-         */
-        /* If the sort is being triggered because the columns were already
-         * sorted and the filter is being cleared (or changed to something
-         * else with more rows than fit in the cache), then the temporary
-         * message will be immediately overwritten with the standard capture
-         * statistics by the packets_bar_update() call after thawing the rows.
-         * It will still blink yellow, and the user will get the message if
-         * they then click on the header file (wondering why it didn't sort.)
-         */
-        if (col_title.isEmpty()) {
-            col_title = tr("Column");
-        }
-        QString temp_msg = tr("%1 can only be sorted with %2 or fewer visible rows; increase cache size in Layout preferences").arg(col_title).arg(prefs.gui_packet_list_cached_rows_max);
-        mainApp->pushStatus(MainApplication::TemporaryStatus, temp_msg);
-        return;
-    }
-
     /* If we are currently in the middle of reading the capture file, don't
      * sort. PacketList::captureFileReadFinished invalidates all the cached
      * column strings and then tries to sort again.
@@ -561,6 +546,10 @@ void PacketListModel::sort(int column, Qt::SortOrder order)
      * overestimate?
      */
     exp_comps_ = log2(visible_rows_.count()) * visible_rows_.count();
+    if (text_sort_column_ >= 0) {
+        /* Each row is dissected once to extract its sort key. */
+        exp_comps_ += visible_rows_.count();
+    }
     progress_frame_ = nullptr;
     if (qobject_cast<MainWindow *>(mainApp->mainWindow())) {
         MainWindow *mw = qobject_cast<MainWindow *>(mainApp->mainWindow());
@@ -576,21 +565,20 @@ void PacketListModel::sort(int column, Qt::SortOrder order)
     sort_column_is_numeric_ = isNumericColumn(sort_column_);
     QVector<PacketListRecord *> sorted_visible_rows_ = visible_rows_;
     try {
-        std::sort(sorted_visible_rows_.begin(), sorted_visible_rows_.end(), recordLessThan);
+        if (text_sort_column_ >= 0) {
+            sortByColumnText(sorted_visible_rows_);
+        } else {
+            std::sort(sorted_visible_rows_.begin(), sorted_visible_rows_.end(), recordLessThan);
+        }
 
+        // Every sorted row came from visible_rows_, so we can take the
+        // sorted vector as-is instead of appending each record again.
         beginResetModel();
-        visible_rows_.resize(0);
+        visible_rows_.swap(sorted_visible_rows_);
         number_to_row_.fill(0);
-        foreach (PacketListRecord *record, sorted_visible_rows_) {
-            frame_data *fdata = record->frameData();
-
-            if (fdata->passed_dfilter || fdata->ref_time) {
-                visible_rows_ << record;
-                if (number_to_row_.size() <= (int)fdata->num) {
-                    number_to_row_.resize(fdata->num + 10000);
-                }
-                number_to_row_[fdata->num] = static_cast<int>(visible_rows_.count());
-            }
+        number_to_row_.resize(physical_rows_.count() + 1);
+        for (int row = 0; row < visible_rows_.count(); row++) {
+            number_to_row_[visible_rows_[row]->frameData()->num] = row + 1;
         }
         endResetModel();
     } catch (const SortAbort& e) {
@@ -679,15 +667,11 @@ bool PacketListModel::isNumericColumn(int column)
     return true;
 }
 
-bool PacketListModel::recordLessThan(PacketListRecord *r1, PacketListRecord *r2)
+// Update the progress bar and process events so that the user can cancel.
+void PacketListModel::updateSortProgress()
 {
-    int cmp_val = 0;
     comps_++;
 
-    // Wherein we try to cram the logic of packet_list_compare_records,
-    // _packet_list_compare_records, and packet_list_compare_custom from
-    // gtk/packet_list_store.c into one function
-
     if (busy_timer_.elapsed() > busy_timeout_) {
         if (progress_frame_) {
             progress_frame_->setValue(static_cast<int>(comps_/exp_comps_ * 100));
@@ -700,44 +684,86 @@ bool PacketListModel::recordLessThan(PacketListRecord *r1, PacketListRecord *r2)
         }
         busy_timer_.restart();
     }
+}
+
+// Sort by column text. The text (and its numeric value, if the column is
+// numeric) is extracted once per record up front, so that each record is
+// dissected once instead of once per comparison, and so that the number of
+// rows that can be sorted isn't limited by the size of the column cache.
+void PacketListModel::sortByColumnText(QVector<PacketListRecord *> &rows)
+{
+    QVector<SortKey> keys;
+
+    keys.reserve(rows.count());
+    foreach (PacketListRecord *record, rows) {
+        SortKey key;
+
+        updateSortProgress();
+        key.record = record;
+        key.text = record->columnString(sort_cap_file_, sort_column_);
+        key.num = 0.0;
+        key.num_ok = false;
+        if (sort_column_is_numeric_) {
+            key.num = parseNumericColumn(key.text, &key.num_ok);
+        }
+        keys << key;
+    }
+
+    std::sort(keys.begin(), keys.end(), sortKeyLessThan);
+
+    rows.resize(0);
+    foreach (const SortKey &key, keys) {
+        rows << key.record;
+    }
+}
+
+bool PacketListModel::sortKeyLessThan(const SortKey &k1, const SortKey &k2)
+{
+    updateSortProgress();
+
+    // XXX: The naive string comparison compares Unicode code points.
+    // Proper collation is more expensive
+    int cmp_val = k1.text.compare(k2.text);
+    if (cmp_val != 0 && sort_column_is_numeric_) {
+        // Custom column with numeric data (or something like a port number).
+        if (!k1.num_ok && !k2.num_ok) {
+            cmp_val = 0;
+        } else if (!k1.num_ok || (k2.num_ok && k1.num < k2.num)) {
+            // either k1 is invalid (and sort it before others) or both
+            // k1 and k2 are valid (sort normally)
+            cmp_val = -1;
+        } else if (!k2.num_ok || (k1.num > k2.num)) {
+            cmp_val = 1;
+        }
+    }
+
+    if (cmp_val == 0) {
+        // All else being equal, compare column numbers.
+        cmp_val = frame_data_compare(sort_cap_file_->epan, k1.record->frameData(), k2.record->frameData(), COL_NUMBER);
+    }
+
+    if (sort_order_ == Qt::AscendingOrder) {
+        return cmp_val < 0;
+    } else {
+        return cmp_val > 0;
+    }
+}
+
+bool PacketListModel::recordLessThan(PacketListRecord *r1, PacketListRecord *r2)
+{
+    int cmp_val = 0;
+
+    // Wherein we try to cram the logic of packet_list_compare_records,
+    // _packet_list_compare_records, and packet_list_compare_custom from
+    // gtk/packet_list_store.c into one function
+
+    updateSortProgress();
     if (sort_column_ < 0) {
         // No column.
         cmp_val = frame_data_compare(sort_cap_file_->epan, r1->frameData(), r2->frameData(), COL_NUMBER);
-    } else if (text_sort_column_ < 0) {
+    } else {
         // Column comes directly from frame data
         cmp_val = frame_data_compare(sort_cap_file_->epan, r1->frameData(), r2->frameData(), sort_cap_file_->cinfo.columns[sort_column_].col_fmt);
-    } else  {
-        QString r1String = r1->columnString(sort_cap_file_, sort_column_);
-        QString r2String = r2->columnString(sort_cap_file_, sort_column_);
-        // XXX: The naive string comparison compares Unicode code points.
-        // Proper collation is more expensive
-        cmp_val = r1String.compare(r2String);
-        if (cmp_val != 0 && sort_column_is_numeric_) {
-            // Custom column with numeric data (or something like a port number).
-            // Attempt to convert to numbers.
-            // XXX This is slow. Can we avoid doing this? Perhaps the actual
-            // values used for sorting should be cached too as QVariant[List].
-            // If so, we could consider using QCollatorSortKeys or similar
-            // for strings as well.
-            bool ok_r1, ok_r2;
-            double num_r1 = parseNumericColumn(r1String, &ok_r1);
-            double num_r2 = parseNumericColumn(r2String, &ok_r2);
-
-            if (!ok_r1 && !ok_r2) {
-                cmp_val = 0;
-            } else if (!ok_r1 || (ok_r2 && num_r1 < num_r2)) {
-                // either r1 is invalid (and sort it before others) or both
-                // r1 and r2 are valid (sort normally)
-                cmp_val = -1;
-            } else if (!ok_r2 || (num_r1 > num_r2)) {
-                cmp_val = 1;
-            }
-        }
-
-        if (cmp_val == 0) {
-            // All else being equal, compare column numbers.
-            cmp_val = frame_data_compare(sort_cap_file_->epan, r1->frameData(), r2->frameData(), COL_NUMBER);
-        }
     }
 
     if (sort_order_ == Qt::AscendingOrder) {
@@ -896,7 +922,7 @@ void PacketListModel::flushVisibleRows()
     int pos = static_cast<int>(visible_rows_.count());
 
     if (new_visible_rows_.count() > 0) {
-        beginInsertRows(QModelIndex(), pos, pos + static_cast<int>(new_visible_rows_.count()));
+        beginInsertRows(QModelIndex(), pos, pos + static_cast<int>(new_visible_rows_.count()) - 1);
         foreach (PacketListRecord *record, new_visible_rows_) {
             frame_data *fdata = record->frameData();
 
@@ -943,6 +969,43 @@ void PacketListModel::dissectIdle(bool reset)
     emit bgColorizationProgress(first+1, idle_dissection_row_+1);
 }
 
+// Fill the column string cache for rows that are about to be scrolled into
+// view, in small slices so that we don't block the event loop. Dissection
+// isn't thread safe, so this is done on the GUI thread between events.
+void PacketListModel::prefetchRows(int first, int count)
+{
+    prefetch_row_ = qMax(first, 0);
+    prefetch_end_ = qMin(first + count, static_cast<int>(visible_rows_.count()));
+
+    if (!prefetch_scheduled_ && prefetch_row_ < prefetch_end_) {
+        prefetch_scheduled_ = true;
+        QTimer::singleShot(0, this, &PacketListModel::prefetchIdle);
+    }
+}
+
+void PacketListModel::prefetchIdle()
+{
+    QElapsedTimer prefetch_timer;
+
+    prefetch_scheduled_ = false;
+    if (!cap_file_) {
+        return;
+    }
+
+    prefetch_timer.start();
+    prefetch_end_ = qMin(prefetch_end_, static_cast<int>(visible_rows_.count()));
+    while (prefetch_row_ < prefetch_end_ && prefetch_timer.elapsed() < idle_dissection_interval_) {
+        // Dissects the record and caches all of its columns if needed.
+        visible_rows_[prefetch_row_]->columnString(cap_file_, 0, true);
+        prefetch_row_++;
+    }
+
+    if (prefetch_row_ < prefetch_end_) {
+        prefetch_scheduled_ = true;
+        QTimer::singleShot(0, this, &PacketListModel::prefetchIdle);
+    }
+}
+
 // XXX Pass in cinfo from packet_list_append so that we can fill in
 // line counts?
 gint PacketListModel::appendPacket(frame_data *fdata)
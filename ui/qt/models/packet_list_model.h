@@ -93,6 +93,7 @@ public slots:
     void stopSorting();
     void flushVisibleRows();
     void dissectIdle(bool reset = false);
+    void prefetchRows(int first, int count);
 
 private:
     capture_file *cap_file_;
@@ -110,6 +111,15 @@ private:
     static int text_sort_column_;
     static Qt::SortOrder sort_order_;
     static capture_file *sort_cap_file_;
+    struct SortKey {
+        PacketListRecord *record;
+        QString text;
+        double num;
+        bool num_ok;
+    };
+    static void updateSortProgress();
+    static void sortByColumnText(QVector<PacketListRecord *> &rows);
+    static bool sortKeyLessThan(const SortKey &k1, const SortKey &k2);
     static bool recordLessThan(PacketListRecord *r1, PacketListRecord *r2);
     static double parseNumericColumn(const QString &val, bool *ok);
 
@@ -120,11 +130,15 @@ private:
 
     QElapsedTimer *idle_dissection_timer_;
     int idle_dissection_row_;
+    int prefetch_row_;
+    int prefetch_end_;
+    bool prefetch_scheduled_;
 
     bool isNumericColumn(int column);
 
 private slots:
     void emitItemHeightChanged(const QModelIndex &ih_index);
+    void prefetchIdle();
 };
 
 #endif // PACKET_LIST_MODEL_H
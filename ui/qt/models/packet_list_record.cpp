@@ -25,7 +25,14 @@
 #include <QStringList>
 
 QCache<guint32, QStringList> PacketListRecord::col_text_cache_(500);
+QHash<QByteArray, QString> PacketListRecord::col_text_pool_;
 QMap<int, int> PacketListRecord::cinfo_column_;
+
+// Strings longer than this (e.g. Info) are rarely repeated.
+static const int max_pooled_col_len_ = 64;
+// Start over when the pool grows too big. Strings in use stay valid since
+// QString is reference counted.
+static const int max_pooled_cols_ = 50000;
 unsigned PacketListRecord::rows_color_ver_ = 1;
 
 PacketListRecord::PacketListRecord(frame_data *frameData) :
@@ -212,6 +219,29 @@ void PacketListRecord::dissect(capture_file *cap_file, bool dissect_columns, boo
     wtap_rec_cleanup(&rec);
 }
 
+QString PacketListRecord::pooledColumnString(const char *str)
+{
+    int len = static_cast<int>(strlen(str));
+
+    if (len > max_pooled_col_len_) {
+        return QString::fromUtf8(str, len);
+    }
+
+    // fromRawData doesn't copy, so looking up an existing entry is cheap.
+    QHash<QByteArray, QString>::const_iterator it = col_text_pool_.constFind(QByteArray::fromRawData(str, len));
+    if (it != col_text_pool_.constEnd()) {
+        return it.value();
+    }
+
+    if (col_text_pool_.size() >= max_pooled_cols_) {
+        col_text_pool_.clear();
+    }
+
+    QString col_str = QString::fromUtf8(str, len);
+    col_text_pool_.insert(QByteArray(str, len), col_str);
+    return col_str;
+}
+
 void PacketListRecord::cacheColumnStrings(column_info *cinfo)
 {
     // packet_list_store.c:packet_list_change_record(PacketList *packet_list, PacketListRecord *record, gint col, column_info *cinfo)
@@ -231,9 +261,12 @@ void PacketListRecord::cacheColumnStrings(column_info *cinfo)
         int text_col = cinfo_column_.value(column, -1);
         if (text_col < 0) {
             col_fill_in_frame_data(fdata_, cinfo, column, FALSE);
+            // Frame data columns (number, time, length) are mostly unique.
+            col_str = QString(get_column_text(cinfo, column));
+        } else {
+            col_str = pooledColumnString(get_column_text(cinfo, column));
         }
 
-        col_str = QString(get_column_text(cinfo, column));
         *col_text << col_str;
         col_lines = static_cast<int>(col_str.count('\n'));
         if (col_lines > lines_) {
@@ -21,6 +21,7 @@
 
 #include <QByteArray>
 #include <QCache>
+#include <QHash>
 #include <QList>
 #include <QVariant>
 
@@ -47,7 +48,7 @@ public:
 
     void invalidateColorized() { colorized_ = false; }
     void invalidateRecord() { col_text_cache_.remove(fdata_->num); }
-    static void invalidateAllRecords() { col_text_cache_.clear(); }
+    static void invalidateAllRecords() { col_text_cache_.clear(); col_text_pool_.clear(); }
     /* In Qt 6, QCache maxCost is a qsizetype, but the QAbstractItemModel
      * number of rows is still an int, so we're limited to INT_MAX anyway.
      */
@@ -61,6 +62,9 @@ public:
 private:
     /** The column text for some columns */
     static QCache<guint32, QStringList> col_text_cache_;
+    /** Shared copies of short, frequently repeated column strings
+     *  ("TCP", addresses, ...), keyed by their UTF-8 text */
+    static QHash<QByteArray, QString> col_text_pool_;
 
     frame_data *fdata_;
     int lines_;
@@ -79,6 +83,7 @@ private:
 
     void dissect(capture_file *cap_file, bool dissect_columns, bool dissect_color = false);
     void cacheColumnStrings(column_info *cinfo);
+    static QString pooledColumnString(const char *str);
 };
 
 #endif // PACKET_LIST_RECORD_H
@@ -33,6 +33,9 @@ void UatModel::loadUat(epan_uat * uat)
 {
     uat_ = uat;
 
+    // Tables loaded on demand might not have been used yet.
+    uat_ensure_loaded(uat_);
+
     dirty_records.reserve(uat_->raw_data->len);
     // Validate existing data such that they can be marked as invalid if necessary.
     record_errors.reserve(uat_->raw_data->len);
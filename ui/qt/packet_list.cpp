@@ -272,6 +272,7 @@ PacketList::PacketList(QWidget *parent) :
             this, SLOT(sectionMoved(int,int,int)));
 
     connect(verticalScrollBar(), SIGNAL(actionTriggered(int)), this, SLOT(vScrollBarActionTriggered(int)));
+    connect(verticalScrollBar(), &QScrollBar::valueChanged, this, &PacketList::prefetchNextPage);
 }
 
 PacketList::~PacketList()
@@ -1925,6 +1926,20 @@ void PacketList::copySummary()
 
 // We need to tell when the user has scrolled the packet list, either to
 // the end or anywhere other than the end.
+// Dissect the page below the viewport ahead of time so that scrolling
+// down doesn't stall on each new page.
+void PacketList::prefetchNextPage()
+{
+    QModelIndex top = indexAt(viewport()->rect().topLeft());
+    QModelIndex bottom = indexAt(viewport()->rect().bottomLeft());
+
+    if (!top.isValid() || !bottom.isValid()) {
+        return;
+    }
+
+    packet_list_model_->prefetchRows(bottom.row() + 1, bottom.row() - top.row() + 1);
+}
+
 void PacketList::vScrollBarActionTriggered(int)
 {
     // If we're scrolling with a mouse wheel or trackpad sliderPosition can end up
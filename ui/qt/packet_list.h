@@ -199,6 +199,7 @@ private slots:
     void updateRowHeights(const QModelIndex &ih_index);
     void copySummary();
     void vScrollBarActionTriggered(int);
+    void prefetchNextPage();
     void drawFarOverlay();
     void drawNearOverlay();
     void updatePackets(bool redraw);
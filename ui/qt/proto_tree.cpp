@@ -462,10 +462,13 @@ void ProtoTree::foreachExpand(const QModelIndex &index = QModelIndex()) {
         childIndex = proto_tree_model_->index(child, 0, index);
         if (childIndex.isValid()) {
             ProtoNode *node = proto_tree_model_->protoNodeFromIndex(childIndex);
+            // Only descend into expanded items. Collapsed subtrees are
+            // restored by syncExpanded when they're opened, which keeps
+            // the model from creating nodes nobody can see.
             if (node && node->isValid() && tree_expanded(node->protoNode()->finfo->tree_type)) {
                 expand(childIndex);
+                foreachExpand(childIndex);
             }
-            foreachExpand(childIndex);
         }
     }
 }
@@ -548,6 +551,11 @@ void ProtoTree::syncExpanded(const QModelIndex &index) {
     if (finfo.treeType() != -1) {
         tree_expanded_set(finfo.treeType(), TRUE);
     }
+
+    // Restore the expanded state of any subtrees below this one.
+    disconnect(this, SIGNAL(expanded(QModelIndex)), this, SLOT(syncExpanded(QModelIndex)));
+    foreachExpand(index);
+    connect(this, SIGNAL(expanded(QModelIndex)), this, SLOT(syncExpanded(QModelIndex)));
 }
 
 void ProtoTree::syncCollapsed(const QModelIndex &index) {
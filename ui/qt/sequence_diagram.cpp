@@ -21,6 +21,7 @@
 #include <QPalette>
 #include <QPen>
 #include <QPointF>
+#include <QtMath>
 
 const int max_comment_em_width_ = 20;
 
@@ -198,6 +199,18 @@ void SequenceDiagram::setSelectedPacket(int selected_packet)
     } else {
         selected_packet_ = 0;
     }
+
+    // draw() only visits rows in view, so look up the key here in case the
+    // selected packet is scrolled out of sight.
+    if (selected_packet_ > 0) {
+        WSCPSeqDataMap::const_iterator it;
+        for (it = data_->constBegin(); it != data_->constEnd(); ++it) {
+            if (it.value().value->frame_number == selected_packet_) {
+                selected_key_ = it.key();
+                break;
+            }
+        }
+    }
     mParentPlot->replot();
 }
 
@@ -243,12 +256,18 @@ void SequenceDiagram::draw(QCPPainter *painter)
     painter->restore();
     fg_pen = pen();
 
-    WSCPSeqDataMap::const_iterator it;
-    for (it = data_->constBegin(); it != data_->constEnd(); ++it) {
+    // Items are keyed by row, so only walk the ones that overlap the
+    // visible key range. Flow graphs can have millions of items.
+    WSCPSeqDataMap::const_iterator it = data_->lowerBound(qFloor(key_axis_->range().lower) - 1.0);
+    for (; it != data_->constEnd(); ++it) {
         double cur_key = it.key();
         seq_analysis_item_t *sai = it.value().value;
         QColor bg_color;
 
+        if (cur_key > key_axis_->range().upper + 1.0) {
+            break;
+        }
+
         if (sai->frame_number == selected_packet_) {
             QPalette sel_pal;
             fg_pen.setColor(sel_pal.color(QPalette::HighlightedText));
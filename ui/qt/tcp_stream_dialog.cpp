@@ -697,7 +697,7 @@ void TCPStreamDialog::zoomAxes(bool in)
 
     sp->xAxis->scaleRange(h_factor, sp->xAxis->range().center());
     sp->yAxis->scaleRange(v_factor, sp->yAxis->range().center());
-    sp->replot();
+    sp->replot(QCustomPlot::rpQueuedReplot);
 }
 
 void TCPStreamDialog::zoomXAxis(bool in)
@@ -710,7 +710,7 @@ void TCPStreamDialog::zoomXAxis(bool in)
     }
 
     sp->xAxis->scaleRange(h_factor, sp->xAxis->range().center());
-    sp->replot();
+    sp->replot(QCustomPlot::rpQueuedReplot);
 }
 
 void TCPStreamDialog::zoomYAxis(bool in)
@@ -723,7 +723,7 @@ void TCPStreamDialog::zoomYAxis(bool in)
     }
 
     sp->yAxis->scaleRange(v_factor, sp->yAxis->range().center());
-    sp->replot();
+    sp->replot(QCustomPlot::rpQueuedReplot);
 }
 
 void TCPStreamDialog::panAxes(int x_pixels, int y_pixels)
@@ -737,11 +737,11 @@ void TCPStreamDialog::panAxes(int x_pixels, int y_pixels)
     // The GTK+ version won't pan unless we're zoomed. Should we do the same here?
     if (h_pan) {
         sp->xAxis->moveRange(h_pan);
-        sp->replot();
+        sp->replot(QCustomPlot::rpQueuedReplot);
     }
     if (v_pan) {
         sp->yAxis->moveRange(v_pan);
-        sp->replot();
+        sp->replot(QCustomPlot::rpQueuedReplot);
     }
 }
 
@@ -796,7 +796,7 @@ void TCPStreamDialog::fillStevens()
         rel_time.append(ts - ts_offset_);
         seq.append(seg->th_seq - seq_offset_);
     }
-    base_graph_->setData(rel_time, seq);
+    base_graph_->setData(rel_time, seq, true);
 }
 
 void TCPStreamDialog::fillTcptrace()
@@ -1327,7 +1327,7 @@ void TCPStreamDialog::fillThroughput()
             r_Xput_times.append(ts);
         }
     }
-    base_graph_->setData(seg_rel_times, seg_lens);
+    base_graph_->setData(seg_rel_times, seg_lens, true);
     tput_graph_->setData(tput_times, tputs);
     goodput_graph_->setData(gput_times, gputs);
 }
@@ -1580,8 +1580,8 @@ void TCPStreamDialog::fillWindowScale()
             }
         }
     }
-    base_graph_->setData(cwnd_time, cwnd_size);
-    rwin_graph_->setData(rel_time, win_size);
+    base_graph_->setData(cwnd_time, cwnd_size, true);
+    rwin_graph_->setData(rel_time, win_size, true);
     sp->yAxis->setLabel(window_size_label_);
 }
 
@@ -1772,7 +1772,7 @@ void TCPStreamDialog::mouseMoved(QMouseEvent *event)
             tracer_->setVisible(false);
             hint += "Hover over the graph for details. " + stream_desc_ + "</i></small>";
             ui->hintLabel->setText(hint);
-            ui->streamPlot->replot();
+            ui->streamPlot->replot(QCustomPlot::rpQueuedReplot);
             return;
         }
 
@@ -1787,7 +1787,7 @@ void TCPStreamDialog::mouseMoved(QMouseEvent *event)
                 .arg(packet_seg->th_ack)
                 .arg(packet_seg->th_win);
         tracer_->setGraphKey(ui->streamPlot->xAxis->pixelToCoord(event->pos().x()));
-        sp->replot();
+        sp->replot(QCustomPlot::rpQueuedReplot);
     } else {
         if (rubber_band_ && rubber_band_->isVisible() && event) {
             rubber_band_->setGeometry(QRect(rb_origin_, event->pos()).normalized());
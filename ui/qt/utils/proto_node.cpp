@@ -13,23 +13,38 @@
 #include <epan/prefs.h>
 
 ProtoNode::ProtoNode(proto_node *node, ProtoNode *parent) :
-    node_(node), parent_(parent)
+    node_(node), parent_(parent), row_(-1), children_loaded_(false)
 {
-    if (node_) {
+}
+
+// Create our children the first time someone asks for them. Packets can
+// have many thousands of items, and most of them sit in collapsed
+// subtrees that are never looked at.
+void ProtoNode::loadChildren() const
+{
+    if (children_loaded_) {
+        return;
+    }
+    children_loaded_ = true;
 
-        int num_children = 0;
-        for (proto_node *child = node_->first_child; child; child = child->next) {
-            if (!isHidden(child)) {
-                num_children++;
-            }
+    if (!node_) {
+        return;
+    }
+
+    int num_children = 0;
+    for (proto_node *child = node_->first_child; child; child = child->next) {
+        if (!isHidden(child)) {
+            num_children++;
         }
+    }
 
-        m_children.reserve(num_children);
+    m_children.reserve(num_children);
 
-        for (proto_node *child = node_->first_child; child; child = child->next) {
-            if (!isHidden(child)) {
-                m_children.append(new ProtoNode(child, this));
-            }
+    for (proto_node *child = node_->first_child; child; child = child->next) {
+        if (!isHidden(child)) {
+            ProtoNode *child_node = new ProtoNode(child, const_cast<ProtoNode *>(this));
+            child_node->row_ = (int)m_children.count();
+            m_children.append(child_node);
         }
     }
 }
@@ -91,6 +106,7 @@ int ProtoNode::childrenCount() const
 {
     if (!node_) return 0;
 
+    loadChildren();
     return (int)m_children.count();
 }
 
@@ -100,7 +116,7 @@ int ProtoNode::row()
         return -1;
     }
 
-    return (int)parent_->m_children.indexOf(const_cast<ProtoNode*>(this));
+    return row_;
 }
 
 bool ProtoNode::isExpanded() const
@@ -118,6 +134,7 @@ proto_node * ProtoNode::protoNode() const
 
 ProtoNode* ProtoNode::child(int row)
 {
+    loadChildren();
     if (row < 0 || row >= m_children.size())
         return nullptr;
     return m_children.at(row);
@@ -54,8 +54,11 @@ public:
 
 private:
     proto_node * node_;
-    QVector<ProtoNode*>m_children;
+    mutable QVector<ProtoNode*>m_children;
     ProtoNode *parent_;
+    int row_;
+    mutable bool children_loaded_;
+    void loadChildren() const;
     static bool isHidden(proto_node * node);
 };
 
@@ -359,16 +359,15 @@ void VoipCallsDialog::tapDraw(void *tapinfo_ptr)
         return;
     }
 
-    GList *graph_item = g_queue_peek_nth_link(tapinfo->graph_analysis->items, 0);
-    for (; graph_item; graph_item = gxx_list_next(graph_item)) {
-        for (GList *rsi_entry = g_list_first(tapinfo->rtpstream_list); rsi_entry; rsi_entry = gxx_list_next(rsi_entry)) {
-            seq_analysis_item_t * sai = gxx_list_data(seq_analysis_item_t *, graph_item);
-            rtpstream_info_t *rsi = gxx_list_data(rtpstream_info_t *, rsi_entry);
-
-            if (rsi->start_fd->num == sai->frame_number) {
-                rsi->call_num = sai->conv_num;
-                // VOIP_CALLS_DEBUG("setting conv num %u for frame %u", sai->conv_num, sai->frame_number);
-            }
+    // Look up each stream's first frame in the graph instead of comparing
+    // every graph item with every stream.
+    for (GList *rsi_entry = g_list_first(tapinfo->rtpstream_list); rsi_entry; rsi_entry = gxx_list_next(rsi_entry)) {
+        rtpstream_info_t *rsi = gxx_list_data(rtpstream_info_t *, rsi_entry);
+        seq_analysis_item_t *sai = (seq_analysis_item_t *)g_hash_table_lookup(tapinfo->graph_analysis->ht, GUINT_TO_POINTER(rsi->start_fd->num));
+
+        if (sai) {
+            rsi->call_num = sai->conv_num;
+            // VOIP_CALLS_DEBUG("setting conv num %u for frame %u", sai->conv_num, sai->frame_number);
         }
     }
 
@@ -378,14 +377,6 @@ void VoipCallsDialog::tapDraw(void *tapinfo_ptr)
     }
 }
 
-gint VoipCallsDialog::compareCallNums(gconstpointer a, gconstpointer b)
-{
-    const voip_calls_info_t *call_a = (const voip_calls_info_t *)a;
-    const voip_calls_info_t *call_b = (const voip_calls_info_t *)b;
-
-    return (call_a->call_num != call_b->call_num);
-}
-
 void VoipCallsDialog::updateCalls()
 {
     voip_calls_info_t *new_callsinfo;
@@ -400,10 +391,11 @@ void VoipCallsDialog::updateCalls()
     while (list) {
         // Find new callsinfo
         new_callsinfo = gxx_list_data(voip_calls_info_t*, list);
-        found = g_queue_find_custom(shown_callsinfos_, new_callsinfo, VoipCallsDialog::compareCallNums);
+        found = shown_callsinfo_links_.value(new_callsinfo->call_num, NULL);
         if (!found) {
             // New call, add it to list for show
             g_queue_push_tail(shown_callsinfos_, new_callsinfo);
+            shown_callsinfo_links_.insert(new_callsinfo->call_num, shown_callsinfos_->tail);
         } else {
             // Existing call
             old_callsinfo = (voip_calls_info_t *)found->data;
@@ -756,6 +748,7 @@ void VoipCallsDialog::removeAllCalls()
         list = g_list_next(list);
     }
     g_queue_clear(shown_callsinfos_);
+    shown_callsinfo_links_.clear();
 }
 
 void VoipCallsDialog::displayFilterCheckBoxToggled(bool checked)
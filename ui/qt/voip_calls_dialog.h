@@ -26,6 +26,7 @@
 #include "ui/rtp_stream_id.h"
 #include "wireshark_dialog.h"
 
+#include <QHash>
 #include <QMenu>
 #include <QAbstractButton>
 #include <QPushButton>
@@ -105,12 +106,12 @@ private:
     QPushButton *copy_button_;
     bool voip_calls_tap_listeners_removed_;
     GQueue* shown_callsinfos_; /* queue with all shown calls (voip_calls_info_t) */
+    QHash<int, GList *> shown_callsinfo_links_; /* call_num -> link in shown_callsinfos_ */
 
     // Tap callbacks
     static void tapReset(void *tapinfo_ptr);
     static tap_packet_status tapPacket(void *tapinfo_ptr, packet_info *pinfo, epan_dissect_t *, const void *data, tap_flags_t flags);
     static void tapDraw(void *tapinfo_ptr);
-    static gint compareCallNums(gconstpointer a, gconstpointer b);
 
     void updateCalls();
     void prepareFilter();
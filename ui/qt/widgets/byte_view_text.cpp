@@ -358,7 +358,16 @@ void ByteViewText::mouseMoveEvent(QMouseEvent *event)
         return;
     }
 
-    hovered_byte_offset_ = byteOffsetAtPixel(event->pos());
+    // Finding the field under the cursor means searching the protocol
+    // tree, which can be large for reassembled data. Only do it when the
+    // pointer moves to a different byte. mousePressEvent calls us with a
+    // button press event in order to force an update.
+    const int byte_offset = byteOffsetAtPixel(event->pos());
+    if (event->type() == QEvent::MouseMove && byte_offset == hovered_byte_offset_) {
+        return;
+    }
+
+    hovered_byte_offset_ = byte_offset;
     emit byteHovered(hovered_byte_offset_);
     viewport()->update();
 }
@@ -418,6 +427,10 @@ void ByteViewText::drawLine(QPainter *painter, const int offset, const int row_y
     QString line;
     HighlightMode offset_mode = ModeOffsetNormal;
 
+    // Make room for the whole line up front. BYTES_BITS is the widest
+    // format at nine characters per byte, plus one for the ASCII column.
+    line.reserve(offsetChars() + row_width_ * 11 + 8);
+
     // Offset.
     if (show_offset_) {
         line = QString(" %1 ").arg(offset, offsetChars(false), 16, QChar('0'));
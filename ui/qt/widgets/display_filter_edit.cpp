@@ -549,28 +549,25 @@ void DisplayFilterEdit::buildCompletionList(const QString &field_word, const QSt
     if (autocomplete_accepts_field_) {
         void *proto_cookie;
 
-        int field_dots = static_cast<int>(field_word.count('.')); // Some protocol names (_ws.expert) contain periods.
         for (int proto_id = proto_get_first_protocol(&proto_cookie); proto_id != -1; proto_id = proto_get_next_protocol(&proto_cookie)) {
             protocol_t *protocol = find_protocol_by_id(proto_id);
             if (!proto_is_protocol_enabled(protocol)) continue;
 
-            const QString pfname = proto_get_protocol_filter_name(proto_id);
-            field_list << pfname;
-
-            // Add fields only if we're past the protocol name and only for the
-            // current protocol.
-            if (field_dots > pfname.count('.')) {
-                void *field_cookie;
-                const QByteArray fw_ba = field_word.toUtf8(); // or toLatin1 or toStdString?
-                const char *fw_utf8 = fw_ba.constData();
-                gsize fw_len = (gsize) strlen(fw_utf8);
-                for (header_field_info *hfinfo = proto_get_first_protocol_field(proto_id, &field_cookie); hfinfo; hfinfo = proto_get_next_protocol_field(proto_id, &field_cookie)) {
-                    if (hfinfo->same_name_prev_id != -1) continue; // Ignore duplicate names.
-
-                    if (!g_ascii_strncasecmp(fw_utf8, hfinfo->abbrev, fw_len)) {
-                        if ((gsize) strlen(hfinfo->abbrev) != fw_len) field_list << hfinfo->abbrev;
-                    }
-                }
+            field_list << proto_get_protocol_filter_name(proto_id);
+        }
+
+        // Add fields only once we're past a protocol name. Only the names
+        // sharing the typed prefix are visited, via the sorted name index.
+        if (field_word.contains('.')) {
+            void *field_cookie;
+            const QByteArray fw_ba = field_word.toUtf8(); // or toLatin1 or toStdString?
+            const char *fw_utf8 = fw_ba.constData();
+            gsize fw_len = (gsize) strlen(fw_utf8);
+            for (header_field_info *hfinfo = proto_registrar_get_first_with_prefix(fw_utf8, &field_cookie); hfinfo; hfinfo = proto_registrar_get_next_with_prefix(fw_utf8, &field_cookie)) {
+                if (hfinfo->parent == -1) continue; // Protocols were added above.
+                if (!proto_is_protocol_enabled(find_protocol_by_id(hfinfo->parent))) continue;
+
+                if ((gsize) strlen(hfinfo->abbrev) != fw_len) field_list << hfinfo->abbrev;
             }
         }
         field_list.sort();
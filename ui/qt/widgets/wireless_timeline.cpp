@@ -252,7 +252,7 @@ void WirelessTimeline::captureFileReadStarted(capture_file *cf)
 void WirelessTimeline::captureFileReadFinished()
 {
     /* All frames must be included in packet list */
-    if (cfile.count == 0 || g_hash_table_size(radio_packet_list) != cfile.count)
+    if (cfile.count == 0 || radio_packet_list->len <= cfile.count)
         return;
 
     /* check that all frames have start and end tsf time and are reasonable time order.
@@ -269,6 +269,8 @@ void WirelessTimeline::captureFileReadFinished()
     /* TODO: indicate error message to the user */
     for (guint32 n = 1; n < cfile.count; n++) {
         struct wlan_radio *w = get_wlan_radio(n);
+        if (w == NULL)
+            return;
         if (w->start_tsf == 0 || w->end_tsf == 0) {
             QString err = tr("Packet number %1 does not include TSF timestamp, not showing timeline.").arg(n);
             mainApp->pushStatus(MainApplication::TemporaryStatus, err);
@@ -342,7 +344,7 @@ WirelessTimeline::WirelessTimeline(QWidget *parent) : QWidget(parent)
     last = NULL;
     capfile = NULL;
 
-    radio_packet_list = g_hash_table_new(g_direct_hash, g_direct_equal);
+    radio_packet_list = g_ptr_array_new();
     connect(mainApp, &MainApplication::appInitialized, this, &WirelessTimeline::appInitialized);
 }
 
@@ -350,7 +352,7 @@ WirelessTimeline::~WirelessTimeline()
 {
     if (radio_packet_list != NULL)
     {
-        g_hash_table_destroy(radio_packet_list);
+        g_ptr_array_free(radio_packet_list, TRUE);
     }
 }
 
@@ -365,11 +367,11 @@ void WirelessTimeline::tap_timeline_reset(void* tapdata)
 
     if (timeline->radio_packet_list != NULL)
     {
-        g_hash_table_destroy(timeline->radio_packet_list);
+        g_ptr_array_free(timeline->radio_packet_list, TRUE);
     }
     timeline->hide();
 
-    timeline->radio_packet_list = g_hash_table_new(g_direct_hash, g_direct_equal);
+    timeline->radio_packet_list = g_ptr_array_new();
 }
 
 tap_packet_status WirelessTimeline::tap_timeline_packet(void *tapdata, packet_info* pinfo, epan_dissect_t* edt _U_, const void *data, tap_flags_t)
@@ -377,14 +379,20 @@ tap_packet_status WirelessTimeline::tap_timeline_packet(void *tapdata, packet_in
     WirelessTimeline* timeline = (WirelessTimeline*)tapdata;
     const struct wlan_radio *wlan_radio_info = (const struct wlan_radio *)data;
 
-    /* Save the radio information in our own (GUI) hashtable */
-    g_hash_table_insert(timeline->radio_packet_list, GUINT_TO_POINTER(pinfo->num), (gpointer)wlan_radio_info);
+    /* Save the radio information in our own (GUI) array, indexed by frame
+     * number. Frames are tapped in order during the first pass, so this
+     * normally just appends. */
+    if (pinfo->num >= timeline->radio_packet_list->len)
+        g_ptr_array_set_size(timeline->radio_packet_list, pinfo->num + 1);
+    g_ptr_array_index(timeline->radio_packet_list, pinfo->num) = (gpointer)wlan_radio_info;
     return TAP_PACKET_DONT_REDRAW;
 }
 
 struct wlan_radio* WirelessTimeline::get_wlan_radio(guint32 packet_num)
 {
-    return (struct wlan_radio*)g_hash_table_lookup(radio_packet_list, GUINT_TO_POINTER(packet_num));
+    if (packet_num >= radio_packet_list->len)
+        return NULL;
+    return (struct wlan_radio*)g_ptr_array_index(radio_packet_list, packet_num);
 }
 
 void WirelessTimeline::doToolTip(struct wlan_radio *wr, QPoint pos, int x)
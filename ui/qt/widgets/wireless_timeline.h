@@ -94,7 +94,7 @@ protected:
     struct wlan_radio *first, *last;
     capture_file *capfile;
 
-    GHashTable* radio_packet_list;
+    GPtrArray* radio_packet_list;
 
 protected slots:
     void selectedFrameChanged(QList<int>);
@@ -42,7 +42,7 @@ typedef struct _rtpstream_info {
 
     guint8          first_payload_type; /**< Numeric payload type */
     const gchar    *first_payload_type_name; /**< Payload type name */
-    const gchar    *payload_type_names[256]; /**< Seen payload type names. Array index is payload type (byte), filled only during TAP_ANALYSE */
+    guint64         payload_types_seen[4]; /**< Bitmap of seen payload types, filled only during TAP_ANALYSE */
     gchar          *all_payload_type_names; /**< All seen payload names for a stream in one string */
 
     gboolean        is_srtp;
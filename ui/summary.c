@@ -25,6 +25,20 @@
 
 #define HASH_BUF_SIZE (1024 * 1024)
 
+/*
+ * Hashing reads the whole file, which on large captures takes far
+ * longer than the rest of the summary. Remember the hashes of the last
+ * file, and reuse them as long as its size and modification time are
+ * unchanged.
+ */
+static struct {
+    gchar  *filename;
+    gint64  size;
+    time_t  mtime;
+    gchar   sha256[HASH_STR_SIZE];
+    gchar   sha1[HASH_STR_SIZE];
+} hash_cache;
+
 static void
 tally_frame_data(frame_data *cur_frame, summary_tally *sum_tally)
 {
@@ -102,6 +116,62 @@ hash_to_str(const unsigned char *hash, size_t length, char *str) {
   }
 }
 
+static void
+summary_fill_in_hashes(const char *filename, summary_tally *st)
+{
+    ws_statb64 statb;
+    gboolean have_stat;
+    FILE  *fh;
+    char  *hash_buf;
+    gcry_md_hd_t hd;
+    size_t hash_bytes;
+
+    (void) g_strlcpy(st->file_sha256, "<unknown>", HASH_STR_SIZE);
+    (void) g_strlcpy(st->file_sha1, "<unknown>", HASH_STR_SIZE);
+
+    if (filename == NULL) {
+        return;
+    }
+
+    have_stat = ws_stat64(filename, &statb) == 0;
+    if (have_stat && hash_cache.filename != NULL &&
+            strcmp(hash_cache.filename, filename) == 0 &&
+            hash_cache.size == (gint64)statb.st_size &&
+            hash_cache.mtime == statb.st_mtime) {
+        (void) g_strlcpy(st->file_sha256, hash_cache.sha256, HASH_STR_SIZE);
+        (void) g_strlcpy(st->file_sha1, hash_cache.sha1, HASH_STR_SIZE);
+        return;
+    }
+
+    gcry_md_open(&hd, GCRY_MD_SHA256, 0);
+    if (hd) {
+        gcry_md_enable(hd, GCRY_MD_SHA1);
+    }
+    hash_buf = (char *)g_malloc(HASH_BUF_SIZE);
+
+    fh = ws_fopen(filename, "rb");
+    if (fh && hash_buf && hd) {
+        while((hash_bytes = fread(hash_buf, 1, HASH_BUF_SIZE, fh)) > 0) {
+            gcry_md_write(hd, hash_buf, hash_bytes);
+        }
+        gcry_md_final(hd);
+        hash_to_str(gcry_md_read(hd, GCRY_MD_SHA256), HASH_SIZE_SHA256, st->file_sha256);
+        hash_to_str(gcry_md_read(hd, GCRY_MD_SHA1), HASH_SIZE_SHA1, st->file_sha1);
+
+        if (have_stat) {
+            g_free(hash_cache.filename);
+            hash_cache.filename = g_strdup(filename);
+            hash_cache.size = (gint64)statb.st_size;
+            hash_cache.mtime = statb.st_mtime;
+            (void) g_strlcpy(hash_cache.sha256, st->file_sha256, HASH_STR_SIZE);
+            (void) g_strlcpy(hash_cache.sha1, st->file_sha1, HASH_STR_SIZE);
+        }
+    }
+    if (fh) fclose(fh);
+    g_free(hash_buf);
+    gcry_md_close(hd);
+}
+
 void
 summary_fill_in(capture_file *cf, summary_tally *st)
 {
@@ -117,11 +187,6 @@ summary_fill_in(capture_file *cf, summary_tally *st)
     char* if_string;
     if_filter_opt_t if_filter;
 
-    FILE  *fh;
-    char  *hash_buf;
-    gcry_md_hd_t hd;
-    size_t hash_bytes;
-
     st->packet_count_ts = 0;
     st->start_time = 0;
     st->stop_time = 0;
@@ -211,27 +276,7 @@ summary_fill_in(capture_file *cf, summary_tally *st)
     }
     g_free(idb_info);
 
-    (void) g_strlcpy(st->file_sha256, "<unknown>", HASH_STR_SIZE);
-    (void) g_strlcpy(st->file_sha1, "<unknown>", HASH_STR_SIZE);
-
-    gcry_md_open(&hd, GCRY_MD_SHA256, 0);
-    if (hd) {
-        gcry_md_enable(hd, GCRY_MD_SHA1);
-    }
-    hash_buf = (char *)g_malloc(HASH_BUF_SIZE);
-
-    fh = ws_fopen(cf->filename, "rb");
-    if (fh && hash_buf && hd) {
-        while((hash_bytes = fread(hash_buf, 1, HASH_BUF_SIZE, fh)) > 0) {
-            gcry_md_write(hd, hash_buf, hash_bytes);
-        }
-        gcry_md_final(hd);
-        hash_to_str(gcry_md_read(hd, GCRY_MD_SHA256), HASH_SIZE_SHA256, st->file_sha256);
-        hash_to_str(gcry_md_read(hd, GCRY_MD_SHA1), HASH_SIZE_SHA1, st->file_sha1);
-    }
-    if (fh) fclose(fh);
-    g_free(hash_buf);
-    gcry_md_close(hd);
+    summary_fill_in_hashes(cf->filename, st);
 }
 
 #ifdef HAVE_LIBPCAP
@@ -28,6 +28,7 @@
 #include <epan/proto_data.h>
 #include <epan/dissectors/packet-rtp.h>
 #include <wsutil/pint.h>
+#include <wsutil/bits_count_ones.h>
 #include "rtp_stream.h"
 #include "tap-rtp-common.h"
 
@@ -257,8 +258,13 @@ static const gchar *PAYLOAD_UNKNOWN_STR = "Unknown";
 
 static void update_payload_names(rtpstream_info_t *stream_info, const struct _rtp_info *rtpinfo)
 {
-    GString *payload_type_names;
     const gchar *new_payload_type_str;
+    guint8 payload_type = rtpinfo->info_payload_type;
+    guint64 pt_bit = G_GUINT64_CONSTANT(1) << (payload_type % 64);
+    guint position = 0;
+    gchar **names;
+    const gchar **new_names;
+    guint n_names;
 
     /* Ensure that we have non empty payload_type_str */
     if (rtpinfo->info_payload_type_str != NULL) {
@@ -266,33 +272,44 @@ static void update_payload_names(rtpstream_info_t *stream_info, const struct _rt
     }
     else {
         /* String is created from const strings only */
-        new_payload_type_str = val_to_str_ext_const(rtpinfo->info_payload_type,
+        new_payload_type_str = val_to_str_ext_const(payload_type,
             &rtp_payload_type_short_vals_ext,
             PAYLOAD_UNKNOWN_STR
         );
     }
-    stream_info->payload_type_names[rtpinfo->info_payload_type] = new_payload_type_str;
-
-    /* Join all existing payload names to one string */
-    payload_type_names = g_string_sized_new(40); /* Preallocate memory */
-    for(int i=0; i<256; i++) {
-        if (stream_info->payload_type_names[i] != NULL) {
-            if (payload_type_names->len > 0) {
-                g_string_append(payload_type_names, ", ");
-            }
-            g_string_append(payload_type_names, stream_info->payload_type_names[i]);
-        }
+
+    /* The names are joined in payload type order. The position of the
+     * new one is the number of lower payload types we have already seen. */
+    for (int i = 0; i < payload_type / 64; i++) {
+        position += ws_count_ones(stream_info->payload_types_seen[i]);
     }
-    if (stream_info->all_payload_type_names != NULL) {
-        g_free(stream_info->all_payload_type_names);
+    position += ws_count_ones(stream_info->payload_types_seen[payload_type / 64] & (pt_bit - 1));
+    stream_info->payload_types_seen[payload_type / 64] |= pt_bit;
+
+    if (stream_info->all_payload_type_names == NULL) {
+        stream_info->all_payload_type_names = g_strdup(new_payload_type_str);
+        return;
     }
-    stream_info->all_payload_type_names = payload_type_names->str;
-    g_string_free(payload_type_names, FALSE);
+
+    /* Insert the new name into the existing list */
+    names = g_strsplit(stream_info->all_payload_type_names, ", ", -1);
+    n_names = g_strv_length(names);
+    position = MIN(position, n_names);
+    new_names = g_new(const gchar *, n_names + 2);
+    memcpy(new_names, names, position * sizeof(gchar *));
+    new_names[position] = new_payload_type_str;
+    memcpy(new_names + position + 1, names + position, (n_names - position) * sizeof(gchar *));
+    new_names[n_names + 1] = NULL;
+
+    g_free(stream_info->all_payload_type_names);
+    stream_info->all_payload_type_names = g_strjoinv(", ", (gchar **)new_names);
+    g_free(new_names);
+    g_strfreev(names);
 }
 
 gboolean rtpstream_is_payload_used(const rtpstream_info_t *stream_info, const guint8 payload_type)
 {
-    return stream_info->payload_type_names[payload_type] != NULL;
+    return (stream_info->payload_types_seen[payload_type / 64] & (G_GUINT64_CONSTANT(1) << (payload_type % 64))) != 0;
 }
 
 #define RTPFILE_VERSION "1.0"
@@ -544,7 +561,7 @@ void rtpstream_info_analyse_process(rtpstream_info_t *stream_info, const packet_
 {
     /* get RTP stats for the packet */
     rtppacket_analyse(&(stream_info->rtp_stats), pinfo, rtpinfo);
-    if (stream_info->payload_type_names[rtpinfo->info_payload_type] == NULL ) {
+    if (!rtpstream_is_payload_used(stream_info, rtpinfo->info_payload_type)) {
         update_payload_names(stream_info, rtpinfo);
     }
 
@@ -104,6 +104,7 @@ graph_segment_list_get(capture_file *cf, struct tcp_graph *tg)
 {
     GString    *error_string;
     tcp_scan_t  ts;
+    guint32     first_frame, last_frame;
 
     if (!cf || !tg) {
         return;
@@ -123,7 +124,12 @@ graph_segment_list_get(capture_file *cf, struct tcp_graph *tg)
         g_string_free(error_string, TRUE);
         exit(1);   /* XXX: fix this */
     }
-    cf_retap_packets(cf);
+    /* Only the frames of the stream can contribute segments. */
+    if (get_tcp_stream_frame_range(tg->stream, &first_frame, &last_frame)) {
+        cf_retap_packets_range(cf, first_frame, last_frame);
+    } else {
+        cf_retap_packets(cf);
+    }
     remove_tap_listener(&ts);
 }
 
@@ -395,7 +395,15 @@ write_byte(const char *str)
 {
     guint32 num;
 
-    if (parse_num(str, FALSE, &num) != IMPORT_SUCCESS)
+    /*
+     * The scanner hands us bytes as two hex digits, possibly followed
+     * by white space; convert those directly rather than through
+     * strtoul(), which is called for every byte of the dump.
+     */
+    if (g_ascii_isxdigit(str[0]) && g_ascii_isxdigit(str[1]) &&
+        !g_ascii_isxdigit(str[2])) {
+        num = (g_ascii_xdigit_value(str[0]) << 4) | g_ascii_xdigit_value(str[1]);
+    } else if (parse_num(str, FALSE, &num) != IMPORT_SUCCESS)
         return IMPORT_FAILURE;
 
     packet_buf[curr_offset] = (guint8) num;
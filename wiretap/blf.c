@@ -75,11 +75,19 @@ typedef struct blf_data {
 
     guint   current_log_container;
     GArray *log_containers;
+    GQueue *cached_containers;        /* indexes of containers with real_data, least recently used first */
 
     GHashTable *channel_to_iface_ht;
     guint32     next_interface_id;
 } blf_t;
 
+/*
+ * How many decompressed log containers to keep in memory. Containers are
+ * usually a few hundred KB when decompressed; sequential reads only need
+ * one or two at a time, and this leaves some room for random access.
+ */
+#define BLF_MAX_CACHED_CONTAINERS 32
+
 typedef struct blf_params {
     wtap     *wth;
     wtap_rec *rec;
@@ -483,16 +491,25 @@ blf_get_logcontainer_by_index(blf_t *blf_data, guint container_index, blf_log_co
 static gboolean
 blf_find_logcontainer_for_address(blf_t *blf_data, gint64 pos, blf_log_container_t **container, gint *container_index) {
     blf_log_container_t *tmp;
+    guint lo, hi, mid;
 
     if (blf_data == NULL || blf_data->log_containers == NULL) {
         return FALSE;
     }
 
-    for (guint i = 0; i < blf_data->log_containers->len; i++) {
-        tmp = &g_array_index(blf_data->log_containers, blf_log_container_t, i);
-        if (tmp->real_start_pos <= pos && pos < tmp->real_start_pos + (gint64)tmp->real_length) {
+    /* The containers are laid out back to back, so they are sorted by real_start_pos. */
+    lo = 0;
+    hi = blf_data->log_containers->len;
+    while (lo < hi) {
+        mid = lo + (hi - lo) / 2;
+        tmp = &g_array_index(blf_data->log_containers, blf_log_container_t, mid);
+        if (pos < tmp->real_start_pos) {
+            hi = mid;
+        } else if (pos >= tmp->real_start_pos + (gint64)tmp->real_length) {
+            lo = mid + 1;
+        } else {
             *container = tmp;
-            *container_index = i;
+            *container_index = mid;
             return TRUE;
         }
     }
@@ -500,6 +517,27 @@ blf_find_logcontainer_for_address(blf_t *blf_data, gint64 pos, blf_log_container
     return FALSE;
 }
 
+static void
+blf_cache_logcontainer(blf_t *blf_data, guint index_log_container) {
+    blf_log_container_t *tmp;
+
+    /* Mark it as most recently used */
+    if (!g_queue_is_empty(blf_data->cached_containers) &&
+        GPOINTER_TO_UINT(g_queue_peek_tail(blf_data->cached_containers)) == index_log_container) {
+        return;
+    }
+    g_queue_remove(blf_data->cached_containers, GUINT_TO_POINTER(index_log_container));
+    g_queue_push_tail(blf_data->cached_containers, GUINT_TO_POINTER(index_log_container));
+
+    /* Drop the least recently used containers */
+    while (g_queue_get_length(blf_data->cached_containers) > BLF_MAX_CACHED_CONTAINERS) {
+        tmp = &g_array_index(blf_data->log_containers, blf_log_container_t,
+                             GPOINTER_TO_UINT(g_queue_pop_head(blf_data->cached_containers)));
+        g_free(tmp->real_data);
+        tmp->real_data = NULL;
+    }
+}
+
 static gboolean
 blf_pull_logcontainer_into_memory(blf_params_t *params, guint index_log_container, int *err, gchar **err_info) {
     blf_t *blf_data = params->blf_data;
@@ -519,6 +557,7 @@ blf_pull_logcontainer_into_memory(blf_params_t *params, guint index_log_containe
     tmp = g_array_index(blf_data->log_containers, blf_log_container_t, index_log_container);
 
     if (tmp.real_data != NULL) {
+        blf_cache_logcontainer(blf_data, index_log_container);
         return TRUE;
     }
 
@@ -705,6 +744,7 @@ blf_pull_logcontainer_into_memory(blf_params_t *params, guint index_log_containe
         g_free(compressed_data);
         tmp.real_data = buf;
         g_array_index(blf_data->log_containers, blf_log_container_t, index_log_container) = tmp;
+        blf_cache_logcontainer(blf_data, index_log_container);
         return TRUE;
 #else
         *err = WTAP_ERR_DECOMPRESSION_NOT_SUPPORTED;
@@ -2279,6 +2319,11 @@ static void blf_close(wtap *wth) {
         blf->log_containers = NULL;
     }
 
+    if (blf != NULL && blf->cached_containers != NULL) {
+        g_queue_free(blf->cached_containers);
+        blf->cached_containers = NULL;
+    }
+
     if (blf != NULL && blf->channel_to_iface_ht != NULL) {
         g_hash_table_destroy(blf->channel_to_iface_ht);
         blf->channel_to_iface_ht = NULL;
@@ -2337,6 +2382,7 @@ blf_open(wtap *wth, int *err, gchar **err_info) {
     /* Prepare our private context. */
     blf = g_new(blf_t, 1);
     blf->log_containers = NULL;
+    blf->cached_containers = g_queue_new();
     blf->current_log_container = 0;
     blf->current_real_seek_pos = 0;
     blf->start_offset_ns = 1000 * 1000 * 1000 * (guint64)mktime(&timestamp);
@@ -275,6 +275,7 @@ erf_t *erf_priv_create(void)
   erf_priv->implicit_host_id = ERF_META_HOST_ID_IMPLICIT;
   erf_priv->capture_gentime = 0;
   erf_priv->host_gentime = 0;
+  erf_priv->anchor_mappings_to_update = g_ptr_array_new_with_free_func(erf_anchor_mapping_destroy);
 
   return erf_priv;
 }
@@ -285,6 +286,7 @@ erf_t* erf_priv_free(erf_t* erf_priv)
   {
     g_hash_table_destroy(erf_priv->anchor_map);
     g_hash_table_destroy(erf_priv->if_map);
+    g_ptr_array_free(erf_priv->anchor_mappings_to_update, TRUE);
     g_free(erf_priv);
   }
 
@@ -580,18 +582,19 @@ static gboolean erf_read(wtap *wth, wtap_rec *rec, Buffer *buf,
 
   *data_offset = file_tell(wth->fh);
 
-  anchor_mappings_to_update = g_ptr_array_new_with_free_func(erf_anchor_mapping_destroy);
+  /* Reuse the array rather than allocating one for every record */
+  anchor_mappings_to_update = ((erf_t *)wth->priv)->anchor_mappings_to_update;
 
   do {
     if (!erf_read_header(wth, wth->fh, rec, &erf_header,
                          err, err_info, &bytes_read, &packet_size,
                          anchor_mappings_to_update)) {
-      g_ptr_array_free(anchor_mappings_to_update, TRUE);
+      g_ptr_array_set_size(anchor_mappings_to_update, 0);
       return FALSE;
     }
 
     if (!wtap_read_packet_bytes(wth->fh, buf, packet_size, err, err_info)) {
-      g_ptr_array_free(anchor_mappings_to_update, TRUE);
+      g_ptr_array_set_size(anchor_mappings_to_update, 0);
       return FALSE;
     }
 
@@ -603,14 +606,14 @@ static gboolean erf_read(wtap *wth, wtap_rec *rec, Buffer *buf,
     if ((erf_header.type & 0x7F) == ERF_TYPE_META && packet_size > 0)
     {
       if (populate_summary_info((erf_t*) wth->priv, wth, &rec->rec_header.packet_header.pseudo_header, buf, packet_size, anchor_mappings_to_update, err, err_info) < 0) {
-        g_ptr_array_free(anchor_mappings_to_update, TRUE);
+        g_ptr_array_set_size(anchor_mappings_to_update, 0);
         return FALSE;
       }
     }
 
   } while ( erf_header.type == ERF_TYPE_PAD );
 
-  g_ptr_array_free(anchor_mappings_to_update, TRUE);
+  g_ptr_array_set_size(anchor_mappings_to_update, 0);
 
   return TRUE;
 }
@@ -626,17 +629,18 @@ static gboolean erf_seek_read(wtap *wth, gint64 seek_off,
   if (file_seek(wth->random_fh, seek_off, SEEK_SET, err) == -1)
     return FALSE;
 
-  anchor_mappings_to_update = g_ptr_array_new_with_free_func(erf_anchor_mapping_destroy);
+  /* Reuse the array rather than allocating one for every record */
+  anchor_mappings_to_update = ((erf_t *)wth->priv)->anchor_mappings_to_update;
 
   do {
     if (!erf_read_header(wth, wth->random_fh, rec, &erf_header,
                          err, err_info, NULL, &packet_size, anchor_mappings_to_update)) {
-      g_ptr_array_free(anchor_mappings_to_update, TRUE);
+      g_ptr_array_set_size(anchor_mappings_to_update, 0);
       return FALSE;
     }
   } while ( erf_header.type == ERF_TYPE_PAD );
 
-  g_ptr_array_free(anchor_mappings_to_update, TRUE);
+  g_ptr_array_set_size(anchor_mappings_to_update, 0);
 
   return wtap_read_packet_bytes(wth->random_fh, buf, packet_size,
                                 err, err_info);
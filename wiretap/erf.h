@@ -32,6 +32,7 @@ struct erf_private {
   guint64 implicit_host_id;
   guint64 capture_gentime;
   guint64 host_gentime;
+  GPtrArray* anchor_mappings_to_update; /* scratch space for erf_read()/erf_seek_read() */
 };
 
 #define MIN_RECORDS_FOR_ERF_CHECK 3
@@ -908,6 +908,7 @@ wtap_open_offline(const char *filename, unsigned int type, int *err, char **err_
 			g_free(wth);
 			return NULL;
 		}
+		file_set_sequential(wth->fh);
 	}
 
 	if (do_random) {
@@ -2723,6 +2724,25 @@ wtap_dump_discard_decryption_secrets(wtap_dumper *wdh)
 	}
 }
 
+/*
+ * Size of the stdio buffer for uncompressed files we write.  Records
+ * are written as several small pieces each, and stdio's default buffer
+ * is typically only a page, so this cuts down on write(2) calls when
+ * writing large files.
+ */
+#define WTAP_DUMP_FILE_BUFFER_SIZE	(128 * 1024)
+
+static FILE *
+wtap_dump_file_open_uncompressed(const char *filename)
+{
+	FILE *fh;
+
+	fh = ws_fopen(filename, "wb");
+	if (fh != NULL)
+		setvbuf(fh, NULL, _IOFBF, WTAP_DUMP_FILE_BUFFER_SIZE);
+	return fh;
+}
+
 /* internally open a file for writing (compressed or not) */
 #ifdef HAVE_ZLIB
 static WFILE_T
@@ -2731,14 +2751,14 @@ wtap_dump_file_open(wtap_dumper *wdh, const char *filename)
 	if (wdh->compression_type == WTAP_GZIP_COMPRESSED) {
 		return gzwfile_open(filename);
 	} else {
-		return ws_fopen(filename, "wb");
+		return wtap_dump_file_open_uncompressed(filename);
 	}
 }
 #else
 static WFILE_T
 wtap_dump_file_open(wtap_dumper *wdh _U_, const char *filename)
 {
-	return ws_fopen(filename, "wb");
+	return wtap_dump_file_open_uncompressed(filename);
 }
 #endif
 
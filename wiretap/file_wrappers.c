@@ -694,6 +694,56 @@ DIAG_ON(cast-qual)
 }
 #endif
 
+#ifdef HAVE_ZSTD
+/* Set up to decompress a zstd frame starting at the current input position. */
+static int
+zstd_reset(FILE_T state)
+{
+    const size_t ret = ZSTD_initDStream(state->zstd_dctx);
+    if (ZSTD_isError(ret)) {
+        state->err = WTAP_ERR_DECOMPRESS;
+        state->err_info = ZSTD_getErrorName(ret);
+        return -1;
+    }
+
+    state->compression = ZSTD;
+    state->is_compressed = TRUE;
+    return 0;
+}
+#endif
+
+#ifdef USE_LZ4
+/* Set up to decompress an lz4 frame starting at the current input position. */
+static int
+lz4_reset(FILE_T state)
+{
+#if LZ4_VERSION_NUMBER >= 10800
+    LZ4F_resetDecompressionContext(state->lz4_dctx);
+#else
+    LZ4F_freeDecompressionContext(state->lz4_dctx);
+    const LZ4F_errorCode_t ret = LZ4F_createDecompressionContext(&state->lz4_dctx, LZ4F_VERSION);
+    if (LZ4F_isError(ret)) {
+        state->err = WTAP_ERR_INTERNAL;
+        state->err_info = LZ4F_getErrorName(ret);
+        return -1;
+    }
+#endif
+    state->compression = LZ4;
+    state->is_compressed = TRUE;
+    return 0;
+}
+#endif
+
+/*
+ * zstd and lz4 both allow "skippable frames", with a magic number of
+ * 0x184D2A5?, to be interleaved with compressed frames; the zstd
+ * seekable format, for example, puts its seek table in one.  Both
+ * decompressors skip over them, so we hand them to whichever one
+ * handled the preceding frame.
+ */
+#define IS_SKIPPABLE_FRAME_MAGIC(p) \
+    (((p)[0] & 0xf0) == 0x50 && (p)[1] == 0x2a && (p)[2] == 0x4d && (p)[3] == 0x18)
+
 static int
 gz_head(FILE_T state)
 {
@@ -861,20 +911,24 @@ gz_head(FILE_T state)
     /* FD 37 7A 58 5A 00 */
 #endif
 
+    /*
+     * Files may consist of several zstd or lz4 frames; check the magic
+     * numbers at the current input position, not at the beginning of
+     * the buffer, which is where the first frame was.
+     */
     if (state->in.avail >= 4
-        && state->in.buf[0] == 0x28 && state->in.buf[1] == 0xb5
-        && state->in.buf[2] == 0x2f && state->in.buf[3] == 0xfd) {
+        && ((state->in.next[0] == 0x28 && state->in.next[1] == 0xb5
+             && state->in.next[2] == 0x2f && state->in.next[3] == 0xfd)
+            || (state->last_compression == ZSTD
+                && IS_SKIPPABLE_FRAME_MAGIC(state->in.next)))) {
 #ifdef HAVE_ZSTD
-        const size_t ret = ZSTD_initDStream(state->zstd_dctx);
-        if (ZSTD_isError(ret)) {
-            state->err = WTAP_ERR_DECOMPRESS;
-            state->err_info = ZSTD_getErrorName(ret);
-            return -1;
-        }
-
-        state->compression = ZSTD;
-        state->is_compressed = TRUE;
-        return 0;
+        /*
+         * Each frame is independent of the ones before it, so its
+         * start is a point from which we can resume decompressing.
+         */
+        if (state->fast_seek)
+            fast_seek_header(state, state->raw_pos - state->in.avail, state->pos, ZSTD);
+        return zstd_reset(state);
 #else
         state->err = WTAP_ERR_DECOMPRESSION_NOT_SUPPORTED;
         state->err_info = "reading zstd-compressed files isn't supported";
@@ -883,23 +937,15 @@ gz_head(FILE_T state)
     }
 
     if (state->in.avail >= 4
-        && state->in.buf[0] == 0x04 && state->in.buf[1] == 0x22
-        && state->in.buf[2] == 0x4d && state->in.buf[3] == 0x18) {
+        && ((state->in.next[0] == 0x04 && state->in.next[1] == 0x22
+             && state->in.next[2] == 0x4d && state->in.next[3] == 0x18)
+            || (state->last_compression == LZ4
+                && IS_SKIPPABLE_FRAME_MAGIC(state->in.next)))) {
 #ifdef USE_LZ4
-#if LZ4_VERSION_NUMBER >= 10800
-        LZ4F_resetDecompressionContext(state->lz4_dctx);
-#else
-        LZ4F_freeDecompressionContext(state->lz4_dctx);
-        const LZ4F_errorCode_t ret = LZ4F_createDecompressionContext(&state->lz4_dctx, LZ4F_VERSION);
-        if (LZ4F_isError(ret)) {
-            state->err = WTAP_ERR_INTERNAL;
-            state->err_info = LZ4F_getErrorName(ret);
-            return -1;
-        }
-#endif
-        state->compression = LZ4;
-        state->is_compressed = TRUE;
-        return 0;
+        /* As with zstd, every frame is a possible seek point. */
+        if (state->fast_seek)
+            fast_seek_header(state, state->raw_pos - state->in.avail, state->pos, LZ4);
+        return lz4_reset(state);
 #else
         state->err = WTAP_ERR_DECOMPRESSION_NOT_SUPPORTED;
         state->err_info = "reading lz4-compressed files isn't supported";
@@ -1288,6 +1334,35 @@ file_open(const char *path)
     return ft;
 }
 
+/*
+ * Tell the OS that we'll be reading this file from start to finish,
+ * so that it can read ahead more aggressively while we're busy
+ * decompressing or dissecting what we've already read.  This is
+ * only a hint; failures are ignored.
+ */
+void
+file_set_sequential(FILE_T stream _U_)
+{
+#ifdef HAVE_POSIX_FADVISE
+    (void)posix_fadvise(stream->fd, 0, 0, POSIX_FADV_SEQUENTIAL);
+#endif
+}
+
+/*
+ * Tell the OS whether reads from this file will, for the time being,
+ * go in increasing offset order, even if not contiguously, so that
+ * it can adjust its read-ahead.  This is only a hint; failures are
+ * ignored.
+ */
+void
+file_set_readahead(FILE_T stream _U_, gboolean sequential _U_)
+{
+#ifdef HAVE_POSIX_FADVISE
+    (void)posix_fadvise(stream->fd, 0, 0,
+                        sequential ? POSIX_FADV_SEQUENTIAL : POSIX_FADV_NORMAL);
+#endif
+}
+
 void
 file_set_random_access(FILE_T stream, gboolean random_flag _U_, GPtrArray *seek)
 {
@@ -1428,6 +1503,18 @@ file_seek(FILE_T file, gint64 offset, int whence, int *err)
             off = here->in;
             off2 = here->out;
         } else
+#endif
+#ifdef HAVE_ZSTD
+        if (here->compression == ZSTD) {
+            off = here->in;
+            off2 = here->out;
+        } else
+#endif
+#ifdef USE_LZ4
+        if (here->compression == LZ4) {
+            off = here->in;
+            off2 = here->out;
+        } else
 #endif
         {
             off2 = (file->pos + offset);
@@ -1480,6 +1567,22 @@ file_seek(FILE_T file, gint64 offset, int whence, int *err)
             strm->adler = crc32(0L, Z_NULL, 0);
             file->compression = ZLIB;
         } else
+#endif
+#ifdef HAVE_ZSTD
+        if (here->compression == ZSTD) {
+            if (zstd_reset(file) == -1) {
+                *err = file->err;
+                return -1;
+            }
+        } else
+#endif
+#ifdef USE_LZ4
+        if (here->compression == LZ4) {
+            if (lz4_reset(file) == -1) {
+                *err = file->err;
+                return -1;
+            }
+        } else
 #endif
             file->compression = here->compression;
 
@@ -1689,6 +1792,33 @@ file_read(void *buf, unsigned int len, FILE_T file)
                we're at the end of the input; just return
                with what we've gotten so far. */
             break;
+        } else if (file->compression == UNCOMPRESSED && buf != NULL &&
+                   len >= file->size) {
+            /* We have nothing in the output buffer, the file
+               isn't compressed, and we want at least a buffer's
+               worth of data; read it directly into the caller's
+               buffer rather than copying it through ours.
+
+               What's left in our buffer no longer precedes the
+               current position, so it can't be used to seek
+               backwards; discard it. */
+            ssize_t ret;
+
+            buf_reset(&file->out);
+
+            ret = ws_read(file->fd, buf, len);
+            if (ret < 0) {
+                file->err = errno;
+                file->err_info = NULL;
+                return -1;
+            }
+            if (ret == 0)
+                file->eof = TRUE;
+            file->raw_pos += ret;
+            buf = (char *)buf + ret;
+            len -= (guint)ret;
+            got += (guint)ret;
+            file->pos += ret;
         } else {
             /* We have nothing in the output buffer, and
                we can generate more data; get more output,
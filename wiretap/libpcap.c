@@ -1007,6 +1007,14 @@ libpcap_read_packet(wtap *wth, FILE_T fh, wtap_rec *rec,
 	rec->rec_header.packet_header.caplen = packet_size;
 	rec->rec_header.packet_header.len = orig_size;
 
+	/*
+	 * If the caller of wtap_read() doesn't want the packet data,
+	 * skip it; ERF needs it to work out the lengths.
+	 */
+	if (wth->skip_packet_data && fh == wth->fh &&
+	    wth->file_encap != WTAP_ENCAP_ERF)
+		return wtap_read_bytes(fh, NULL, packet_size, err, err_info);
+
 	/*
 	 * Read the packet data.
 	 */
@@ -211,21 +211,88 @@ merge_select_frame_type(const int file_type, int in_file_count, merge_in_file_t
 }
 
 /*
- * returns TRUE if first argument is earlier than second
+ * Binary min-heap of the input files that have a record available,
+ * ordered by the time stamp of that record, so that picking the file
+ * with the earliest record doesn't require looking at all of them.
+ */
+typedef struct {
+    guint   *files;     /* indices into the in_files array */
+    guint    count;     /* number of files in the heap */
+    gboolean primed;    /* TRUE once every file has been read from */
+} merge_heap_t;
+
+/*
+ * Returns TRUE if the record currently read from in_files[a] should be
+ * written before the one from in_files[b].
+ *
+ * Records with no time stamp are treated as earlier than all other records;
+ * yes, this means you won't get a chronological merge of those records,
+ * but you obviously *can't* get that.  Ties are broken the same way as
+ * the linear scan this replaced did, so the output is unchanged: records
+ * without a time stamp are taken from the lowest-numbered file first,
+ * and records with equal time stamps from the highest-numbered file first.
  */
 static gboolean
-is_earlier(nstime_t *l, nstime_t *r) /* XXX, move to nstime.c */
+merge_heap_is_earlier(const merge_in_file_t in_files[], guint a, guint b)
 {
-    if (l->secs > r->secs) {  /* left is later */
-        return FALSE;
-    } else if (l->secs < r->secs) { /* left is earlier */
-        return TRUE;
-    } else if (l->nsecs > r->nsecs) { /* tv_sec equal, l.usec later */
-        return FALSE;
+    const wtap_rec *rec_a = &in_files[a].rec;
+    const wtap_rec *rec_b = &in_files[b].rec;
+    gboolean a_has_ts = (rec_a->presence_flags & WTAP_HAS_TS) != 0;
+    gboolean b_has_ts = (rec_b->presence_flags & WTAP_HAS_TS) != 0;
+    int cmp;
+
+    if (!a_has_ts || !b_has_ts) {
+        if (a_has_ts != b_has_ts)
+            return !a_has_ts;
+        return a < b;
     }
-    /* either one < two or one == two
-     * either way, return one
-     */
+
+    cmp = nstime_cmp(&rec_a->ts, &rec_b->ts);
+    if (cmp != 0)
+        return cmp < 0;
+    return a > b;
+}
+
+static void
+merge_heap_sift_down(merge_heap_t *heap, const merge_in_file_t in_files[],
+                     guint pos)
+{
+    guint file = heap->files[pos];
+
+    for (;;) {
+        guint child = 2 * pos + 1;
+
+        if (child >= heap->count)
+            break;
+        if (child + 1 < heap->count &&
+            merge_heap_is_earlier(in_files, heap->files[child + 1], heap->files[child]))
+            child++;
+        if (!merge_heap_is_earlier(in_files, heap->files[child], file))
+            break;
+        heap->files[pos] = heap->files[child];
+        pos = child;
+    }
+    heap->files[pos] = file;
+}
+
+/*
+ * Read the next record from in_file, setting its state accordingly.
+ * Returns FALSE on a read error.
+ */
+static gboolean
+merge_read_next_record(merge_in_file_t *in_file, int *err, gchar **err_info)
+{
+    gint64 data_offset;
+
+    if (!wtap_read(in_file->wth, &in_file->rec, &in_file->frame_buffer,
+                   err, err_info, &data_offset)) {
+        if (*err != 0) {
+            in_file->state = GOT_ERROR;
+            return FALSE;
+        }
+        in_file->state = AT_EOF;
+    } else
+        in_file->state = RECORD_PRESENT;
     return TRUE;
 }
 
@@ -243,6 +310,7 @@ is_earlier(nstime_t *l, nstime_t *r) /* XXX, move to nstime.c */
  *
  * @param in_file_count number of entries in in_files
  * @param in_files input file array
+ * @param heap heap of input files, ordered by the time of their next record
  * @param err wiretap error, if failed
  * @param err_info wiretap error string, if failed
  * @return pointer to merge_in_file_t for file from which that packet
@@ -250,68 +318,52 @@ is_earlier(nstime_t *l, nstime_t *r) /* XXX, move to nstime.c */
  * all files
  */
 static merge_in_file_t *
-merge_read_packet(int in_file_count, merge_in_file_t in_files[],
-                  int *err, gchar **err_info)
+merge_read_packet(guint in_file_count, merge_in_file_t in_files[],
+                  merge_heap_t *heap, int *err, gchar **err_info)
 {
-    int i;
-    int ei = -1;
-    nstime_t tv = NSTIME_INIT_MAX;
-    wtap_rec *rec;
-
-    /*
-     * Make sure we have a record available from each file that's not at
-     * EOF, and search for the record with the earliest time stamp or
-     * with no time stamp (those records are treated as earlier than
-     * all other records).  Yes, this means you won't get a chronological
-     * merge of those records, but you obviously *can't* get that.
-     */
-    for (i = 0; i < in_file_count; i++) {
-        gint64 data_offset;
+    guint i;
+    guint ei;
 
-        if (in_files[i].state == RECORD_NOT_PRESENT) {
-            /*
-             * No packet available, and we haven't seen an error or EOF yet,
-             * so try to read the next packet.
-             */
-            if (!wtap_read(in_files[i].wth, &in_files[i].rec,
-                           &in_files[i].frame_buffer, err, err_info,
-                           &data_offset)) {
-                if (*err != 0) {
-                    in_files[i].state = GOT_ERROR;
+    if (!heap->primed) {
+        /*
+         * Get a record from each file that's not at EOF, and put
+         * the files into heap order.
+         */
+        for (i = 0; i < in_file_count; i++) {
+            if (in_files[i].state == RECORD_NOT_PRESENT) {
+                if (!merge_read_next_record(&in_files[i], err, err_info))
                     return &in_files[i];
-                }
-                in_files[i].state = AT_EOF;
-            } else
-                in_files[i].state = RECORD_PRESENT;
-        }
-
-        if (in_files[i].state == RECORD_PRESENT) {
-            rec = &in_files[i].rec;
-            if (!(rec->presence_flags & WTAP_HAS_TS)) {
-                /*
-                 * No time stamp.  Pick this record, and stop looking.
-                 */
-                ei = i;
-                break;
-            }
-            if (is_earlier(&rec->ts, &tv)) {
-                /*
-                 * This record's time stamp is earlier than any of the
-                 * records we've seen so far.  Pick it, for now, but
-                 * keep looking.
-                 */
-                tv = rec->ts;
-                ei = i;
             }
+            if (in_files[i].state == RECORD_PRESENT)
+                heap->files[heap->count++] = i;
         }
+        for (i = heap->count / 2; i > 0; i--)
+            merge_heap_sift_down(heap, in_files, i - 1);
+        heap->primed = TRUE;
+    } else if (heap->count > 0 &&
+               in_files[heap->files[0]].state == RECORD_NOT_PRESENT) {
+        /*
+         * The file at the top of the heap is the one we returned the
+         * last record from; replace that record with the file's next
+         * one, and move the file to where it now belongs.
+         */
+        ei = heap->files[0];
+        if (!merge_read_next_record(&in_files[ei], err, err_info))
+            return &in_files[ei];
+        if (in_files[ei].state == AT_EOF)
+            heap->files[0] = heap->files[--heap->count];
+        if (heap->count > 0)
+            merge_heap_sift_down(heap, in_files, 0);
     }
 
-    if (ei == -1) {
+    if (heap->count == 0) {
         /* All the streams are at EOF.  Return an EOF indication. */
         *err = 0;
         return NULL;
     }
 
+    ei = heap->files[0];
+
     /* We'll need to read another packet from this file. */
     in_files[ei].state = RECORD_NOT_PRESENT;
 
@@ -340,6 +392,8 @@ merge_read_packet(int in_file_count, merge_in_file_t in_files[],
  *
  * @param in_file_count number of entries in in_files
  * @param in_files input file array
+ * @param current_file index of the file we're currently reading from,
+ * updated as files reach EOF
  * @param err wiretap error, if failed
  * @param err_info wiretap error string, if failed
  * @return pointer to merge_in_file_t for file from which that packet
@@ -348,15 +402,16 @@ merge_read_packet(int in_file_count, merge_in_file_t in_files[],
  */
 static merge_in_file_t *
 merge_append_read_packet(int in_file_count, merge_in_file_t in_files[],
-                         int *err, gchar **err_info)
+                         int *current_file, int *err, gchar **err_info)
 {
     int i;
     gint64 data_offset;
 
     /*
      * Find the first file not at EOF, and read the next packet from it.
+     * All the files before *current_file are known to be at EOF.
      */
-    for (i = 0; i < in_file_count; i++) {
+    for (i = *current_file; i < in_file_count; i++) {
         if (in_files[i].state == AT_EOF)
             continue; /* This file is already at EOF */
         if (wtap_read(in_files[i].wth, &in_files[i].rec,
@@ -371,6 +426,7 @@ merge_append_read_packet(int in_file_count, merge_in_file_t in_files[],
         /* EOF - flag this file as being at EOF, and try the next one. */
         in_files[i].state = AT_EOF;
     }
+    *current_file = i;
     if (i == in_file_count) {
         /* All the streams are at EOF.  Return an EOF indication. */
         *err = 0;
@@ -750,15 +806,19 @@ add_idb_to_merged_file(wtapng_iface_descriptions_t *merged_idb_list,
 /*
  * Create clone IDBs for the merge file for IDBs found in the middle of
  * input files while processing.
+ *
+ * Only in_files[first_file] through in_files[last_file] are checked; the
+ * caller passes the range of files read from since the last call, as only
+ * those can have new IDBs and there can be hundreds of input files.
  */
 static gboolean
-process_new_idbs(wtap_dumper *pdh, merge_in_file_t *in_files, const guint in_file_count, const idb_merge_mode mode, wtapng_iface_descriptions_t *merged_idb_list, int *err, gchar **err_info)
+process_new_idbs(wtap_dumper *pdh, merge_in_file_t *in_files, const guint first_file, const guint last_file, const idb_merge_mode mode, wtapng_iface_descriptions_t *merged_idb_list, int *err, gchar **err_info)
 {
     wtap_block_t                 input_file_idb;
     guint                        itf_count, merged_index;
     guint                        i;
 
-    for (i = 0; i < in_file_count; i++) {
+    for (i = first_file; i <= last_file; i++) {
 
         itf_count = in_files[i].wth->next_interface_data;
         while ((input_file_idb = wtap_get_next_interface_description(in_files[i].wth)) != NULL) {
@@ -923,19 +983,26 @@ merge_process_packets(wtap_dumper *pdh, const int file_type,
 {
     merge_result        status = MERGE_OK;
     merge_in_file_t    *in_file;
+    merge_in_file_t    *prev_in_file = NULL;
+    int                 append_file = 0;
+    guint               idb_first, idb_last;
     int                 count = 0;
     gboolean            stop_flag = FALSE;
     wtap_rec *rec,      snap_rec;
+    merge_heap_t        heap = { NULL, 0, FALSE };
+
+    if (!do_append)
+        heap.files = g_new(guint, in_file_count);
 
     for (;;) {
         *err = 0;
 
         if (do_append) {
-            in_file = merge_append_read_packet(in_file_count, in_files, err,
-                                               err_info);
+            in_file = merge_append_read_packet(in_file_count, in_files,
+                                               &append_file, err, err_info);
         }
         else {
-            in_file = merge_read_packet(in_file_count, in_files, err,
+            in_file = merge_read_packet(in_file_count, in_files, &heap, err,
                                         err_info);
         }
 
@@ -964,11 +1031,27 @@ merge_process_packets(wtap_dumper *pdh, const int file_type,
 
         if (wtap_file_type_subtype_supports_block(file_type,
                                                   WTAP_BLOCK_IF_ID_AND_INFO) != BLOCK_NOT_SUPPORTED) {
-            if (!process_new_idbs(pdh, in_files, in_file_count, mode, idb_inf, err, err_info)) {
+            /*
+             * Before the first record, every file has been read from.
+             * After that, when appending we've read from the previous
+             * file up to (if it hit EOF) this one; when merging we've
+             * only read the next record from the previous file.
+             */
+            if (prev_in_file == NULL) {
+                idb_first = 0;
+                idb_last = in_file_count - 1;
+            } else if (do_append) {
+                idb_first = (guint)(prev_in_file - in_files);
+                idb_last = (guint)(in_file - in_files);
+            } else {
+                idb_first = idb_last = (guint)(prev_in_file - in_files);
+            }
+            if (!process_new_idbs(pdh, in_files, idb_first, idb_last, mode, idb_inf, err, err_info)) {
                 status = MERGE_ERR_CANT_WRITE_OUTFILE;
                 break;
             }
         }
+        prev_in_file = in_file;
 
         switch (rec->rec_type) {
 
@@ -1042,6 +1125,8 @@ merge_process_packets(wtap_dumper *pdh, const int file_type,
         wtap_rec_reset(rec);
     }
 
+    g_free(heap.files);
+
     if (cb)
         cb->callback_func(MERGE_EVENT_DONE, count, in_files, in_file_count, cb->data);
 
@@ -1049,7 +1134,8 @@ merge_process_packets(wtap_dumper *pdh, const int file_type,
         /* Check for IDBs, NRBs, or DSBs read after the last packet records. */
         if (wtap_file_type_subtype_supports_block(file_type,
                                                   WTAP_BLOCK_IF_ID_AND_INFO) != BLOCK_NOT_SUPPORTED) {
-            if (!process_new_idbs(pdh, in_files, in_file_count, mode, idb_inf, err, err_info)) {
+            if (in_file_count > 0 &&
+                !process_new_idbs(pdh, in_files, 0, in_file_count - 1, mode, idb_inf, err, err_info)) {
                 status = MERGE_ERR_CANT_WRITE_OUTFILE;
             }
         }
@@ -968,7 +968,9 @@ pcapng_process_options(FILE_T fh, wtapng_block_t *wblock,
                        pcapng_opt_byte_order_e byte_order,
                        int *err, gchar **err_info)
 {
-    guint8 *option_content; /* Allocate as large as the options block */
+    guint32 option_stack_buf[64];   /* Options of most packet blocks fit here */
+    guint8 *option_alloc = NULL;    /* Allocated if they don't */
+    guint8 *option_content; /* As large as the options block */
     guint opt_bytes_remaining;
     const guint8 *option_ptr;
     const pcapng_option_header_t *oh;
@@ -981,24 +983,34 @@ pcapng_process_options(FILE_T fh, wtapng_block_t *wblock,
         return TRUE;
     }
 
-    /* Allocate enough memory to hold all options */
-    option_content = (guint8 *)g_try_malloc(opt_cont_buf_len);
-    if (option_content == NULL) {
-        *err = ENOMEM;  /* we assume we're out of memory */
-        return FALSE;
+    /*
+     * Use the buffer on the stack if the options fit, as this is done
+     * for every packet block that has options; otherwise allocate
+     * enough memory to hold all options.
+     */
+    if (opt_cont_buf_len <= sizeof option_stack_buf) {
+        option_content = (guint8 *)option_stack_buf;
+    } else {
+        option_alloc = (guint8 *)g_try_malloc(opt_cont_buf_len);
+        if (option_alloc == NULL) {
+            *err = ENOMEM;  /* we assume we're out of memory */
+            return FALSE;
+        }
+        option_content = option_alloc;
     }
 
     /* Read all the options into the buffer */
     if (!wtap_read_bytes(fh, option_content, opt_cont_buf_len, err, err_info)) {
         ws_debug("failed to read options");
-        g_free(option_content);
+        g_free(option_alloc);
         return FALSE;
     }
 
     /*
      * Now process them.
      * option_ptr starts out aligned on at least a 4-byte boundary, as
-     * that's what g_try_malloc() gives us, and each option is padded
+     * that's what both g_try_malloc() and the guint32 array on the
+     * stack give us, and each option is padded
      * to a length that's a multiple of 4 bytes, so it remains aligned.
      */
     option_ptr = &option_content[0];
@@ -1010,7 +1022,7 @@ pcapng_process_options(FILE_T fh, wtapng_block_t *wblock,
         if (sizeof (*oh) > opt_bytes_remaining) {
             *err = WTAP_ERR_BAD_FILE;
             *err_info = ws_strdup_printf("pcapng: Not enough data for option header");
-            g_free(option_content);
+            g_free(option_alloc);
             return FALSE;
         }
         option_code = oh->option_code;
@@ -1052,7 +1064,7 @@ pcapng_process_options(FILE_T fh, wtapng_block_t *wblock,
             *err = WTAP_ERR_BAD_FILE;
             *err_info = ws_strdup_printf("pcapng: Not enough data to handle option of length %u",
                                         option_length);
-            g_free(option_content);
+            g_free(option_alloc);
             return FALSE;
         }
 
@@ -1077,7 +1089,7 @@ pcapng_process_options(FILE_T fh, wtapng_block_t *wblock,
                                                   option_ptr,
                                                   byte_order,
                                                   err, err_info)) {
-                    g_free(option_content);
+                    g_free(option_alloc);
                     return FALSE;
                 }
                 break;
@@ -1087,14 +1099,14 @@ pcapng_process_options(FILE_T fh, wtapng_block_t *wblock,
                     !(*process_option)(wblock, (const section_info_t *)section_info, option_code,
                                        option_length, option_ptr,
                                        err, err_info)) {
-                    g_free(option_content);
+                    g_free(option_alloc);
                     return FALSE;
                 }
         }
         option_ptr += rounded_option_length; /* multiple of 4 bytes, so it remains aligned */
         opt_bytes_remaining -= rounded_option_length;
     }
-    g_free(option_content);
+    g_free(option_alloc);
     return TRUE;
 }
 
@@ -1904,6 +1916,7 @@ pcapng_read_packet_block(FILE_T fh, pcapng_block_header_t *bh,
     guint64 ts;
     int pseudo_header_len;
     int fcslen;
+    gboolean skip_data;
 
     wblock->block = wtap_block_create(WTAP_BLOCK_PACKET);
 
@@ -2071,9 +2084,15 @@ pcapng_read_packet_block(FILE_T fh, pcapng_block_header_t *bh,
     wblock->rec->ts.secs = (time_t)(ts / iface_info.time_units_per_second);
     wblock->rec->ts.nsecs = (int)(((ts % iface_info.time_units_per_second) * 1000000000) / iface_info.time_units_per_second);
 
-    /* "(Enhanced) Packet Block" read capture data */
-    if (!wtap_read_packet_bytes(fh, wblock->frame_buffer,
-                                packet.cap_len - pseudo_header_len, err, err_info))
+    /* "(Enhanced) Packet Block" read capture data, unless it's not
+       wanted; ERF needs it to work out the lengths */
+    skip_data = wblock->skip_packet_data && iface_info.wtap_encap != WTAP_ENCAP_ERF;
+    if (skip_data) {
+        if (!wtap_read_bytes(fh, NULL, packet.cap_len - pseudo_header_len,
+                             err, err_info))
+            return FALSE;
+    } else if (!wtap_read_packet_bytes(fh, wblock->frame_buffer,
+                                       packet.cap_len - pseudo_header_len, err, err_info))
         return FALSE;
     block_read += packet.cap_len - pseudo_header_len;
 
@@ -2113,9 +2132,11 @@ pcapng_read_packet_block(FILE_T fh, pcapng_block_header_t *bh,
         wtap_block_add_uint64_option(wblock->block, OPT_PKT_DROPCOUNT, (guint64)packet.drops_count);
     }
 
-    pcap_read_post_process(FALSE, iface_info.wtap_encap,
-                           wblock->rec, ws_buffer_start_ptr(wblock->frame_buffer),
-                           section_info->byte_swapped, fcslen);
+    if (!skip_data) {
+        pcap_read_post_process(FALSE, iface_info.wtap_encap,
+                               wblock->rec, ws_buffer_start_ptr(wblock->frame_buffer),
+                               section_info->byte_swapped, fcslen);
+    }
 
     /*
      * We return these to the caller in pcapng_read().
@@ -2146,6 +2167,7 @@ pcapng_read_simple_packet_block(FILE_T fh, pcapng_block_header_t *bh,
     wtapng_simple_packet_t simple_packet;
     guint32 padding;
     int pseudo_header_len;
+    gboolean skip_data;
 
     /*
      * Is this block long enough to be an SPB?
@@ -2252,9 +2274,14 @@ pcapng_read_simple_packet_block(FILE_T fh, pcapng_block_header_t *bh,
 
     memset((void *)&wblock->rec->rec_header.packet_header.pseudo_header, 0, sizeof(union wtap_pseudo_header));
 
-    /* "Simple Packet Block" read capture data */
-    if (!wtap_read_packet_bytes(fh, wblock->frame_buffer,
-                                simple_packet.cap_len, err, err_info))
+    /* "Simple Packet Block" read capture data, unless it's not
+       wanted; ERF needs it to work out the lengths */
+    skip_data = wblock->skip_packet_data && iface_info.wtap_encap != WTAP_ENCAP_ERF;
+    if (skip_data) {
+        if (!wtap_read_bytes(fh, NULL, simple_packet.cap_len, err, err_info))
+            return FALSE;
+    } else if (!wtap_read_packet_bytes(fh, wblock->frame_buffer,
+                                       simple_packet.cap_len, err, err_info))
         return FALSE;
 
     /* jump over potential padding bytes at end of the packet data */
@@ -2263,9 +2290,11 @@ pcapng_read_simple_packet_block(FILE_T fh, pcapng_block_header_t *bh,
             return FALSE;
     }
 
-    pcap_read_post_process(FALSE, iface_info.wtap_encap,
-                           wblock->rec, ws_buffer_start_ptr(wblock->frame_buffer),
-                           section_info->byte_swapped, iface_info.fcslen);
+    if (!skip_data) {
+        pcap_read_post_process(FALSE, iface_info.wtap_encap,
+                               wblock->rec, ws_buffer_start_ptr(wblock->frame_buffer),
+                               section_info->byte_swapped, iface_info.fcslen);
+    }
 
     /*
      * We return these to the caller in pcapng_read().
@@ -3615,6 +3644,7 @@ pcapng_open(wtap *wth, int *err, gchar **err_info)
     /* we don't expect any packet blocks yet */
     wblock.frame_buffer = NULL;
     wblock.rec = NULL;
+    wblock.skip_packet_data = FALSE;
 
     switch (pcapng_read_section_header_block(wth->fh, &bh, &first_section,
                                              &wblock, err, err_info)) {
@@ -3798,6 +3828,7 @@ pcapng_read(wtap *wth, wtap_rec *rec, Buffer *buf, int *err,
 
     wblock.frame_buffer  = buf;
     wblock.rec = rec;
+    wblock.skip_packet_data = wth->skip_packet_data;
 
     /* read next block */
     while (1) {
@@ -3896,6 +3927,7 @@ pcapng_seek_read(wtap *wth, gint64 seek_off,
 
     wblock.frame_buffer = buf;
     wblock.rec = rec;
+    wblock.skip_packet_data = FALSE;
 
     /* read the block */
     if (!pcapng_read_block(wth, wth->random_fh, pcapng, section_info,
@@ -4920,6 +4952,8 @@ pcapng_write_enhanced_packet_block(wtap_dumper *wdh, const wtap_rec *rec,
     const union wtap_pseudo_header *pseudo_header = &rec->rec_header.packet_header.pseudo_header;
     pcapng_block_header_t bh;
     pcapng_enhanced_packet_block_t epb;
+    guint8 block_head[sizeof(pcapng_block_header_t) + sizeof(pcapng_enhanced_packet_block_t)];
+    guint8 block_tail[3 + sizeof(guint32)];
     guint32 options_size = 0;
     guint64 ts;
     const guint32 zero_pad = 0;
@@ -5008,9 +5042,6 @@ pcapng_write_enhanced_packet_block(wtap_dumper *wdh, const wtap_rec *rec,
     bh.block_type = BLOCK_TYPE_EPB;
     bh.block_total_length = (guint32)sizeof(bh) + (guint32)sizeof(epb) + phdr_len + rec->rec_header.packet_header.caplen + pad_len + options_total_length + options_size + 4;
 
-    if (!wtap_dump_file_write(wdh, &bh, sizeof bh, err))
-        return FALSE;
-
     /* write block fixed content */
     /*
      * Split the 64-bit timestamp into two 32-bit pieces, using
@@ -5023,7 +5054,13 @@ pcapng_write_enhanced_packet_block(wtap_dumper *wdh, const wtap_rec *rec,
     epb.captured_len        = rec->rec_header.packet_header.caplen + phdr_len;
     epb.packet_len          = rec->rec_header.packet_header.len + phdr_len;
 
-    if (!wtap_dump_file_write(wdh, &epb, sizeof epb, err))
+    /*
+     * This is the block written for nearly every packet, so hand the
+     * block header and the fixed content to the file in one go.
+     */
+    memcpy(block_head, &bh, sizeof bh);
+    memcpy(block_head + sizeof bh, &epb, sizeof epb);
+    if (!wtap_dump_file_write(wdh, block_head, sizeof block_head, err))
         return FALSE;
 
     /* write pseudo header */
@@ -5035,17 +5072,22 @@ pcapng_write_enhanced_packet_block(wtap_dumper *wdh, const wtap_rec *rec,
     if (!wtap_dump_file_write(wdh, pd, rec->rec_header.packet_header.caplen, err))
         return FALSE;
 
+    /* Without options, the padding and the footer are adjacent */
+    if (options_size == 0) {
+        memset(block_tail, 0, pad_len);
+        memcpy(block_tail + pad_len, &bh.block_total_length, sizeof bh.block_total_length);
+        return wtap_dump_file_write(wdh, block_tail, pad_len + sizeof bh.block_total_length, err);
+    }
+
     /* write padding (if any) */
     if (pad_len != 0) {
         if (!wtap_dump_file_write(wdh, &zero_pad, pad_len, err))
             return FALSE;
     }
 
-    /* Write options, if we have any */
-    if (options_size != 0) {
-        if (!write_options(wdh, rec->block, write_wtap_epb_option, err))
-            return FALSE;
-    }
+    /* Write options */
+    if (!write_options(wdh, rec->block, write_wtap_epb_option, err))
+        return FALSE;
 
     /* write block footer */
     if (!wtap_dump_file_write(wdh, &bh.block_total_length,
@@ -52,6 +52,7 @@ typedef struct wtapng_block_s {
     wtap_block_t block;
     wtap_rec     *rec;
     Buffer       *frame_buffer;
+    gboolean     skip_packet_data; /* TRUE to skip, rather than read, packet data */
 } wtapng_block_t;
 
 /* Section data in private struct */
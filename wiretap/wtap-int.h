@@ -74,6 +74,7 @@ struct wtap {
     wtap_new_ipv6_callback_t    add_new_ipv6;
     wtap_new_secrets_callback_t add_new_secrets;
     GPtrArray                   *fast_seek;
+    gboolean                    skip_packet_data;       /**< TRUE if wtap_read() callers don't want packet data; see wtap_set_skip_packet_data() */
 };
 
 struct wtap_dumper;
@@ -1447,6 +1447,13 @@ wtap_strerror(int err)
 		return g_strerror(err);
 }
 
+void
+wtap_set_random_read_sequential(wtap *wth, gboolean sequential)
+{
+	if (wth->random_fh != NULL)
+		file_set_readahead(wth->random_fh, sequential);
+}
+
 /* Close only the sequential side, freeing up memory it uses.
 
    Note that we do *not* want to call the subtype's close function,
@@ -1612,6 +1619,12 @@ void wtap_set_cb_new_secrets(wtap *wth, wtap_new_secrets_callback_t add_new_secr
 	}
 }
 
+void
+wtap_set_skip_packet_data(wtap *wth, gboolean skip)
+{
+	wth->skip_packet_data = skip;
+}
+
 void
 wtapng_process_dsb(wtap *wth, wtap_block_t dsb)
 {
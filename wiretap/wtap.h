@@ -1785,6 +1785,21 @@ typedef void (*wtap_new_secrets_callback_t)(guint32 secrets_type, const void *se
 WS_DLL_PUBLIC
 void wtap_set_cb_new_secrets(wtap *wth, wtap_new_secrets_callback_t add_new_secrets);
 
+/** Tell wtap_read() whether the caller wants the packet data.
+ *
+ * If skip is TRUE, readers that support it skip over the data of packet
+ * records rather than reading it into the buffer, which is left empty;
+ * the wtap_rec, including the captured length and time stamp, is still
+ * filled in.  This is for programs such as capinfos that only look at
+ * record headers.  The pcap and pcapng readers support this; others
+ * keep reading the data.  wtap_seek_read() always reads the data.
+ *
+ * @param wth a wtap * returned by a call that opened a file for reading.
+ * @param skip TRUE to skip the packet data, FALSE to read it.
+ */
+WS_DLL_PUBLIC
+void wtap_set_skip_packet_data(wtap *wth, gboolean skip);
+
 /** Read the next record in the file, filling in *phdr and *buf.
  *
  * @wth a wtap * returned by a call that opened a file for reading.
@@ -1989,6 +2004,13 @@ void wtap_fdclose(wtap *wth);
 WS_DLL_PUBLIC
 gboolean wtap_fdreopen(wtap *wth, const char *filename, int *err);
 
+/** Hint that records will, until further notice, be read from the random
+ *  side in increasing file offset order, as when saving or printing a
+ *  range of frames, so that the OS can read ahead; or, with sequential
+ *  FALSE, that they no longer will be. */
+WS_DLL_PUBLIC
+void wtap_set_random_read_sequential(wtap *wth, gboolean sequential);
+
 /** Close only the sequential side, freeing up memory it uses. */
 WS_DLL_PUBLIC
 void wtap_sequential_close(wtap *wth);
@@ -638,6 +638,8 @@ pcapng_write_interface_statistics_block(FILE* pfile,
                                         guint64 isb_endtime,   /* ISB_ENDTIME           3 */
                                         guint64 isb_ifrecv,    /* ISB_IFRECV            4 */
                                         guint64 isb_ifdrop,    /* ISB_IFDROP            5 */
+                                        guint64 isb_osdrop,    /* ISB_OSDROP            7 */
+                                        guint64 isb_usrdeliv,  /* ISB_USRDELIV          8 */
                                         int *err)
 {
         struct isb isb;
@@ -700,6 +702,14 @@ pcapng_write_interface_statistics_block(FILE* pfile,
                 options_length += (guint32)(sizeof(struct ws_option) +
                                             sizeof(guint64));
         }
+        if (isb_osdrop != G_MAXUINT64) {
+                options_length += (guint32)(sizeof(struct ws_option) +
+                                            sizeof(guint64));
+        }
+        if (isb_usrdeliv != G_MAXUINT64) {
+                options_length += (guint32)(sizeof(struct ws_option) +
+                                            sizeof(guint64));
+        }
         /* OPT_COMMENT */
         options_length += pcapng_count_string_option(comment);
         if (isb_starttime !=0) {
@@ -779,6 +789,24 @@ pcapng_write_interface_statistics_block(FILE* pfile,
                 if (!write_to_file(pfile, (const guint8*)&isb_ifdrop, sizeof(guint64), bytes_written, err))
                         return FALSE;
         }
+        if (isb_osdrop != G_MAXUINT64) {
+                option.type = ISB_OSDROP;
+                option.value_length = sizeof(guint64);
+                if (!write_to_file(pfile, (const guint8*)&option, sizeof(struct ws_option), bytes_written, err))
+                        return FALSE;
+
+                if (!write_to_file(pfile, (const guint8*)&isb_osdrop, sizeof(guint64), bytes_written, err))
+                        return FALSE;
+        }
+        if (isb_usrdeliv != G_MAXUINT64) {
+                option.type = ISB_USRDELIV;
+                option.value_length = sizeof(guint64);
+                if (!write_to_file(pfile, (const guint8*)&option, sizeof(struct ws_option), bytes_written, err))
+                        return FALSE;
+
+                if (!write_to_file(pfile, (const guint8*)&isb_usrdeliv, sizeof(guint64), bytes_written, err))
+                        return FALSE;
+        }
         if (options_length != 0) {
                 /* write end of options */
                 option.type = OPT_ENDOFOPT;
@@ -86,6 +86,8 @@ pcapng_write_interface_statistics_block(FILE* pfile,
                                         guint64 isb_endtime,   /* ISB_ENDTIME           3 */
                                         guint64 isb_ifrecv,    /* ISB_IFRECV            4 */
                                         guint64 isb_ifdrop,    /* ISB_IFDROP            5 */
+                                        guint64 isb_osdrop,    /* ISB_OSDROP            7 */
+                                        guint64 isb_usrdeliv,  /* ISB_USRDELIV          8 */
                                         int *err);
 
 extern gboolean
@@ -66,8 +66,8 @@ ws_buffer_assure_space(Buffer* buffer, gsize space)
 {
 	ws_assert(buffer);
 	gsize available_at_end = buffer->allocated - buffer->first_free;
-	gsize space_used;
-	gboolean space_at_beginning;
+	gsize space_used = buffer->first_free - buffer->start;
+	gsize needed;
 
 	/* If we've got the space already, good! */
 	if (space <= available_at_end) {
@@ -78,25 +78,28 @@ ws_buffer_assure_space(Buffer* buffer, gsize space)
 		if we moved the used space back to the beginning of the
 		allocation. The buffer could have become fragmented through lots
 		of calls to ws_buffer_remove_start(). I'm using buffer->start as the
-		same as 'available_at_start' in this comparison. */
+		same as 'available_at_start' in this comparison.
 
-	/* or maybe there's just no more room. */
+		Only do that if the data to move is no more than what has been
+		consumed from the front, so a buffer used as a queue copies each
+		byte a bounded number of times; otherwise grow it instead. Once
+		the allocation is twice the amount of data kept in it, the
+		buffer stops growing. */
 
-	space_at_beginning = buffer->start >= space;
-	if (space_at_beginning || buffer->start > 0) {
-		space_used = buffer->first_free - buffer->start;
+	if (buffer->start > 0 && buffer->start >= space_used) {
 		/* this memory copy better be safe for overlapping memory regions! */
 		memmove(buffer->data, buffer->data + buffer->start, space_used);
 		buffer->start = 0;
 		buffer->first_free = space_used;
-	}
-	/*if (buffer->start >= space) {*/
-	if (space_at_beginning) {
-		return;
+		if (space <= buffer->allocated - buffer->first_free) {
+			return;
+		}
 	}
 
-	/* We'll allocate more space */
-	buffer->allocated += space + 1024;
+	/* We'll allocate more space. Grow geometrically, so that a buffer
+		that is appended to repeatedly is reallocated O(log n) times. */
+	needed = buffer->first_free + space + 1024;
+	buffer->allocated = MAX(buffer->allocated * 2, needed);
 	buffer->data = (guint8*)g_realloc(buffer->data, buffer->allocated);
 }
 
@@ -17,6 +17,7 @@
 
 #include <glib.h>
 #include <wsutil/crc32.h>
+#include "crc32_int.h"
 
 #define CRC32_ACCUMULATE(c,d,table) (c=(c>>8)^(table)[(c^(d))&0xFF])
 
@@ -368,18 +369,27 @@ crc32_ccitt_table_lookup (guchar pos)
 guint32
 crc32c_calculate(const void *buf, int len, guint32 crc)
 {
-	const guint8 *p = (const guint8 *)buf;
-	crc = CRC32C_SWAP(crc);
-	while (len-- > 0) {
-		CRC32C(crc, *p++);
-	}
+	crc = crc32c_calculate_no_swap(buf, len, CRC32C_SWAP(crc));
 	return CRC32C_SWAP(crc);
 }
 
+#ifdef HAVE_SSE4_2
+/* -1 until we've checked whether the CPU has the CRC32 instruction */
+static int crc32c_use_sse42 = -1;
+#endif
+
 guint32
 crc32c_calculate_no_swap(const void *buf, int len, guint32 crc)
 {
 	const guint8 *p = (const guint8 *)buf;
+
+#ifdef HAVE_SSE4_2
+	if (crc32c_use_sse42 == -1)
+		crc32c_use_sse42 = crc32c_sse42_supported() ? 1 : 0;
+	if (crc32c_use_sse42)
+		return crc32c_sse42_calculate_no_swap(buf, len, crc);
+#endif
+
 	while (len-- > 0) {
 		CRC32C(crc, *p++);
 	}
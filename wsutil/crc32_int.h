@@ -0,0 +1,20 @@
+/** @file
+ *
+ * Internal declarations for the CRC-32 routines
+ *
+ * Wireshark - Network traffic analyzer
+ * By Gerald Combs <gerald@wireshark.org>
+ * Copyright 1998 Gerald Combs
+ *
+ * SPDX-License-Identifier: GPL-2.0-or-later
+ */
+
+#ifndef __CRC32_INT_H__
+#define __CRC32_INT_H__
+
+#ifdef HAVE_SSE4_2
+gboolean crc32c_sse42_supported(void);
+guint32 crc32c_sse42_calculate_no_swap(const void *buf, int len, guint32 crc);
+#endif
+
+#endif /* __CRC32_INT_H__ */
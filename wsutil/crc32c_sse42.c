@@ -0,0 +1,77 @@
+/* crc32c_sse42.c
+ * CRC-32C using the SSE 4.2 CRC32 instruction
+ *
+ * Wireshark - Network traffic analyzer
+ * By Gerald Combs <gerald@wireshark.org>
+ * Copyright 1998 Gerald Combs
+ *
+ * SPDX-License-Identifier: GPL-2.0-or-later
+ */
+
+#include "config.h"
+
+#ifdef HAVE_SSE4_2
+
+#include <glib.h>
+#include "ws_cpuid.h"
+
+#include <nmmintrin.h>
+#include <string.h>
+#include "crc32_int.h"
+
+gboolean
+crc32c_sse42_supported(void)
+{
+	return ws_cpuid_sse42() ? TRUE : FALSE;
+}
+
+/*
+ * The CRC32 instruction computes the reflected CRC-32C, i.e. the same
+ * value as the table-driven crc32c_calculate_no_swap().
+ */
+guint32
+crc32c_sse42_calculate_no_swap(const void *buf, int len, guint32 crc)
+{
+	const guint8 *p = (const guint8 *)buf;
+
+#if defined(__x86_64__) || defined(_M_X64)
+	guint64 crc64 = crc;
+	guint64 v64;
+
+	while (len >= 8) {
+		memcpy(&v64, p, sizeof v64);
+		crc64 = _mm_crc32_u64(crc64, v64);
+		p += 8;
+		len -= 8;
+	}
+	crc = (guint32)crc64;
+#endif
+	while (len >= 4) {
+		guint32 v32;
+
+		memcpy(&v32, p, sizeof v32);
+		crc = _mm_crc32_u32(crc, v32);
+		p += 4;
+		len -= 4;
+	}
+	while (len-- > 0) {
+		crc = _mm_crc32_u8(crc, *p++);
+	}
+
+	return crc;
+}
+
+#endif /* HAVE_SSE4_2 */
+
+/*
+ * Editor modelines  -  https://www.wireshark.org/tools/modelines.html
+ *
+ * Local variables:
+ * c-basic-offset: 8
+ * tab-width: 8
+ * indent-tabs-mode: t
+ * End:
+ *
+ * vi: set shiftwidth=8 tabstop=8 noexpandtab:
+ * :indentSize=8:tabSize=8:noTabs=false:
+ */
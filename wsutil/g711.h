@@ -12,6 +12,8 @@
 #ifndef __G711_H__
 #define __G711_H__
 
+#include <stddef.h>
+
 #include "ws_symbol_export.h"
 
 #ifdef __cplusplus
@@ -23,6 +25,10 @@ WS_DLL_PUBLIC int alaw2linear( unsigned char );
 WS_DLL_PUBLIC unsigned char linear2ulaw( int );
 WS_DLL_PUBLIC int ulaw2linear( unsigned char );
 
+/* Convert a buffer of count A-law or u-law values using lookup tables. */
+WS_DLL_PUBLIC void alaw2linear_block( const unsigned char *, short *, size_t );
+WS_DLL_PUBLIC void ulaw2linear_block( const unsigned char *, short *, size_t );
+
 #ifdef __cplusplus
 }
 #endif /* __cplusplus */
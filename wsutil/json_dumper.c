@@ -123,24 +123,43 @@ json_puts_string(const json_dumper *dumper, const char *str, gboolean dot_to_und
         "u0010", "u0011", "u0012", "u0013", "u0014", "u0015", "u0016", "u0017", "u0018", "u0019", "u001a", "u001b", "u001c", "u001d", "u001e", "u001f"
     };
 
+    /* Write runs of characters that don't need escaping with a single
+     * call, rather than one character at a time. */
+    const char *run = str;
+    const char *p;
+
     jd_putc(dumper, '"');
-    for (int i = 0; str[i]; i++) {
-        if ((guint)str[i] < 0x20) {
+    for (p = str; *p; p++) {
+        guchar c = (guchar)*p;
+
+        if (c >= 0x20 && c != '\\' && c != '"' && c != '/' && c != '.') {
+            continue;
+        }
+        if ((c == '/' && (p == str || p[-1] != '<')) || (c == '.' && !dot_to_underscore)) {
+            continue;
+        }
+
+        if (p > run) {
+            jd_puts_len(dumper, run, p - run);
+        }
+        run = p + 1;
+
+        if (c < 0x20) {
             jd_putc(dumper, '\\');
-            jd_puts(dumper, json_cntrl[(guint)str[i]]);
-        } else if (i > 0 && str[i - 1] == '<' && str[i] == '/') {
+            jd_puts(dumper, json_cntrl[c]);
+        } else if (c == '/') {
             // Convert </script> to <\/script> to avoid breaking web pages.
             jd_puts(dumper, "\\/");
+        } else if (c == '.') {
+            jd_putc(dumper, '_');
         } else {
-            if (str[i] == '\\' || str[i] == '"') {
-                jd_putc(dumper, '\\');
-            }
-            if (dot_to_underscore && str[i] == '.')
-                jd_putc(dumper, '_');
-            else
-                jd_putc(dumper, str[i]);
+            jd_putc(dumper, '\\');
+            jd_putc(dumper, c);
         }
     }
+    if (p > run) {
+        jd_puts_len(dumper, run, p - run);
+    }
     jd_putc(dumper, '"');
 }
 
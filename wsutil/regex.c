@@ -75,6 +75,13 @@ compile_pcre2(const char *patt, ssize_t size, char **errmsg, unsigned flags)
         return NULL;
     }
 
+    /* Display filters and coloring rules match the same regex against
+     * every packet, so it's worth the up-front cost of JIT compiling
+     * it. If JIT isn't available on this platform (or the library was
+     * built without it) this fails and pcre2_match() falls back to the
+     * interpreter, so the error is deliberately ignored. */
+    (void)pcre2_jit_compile(code, PCRE2_JIT_COMPLETE);
+
     return code;
 }
 
@@ -102,6 +109,22 @@ ws_regex_compile(const char *patt, char **errmsg)
 }
 
 
+/*
+ * None of our callers use more than the offsets of the whole match, so
+ * one match data block per thread can be shared by all regexes, rather
+ * than creating and freeing one on every match.
+ */
+static WS_THREAD_LOCAL pcre2_match_data *thread_match_data;
+
+static pcre2_match_data *
+get_match_data(void)
+{
+    if (thread_match_data == NULL)
+        thread_match_data = pcre2_match_data_create(1, NULL);
+    return thread_match_data;
+}
+
+
 static bool
 match_pcre2(pcre2_code *code, const char *subject, ssize_t subj_length,
                 pcre2_match_data *match_data)
@@ -150,18 +173,12 @@ bool
 ws_regex_matches_length(const ws_regex_t *re,
                         const char *subj, ssize_t subj_length)
 {
-    bool matched;
-    pcre2_match_data *match_data;
-
     ws_return_val_if_null(re, FALSE);
     ws_return_val_if_null(subj, FALSE);
 
     /* We don't use the matched substring but pcre2_match requires
      * at least one pair of offsets. */
-    match_data = pcre2_match_data_create(1, NULL);
-    matched = match_pcre2(re->code, subj, subj_length, match_data);
-    pcre2_match_data_free(match_data);
-    return matched;
+    return match_pcre2(re->code, subj, subj_length, get_match_data());
 }
 
 
@@ -176,14 +193,13 @@ ws_regex_matches_pos(const ws_regex_t *re,
     ws_return_val_if_null(re, FALSE);
     ws_return_val_if_null(subj, FALSE);
 
-    match_data = pcre2_match_data_create(1, NULL);
+    match_data = get_match_data();
     matched = match_pcre2(re->code, subj, subj_length, match_data);
     if (matched && pos_vect) {
         PCRE2_SIZE *ovect = pcre2_get_ovector_pointer(match_data);
         pos_vect[0] = ovect[0];
         pos_vect[1] = ovect[1];
     }
-    pcre2_match_data_free(match_data);
     return matched;
 }
 
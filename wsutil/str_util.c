@@ -596,6 +596,25 @@ ws_strdup_underline(wmem_allocator_t *allocator, long offset, size_t len)
         fmtbuf = (gchar *)wmem_realloc(allocator, fmtbuf, fmtbuf_len); \
     }
 
+/*
+ * Expand the buffer to be large enough to add an arbitrary number of
+ * bytes, plus a terminating '\0'.
+ */
+#define FMTBUF_RESERVE(nbytes) \
+    if (column+(nbytes+1) >= fmtbuf_len) { \
+        while (column+(nbytes+1) >= fmtbuf_len) \
+            fmtbuf_len *= 2; \
+        fmtbuf = (gchar *)wmem_realloc(allocator, fmtbuf, fmtbuf_len); \
+    }
+
+/*
+ * Put a run of bytes into the buffer; space must have been ensured
+ * for them.
+ */
+#define FMTBUF_PUTRUN(p, n) \
+    memcpy(&fmtbuf[column], (p), (n)); \
+    column += (guint)(n)
+
 /*
  * Put a byte into the buffer; space must have been ensured for it.
  */
@@ -628,29 +647,78 @@ ws_strdup_underline(wmem_allocator_t *allocator, long offset, size_t len)
 #define FMTBUF_ENDSTR \
     fmtbuf[column] = '\0'
 
+#define ONES_64     G_GUINT64_CONSTANT(0x0101010101010101)
+#define HIGHBITS_64 G_GUINT64_CONSTANT(0x8080808080808080)
+
+/*
+ * Return the length of the run of printable ASCII characters (0x20
+ * through 0x7E) at the beginning of the string, i.e. the part of it
+ * that format_text() copies through unchanged.
+ *
+ * Eight bytes are checked at a time: a word is all printable if no
+ * byte has its high-order bit set, is less than 0x20, or is 0x7F.
+ */
+static inline size_t
+printable_ascii_prefix_len(const guchar *string, size_t len)
+{
+    const guchar *start = string;
+    guint64 word, del;
+
+    while (len >= sizeof(word)) {
+        memcpy(&word, string, sizeof(word));
+        del = word ^ (0x7F * ONES_64);
+        if ((word | ((word - 0x20 * ONES_64) & ~word) |
+                ((del - ONES_64) & ~del)) & HIGHBITS_64)
+            break;
+        string += sizeof(word);
+        len -= sizeof(word);
+    }
+    while (len > 0 && g_ascii_isprint(*string)) {
+        string++;
+        len--;
+    }
+
+    return string - start;
+}
+
 static gchar *
 format_text_internal(wmem_allocator_t *allocator,
                         const guchar *string, size_t len,
                         gboolean replace_space)
 {
-    FMTBUF_VARS;
     const guchar *stringend = string + len;
+    size_t run;
     guchar c;
 
+    /*
+     * In the common case there's nothing to escape, so just copy
+     * the string.
+     */
+    run = printable_ascii_prefix_len(string, len);
+    if (run == len)
+        return wmem_strndup(allocator, (const gchar *)string, len);
+
+    FMTBUF_VARS;
+
     while (string < stringend) {
+        if (run) {
+            /*
+             * Printable ASCII, so not part of a multi-byte UTF-8
+             * sequence.  Make sure there's enough room for the
+             * whole run, and add it.
+             */
+            FMTBUF_RESERVE(run);
+            FMTBUF_PUTRUN(string, run);
+            string += run;
+            if (string >= stringend)
+                break;
+        }
+
         /*
          * Get the first byte of this character.
          */
         c = *string++;
-        if (g_ascii_isprint(c)) {
-            /*
-             * Printable ASCII, so not part of a multi-byte UTF-8 sequence.
-             * Make sure there's enough room for one more byte, and add
-             * the character.
-             */
-            FMTBUF_EXPAND(1);
-            FMTBUF_PUTCHAR(c);
-        } else if (replace_space && g_ascii_isspace(c)) {
+        if (replace_space && g_ascii_isspace(c)) {
             /*
              * ASCII, so not part of a multi-byte UTF-8 sequence, but
              * not printable, but is a space character; show it as a
@@ -920,6 +988,8 @@ format_text_internal(wmem_allocator_t *allocator,
                 }
             }
         }
+
+        run = printable_ascii_prefix_len(string, stringend - string);
     }
 
     FMTBUF_ENDSTR;
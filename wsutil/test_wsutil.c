@@ -212,6 +212,20 @@ static void test_format_text(void)
     g_assert_cmpstr(res, ==, want);
     g_free(res);
 
+    /* Long ASCII runs around characters that need escaping. */
+    have = "GET /index.html HTTP/1.1\r\nHost: www.example.com\177\r\n";
+    want = "GET /index.html HTTP/1.1\\r\\nHost: www.example.com\\177\\r\\n";
+    res = format_text_string(NULL, have);
+    g_assert_cmpstr(res, ==, want);
+    g_free(res);
+
+    /* The same, with white space replaced. */
+    have = "GET /index.html HTTP/1.1\r\nHost: www.example.com\177\r\n";
+    want = "GET /index.html HTTP/1.1  Host: www.example.com\\177  ";
+    res = format_text_wsp(NULL, have, strlen(have));
+    g_assert_cmpstr(res, ==, want);
+    g_free(res);
+
     /* UTF-8 */
     have = u8"Γαζέες καὶ μυρτιὲς δὲν θὰ βρῶ πιὰ στὸ χρυσαφὶ ξέφωτο";
     want = u8"Γαζέες καὶ μυρτιὲς δὲν θὰ βρῶ πιὰ στὸ χρυσαφὶ ξέφωτο";
@@ -570,6 +584,154 @@ static void test_int64_to_str_back(void)
     g_assert_cmpstr(str, ==, "9223372036854775807");
 }
 
+static void test_ip6_to_str_buf(void)
+{
+    static const struct {
+        guint8 addr[16];
+        const char *str;
+    } tests[] = {
+        { { 0 }, "::" },
+        { { 0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,1 }, "::1" },
+        { { 0x20,0x01,0x0d,0xb8,0,0,0,0,0,0,0,0,0,0,0,1 }, "2001:db8::1" },
+        { { 0x20,0x01,0x0d,0xb8,0,0,0,1,0,0,0,0,0,0,0,1 }, "2001:db8:0:1::1" },
+        { { 0x20,0x01,0x0d,0xb8,0,0,0,0,0,1,0,0,0,0,0,1 }, "2001:db8::1:0:0:1" },
+        { { 0x20,0x01,0x0d,0xb8,0,1,0,1,0,1,0,1,0,1,0,0 }, "2001:db8:1:1:1:1:1:0" },
+        { { 0xfe,0x80,0,0,0,0,0,0,0,0,0,0,0,0,0,0 }, "fe80::" },
+        { { 0,0,0,0,0,0,0,0,0,0,0xff,0xff,192,0,2,1 }, "::ffff:192.0.2.1" },
+        { { 0,0,0,0,0,0,0,0,0,0,0,0,192,0,2,1 }, "::192.0.2.1" },
+        { { 0xab,0xcd,0x0f,0xff,0,0x10,0x12,0x34,0xff,0xff,0,0,0xa0,0,0,0x0a }, "abcd:fff:10:1234:ffff:0:a000:a" },
+    };
+    char buf[WS_INET6_ADDRSTRLEN];
+    char small[4];
+
+    for (size_t i = 0; i < G_N_ELEMENTS(tests); i++) {
+        ws_in6_addr addr;
+
+        memcpy(addr.bytes, tests[i].addr, sizeof(addr.bytes));
+        ip6_to_str_buf(&addr, buf, sizeof(buf));
+        g_assert_cmpstr(buf, ==, tests[i].str);
+    }
+
+    /* Short buffers are fine as long as the address fits. */
+    ip6_to_str_buf((const ws_in6_addr *)tests[1].addr, small, sizeof(small));
+    g_assert_cmpstr(small, ==, "::1");
+    ip6_to_str_buf((const ws_in6_addr *)tests[2].addr, small, sizeof(small));
+    g_assert_cmpstr(small, ==, "[Bu");
+}
+
+#include "unicode-utils.h"
+
+static void test_ascii_prefix_len(void)
+{
+    const guint8 *str;
+
+    str = (const guint8 *)"0123456789abcdef";
+    g_assert_cmpuint(ws_ascii_prefix_len(str, 16), ==, 16);
+    g_assert_cmpuint(ws_ascii_prefix_len(str, 13), ==, 13);
+    g_assert_cmpuint(ws_ascii_prefix_len(str, 0), ==, 0);
+
+    str = (const guint8 *)"0123456789abcdef\x80xyz";
+    g_assert_cmpuint(ws_ascii_prefix_len(str, 20), ==, 16);
+
+    str = (const guint8 *)"abc\xff" "defghijklmnop";
+    g_assert_cmpuint(ws_ascii_prefix_len(str, 16), ==, 3);
+
+    str = (const guint8 *)"\xc3\xa9" "abcdefghij";
+    g_assert_cmpuint(ws_ascii_prefix_len(str, 12), ==, 0);
+}
+
+static void test_utf8_make_valid(void)
+{
+    const char *str;
+    guint8 *result;
+
+    /* Long ASCII runs are passed through unchanged. */
+    str = "The quick brown fox jumps over the lazy dog";
+    result = ws_utf8_make_valid(NULL, (const guint8 *)str, strlen(str));
+    g_assert_cmpstr((char *)result, ==, str);
+    wmem_free(NULL, result);
+
+    /* As are valid multibyte sequences between them. */
+    str = "0123456789" "\xc3\xa9" "abcdefgh" "\xe2\x82\xac" "ijklmnopq";
+    result = ws_utf8_make_valid(NULL, (const guint8 *)str, strlen(str));
+    g_assert_cmpstr((char *)result, ==, str);
+    wmem_free(NULL, result);
+
+    /* Invalid bytes are replaced, wherever they fall within a word. */
+    str = "0123456789" "\xff" "abcdefgh" "\xc3";
+    result = ws_utf8_make_valid(NULL, (const guint8 *)str, strlen(str));
+    g_assert_cmpstr((char *)result, ==,
+                    "0123456789" "\xef\xbf\xbd" "abcdefgh" "\xef\xbf\xbd");
+    wmem_free(NULL, result);
+}
+
+#include "g711.h"
+
+static void test_g711_block(void)
+{
+    unsigned char code[256];
+    short alaw[256], ulaw[256];
+
+    for (int i = 0; i < 256; i++)
+        code[i] = (unsigned char)i;
+
+    alaw2linear_block(code, alaw, 256);
+    ulaw2linear_block(code, ulaw, 256);
+
+    for (int i = 0; i < 256; i++) {
+        g_assert_cmpint(alaw[i], ==, alaw2linear(code[i]));
+        g_assert_cmpint(ulaw[i], ==, ulaw2linear(code[i]));
+    }
+}
+
+#include "crc32.h"
+
+static void test_crc32c(void)
+{
+    const char *check = "123456789";
+    guint8 buf[300];
+    guint32 crc, want;
+    int i, len, offset;
+
+    /* The standard check value for CRC-32C */
+    crc = crc32c_calculate_no_swap(check, 9, CRC32C_PRELOAD) ^ 0xffffffff;
+    g_assert_cmphex(crc, ==, 0xe3069283);
+
+    /* Compare against the table at every length and alignment that
+     * matters to the word-at-a-time implementations. */
+    for (i = 0; i < (int)sizeof(buf); i++) {
+        buf[i] = (guint8)(i * 7 + 3);
+    }
+    for (offset = 0; offset < 8; offset++) {
+        for (len = 0; len <= (int)sizeof(buf) - offset; len++) {
+            want = CRC32C_PRELOAD;
+            for (i = 0; i < len; i++) {
+                want = (want >> 8) ^ crc32c_table_lookup((guchar)(want ^ buf[offset + i]));
+            }
+            crc = crc32c_calculate_no_swap(buf + offset, len, CRC32C_PRELOAD);
+            g_assert_cmphex(crc, ==, want);
+        }
+    }
+}
+
+static void test_crc32c_perf(void)
+{
+#define CRC_LOOP_COUNT (100 * 1000)
+    static guint8 buf[9000];
+    guint32 crc = CRC32C_PRELOAD;
+    int i;
+    double start_utime, start_stime, end_utime, end_stime, utime_ms, stime_ms;
+
+    RESOURCE_USAGE_START;
+    for (i = 0; i < CRC_LOOP_COUNT; i++) {
+        crc = crc32c_calculate_no_swap(buf, (int)sizeof(buf), crc);
+    }
+    RESOURCE_USAGE_END;
+    g_test_minimized_result(utime_ms + stime_ms,
+        "crc32c_calculate_no_swap() of %u x %zu bytes: u %.3f ms s %.3f ms (crc %08x)",
+        CRC_LOOP_COUNT, sizeof(buf), utime_ms, stime_ms, crc);
+}
+
 #include "nstime.h"
 #include "time_util.h"
 
@@ -635,6 +797,59 @@ void test_nstime_from_iso8601(void)
     g_assert_cmpint(result.nsecs, ==, expect.nsecs);
 }
 
+static void test_gmtime_cached(void)
+{
+    const struct tm *tmp;
+
+    tmp = ws_gmtime_cached(0);
+    g_assert_nonnull(tmp);
+    g_assert_cmpint(tmp->tm_year, ==, 70);
+    g_assert_cmpint(tmp->tm_mday, ==, 1);
+
+    /* A different second must not come from the cache. */
+    tmp = ws_gmtime_cached(86400 + 3600 + 60 + 1);
+    g_assert_nonnull(tmp);
+    g_assert_cmpint(tmp->tm_mday, ==, 2);
+    g_assert_cmpint(tmp->tm_hour, ==, 1);
+    g_assert_cmpint(tmp->tm_min, ==, 1);
+    g_assert_cmpint(tmp->tm_sec, ==, 1);
+
+    tmp = ws_gmtime_cached(86400 + 3600 + 60 + 1);
+    g_assert_cmpint(tmp->tm_sec, ==, 1);
+    tmp = ws_gmtime_cached(0);
+    g_assert_cmpint(tmp->tm_mday, ==, 1);
+    g_assert_cmpint(tmp->tm_sec, ==, 0);
+}
+
+#include "buffer.h"
+
+static void test_buffer_queue(void)
+{
+    Buffer buf;
+    guint8 chunk[1000];
+    gsize max_allocated = 0;
+
+    for (gsize i = 0; i < sizeof chunk; i++)
+        chunk[i] = (guint8)i;
+
+    ws_buffer_init(&buf, 0);
+
+    /* Keep about 10 chunks queued while appending many more; the
+     * allocation must stay bounded and the data intact. */
+    for (int i = 0; i < 1000; i++) {
+        ws_buffer_append(&buf, chunk, sizeof chunk);
+        if (ws_buffer_length(&buf) > 10 * sizeof chunk) {
+            g_assert_cmpmem(ws_buffer_start_ptr(&buf), sizeof chunk, chunk, sizeof chunk);
+            ws_buffer_remove_start(&buf, sizeof chunk);
+        }
+        max_allocated = MAX(max_allocated, buf.allocated);
+    }
+    g_assert_cmpuint(ws_buffer_length(&buf), ==, 10 * sizeof chunk);
+    g_assert_cmpuint(max_allocated, <=, 4 * 11 * sizeof chunk);
+
+    ws_buffer_free(&buf);
+}
+
 #include "ws_getopt.h"
 
 #define ARGV_MAX 31
@@ -849,8 +1064,23 @@ int main(int argc, char **argv)
     g_test_add_func("/to_str/uint64_to_str_back_len", test_uint64_to_str_back_len);
     g_test_add_func("/to_str/int_to_str_back", test_int_to_str_back);
     g_test_add_func("/to_str/int64_to_str_back", test_int64_to_str_back);
+    g_test_add_func("/to_str/ip6_to_str_buf", test_ip6_to_str_buf);
+
+    g_test_add_func("/unicode/ascii_prefix_len", test_ascii_prefix_len);
+    g_test_add_func("/unicode/utf8_make_valid", test_utf8_make_valid);
+
+    g_test_add_func("/g711/block", test_g711_block);
+
+    g_test_add_func("/crc32/crc32c", test_crc32c);
+
+    if (g_test_perf()) {
+        g_test_add_func("/crc32/crc32c_perf", test_crc32c_perf);
+    }
 
     g_test_add_func("/nstime/from_iso8601", test_nstime_from_iso8601);
+    g_test_add_func("/time_util/gmtime_cached", test_gmtime_cached);
+
+    g_test_add_func("/buffer/queue", test_buffer_queue);
 
     g_test_add_func("/ws_getopt/basic1", test_getopt_long_basic1);
     g_test_add_func("/ws_getopt/basic2", test_getopt_long_basic2);
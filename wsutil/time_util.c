@@ -105,6 +105,49 @@ tm_is_valid(struct tm *tm)
 	return TRUE;
 }
 
+/*
+ * Converting a time to broken-down time isn't cheap, especially for
+ * local time, and consecutive packets are usually in the same second,
+ * so remember the answer for the last second we were asked about.
+ */
+typedef struct {
+	gboolean valid;
+	time_t secs;
+	struct tm tm;
+} tm_cache_t;
+
+static WS_THREAD_LOCAL tm_cache_t localtime_cache;
+static WS_THREAD_LOCAL tm_cache_t gmtime_cache;
+
+static const struct tm *
+get_cached_tm(tm_cache_t *cache, time_t secs, gboolean local)
+{
+	struct tm *tmp;
+
+	if (cache->valid && cache->secs == secs)
+		return &cache->tm;
+
+	tmp = local ? localtime(&secs) : gmtime(&secs);
+	if (tmp == NULL)
+		return NULL;
+	cache->tm = *tmp;
+	cache->secs = secs;
+	cache->valid = TRUE;
+	return &cache->tm;
+}
+
+const struct tm *
+ws_localtime_cached(time_t secs)
+{
+	return get_cached_tm(&localtime_cache, secs, TRUE);
+}
+
+const struct tm *
+ws_gmtime_cached(time_t secs)
+{
+	return get_cached_tm(&gmtime_cache, secs, FALSE);
+}
+
 void get_resource_usage(double *user_time, double *sys_time) {
 #ifndef _WIN32
 	struct rusage ru;
@@ -32,6 +32,20 @@ time_t mktime_utc(struct tm *tm);
 WS_DLL_PUBLIC
 gboolean tm_is_valid(struct tm *tm);
 
+/** Like localtime() and gmtime(), but the result for the most recent
+ * second asked about is remembered, as successive callers (e.g. the
+ * time columns for consecutive packets) tend to ask for the same one.
+ *
+ * @param secs The time to convert.
+ * @return A pointer to a per-thread buffer, which is overwritten by
+ * the next call, or NULL if the time can't be represented.
+ */
+WS_DLL_PUBLIC
+const struct tm *ws_localtime_cached(time_t secs);
+
+WS_DLL_PUBLIC
+const struct tm *ws_gmtime_cached(time_t secs);
+
 /** Fetch the process CPU time.
  *
  * Fetch the current process user and system CPU times, convert them to
@@ -594,22 +594,95 @@ char *ip_to_str(wmem_allocator_t *scope, const guint8 *ad)
 	return buf;
 }
 
+/*
+ * Format an IPv6 address the way inet_ntop() does on glibc (RFC 5952
+ * text form, with the IPv4-mapped and IPv4-compatible forms for the
+ * last 32 bits), without going through sprintf() for every group like
+ * the system implementations do.
+ *
+ * Returns the number of characters written, not counting the
+ * terminating NUL; buf must have room for WS_INET6_ADDRSTRLEN bytes.
+ */
+static size_t
+ip6_to_str_unchecked(const ws_in6_addr *addr, gchar *buf)
+{
+	const guint8 *ad = addr->bytes;
+	guint16 words[8];
+	int best_base = -1, best_len = 0;
+	int cur_base = -1, cur_len = 0;
+	gchar *b = buf;
+	int i;
+
+	for (i = 0; i < 8; i++)
+		words[i] = pntoh16(&ad[i * 2]);
+
+	/* Find the longest run of (at least two) zero groups; the first one wins a tie. */
+	for (i = 0; i < 8; i++) {
+		if (words[i] == 0) {
+			if (cur_base == -1) {
+				cur_base = i;
+				cur_len = 1;
+			} else {
+				cur_len++;
+			}
+		} else if (cur_base != -1) {
+			if (best_base == -1 || cur_len > best_len) {
+				best_base = cur_base;
+				best_len = cur_len;
+			}
+			cur_base = -1;
+		}
+	}
+	if (cur_base != -1 && (best_base == -1 || cur_len > best_len)) {
+		best_base = cur_base;
+		best_len = cur_len;
+	}
+	if (best_base != -1 && best_len < 2)
+		best_base = -1;
+
+	for (i = 0; i < 8; i++) {
+		if (best_base != -1 && i >= best_base && i < best_base + best_len) {
+			if (i == best_base)
+				*b++ = ':';
+			continue;
+		}
+		if (i != 0)
+			*b++ = ':';
+		if (i == 6 && best_base == 0 &&
+		    (best_len == 6 || (best_len == 5 && words[5] == 0xffff))) {
+			ip_to_str_buf(&ad[12], b, WS_INET_ADDRSTRLEN);
+			return (size_t)(b - buf) + strlen(b);
+		}
+		b = word_to_hex_npad(b, words[i]);
+	}
+	if (best_base != -1 && best_base + best_len == 8)
+		*b++ = ':';
+	*b = '\0';
+
+	return (size_t)(b - buf);
+}
+
 void
 ip6_to_str_buf(const ws_in6_addr *addr, gchar *buf, size_t buf_size)
 {
-	/*
-	 * If there is not enough space then ws_inet_ntop6() will leave
-	 * an error message in the buffer, we don't need
-	 * to use _return_if_nospace().
-	 */
-	ws_inet_ntop6(addr, buf, (guint)buf_size);
+	gchar str[WS_INET6_ADDRSTRLEN];
+	size_t str_len;
+
+	if (buf_size >= WS_INET6_ADDRSTRLEN) {
+		ip6_to_str_unchecked(addr, buf);
+		return;
+	}
+
+	str_len = ip6_to_str_unchecked(addr, str) + 1;
+	_return_if_nospace(str_len, buf, buf_size);
+	memcpy(buf, str, str_len);
 }
 
 char *ip6_to_str(wmem_allocator_t *scope, const ws_in6_addr *ad)
 {
 	char *buf = wmem_alloc(scope, WS_INET6_ADDRSTRLEN * sizeof(char));
 
-	ws_inet_ntop6(ad, buf, WS_INET6_ADDRSTRLEN);
+	ip6_to_str_unchecked(ad, buf);
 
 	return buf;
 }
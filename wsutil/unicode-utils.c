@@ -12,6 +12,8 @@
 
 #include "unicode-utils.h"
 
+#include <string.h>
+
 int ws_utf8_seqlen[256] = {
     1,1,1,1,1,1,1,1,1,1,1,1,1,1,1,1,  /* 0x00...0x0f */
     1,1,1,1,1,1,1,1,1,1,1,1,1,1,1,1,  /* 0x10...0x1f */
@@ -31,6 +33,29 @@ int ws_utf8_seqlen[256] = {
     4,4,4,4,4,0,0,0,0,0,0,0,0,0,0,0,  /* 0xf0...0xff */
 };
 
+size_t
+ws_ascii_prefix_len(const guint8 *ptr, size_t length)
+{
+    const guint8 *start = ptr;
+    guint64 word;
+
+    /* A word at a time while all the high-order bits are clear... */
+    while (length >= sizeof(word)) {
+        memcpy(&word, ptr, sizeof(word));
+        if (word & G_GUINT64_CONSTANT(0x8080808080808080))
+            break;
+        ptr += sizeof(word);
+        length -= sizeof(word);
+    }
+    /* ...and then up to the first non-ASCII byte. */
+    while (length > 0 && *ptr < 0x80) {
+        ptr++;
+        length--;
+    }
+
+    return ptr - start;
+}
+
 /* Given a pointer and a length, validates a string of bytes as UTF-8.
  * Returns the number of valid bytes, and a pointer immediately past
  * the checked region.
@@ -54,9 +79,11 @@ utf_8_validate(const guint8 *start, ssize_t length, const guint8 **end)
         ch = *ptr;
 
         if (ch < 0x80) {
-            valid_bytes++;
-            ptr++;
-            length--;
+            size_t ascii_len = ws_ascii_prefix_len(ptr, length);
+
+            valid_bytes += ascii_len;
+            ptr += ascii_len;
+            length -= ascii_len;
             continue;
         }
 
@@ -59,6 +59,15 @@ int ws_utf8_seqlen[256];
  */
 #define ws_utf8_char_len(ch)  (ws_utf8_seqlen[(ch)])
 
+/*
+ * Return the number of leading bytes of the buffer referred to by the
+ * pointer and length that are ASCII, i.e. have the high-order bit clear.
+ * Checks a 64-bit word at a time, so it's considerably faster than a
+ * byte-by-byte loop on mostly-ASCII text.
+ */
+WS_DLL_PUBLIC size_t
+ws_ascii_prefix_len(const guint8 *ptr, size_t length);
+
 /*
  * Given a wmem scope, a pointer, and a length, treat the string of bytes
  * referred to by the pointer and length as a UTF-8 string, and return a
@@ -63,6 +63,11 @@ typedef struct _wmem_block_fast_jumbo {
 typedef struct {
     wmem_block_fast_hdr_t   *block_list;
     wmem_block_fast_jumbo_t *jumbo_list;
+    /* One block kept back by free_all() for reuse, so that a pool which
+     * regularly needs more than one block (e.g. the per-packet pool for
+     * large reassembled PDUs) doesn't allocate, fault in and free a fresh
+     * block every time it is emptied. Released by gc(). */
+    wmem_block_fast_hdr_t   *spare_block;
 } wmem_block_fast_allocator_t;
 
 /* Creates a new block, and initializes it. */
@@ -72,7 +77,12 @@ wmem_block_fast_new_block(wmem_block_fast_allocator_t *allocator)
     wmem_block_fast_hdr_t *block;
 
     /* allocate/initialize the new block and add it to the block list */
-    block = (wmem_block_fast_hdr_t *)wmem_alloc(NULL, WMEM_BLOCK_SIZE);
+    if (allocator->spare_block) {
+        block = allocator->spare_block;
+        allocator->spare_block = NULL;
+    } else {
+        block = (wmem_block_fast_hdr_t *)wmem_alloc(NULL, WMEM_BLOCK_SIZE);
+    }
 
     block->pos  = WMEM_BLOCK_HEADER_SIZE;
     block->next = allocator->block_list;
@@ -178,7 +188,8 @@ wmem_block_fast_free_all(void *private_data)
     wmem_block_fast_jumbo_t     *cur_jum, *nxt_jum;
 
     /* iterate through the blocks, freeing all but the first and reinitializing
-     * that one */
+     * that one; keep one of the others as the spare block if we don't have
+     * one yet */
     cur = allocator->block_list;
 
     if (cur) {
@@ -190,7 +201,11 @@ wmem_block_fast_free_all(void *private_data)
 
     while (cur) {
         nxt  = cur->next;
-        wmem_free(NULL, cur);
+        if (allocator->spare_block == NULL) {
+            allocator->spare_block = cur;
+        } else {
+            wmem_free(NULL, cur);
+        }
         cur = nxt;
     }
 
@@ -205,9 +220,13 @@ wmem_block_fast_free_all(void *private_data)
 }
 
 static void
-wmem_block_fast_gc(void *private_data _U_)
+wmem_block_fast_gc(void *private_data)
 {
-    /* No-op */
+    wmem_block_fast_allocator_t *allocator = (wmem_block_fast_allocator_t*) private_data;
+
+    /* The only unused memory we hold on to is the spare block */
+    wmem_free(NULL, allocator->spare_block);
+    allocator->spare_block = NULL;
 }
 
 static void
@@ -216,8 +235,9 @@ wmem_block_fast_allocator_cleanup(void *private_data)
     wmem_block_fast_allocator_t *allocator = (wmem_block_fast_allocator_t*) private_data;
 
     /* wmem guarantees that free_all() is called directly before this, so
-     * simply free the first block */
+     * simply free the first block and the spare one */
     wmem_free(NULL, allocator->block_list);
+    wmem_free(NULL, allocator->spare_block);
 
     /* then just free the allocator structs */
     wmem_free(NULL, private_data);
@@ -242,6 +262,7 @@ wmem_block_fast_allocator_init(wmem_allocator_t *allocator)
 
     block_allocator->block_list = NULL;
     block_allocator->jumbo_list = NULL;
+    block_allocator->spare_block = NULL;
 }
 
 /*
@@ -41,6 +41,9 @@ wmem_alloc(wmem_allocator_t *allocator, const size_t size)
         return NULL;
     }
 
+    allocator->stats.alloc_count++;
+    allocator->stats.bytes_requested += size;
+
     return allocator->walloc(allocator->private_data, size);
 }
 
@@ -72,6 +75,8 @@ wmem_free(wmem_allocator_t *allocator, void *ptr)
         return;
     }
 
+    allocator->stats.free_count++;
+
     allocator->wfree(allocator->private_data, ptr);
 }
 
@@ -93,6 +98,8 @@ wmem_realloc(wmem_allocator_t *allocator, void *ptr, const size_t size)
 
     ws_assert(allocator->in_scope);
 
+    allocator->stats.bytes_requested += size;
+
     return allocator->wrealloc(allocator->private_data, ptr, size);
 }
 
@@ -102,6 +109,13 @@ wmem_free_all_real(wmem_allocator_t *allocator, gboolean final)
     wmem_call_callbacks(allocator,
             final ? WMEM_CB_DESTROY_EVENT : WMEM_CB_FREE_EVENT);
     allocator->free_all(allocator->private_data);
+
+    if (allocator->stats.bytes_requested > allocator->stats.peak_bytes_requested) {
+        allocator->stats.peak_bytes_requested = allocator->stats.bytes_requested;
+    }
+    allocator->stats.alloc_count     = 0;
+    allocator->stats.free_count      = 0;
+    allocator->stats.bytes_requested = 0;
 }
 
 void
@@ -116,6 +130,15 @@ wmem_gc(wmem_allocator_t *allocator)
     allocator->gc(allocator->private_data);
 }
 
+void
+wmem_get_allocator_stats(wmem_allocator_t *allocator, wmem_allocator_stats_t *stats)
+{
+    *stats = allocator->stats;
+    if (stats->bytes_requested > stats->peak_bytes_requested) {
+        stats->peak_bytes_requested = stats->bytes_requested;
+    }
+}
+
 void
 wmem_destroy_allocator(wmem_allocator_t *allocator)
 {
@@ -142,6 +165,7 @@ wmem_allocator_new(const wmem_allocator_type_t type)
     allocator->type      = real_type;
     allocator->callbacks = NULL;
     allocator->in_scope  = TRUE;
+    memset(&allocator->stats, 0, sizeof(allocator->stats));
 
     switch (real_type) {
         case WMEM_ALLOCATOR_SIMPLE:
@@ -184,6 +184,27 @@ WS_DLL_PUBLIC
 void
 wmem_gc(wmem_allocator_t *allocator);
 
+/** Usage counters kept by every allocator. They are reset whenever the
+ * allocator's memory is freed with wmem_free_all(). Allocators don't record
+ * the size of individual blocks, so bytes_requested is not reduced by
+ * wmem_free(), and a wmem_realloc() counts its full new size.
+ */
+typedef struct _wmem_allocator_stats_t {
+    size_t alloc_count;          /**< blocks allocated since the last free_all */
+    size_t free_count;           /**< blocks explicitly freed since then */
+    size_t bytes_requested;      /**< bytes requested since then */
+    size_t peak_bytes_requested; /**< largest bytes_requested ever reached */
+} wmem_allocator_stats_t;
+
+/** Get the usage counters of an allocator.
+ *
+ * @param allocator The allocator to query.
+ * @param stats Filled in with the allocator's counters.
+ */
+WS_DLL_PUBLIC
+void
+wmem_get_allocator_stats(wmem_allocator_t *allocator, wmem_allocator_stats_t *stats);
+
 /** Destroy the given allocator, freeing all memory allocated in it. Once this
  * function has been called, no memory allocated with the allocator is valid.
  *
@@ -10,6 +10,8 @@
  */
 #include "config.h"
 
+#include <string.h>
+
 #include <glib.h>
 
 #include "wmem_core.h"
@@ -41,6 +43,15 @@ typedef struct _wmem_map_item_t {
     struct _wmem_map_item_t *next;
 } wmem_map_item_t;
 
+/* Entry of a flat (open addressing) map. The mixed hash is kept alongside the
+ * key so that growing the table and shifting entries back on removal never
+ * need to call the hash function again. */
+typedef struct _wmem_map_flat_entry_t {
+    const void *key;
+    void *value;
+    guint32 hash;
+} wmem_map_flat_entry_t;
+
 struct _wmem_map_t {
     guint count; /* number of items stored */
 
@@ -52,6 +63,14 @@ struct _wmem_map_t {
 
     wmem_map_item_t **table;
 
+    /* Flat maps use linear probing over a single array of entries instead of
+     * chains of individually allocated items. Each slot has a control byte
+     * which is either zero (empty) or a 7-bit tag of the hash with the high
+     * bit set, so probing mostly touches the small, dense control array. */
+    gboolean               flat;
+    wmem_map_flat_entry_t *entries;
+    guint8                *ctrl;
+
     GHashFunc  hash_func;
     GEqualFunc eql_func;
 
@@ -76,6 +95,18 @@ struct _wmem_map_t {
 #define HASH(MAP, KEY) \
     ((guint32)(((MAP)->hash_func(KEY) * x) >> (32 - (MAP)->capacity)))
 
+/* Flat maps keep the full mixed hash; the slot is taken from its top bits as
+ * above and the control tag from the middle ones. */
+#define FLAT_HASH(MAP, KEY) ((guint32)((MAP)->hash_func(KEY) * x))
+#define FLAT_SLOT(MAP, H)   ((size_t)((H) >> (32 - (MAP)->capacity)))
+#define FLAT_TAG(H)         ((guint8)(0x80 | (((H) ^ ((H) >> 16)) & 0x7f)))
+#define FLAT_EMPTY          0
+#define FLAT_MASK(MAP)      (CAPACITY(MAP) - 1)
+
+/* Linear probing degrades quickly when nearly full, so flat maps grow when
+ * they are three quarters full rather than when full. */
+#define FLAT_OVERFULL(MAP)  ((size_t)(MAP)->count * 4 >= CAPACITY(MAP) * 3)
+
 static void
 wmem_map_init_table(wmem_map_t *map)
 {
@@ -98,6 +129,9 @@ wmem_map_new(wmem_allocator_t *allocator,
     map->data_allocator = allocator;
     map->count = 0;
     map->table = NULL;
+    map->flat = FALSE;
+    map->entries = NULL;
+    map->ctrl = NULL;
 
     return map;
 }
@@ -110,6 +144,8 @@ wmem_map_reset_cb(wmem_allocator_t *allocator _U_, wmem_cb_event_t event,
 
     map->count = 0;
     map->table = NULL;
+    map->entries = NULL;
+    map->ctrl = NULL;
 
     if (event == WMEM_CB_DESTROY_EVENT) {
         wmem_unregister_callback(map->metadata_allocator, map->metadata_scope_cb_id);
@@ -144,6 +180,9 @@ wmem_map_new_autoreset(wmem_allocator_t *metadata_scope, wmem_allocator_t *data_
     map->data_allocator = data_scope;
     map->count = 0;
     map->table = NULL;
+    map->flat = FALSE;
+    map->entries = NULL;
+    map->ctrl = NULL;
 
     map->metadata_scope_cb_id = wmem_register_callback(metadata_scope, wmem_map_destroy_cb, map);
     map->data_scope_cb_id  = wmem_register_callback(data_scope, wmem_map_reset_cb, map);
@@ -151,6 +190,245 @@ wmem_map_new_autoreset(wmem_allocator_t *metadata_scope, wmem_allocator_t *data_
     return map;
 }
 
+wmem_map_t *
+wmem_map_new_flat(wmem_allocator_t *allocator,
+        GHashFunc hash_func, GEqualFunc eql_func)
+{
+    wmem_map_t *map;
+
+    map = wmem_map_new(allocator, hash_func, eql_func);
+    map->flat = TRUE;
+
+    return map;
+}
+
+wmem_map_t *
+wmem_map_new_flat_autoreset(wmem_allocator_t *metadata_scope, wmem_allocator_t *data_scope,
+        GHashFunc hash_func, GEqualFunc eql_func)
+{
+    wmem_map_t *map;
+
+    map = wmem_map_new_autoreset(metadata_scope, data_scope, hash_func, eql_func);
+    map->flat = TRUE;
+
+    return map;
+}
+
+static void
+wmem_map_flat_alloc_table(wmem_map_t *map)
+{
+    size_t cap = CAPACITY(map);
+
+    /* Entries and control bytes share one allocation, entries first so that
+     * they stay suitably aligned. */
+    map->entries = (wmem_map_flat_entry_t *)wmem_alloc(map->data_allocator,
+            cap * (sizeof(wmem_map_flat_entry_t) + 1));
+    map->ctrl = (guint8 *)(map->entries + cap);
+    memset(map->ctrl, FLAT_EMPTY, cap);
+}
+
+static void
+wmem_map_flat_init_table(wmem_map_t *map)
+{
+    map->count    = 0;
+    map->capacity = WMEM_MAP_DEFAULT_CAPACITY;
+    wmem_map_flat_alloc_table(map);
+}
+
+/* Looks for the key. Returns TRUE and its slot if it is present, otherwise
+ * FALSE and the empty slot where it would be inserted. */
+static gboolean
+wmem_map_flat_find(wmem_map_t *map, const void *key, guint32 hash, size_t *slot)
+{
+    size_t mask = FLAT_MASK(map);
+    size_t i    = FLAT_SLOT(map, hash);
+    guint8 tag  = FLAT_TAG(hash);
+
+    while (map->ctrl[i] != FLAT_EMPTY) {
+        if (map->ctrl[i] == tag && map->entries[i].hash == hash &&
+                map->eql_func(key, map->entries[i].key)) {
+            *slot = i;
+            return TRUE;
+        }
+        i = (i + 1) & mask;
+    }
+
+    *slot = i;
+    return FALSE;
+}
+
+static void
+wmem_map_flat_grow(wmem_map_t *map)
+{
+    wmem_map_flat_entry_t *old_entries;
+    guint8                *old_ctrl;
+    size_t                 old_cap, mask, i, slot;
+
+    old_entries = map->entries;
+    old_ctrl    = map->ctrl;
+    old_cap     = CAPACITY(map);
+
+    map->capacity++;
+    wmem_map_flat_alloc_table(map);
+    mask = FLAT_MASK(map);
+
+    for (i = 0; i < old_cap; i++) {
+        if (old_ctrl[i] == FLAT_EMPTY)
+            continue;
+        slot = FLAT_SLOT(map, old_entries[i].hash);
+        while (map->ctrl[slot] != FLAT_EMPTY) {
+            slot = (slot + 1) & mask;
+        }
+        map->entries[slot] = old_entries[i];
+        map->ctrl[slot]    = old_ctrl[i];
+    }
+
+    wmem_free(map->data_allocator, old_entries);
+}
+
+static void *
+wmem_map_flat_insert(wmem_map_t *map, const void *key, void *value)
+{
+    guint32 hash;
+    size_t  slot;
+    void   *old_val;
+
+    if (map->entries == NULL) {
+        wmem_map_flat_init_table(map);
+    }
+
+    hash = FLAT_HASH(map, key);
+    if (wmem_map_flat_find(map, key, hash, &slot)) {
+        old_val = map->entries[slot].value;
+        map->entries[slot].value = value;
+        return old_val;
+    }
+
+    map->entries[slot].key   = key;
+    map->entries[slot].value = value;
+    map->entries[slot].hash  = hash;
+    map->ctrl[slot]          = FLAT_TAG(hash);
+
+    map->count++;
+
+    if (FLAT_OVERFULL(map)) {
+        wmem_map_flat_grow(map);
+    }
+
+    return NULL;
+}
+
+/* Empties the given slot and moves later entries of the same probe sequence
+ * back into the hole, so that no tombstones are needed (Knuth's Algorithm R).
+ * Entries only ever move to the emptied slot or to slots after it and before
+ * the next empty slot, which wmem_map_flat_foreach_remove() relies on. */
+static void
+wmem_map_flat_remove_slot(wmem_map_t *map, size_t slot)
+{
+    size_t mask = FLAT_MASK(map);
+    size_t hole = slot;
+    size_t i    = slot;
+    size_t home;
+
+    for (;;) {
+        i = (i + 1) & mask;
+        if (map->ctrl[i] == FLAT_EMPTY)
+            break;
+
+        /* Leave the entry alone if its home slot lies cyclically in
+         * (hole, i], as it would not be found from there otherwise. */
+        home = FLAT_SLOT(map, map->entries[i].hash);
+        if (hole <= i ? (hole < home && home <= i) : (hole < home || home <= i))
+            continue;
+
+        map->entries[hole] = map->entries[i];
+        map->ctrl[hole]    = map->ctrl[i];
+        hole = i;
+    }
+
+    map->ctrl[hole] = FLAT_EMPTY;
+    map->count--;
+}
+
+static gboolean
+wmem_map_flat_lookup_extended(wmem_map_t *map, const void *key, const void **orig_key, void **value)
+{
+    size_t slot;
+
+    if (map->entries == NULL) {
+        return FALSE;
+    }
+
+    if (!wmem_map_flat_find(map, key, FLAT_HASH(map, key), &slot)) {
+        return FALSE;
+    }
+
+    if (orig_key) {
+        *orig_key = map->entries[slot].key;
+    }
+    if (value) {
+        *value = map->entries[slot].value;
+    }
+    return TRUE;
+}
+
+static gboolean
+wmem_map_flat_steal(wmem_map_t *map, const void *key, void **value)
+{
+    size_t slot;
+
+    if (map->entries == NULL) {
+        return FALSE;
+    }
+
+    if (!wmem_map_flat_find(map, key, FLAT_HASH(map, key), &slot)) {
+        return FALSE;
+    }
+
+    if (value) {
+        *value = map->entries[slot].value;
+    }
+    wmem_map_flat_remove_slot(map, slot);
+    return TRUE;
+}
+
+static guint
+wmem_map_flat_foreach_remove(wmem_map_t *map, GHRFunc foreach_func, gpointer user_data)
+{
+    size_t   cap, mask, start, i, n;
+    unsigned deleted = 0;
+
+    if (map->entries == NULL) {
+        return 0;
+    }
+
+    cap  = CAPACITY(map);
+    mask = FLAT_MASK(map);
+
+    /* Start just after an empty slot (there is always one, as the map is
+     * never full). Removal then only shifts entries we haven't visited yet
+     * into the current slot or later ones, so visiting each slot in order
+     * and rechecking the current one after a removal sees every entry
+     * exactly once. */
+    for (start = 0; map->ctrl[start] != FLAT_EMPTY; start++)
+        ;
+
+    i = (start + 1) & mask;
+    n = 1;
+    while (n < cap) {
+        if (map->ctrl[i] != FLAT_EMPTY &&
+                foreach_func((gpointer)map->entries[i].key, map->entries[i].value, user_data)) {
+            wmem_map_flat_remove_slot(map, i);
+            deleted++;
+            continue;
+        }
+        i = (i + 1) & mask;
+        n++;
+    }
+
+    return deleted;
+}
+
 static inline void
 wmem_map_grow(wmem_map_t *map)
 {
@@ -189,6 +467,10 @@ wmem_map_insert(wmem_map_t *map, const void *key, void *value)
     wmem_map_item_t **item;
     void *old_val;
 
+    if (map->flat) {
+        return wmem_map_flat_insert(map, key, value);
+    }
+
     /* Make sure we have a table */
     if (map->table == NULL) {
         wmem_map_init_table(map);
@@ -231,6 +513,10 @@ wmem_map_contains(wmem_map_t *map, const void *key)
 {
     wmem_map_item_t *item;
 
+    if (map->flat) {
+        return wmem_map_flat_lookup_extended(map, key, NULL, NULL);
+    }
+
     /* Make sure we have a table */
     if (map->table == NULL) {
         return FALSE;
@@ -255,6 +541,12 @@ wmem_map_lookup(wmem_map_t *map, const void *key)
 {
     wmem_map_item_t *item;
 
+    if (map->flat) {
+        void *value = NULL;
+        wmem_map_flat_lookup_extended(map, key, NULL, &value);
+        return value;
+    }
+
     /* Make sure we have a table */
     if (map->table == NULL) {
         return NULL;
@@ -279,6 +571,10 @@ wmem_map_lookup_extended(wmem_map_t *map, const void *key, const void **orig_key
 {
     wmem_map_item_t *item;
 
+    if (map->flat) {
+        return wmem_map_flat_lookup_extended(map, key, orig_key, value);
+    }
+
     /* Make sure we have a table */
     if (map->table == NULL) {
         return FALSE;
@@ -310,6 +606,12 @@ wmem_map_remove(wmem_map_t *map, const void *key)
     wmem_map_item_t **item, *tmp;
     void *value;
 
+    if (map->flat) {
+        value = NULL;
+        wmem_map_flat_steal(map, key, &value);
+        return value;
+    }
+
     /* Make sure we have a table */
     if (map->table == NULL) {
         return NULL;
@@ -341,6 +643,10 @@ wmem_map_steal(wmem_map_t *map, const void *key)
 {
     wmem_map_item_t **item, *tmp;
 
+    if (map->flat) {
+        return wmem_map_flat_steal(map, key, NULL);
+    }
+
     /* Make sure we have a table */
     if (map->table == NULL) {
         return FALSE;
@@ -372,6 +678,18 @@ wmem_map_get_keys(wmem_allocator_t *list_allocator, wmem_map_t *map)
     wmem_map_item_t *cur;
     wmem_list_t* list = wmem_list_new(list_allocator);
 
+    if (map->flat) {
+        if (map->entries != NULL) {
+            capacity = CAPACITY(map);
+            for (i=0; i<capacity; i++) {
+                if (map->ctrl[i] != FLAT_EMPTY) {
+                    wmem_list_prepend(list, (void*)map->entries[i].key);
+                }
+            }
+        }
+        return list;
+    }
+
     if (map->table != NULL) {
         capacity = CAPACITY(map);
 
@@ -394,6 +712,18 @@ wmem_map_foreach(wmem_map_t *map, GHFunc foreach_func, gpointer user_data)
     wmem_map_item_t *cur;
     unsigned i;
 
+    if (map->flat) {
+        if (map->entries == NULL) {
+            return;
+        }
+        for (i = 0; i < CAPACITY(map); i++) {
+            if (map->ctrl[i] != FLAT_EMPTY) {
+                foreach_func((gpointer)map->entries[i].key, map->entries[i].value, user_data);
+            }
+        }
+        return;
+    }
+
     /* Make sure we have a table */
     if (map->table == NULL) {
         return;
@@ -414,6 +744,10 @@ wmem_map_foreach_remove(wmem_map_t *map, GHRFunc foreach_func, gpointer user_dat
     wmem_map_item_t **item, *tmp;
     unsigned i, deleted = 0;
 
+    if (map->flat) {
+        return wmem_map_flat_foreach_remove(map, foreach_func, user_data);
+    }
+
     /* Make sure we have a table */
     if (map->table == NULL) {
         return 0;
@@ -76,6 +76,33 @@ wmem_map_new_autoreset(wmem_allocator_t *metadata_scope, wmem_allocator_t *data_
         GHashFunc hash_func, GEqualFunc eql_func)
 G_GNUC_MALLOC;
 
+/** Creates a map like wmem_map_new(), but stored in a single open addressing
+ * table rather than in chains of separately allocated items. Lookups touch far
+ * fewer cache lines, which makes this the better choice for large, frequently
+ * searched maps. All other wmem_map functions work on it unchanged; unlike
+ * regular maps, removing an item may move other items within the table, so
+ * it must not be modified from within wmem_map_foreach().
+ *
+ * @param allocator The allocator scope with which to create the map.
+ * @param hash_func The hash function used to place inserted keys.
+ * @param eql_func  The equality function used to compare inserted keys.
+ * @return The newly-allocated map.
+ */
+WS_DLL_PUBLIC
+wmem_map_t *
+wmem_map_new_flat(wmem_allocator_t *allocator,
+        GHashFunc hash_func, GEqualFunc eql_func)
+G_GNUC_MALLOC;
+
+/** Creates a flat map (see wmem_map_new_flat()) with two allocator scopes,
+ * as wmem_map_new_autoreset() does for regular maps.
+ */
+WS_DLL_PUBLIC
+wmem_map_t *
+wmem_map_new_flat_autoreset(wmem_allocator_t *metadata_scope, wmem_allocator_t *data_scope,
+        GHashFunc hash_func, GEqualFunc eql_func)
+G_GNUC_MALLOC;
+
 /** Inserts a value into the map.
  *
  * @param map The map to insert into.
@@ -194,6 +194,42 @@ wmem_test_allocator_callbacks(void)
     g_assert_true(cb_called_count == 3);
 }
 
+static void
+wmem_test_allocator_stats(void)
+{
+    wmem_allocator_t       *allocator;
+    wmem_allocator_stats_t  stats;
+    void                   *ptr;
+
+    allocator = wmem_allocator_new(WMEM_ALLOCATOR_STRICT);
+
+    wmem_get_allocator_stats(allocator, &stats);
+    g_assert_true(stats.alloc_count == 0);
+    g_assert_true(stats.bytes_requested == 0);
+
+    ptr = wmem_alloc(allocator, 100);
+    wmem_alloc(allocator, 20);
+    ptr = wmem_realloc(allocator, ptr, 200);
+    wmem_free(allocator, ptr);
+
+    wmem_get_allocator_stats(allocator, &stats);
+    g_assert_true(stats.alloc_count == 2);
+    g_assert_true(stats.free_count == 1);
+    g_assert_true(stats.bytes_requested == 320);
+    g_assert_true(stats.peak_bytes_requested == 320);
+
+    wmem_free_all(allocator);
+    wmem_alloc(allocator, 10);
+
+    wmem_get_allocator_stats(allocator, &stats);
+    g_assert_true(stats.alloc_count == 1);
+    g_assert_true(stats.free_count == 0);
+    g_assert_true(stats.bytes_requested == 10);
+    g_assert_true(stats.peak_bytes_requested == 320);
+
+    wmem_destroy_allocator(allocator);
+}
+
 static void
 wmem_test_allocator_det(wmem_allocator_t *allocator, wmem_verify_func verify,
         guint len)
@@ -1016,6 +1052,83 @@ wmem_test_map(void)
     wmem_destroy_allocator(allocator);
 }
 
+static gboolean
+odd_key_map(gpointer key, gpointer val _U_, gpointer user_data _U_)
+{
+    return GPOINTER_TO_UINT(key) & 1;
+}
+
+static void
+wmem_test_map_flat(void)
+{
+    wmem_allocator_t   *allocator, *extra_allocator;
+    wmem_map_t       *map;
+    unsigned int      i;
+    void             *ret;
+
+    allocator = wmem_allocator_new(WMEM_ALLOCATOR_STRICT);
+    extra_allocator = wmem_allocator_new(WMEM_ALLOCATOR_STRICT);
+
+    /* insertion, lookup and removal, including across growth */
+    map = wmem_map_new_flat(allocator, g_direct_hash, g_direct_equal);
+    g_assert_true(map);
+
+    for (i=0; i<CONTAINER_ITERS; i++) {
+        ret = wmem_map_insert(map, GUINT_TO_POINTER(i), GUINT_TO_POINTER(777777));
+        g_assert_true(ret == NULL);
+        ret = wmem_map_insert(map, GUINT_TO_POINTER(i), GUINT_TO_POINTER(i));
+        g_assert_true(ret == GUINT_TO_POINTER(777777));
+    }
+    g_assert_true(wmem_map_size(map) == CONTAINER_ITERS);
+
+    /* remove every third key, then make sure all others are still found
+     * after the entries behind them have been shifted back */
+    for (i=0; i<CONTAINER_ITERS; i+=3) {
+        ret = wmem_map_remove(map, GUINT_TO_POINTER(i));
+        g_assert_true(ret == GUINT_TO_POINTER(i));
+        ret = wmem_map_remove(map, GUINT_TO_POINTER(i));
+        g_assert_true(ret == NULL);
+    }
+    for (i=0; i<CONTAINER_ITERS; i++) {
+        ret = wmem_map_lookup(map, GUINT_TO_POINTER(i));
+        if (i % 3 == 0) {
+            g_assert_true(ret == NULL);
+            g_assert_true(wmem_map_contains(map, GUINT_TO_POINTER(i)) == FALSE);
+        } else {
+            g_assert_true(ret == GUINT_TO_POINTER(i));
+            g_assert_true(wmem_map_contains(map, GUINT_TO_POINTER(i)) == TRUE);
+        }
+    }
+
+    /* foreach_remove must see each entry exactly once even though removal
+     * moves entries around */
+    wmem_map_foreach_remove(map, odd_key_map, NULL);
+    for (i=0; i<CONTAINER_ITERS; i++) {
+        g_assert_true(wmem_map_contains(map, GUINT_TO_POINTER(i)) ==
+                (i % 3 != 0 && i % 2 == 0));
+    }
+    g_assert_true(wmem_map_steal(map, GUINT_TO_POINTER(2)) == TRUE);
+    g_assert_true(wmem_map_steal(map, GUINT_TO_POINTER(2)) == FALSE);
+    wmem_free_all(allocator);
+
+    /* auto-reset */
+    map = wmem_map_new_flat_autoreset(allocator, extra_allocator, g_direct_hash, g_direct_equal);
+    g_assert_true(map);
+    for (i=0; i<CONTAINER_ITERS; i++) {
+        wmem_map_insert(map, GUINT_TO_POINTER(i), GUINT_TO_POINTER(i));
+    }
+    wmem_free_all(extra_allocator);
+    g_assert_true(wmem_map_size(map) == 0);
+    for (i=0; i<CONTAINER_ITERS; i++) {
+        g_assert_true(wmem_map_lookup(map, GUINT_TO_POINTER(i)) == NULL);
+    }
+    wmem_map_insert(map, GUINT_TO_POINTER(1), GUINT_TO_POINTER(1));
+    g_assert_true(wmem_map_lookup(map, GUINT_TO_POINTER(1)) == GUINT_TO_POINTER(1));
+
+    wmem_destroy_allocator(extra_allocator);
+    wmem_destroy_allocator(allocator);
+}
+
 static void
 wmem_test_queue(void)
 {
@@ -1223,6 +1336,23 @@ wmem_test_tree(void)
     g_assert_true(wmem_tree_count(tree) == CONTAINER_ITERS);
     wmem_free_all(allocator);
 
+    /* test lookup32_le with ascending and descending insertions mixed */
+    tree = wmem_tree_new(allocator);
+    for (i=0; i<CONTAINER_ITERS; i++) {
+        wmem_tree_insert32(tree, i*10, GUINT_TO_POINTER(i*10 + 1));
+    }
+    for (i=CONTAINER_ITERS; i>0; i--) {
+        wmem_tree_insert32(tree, i*10 - 5, GUINT_TO_POINTER(i*10 - 5 + 1));
+    }
+    for (i=0; i<CONTAINER_ITERS*10 + 10; i++) {
+        guint32 le_key = i - (i % 10 >= 5 ? i % 10 - 5 : i % 10);
+        if (le_key > CONTAINER_ITERS*10 - 5) {
+            le_key = CONTAINER_ITERS*10 - 5;
+        }
+        g_assert_true(wmem_tree_lookup32_le(tree, i) == GUINT_TO_POINTER(le_key + 1));
+    }
+    wmem_free_all(allocator);
+
     /* test auto-reset functionality */
     tree = wmem_tree_new_autoreset(allocator, extra_allocator);
     for (i=0; i<CONTAINER_ITERS; i++) {
@@ -1454,6 +1584,7 @@ main(int argc, char **argv)
     g_test_add_func("/wmem/allocator/simple",    wmem_test_allocator_simple);
     g_test_add_func("/wmem/allocator/strict",    wmem_test_allocator_strict);
     g_test_add_func("/wmem/allocator/callbacks", wmem_test_allocator_callbacks);
+    g_test_add_func("/wmem/allocator/stats",     wmem_test_allocator_stats);
 
     g_test_add_func("/wmem/utils/misc",    wmem_test_miscutls);
     g_test_add_func("/wmem/utils/strings", wmem_test_strutls);
@@ -1465,6 +1596,7 @@ main(int argc, char **argv)
     g_test_add_func("/wmem/datastruct/array",  wmem_test_array);
     g_test_add_func("/wmem/datastruct/list",   wmem_test_list);
     g_test_add_func("/wmem/datastruct/map",    wmem_test_map);
+    g_test_add_func("/wmem/datastruct/map_flat", wmem_test_map_flat);
     g_test_add_func("/wmem/datastruct/queue",  wmem_test_queue);
     g_test_add_func("/wmem/datastruct/stack",  wmem_test_stack);
     g_test_add_func("/wmem/datastruct/strbuf", wmem_test_strbuf);
@@ -49,6 +49,7 @@ struct _wmem_tree_t {
     wmem_allocator_t *metadata_allocator;
     wmem_allocator_t *data_allocator;
     wmem_tree_node_t *root;
+    wmem_tree_node_t *rightmost; /* node with the largest key */
     guint             metadata_scope_cb_id;
     guint             data_scope_cb_id;
 
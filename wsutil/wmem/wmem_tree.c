@@ -212,6 +212,7 @@ wmem_tree_reset_cb(wmem_allocator_t *allocator _U_, wmem_cb_event_t event,
     wmem_tree_t *tree = (wmem_tree_t *)user_data;
 
     tree->root = NULL;
+    tree->rightmost = NULL;
 
     if (event == WMEM_CB_DESTROY_EVENT) {
         wmem_unregister_callback(tree->metadata_allocator, tree->metadata_scope_cb_id);
@@ -359,9 +360,18 @@ lookup_or_insert32_node(wmem_tree_t *tree, guint32 key,
         new_node = create_node(tree->data_allocator, NULL, GUINT_TO_POINTER(key),
                 CREATE_DATA(func, data), WMEM_NODE_COLOR_BLACK, is_subtree);
         tree->root = new_node;
+        tree->rightmost = new_node;
         return new_node;
     }
 
+    /* Keys such as frame numbers are mostly inserted in increasing order.
+     * A key larger than any other belongs right below the rightmost node,
+     * so there is no need to walk down from the root.
+     */
+    if (key >= GPOINTER_TO_UINT(tree->rightmost->key)) {
+        node = tree->rightmost;
+    }
+
     /* it was not the new root so walk the tree until we find where to
      * insert this new leaf.
      */
@@ -395,6 +405,9 @@ lookup_or_insert32_node(wmem_tree_t *tree, guint32 key,
                         CREATE_DATA(func, data), WMEM_NODE_COLOR_RED,
                         is_subtree);
                 node->right = new_node;
+                if (node == tree->rightmost) {
+                    tree->rightmost = new_node;
+                }
             }
         }
     }
@@ -451,6 +464,7 @@ wmem_tree_insert(wmem_tree_t *tree, const void *key, void *data, compare_func cm
     if (!node) {
         tree->root = create_node(tree->data_allocator, node, key,
                 data, WMEM_NODE_COLOR_BLACK, FALSE);
+        tree->rightmost = tree->root;
         return tree->root;
     }
 
@@ -483,6 +497,9 @@ wmem_tree_insert(wmem_tree_t *tree, const void *key, void *data, compare_func cm
                 new_node = create_node(tree->data_allocator, node, key,
                         data, WMEM_NODE_COLOR_RED, FALSE);
                 node->right = new_node;
+                if (node == tree->rightmost) {
+                    tree->rightmost = new_node;
+                }
             }
         }
     }
@@ -553,6 +570,12 @@ wmem_tree_lookup32_le(wmem_tree_t *tree, guint32 key)
         return NULL;
     }
 
+    /* Lookups are mostly for the frame being dissected, which on the first
+     * pass is at or past the largest key. */
+    if (tree->rightmost && key >= GPOINTER_TO_UINT(tree->rightmost->key)) {
+        return tree->rightmost->data;
+    }
+
     wmem_tree_node_t *node = tree->root;
 
     while (node) {
@@ -22,6 +22,8 @@
 #endif
 #endif
 
+#include <string.h>
+
 #include <glib.h>
 #include "ws_symbol_export.h"
 #include "ws_mempbrk.h"
@@ -31,11 +33,22 @@ void
 ws_mempbrk_compile(ws_mempbrk_pattern* pattern, const gchar *needles)
 {
     const gchar *n = needles;
+    int i;
+
     while (*n) {
         pattern->patt[(int)*n] = 1;
         n++;
     }
 
+    pattern->num_needles = 0;
+    for (i = 0; i < 256; i++) {
+        if (pattern->patt[i]) {
+            if (pattern->num_needles < G_N_ELEMENTS(pattern->needles))
+                pattern->needles[pattern->num_needles] = (guchar)i;
+            pattern->num_needles++;
+        }
+    }
+
 #ifdef HAVE_SSE4_2
     ws_mempbrk_sse42_compile(pattern, needles);
 #endif
@@ -60,9 +73,57 @@ ws_mempbrk_portable_exec(const guint8* haystack, size_t haystacklen, const ws_me
 }
 
 
+/*
+ * Look for either of two needles with memchr().  Searching the whole
+ * haystack for the first needle before looking for the second one would
+ * scan all of it whenever the first needle is rare, e.g. for CR in text
+ * with bare LF line endings, so go through it a chunk at a time.
+ */
+#define MEMPBRK_CHUNK_SIZE 256
+
+static const guint8 *
+ws_mempbrk_memchr_exec(const guint8* haystack, size_t haystacklen, const ws_mempbrk_pattern* pattern, guchar *found_needle)
+{
+    const guint8 *result;
+    size_t chunklen, len;
+
+    if (pattern->num_needles == 1) {
+        result = (const guint8 *)memchr(haystack, pattern->needles[0], haystacklen);
+        if (result && found_needle)
+            *found_needle = *result;
+        return result;
+    }
+
+    while (haystacklen != 0) {
+        chunklen = MIN(haystacklen, MEMPBRK_CHUNK_SIZE);
+
+        result = (const guint8 *)memchr(haystack, pattern->needles[0], chunklen);
+        len = result ? (size_t)(result - haystack) : chunklen;
+        if (len != 0) {
+            const guint8 *second = (const guint8 *)memchr(haystack, pattern->needles[1], len);
+            if (second)
+                result = second;
+        }
+        if (result) {
+            if (found_needle)
+                *found_needle = *result;
+            return result;
+        }
+
+        haystack += chunklen;
+        haystacklen -= chunklen;
+    }
+
+    return NULL;
+}
+
+
 WS_DLL_PUBLIC const guint8 *
 ws_mempbrk_exec(const guint8* haystack, size_t haystacklen, const ws_mempbrk_pattern* pattern, guchar *found_needle)
 {
+    if (pattern->num_needles == 1 || pattern->num_needles == 2)
+        return ws_mempbrk_memchr_exec(haystack, haystacklen, pattern, found_needle);
+
 #ifdef HAVE_SSE4_2
     if (haystacklen >= 16 && pattern->use_sse42)
         return ws_mempbrk_sse42_exec(haystack, haystacklen, pattern, found_needle);
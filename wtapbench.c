@@ -0,0 +1,333 @@
+/* wtapbench.c
+ * Measures how fast wiretap reads capture files
+ *
+ * Based on captype.c
+ *
+ * Wireshark - Network traffic analyzer
+ * By Gerald Combs <gerald@wireshark.org>
+ * Copyright 1998 Gerald Combs
+ *
+ * SPDX-License-Identifier: GPL-2.0-or-later
+ */
+
+#include <config.h>
+#define WS_LOG_DOMAIN  LOG_DOMAIN_MAIN
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdarg.h>
+#include <locale.h>
+#include <errno.h>
+
+#include <wsutil/ws_getopt.h>
+
+#include <glib.h>
+
+#include <wiretap/wtap.h>
+
+#include <wsutil/cmdarg_err.h>
+#include <wsutil/file_util.h>
+#include <wsutil/filesystem.h>
+#include <wsutil/privileges.h>
+#include <cli_main.h>
+#include <wsutil/version_info.h>
+
+#include <wsutil/report_message.h>
+#include <wsutil/str_util.h>
+#include <wsutil/strtoi.h>
+#include <wsutil/wslog.h>
+
+#include "ui/failure_message.h"
+
+/* Fixed, so that the random pattern is the same from run to run. */
+#define WTAPBENCH_DEFAULT_SEED 0x5eed
+
+static void
+print_usage(FILE *output)
+{
+    fprintf(output, "\n");
+    fprintf(output, "Usage: wtapbench [options] <infile> ...\n");
+    fprintf(output, "\n");
+    fprintf(output, "Benchmark:\n");
+    fprintf(output, "  -p <passes>              read each file sequentially <passes> times\n");
+    fprintf(output, "                           (default 1)\n");
+    fprintf(output, "  -r <reads>               after the sequential passes, do <reads>\n");
+    fprintf(output, "                           wtap_seek_read() calls on random records\n");
+    fprintf(output, "  -s <seed>                seed for the random reads\n");
+    fprintf(output, "  -n, --no-copy-payload    don't read packet data in the sequential\n");
+    fprintf(output, "                           passes, where supported, to measure\n");
+    fprintf(output, "                           header parsing alone\n");
+    fprintf(output, "\n");
+    fprintf(output, "Miscellaneous:\n");
+    fprintf(output, "  -h, --help               display this help and exit\n");
+    fprintf(output, "  -v, --version            display version info and exit\n");
+}
+
+/*
+ * Report an error in command-line arguments.
+ */
+static void
+wtapbench_cmdarg_err(const char *msg_format, va_list ap)
+{
+    fprintf(stderr, "wtapbench: ");
+    vfprintf(stderr, msg_format, ap);
+    fprintf(stderr, "\n");
+}
+
+/*
+ * Report additional information for an error in command-line arguments.
+ */
+static void
+wtapbench_cmdarg_err_cont(const char *msg_format, va_list ap)
+{
+    vfprintf(stderr, msg_format, ap);
+    fprintf(stderr, "\n");
+}
+
+static void
+print_result(const char *filename, const char *test, guint64 records,
+             guint64 bytes, gint64 elapsed_us)
+{
+    double secs = elapsed_us > 0 ? (double)elapsed_us / 1e6 : 1e-6;
+
+    printf("%s: %s: %" PRIu64 " records, %" PRIu64 " bytes, %.3f s, "
+           "%.0f records/s, %.2f MB/s\n",
+           filename, test, records, bytes, secs,
+           (double)records / secs, (double)bytes / secs / 1e6);
+}
+
+/* Returns 0 on success, 2 on failure. */
+static int
+bench_file(const char *filename, guint passes, guint random_reads,
+           guint32 seed, gboolean skip_data)
+{
+    wtap     *wth;
+    wtap_rec  rec;
+    Buffer    buf;
+    int       err = 0;
+    gchar    *err_info = NULL;
+    gint64    offset;
+    GArray   *offsets;
+    int       status = 0;
+
+    wth = wtap_open_offline(filename, WTAP_TYPE_AUTO, &err, &err_info,
+                            random_reads > 0);
+    if (!wth) {
+        cfile_open_failure_message(filename, err, err_info);
+        return 2;
+    }
+
+    printf("%s: %s\n", filename,
+           wtap_file_type_subtype_name(wtap_file_type_subtype(wth)));
+
+    wtap_rec_init(&rec);
+    ws_buffer_init(&buf, 1514);
+    offsets = g_array_new(FALSE, FALSE, sizeof(gint64));
+
+    for (guint pass = 0; pass < passes; pass++) {
+        guint64 records = 0, bytes = 0;
+        gint64  start;
+
+        if (pass > 0) {
+            /* Reopen rather than rewind, so that each pass includes
+             * the same work. */
+            wtap_close(wth);
+            wth = wtap_open_offline(filename, WTAP_TYPE_AUTO, &err,
+                                    &err_info, random_reads > 0);
+            if (!wth) {
+                cfile_open_failure_message(filename, err, err_info);
+                status = 2;
+                goto done;
+            }
+        }
+        wtap_set_skip_packet_data(wth, skip_data);
+
+        start = g_get_monotonic_time();
+        while (wtap_read(wth, &rec, &buf, &err, &err_info, &offset)) {
+            records++;
+            bytes += rec.rec_header.packet_header.caplen;
+            if (pass == 0 && random_reads > 0)
+                g_array_append_val(offsets, offset);
+            wtap_rec_reset(&rec);
+        }
+        if (err != 0) {
+            cfile_read_failure_message(filename, err, err_info);
+            status = 2;
+            goto done;
+        }
+        print_result(filename, skip_data ? "sequential, no data" : "sequential",
+                     records, bytes, g_get_monotonic_time() - start);
+    }
+
+    if (random_reads > 0 && offsets->len > 0) {
+        GRand  *rand = g_rand_new_with_seed(seed);
+        guint64 bytes = 0;
+        gint64  start;
+
+        start = g_get_monotonic_time();
+        for (guint i = 0; i < random_reads; i++) {
+            gint64 seek_off = g_array_index(offsets, gint64,
+                    g_rand_int_range(rand, 0, (gint32)offsets->len));
+            if (!wtap_seek_read(wth, seek_off, &rec, &buf, &err, &err_info)) {
+                cfile_read_failure_message(filename, err, err_info);
+                status = 2;
+                break;
+            }
+            bytes += rec.rec_header.packet_header.caplen;
+            wtap_rec_reset(&rec);
+        }
+        g_rand_free(rand);
+        if (status == 0)
+            print_result(filename, "random", random_reads, bytes,
+                         g_get_monotonic_time() - start);
+    }
+
+done:
+    g_array_free(offsets, TRUE);
+    ws_buffer_free(&buf);
+    wtap_rec_cleanup(&rec);
+    if (wth)
+        wtap_close(wth);
+    return status;
+}
+
+int
+main(int argc, char *argv[])
+{
+    char  *configuration_init_error;
+    static const struct report_message_routines wtapbench_report_routines = {
+        failure_message,
+        failure_message,
+        open_failure_message,
+        read_failure_message,
+        write_failure_message,
+        cfile_open_failure_message,
+        cfile_dump_open_failure_message,
+        cfile_read_failure_message,
+        cfile_write_failure_message,
+        cfile_close_failure_message
+    };
+    int      i;
+    int      opt;
+    int      overall_error_status;
+    guint32  passes = 1;
+    guint32  random_reads = 0;
+    guint32  seed = WTAPBENCH_DEFAULT_SEED;
+    gboolean skip_data = FALSE;
+    static const struct ws_option long_options[] = {
+        {"help", ws_no_argument, NULL, 'h'},
+        {"version", ws_no_argument, NULL, 'v'},
+        {"no-copy-payload", ws_no_argument, NULL, 'n'},
+        {0, 0, 0, 0 }
+    };
+
+    /*
+     * Set the C-language locale to the native environment and set the
+     * code page to UTF-8 on Windows.
+     */
+#ifdef _WIN32
+    setlocale(LC_ALL, ".UTF-8");
+#else
+    setlocale(LC_ALL, "");
+#endif
+
+    cmdarg_err_init(wtapbench_cmdarg_err, wtapbench_cmdarg_err_cont);
+
+    /* Initialize log handler early so we can have proper logging during startup. */
+    ws_log_init("wtapbench", vcmdarg_err);
+
+    /* Early logging command-line initialization. */
+    ws_log_parse_args(&argc, argv, vcmdarg_err, 1);
+
+    ws_noisy("Finished log init and parsing command line log arguments");
+
+    /* Initialize the version information. */
+    ws_init_version_info("Wtapbench", NULL, NULL);
+
+    /*
+     * Get credential information for later use.
+     */
+    init_process_policies();
+
+    /*
+     * Attempt to get the pathname of the directory containing the
+     * executable file.
+     */
+    configuration_init_error = configuration_init(argv[0], NULL);
+    if (configuration_init_error != NULL) {
+        fprintf(stderr,
+                "wtapbench: Can't get pathname of directory containing the wtapbench program: %s.\n",
+                configuration_init_error);
+        g_free(configuration_init_error);
+    }
+
+    init_report_message("wtapbench", &wtapbench_report_routines);
+
+    wtap_init(TRUE);
+
+    /* Process the options */
+    while ((opt = ws_getopt_long(argc, argv, "hnp:r:s:v", long_options, NULL)) !=-1) {
+
+        switch (opt) {
+
+            case 'h':
+                show_help_header("Measure how fast capture files are read.");
+                print_usage(stdout);
+                exit(0);
+                break;
+
+            case 'n':
+                skip_data = TRUE;
+                break;
+
+            case 'p':
+                if (!ws_strtou32(ws_optarg, NULL, &passes) || passes == 0) {
+                    cmdarg_err("\"%s\" isn't a valid number of passes", ws_optarg);
+                    exit(1);
+                }
+                break;
+
+            case 'r':
+                if (!ws_strtou32(ws_optarg, NULL, &random_reads)) {
+                    cmdarg_err("\"%s\" isn't a valid number of reads", ws_optarg);
+                    exit(1);
+                }
+                break;
+
+            case 's':
+                if (!ws_strtou32(ws_optarg, NULL, &seed)) {
+                    cmdarg_err("\"%s\" isn't a valid seed", ws_optarg);
+                    exit(1);
+                }
+                break;
+
+            case 'v':
+                show_version();
+                exit(0);
+                break;
+
+            case '?':              /* Bad flag - print usage message */
+                print_usage(stderr);
+                exit(1);
+                break;
+        }
+    }
+
+    if (ws_optind >= argc) {
+        print_usage(stderr);
+        return 1;
+    }
+
+    overall_error_status = 0;
+
+    for (i = ws_optind; i < argc; i++) {
+        if (bench_file(argv[i], passes, random_reads, seed, skip_data) != 0)
+            overall_error_status = 2; /* remember that an error has occurred */
+    }
+
+    wtap_cleanup();
+    free_progdirs();
+    return overall_error_status;
+}
+